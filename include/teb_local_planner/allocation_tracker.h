@@ -0,0 +1,170 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef ALLOCATION_TRACKER_H_
+#define ALLOCATION_TRACKER_H_
+
+#include <boost/utility.hpp>
+
+#include <cstddef>
+
+
+namespace teb_local_planner
+{
+
+//! Phases of a planning cycle to which heap allocations are attributed (see AllocationTracker)
+enum class AllocationPhase
+{
+  Other = 0, //!< Allocations outside of any marked phase
+  TebResize, //!< Trajectory initialization, warm start (pruning) and automatic resizing
+  GraphBuild, //!< Construction of the hyper-graph (vertices and edges)
+  Optimization, //!< Solver iterations
+  ObstacleUpdate, //!< Update of the obstacle container (e.g. from the costmap)
+  HSignature, //!< Computation of equivalence classes (h-signatures) for homotopy class planning
+  MessageConstruction, //!< Construction of ROS messages (visualization, feedback, diagnostics)
+  Count //!< Number of phases (not a phase)
+};
+
+//! Number of allocation phases
+static const int NoAllocationPhases = static_cast<int>(AllocationPhase::Count);
+
+/**
+ * @brief Get a human readable name of an allocation phase
+ * @param phase the allocation phase
+ * @return name of the phase (static string)
+ */
+const char* allocationPhaseName(AllocationPhase phase);
+
+
+/**
+ * @struct AllocationStats
+ * @brief Number of heap allocations and allocated bytes for each phase
+ */
+struct AllocationStats
+{
+  unsigned long count[NoAllocationPhases]; //!< Number of allocations per phase
+  unsigned long bytes[NoAllocationPhases]; //!< Number of allocated bytes per phase
+  
+  //! Number of allocations of a phase
+  unsigned long countOf(AllocationPhase phase) const {return count[static_cast<int>(phase)];}
+  //! Number of allocated bytes of a phase
+  unsigned long bytesOf(AllocationPhase phase) const {return bytes[static_cast<int>(phase)];}
+  //! Total number of allocations
+  unsigned long totalCount() const;
+  //! Total number of allocated bytes
+  unsigned long totalBytes() const;
+};
+
+
+/**
+ * @class AllocationTracker
+ * @brief Instrumentation that counts heap allocations per phase of the planning cycle
+ * 
+ * The planning core marks its phases with an AllocationPhaseScope. The tracker itself does not
+ * intercept the allocator: an executable that wants to collect the statistics replaces the heap
+ * allocation functions by including allocation_tracker_hooks.h in exactly one translation unit.
+ * Without the hooks, marking phases costs a single thread-local store.
+ * The phase is tracked per thread, the counters are shared among all threads.
+ */
+class AllocationTracker
+{
+public:
+  
+  /**
+   * @brief Account an allocation of \c size bytes to the phase of the calling thread
+   * @remarks This method is called from the replaced allocation functions and does not allocate itself.
+   * @param size number of requested bytes
+   */
+  static void recordAllocation(std::size_t size);
+  
+  /**
+   * @brief Enable or disable the accounting (enabled by default)
+   * @param enabled if \c false, recordAllocation() ignores all allocations
+   */
+  static void setEnabled(bool enabled);
+  
+  /**
+   * @brief Get a snapshot of all counters
+   * @param[out] stats counters since the last reset()
+   */
+  static void getStats(AllocationStats& stats);
+  
+  /**
+   * @brief Reset all counters to zero
+   */
+  static void reset();
+  
+  /**
+   * @brief Get the phase of the calling thread
+   */
+  static AllocationPhase currentPhase();
+  
+  /**
+   * @brief Set the phase of the calling thread (prefer AllocationPhaseScope)
+   * @param phase new phase
+   */
+  static void setCurrentPhase(AllocationPhase phase);
+};
+
+
+/**
+ * @class AllocationPhaseScope
+ * @brief Mark the lifetime of the object as a phase of the planning cycle
+ * 
+ * The previous phase of the thread is restored on destruction, hence scopes can be nested.
+ */
+class AllocationPhaseScope : boost::noncopyable
+{
+public:
+  explicit AllocationPhaseScope(AllocationPhase phase) : previous_(AllocationTracker::currentPhase())
+  {
+    AllocationTracker::setCurrentPhase(phase);
+  }
+  
+  ~AllocationPhaseScope()
+  {
+    AllocationTracker::setCurrentPhase(previous_);
+  }
+  
+private:
+  AllocationPhase previous_;
+};
+
+} // namespace teb_local_planner
+
+#endif /* ALLOCATION_TRACKER_H_ */
@@ -0,0 +1,162 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+/*
+ * Replacement of the heap allocation functions that forwards each allocation to the AllocationTracker.
+ * 
+ * Include this header in exactly one translation unit of an executable (e.g. a benchmark)
+ * in order to enable the allocation accounting. Never include it in a library.
+ * 
+ * With glibc, the C allocation functions (malloc, calloc, realloc, posix_memalign, aligned_alloc, memalign)
+ * are interposed and forwarded to the glibc implementation. Hence every heap allocation is counted:
+ * the global operator new, the class specific operators of EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+ * (e.g. VertexPose, g2o edges and obstacles) and Eigen::aligned_allocator (e.g. PoseSE2Container).
+ * Otherwise only the global operator new is replaced, which misses all Eigen aligned allocations.
+ */
+
+#ifndef ALLOCATION_TRACKER_HOOKS_H_
+#define ALLOCATION_TRACKER_HOOKS_H_
+
+#include <teb_local_planner/allocation_tracker.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+
+#if defined(__GLIBC__)
+
+extern "C"
+{
+
+// implementation of glibc, to which the interposed functions forward
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(std::size_t size)
+{
+  teb_local_planner::AllocationTracker::recordAllocation(size);
+  return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+  teb_local_planner::AllocationTracker::recordAllocation(count * size);
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, std::size_t size)
+{
+  teb_local_planner::AllocationTracker::recordAllocation(size);
+  return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void** ptr, std::size_t alignment, std::size_t size)
+{
+  if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+    return EINVAL;
+  teb_local_planner::AllocationTracker::recordAllocation(size);
+  void* mem = __libc_memalign(alignment, size);
+  if (!mem)
+    return ENOMEM;
+  *ptr = mem;
+  return 0;
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size)
+{
+  teb_local_planner::AllocationTracker::recordAllocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size)
+{
+  teb_local_planner::AllocationTracker::recordAllocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+void free(void* ptr)
+{
+  __libc_free(ptr);
+}
+
+} // extern "C"
+
+#else // the global operator new only
+
+void* operator new(std::size_t size)
+{
+  teb_local_planner::AllocationTracker::recordAllocation(size);
+  if (void* ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  teb_local_planner::AllocationTracker::recordAllocation(size);
+  if (void* ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  teb_local_planner::AllocationTracker::recordAllocation(size);
+  return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  teb_local_planner::AllocationTracker::recordAllocation(size);
+  return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept {std::free(ptr);}
+void operator delete[](void* ptr) noexcept {std::free(ptr);}
+void operator delete(void* ptr, std::size_t) noexcept {std::free(ptr);}
+void operator delete[](void* ptr, std::size_t) noexcept {std::free(ptr);}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {std::free(ptr);}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {std::free(ptr);}
+
+#endif // __GLIBC__
+
+#endif /* ALLOCATION_TRACKER_HOOKS_H_ */
@@ -0,0 +1,241 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef BATCH_PLANNER_H_
+#define BATCH_PLANNER_H_
+
+#include <teb_local_planner/pose_se2.h>
+#include <teb_local_planner/teb_types.h>
+#include <teb_local_planner/teb_config.h>
+#include <teb_local_planner/obstacles.h>
+#include <teb_local_planner/robot_footprint_model.h>
+#include <teb_local_planner/planner_interface.h>
+#include <teb_local_planner/optimal_planner.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/utility.hpp>
+
+#include <cstddef>
+#include <vector>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @struct BatchPlanningProblem
+ * @brief Planning problem of a single robot that is solved by the BatchPlanner
+ */
+struct BatchPlanningProblem
+{
+  /**
+   * @brief Default constructor
+   */
+  BatchPlanningProblem() : has_start_vel(false), free_goal_vel(false) {}
+  
+  PoseSE2Container initial_plan; //!< Initial plan (at least start and goal)
+  Twist2D start_vel; //!< Current velocity of the robot (only used if has_start_vel is \c true)
+  bool has_start_vel; //!< Use start_vel as initial velocity (otherwise the robot starts at rest)
+  bool free_goal_vel; //!< Allow a nonzero final velocity at the goal pose
+  RobotFootprintModelPtr robot_model; //!< Footprint model of the robot (a point robot is assumed if empty)
+  ViaPointContainer via_points; //!< Optional via-points
+  ObstContainer local_obstacles; //!< Obstacles that are only relevant for this robot (e.g. the other robots of the fleet)
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+//! Container of planning problems
+typedef std::vector< BatchPlanningProblem, Eigen::aligned_allocator<BatchPlanningProblem> > BatchPlanningProblemContainer;
+
+
+/**
+ * @struct BatchPlanningResult
+ * @brief Result of a single planning problem solved by the BatchPlanner
+ */
+struct BatchPlanningResult
+{
+  /**
+   * @brief Default constructor
+   */
+  BatchPlanningResult() : success(false), vx(0), vy(0), omega(0), computation_time(0) {}
+  
+  bool success; //!< \c true if the planner succeeded and a velocity command is available
+  double vx; //!< Translational velocity command in x-direction [m/s]
+  double vy; //!< Strafing velocity command (holonomic robots) [m/s]
+  double omega; //!< Angular velocity command [rad/s]
+  double computation_time; //!< Wall time spent for this problem [s]
+};
+
+
+/**
+ * @struct BatchPlanningStatistics
+ * @brief Timing of the last BatchPlanner::plan() call
+ */
+struct BatchPlanningStatistics
+{
+  /**
+   * @brief Default constructor
+   */
+  BatchPlanningStatistics() : no_problems(0), no_threads(0), wall_time(0), plans_per_second(0) {}
+  
+  std::size_t no_problems; //!< Number of planning problems
+  std::size_t no_threads; //!< Number of worker threads that have been used
+  double wall_time; //!< Wall time of the complete batch [s]
+  double plans_per_second; //!< Throughput of the batch
+};
+
+
+/**
+ * @class BatchPlanner
+ * @brief Solves the local planning problems of many robots (e.g. a fleet simulation) in a single call
+ * 
+ * Instead of running a separate planner instance with its own obstacle container and threads per robot,
+ * all problems of a batch share:
+ * - a single container of common obstacles: each robot refers to the same obstacle objects and
+ *   only adds its robot specific obstacles (BatchPlanningProblem::local_obstacles),
+ * - a single pool of worker threads that fetches the problems one after another,
+ *   hence the load is balanced even if the problems differ in complexity.
+ * 
+ * Each problem index keeps its own planner across calls, so that problem \c i is warm-started
+ * from the trajectory of the previous call (robot \c i should keep its index).
+ * The planner type follows TebConfig::HomotopyClasses::enable_homotopy_class_planning.
+ * Since the batch already runs in parallel, TebConfig::HomotopyClasses::enable_multithreading
+ * should be disabled in order to avoid oversubscription of the cores.
+ * 
+ * The obstacles, the config and an optional experience cache are only read during plan(),
+ * hence they must not be modified concurrently.
+ */
+class BatchPlanner : public boost::noncopyable
+{
+public:
+  
+  /**
+   * @brief Construct the batch planner
+   * @param cfg const reference to the TebConfig class for parameters (shared by all problems)
+   * @param no_threads number of worker threads (0 selects the number of hardware threads)
+   */
+  BatchPlanner(const TebConfig& cfg, int no_threads = 0);
+  
+  /**
+   * @brief Solve a batch of planning problems
+   * @param problems planning problems (one per robot)
+   * @param shared_obstacles obstacles that are relevant for all robots
+   * @param[out] results result of each problem (same order as \c problems)
+   * @return number of successful problems
+   */
+  std::size_t plan(const BatchPlanningProblemContainer& problems, const ObstContainer& shared_obstacles,
+                   std::vector<BatchPlanningResult>& results);
+  
+  /**
+   * @brief Access the planner that solved a specific problem during the last call (e.g. to retrieve the trajectory)
+   * @param index index of the problem
+   * @return planner of the problem or an empty pointer if the index is out of range
+   */
+  PlannerInterfacePtr planner(std::size_t index) const;
+  
+  /**
+   * @brief Delete all planners (the next call starts from scratch)
+   */
+  void clear();
+  
+  /**
+   * @brief Share an experience cache among all planners of the batch
+   * @param cache shared pointer to the cache (an empty pointer disables the cache)
+   */
+  void setExperienceCache(ExperienceCachePtr cache) {experience_cache_ = cache;}
+  
+  /**
+   * @brief Get the number of worker threads
+   */
+  std::size_t numberOfThreads() const {return no_threads_;}
+  
+  /**
+   * @brief Get the timing of the last plan() call
+   */
+  const BatchPlanningStatistics& statistics() const {return statistics_;}
+  
+private:
+  
+  /**
+   * @struct Slot
+   * @brief Planner and containers that belong to a single problem index
+   * 
+   * The planner stores pointers to the containers, hence a slot must not be moved.
+   */
+  struct Slot
+  {
+    PlannerInterfacePtr planner; //!< Planner (warm-started across calls)
+    RobotFootprintModelPtr robot_model; //!< Footprint model the planner has been created with
+    ObstContainer obstacles; //!< Shared and robot specific obstacles
+    ViaPointContainer via_points; //!< Via-points of the problem
+  };
+  typedef boost::shared_ptr<Slot> SlotPtr;
+  
+  /**
+   * @brief Worker function: solves problems until the batch is exhausted
+   */
+  void work(const BatchPlanningProblemContainer* problems, const ObstContainer* shared_obstacles, std::vector<BatchPlanningResult>* results);
+  
+  /**
+   * @brief Solve a single problem using its slot
+   */
+  void solve(const BatchPlanningProblem& problem, const ObstContainer& shared_obstacles, Slot& slot, BatchPlanningResult& result);
+  
+  const TebConfig* cfg_; //!< Config class that stores and manages all related parameters
+  std::size_t no_threads_; //!< Number of worker threads
+  std::vector<SlotPtr> slots_; //!< One slot per problem index
+  ExperienceCachePtr experience_cache_; //!< Optional experience cache shared by all planners
+  RobotFootprintModelPtr default_robot_model_; //!< Point robot for problems without footprint model
+  
+  boost::mutex queue_mutex_; //!< Mutex that protects next_problem_
+  std::size_t next_problem_; //!< Index of the next problem that is fetched by a worker
+  
+  BatchPlanningStatistics statistics_; //!< Timing of the last call
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+//! Abbrev. for shared instances of the BatchPlanner
+typedef boost::shared_ptr<BatchPlanner> BatchPlannerPtr;
+
+} // namespace teb_local_planner
+
+#endif /* BATCH_PLANNER_H_ */
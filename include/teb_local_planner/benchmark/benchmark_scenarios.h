@@ -0,0 +1,136 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef BENCHMARK_SCENARIOS_H_
+#define BENCHMARK_SCENARIOS_H_
+
+#include <teb_local_planner/teb_config.h>
+#include <teb_local_planner/pose_se2.h>
+#include <teb_local_planner/obstacles.h>
+#include <teb_local_planner/robot_footprint_model.h>
+#include <teb_local_planner/optimal_planner.h>
+
+#include <boost/function.hpp>
+
+#include <string>
+#include <vector>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @struct BenchmarkScenario
+ * @brief Synthetic planning problem used by the headless benchmark and evaluation tools
+ * 
+ * A scenario bundles start and goal, a set of (possibly dynamic) obstacles, optional via-points,
+ * the robot footprint model and scenario specific parameter overrides (e.g. car-like kinematics).
+ * All scenarios are generated deterministically in order to obtain reproducible results.
+ */
+struct BenchmarkScenario
+{
+  std::string name; //!< Unique identifier of the scenario
+  std::string description; //!< Short human readable description
+  PoseSE2 start; //!< Start pose of the robot
+  PoseSE2 goal; //!< Goal pose of the robot
+  ObstContainer obstacles; //!< Obstacles of the scene (dynamic obstacles are marked by a non-zero centroid velocity)
+  ViaPointContainer via_points; //!< Optional via-points
+  RobotFootprintModelPtr robot_model; //!< Footprint model of the robot
+  boost::function<void (TebConfig&)> configure; //!< Optional scenario specific parameter overrides (applied to the default config)
+  
+  /**
+   * @brief Apply the scenario specific parameter overrides to a config
+   * @param[in,out] cfg TebConfig that should be modified
+   */
+  void applyConfig(TebConfig& cfg) const
+  {
+    if (configure)
+      configure(cfg);
+  }
+  
+  /**
+   * @brief Check whether the scenario contains at least a single dynamic obstacle
+   * @return \c true if a dynamic obstacle is included, \c false otherwise
+   */
+  bool hasDynamicObstacles() const;
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+/**
+ * @brief Get the names of all available benchmark scenarios
+ * @return container of scenario names (corridor, cluttered_room, doorway, pedestrian_crowd, carlike_parking)
+ */
+std::vector<std::string> benchmarkScenarioNames();
+
+/**
+ * @brief Create a benchmark scenario by its name
+ * 
+ * A new set of obstacles is allocated for each call, hence the scenario can be modified
+ * (e.g. by advancing dynamic obstacles) without affecting other instances.
+ * @param name name of the scenario (see benchmarkScenarioNames())
+ * @param[out] scenario the generated scenario
+ * @return \c true if the scenario is known, \c false otherwise
+ */
+bool createBenchmarkScenario(const std::string& name, BenchmarkScenario& scenario);
+
+/**
+ * @brief Advance all dynamic obstacles of a scenario using a constant velocity model
+ * 
+ * Currently only point and circular obstacles are moved, since they are the only types
+ * that are created as dynamic obstacles by the scenario library.
+ * @param[in,out] scenario scenario whose obstacles should be moved
+ * @param dt time interval [s]
+ */
+void advanceDynamicObstacles(BenchmarkScenario& scenario, double dt);
+
+/**
+ * @brief Compute the minimum separation between a trajectory and the obstacles of a scenario
+ * 
+ * Dynamic obstacles are predicted along the time stamps of the trajectory.
+ * @param teb trajectory to be checked
+ * @param scenario scenario that contains the obstacles and the robot footprint model
+ * @return minimum distance between the robot footprint and all obstacles (negative values indicate a collision)
+ */
+double computeMinimumClearance(const TimedElasticBand& teb, const BenchmarkScenario& scenario);
+
+} // namespace teb_local_planner
+
+#endif /* BENCHMARK_SCENARIOS_H_ */
@@ -0,0 +1,98 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef BENCHMARK_STATISTICS_H_
+#define BENCHMARK_STATISTICS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @brief Return the p-th percentile of a sorted set of samples (nearest-rank method)
+ * @param sorted_values samples sorted in ascending order
+ * @param p percentile in [0, 100]
+ * @return percentile (0 if no samples are available)
+ */
+inline double percentile(const std::vector<double>& sorted_values, double p)
+{
+  if (sorted_values.empty())
+    return 0;
+  int idx = (int) std::ceil(p / 100.0 * sorted_values.size()) - 1;
+  idx = std::max(0, std::min(idx, (int) sorted_values.size() - 1));
+  return sorted_values[idx];
+}
+
+/**
+ * @brief Return the arithmetic mean of a set of samples (0 if no samples are available)
+ */
+inline double mean(const std::vector<double>& values)
+{
+  if (values.empty())
+    return 0;
+  return std::accumulate(values.begin(), values.end(), 0.0) / (double) values.size();
+}
+
+/**
+ * @brief Return the maximum of a set of samples (0 if no samples are available)
+ */
+inline double maximum(const std::vector<double>& values)
+{
+  if (values.empty())
+    return 0;
+  return *std::max_element(values.begin(), values.end());
+}
+
+/**
+ * @brief Return the minimum of a set of samples (0 if no samples are available)
+ */
+inline double minimum(const std::vector<double>& values)
+{
+  if (values.empty())
+    return 0;
+  return *std::min_element(values.begin(), values.end());
+}
+
+} // namespace teb_local_planner
+
+#endif /* BENCHMARK_STATISTICS_H_ */
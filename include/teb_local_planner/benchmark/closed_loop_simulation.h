@@ -0,0 +1,255 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef CLOSED_LOOP_SIMULATION_H_
+#define CLOSED_LOOP_SIMULATION_H_
+
+#include <teb_local_planner/benchmark/benchmark_scenarios.h>
+#include <teb_local_planner/planner_interface.h>
+#include <teb_local_planner/collision_checker.h>
+#include <teb_local_planner/recovery_behaviors.h>
+#include <teb_local_planner/replanning_monitor.h>
+#include <teb_local_planner/speculative_planner.h>
+#include <teb_local_planner/obstacle_corridor.h>
+#include <teb_local_planner/clock.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+#include <vector>
+
+
+namespace teb_local_planner
+{
+
+//! Kinematic models of the simulated robot
+enum class RobotKinematics { DiffDrive, Holonomic, CarLike };
+
+/**
+ * @brief Parse the name of a kinematic model (diff_drive, holonomic, carlike)
+ * @param name name of the kinematic model
+ * @param[out] kinematics parsed kinematic model
+ * @return \c true if the name is known, \c false otherwise
+ */
+bool kinematicsFromString(const std::string& name, RobotKinematics& kinematics);
+
+/**
+ * @brief Return the name of a kinematic model
+ * @param kinematics kinematic model
+ * @return name of the kinematic model (diff_drive, holonomic, carlike)
+ */
+std::string kinematicsToString(RobotKinematics kinematics);
+
+/**
+ * @brief Adapt the robot parameters of a config to a kinematic model
+ * 
+ * Scenario specific values are kept if they are compatible with the kinematic model
+ * (e.g. the minimum turning radius of a car-like scenario).
+ * @param kinematics kinematic model of the simulated robot
+ * @param[in,out] cfg config to be modified
+ */
+void applyKinematics(RobotKinematics kinematics, TebConfig& cfg);
+
+
+/**
+ * @struct SimulationSettings
+ * @brief Parameters of the closed-loop simulation
+ */
+struct SimulationSettings
+{
+  RobotKinematics kinematics = RobotKinematics::DiffDrive; //!< Kinematic model of the simulated robot
+  double dt = 0.1; //!< Fixed control period (simulated time) [s]
+  double max_duration = 60; //!< Abort the mission after this amount of simulated time [s]
+  double local_map_radius = 3; //!< Radius of the (virtual) local map, poses of the global plan outside are ignored [m]
+  double global_plan_resolution = 0.1; //!< Distance between two consecutive poses of the generated global plan [m]
+};
+
+
+/**
+ * @struct SimulationResult
+ * @brief Metrics collected during a closed-loop simulation
+ */
+struct SimulationResult
+{
+  bool goal_reached = false; //!< The robot reached the goal within the given tolerances
+  double time_to_goal = 0; //!< Simulated time until the goal has been reached (or the mission was aborted) [s]
+  double wall_time = 0; //!< Wall time of the complete mission (including the robot and obstacle simulation) [s]
+  double path_length = 0; //!< Length of the path travelled by the robot [m]
+  std::vector<double> cycle_times_ms; //!< Wall time of each control cycle (plan processing, planning, feasibility check and command generation)
+  std::vector<double> planning_times_ms; //!< Wall time of each plan() call
+  int collision_events = 0; //!< Number of times the robot footprint started to overlap an obstacle
+  int collision_cycles = 0; //!< Number of control cycles in which the robot footprint overlaps an obstacle
+  double min_clearance = 0; //!< Minimum distance between the robot footprint and all obstacles along the executed path [m]
+  int planning_failures = 0; //!< Number of cycles in which the planner did not return a solution
+  int infeasible_trajectories = 0; //!< Number of cycles in which the trajectory did not pass the feasibility check
+  int invalid_commands = 0; //!< Number of cycles in which no valid velocity command could be obtained
+  int horizon_reductions = 0; //!< Number of cycles with an active reduced horizon backup mode
+  int oscillation_recoveries = 0; //!< Number of times the oscillation recovery has been activated
+  int refinements = 0; //!< Number of cycles in which the previous trajectory has only been refined (event-driven replanning)
+  int speculative_hits = 0; //!< Number of cycles that used the result of the speculative optimization (speculative planning)
+};
+
+
+/**
+ * @class ObstacleCollisionChecker
+ * @brief FootprintCollisionChecker that validates poses against a container of (synthetic) obstacles
+ */
+class ObstacleCollisionChecker : public FootprintCollisionChecker
+{
+public:
+  
+  /**
+   * @brief Construct the collision checker
+   * @param robot_model footprint model of the robot
+   * @param obstacles obstacles to be checked (the container must outlive the checker)
+   */
+  ObstacleCollisionChecker(const RobotFootprintModelPtr& robot_model, const ObstContainer* obstacles)
+    : robot_model_(robot_model), obstacles_(obstacles) {}
+  
+  // implements footprintCost() of the base class
+  virtual double footprintCost(const PoseSE2& pose) const;
+  
+  // implements getInscribedRadius() of the base class
+  virtual double getInscribedRadius() const {return robot_model_->getInscribedRadius();}
+  
+  /**
+   * @brief Compute the minimum distance between the robot footprint at a given pose and all obstacles
+   * @param pose robot pose
+   * @return minimum distance, values <= 0 indicate a collision
+   */
+  double computeClearance(const PoseSE2& pose) const;
+  
+private:
+  RobotFootprintModelPtr robot_model_; //!< Footprint model of the robot
+  const ObstContainer* obstacles_; //!< Obstacles to be checked
+};
+
+
+/**
+ * @class ClosedLoopSimulation
+ * @brief Headless closed-loop simulation of complete missions
+ * 
+ * The planner is executed in closed loop with a simple kinematic robot model
+ * (differential drive, holonomic or car-like). The global plan is a straight polyline through
+ * the via-points of the scenario, dynamic obstacles are propagated with a constant velocity model
+ * and time advances with a fixed control period, hence missions run much faster than real time.
+ * 
+ * Each control cycle follows the logic of TebLocalPlannerROS::computeVelocityCommands() by means of
+ * the ROS-free helpers in plan_processing.h and the BackupModeManager
+ * (plan pruning, local plan extraction, via-points, backup modes, feasibility check and velocity saturation).
+ * Like the obstacle container of the ROS node, the obstacles offered to the planner are refreshed from the
+ * scenario in each cycle (and optionally prefiltered by the ObstacleCorridorFilter), whereas the collision check
+ * always considers all obstacles of the scenario.
+ * 
+ * @remarks The planner and the backup modes obtain the time from a ManualClock of the simulation
+ *          in order to advance the planner time with the simulated time. The global clock (refer to setClock())
+ *          is not modified, hence multiple simulations may run concurrently.
+ */
+class ClosedLoopSimulation
+{
+public:
+  
+  /**
+   * @brief Construct the simulation
+   * @param scenario scenario that defines start, goal, obstacles and the robot footprint (obstacles are modified during the simulation)
+   * @param cfg planner configuration (the scenario and kinematic specific overrides must already be applied, must outlive the simulation)
+   * @param settings simulation settings
+   */
+  ClosedLoopSimulation(BenchmarkScenario& scenario, const TebConfig& cfg, const SimulationSettings& settings);
+  
+  /**
+   * @brief Run the mission until the goal is reached or the maximum duration is exceeded
+   * @param[out] result metrics of the mission
+   * @return \c true if the goal has been reached, \c false otherwise
+   */
+  bool run(SimulationResult& result);
+  
+  /**
+   * @brief Access the planner (e.g. in order to query the current trajectory)
+   */
+  const PlannerInterfacePtr& planner() const {return planner_;}
+  
+protected:
+  
+  /**
+   * @brief Execute a single control cycle and compute the next velocity command
+   * @param[out] cmd velocity command (zero if the planner failed)
+   * @param[in,out] result metrics to be updated
+   * @return \c true if the goal is reached, \c false otherwise
+   */
+  bool controlCycle(Twist2D& cmd, SimulationResult& result);
+  
+  /**
+   * @brief Integrate the kinematic robot model over a single control period
+   * @param cmd velocity command
+   */
+  void integrateRobot(const Twist2D& cmd);
+  
+  /**
+   * @brief Sample the global plan (polyline from start through all via-points to the goal)
+   */
+  void createGlobalPlan();
+  
+private:
+  
+  BenchmarkScenario& scenario_; //!< Simulated scene
+  const TebConfig* cfg_; //!< Planner configuration
+  SimulationSettings settings_; //!< Simulation settings
+  
+  PlannerInterfacePtr planner_; //!< Planner under test
+  ObstacleCollisionChecker collision_checker_; //!< Feasibility check against the obstacles of the scenario
+  BackupModeManager backup_modes_; //!< Backup modes (reduced horizon, oscillation recovery)
+  ReplanningMonitor replanning_monitor_; //!< Change detection for event-driven replanning
+  SpeculativePlanner speculative_planner_; //!< Optimization for the predicted start state of the next cycle
+  ObstacleCorridorFilter corridor_filter_; //!< Obstacle prefilter (if corridor_prefilter is enabled)
+  ObstContainer planner_obstacles_; //!< Obstacles of the current cycle as seen by the planner
+  boost::shared_ptr<ManualClock> clock_; //!< Simulated time
+  
+  PoseSE2Container global_plan_; //!< Remaining global plan
+  ViaPointContainer via_points_; //!< Via-points considered by the planner
+  PoseSE2 robot_pose_; //!< Current pose of the simulated robot
+  Twist2D robot_vel_; //!< Current velocity of the simulated robot (robot frame)
+  Twist2D last_cmd_; //!< Last velocity command
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+} // namespace teb_local_planner
+
+#endif /* CLOSED_LOOP_SIMULATION_H_ */
@@ -0,0 +1,143 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef TEB_CLOCK_H_
+#define TEB_CLOCK_H_
+
+#include <boost/shared_ptr.hpp>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @class Clock
+ * @brief Abstract time source of the planning core
+ * 
+ * The planning core queries the current time only for time-based decisions
+ * (e.g. the blocking period for switching between homotopy classes).
+ * By default a monotonic system clock is used (see SteadyClock).
+ * A custom clock (e.g. ROS time or a simulated clock) can be registered globally via setClock()
+ * or passed to individual components (e.g. HomotopyClassPlanner, BackupModeManager),
+ * which fall back to the global clock otherwise.
+ */
+class Clock
+{
+public:
+  
+  /**
+   * @brief Virtual destructor.
+   */
+  virtual ~Clock() {}
+  
+  /**
+   * @brief Get the current time
+   * @return current time in seconds (the epoch is implementation specific, only differences are meaningful)
+   */
+  virtual double now() const = 0;
+};
+
+//! Abbrev. for shared clock instances
+typedef boost::shared_ptr<Clock> ClockPtr;
+
+
+/**
+ * @class SteadyClock
+ * @brief Default clock based on std::chrono::steady_clock
+ */
+class SteadyClock : public Clock
+{
+public:
+  // implements Clock::now()
+  virtual double now() const;
+};
+
+
+/**
+ * @class ManualClock
+ * @brief Clock whose time is set explicitly, e.g. for simulation and benchmarking
+ */
+class ManualClock : public Clock
+{
+public:
+  
+  /**
+   * @brief Construct the clock
+   * @param time initial time in seconds
+   */
+  ManualClock(double time = 0) : time_(time) {}
+  
+  // implements Clock::now()
+  virtual double now() const {return time_;}
+  
+  /**
+   * @brief Set the current time
+   * @param time new time in seconds
+   */
+  void setTime(double time) {time_ = time;}
+  
+  /**
+   * @brief Advance the current time
+   * @param dt time increment in seconds
+   */
+  void advance(double dt) {time_ += dt;}
+  
+protected:
+  double time_; //!< Current time in seconds
+};
+
+
+/**
+ * @brief Register a new global clock for the planning core
+ * 
+ * The clock is exchanged atomically, hence it may be replaced while planners are running.
+ * Components that query the time concurrently keep the previous clock alive until their query returns.
+ * Passing an empty pointer restores the default SteadyClock.
+ * @param clock shared pointer to the new clock
+ */
+void setClock(const ClockPtr& clock);
+
+/**
+ * @brief Access the currently registered global clock
+ * @return shared pointer to the active clock (never empty)
+ */
+ClockPtr getClock();
+
+} // namespace teb_local_planner
+
+#endif /* TEB_CLOCK_H_ */
@@ -0,0 +1,96 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef COLLISION_CHECKER_H_
+#define COLLISION_CHECKER_H_
+
+#include <boost/shared_ptr.hpp>
+
+#include <teb_local_planner/pose_se2.h>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @class FootprintCollisionChecker
+ * @brief Abstract interface for validating robot poses against an external world representation
+ * 
+ * The planners verify the feasibility of their trajectories by means of this interface
+ * (refer to PlannerInterface::isTrajectoryFeasible()). It decouples the planning core from
+ * a specific map representation, e.g. the ROS costmap (refer to CostmapCollisionChecker in ros_adapter.h).
+ */
+class FootprintCollisionChecker
+{
+public:
+  
+  /**
+   * @brief Virtual destructor.
+   */
+  virtual ~FootprintCollisionChecker() {}
+  
+  /**
+   * @brief Compute the cost of the robot footprint placed at a given pose
+   * @param pose robot pose in the planning frame
+   * @return cost of the footprint, a negative value indicates a collision (or a pose outside the map)
+   */
+  virtual double footprintCost(const PoseSE2& pose) const = 0;
+  
+  /**
+   * @brief Return the radius of the inscribed circle of the robot footprint
+   * 
+   * The radius defines the maximum distance between two consecutive poses that
+   * are checked without interpolating intermediate poses.
+   * @return inscribed radius [m]
+   */
+  virtual double getInscribedRadius() const = 0;
+  
+  /**
+   * @brief Callback that is invoked for the first infeasible pose found along a trajectory (e.g. for visualization)
+   * @param pose infeasible robot pose
+   */
+  virtual void infeasiblePoseDetected(const PoseSE2& pose) const {}
+  
+};
+
+//! Abbrev. for shared instances of the FootprintCollisionChecker or it's subclasses
+typedef boost::shared_ptr<FootprintCollisionChecker> FootprintCollisionCheckerPtr;
+
+} // namespace teb_local_planner
+
+#endif /* COLLISION_CHECKER_H_ */
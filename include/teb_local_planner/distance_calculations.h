@@ -260,6 +260,240 @@ inline double distance_polygon_to_polygon_2d(const Point2dContainer& vertices1,
 
   return dist;
 }
+
+
+/**
+ * @brief Line segment with precomputed geometric invariants
+ * 
+ * Obstacles with a static shape (LineObstacle, PolygonObstacle) store their edges in this representation,
+ * such that directions, lengths and normals are not recomputed for each distance query.
+ * A segment with coincident end points represents a single point.
+ */
+struct PrecomputedSegment2d
+{
+  Eigen::Vector2d start; //!< Start of the segment
+  Eigen::Vector2d end; //!< End of the segment
+  Eigen::Vector2d direction; //!< Segment direction (end - start)
+  Eigen::Vector2d normal; //!< Unit normal of the segment (outward, if the segment is an edge of a polygon; zero for a point)
+  double inv_sq_length; //!< Inverse squared length of the segment (zero for a point)
+  
+  PrecomputedSegment2d() : start(Eigen::Vector2d::Zero()), end(Eigen::Vector2d::Zero()), direction(Eigen::Vector2d::Zero()),
+                           normal(Eigen::Vector2d::Zero()), inv_sq_length(0) {}
+  
+  /**
+   * @brief Compute all invariants of the segment
+   * @param segment_start 2D point representing the start of the line segment
+   * @param segment_end 2D point representing the end of the line segment
+   * @param clockwise set to \c true if the segment is an edge of a polygon with clockwise ordered vertices (flips the normal outwards)
+   */
+  void set(const Eigen::Ref<const Eigen::Vector2d>& segment_start, const Eigen::Ref<const Eigen::Vector2d>& segment_end, bool clockwise = false)
+  {
+    start = segment_start;
+    end = segment_end;
+    direction = end - start;
+    double sq_norm = direction.squaredNorm();
+    if (sq_norm == 0)
+    {
+      inv_sq_length = 0;
+      normal.setZero();
+      return;
+    }
+    inv_sq_length = 1.0 / sq_norm;
+    normal.x() = direction.y();
+    normal.y() = -direction.x();
+    normal *= std::sqrt(inv_sq_length);
+    if (clockwise)
+      normal = -normal;
+  }
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+//! Abbrev. for a container storing precomputed segments (e.g. the edges of a polygon)
+typedef std::vector< PrecomputedSegment2d, Eigen::aligned_allocator<PrecomputedSegment2d> > PrecomputedSegmentContainer;
+
+
+/**
+ * @brief Helper function to obtain the closest point on a precomputed line segment w.r.t. a reference point
+ * @param point 2D point
+ * @param segment precomputed line segment
+ * @return Closest point on the line segment
+ */
+inline Eigen::Vector2d closest_point_on_line_segment_2d(const Eigen::Ref<const Eigen::Vector2d>& point, const PrecomputedSegment2d& segment)
+{
+  double u = ((point.x() - segment.start.x()) * segment.direction.x() + (point.y() - segment.start.y()) * segment.direction.y()) * segment.inv_sq_length;
+  
+  if (u <= 0) return segment.start;
+  else if (u >= 1) return segment.end;
+  
+  return segment.start + u*segment.direction;
+}
+
+/**
+ * @brief Helper function to calculate the squared distance between a precomputed line segment and a point
+ * @param point 2D point
+ * @param segment precomputed line segment
+ * @return squared minimum distance to the line segment
+ */
+inline double squared_distance_point_to_segment_2d(const Eigen::Ref<const Eigen::Vector2d>& point, const PrecomputedSegment2d& segment)
+{
+  return (point - closest_point_on_line_segment_2d(point, segment)).squaredNorm();
+}
+
+/**
+ * @brief Helper function to calculate the distance between a precomputed line segment and a point
+ * @param point 2D point
+ * @param segment precomputed line segment
+ * @return minimum distance to the line segment
+ */
+inline double distance_point_to_segment_2d(const Eigen::Ref<const Eigen::Vector2d>& point, const PrecomputedSegment2d& segment)
+{
+  return std::sqrt(squared_distance_point_to_segment_2d(point, segment));
+}
+
+/**
+ * @brief Helper function to check whether a line segment intersects a precomputed line segment
+ * 
+ * The normal of the precomputed segment rejects most non-intersecting pairs before the full intersection test.
+ * @param line_start 2D point representing the start of the line segment
+ * @param line_end 2D point representing the end of the line segment
+ * @param segment precomputed line segment
+ * @return \c true if both line segments intersect
+ */
+inline bool check_line_segments_intersection_2d(const Eigen::Ref<const Eigen::Vector2d>& line_start, const Eigen::Ref<const Eigen::Vector2d>& line_end,
+                                                const PrecomputedSegment2d& segment)
+{
+  // both end points strictly on the same side of the supporting line -> no intersection
+  double side_start = segment.normal.dot(line_start - segment.start);
+  double side_end = segment.normal.dot(line_end - segment.start);
+  if ((side_start > 0 && side_end > 0) || (side_start < 0 && side_end < 0))
+    return false;
+  return check_line_segments_intersection_2d(line_start, line_end, segment.start, segment.end);
+}
+
+/**
+ * @brief Helper function to calculate the smallest squared distance between a line segment and a precomputed line segment
+ * @param line_start 2D point representing the start of the line segment
+ * @param line_end 2D point representing the end of the line segment
+ * @param segment precomputed line segment
+ * @return smallest squared distance between both segments
+ */
+inline double squared_distance_segment_to_segment_2d(const Eigen::Ref<const Eigen::Vector2d>& line_start, const Eigen::Ref<const Eigen::Vector2d>& line_end,
+                                                     const PrecomputedSegment2d& segment)
+{
+  if (check_line_segments_intersection_2d(line_start, line_end, segment))
+    return 0;
+  
+  double dist = std::min(squared_distance_point_to_segment_2d(line_start, segment), squared_distance_point_to_segment_2d(line_end, segment));
+  dist = std::min(dist, (segment.start - closest_point_on_line_segment_2d(segment.start, line_start, line_end)).squaredNorm());
+  return std::min(dist, (segment.end - closest_point_on_line_segment_2d(segment.end, line_start, line_end)).squaredNorm());
+}
+
+/**
+ * @brief Helper function to calculate the smallest distance between a line segment and a precomputed line segment
+ * @param line_start 2D point representing the start of the line segment
+ * @param line_end 2D point representing the end of the line segment
+ * @param segment precomputed line segment
+ * @return smallest distance between both segments
+ */
+inline double distance_segment_to_segment_2d(const Eigen::Ref<const Eigen::Vector2d>& line_start, const Eigen::Ref<const Eigen::Vector2d>& line_end,
+                                             const PrecomputedSegment2d& segment)
+{
+  return std::sqrt(squared_distance_segment_to_segment_2d(line_start, line_end, segment));
+}
+
+/**
+ * @brief Helper function to calculate the smallest distance between a point and a polygon given by its precomputed edges
+ * @param point 2D point
+ * @param edges Precomputed edges of the polygon (including the closing edge; a single degenerate edge represents a point)
+ * @return smallest distance between point and polygon
+ */
+inline double distance_point_to_polygon_2d(const Eigen::Vector2d& point, const PrecomputedSegmentContainer& edges)
+{
+  double sq_dist = HUGE_VAL;
+  for (const PrecomputedSegment2d& edge : edges)
+    sq_dist = std::min(sq_dist, squared_distance_point_to_segment_2d(point, edge));
+  return std::sqrt(sq_dist);
+}
+
+/**
+ * @brief Helper function to calculate the smallest distance between a line segment and a polygon given by its precomputed edges
+ * @param line_start 2D point representing the start of the line segment
+ * @param line_end 2D point representing the end of the line segment
+ * @param edges Precomputed edges of the polygon (including the closing edge; a single degenerate edge represents a point)
+ * @return smallest distance between line segment and polygon
+ */
+inline double distance_segment_to_polygon_2d(const Eigen::Vector2d& line_start, const Eigen::Vector2d& line_end, const PrecomputedSegmentContainer& edges)
+{
+  double sq_dist = HUGE_VAL;
+  for (const PrecomputedSegment2d& edge : edges)
+  {
+    sq_dist = std::min(sq_dist, squared_distance_segment_to_segment_2d(line_start, line_end, edge));
+    if (sq_dist == 0)
+      break;
+  }
+  return std::sqrt(sq_dist);
+}
+
+/**
+ * @brief Helper function to calculate the smallest squared distance between a (translated) closed polygon and a precomputed line segment
+ * @param vertices Vertices describing the closed polygon (the first vertex is not repeated at the end)
+ * @param segment precomputed line segment
+ * @param offset Translation that is applied to \c vertices (avoids copying the polygon, e.g. for predicted obstacles)
+ * @return smallest squared distance between polygon and line segment
+ */
+inline double squared_distance_polygon_to_segment_2d(const Point2dContainer& vertices, const PrecomputedSegment2d& segment, const Eigen::Vector2d& offset)
+{
+  if (vertices.empty())
+    return HUGE_VAL;
+  
+  if (vertices.size() == 1)
+    return squared_distance_point_to_segment_2d(vertices.front() + offset, segment);
+  
+  double sq_dist = HUGE_VAL;
+  int no_edges = vertices.size() > 2 ? (int)vertices.size() : 1; // a line is not closed
+  for (int i=0; i < no_edges; ++i)
+  {
+    sq_dist = std::min(sq_dist, squared_distance_segment_to_segment_2d(vertices[i] + offset, vertices[(i+1) % vertices.size()] + offset, segment));
+    if (sq_dist == 0)
+      break;
+  }
+  return sq_dist;
+}
+
+/**
+ * @brief Helper function to calculate the smallest distance between a (translated) closed polygon and a precomputed line segment
+ * @param vertices Vertices describing the closed polygon (the first vertex is not repeated at the end)
+ * @param segment precomputed line segment
+ * @param offset Translation that is applied to \c vertices (avoids copying the polygon, e.g. for predicted obstacles)
+ * @return smallest distance between polygon and line segment
+ */
+inline double distance_polygon_to_segment_2d(const Point2dContainer& vertices, const PrecomputedSegment2d& segment,
+                                             const Eigen::Vector2d& offset = Eigen::Vector2d::Zero())
+{
+  return std::sqrt(squared_distance_polygon_to_segment_2d(vertices, segment, offset));
+}
+
+/**
+ * @brief Helper function to calculate the smallest distance between a (translated) closed polygon and a polygon given by its precomputed edges
+ * @param vertices1 Vertices describing the first closed polygon (the first vertex is not repeated at the end)
+ * @param edges2 Precomputed edges of the second polygon (including the closing edge; a single degenerate edge represents a point)
+ * @param offset1 Translation that is applied to \c vertices1 (avoids copying the polygon, e.g. for predicted obstacles)
+ * @return smallest distance between both polygons
+ */
+inline double distance_polygon_to_polygon_2d(const Point2dContainer& vertices1, const PrecomputedSegmentContainer& edges2,
+                                             const Eigen::Vector2d& offset1 = Eigen::Vector2d::Zero())
+{
+  double sq_dist = HUGE_VAL;
+  for (const PrecomputedSegment2d& edge : edges2)
+  {
+    sq_dist = std::min(sq_dist, squared_distance_polygon_to_segment_2d(vertices1, edge, offset1));
+    if (sq_dist == 0)
+      break;
+  }
+  return std::sqrt(sq_dist);
+}
   
   
   
@@ -0,0 +1,213 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef EXPERIENCE_CACHE_H_
+#define EXPERIENCE_CACHE_H_
+
+#include <teb_local_planner/pose_se2.h>
+#include <teb_local_planner/obstacles.h>
+#include <teb_local_planner/robot_footprint_model.h>
+#include <teb_local_planner/timed_elastic_band.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/utility.hpp>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @struct ExperienceDescriptor
+ * @brief Key of a planning problem in the ExperienceCache
+ * 
+ * The goal is expressed w.r.t. the start frame. The obstacle layout is quantized by an 8x8 occupancy grid
+ * that is centered between start and goal and aligned with the start orientation. Dynamic obstacles are ignored.
+ */
+struct ExperienceDescriptor
+{
+  PoseSE2 relative_goal; //!< Goal pose w.r.t. the start frame
+  uint64_t occupancy; //!< Occupancy grid (bit 8*row+col is set if the cell is occupied)
+  std::string robot; //!< Robot model identifier (see ExperienceCache::robotIdentifier())
+  
+  /**
+   * @brief Number of grid cells that differ between two descriptors
+   */
+  int cellMismatch(const ExperienceDescriptor& other) const;
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+/**
+ * @class ExperienceCache
+ * @brief Bounded cache of optimized trajectories that serve as initial guess for similar planning problems
+ * 
+ * Robots often repeat the same maneuvers (e.g. docking or passing a doorway). Instead of initializing a new
+ * trajectory from the global plan, the trajectory of the most similar stored planning problem is transformed
+ * into the current start frame and bent such that it ends exactly at the current goal.
+ * 
+ * Trajectories are stored w.r.t. their start frame. The number of entries is bounded, the least recently used
+ * entry is evicted. The cache can be stored to and restored from a file in order to persist across restarts.
+ * All methods are thread-safe, hence a single instance can be shared among several planners.
+ */
+class ExperienceCache : boost::noncopyable
+{
+public:
+  
+  /**
+   * @brief Construct the cache
+   * @param max_entries maximum number of stored trajectories
+   * @param grid_resolution cell size of the occupancy grid of the descriptor [m]
+   */
+  ExperienceCache(int max_entries = 200, double grid_resolution = 0.5);
+  
+  /**
+   * @brief Compute the descriptor of a planning problem
+   * @param start start pose
+   * @param goal goal pose
+   * @param obstacles obstacle container (might be \c NULL)
+   * @param robot robot model identifier (see robotIdentifier())
+   * @param[out] descriptor the resulting descriptor
+   */
+  void describe(const PoseSE2& start, const PoseSE2& goal, const ObstContainer* obstacles, const std::string& robot,
+                ExperienceDescriptor& descriptor) const;
+  
+  /**
+   * @brief Store an optimized trajectory
+   * 
+   * An existing entry with the same occupancy grid and an almost identical relative goal is replaced.
+   * @param descriptor descriptor of the planning problem (see describe())
+   * @param teb optimized trajectory (from the start to the goal of the planning problem)
+   */
+  void insert(const ExperienceDescriptor& descriptor, const TimedElasticBand& teb);
+  
+  /**
+   * @brief Initialize a trajectory from the most similar stored planning problem
+   * @param descriptor descriptor of the current planning problem (see describe())
+   * @param start current start pose
+   * @param goal current goal pose
+   * @param max_goal_distance maximum distance between the relative goals [m]
+   * @param max_goal_angle maximum orientation difference between the relative goals [rad]
+   * @param max_cell_mismatch maximum number of differing occupancy grid cells
+   * @param[out] teb trajectory to be initialized (must be empty)
+   * @return \c true if a matching entry has been found and \c teb has been initialized, \c false otherwise
+   */
+  bool retrieve(const ExperienceDescriptor& descriptor, const PoseSE2& start, const PoseSE2& goal, double max_goal_distance,
+                double max_goal_angle, int max_cell_mismatch, TimedElasticBand& teb);
+  
+  /**
+   * @brief Store all entries to a file
+   * @param filename path of the file
+   * @return \c true on success, \c false otherwise
+   */
+  bool save(const std::string& filename) const;
+  
+  /**
+   * @brief Restore the entries from a file (the current entries are replaced)
+   * @param filename path of the file
+   * @return \c true on success, \c false otherwise
+   */
+  bool load(const std::string& filename);
+  
+  /**
+   * @brief Number of stored trajectories
+   */
+  std::size_t size() const;
+  
+  /**
+   * @brief Remove all entries
+   */
+  void clear();
+  
+  /**
+   * @brief Number of successful retrievals since construction
+   */
+  unsigned long hits() const;
+  
+  /**
+   * @brief Number of unsuccessful retrievals since construction
+   */
+  unsigned long misses() const;
+  
+  /**
+   * @brief Build an identifier of a robot model
+   * 
+   * Entries are only retrieved for the robot model they have been stored for.
+   * @param robot_model footprint model of the robot
+   * @param min_turning_radius minimum turning radius (zero for non car-like robots)
+   * @return identifier that contains the type, the inscribed radius and a hash of the geometry of the footprint model
+   *         as well as the turning radius
+   */
+  static std::string robotIdentifier(const RobotFootprintModelPtr& robot_model, double min_turning_radius);
+  
+private:
+  
+  //! A stored trajectory
+  struct Entry
+  {
+    ExperienceDescriptor descriptor; //!< Descriptor of the planning problem
+    PoseSE2Container poses; //!< Poses w.r.t. the start frame
+    std::vector<double> timediffs; //!< Time differences between consecutive poses
+    unsigned long last_used; //!< Value of use_counter_ at the last insertion or retrieval
+    
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+  
+  std::vector<Entry, Eigen::aligned_allocator<Entry> > entries_; //!< Stored trajectories
+  int max_entries_; //!< Maximum number of stored trajectories
+  double grid_resolution_; //!< Cell size of the occupancy grid [m]
+  unsigned long use_counter_; //!< Logical clock for the least recently used eviction
+  unsigned long hits_; //!< Number of successful retrievals
+  unsigned long misses_; //!< Number of unsuccessful retrievals
+  
+  mutable boost::mutex mutex_; //!< Mutex that protects the entries against concurrent access
+};
+
+//! Abbrev. for shared instances of the ExperienceCache
+typedef boost::shared_ptr<ExperienceCache> ExperienceCachePtr;
+
+} // namespace teb_local_planner
+
+#endif /* EXPERIENCE_CACHE_H_ */
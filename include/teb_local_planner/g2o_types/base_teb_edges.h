@@ -45,6 +45,7 @@
 #define _BASE_TEB_EDGES_H_
 
 #include <teb_local_planner/teb_config.h>
+#include <teb_local_planner/logging.h>
 
 #include <g2o/core/base_binary_edge.h>
 #include <g2o/core/base_unary_edge.h>
@@ -337,8 +338,90 @@ public:
 };
 
 
+/**
+ * @class ConstraintEdge
+ * @brief Interface of edges whose errors contain hard constraints (velocity, acceleration and obstacle separation)
+ * 
+ * The interface is utilized by the augmented Lagrangian mode of the TebOptimalPlanner
+ * (refer to TebConfig::Optimization::augmented_lagrangian) and for reporting the constraint violation.
+ * @see ConstraintShift
+ */
+class ConstraintEdge
+{
+public:
+  
+  /**
+   * @brief Virtual destructor
+   */
+  virtual ~ConstraintEdge() {}
+  
+  /**
+   * @brief Update the multipliers with the constraint violation of the last error computation
+   */
+  virtual void updateMultipliers() = 0;
+  
+  /**
+   * @brief Reset all multipliers to zero (the edge then represents the plain penalty again)
+   */
+  virtual void resetMultipliers() = 0;
+  
+  /**
+   * @brief Get the largest constraint violation of the last error computation (excluding the multiplier shift)
+   * @return largest penalty value of the constraint components
+   */
+  virtual double getConstraintViolation() const = 0;
+};
 
 
+/**
+ * @class ConstraintShift
+ * @brief Shifts the leading constraint components of an edge error by the scaled multipliers of the augmented Lagrangian
+ * 
+ * The penalty errors \f$ e_c \f$ of the first \e C error components are nonnegative and vanish if the constraints are satisfied.
+ * Treating \f$ e_c = 0 \f$ as equality constraint, the augmented Lagrangian term with multipliers \f$ \lambda \f$ and weight \f$ \rho \f$
+ * equals the least-squares term \f$ \rho \| e_c + s \|^2 \f$ (up to a constant) with shift \f$ s = \lambda / \rho \f$.
+ * The first-order multiplier update reads \f$ s \leftarrow s + e_c \f$.
+ * Since \f$ e_c \geq 0 \f$, the multipliers grow as long as a constraint is violated and the edge becomes an exact penalty:
+ * the constraints are satisfied with a finite weight instead of a weight increased in each outer iteration.
+ * The shift is constant w.r.t. the vertices, hence the jacobians are not affected.
+ * @tparam C number of leading error components that represent constraints
+ */
+template <int C>
+class ConstraintShift : public ConstraintEdge
+{
+public:
+  
+  /**
+   * @brief Construct with zero multipliers
+   */
+  ConstraintShift()
+  {
+    shift_.setZero();
+    violation_.setZero();
+  }
+  
+  virtual void updateMultipliers() {shift_ += violation_;}
+  
+  virtual void resetMultipliers() {shift_.setZero();}
+  
+  virtual double getConstraintViolation() const {return violation_.maxCoeff();}
+  
+protected:
+  
+  /**
+   * @brief Store the constraint components of the error and apply the shift (call at the end of computeError())
+   * @param[in,out] error error vector of the edge
+   */
+  template <typename ErrorVectorType>
+  void applyConstraintShift(ErrorVectorType& error)
+  {
+    violation_ = error.template head<C>();
+    error.template head<C>() += shift_;
+  }
+  
+  Eigen::Matrix<double, C, 1> shift_; //!< Multipliers scaled by the inverse weight
+  Eigen::Matrix<double, C, 1> violation_; //!< Constraint components of the last error computation
+};
 
 
 } // end namespace
@@ -49,8 +49,9 @@
 #include <teb_local_planner/g2o_types/penalties.h>
 #include <teb_local_planner/teb_config.h>
 #include <teb_local_planner/g2o_types/base_teb_edges.h>
+#include <teb_local_planner/g2o_types/edge_chain_batch.h>
 
-#include <geometry_msgs/Twist.h>
+#include <teb_local_planner/teb_types.h>
 
 
 
@@ -72,10 +73,11 @@ namespace teb_local_planner
  * @see TebOptimalPlanner::AddEdgesAcceleration
  * @see EdgeAccelerationStart
  * @see EdgeAccelerationGoal
+ * @see EdgeChainBatch
  * @remarks Do not forget to call setTebConfig()
  * @remarks Refer to EdgeAccelerationStart() and EdgeAccelerationGoal() for defining boundary values!
  */    
-class EdgeAcceleration : public BaseTebMultiEdge<2, double>
+class EdgeAcceleration : public BaseTebMultiEdge<2, double>, public BatchableEdge, public ConstraintShift<2>
 {
 public:
 
@@ -92,61 +94,34 @@ public:
    */   
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeAcceleration()");
+    TEB_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeAcceleration()");
     const VertexPose* pose1 = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* pose2 = static_cast<const VertexPose*>(_vertices[1]);
     const VertexPose* pose3 = static_cast<const VertexPose*>(_vertices[2]);
     const VertexTimeDiff* dt1 = static_cast<const VertexTimeDiff*>(_vertices[3]);
     const VertexTimeDiff* dt2 = static_cast<const VertexTimeDiff*>(_vertices[4]);
 
-    // VELOCITY & ACCELERATION
-    const Eigen::Vector2d diff1 = pose2->position() - pose1->position();
-    const Eigen::Vector2d diff2 = pose3->position() - pose2->position();
-        
-    double dist1 = diff1.norm();
-    double dist2 = diff2.norm();
-    const double angle_diff1 = g2o::normalize_theta(pose2->theta() - pose1->theta());
-    const double angle_diff2 = g2o::normalize_theta(pose3->theta() - pose2->theta());
-    
-    if (cfg_->trajectory.exact_arc_length) // use exact arc length instead of Euclidean approximation
-    {
-        if (angle_diff1 != 0)
-        {
-            const double radius =  dist1/(2*sin(angle_diff1/2));
-            dist1 = fabs( angle_diff1 * radius ); // actual arg length!
-        }
-        if (angle_diff2 != 0)
-        {
-            const double radius =  dist2/(2*sin(angle_diff2/2));
-            dist2 = fabs( angle_diff2 * radius ); // actual arg length!
-        }
-    }
-    
-    double vel1 = dist1 / dt1->dt();
-    double vel2 = dist2 / dt2->dt();
+    accelerationErrorKernel(*cfg_, PoseSample::fromVertex(*pose1), PoseSample::fromVertex(*pose2), PoseSample::fromVertex(*pose3, false),
+                            dt1->dt(), dt2->dt(), _error.data());
     
-    
-    // consider directions
-//     vel1 *= g2o::sign(diff1[0]*cos(pose1->theta()) + diff1[1]*sin(pose1->theta())); 
-//     vel2 *= g2o::sign(diff2[0]*cos(pose2->theta()) + diff2[1]*sin(pose2->theta())); 
-    vel1 *= fast_sigmoid( 100*(diff1.x()*cos(pose1->theta()) + diff1.y()*sin(pose1->theta())) ); 
-    vel2 *= fast_sigmoid( 100*(diff2.x()*cos(pose2->theta()) + diff2.y()*sin(pose2->theta())) ); 
-    
-    const double acc_lin  = (vel2 - vel1)*2 / ( dt1->dt() + dt2->dt() );
-   
+    applyConstraintShift(_error);
 
-    _error[0] = penaltyBoundToInterval(acc_lin,cfg_->robot.acc_lim_x,cfg_->optim.penalty_epsilon);
-    
-    // ANGULAR ACCELERATION
-    const double omega1 = angle_diff1 / dt1->dt();
-    const double omega2 = angle_diff2 / dt2->dt();
-    const double acc_rot  = (omega2 - omega1)*2 / ( dt1->dt() + dt2->dt() );
-      
-    _error[1] = penaltyBoundToInterval(acc_rot,cfg_->robot.acc_lim_theta,cfg_->optim.penalty_epsilon);
-
-    
-    ROS_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAcceleration::computeError() translational: _error[0]=%f\n",_error[0]);
-    ROS_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAcceleration::computeError() rotational: _error[1]=%f\n",_error[1]);
+    TEB_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAcceleration::computeError() translational: _error[0]=%f\n",_error[0]);
+    TEB_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAcceleration::computeError() rotational: _error[1]=%f\n",_error[1]);
+  }
+  
+  /**
+   * @brief Jacobi matrix of the cost function specified in computeError().
+   * 
+   * Taken from the EdgeChainBatch if the edge is attached to an active batch, otherwise computed numerically by g2o.
+   */
+  void linearizeOplus()
+  {
+    double* jacobians[5] = {_jacobianOplus[0].data(), _jacobianOplus[1].data(), _jacobianOplus[2].data(),
+                            _jacobianOplus[3].data(), _jacobianOplus[4].data()};
+    if (batch_ && batch_->getJacobians(EdgeChainType::Acceleration, batch_index_, jacobians))
+      return;
+    BaseTebMultiEdge<2, double>::linearizeOplus();
   }
 
 
@@ -158,7 +133,7 @@ public:
    */
   void linearizeOplus()
   {
-    ROS_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeAcceleration()");
+    TEB_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeAcceleration()");
     const VertexPointXY* conf1 = static_cast<const VertexPointXY*>(_vertices[0]);
     const VertexPointXY* conf2 = static_cast<const VertexPointXY*>(_vertices[1]);
     const VertexPointXY* conf3 = static_cast<const VertexPointXY*>(_vertices[2]);
@@ -288,7 +263,7 @@ public:
  * @remarks Do not forget to call setTebConfig()
  * @remarks Refer to EdgeAccelerationGoal() for defining boundary values at the end of the trajectory!
  */      
-class EdgeAccelerationStart : public BaseTebMultiEdge<2, const geometry_msgs::Twist*>
+class EdgeAccelerationStart : public BaseTebMultiEdge<2, const Twist2D*>, public ConstraintShift<2>
 {
 public:
 
@@ -307,7 +282,7 @@ public:
    */   
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_ && _measurement, "You must call setTebConfig() and setStartVelocity() on EdgeAccelerationStart()");
+    TEB_ASSERT_MSG(cfg_ && _measurement, "You must call setTebConfig() and setStartVelocity() on EdgeAccelerationStart()");
     const VertexPose* pose1 = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* pose2 = static_cast<const VertexPose*>(_vertices[1]);
     const VertexTimeDiff* dt = static_cast<const VertexTimeDiff*>(_vertices[2]);
@@ -322,33 +297,35 @@ public:
         dist = fabs( angle_diff * radius ); // actual arg length!
     }
     
-    const double vel1 = _measurement->linear.x;
+    const double vel1 = _measurement->vx;
     double vel2 = dist / dt->dt();
 
     // consider directions
     //vel2 *= g2o::sign(diff[0]*cos(pose1->theta()) + diff[1]*sin(pose1->theta())); 
-    vel2 *= fast_sigmoid( 100*(diff.x()*cos(pose1->theta()) + diff.y()*sin(pose1->theta())) ); 
+    vel2 *= fast_sigmoid( 100*(diff.x()*pose1->cosTheta() + diff.y()*pose1->sinTheta()) ); 
     
     const double acc_lin  = (vel2 - vel1) / dt->dt();
     
     _error[0] = penaltyBoundToInterval(acc_lin,cfg_->robot.acc_lim_x,cfg_->optim.penalty_epsilon);
     
     // ANGULAR ACCELERATION
-    const double omega1 = _measurement->angular.z;
+    const double omega1 = _measurement->omega;
     const double omega2 = angle_diff / dt->dt();
     const double acc_rot  = (omega2 - omega1) / dt->dt();
       
     _error[1] = penaltyBoundToInterval(acc_rot,cfg_->robot.acc_lim_theta,cfg_->optim.penalty_epsilon);
 
-    ROS_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAccelerationStart::computeError() translational: _error[0]=%f\n",_error[0]);
-    ROS_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAccelerationStart::computeError() rotational: _error[1]=%f\n",_error[1]);
+    applyConstraintShift(_error);
+
+    TEB_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAccelerationStart::computeError() translational: _error[0]=%f\n",_error[0]);
+    TEB_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAccelerationStart::computeError() rotational: _error[1]=%f\n",_error[1]);
   }
   
   /**
    * @brief Set the initial velocity that is taken into account for calculating the acceleration
-   * @param vel_start twist message containing the translational and rotational velocity
+   * @param vel_start twist containing the translational and rotational velocity
    */    
-  void setInitialVelocity(const geometry_msgs::Twist& vel_start)
+  void setInitialVelocity(const Twist2D& vel_start)
   {
     _measurement = &vel_start;
   }
@@ -379,7 +356,7 @@ public:
  * @remarks Do not forget to call setTebConfig()
  * @remarks Refer to EdgeAccelerationStart() for defining boundary (initial) values at the end of the trajectory
  */  
-class EdgeAccelerationGoal : public BaseTebMultiEdge<2, const geometry_msgs::Twist*>
+class EdgeAccelerationGoal : public BaseTebMultiEdge<2, const Twist2D*>, public ConstraintShift<2>
 {
 public:
 
@@ -398,7 +375,7 @@ public:
    */ 
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_ && _measurement, "You must call setTebConfig() and setGoalVelocity() on EdgeAccelerationGoal()");
+    TEB_ASSERT_MSG(cfg_ && _measurement, "You must call setTebConfig() and setGoalVelocity() on EdgeAccelerationGoal()");
     const VertexPose* pose_pre_goal = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* pose_goal = static_cast<const VertexPose*>(_vertices[1]);
     const VertexTimeDiff* dt = static_cast<const VertexTimeDiff*>(_vertices[2]);
@@ -415,11 +392,11 @@ public:
     }
     
     double vel1 = dist / dt->dt();
-    const double vel2 = _measurement->linear.x;
+    const double vel2 = _measurement->vx;
     
     // consider directions
     //vel1 *= g2o::sign(diff[0]*cos(pose_pre_goal->theta()) + diff[1]*sin(pose_pre_goal->theta())); 
-    vel1 *= fast_sigmoid( 100*(diff.x()*cos(pose_pre_goal->theta()) + diff.y()*sin(pose_pre_goal->theta())) ); 
+    vel1 *= fast_sigmoid( 100*(diff.x()*pose_pre_goal->cosTheta() + diff.y()*pose_pre_goal->sinTheta()) ); 
     
     const double acc_lin  = (vel2 - vel1) / dt->dt();
 
@@ -427,20 +404,22 @@ public:
     
     // ANGULAR ACCELERATION
     const double omega1 = angle_diff / dt->dt();
-    const double omega2 = _measurement->angular.z;
+    const double omega2 = _measurement->omega;
     const double acc_rot  = (omega2 - omega1) / dt->dt();
       
     _error[1] = penaltyBoundToInterval(acc_rot,cfg_->robot.acc_lim_theta,cfg_->optim.penalty_epsilon);
 
-    ROS_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAccelerationGoal::computeError() translational: _error[0]=%f\n",_error[0]);
-    ROS_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAccelerationGoal::computeError() rotational: _error[1]=%f\n",_error[1]);
+    applyConstraintShift(_error);
+
+    TEB_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAccelerationGoal::computeError() translational: _error[0]=%f\n",_error[0]);
+    TEB_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAccelerationGoal::computeError() rotational: _error[1]=%f\n",_error[1]);
   }
     
   /**
    * @brief Set the goal / final velocity that is taken into account for calculating the acceleration
-   * @param vel_goal twist message containing the translational and rotational velocity
+   * @param vel_goal twist containing the translational and rotational velocity
    */    
-  void setGoalVelocity(const geometry_msgs::Twist& vel_goal)
+  void setGoalVelocity(const Twist2D& vel_goal)
   {
     _measurement = &vel_goal;
   }
@@ -471,7 +450,7 @@ public:
  * @remarks Do not forget to call setTebConfig()
  * @remarks Refer to EdgeAccelerationHolonomicStart() and EdgeAccelerationHolonomicGoal() for defining boundary values!
  */    
-class EdgeAccelerationHolonomic : public BaseTebMultiEdge<3, double>
+class EdgeAccelerationHolonomic : public BaseTebMultiEdge<3, double>, public ConstraintShift<3>
 {
 public:
 
@@ -488,7 +467,7 @@ public:
    */   
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeAcceleration()");
+    TEB_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeAcceleration()");
     const VertexPose* pose1 = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* pose2 = static_cast<const VertexPose*>(_vertices[1]);
     const VertexPose* pose3 = static_cast<const VertexPose*>(_vertices[2]);
@@ -499,10 +478,10 @@ public:
     Eigen::Vector2d diff1 = pose2->position() - pose1->position();
     Eigen::Vector2d diff2 = pose3->position() - pose2->position();
     
-    double cos_theta1 = std::cos(pose1->theta());
-    double sin_theta1 = std::sin(pose1->theta()); 
-    double cos_theta2 = std::cos(pose2->theta());
-    double sin_theta2 = std::sin(pose2->theta()); 
+    double cos_theta1 = pose1->cosTheta();
+    double sin_theta1 = pose1->sinTheta(); 
+    double cos_theta2 = pose2->cosTheta();
+    double sin_theta2 = pose2->sinTheta(); 
     
     // transform pose2 into robot frame pose1 (inverse 2d rotation matrix)
     double p1_dx =  cos_theta1*diff1.x() + sin_theta1*diff1.y();
@@ -532,9 +511,11 @@ public:
     _error[2] = penaltyBoundToInterval(acc_rot,cfg_->robot.acc_lim_theta,cfg_->optim.penalty_epsilon);
 
     
-    ROS_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAcceleration::computeError() translational: _error[0]=%f\n",_error[0]);
-    ROS_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAcceleration::computeError() strafing: _error[1]=%f\n",_error[1]);
-    ROS_ASSERT_MSG(std::isfinite(_error[2]), "EdgeAcceleration::computeError() rotational: _error[2]=%f\n",_error[2]);
+    applyConstraintShift(_error);
+
+    TEB_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAcceleration::computeError() translational: _error[0]=%f\n",_error[0]);
+    TEB_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAcceleration::computeError() strafing: _error[1]=%f\n",_error[1]);
+    TEB_ASSERT_MSG(std::isfinite(_error[2]), "EdgeAcceleration::computeError() rotational: _error[2]=%f\n",_error[2]);
   }
 
 public: 
@@ -563,7 +544,7 @@ public:
  * @remarks Do not forget to call setTebConfig()
  * @remarks Refer to EdgeAccelerationHolonomicGoal() for defining boundary values at the end of the trajectory!
  */      
-class EdgeAccelerationHolonomicStart : public BaseTebMultiEdge<3, const geometry_msgs::Twist*>
+class EdgeAccelerationHolonomicStart : public BaseTebMultiEdge<3, const Twist2D*>, public ConstraintShift<3>
 {
 public:
 
@@ -581,7 +562,7 @@ public:
    */   
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_ && _measurement, "You must call setTebConfig() and setStartVelocity() on EdgeAccelerationStart()");
+    TEB_ASSERT_MSG(cfg_ && _measurement, "You must call setTebConfig() and setStartVelocity() on EdgeAccelerationStart()");
     const VertexPose* pose1 = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* pose2 = static_cast<const VertexPose*>(_vertices[1]);
     const VertexTimeDiff* dt = static_cast<const VertexTimeDiff*>(_vertices[2]);
@@ -589,15 +570,15 @@ public:
     // VELOCITY & ACCELERATION
     Eigen::Vector2d diff = pose2->position() - pose1->position();
             
-    double cos_theta1 = std::cos(pose1->theta());
-    double sin_theta1 = std::sin(pose1->theta()); 
+    double cos_theta1 = pose1->cosTheta();
+    double sin_theta1 = pose1->sinTheta(); 
     
     // transform pose2 into robot frame pose1 (inverse 2d rotation matrix)
     double p1_dx =  cos_theta1*diff.x() + sin_theta1*diff.y();
     double p1_dy = -sin_theta1*diff.x() + cos_theta1*diff.y();
     
-    double vel1_x = _measurement->linear.x;
-    double vel1_y = _measurement->linear.y;
+    double vel1_x = _measurement->vx;
+    double vel1_y = _measurement->vy;
     double vel2_x = p1_dx / dt->dt();
     double vel2_y = p1_dy / dt->dt();
 
@@ -608,22 +589,24 @@ public:
     _error[1] = penaltyBoundToInterval(acc_lin_y,cfg_->robot.acc_lim_y,cfg_->optim.penalty_epsilon);
     
     // ANGULAR ACCELERATION
-    double omega1 = _measurement->angular.z;
+    double omega1 = _measurement->omega;
     double omega2 = g2o::normalize_theta(pose2->theta() - pose1->theta()) / dt->dt();
     double acc_rot  = (omega2 - omega1) / dt->dt();
       
     _error[2] = penaltyBoundToInterval(acc_rot,cfg_->robot.acc_lim_theta,cfg_->optim.penalty_epsilon);
 
-    ROS_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAccelerationStart::computeError() translational: _error[0]=%f\n",_error[0]);
-    ROS_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAccelerationStart::computeError() strafing: _error[1]=%f\n",_error[1]);
-    ROS_ASSERT_MSG(std::isfinite(_error[2]), "EdgeAccelerationStart::computeError() rotational: _error[2]=%f\n",_error[2]);
+    applyConstraintShift(_error);
+
+    TEB_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAccelerationStart::computeError() translational: _error[0]=%f\n",_error[0]);
+    TEB_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAccelerationStart::computeError() strafing: _error[1]=%f\n",_error[1]);
+    TEB_ASSERT_MSG(std::isfinite(_error[2]), "EdgeAccelerationStart::computeError() rotational: _error[2]=%f\n",_error[2]);
   }
   
   /**
    * @brief Set the initial velocity that is taken into account for calculating the acceleration
-   * @param vel_start twist message containing the translational and rotational velocity
+   * @param vel_start twist containing the translational and rotational velocity
    */    
-  void setInitialVelocity(const geometry_msgs::Twist& vel_start)
+  void setInitialVelocity(const Twist2D& vel_start)
   {
     _measurement = &vel_start;
   }
@@ -654,7 +637,7 @@ public:
  * @remarks Do not forget to call setTebConfig()
  * @remarks Refer to EdgeAccelerationHolonomicStart() for defining boundary (initial) values at the end of the trajectory
  */  
-class EdgeAccelerationHolonomicGoal : public BaseTebMultiEdge<3, const geometry_msgs::Twist*>
+class EdgeAccelerationHolonomicGoal : public BaseTebMultiEdge<3, const Twist2D*>, public ConstraintShift<3>
 {
 public:
 
@@ -672,7 +655,7 @@ public:
    */ 
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_ && _measurement, "You must call setTebConfig() and setGoalVelocity() on EdgeAccelerationGoal()");
+    TEB_ASSERT_MSG(cfg_ && _measurement, "You must call setTebConfig() and setGoalVelocity() on EdgeAccelerationGoal()");
     const VertexPose* pose_pre_goal = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* pose_goal = static_cast<const VertexPose*>(_vertices[1]);
     const VertexTimeDiff* dt = static_cast<const VertexTimeDiff*>(_vertices[2]);
@@ -681,8 +664,8 @@ public:
 
     Eigen::Vector2d diff = pose_goal->position() - pose_pre_goal->position();    
     
-    double cos_theta1 = std::cos(pose_pre_goal->theta());
-    double sin_theta1 = std::sin(pose_pre_goal->theta()); 
+    double cos_theta1 = pose_pre_goal->cosTheta();
+    double sin_theta1 = pose_pre_goal->sinTheta(); 
     
     // transform pose2 into robot frame pose1 (inverse 2d rotation matrix)
     double p1_dx =  cos_theta1*diff.x() + sin_theta1*diff.y();
@@ -690,8 +673,8 @@ public:
    
     double vel1_x = p1_dx / dt->dt();
     double vel1_y = p1_dy / dt->dt();
-    double vel2_x = _measurement->linear.x;
-    double vel2_y = _measurement->linear.y;
+    double vel2_x = _measurement->vx;
+    double vel2_y = _measurement->vy;
     
     double acc_lin_x  = (vel2_x - vel1_x) / dt->dt();
     double acc_lin_y  = (vel2_y - vel1_y) / dt->dt();
@@ -701,22 +684,24 @@ public:
     
     // ANGULAR ACCELERATION
     double omega1 = g2o::normalize_theta(pose_goal->theta() - pose_pre_goal->theta()) / dt->dt();
-    double omega2 = _measurement->angular.z;
+    double omega2 = _measurement->omega;
     double acc_rot  = (omega2 - omega1) / dt->dt();
       
     _error[2] = penaltyBoundToInterval(acc_rot,cfg_->robot.acc_lim_theta,cfg_->optim.penalty_epsilon);
 
-    ROS_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAccelerationGoal::computeError() translational: _error[0]=%f\n",_error[0]);
-    ROS_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAccelerationGoal::computeError() strafing: _error[1]=%f\n",_error[1]);
-    ROS_ASSERT_MSG(std::isfinite(_error[2]), "EdgeAccelerationGoal::computeError() rotational: _error[2]=%f\n",_error[2]);
+    applyConstraintShift(_error);
+
+    TEB_ASSERT_MSG(std::isfinite(_error[0]), "EdgeAccelerationGoal::computeError() translational: _error[0]=%f\n",_error[0]);
+    TEB_ASSERT_MSG(std::isfinite(_error[1]), "EdgeAccelerationGoal::computeError() strafing: _error[1]=%f\n",_error[1]);
+    TEB_ASSERT_MSG(std::isfinite(_error[2]), "EdgeAccelerationGoal::computeError() rotational: _error[2]=%f\n",_error[2]);
   }
   
   
   /**
    * @brief Set the goal / final velocity that is taken into account for calculating the acceleration
-   * @param vel_goal twist message containing the translational and rotational velocity
+   * @param vel_goal twist containing the translational and rotational velocity
    */    
-  void setGoalVelocity(const geometry_msgs::Twist& vel_goal)
+  void setGoalVelocity(const Twist2D& vel_goal)
   {
     _measurement = &vel_goal;
   }
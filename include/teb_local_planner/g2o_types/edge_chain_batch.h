@@ -0,0 +1,260 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef EDGE_CHAIN_BATCH_H_
+#define EDGE_CHAIN_BATCH_H_
+
+#include <teb_local_planner/teb_config.h>
+#include <teb_local_planner/g2o_types/edge_chain_kernels.h>
+
+#include <g2o/core/hyper_graph_action.h>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/utility.hpp>
+
+#include <atomic>
+#include <vector>
+
+
+namespace teb_local_planner
+{
+
+class TimedElasticBand;
+
+//! Homogeneous chains of edges that are evaluated by the EdgeChainBatch
+enum class EdgeChainType
+{
+  Velocity = 0, //!< EdgeVelocity connecting pose i, pose i+1 and time diff i
+  Acceleration, //!< EdgeAcceleration connecting poses i, i+1, i+2 and time diffs i, i+1
+  KinematicsDiffDrive, //!< EdgeKinematicsDiffDrive connecting pose i and pose i+1
+  KinematicsCarlike, //!< EdgeKinematicsCarlike connecting pose i and pose i+1
+  Count //!< Number of chain types (not a chain type)
+};
+
+//! Number of edge chain types
+static const int NoEdgeChainTypes = static_cast<int>(EdgeChainType::Count);
+
+
+/**
+ * @class EdgeChainBatch
+ * @brief Linearizes homogeneous edge chains in one pass over contiguous arrays
+ * 
+ * The velocity, acceleration and kinematic edges of the TEB form chains along the trajectory:
+ * every edge of a chain connects the same pattern of consecutive vertices and only differs in its first index.
+ * Instead of linearizing each edge through g2o (virtual calls, vertex push/pop and oplus for each numeric derivative),
+ * the batch stores the first indices of each chain in a plain array, gathers the current trajectory
+ * into contiguous pose and time diff arrays and computes the jacobians of all edges of a chain in a single loop.
+ * The perturbed poses required for the numeric jacobians (including cos and sin of the perturbed yaw angles)
+ * are computed once per pose and shared by all chains.
+ * 
+ * g2o still queries each edge individually. An edge attached to the batch (see BatchableEdge) copies its
+ * jacobians from the batch, which computes all of them lazily on the first query after
+ * the vertices have changed. Changes are signaled by invalidateAction(), which must be registered
+ * as pre-iteration and compute-error action of the optimizer.
+ * The errors are still computed by the edges: a single error evaluation is too cheap to amortize the gathering.
+ * All edges share their error kernels with the batch (see edge_chain_kernels.h) and the numeric jacobians
+ * follow the g2o central differences exactly, hence the results are identical to the per-edge linearization.
+ * 
+ * The batch is only used while it is active (see setActive()), e.g. during TebOptimalPlanner::optimizeGraph().
+ * Outside, edges evaluate themselves, which also covers all calls in which g2o perturbs single vertices.
+ * @see TebOptimalPlanner::buildGraph, BatchableEdge
+ */
+class EdgeChainBatch : public boost::noncopyable
+{
+public:
+  
+  /**
+   * @brief Construct an empty batch
+   */
+  EdgeChainBatch();
+  
+  /**
+   * @brief Set the trajectory and config the batch refers to (must be called before adding edges)
+   * @param cfg TebConfig class
+   * @param teb trajectory whose vertices are connected by the batched edges
+   */
+  void initialize(const TebConfig& cfg, const TimedElasticBand& teb);
+  
+  /**
+   * @brief Add an edge to a chain
+   * @param type chain type
+   * @param first_index index of the first pose (and time diff) the edge is connected to
+   * @return index of the edge in its chain (see BatchableEdge::setBatch())
+   */
+  int addEdge(EdgeChainType type, int first_index);
+  
+  /**
+   * @brief Remove all edges from all chains (the allocated memory is kept for the next graph)
+   */
+  void clear();
+  
+  /**
+   * @brief Get the number of edges of a chain
+   * @param type chain type
+   * @return number of edges
+   */
+  int size(EdgeChainType type) const {return (int)chains_[static_cast<int>(type)].first_index.size();}
+  
+  /**
+   * @brief Check if no edge is attached to the batch
+   * @return \c true if all chains are empty
+   */
+  bool empty() const;
+  
+  /**
+   * @brief Enable or disable the batch evaluation (edges linearize themselves if inactive)
+   * @param active \c true to enable the batch
+   */
+  void setActive(bool active);
+  
+  /**
+   * @brief Check if the batch evaluation is enabled
+   * @return \c true if active
+   */
+  bool isActive() const {return active_;}
+  
+  /**
+   * @brief Mark all jacobians as outdated (e.g. after the vertices have been changed)
+   */
+  void invalidate() {++generation_;}
+  
+  /**
+   * @brief Get the g2o action that invalidates the batch
+   * 
+   * Register it with g2o::SparseOptimizer::addPreIterationAction() and g2o::SparseOptimizer::addComputeErrorAction().
+   * @return pointer to the action (owned by the batch)
+   */
+  g2o::HyperGraphAction* invalidateAction() {return &invalidate_action_;}
+  
+  /**
+   * @brief Get the jacobians of an edge
+   * @param type chain type
+   * @param index index of the edge in its chain
+   * @param[out] jacobians destinations of the (column-major) jacobians, one for each vertex of the edge
+   * @return \c false if the batch is inactive (nothing is written in this case)
+   */
+  bool getJacobians(EdgeChainType type, int index, double* const* jacobians);
+  
+  
+protected:
+  
+  /**
+   * @brief g2o action that invalidates the batch
+   */
+  class InvalidateAction : public g2o::HyperGraphAction
+  {
+  public:
+    InvalidateAction(EdgeChainBatch* batch) : batch_(batch) {}
+    virtual g2o::HyperGraphAction* operator()(const g2o::HyperGraph* graph, g2o::HyperGraphAction::Parameters* parameters = 0)
+    {
+      batch_->invalidate();
+      return this;
+    }
+  private:
+    EdgeChainBatch* batch_;
+  };
+  
+  //! Edges of a single chain type, the jacobians are stored component-major (edges are contiguous)
+  struct Chain
+  {
+    std::vector<int> first_index; //!< Index of the first pose (and time diff) of each edge
+    std::vector<double> jacobians; //!< Jacobians: element (r,c) of edge k is stored at [(c*D + r)*n + k]
+  };
+  
+  void gatherStates(); //!< Copy the current poses and time diffs from the trajectory and compute the perturbed poses
+  void updateJacobians(); //!< Evaluate the jacobians of all chains if outdated
+  
+  template <typename Kernel>
+  void computeNumericJacobians(Chain& chain); //!< Evaluate the jacobians of a chain by central differences
+  
+  void computeKinematicsDiffDriveJacobians(Chain& chain); //!< Evaluate the analytic jacobians of the diff-drive kinematics chain
+  
+  
+  const TebConfig* cfg_; //!< Config class that stores and manages all related parameters
+  const TimedElasticBand* teb_; //!< Trajectory whose vertices are connected by the batched edges
+  
+  Chain chains_[NoEdgeChainTypes]; //!< Edges of each chain type
+  
+  std::vector<PoseSample> poses_; //!< Current poses
+  std::vector<double> time_diffs_; //!< Current time diffs
+  std::vector<PoseSample> poses_shifted_; //!< Current poses after a zero oplus update of the yaw angle (i.e. normalized)
+  std::vector<PoseSample> poses_theta_plus_; //!< Poses with the yaw angle perturbed by +delta
+  std::vector<PoseSample> poses_theta_minus_; //!< Poses with the yaw angle perturbed by -delta
+  
+  bool active_; //!< Batch evaluation enabled
+  std::atomic<unsigned int> generation_; //!< Incremented each time the vertices (might) have changed
+  std::atomic<unsigned int> jacobians_generation_; //!< Generation of the jacobians
+  boost::mutex mutex_; //!< Serializes lazy updates (g2o might linearize edges concurrently)
+  
+  InvalidateAction invalidate_action_; //!< Action that invalidates the batch
+};
+
+
+/**
+ * @class BatchableEdge
+ * @brief Mixin for edges whose jacobians can be provided by an EdgeChainBatch
+ * @see EdgeChainBatch
+ */
+class BatchableEdge
+{
+public:
+  
+  /**
+   * @brief Construct an edge that is not attached to a batch
+   */
+  BatchableEdge() : batch_(nullptr), batch_index_(-1) {}
+  
+  /**
+   * @brief Attach the edge to a batch
+   * @param batch the batch (must outlive the edge), \c nullptr to detach
+   * @param index index of the edge in its chain (returned by EdgeChainBatch::addEdge())
+   */
+  void setBatch(EdgeChainBatch* batch, int index)
+  {
+    batch_ = batch;
+    batch_index_ = index;
+  }
+  
+protected:
+  EdgeChainBatch* batch_; //!< Batch providing the jacobians (or \c nullptr)
+  int batch_index_; //!< Index of the edge in its chain
+};
+
+} // end namespace
+
+#endif /* EDGE_CHAIN_BATCH_H_ */
@@ -0,0 +1,275 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef EDGE_CHAIN_KERNELS_H_
+#define EDGE_CHAIN_KERNELS_H_
+
+#include <teb_local_planner/g2o_types/vertex_pose.h>
+#include <teb_local_planner/g2o_types/penalties.h>
+#include <teb_local_planner/teb_config.h>
+#include <teb_local_planner/misc.h>
+
+#include <g2o/stuff/misc.h>
+
+#include <cmath>
+#include <limits>
+
+namespace teb_local_planner
+{
+
+/**
+ * @struct PoseSample
+ * @brief Plain copy of a pose including the cosine and sine of its yaw angle
+ * 
+ * The error kernels below operate on pose samples rather than on VertexPose instances.
+ * This allows the edges and the EdgeChainBatch to share the exact same code,
+ * while the batch evaluates the kernels on perturbed copies without touching the vertices.
+ */
+struct PoseSample
+{
+  double x; //!< x-coordinate
+  double y; //!< y-coordinate
+  double theta; //!< yaw angle
+  double cos_theta; //!< cosine of the yaw angle
+  double sin_theta; //!< sine of the yaw angle
+  
+  /**
+   * @brief Copy the current estimate of a pose vertex (uses the cached cos/sin of the vertex)
+   * @param pose pose vertex
+   * @param with_orientation_vec if \c false, cos and sin are not requested from the vertex and set to NaN
+   *                             (for kernels that do not read them, which avoids recomputing the vertex cache)
+   * @return pose sample
+   */
+  static PoseSample fromVertex(const VertexPose& pose, bool with_orientation_vec = true)
+  {
+    PoseSample sample;
+    sample.x = pose.x();
+    sample.y = pose.y();
+    sample.theta = pose.theta();
+    if (with_orientation_vec)
+    {
+      sample.cos_theta = pose.cosTheta();
+      sample.sin_theta = pose.sinTheta();
+    }
+    else
+      sample.cos_theta = sample.sin_theta = std::numeric_limits<double>::quiet_NaN();
+    return sample;
+  }
+};
+
+
+/**
+ * @brief Error kernel of EdgeVelocity
+ * @param cfg TebConfig class
+ * @param pose1 first pose \f$ \mathbf{s}_i \f$
+ * @param pose2 second pose \f$ \mathbf{s}_{ip1} \f$ (cos and sin are not used)
+ * @param dt time difference \f$ \Delta T_i \f$
+ * @param[out] error 2D error vector [velocity, rotational velocity]
+ */
+inline void velocityErrorKernel(const TebConfig& cfg, const PoseSample& pose1, const PoseSample& pose2, double dt, double* error)
+{
+  const Eigen::Vector2d deltaS(pose2.x - pose1.x, pose2.y - pose1.y);
+  
+  double dist = deltaS.norm();
+  const double angle_diff = g2o::normalize_theta(pose2.theta - pose1.theta);
+  if (cfg.trajectory.exact_arc_length && angle_diff != 0)
+  {
+      double radius =  dist/(2*sin(angle_diff/2));
+      dist = fabs( angle_diff * radius ); // actual arg length!
+  }
+  double vel = dist / dt;
+  
+  vel *= fast_sigmoid( 100 * (deltaS.x()*pose1.cos_theta + deltaS.y()*pose1.sin_theta) ); // consider direction
+  
+  const double omega = angle_diff / dt;
+
+  error[0] = penaltyBoundToInterval(vel, -cfg.robot.max_vel_x_backwards, cfg.robot.max_vel_x,cfg.optim.penalty_epsilon);
+  error[1] = penaltyBoundToInterval(omega, cfg.robot.max_vel_theta,cfg.optim.penalty_epsilon);
+}
+
+
+/**
+ * @brief Error kernel of EdgeAcceleration
+ * @param cfg TebConfig class
+ * @param pose1 first pose \f$ \mathbf{s}_i \f$
+ * @param pose2 second pose \f$ \mathbf{s}_{ip1} \f$
+ * @param pose3 third pose \f$ \mathbf{s}_{ip2} \f$ (cos and sin are not used)
+ * @param dt1 time difference \f$ \Delta T_i \f$
+ * @param dt2 time difference \f$ \Delta T_{ip1} \f$
+ * @param[out] error 2D error vector [acceleration, rotational acceleration]
+ */
+inline void accelerationErrorKernel(const TebConfig& cfg, const PoseSample& pose1, const PoseSample& pose2, const PoseSample& pose3,
+                                    double dt1, double dt2, double* error)
+{
+  // VELOCITY & ACCELERATION
+  const Eigen::Vector2d diff1(pose2.x - pose1.x, pose2.y - pose1.y);
+  const Eigen::Vector2d diff2(pose3.x - pose2.x, pose3.y - pose2.y);
+      
+  double dist1 = diff1.norm();
+  double dist2 = diff2.norm();
+  const double angle_diff1 = g2o::normalize_theta(pose2.theta - pose1.theta);
+  const double angle_diff2 = g2o::normalize_theta(pose3.theta - pose2.theta);
+  
+  if (cfg.trajectory.exact_arc_length) // use exact arc length instead of Euclidean approximation
+  {
+      if (angle_diff1 != 0)
+      {
+          const double radius =  dist1/(2*sin(angle_diff1/2));
+          dist1 = fabs( angle_diff1 * radius ); // actual arg length!
+      }
+      if (angle_diff2 != 0)
+      {
+          const double radius =  dist2/(2*sin(angle_diff2/2));
+          dist2 = fabs( angle_diff2 * radius ); // actual arg length!
+      }
+  }
+  
+  double vel1 = dist1 / dt1;
+  double vel2 = dist2 / dt2;
+  
+  // consider directions
+  vel1 *= fast_sigmoid( 100*(diff1.x()*pose1.cos_theta + diff1.y()*pose1.sin_theta) ); 
+  vel2 *= fast_sigmoid( 100*(diff2.x()*pose2.cos_theta + diff2.y()*pose2.sin_theta) ); 
+  
+  const double acc_lin  = (vel2 - vel1)*2 / ( dt1 + dt2 );
+
+  error[0] = penaltyBoundToInterval(acc_lin,cfg.robot.acc_lim_x,cfg.optim.penalty_epsilon);
+  
+  // ANGULAR ACCELERATION
+  const double omega1 = angle_diff1 / dt1;
+  const double omega2 = angle_diff2 / dt2;
+  const double acc_rot  = (omega2 - omega1)*2 / ( dt1 + dt2 );
+    
+  error[1] = penaltyBoundToInterval(acc_rot,cfg.robot.acc_lim_theta,cfg.optim.penalty_epsilon);
+}
+
+
+/**
+ * @brief Error kernel of EdgeKinematicsDiffDrive
+ * @param pose1 first pose \f$ \mathbf{s}_i \f$
+ * @param pose2 second pose \f$ \mathbf{s}_{ip1} \f$
+ * @param[out] error 2D error vector [non-holonomic constraint, positive drive direction]
+ */
+inline void kinematicsDiffDriveErrorKernel(const PoseSample& pose1, const PoseSample& pose2, double* error)
+{
+  const Eigen::Vector2d deltaS(pose2.x - pose1.x, pose2.y - pose1.y);
+
+  // non holonomic constraint
+  error[0] = fabs( ( pose1.cos_theta+pose2.cos_theta ) * deltaS[1] - ( pose1.sin_theta+pose2.sin_theta ) * deltaS[0] );
+
+  // positive-drive-direction constraint
+  const Eigen::Vector2d angle_vec ( pose1.cos_theta, pose1.sin_theta );
+  error[1] = penaltyBoundFromBelow(deltaS.dot(angle_vec), 0,0);
+  // epsilon=0, otherwise it pushes the first bandpoints away from start
+}
+
+
+/**
+ * @brief Analytic jacobians of kinematicsDiffDriveErrorKernel()
+ * @param pose1 first pose \f$ \mathbf{s}_i \f$
+ * @param pose2 second pose \f$ \mathbf{s}_{ip1} \f$
+ * @param[out] jacobian1 2x3 jacobian w.r.t. the first pose (column-major)
+ * @param[out] jacobian2 2x3 jacobian w.r.t. the second pose (column-major)
+ */
+inline void kinematicsDiffDriveJacobianKernel(const PoseSample& pose1, const PoseSample& pose2, double* jacobian1, double* jacobian2)
+{
+  Eigen::Map<Eigen::Matrix<double,2,3> > jac1(jacobian1);
+  Eigen::Map<Eigen::Matrix<double,2,3> > jac2(jacobian2);
+
+  const Eigen::Vector2d deltaS(pose2.x - pose1.x, pose2.y - pose1.y);
+
+  double cos1 = pose1.cos_theta;
+  double cos2 = pose2.cos_theta;
+  double sin1 = pose1.sin_theta;
+  double sin2 = pose2.sin_theta;
+  double aux1 = sin1 + sin2;
+  double aux2 = cos1 + cos2;
+
+  double dd_error_1 = deltaS[0]*cos1;
+  double dd_error_2 = deltaS[1]*sin1;
+  double dd_dev = penaltyBoundFromBelowDerivative(dd_error_1+dd_error_2, 0,0);
+
+  double dev_nh_abs = g2o::sign( ( pose1.cos_theta+pose2.cos_theta ) * deltaS[1] -
+        ( pose1.sin_theta+pose2.sin_theta ) * deltaS[0] );
+
+  // conf1
+  jac1(0,0) = aux1 * dev_nh_abs; // nh x1
+  jac1(0,1) = -aux2 * dev_nh_abs; // nh y1
+  jac1(1,0) = -cos1 * dd_dev; // drive-dir x1
+  jac1(1,1) = -sin1 * dd_dev; // drive-dir y1
+  jac1(0,2) = (-dd_error_2 - dd_error_1) * dev_nh_abs; // nh angle
+  jac1(1,2) = ( -sin1*deltaS[0] + cos1*deltaS[1] ) * dd_dev; // drive-dir angle1
+
+  // conf2
+  jac2(0,0) = -aux1 * dev_nh_abs; // nh x2
+  jac2(0,1) = aux2 * dev_nh_abs; // nh y2
+  jac2(1,0) = cos1 * dd_dev; // drive-dir x2
+  jac2(1,1) = sin1 * dd_dev; // drive-dir y2
+  jac2(0,2) = (-sin2*deltaS[1] - cos2*deltaS[0]) * dev_nh_abs; // nh angle
+  jac2(1,2) = 0; // drive-dir angle1
+}
+
+
+/**
+ * @brief Error kernel of EdgeKinematicsCarlike
+ * @param cfg TebConfig class
+ * @param pose1 first pose \f$ \mathbf{s}_i \f$
+ * @param pose2 second pose \f$ \mathbf{s}_{ip1} \f$
+ * @param[out] error 2D error vector [non-holonomic constraint, minimum turning radius]
+ */
+inline void kinematicsCarlikeErrorKernel(const TebConfig& cfg, const PoseSample& pose1, const PoseSample& pose2, double* error)
+{
+  const Eigen::Vector2d deltaS(pose2.x - pose1.x, pose2.y - pose1.y);
+
+  // non holonomic constraint
+  error[0] = fabs( ( pose1.cos_theta+pose2.cos_theta ) * deltaS[1] - ( pose1.sin_theta+pose2.sin_theta ) * deltaS[0] );
+
+  // limit minimum turning radius
+  double angle_diff = g2o::normalize_theta( pose2.theta - pose1.theta );
+  if (angle_diff == 0)
+    error[1] = 0; // straight line motion
+  else if (cfg.trajectory.exact_arc_length) // use exact computation of the radius
+    error[1] = penaltyBoundFromBelow(fabs(deltaS.norm()/(2*sin(angle_diff/2))), cfg.robot.min_turning_radius, 0.0);
+  else
+    error[1] = penaltyBoundFromBelow(deltaS.norm() / fabs(angle_diff), cfg.robot.min_turning_radius, 0.0); 
+  // This edge is not affected by the epsilon parameter, the user might add an exra margin to the min_turning_radius parameter.
+}
+
+} // end namespace
+
+#endif /* EDGE_CHAIN_KERNELS_H_ */
@@ -0,0 +1,167 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Notes:
+ * The following class is derived from a class defined by the
+ * g2o-framework. g2o is licensed under the terms of the BSD License.
+ * Refer to the base class source for detailed licensing information.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef EDGE_CONSECUTIVE_POSES_H_
+#define EDGE_CONSECUTIVE_POSES_H_
+
+#include <teb_local_planner/g2o_types/vertex_pose.h>
+#include <teb_local_planner/g2o_types/vertex_timediff.h>
+#include <teb_local_planner/g2o_types/base_teb_edges.h>
+#include <teb_local_planner/g2o_types/penalties.h>
+#include <teb_local_planner/teb_config.h>
+
+#include <cmath>
+
+namespace teb_local_planner
+{
+
+/**
+ * @class EdgeConsecutivePoses
+ * @brief Edge that fuses all cost terms defined between two consecutive poses of a non-holonomic robot.
+ * 
+ * The edge depends on three vertices \f$ \mathbf{s}_i, \mathbf{s}_{ip1}, \Delta T_i \f$ and stacks the residuals of
+ * EdgeVelocity, EdgeKinematicsDiffDrive (or EdgeKinematicsCarlike) and EdgeShortestPath. \n
+ * The geometry shared by these terms (position delta, distance, angle difference and the sine/cosine of both headings)
+ * is computed only once per evaluation. Since the numerical Jacobian of g2o perturbs each vertex dimension
+ * and evaluates computeError() twice per dimension, fusing the terms reduces the number of edges and
+ * the number of trigonometric function calls for the pairwise terms by about a factor of three. \n
+ * The dimension of the error / cost vector is 5:
+ *  - 0: translational velocity (see EdgeVelocity)
+ *  - 1: rotational velocity (see EdgeVelocity)
+ *  - 2: non-holonomic constraint (see EdgeKinematicsDiffDrive)
+ *  - 3: positive drive direction (diff-drive) or minimum turning radius (carlike, see EdgeKinematicsCarlike)
+ *  - 4: path length (see EdgeShortestPath)
+ * 
+ * The \e weights of the individual terms are the diagonal elements of the information matrix (see setInformation()).
+ * The residuals are identical to those of the individual edges, hence the solution does not change.
+ * @see TebOptimalPlanner::AddEdgesConsecutivePoses
+ * @remarks Do not forget to call setTebConfig() and setCarlike()
+ */
+class EdgeConsecutivePoses : public BaseTebMultiEdge<5, double>, public ConstraintShift<2>
+{
+public:
+  
+  /**
+   * @brief Construct edge.
+   */
+  EdgeConsecutivePoses() : carlike_(false)
+  {
+    this->resize(3); // Since we derive from a g2o::BaseMultiEdge, set the desired number of vertices
+  }
+  
+  /**
+   * @brief Actual cost function
+   */
+  void computeError()
+  {
+    TEB_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeConsecutivePoses()");
+    const VertexPose* conf1 = static_cast<const VertexPose*>(_vertices[0]);
+    const VertexPose* conf2 = static_cast<const VertexPose*>(_vertices[1]);
+    const VertexTimeDiff* deltaT = static_cast<const VertexTimeDiff*>(_vertices[2]);
+    
+    // shared geometry
+    const Eigen::Vector2d deltaS = conf2->position() - conf1->position();
+    const double dist = deltaS.norm();
+    const double angle_diff = g2o::normalize_theta(conf2->theta() - conf1->theta());
+    const double cos1 = conf1->cosTheta();
+    const double sin1 = conf1->sinTheta();
+    const double cos2 = conf2->cosTheta();
+    const double sin2 = conf2->sinTheta();
+    const double proj_dir = deltaS.x()*cos1 + deltaS.y()*sin1; // projection onto the heading of the first pose
+    const double sin_half_angle = (cfg_->trajectory.exact_arc_length && angle_diff != 0) ? std::sin(angle_diff/2) : 0;
+    
+    // velocity
+    double arc_length = dist;
+    if (sin_half_angle != 0)
+      arc_length = std::fabs( angle_diff * dist/(2*sin_half_angle) ); // actual arc length!
+    const double vel = arc_length / deltaT->estimate() * fast_sigmoid( 100 * proj_dir ); // consider direction
+    const double omega = angle_diff / deltaT->estimate();
+    _error[0] = penaltyBoundToInterval(vel, -cfg_->robot.max_vel_x_backwards, cfg_->robot.max_vel_x,cfg_->optim.penalty_epsilon);
+    _error[1] = penaltyBoundToInterval(omega, cfg_->robot.max_vel_theta,cfg_->optim.penalty_epsilon);
+    
+    // non holonomic constraint
+    _error[2] = std::fabs( (cos1 + cos2) * deltaS.y() - (sin1 + sin2) * deltaS.x() );
+    
+    if (carlike_) // limit minimum turning radius
+    {
+      if (angle_diff == 0)
+        _error[3] = 0; // straight line motion
+      else if (cfg_->trajectory.exact_arc_length) // use exact computation of the radius
+        _error[3] = penaltyBoundFromBelow(std::fabs(dist/(2*sin_half_angle)), cfg_->robot.min_turning_radius, 0.0);
+      else
+        _error[3] = penaltyBoundFromBelow(dist / std::fabs(angle_diff), cfg_->robot.min_turning_radius, 0.0);
+    }
+    else // positive-drive-direction constraint
+      _error[3] = penaltyBoundFromBelow(proj_dir, 0, 0);
+    
+    // path length
+    _error[4] = dist;
+    
+    applyConstraintShift(_error);
+
+    TEB_ASSERT_MSG(std::isfinite(_error[0]) && std::isfinite(_error[3]), "EdgeConsecutivePoses::computeError() _error[0]=%f _error[3]=%f\n",_error[0],_error[3]);
+  }
+  
+  /**
+   * @brief Select the kinematic model of the fourth residual
+   * @param carlike if \c true, a minimum turning radius is enforced (EdgeKinematicsCarlike),
+   *                otherwise forward motions are preferred (EdgeKinematicsDiffDrive)
+   */
+  void setCarlike(bool carlike) {carlike_ = carlike;}
+  
+  /**
+   * @brief Check whether the kinematic model of a carlike robot is in use
+   */
+  bool isCarlike() const {return carlike_;}
+  
+protected:
+  
+  bool carlike_; //!< Minimum turning radius instead of positive drive direction
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+} // end namespace
+
+#endif /* EDGE_CONSECUTIVE_POSES_H_ */
@@ -68,7 +68,7 @@ namespace teb_local_planner
  * @remarks Do not forget to call setTebConfig(), setVertexIdx() and 
  * @warning Experimental
  */  
-class EdgeDynamicObstacle : public BaseTebUnaryEdge<2, const Obstacle*, VertexPose>
+class EdgeDynamicObstacle : public BaseTebUnaryEdge<2, const Obstacle*, VertexPose>, public ConstraintShift<1>
 {
 public:
   
@@ -92,15 +92,12 @@ public:
    */   
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_ && _measurement && robot_model_, "You must call setTebConfig(), setObstacle() and setRobotModel() on EdgeDynamicObstacle()");
+    TEB_ASSERT_MSG(cfg_ && _measurement && robot_model_, "You must call setTebConfig(), setObstacle() and setRobotModel() on EdgeDynamicObstacle()");
     const VertexPose* bandpt = static_cast<const VertexPose*>(_vertices[0]);
     
-    double dist = robot_model_->estimateSpatioTemporalDistance(bandpt->pose(), _measurement, t_);
+    double dist = robot_model_->estimateSpatioTemporalDistance(bandpt->pose(), bandpt->orientationUnitVec(), _measurement, t_);
 
-    _error[0] = penaltyBoundFromBelow(dist, cfg_->obstacles.min_obstacle_dist, cfg_->optim.penalty_epsilon);
-    _error[1] = penaltyBoundFromBelow(dist, cfg_->obstacles.dynamic_obstacle_inflation_dist, 0.0);
-
-    ROS_ASSERT_MSG(std::isfinite(_error[0]), "EdgeDynamicObstacle::computeError() _error[0]=%f\n",_error[0]);
+    computeErrorFromDistance(dist);
   }
   
   
@@ -137,6 +134,22 @@ public:
 
 protected:
   
+  /**
+   * @brief Compute the obstacle and inflation cost from the predicted distance between footprint and obstacle
+   * 
+   * Shared by computeError() and the footprint specific EdgeDynamicObstacleSpecialized.
+   * @param dist predicted distance between the robot footprint and the obstacle
+   */
+  void computeErrorFromDistance(double dist)
+  {
+    _error[0] = penaltyBoundFromBelow(dist, cfg_->obstacles.min_obstacle_dist, cfg_->optim.penalty_epsilon);
+    _error[1] = penaltyBoundFromBelow(dist, cfg_->obstacles.dynamic_obstacle_inflation_dist, 0.0);
+
+    applyConstraintShift(_error);
+
+    TEB_ASSERT_MSG(std::isfinite(_error[0]), "EdgeDynamicObstacle::computeError() _error[0]=%f\n",_error[0]);
+  }
+  
   const BaseRobotFootprintModel* robot_model_; //!< Store pointer to robot_model
   double t_; //!< Estimated time until current pose is reached
   
@@ -145,7 +158,45 @@ public:
 
 };
     
- 
+
+/**
+ * @class EdgeDynamicObstacleSpecialized
+ * @brief EdgeDynamicObstacle with the distance estimation of a specific footprint model resolved at compile time
+ * 
+ * The spatio-temporal distance function of \c FootprintT is called non-virtually, so that it can be
+ * inlined into computeError(). The robot model passed to setRobotModel() must be of exact type \c FootprintT.
+ * @tparam FootprintT concrete footprint model (e.g. PolygonRobotFootprint)
+ * @see footprintType(), EdgeObstacleSpecialized, TebOptimalPlanner::AddEdgesDynamicObstacles
+ */
+template <typename FootprintT>
+class EdgeDynamicObstacleSpecialized : public EdgeDynamicObstacle
+{
+public:
+  
+  /**
+   * @brief Construct edge and specify the time for its associated pose (neccessary for computeError).
+   * @param t Estimated time until current pose is reached
+   */
+  explicit EdgeDynamicObstacleSpecialized(double t = 0) : EdgeDynamicObstacle(t)
+  {
+  }
+  
+  /**
+   * @brief Actual cost function
+   */   
+  void computeError()
+  {
+    TEB_ASSERT_MSG(cfg_ && _measurement && robot_model_, "You must call setTebConfig(), setObstacle() and setRobotModel() on EdgeDynamicObstacleSpecialized()");
+    const VertexPose* bandpt = static_cast<const VertexPose*>(_vertices[0]);
+    
+    double dist = static_cast<const FootprintT*>(robot_model_)->FootprintT::estimateSpatioTemporalDistance(bandpt->pose(), bandpt->orientationUnitVec(), _measurement, t_);
+    
+    computeErrorFromDistance(dist);
+  }
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
     
 
 } // end namespace
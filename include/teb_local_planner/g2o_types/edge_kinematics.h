@@ -47,6 +47,7 @@
 #include <teb_local_planner/g2o_types/vertex_pose.h>
 #include <teb_local_planner/g2o_types/penalties.h>
 #include <teb_local_planner/g2o_types/base_teb_edges.h>
+#include <teb_local_planner/g2o_types/edge_chain_batch.h>
 #include <teb_local_planner/teb_config.h>
 
 #include <cmath>
@@ -67,10 +68,10 @@ namespace teb_local_planner
  * The \e weight can be set using setInformation(): Matrix element 2,2: (A value ~1 allows backward driving, but penalizes it slighly). \n
  * The dimension of the error / cost vector is 2: the first component represents the nonholonomic constraint cost, 
  * the second one backward-drive cost.
- * @see TebOptimalPlanner::AddEdgesKinematics, EdgeKinematicsCarlike
+ * @see TebOptimalPlanner::AddEdgesKinematics, EdgeKinematicsCarlike, EdgeChainBatch
  * @remarks Do not forget to call setTebConfig()
  */    
-class EdgeKinematicsDiffDrive : public BaseTebBinaryEdge<2, double, VertexPose, VertexPose>
+class EdgeKinematicsDiffDrive : public BaseTebBinaryEdge<2, double, VertexPose, VertexPose>, public BatchableEdge
 {
 public:
   
@@ -87,68 +88,36 @@ public:
    */    
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeKinematicsDiffDrive()");
+    TEB_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeKinematicsDiffDrive()");
     const VertexPose* conf1 = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* conf2 = static_cast<const VertexPose*>(_vertices[1]);
     
-    Eigen::Vector2d deltaS = conf2->position() - conf1->position();
+    kinematicsDiffDriveErrorKernel(PoseSample::fromVertex(*conf1), PoseSample::fromVertex(*conf2), _error.data());
 
-    // non holonomic constraint
-    _error[0] = fabs( ( cos(conf1->theta())+cos(conf2->theta()) ) * deltaS[1] - ( sin(conf1->theta())+sin(conf2->theta()) ) * deltaS[0] );
-
-    // positive-drive-direction constraint
-    Eigen::Vector2d angle_vec ( cos(conf1->theta()), sin(conf1->theta()) );	   
-    _error[1] = penaltyBoundFromBelow(deltaS.dot(angle_vec), 0,0);
-    // epsilon=0, otherwise it pushes the first bandpoints away from start
-
-    ROS_ASSERT_MSG(std::isfinite(_error[0]) && std::isfinite(_error[1]), "EdgeKinematicsDiffDrive::computeError() _error[0]=%f _error[1]=%f\n",_error[0],_error[1]);
+    TEB_ASSERT_MSG(std::isfinite(_error[0]) && std::isfinite(_error[1]), "EdgeKinematicsDiffDrive::computeError() _error[0]=%f _error[1]=%f\n",_error[0],_error[1]);
   }
 
-#ifdef USE_ANALYTIC_JACOBI
-#if 1
   /**
    * @brief Jacobi matrix of the cost function specified in computeError().
+   * 
+   * Taken from the EdgeChainBatch if the edge is attached to an active batch.
    */
   void linearizeOplus()
   {
-    ROS_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeKinematicsDiffDrive()");
+    TEB_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeKinematicsDiffDrive()");
+    double* jacobians[2] = {_jacobianOplusXi.data(), _jacobianOplusXj.data()};
+    if (batch_ && batch_->getJacobians(EdgeChainType::KinematicsDiffDrive, batch_index_, jacobians))
+      return;
+    
+#ifdef USE_ANALYTIC_JACOBI
     const VertexPose* conf1 = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* conf2 = static_cast<const VertexPose*>(_vertices[1]);
     
-    Eigen::Vector2d deltaS = conf2->position() - conf1->position();
-	    
-    double cos1 = cos(conf1->theta());
-    double cos2 = cos(conf2->theta());
-    double sin1 = sin(conf1->theta());
-    double sin2 = sin(conf2->theta());
-    double aux1 = sin1 + sin2;
-    double aux2 = cos1 + cos2;
-    
-    double dd_error_1 = deltaS[0]*cos1;
-    double dd_error_2 = deltaS[1]*sin1;
-    double dd_dev = penaltyBoundFromBelowDerivative(dd_error_1+dd_error_2, 0,0);
-    
-    double dev_nh_abs = g2o::sign( ( cos(conf1->theta())+cos(conf2->theta()) ) * deltaS[1] - 
-	      ( sin(conf1->theta())+sin(conf2->theta()) ) * deltaS[0] );
-	    
-    // conf1
-    _jacobianOplusXi(0,0) = aux1 * dev_nh_abs; // nh x1
-    _jacobianOplusXi(0,1) = -aux2 * dev_nh_abs; // nh y1
-    _jacobianOplusXi(1,0) = -cos1 * dd_dev; // drive-dir x1
-    _jacobianOplusXi(1,1) = -sin1 * dd_dev; // drive-dir y1
-    _jacobianOplusXi(0,2) = (-dd_error_2 - dd_error_1) * dev_nh_abs; // nh angle
-    _jacobianOplusXi(1,2) = ( -sin1*deltaS[0] + cos1*deltaS[1] ) * dd_dev; // drive-dir angle1
-    
-    // conf2
-    _jacobianOplusXj(0,0) = -aux1 * dev_nh_abs; // nh x2
-    _jacobianOplusXj(0,1) = aux2 * dev_nh_abs; // nh y2
-    _jacobianOplusXj(1,0) = cos1 * dd_dev; // drive-dir x2
-    _jacobianOplusXj(1,1) = sin1 * dd_dev; // drive-dir y2
-    _jacobianOplusXj(0,2) = (-sin2*deltaS[1] - cos2*deltaS[0]) * dev_nh_abs; // nh angle
-    _jacobianOplusXj(1,2) = 0; // drive-dir angle1					
-  }
-#endif
+    kinematicsDiffDriveJacobianKernel(PoseSample::fromVertex(*conf1), PoseSample::fromVertex(*conf2), jacobians[0], jacobians[1]);
+#else
+    BaseTebBinaryEdge<2, double, VertexPose, VertexPose>::linearizeOplus();
 #endif
+  }
       
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW   
@@ -178,8 +147,9 @@ public:
  * @remarks Bounding the turning radius from below is not affected by the penalty_epsilon parameter, 
  *          the user might add an extra margin to the min_turning_radius param.
  * @remarks Do not forget to call setTebConfig()
+ * @see EdgeChainBatch
  */    
-class EdgeKinematicsCarlike : public BaseTebBinaryEdge<2, double, VertexPose, VertexPose>
+class EdgeKinematicsCarlike : public BaseTebBinaryEdge<2, double, VertexPose, VertexPose>, public BatchableEdge
 {
 public:
   
@@ -196,26 +166,26 @@ public:
    */    
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeKinematicsCarlike()");
+    TEB_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeKinematicsCarlike()");
     const VertexPose* conf1 = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* conf2 = static_cast<const VertexPose*>(_vertices[1]);
     
-    Eigen::Vector2d deltaS = conf2->position() - conf1->position();
-
-    // non holonomic constraint
-    _error[0] = fabs( ( cos(conf1->theta())+cos(conf2->theta()) ) * deltaS[1] - ( sin(conf1->theta())+sin(conf2->theta()) ) * deltaS[0] );
-
-    // limit minimum turning radius
-    double angle_diff = g2o::normalize_theta( conf2->theta() - conf1->theta() );
-    if (angle_diff == 0)
-      _error[1] = 0; // straight line motion
-    else if (cfg_->trajectory.exact_arc_length) // use exact computation of the radius
-      _error[1] = penaltyBoundFromBelow(fabs(deltaS.norm()/(2*sin(angle_diff/2))), cfg_->robot.min_turning_radius, 0.0);
-    else
-      _error[1] = penaltyBoundFromBelow(deltaS.norm() / fabs(angle_diff), cfg_->robot.min_turning_radius, 0.0); 
-    // This edge is not affected by the epsilon parameter, the user might add an exra margin to the min_turning_radius parameter.
+    kinematicsCarlikeErrorKernel(*cfg_, PoseSample::fromVertex(*conf1), PoseSample::fromVertex(*conf2), _error.data());
     
-    ROS_ASSERT_MSG(std::isfinite(_error[0]) && std::isfinite(_error[1]), "EdgeKinematicsCarlike::computeError() _error[0]=%f _error[1]=%f\n",_error[0],_error[1]);
+    TEB_ASSERT_MSG(std::isfinite(_error[0]) && std::isfinite(_error[1]), "EdgeKinematicsCarlike::computeError() _error[0]=%f _error[1]=%f\n",_error[0],_error[1]);
+  }
+  
+  /**
+   * @brief Jacobi matrix of the cost function specified in computeError().
+   * 
+   * Taken from the EdgeChainBatch if the edge is attached to an active batch, otherwise computed numerically by g2o.
+   */
+  void linearizeOplus()
+  {
+    double* jacobians[2] = {_jacobianOplusXi.data(), _jacobianOplusXj.data()};
+    if (batch_ && batch_->getJacobians(EdgeChainType::KinematicsCarlike, batch_index_, jacobians))
+      return;
+    BaseTebBinaryEdge<2, double, VertexPose, VertexPose>::linearizeOplus();
   }
   
 public:
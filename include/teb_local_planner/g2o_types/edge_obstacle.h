@@ -67,7 +67,7 @@ namespace teb_local_planner
  * @see TebOptimalPlanner::AddEdgesObstacles, TebOptimalPlanner::EdgeInflatedObstacle
  * @remarks Do not forget to call setTebConfig() and setObstacle()
  */     
-class EdgeObstacle : public BaseTebUnaryEdge<1, const Obstacle*, VertexPose>
+class EdgeObstacle : public BaseTebUnaryEdge<1, const Obstacle*, VertexPose>, public ConstraintShift<1>
 {
 public:
     
@@ -84,25 +84,12 @@ public:
    */    
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_ && _measurement && robot_model_, "You must call setTebConfig(), setObstacle() and setRobotModel() on EdgeObstacle()");
+    TEB_ASSERT_MSG(cfg_ && _measurement && robot_model_, "You must call setTebConfig(), setObstacle() and setRobotModel() on EdgeObstacle()");
     const VertexPose* bandpt = static_cast<const VertexPose*>(_vertices[0]);
 
-    double dist = robot_model_->calculateDistance(bandpt->pose(), _measurement);
+    double dist = robot_model_->calculateDistance(bandpt->pose(), bandpt->orientationUnitVec(), _measurement);
 
-    // Original obstacle cost.
-    _error[0] = penaltyBoundFromBelow(dist, cfg_->obstacles.min_obstacle_dist, cfg_->optim.penalty_epsilon);
-
-    if (cfg_->optim.obstacle_cost_exponent != 1.0 && cfg_->obstacles.min_obstacle_dist > 0.0)
-    {
-      // Optional non-linear cost. Note the max cost (before weighting) is
-      // the same as the straight line version and that all other costs are
-      // below the straight line (for positive exponent), so it may be
-      // necessary to increase weight_obstacle and/or the inflation_weight
-      // when using larger exponents.
-      _error[0] = cfg_->obstacles.min_obstacle_dist * std::pow(_error[0] / cfg_->obstacles.min_obstacle_dist, cfg_->optim.obstacle_cost_exponent);
-    }
-
-    ROS_ASSERT_MSG(std::isfinite(_error[0]), "EdgeObstacle::computeError() _error[0]=%f\n",_error[0]);
+    computeErrorFromDistance(dist);
   }
 
 #ifdef USE_ANALYTIC_JACOBI
@@ -113,7 +100,7 @@ public:
    */
   void linearizeOplus()
   {
-    ROS_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgePointObstacle()");
+    TEB_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgePointObstacle()");
     const VertexPose* bandpt = static_cast<const VertexPose*>(_vertices[0]);
     
     Eigen::Vector2d deltaS = *_measurement - bandpt->position(); 
@@ -183,6 +170,32 @@ public:
   
 protected:
 
+  /**
+   * @brief Compute the obstacle cost from the distance between footprint and obstacle
+   * 
+   * Shared by computeError() and the footprint specific EdgeObstacleSpecialized.
+   * @param dist distance between the robot footprint and the obstacle
+   */
+  void computeErrorFromDistance(double dist)
+  {
+    // Original obstacle cost.
+    _error[0] = penaltyBoundFromBelow(dist, cfg_->obstacles.min_obstacle_dist, cfg_->optim.penalty_epsilon);
+
+    if (cfg_->optim.obstacle_cost_exponent != 1.0 && cfg_->obstacles.min_obstacle_dist > 0.0)
+    {
+      // Optional non-linear cost. Note the max cost (before weighting) is
+      // the same as the straight line version and that all other costs are
+      // below the straight line (for positive exponent), so it may be
+      // necessary to increase weight_obstacle and/or the inflation_weight
+      // when using larger exponents.
+      _error[0] = cfg_->obstacles.min_obstacle_dist * std::pow(_error[0] / cfg_->obstacles.min_obstacle_dist, cfg_->optim.obstacle_cost_exponent);
+    }
+
+    applyConstraintShift(_error);
+
+    TEB_ASSERT_MSG(std::isfinite(_error[0]), "EdgeObstacle::computeError() _error[0]=%f\n",_error[0]);
+  }
+
   const BaseRobotFootprintModel* robot_model_; //!< Store pointer to robot_model
   
 public: 	
@@ -206,7 +219,7 @@ public:
  * @see TebOptimalPlanner::AddEdgesObstacles, TebOptimalPlanner::EdgeObstacle
  * @remarks Do not forget to call setTebConfig() and setObstacle()
  */     
-class EdgeInflatedObstacle : public BaseTebUnaryEdge<2, const Obstacle*, VertexPose>
+class EdgeInflatedObstacle : public BaseTebUnaryEdge<2, const Obstacle*, VertexPose>, public ConstraintShift<1>
 {
 public:
     
@@ -223,30 +236,12 @@ public:
    */    
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_ && _measurement && robot_model_, "You must call setTebConfig(), setObstacle() and setRobotModel() on EdgeInflatedObstacle()");
+    TEB_ASSERT_MSG(cfg_ && _measurement && robot_model_, "You must call setTebConfig(), setObstacle() and setRobotModel() on EdgeInflatedObstacle()");
     const VertexPose* bandpt = static_cast<const VertexPose*>(_vertices[0]);
 
-    double dist = robot_model_->calculateDistance(bandpt->pose(), _measurement);
-
-    // Original "straight line" obstacle cost. The max possible value
-    // before weighting is min_obstacle_dist
-    _error[0] = penaltyBoundFromBelow(dist, cfg_->obstacles.min_obstacle_dist, cfg_->optim.penalty_epsilon);
-
-    if (cfg_->optim.obstacle_cost_exponent != 1.0 && cfg_->obstacles.min_obstacle_dist > 0.0)
-    {
-      // Optional non-linear cost. Note the max cost (before weighting) is
-      // the same as the straight line version and that all other costs are
-      // below the straight line (for positive exponent), so it may be
-      // necessary to increase weight_obstacle and/or the inflation_weight
-      // when using larger exponents.
-      _error[0] = cfg_->obstacles.min_obstacle_dist * std::pow(_error[0] / cfg_->obstacles.min_obstacle_dist, cfg_->optim.obstacle_cost_exponent);
-    }
-
-    // Additional linear inflation cost
-    _error[1] = penaltyBoundFromBelow(dist, cfg_->obstacles.inflation_dist, 0.0);
-
+    double dist = robot_model_->calculateDistance(bandpt->pose(), bandpt->orientationUnitVec(), _measurement);
 
-    ROS_ASSERT_MSG(std::isfinite(_error[0]) && std::isfinite(_error[1]), "EdgeInflatedObstacle::computeError() _error[0]=%f, _error[1]=%f\n",_error[0], _error[1]);
+    computeErrorFromDistance(dist);
   }
 
   /**
@@ -282,12 +277,108 @@ public:
   
 protected:
 
+  /**
+   * @brief Compute the obstacle and inflation cost from the distance between footprint and obstacle
+   * 
+   * Shared by computeError() and the footprint specific EdgeInflatedObstacleSpecialized.
+   * @param dist distance between the robot footprint and the obstacle
+   */
+  void computeErrorFromDistance(double dist)
+  {
+    // Original "straight line" obstacle cost. The max possible value
+    // before weighting is min_obstacle_dist
+    _error[0] = penaltyBoundFromBelow(dist, cfg_->obstacles.min_obstacle_dist, cfg_->optim.penalty_epsilon);
+
+    if (cfg_->optim.obstacle_cost_exponent != 1.0 && cfg_->obstacles.min_obstacle_dist > 0.0)
+    {
+      // Optional non-linear cost. Note the max cost (before weighting) is
+      // the same as the straight line version and that all other costs are
+      // below the straight line (for positive exponent), so it may be
+      // necessary to increase weight_obstacle and/or the inflation_weight
+      // when using larger exponents.
+      _error[0] = cfg_->obstacles.min_obstacle_dist * std::pow(_error[0] / cfg_->obstacles.min_obstacle_dist, cfg_->optim.obstacle_cost_exponent);
+    }
+
+    // Additional linear inflation cost
+    _error[1] = penaltyBoundFromBelow(dist, cfg_->obstacles.inflation_dist, 0.0);
+
+
+    applyConstraintShift(_error);
+
+    TEB_ASSERT_MSG(std::isfinite(_error[0]) && std::isfinite(_error[1]), "EdgeInflatedObstacle::computeError() _error[0]=%f, _error[1]=%f\n",_error[0], _error[1]);
+  }
+
   const BaseRobotFootprintModel* robot_model_; //!< Store pointer to robot_model
   
 public:         
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
 };
+
+
+/**
+ * @class EdgeObstacleSpecialized
+ * @brief EdgeObstacle with the distance calculation of a specific footprint model resolved at compile time
+ * 
+ * The generic EdgeObstacle dispatches the distance calculation virtually to the footprint model
+ * and, inside the footprint model, virtually to the obstacle. This edge calls the distance function
+ * of \c FootprintT non-virtually, so that it can be inlined into computeError() and only the
+ * obstacle dispatch remains. The robot model passed to setRobotModel() must be of exact type \c FootprintT.
+ * @tparam FootprintT concrete footprint model (e.g. PolygonRobotFootprint)
+ * @see footprintType(), TebOptimalPlanner::AddEdgesObstacles
+ */
+template <typename FootprintT>
+class EdgeObstacleSpecialized : public EdgeObstacle
+{
+public:
+  
+  /**
+   * @brief Actual cost function
+   */    
+  void computeError()
+  {
+    TEB_ASSERT_MSG(cfg_ && _measurement && robot_model_, "You must call setTebConfig(), setObstacle() and setRobotModel() on EdgeObstacleSpecialized()");
+    const VertexPose* bandpt = static_cast<const VertexPose*>(_vertices[0]);
+    
+    double dist = static_cast<const FootprintT*>(robot_model_)->FootprintT::calculateDistance(bandpt->pose(), bandpt->orientationUnitVec(), _measurement);
+    
+    computeErrorFromDistance(dist);
+  }
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+
+/**
+ * @class EdgeInflatedObstacleSpecialized
+ * @brief EdgeInflatedObstacle with the distance calculation of a specific footprint model resolved at compile time
+ * 
+ * See EdgeObstacleSpecialized for details.
+ * @tparam FootprintT concrete footprint model (e.g. PolygonRobotFootprint)
+ * @see footprintType(), TebOptimalPlanner::AddEdgesObstacles
+ */
+template <typename FootprintT>
+class EdgeInflatedObstacleSpecialized : public EdgeInflatedObstacle
+{
+public:
+  
+  /**
+   * @brief Actual cost function
+   */    
+  void computeError()
+  {
+    TEB_ASSERT_MSG(cfg_ && _measurement && robot_model_, "You must call setTebConfig(), setObstacle() and setRobotModel() on EdgeInflatedObstacleSpecialized()");
+    const VertexPose* bandpt = static_cast<const VertexPose*>(_vertices[0]);
+    
+    double dist = static_cast<const FootprintT*>(robot_model_)->FootprintT::calculateDistance(bandpt->pose(), bandpt->orientationUnitVec(), _measurement);
+    
+    computeErrorFromDistance(dist);
+  }
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
     
 
 } // end namespace
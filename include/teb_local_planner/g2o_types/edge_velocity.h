@@ -48,6 +48,7 @@
 #include <teb_local_planner/g2o_types/vertex_timediff.h>
 #include <teb_local_planner/g2o_types/base_teb_edges.h>
 #include <teb_local_planner/g2o_types/penalties.h>
+#include <teb_local_planner/g2o_types/edge_chain_batch.h>
 #include <teb_local_planner/teb_config.h>
 
 
@@ -69,10 +70,10 @@ namespace teb_local_planner
  * \e penaltyInterval denotes the penalty function, see penaltyBoundToInterval(). \n
  * The dimension of the error / cost vector is 2: the first component represents the translational velocity and
  * the second one the rotational velocity.
- * @see TebOptimalPlanner::AddEdgesVelocity
+ * @see TebOptimalPlanner::AddEdgesVelocity, EdgeChainBatch
  * @remarks Do not forget to call setTebConfig()
  */  
-class EdgeVelocity : public BaseTebMultiEdge<2, double>
+class EdgeVelocity : public BaseTebMultiEdge<2, double>, public BatchableEdge, public ConstraintShift<2>
 {
 public:
   
@@ -89,31 +90,29 @@ public:
    */  
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeVelocity()");
+    TEB_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeVelocity()");
     const VertexPose* conf1 = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* conf2 = static_cast<const VertexPose*>(_vertices[1]);
     const VertexTimeDiff* deltaT = static_cast<const VertexTimeDiff*>(_vertices[2]);
     
-    const Eigen::Vector2d deltaS = conf2->estimate().position() - conf1->estimate().position();
-    
-    double dist = deltaS.norm();
-    const double angle_diff = g2o::normalize_theta(conf2->theta() - conf1->theta());
-    if (cfg_->trajectory.exact_arc_length && angle_diff != 0)
-    {
-        double radius =  dist/(2*sin(angle_diff/2));
-        dist = fabs( angle_diff * radius ); // actual arg length!
-    }
-    double vel = dist / deltaT->estimate();
-    
-//     vel *= g2o::sign(deltaS[0]*cos(conf1->theta()) + deltaS[1]*sin(conf1->theta())); // consider direction
-    vel *= fast_sigmoid( 100 * (deltaS.x()*cos(conf1->theta()) + deltaS.y()*sin(conf1->theta())) ); // consider direction
-    
-    const double omega = angle_diff / deltaT->estimate();
-  
-    _error[0] = penaltyBoundToInterval(vel, -cfg_->robot.max_vel_x_backwards, cfg_->robot.max_vel_x,cfg_->optim.penalty_epsilon);
-    _error[1] = penaltyBoundToInterval(omega, cfg_->robot.max_vel_theta,cfg_->optim.penalty_epsilon);
+    velocityErrorKernel(*cfg_, PoseSample::fromVertex(*conf1), PoseSample::fromVertex(*conf2, false), deltaT->estimate(), _error.data());
+
+    applyConstraintShift(_error);
 
-    ROS_ASSERT_MSG(std::isfinite(_error[0]), "EdgeVelocity::computeError() _error[0]=%f _error[1]=%f\n",_error[0],_error[1]);
+    TEB_ASSERT_MSG(std::isfinite(_error[0]), "EdgeVelocity::computeError() _error[0]=%f _error[1]=%f\n",_error[0],_error[1]);
+  }
+  
+  /**
+   * @brief Jacobi matrix of the cost function specified in computeError().
+   * 
+   * Taken from the EdgeChainBatch if the edge is attached to an active batch, otherwise computed numerically by g2o.
+   */
+  void linearizeOplus()
+  {
+    double* jacobians[3] = {_jacobianOplus[0].data(), _jacobianOplus[1].data(), _jacobianOplus[2].data()};
+    if (batch_ && batch_->getJacobians(EdgeChainType::Velocity, batch_index_, jacobians))
+      return;
+    BaseTebMultiEdge<2, double>::linearizeOplus();
   }
 
 #ifdef USE_ANALYTIC_JACOBI
@@ -125,7 +124,7 @@ public:
    */
   void linearizeOplus()
   {
-    ROS_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeVelocity()");
+    TEB_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeVelocity()");
     const VertexPose* conf1 = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* conf2 = static_cast<const VertexPose*>(_vertices[1]);
     const VertexTimeDiff* deltaT = static_cast<const VertexTimeDiff*>(_vertices[2]);
@@ -218,7 +217,7 @@ public:
  * @see TebOptimalPlanner::AddEdgesVelocity
  * @remarks Do not forget to call setTebConfig()
  */  
-class EdgeVelocityHolonomic : public BaseTebMultiEdge<3, double>
+class EdgeVelocityHolonomic : public BaseTebMultiEdge<3, double>, public ConstraintShift<3>
 {
 public:
   
@@ -235,14 +234,14 @@ public:
    */  
   void computeError()
   {
-    ROS_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeVelocityHolonomic()");
+    TEB_ASSERT_MSG(cfg_, "You must call setTebConfig on EdgeVelocityHolonomic()");
     const VertexPose* conf1 = static_cast<const VertexPose*>(_vertices[0]);
     const VertexPose* conf2 = static_cast<const VertexPose*>(_vertices[1]);
     const VertexTimeDiff* deltaT = static_cast<const VertexTimeDiff*>(_vertices[2]);
     Eigen::Vector2d deltaS = conf2->position() - conf1->position();
     
-    double cos_theta1 = std::cos(conf1->theta());
-    double sin_theta1 = std::sin(conf1->theta()); 
+    double cos_theta1 = conf1->cosTheta();
+    double sin_theta1 = conf1->sinTheta(); 
     
     // transform conf2 into current robot frame conf1 (inverse 2d rotation matrix)
     double r_dx =  cos_theta1*deltaS.x() + sin_theta1*deltaS.y();
@@ -256,7 +255,9 @@ public:
     _error[1] = penaltyBoundToInterval(vy, cfg_->robot.max_vel_y, 0.0); // we do not apply the penalty epsilon here, since the velocity could be close to zero
     _error[2] = penaltyBoundToInterval(omega, cfg_->robot.max_vel_theta,cfg_->optim.penalty_epsilon);
 
-    ROS_ASSERT_MSG(std::isfinite(_error[0]) && std::isfinite(_error[1]) && std::isfinite(_error[2]),
+    applyConstraintShift(_error);
+
+    TEB_ASSERT_MSG(std::isfinite(_error[0]) && std::isfinite(_error[1]) && std::isfinite(_error[2]),
                    "EdgeVelocityHolonomic::computeError() _error[0]=%f _error[1]=%f _error[2]=%f\n",_error[0],_error[1],_error[2]);
   }
  
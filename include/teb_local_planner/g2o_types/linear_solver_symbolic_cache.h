@@ -0,0 +1,190 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef LINEAR_SOLVER_SYMBOLIC_CACHE_H_
+#define LINEAR_SOLVER_SYMBOLIC_CACHE_H_
+
+#include <g2o/core/sparse_block_matrix.h>
+
+#include <vector>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @class LinearSolverSymbolicCache
+ * @brief Keeps the symbolic factorization of a g2o linear solver across graph rebuilds
+ * 
+ * The TebOptimalPlanner rebuilds the hyper-graph in each outer iteration and in each planning cycle.
+ * g2o then reinitializes the linear solver, which discards the fill-reducing ordering and the elimination tree
+ * (symbolic factorization) and recomputes them in the next solve.
+ * However, the sparsity pattern of the TEB hessian is determined by the chain of velocity, acceleration and kinematic
+ * edges and by the set of fixed vertices only: obstacle and via-point edges are unary and contribute to diagonal blocks.
+ * As long as the number of poses does not change (which is the usual case with the hysteresis of the auto resize),
+ * the pattern is identical even though the obstacle association and all numerical values changed.
+ * 
+ * If enabled, this wrapper defers the reinitialization to the first solve after init().
+ * The block pattern of the new system is compared to the one of the previous analysis: if they are identical,
+ * the symbolic factorization is reused and only the numeric factorization is performed,
+ * otherwise the wrapped solver is reinitialized and performs a complete analysis.
+ * 
+ * Only the symbolic factorization is kept: the compressed column view of the wrapped solver refers to the blocks of
+ * the previous hessian, which is reallocated by the block solver after each init(). Hence the view is always
+ * rebuilt for the new system (in the same way as the wrapped solver does after its own init()).
+ * @tparam LinearSolverBase g2o linear solver derived from g2o::LinearSolverCCS that reuses its symbolic factorization
+ *                          until init() is called (e.g. g2o::LinearSolverCSparse or g2o::LinearSolverCholmod)
+ * @tparam MatrixType block type of the sparse block matrix
+ * @see TebConfig::Optimization::reuse_symbolic_factorization
+ */
+template <class LinearSolverBase, typename MatrixType>
+class LinearSolverSymbolicCache : public LinearSolverBase
+{
+public:
+  
+  /**
+   * @brief Construct the solver (the reuse is disabled by default)
+   */
+  LinearSolverSymbolicCache() : reuse_(false), init_pending_(true), no_analyses_(0), no_reuses_(0) {}
+  
+  /**
+   * @brief Enable or disable the reuse of the symbolic factorization
+   * @param enabled if \c false, the solver behaves exactly like \c LinearSolverBase
+   */
+  void setReuseEnabled(bool enabled) {reuse_ = enabled;}
+  
+  /**
+   * @brief Check whether the reuse of the symbolic factorization is enabled
+   * @return \c true if enabled
+   */
+  bool isReuseEnabled() const {return reuse_;}
+  
+  /**
+   * @brief Reinitialize the solver (deferred to the next solve(), since the new pattern is not known yet)
+   * @return \c true
+   */
+  virtual bool init()
+  {
+    init_pending_ = true;
+    return true;
+  }
+  
+  /**
+   * @brief Solve the system A*x = b
+   * @param A symmetric block matrix (upper triangle)
+   * @param[out] x solution
+   * @param b right hand side
+   * @return \c true if the system was solved successfully
+   */
+  virtual bool solve(const g2o::SparseBlockMatrix<MatrixType>& A, double* x, double* b)
+  {
+    if (init_pending_)
+    {
+      init_pending_ = false;
+      if (!reuse_)
+      {
+        pattern_.clear();
+        LinearSolverBase::init();
+      }
+      else
+      {
+        extractPattern(A, new_pattern_);
+        if (new_pattern_ == pattern_)
+        {
+          this->initMatrixStructure(A); // the blocks of the previous hessian are already freed
+          ++no_reuses_;
+        }
+        else
+        {
+          LinearSolverBase::init();
+          pattern_.swap(new_pattern_);
+          ++no_analyses_;
+        }
+      }
+    }
+    return LinearSolverBase::solve(A, x, b);
+  }
+  
+  /**
+   * @brief Get the number of complete analyses performed since the reuse was enabled
+   * @return number of symbolic factorizations
+   */
+  int getNumberOfAnalyses() const {return no_analyses_;}
+  
+  /**
+   * @brief Get the number of reinitializations in which the symbolic factorization was reused
+   * @return number of reuses
+   */
+  int getNumberOfReuses() const {return no_reuses_;}
+  
+protected:
+  
+  /**
+   * @brief Serialize the block structure of a sparse block matrix
+   * 
+   * The block dimensions are encoded by the cumulative row and column indices, followed by the
+   * row indices of the (upper triangular) blocks of each block column. Sections are separated by -1.
+   * @param A sparse block matrix
+   * @param[out] pattern serialized pattern (the allocated memory is reused)
+   */
+  static void extractPattern(const g2o::SparseBlockMatrix<MatrixType>& A, std::vector<int>& pattern)
+  {
+    pattern.clear();
+    pattern.insert(pattern.end(), A.rowBlockIndices().begin(), A.rowBlockIndices().end());
+    pattern.push_back(-1);
+    pattern.insert(pattern.end(), A.colBlockIndices().begin(), A.colBlockIndices().end());
+    pattern.push_back(-1);
+    for (std::size_t col = 0; col < A.blockCols().size(); ++col)
+    {
+      for (typename g2o::SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = A.blockCols()[col].begin(); it != A.blockCols()[col].end(); ++it)
+        pattern.push_back(it->first);
+      pattern.push_back(-1);
+    }
+  }
+  
+  bool reuse_; //!< Reuse the symbolic factorization if the pattern did not change
+  bool init_pending_; //!< A reinitialization was requested, which is performed (if required) in the next solve()
+  std::vector<int> pattern_; //!< Block pattern of the system of the last complete analysis
+  std::vector<int> new_pattern_; //!< Block pattern of the current system (preallocated)
+  int no_analyses_; //!< Number of complete analyses
+  int no_reuses_; //!< Number of reused symbolic factorizations
+};
+
+} // namespace teb_local_planner
+
+#endif /* LINEAR_SOLVER_SYMBOLIC_CACHE_H_ */
@@ -51,12 +51,25 @@
 
 #include <teb_local_planner/pose_se2.h>
 
+#include <cmath>
+#include <limits>
+
 namespace teb_local_planner
 {
 
 /**
   * @class VertexPose
   * @brief This class stores and wraps a SE2 pose (position and orientation) into a vertex that can be optimized via g2o
+  * 
+  * The vertex caches cos and sin of the yaw angle, since most edges and the footprint models require them
+  * (often for the same vertex and, due to numerical differentiation, many times per iteration).
+  * The cache is refreshed by the modifying methods (constructors, setEstimate(), setTheta(), oplusImpl(),
+  * pop() and read()), and only if the yaw angle actually changed. Perturbing only the position keeps the cache valid.
+  * Writes through the mutable references theta() and pose() cannot be observed. The cache is keyed by the angle
+  * for which it was computed, hence such writes are detected and the cache is refreshed by the next read.
+  * @warning This lazy refresh modifies the cache from a const method and is single-threaded only:
+  *          do not read a vertex from multiple threads after writing its yaw angle through theta() or pose()
+  *          (use setTheta() or setEstimate() instead).
   * @see PoseSE2
   * @see VertexTimeDiff
   */
@@ -68,7 +81,7 @@ public:
     * @brief Default constructor
     * @param fixed if \c true, this vertex is considered fixed during optimization [default: \c false]
     */ 
-  VertexPose(bool fixed = false)
+  VertexPose(bool fixed = false) : cached_theta_(std::numeric_limits<double>::quiet_NaN())
   {
     setToOriginImpl();
     setFixed(fixed);
@@ -79,9 +92,10 @@ public:
     * @param pose PoseSE2 defining the pose [x, y, angle_rad]
     * @param fixed if \c true, this vertex is considered fixed during optimization [default: \c false]
     */ 
-  VertexPose(const PoseSE2& pose, bool fixed = false)
+  VertexPose(const PoseSE2& pose, bool fixed = false) : cached_theta_(std::numeric_limits<double>::quiet_NaN())
   {
     _estimate = pose;
+    updateOrientationCache();
     setFixed(fixed);
   }
   
@@ -91,10 +105,11 @@ public:
     * @param theta yaw-angle
     * @param fixed if \c true, this vertex is considered fixed during optimization [default: \c false]
     */ 
-  VertexPose(const Eigen::Ref<const Eigen::Vector2d>& position, double theta, bool fixed = false)
+  VertexPose(const Eigen::Ref<const Eigen::Vector2d>& position, double theta, bool fixed = false) : cached_theta_(std::numeric_limits<double>::quiet_NaN())
   {
     _estimate.position() = position;
     _estimate.theta() = theta;
+    updateOrientationCache();
     setFixed(fixed);
   }
   
@@ -105,11 +120,12 @@ public:
     * @param theta yaw angle in rad
     * @param fixed if \c true, this vertex is considered fixed during optimization [default: \c false]
     */ 
-  VertexPose(double x, double y, double theta, bool fixed = false)
+  VertexPose(double x, double y, double theta, bool fixed = false) : cached_theta_(std::numeric_limits<double>::quiet_NaN())
   {
     _estimate.x() = x;
     _estimate.y() = y;
     _estimate.theta() = theta;
+    updateOrientationCache();
     setFixed(fixed);
   }
   
@@ -183,12 +199,55 @@ public:
     */ 
   const double& theta() const {return _estimate.theta();}
   
+  /**
+    * @brief Set the pose and refresh the orientation cache
+    * @param pose PoseSE2 defining the pose [x, y, angle_rad]
+    */ 
+  void setEstimate(const PoseSE2& pose)
+  {
+    g2o::BaseVertex<3, PoseSE2 >::setEstimate(pose);
+    updateOrientationCache();
+  }
+  
+  /**
+    * @brief Set the orientation part (yaw angle) of the pose and refresh the orientation cache
+    * @param theta yaw angle in rad
+    */ 
+  void setTheta(double theta)
+  {
+    _estimate.theta() = theta;
+    updateOrientationCache();
+  }
+  
+  /**
+    * @brief Get the cosine of the yaw angle (cached)
+    * @return cos(theta)
+    */ 
+  double cosTheta() const {return orientationUnitVec().x();}
+  
+  /**
+    * @brief Get the sine of the yaw angle (cached)
+    * @return sin(theta)
+    */ 
+  double sinTheta() const {return orientationUnitVec().y();}
+  
+  /**
+    * @brief Get the unit vector of the current orientation (cached)
+    * @return [cos(theta), sin(theta)]^T
+    */ 
+  const Eigen::Vector2d& orientationUnitVec() const
+  {
+    updateOrientationCache(); // no-op unless the yaw angle was written through theta() or pose()
+    return orientation_;
+  }
+  
   /**
     * @brief Set the underlying estimate (2D vector) to zero.
     */ 
   virtual void setToOriginImpl()
   {
     _estimate.setZero();
+    updateOrientationCache();
   }
 
   /**
@@ -200,6 +259,16 @@ public:
   virtual void oplusImpl(const double* update)
   {
     _estimate.plus(update);
+    updateOrientationCache();
+  }
+  
+  /**
+    * @brief Restore the previously pushed estimate (refer to g2o::BaseVertex::pop()) and refresh the orientation cache
+    */ 
+  virtual void pop()
+  {
+    g2o::BaseVertex<3, PoseSE2 >::pop();
+    updateOrientationCache();
   }
 
   /**
@@ -211,6 +280,7 @@ public:
   virtual bool read(std::istream& is)
   {
     is >> _estimate.x() >> _estimate.y() >> _estimate.theta();
+    updateOrientationCache();
     return true;
   }
 
@@ -225,7 +295,28 @@ public:
     os << _estimate.x() << " " << _estimate.y() << _estimate.theta();
     return os.good();
   }
+  
+protected:
+  
+  /**
+    * @brief Recompute the cached orientation unit vector if the yaw angle changed since the last update
+    * @remarks Single-threaded only (see the class description), orientation_ is written before cached_theta_.
+    */ 
+  void updateOrientationCache() const
+  {
+    if (_estimate.theta() != cached_theta_) // also true if the cache is invalid (NaN)
+    {
+      const double theta = _estimate.theta();
+      orientation_.x() = std::cos(theta);
+      orientation_.y() = std::sin(theta);
+      cached_theta_ = theta;
+    }
+  }
+  
+  mutable double cached_theta_; //!< Yaw angle for which orientation_ is valid (NaN if invalid)
+  mutable Eigen::Vector2d orientation_; //!< Cached [cos(theta), sin(theta)]^T
 
+public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW  
 };
 
@@ -44,8 +44,8 @@
 #include <teb_local_planner/obstacles.h>
 #include <teb_local_planner/teb_config.h>
 #include <teb_local_planner/timed_elastic_band.h>
+#include <teb_local_planner/logging.h>
 
-#include <ros/ros.h>
 #include <math.h>
 #include <algorithm>
 #include <functional>
@@ -103,7 +103,7 @@ public:
         }
 
 
-        ROS_ASSERT_MSG(cfg_->hcp.h_signature_prescaler>0.1 && cfg_->hcp.h_signature_prescaler<=1, "Only a prescaler on the interval (0.1,1] ist allowed.");
+        TEB_ASSERT_MSG(cfg_->hcp.h_signature_prescaler>0.1 && cfg_->hcp.h_signature_prescaler<=1, "Only a prescaler on the interval (0.1,1] ist allowed.");
 
         // guess values for f0
         // paper proposes a+b=N-1 && |a-b|<=1, 1...N obstacles
@@ -203,7 +203,7 @@ public:
                 return true; // Found! Homotopy class already exists, therefore nothing added
         }
         else
-            ROS_ERROR("Cannot compare HSignature equivalence classes with types other than HSignature.");
+            TEB_ERROR("Cannot compare HSignature equivalence classes with types other than HSignature.");
 
         return false;
     }
@@ -310,7 +310,7 @@ public:
           else // otherwise use the time information from the teb trajectory
           {
             if (std::distance(path_iter, path_end) != std::distance(timediff_iter, timediff_end.get()))
-              ROS_ERROR("Size of poses and timediff vectors does not match. This is a bug.");
+              TEB_ERROR("Size of poses and timediff vectors does not match. This is a bug.");
             next_transition_time += (*timediff_iter)->dt();
           }
 
@@ -378,7 +378,7 @@ public:
         }
       }
       else
-          ROS_ERROR("Cannot compare HSignature3d equivalence classes with types other than HSignature3d.");
+          TEB_ERROR("Cannot compare HSignature3d equivalence classes with types other than HSignature3d.");
 
       return false;
     }
@@ -47,21 +47,14 @@
 
 #include <boost/shared_ptr.hpp>
 
-#include <visualization_msgs/Marker.h>
-#include <geometry_msgs/Point.h>
-#include <std_msgs/ColorRGBA.h>
-
-#include <ros/console.h>
-#include <ros/ros.h>
-
 #include <teb_local_planner/planner_interface.h>
 #include <teb_local_planner/teb_config.h>
 #include <teb_local_planner/obstacles.h>
 #include <teb_local_planner/optimal_planner.h>
-#include <teb_local_planner/visualization.h>
 #include <teb_local_planner/robot_footprint_model.h>
 #include <teb_local_planner/equivalence_relations.h>
 #include <teb_local_planner/graph_search.h>
+#include <teb_local_planner/clock.h>
 
 
 namespace teb_local_planner
@@ -74,10 +67,10 @@ inline std::complex<long double> getCplxFromVertexPosePtr(const VertexPose* pose
 };
 
 
-//!< Inline function used for calculateHSignature() in combination with geometry_msgs::PoseStamped
-inline std::complex<long double> getCplxFromMsgPoseStamped(const geometry_msgs::PoseStamped& pose)
+//!< Inline function used for calculateHSignature() in combination with PoseSE2
+inline std::complex<long double> getCplxFromPoseSE2(const PoseSE2& pose)
 {
-  return std::complex<long double>(pose.pose.position.x, pose.pose.position.y);
+  return std::complex<long double>(pose.x(), pose.y());
 };
 
 /**
@@ -120,11 +113,11 @@ public:
    * @param cfg Const reference to the TebConfig class for internal parameters
    * @param obstacles Container storing all relevant obstacles (see Obstacle)
    * @param robot_model Shared pointer to the robot shape model used for optimization (optional)
-   * @param visualization Shared pointer to the TebVisualization class (optional)
    * @param via_points Container storing via-points (optional)
+   * @param clock Time source of this planner (optional, the global clock returned by getClock() is used if empty)
    */
   HomotopyClassPlanner(const TebConfig& cfg, ObstContainer* obstacles = NULL, RobotFootprintModelPtr robot_model = boost::make_shared<PointRobotFootprint>(),
-                       TebVisualizationPtr visualization = TebVisualizationPtr(), const ViaPointContainer* via_points = NULL);
+                       const ViaPointContainer* via_points = NULL, const ClockPtr& clock = ClockPtr());
 
   /**
    * @brief Destruct the HomotopyClassPlanner.
@@ -136,11 +129,11 @@ public:
    * @param cfg Const reference to the TebConfig class for internal parameters
    * @param obstacles Container storing all relevant obstacles (see Obstacle)
    * @param robot_model Shared pointer to the robot shape model used for optimization (optional)
-   * @param visualization Shared pointer to the TebVisualization class (optional)
    * @param via_points Container storing via-points (optional)
+   * @param clock Time source of this planner (optional, the global clock returned by getClock() is used if empty)
    */
   void initialize(const TebConfig& cfg, ObstContainer* obstacles = NULL, RobotFootprintModelPtr robot_model = boost::make_shared<PointRobotFootprint>(),
-                  TebVisualizationPtr visualization = TebVisualizationPtr(), const ViaPointContainer* via_points = NULL);
+                  const ViaPointContainer* via_points = NULL, const ClockPtr& clock = ClockPtr());
 
 
 
@@ -153,39 +146,40 @@ public:
    * Provide this method to create and optimize a trajectory that is initialized
    * according to an initial reference plan (given as a container of poses).
    * @warning The current implementation extracts only the start and goal pose and calls the overloaded plan()
-   * @param initial_plan vector of geometry_msgs::PoseStamped (must be valid until clearPlanner() is called!)
-   * @param start_vel Current start velocity (e.g. the velocity of the robot, only linear.x, linear.y (holonomic) and angular.z are used)
+   * @param initial_plan container of poses (must be valid until clearPlanner() is called!)
+   * @param start_vel Current start velocity (e.g. the velocity of the robot, only vx, vy (holonomic) and omega are used)
    * @param free_goal_vel if \c true, a nonzero final velocity at the goal pose is allowed,
    *		      otherwise the final velocity will be zero (default: false)
    * @return \c true if planning was successful, \c false otherwise
    */
-  virtual bool plan(const std::vector<geometry_msgs::PoseStamped>& initial_plan, const geometry_msgs::Twist* start_vel = NULL, bool free_goal_vel=false);
+  virtual bool plan(const PoseSE2Container& initial_plan, const Twist2D* start_vel = NULL, bool free_goal_vel=false);
 
   /**
-   * @brief Plan a trajectory between a given start and goal pose (tf::Pose version).
+   * @brief Plan a trajectory between a given start and goal pose.
    *
    * Provide this method to create and optimize a trajectory that is initialized between a given start and goal pose.
-   * @param start tf::Pose containing the start pose of the trajectory
-   * @param goal tf::Pose containing the goal pose of the trajectory
-   * @param start_vel Current start velocity (e.g. the velocity of the robot, only linear.x, linear.y (holonomic) and angular.z are used)
+   * @param start PoseSE2 containing the start pose of the trajectory
+   * @param goal PoseSE2 containing the goal pose of the trajectory
+   * @param start_vel Initial velocity at the start pose (containing the translational and angular velocity).
    * @param free_goal_vel if \c true, a nonzero final velocity at the goal pose is allowed,
    *		      otherwise the final velocity will be zero (default: false)
    * @return \c true if planning was successful, \c false otherwise
    */
-  virtual bool plan(const tf::Pose& start, const tf::Pose& goal, const geometry_msgs::Twist* start_vel = NULL, bool free_goal_vel=false);
+  virtual bool plan(const PoseSE2& start, const PoseSE2& goal, const Twist2D* start_vel = NULL, bool free_goal_vel=false);
 
   /**
-   * @brief Plan a trajectory between a given start and goal pose.
+   * @brief Refine the currently best trajectory with a reduced optimization effort.
    *
-   * Provide this method to create and optimize a trajectory that is initialized between a given start and goal pose.
-   * @param start PoseSE2 containing the start pose of the trajectory
-   * @param goal PoseSE2 containing the goal pose of the trajectory
-   * @param start_vel Initial velocity at the start pose (twist message containing the translational and angular velocity).
+   * Only the best candidate is updated and optimized (see TebOptimalPlanner::refine()),
+   * no new equivalence classes are explored and the selection is kept.
+   * A regular plan() is performed if no candidate exists yet.
+   * @param initial_plan container of poses (start and goal included)
+   * @param start_vel Current start velocity (e.g. the velocity of the robot, only vx, vy (holonomic) and omega are used)
    * @param free_goal_vel if \c true, a nonzero final velocity at the goal pose is allowed,
    *		      otherwise the final velocity will be zero (default: false)
    * @return \c true if planning was successful, \c false otherwise
    */
-  virtual bool plan(const PoseSE2& start, const PoseSE2& goal, const geometry_msgs::Twist* start_vel = NULL, bool free_goal_vel=false);
+  virtual bool refine(const PoseSE2Container& initial_plan, const Twist2D* start_vel = NULL, bool free_goal_vel=false);
 
   /**
    * @brief Get the velocity command from a previously optimized plan to control the robot at the current sampling interval.
@@ -197,6 +191,24 @@ public:
    */
   virtual bool getVelocityCommand(double& vx, double& vy, double& omega) const;
 
+  /**
+   * @brief Compute the deviation of a pose from the currently best trajectory (see TebOptimalPlanner::computeTrackingError())
+   * @param pose pose to be compared with the trajectory (e.g. the current robot pose)
+   * @param[out] dist Euclidean distance to the trajectory [m]
+   * @param[out] angle_diff absolute orientation difference to the closest pose of the trajectory [rad]
+   * @return \c true if a trajectory is available, \c false otherwise
+   */
+  virtual bool computeTrackingError(const PoseSE2& pose, double& dist, double& angle_diff) const;
+
+  /**
+   * @brief Predict the state of the robot according to the currently best trajectory (see TebOptimalPlanner::predictState())
+   * @param t time w.r.t. the start of the trajectory [s]
+   * @param[out] pose predicted pose
+   * @param[out] velocity predicted velocity (w.r.t. the robot frame)
+   * @return \c true if a trajectory is available, \c false otherwise
+   */
+  virtual bool predictState(double t, PoseSE2& pose, Twist2D& velocity) const;
+
   /**
    * @brief Access current best trajectory candidate (that relates to the "best" homotopy class).
    *
@@ -211,17 +223,14 @@ public:
    * @brief Check whether the planned trajectory is feasible or not.
    *
    * This method currently checks only that the trajectory, or a part of the trajectory is collision free.
-   * Obstacles are here represented as costmap instead of the internal ObstacleContainer.
-   * @param costmap_model Pointer to the costmap model
-   * @param footprint_spec The specification of the footprint of the robot in world coordinates
-   * @param inscribed_radius The radius of the inscribed circle of the robot
-   * @param circumscribed_radius The radius of the circumscribed circle of the robot
+   * Obstacles are here represented by an external world model (e.g. a costmap) instead of the internal ObstacleContainer.
+   * Infeasible candidates are removed until a feasible one is found.
+   * @param checker Collision checker that validates single robot poses
    * @param look_ahead_idx Number of poses along the trajectory that should be verified, if -1, the complete trajectory will be checked.
    * @return \c true, if the robot footprint along the first part of the trajectory intersects with
    *         any obstacle in the costmap, \c false otherwise.
    */
-  virtual bool isTrajectoryFeasible(base_local_planner::CostmapModel* costmap_model, const std::vector<geometry_msgs::Point>& footprint_spec,
-                                    double inscribed_radius = 0.0, double circumscribed_radius=0.0, int look_ahead_idx=-1);
+  virtual bool isTrajectoryFeasible(const FootprintCollisionChecker& checker, int look_ahead_idx=-1);
 
   /**
    * @brief In case of empty best teb, scores again the available plans to find the best one.
@@ -240,26 +249,6 @@ public:
 
   //@}
 
-  /** @name Visualization */
-  //@{
-
-  /**
-   * @brief Register a TebVisualization class to enable visiualization routines (e.g. publish the local plan and pose sequence)
-   * @param visualization shared pointer to a TebVisualization instance
-   * @see visualizeTeb
-   */
-  void setVisualization(TebVisualizationPtr visualization);
-
-   /**
-    * @brief Publish the local plan, pose sequence and additional information via ros topics (e.g. subscribe with rviz).
-    *
-    * Make sure to register a TebVisualization instance before using setVisualization() or an overlaoded constructor.
-    * @see setVisualization
-    */
-  virtual void visualize();
-
-  //@}
-
   /** @name Important steps that are called during planning */
   //@{
 
@@ -279,7 +268,7 @@ public:
    * @param dist_to_obst Allowed distance to obstacles: if not satisfying, the path will be rejected (note, this is not the distance used for optimization).
    * @param @param start_velocity start velocity (optional)
    */
-  void exploreEquivalenceClassesAndInitTebs(const PoseSE2& start, const PoseSE2& goal, double dist_to_obst, const geometry_msgs::Twist* start_vel);
+  void exploreEquivalenceClassesAndInitTebs(const PoseSE2& start, const PoseSE2& goal, double dist_to_obst, const Twist2D* start_vel);
 
   /**
    * @brief Add a new Teb to the internal trajectory container, if this teb constitutes a new equivalence class. Initialize it using a generic 2D reference path
@@ -296,7 +285,7 @@ public:
    * @return Shared pointer to the newly created teb optimal planner
    */
   template<typename BidirIter, typename Fun>
-  TebOptimalPlannerPtr addAndInitNewTeb(BidirIter path_start, BidirIter path_end, Fun fun_position, double start_orientation, double goal_orientation, const geometry_msgs::Twist* start_velocity);
+  TebOptimalPlannerPtr addAndInitNewTeb(BidirIter path_start, BidirIter path_end, Fun fun_position, double start_orientation, double goal_orientation, const Twist2D* start_velocity);
 
   /**
    * @brief Add a new Teb to the internal trajectory container, if this teb constitutes a new equivalence class. Initialize it with a simple straight line between a given start and goal
@@ -305,7 +294,7 @@ public:
    * @param start_velocity start velocity (optional)
    * @return Shared pointer to the newly created teb optimal planner
    */
-  TebOptimalPlannerPtr addAndInitNewTeb(const PoseSE2& start, const PoseSE2& goal, const geometry_msgs::Twist* start_velocity);
+  TebOptimalPlannerPtr addAndInitNewTeb(const PoseSE2& start, const PoseSE2& goal, const Twist2D* start_velocity);
 
   /**
    * @brief Add a new Teb to the internal trajectory container , if this teb constitutes a new equivalence class. Initialize it using a PoseStamped container
@@ -313,7 +302,7 @@ public:
    * @param start_velocity start velocity (optional)
    * @return Shared pointer to the newly created teb optimal planner
    */
-  TebOptimalPlannerPtr addAndInitNewTeb(const std::vector<geometry_msgs::PoseStamped>& initial_plan, const geometry_msgs::Twist* start_velocity);
+  TebOptimalPlannerPtr addAndInitNewTeb(const PoseSE2Container& initial_plan, const Twist2D* start_velocity);
 
   /**
    * @brief Update TEBs with new pose, goal and current velocity.
@@ -321,7 +310,7 @@ public:
    * @param goal New goal pose (optional)
    * @param start_velocity start velocity (optional)
    */
-  void updateAllTEBs(const PoseSE2* start, const PoseSE2* goal, const geometry_msgs::Twist* start_velocity);
+  void updateAllTEBs(const PoseSE2* start, const PoseSE2* goal, const Twist2D* start_velocity);
 
 
   /**
@@ -367,6 +356,23 @@ public:
    * @param dir This parameter might be RotType::left (prefer left), RotType::right (prefer right) or RotType::none (prefer none)
    */
   virtual void setPreferredTurningDir(RotType dir);
+  
+  /**
+   * @brief Register a telemetry sink that records statistics of each optimizer iteration of all trajectory candidates
+   * 
+   * Each candidate is assigned a unique source id (see OptimizerIterationRecord::source).
+   * @param telemetry shared telemetry instance (see OptimizerTelemetry), pass an empty pointer in order to disable the recording
+   */
+  virtual void setTelemetry(OptimizerTelemetryPtr telemetry);
+  
+  /**
+   * @brief Register a cache of optimized trajectories that is shared with all trajectory candidates
+   * 
+   * The candidates that follow the initial plan (or the straight line between start and goal) are initialized from the cache.
+   * The best trajectory of each cold start is stored in the cache.
+   * @param cache shared cache instance (see ExperienceCache), pass an empty pointer in order to detach the cache
+   */
+  virtual void setExperienceCache(ExperienceCachePtr cache);
 
   /**
    * @brief Check if the planner suggests a shorter horizon (e.g. to resolve problems)
@@ -377,7 +383,7 @@ public:
    * @param initial_plan The intial and transformed plan (part of the local map and pruned up to the robot position)
    * @return \c true, if the planner suggests a shorter horizon, \c false otherwise.
    */
-  virtual bool isHorizonReductionAppropriate(const std::vector<geometry_msgs::PoseStamped>& initial_plan) const;
+  virtual bool isHorizonReductionAppropriate(const PoseSE2Container& initial_plan) const;
 
   /**
    * @brief Calculate the equivalence class of a path
@@ -401,6 +407,12 @@ public:
    * @return read-only reference to the teb container.
    */
   const TebOptPlannerContainer& getTrajectoryContainer() const {return tebs_;}
+  
+  /**
+   * @brief Read-only access to the graph utilized for exploring alternative homotopy classes (e.g. for visualization).
+   * @return shared pointer to the graph search object (empty if the planner is not initialized).
+   */
+  boost::shared_ptr<const GraphSearchInterface> getGraphSearch() const {return graph_search_;}
 
   /**
    * Compute and return the cost of the current optimization graph (supports multiple trajectories)
@@ -534,11 +546,10 @@ protected:
   const ViaPointContainer* via_points_; //!< Store the current list of via-points
 
   // internal objects (memory management owned)
-  TebVisualizationPtr visualization_; //!< Instance of the visualization class (local/global plan, obstacles, ...)
   TebOptimalPlannerPtr best_teb_; //!< Store the current best teb.
   RobotFootprintModelPtr robot_model_; //!< Robot model shared instance
 
-  const std::vector<geometry_msgs::PoseStamped>* initial_plan_; //!< Store the initial plan if available for a better trajectory initialization
+  const PoseSE2Container* initial_plan_; //!< Store the initial plan if available for a better trajectory initialization
   EquivalenceClassPtr initial_plan_eq_class_; //!< Store the equivalence class of the initial plan
   TebOptimalPlannerPtr initial_plan_teb_; //!< Store pointer to the TEB related to the initial plan (use method getInitialPlanTEB() since it checks if initial_plan_teb_ is still included in tebs_.)
 
@@ -549,11 +560,16 @@ protected:
 
   boost::shared_ptr<GraphSearchInterface> graph_search_;
 
-  ros::Time last_eq_class_switching_time_; //!< Store the time at which the equivalence class changed recently
+  ClockPtr clock_; //!< Time source of this planner (empty: use the global clock)
+  double last_eq_class_switching_time_; //!< Store the time [s] at which the equivalence class changed recently (see clock_)
 
   bool initialized_; //!< Keeps track about the correct initialization of this class
 
   TebOptimalPlannerPtr last_best_teb_;  //!< Points to the plan used in the previous control cycle
+  
+  OptimizerTelemetryPtr telemetry_; //!< Optional sink for per-iteration optimizer statistics (shared with all candidates)
+  ExperienceCachePtr experience_cache_; //!< Optional cache of optimized trajectories (shared with all candidates)
+  int telemetry_source_counter_; //!< Source id assigned to the next trajectory candidate
 
 
 
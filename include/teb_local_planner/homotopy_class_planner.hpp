@@ -47,6 +47,7 @@ template<typename BidirIter, typename Fun>
 EquivalenceClassPtr HomotopyClassPlanner::calculateEquivalenceClass(BidirIter path_start, BidirIter path_end, Fun fun_cplx_point, const ObstContainer* obstacles,
                                                                     boost::optional<TimeDiffSequence::iterator> timediff_start, boost::optional<TimeDiffSequence::iterator> timediff_end)
 {
+  AllocationPhaseScope alloc_phase(AllocationPhase::HSignature);
   if(cfg_->obstacles.include_dynamic_obstacles)
   {
     HSignature3d* H = new HSignature3d(*cfg_);
@@ -63,9 +64,10 @@ EquivalenceClassPtr HomotopyClassPlanner::calculateEquivalenceClass(BidirIter pa
 
 
 template<typename BidirIter, typename Fun>
-TebOptimalPlannerPtr HomotopyClassPlanner::addAndInitNewTeb(BidirIter path_start, BidirIter path_end, Fun fun_position, double start_orientation, double goal_orientation, const geometry_msgs::Twist* start_velocity)
+TebOptimalPlannerPtr HomotopyClassPlanner::addAndInitNewTeb(BidirIter path_start, BidirIter path_end, Fun fun_position, double start_orientation, double goal_orientation, const Twist2D* start_velocity)
 {
   TebOptimalPlannerPtr candidate = TebOptimalPlannerPtr( new TebOptimalPlanner(*cfg_, obstacles_, robot_model_));
+  candidate->setExperienceCache(experience_cache_); // the candidate might become the best one of a cold start
 
   candidate->teb().initTrajectoryToGoal(path_start, path_end, fun_position, cfg_->robot.max_vel_x, cfg_->robot.max_vel_theta,
                                  cfg_->robot.acc_lim_x, cfg_->robot.acc_lim_theta, start_orientation, goal_orientation, cfg_->trajectory.min_samples,
@@ -73,12 +75,18 @@ TebOptimalPlannerPtr HomotopyClassPlanner::addAndInitNewTeb(BidirIter path_start
 
   if (start_velocity)
     candidate->setVelocityStart(*start_velocity);
+  candidate->initFeasibleTimeProfile();
 
   EquivalenceClassPtr H = calculateEquivalenceClass(candidate->teb().poses().begin(), candidate->teb().poses().end(), getCplxFromVertexPosePtr, obstacles_,
                                                     candidate->teb().timediffs().begin(), candidate->teb().timediffs().end());
 
   if(addEquivalenceClassIfNew(H))
   {
+    if (telemetry_)
+    {
+      candidate->setTelemetry(telemetry_);
+      candidate->setTelemetrySourceId(telemetry_source_counter_++);
+    }
     tebs_.push_back(candidate);
     return tebs_.back();
   }
@@ -0,0 +1,238 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef TEB_LOGGING_H_
+#define TEB_LOGGING_H_
+
+#include <boost/shared_ptr.hpp>
+
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @class Logger
+ * @brief Abstract interface for the log output of the planning core
+ * 
+ * The planning core does not depend on a specific logging framework.
+ * Messages are forwarded to the logger that is registered via setLogger().
+ * Implementations must be thread-safe, since the planners may log from multiple threads.
+ * By default, messages with level Info or higher are printed to stderr (see StreamLogger).
+ * The ROS adapter (see ros_adapter.h) forwards all messages to rosconsole.
+ */
+class Logger
+{
+public:
+  
+  //! Severity levels of log messages
+  enum Level { Debug = 0, Info, Warn, Error, Fatal };
+  
+  /**
+   * @brief Virtual destructor.
+   */
+  virtual ~Logger() {}
+  
+  /**
+   * @brief Write a single log message
+   * @param level severity of the message
+   * @param file source file that emitted the message
+   * @param line line number in the source file
+   * @param message formatted, null terminated message
+   */
+  virtual void log(Level level, const char* file, int line, const char* message) = 0;
+  
+  /**
+   * @brief Check whether messages with a given level are processed
+   * 
+   * The check is performed before the message is formatted in order to avoid
+   * unnecessary computations for suppressed levels.
+   * @param level severity level to be tested
+   * @return \c true if messages of the given level should be forwarded to log()
+   */
+  virtual bool isEnabled(Level level) const {return true;}
+};
+
+//! Abbrev. for shared logger instances
+typedef boost::shared_ptr<Logger> LoggerPtr;
+
+
+/**
+ * @class StreamLogger
+ * @brief Default logger that prints all messages above a minimum severity to stderr
+ */
+class StreamLogger : public Logger
+{
+public:
+  
+  /**
+   * @brief Construct the logger
+   * @param min_level minimum severity of messages that are printed
+   */
+  StreamLogger(Level min_level = Info) : min_level_(min_level) {}
+  
+  // implements Logger::log()
+  virtual void log(Level level, const char* file, int line, const char* message);
+  
+  // implements Logger::isEnabled()
+  virtual bool isEnabled(Level level) const {return level >= min_level_;}
+  
+  /**
+   * @brief Change the minimum severity of messages that are printed
+   * @param min_level new minimum severity level
+   */
+  void setMinLevel(Level min_level) {min_level_ = min_level;}
+  
+protected:
+  Level min_level_; //!< Minimum severity of printed messages
+};
+
+
+/**
+ * @brief Register a new logger for the planning core
+ * 
+ * The logger is exchanged atomically, hence it may be replaced while planners are running.
+ * Messages that are logged concurrently still reach the previous logger, which is kept alive
+ * until these messages are processed.
+ * Passing an empty pointer restores the default StreamLogger.
+ * @param logger shared pointer to the new logger
+ */
+void setLogger(const LoggerPtr& logger);
+
+/**
+ * @brief Access the currently registered logger
+ * @return shared pointer to the active logger (never empty)
+ */
+LoggerPtr getLogger();
+
+namespace logging
+{
+  
+/**
+ * @brief Format a printf-style message and forward it to the given logger
+ * 
+ * The message is formatted into a fixed size buffer on the stack (messages are truncated if necessary)
+ * in order to avoid heap allocations within the planning loop.
+ */
+void logFormatted(Logger& logger, Logger::Level level, const char* file, int line, const char* fmt, ...)
+#if defined(__GNUC__)
+  __attribute__((format(printf, 5, 6)))
+#endif
+;
+
+/**
+ * @brief Report a failed assertion and abort the program
+ */
+void assertionFailed(const char* condition, const char* file, int line, const char* message);
+
+} // namespace logging
+
+} // namespace teb_local_planner
+
+
+#define TEB_LOG(level, ...) \
+  do { \
+    ::teb_local_planner::LoggerPtr teb_logger = ::teb_local_planner::getLogger(); \
+    if (teb_logger->isEnabled(level)) \
+      ::teb_local_planner::logging::logFormatted(*teb_logger, level, __FILE__, __LINE__, __VA_ARGS__); \
+  } while(0)
+
+#define TEB_LOG_STREAM(level, args) \
+  do { \
+    ::teb_local_planner::LoggerPtr teb_logger = ::teb_local_planner::getLogger(); \
+    if (teb_logger->isEnabled(level)) \
+    { \
+      std::stringstream teb_log_stream; \
+      teb_log_stream << args; \
+      teb_logger->log(level, __FILE__, __LINE__, teb_log_stream.str().c_str()); \
+    } \
+  } while(0)
+
+#define TEB_LOG_ONCE(level, ...) \
+  do { \
+    static bool teb_log_once_hit = false; \
+    if (!teb_log_once_hit) \
+    { \
+      teb_log_once_hit = true; \
+      TEB_LOG(level, __VA_ARGS__); \
+    } \
+  } while(0)
+
+#define TEB_DEBUG(...) TEB_LOG(::teb_local_planner::Logger::Debug, __VA_ARGS__)
+#define TEB_INFO(...) TEB_LOG(::teb_local_planner::Logger::Info, __VA_ARGS__)
+#define TEB_WARN(...) TEB_LOG(::teb_local_planner::Logger::Warn, __VA_ARGS__)
+#define TEB_ERROR(...) TEB_LOG(::teb_local_planner::Logger::Error, __VA_ARGS__)
+
+#define TEB_DEBUG_COND(cond, ...) do { if (cond) TEB_DEBUG(__VA_ARGS__); } while(0)
+#define TEB_INFO_COND(cond, ...) do { if (cond) TEB_INFO(__VA_ARGS__); } while(0)
+#define TEB_WARN_COND(cond, ...) do { if (cond) TEB_WARN(__VA_ARGS__); } while(0)
+
+#define TEB_DEBUG_STREAM(args) TEB_LOG_STREAM(::teb_local_planner::Logger::Debug, args)
+#define TEB_INFO_STREAM(args) TEB_LOG_STREAM(::teb_local_planner::Logger::Info, args)
+#define TEB_WARN_STREAM(args) TEB_LOG_STREAM(::teb_local_planner::Logger::Warn, args)
+#define TEB_ERROR_STREAM(args) TEB_LOG_STREAM(::teb_local_planner::Logger::Error, args)
+
+#define TEB_INFO_ONCE(...) TEB_LOG_ONCE(::teb_local_planner::Logger::Info, __VA_ARGS__)
+#define TEB_WARN_ONCE(...) TEB_LOG_ONCE(::teb_local_planner::Logger::Warn, __VA_ARGS__)
+
+// Assertions are only active in debug builds (similar to ROS_ASSERT)
+#ifndef NDEBUG
+  #define TEB_ASSERT(cond) \
+    do { \
+      if (!(cond)) \
+        ::teb_local_planner::logging::assertionFailed(#cond, __FILE__, __LINE__, ""); \
+    } while(0)
+  
+  #define TEB_ASSERT_MSG(cond, ...) \
+    do { \
+      if (!(cond)) \
+      { \
+        char teb_assert_msg[512]; \
+        std::snprintf(teb_assert_msg, sizeof(teb_assert_msg), __VA_ARGS__); \
+        ::teb_local_planner::logging::assertionFailed(#cond, __FILE__, __LINE__, teb_assert_msg); \
+      } \
+    } while(0)
+#else
+  #define TEB_ASSERT(cond) do {} while(0)
+  #define TEB_ASSERT_MSG(cond, ...) do {} while(0)
+#endif
+
+#endif /* TEB_LOGGING_H_ */
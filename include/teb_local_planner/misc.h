@@ -49,6 +49,15 @@ namespace teb_local_planner
 
 #define SMALL_NUM 0.00000001
 
+//! Mark deprecated functions (replaces ROS_DEPRECATED in order to keep the planning core independent of ROS)
+#if defined(__GNUC__)
+  #define TEB_DEPRECATED __attribute__((deprecated))
+#elif defined(_MSC_VER)
+  #define TEB_DEPRECATED __declspec(deprecated)
+#else
+  #define TEB_DEPRECATED
+#endif
+
 //! Symbols for left/none/right rotations      
 enum class RotType { left, none, right };
 
@@ -0,0 +1,240 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef OBSTACLE_CORRIDOR_H_
+#define OBSTACLE_CORRIDOR_H_
+
+#include <teb_local_planner/pose_se2.h>
+#include <teb_local_planner/teb_config.h>
+#include <teb_local_planner/obstacles.h>
+#include <teb_local_planner/timed_elastic_band.h>
+#include <teb_local_planner/optimal_planner.h>
+#include <teb_local_planner/planner_interface.h>
+#include <teb_local_planner/robot_footprint_model.h>
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @class ObstacleCorridorFilter
+ * @brief Discards obstacles that are too far from the current trajectories to be taken into account by the optimization
+ * 
+ * Every obstacle of the container is offered to the obstacle association (TebOptimalPlanner::AddEdgesObstacles()),
+ * the graph builders of the HomotopyClassPlanner and the H-signature computation, although only obstacles closer than
+ * obstacle_association_cutoff_factor * min_obstacle_dist to the robot footprint are associated with any pose.
+ * The filter builds a corridor around the transformed global plan, the via-points and the trajectories of the previous
+ * cycle (all candidate trajectories of the HomotopyClassPlanner). The corridor is the union of the line segments
+ * between consecutive poses, inflated by the margin
+ * \f$ r_{circumscribed} + cutoff\_factor \cdot min\_obstacle\_dist + slack \f$.
+ * The slack accounts for the deformation of the trajectories during the optimization of the current cycle.
+ * Since consecutive poses are almost collinear, the paths are simplified with a tolerance of 5% of the margin
+ * and the margin is enlarged by the tolerance accordingly.
+ * Static obstacles outside the corridor are removed from the container, dynamic obstacles are always kept,
+ * since their predicted motion might enter the corridor.
+ * 
+ * The segments are stored in a dense uniform grid around the corridor (cell size is half of the margin).
+ * Each cell lists the segments that might be closer than the margin to any point of the cell, and cells that are
+ * completely covered by the corridor are marked. An obstacle whose anchor point (e.g. the position of a point obstacle)
+ * is located in a covered cell is accepted immediately, otherwise it is only compared with the segments of the cells
+ * overlapped by its bounding box (and with the border of the covered cells among them).
+ * As in the obstacle association, the distance of polygons refers to their boundary.
+ * 
+ * Usage (once per control cycle, before the planner and the replanning monitor access the obstacles):
+ * @code
+ *   filter.clear();
+ *   filter.addPath(initial_plan);
+ *   filter.addPlanner(*planner); // trajectories of the previous cycle
+ *   filter.filter(obstacles);
+ * @endcode
+ * 
+ * The class does not depend on ROS, hence it is shared between TebLocalPlannerROS
+ * and headless tools such as the closed-loop simulation.
+ */
+class ObstacleCorridorFilter
+{
+public:
+  
+  /**
+   * @brief Default constructor
+   */
+  ObstacleCorridorFilter();
+  
+  /**
+   * @brief Initialize the filter
+   * @param cfg const reference to the TebConfig class for parameters
+   * @param robot_model footprint model of the robot (the circumscribed radius enlarges the corridor)
+   */
+  void initialize(const TebConfig& cfg, RobotFootprintModelPtr robot_model);
+  
+  /**
+   * @brief Remove all paths from the corridor
+   */
+  void clear();
+  
+  /**
+   * @brief Add a path (e.g. the transformed global plan) to the corridor
+   * @param path sequence of poses, consecutive poses are connected by line segments
+   */
+  void addPath(const PoseSE2Container& path);
+  
+  /**
+   * @brief Add a trajectory to the corridor
+   * @param teb trajectory
+   */
+  void addTrajectory(const TimedElasticBand& teb);
+  
+  /**
+   * @brief Add all trajectories of a planner to the corridor
+   * 
+   * Supports the TebOptimalPlanner and all candidate trajectories of the HomotopyClassPlanner.
+   * Other planners are ignored.
+   * @param planner planner that stores the trajectories of the previous cycle
+   */
+  void addPlanner(const PlannerInterface& planner);
+  
+  /**
+   * @brief Add via-points to the corridor (the trajectory might be attracted towards via-points off the global plan)
+   * @param via_points via-point container
+   */
+  void addViaPoints(const ViaPointContainer& via_points);
+  
+  /**
+   * @brief Remove all static obstacles that are outside of the corridor
+   * 
+   * The container is not modified if the corridor is empty (e.g. no plan has been added)
+   * or if the circumscribed radius of the robot footprint model is unknown.
+   * @param[in,out] obstacles obstacle container
+   * @return number of removed obstacles
+   */
+  std::size_t filter(ObstContainer& obstacles);
+  
+  /**
+   * @brief Check whether an obstacle is inside of the corridor
+   * @remarks Only valid after filter() has been called for the current set of paths
+   * @param obstacle obstacle to be checked
+   * @return \c true if the distance to any segment of the corridor is below the (enlarged) margin
+   */
+  bool isInside(const Obstacle& obstacle) const;
+  
+  /**
+   * @brief Compute the margin by which the paths are inflated
+   * @return margin, or a negative value if the circumscribed radius of the footprint model is unknown
+   *         (BaseRobotFootprintModel::getCircumscribedRadius()), in which case filter() keeps all obstacles
+   */
+  double computeMargin() const;
+  
+  /**
+   * @brief Return the number of segments of the corridor
+   * @remarks Only valid after filter() has been called for the current set of paths
+   */
+  std::size_t getNoSegments() const {return segments_.size();}
+  
+protected:
+  
+  //! Line segment of the corridor
+  struct Segment
+  {
+    Eigen::Vector2d start;
+    Eigen::Vector2d end;
+    Eigen::Vector2d box_min; //!< Lower corner of the bounding box
+    Eigen::Vector2d box_max; //!< Upper corner of the bounding box
+    
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+  typedef std::vector<Segment, Eigen::aligned_allocator<Segment> > SegmentContainer;
+  
+  /**
+   * @brief Add a single line segment to segments_
+   */
+  void addSegment(const Eigen::Vector2d& start, const Eigen::Vector2d& end);
+  
+  /**
+   * @brief Approximate all paths by line segments
+   * @param tolerance maximum distance of the paths from their approximation
+   */
+  void createSegments(double tolerance);
+  
+  /**
+   * @brief Insert all segments into the grid and mark the cells that are covered by the corridor
+   */
+  void buildIndex();
+  
+  /**
+   * @brief Compute the bounding box and a point on the boundary (or inside) of an obstacle
+   * @return \c false if the obstacle type is unknown (the obstacle is kept in that case)
+   */
+  static bool computeBoundingBox(const Obstacle& obstacle, Eigen::Vector2d& box_min, Eigen::Vector2d& box_max, Eigen::Vector2d& anchor);
+  
+  //! Column of the cell that contains the x-coordinate (might be outside of the grid)
+  int cellX(double x) const {return (int)std::floor((x - grid_origin_.x()) / cell_size_);}
+  //! Row of the cell that contains the y-coordinate (might be outside of the grid)
+  int cellY(double y) const {return (int)std::floor((y - grid_origin_.y()) / cell_size_);}
+  
+  const TebConfig* cfg_; //!< Config class that stores and manages all related parameters
+  RobotFootprintModelPtr robot_model_; //!< Footprint model of the robot
+  
+  Point2dContainer points_; //!< Positions of all paths that span the corridor
+  std::vector<int> polyline_starts_; //!< Index of the first position of each path in points_
+  SegmentContainer segments_; //!< Simplified segments of all paths
+  double margin_; //!< Margin of the current index
+  
+  Eigen::Vector2d grid_origin_; //!< Lower corner of the grid
+  double cell_size_; //!< Edge length of the cells
+  int grid_width_; //!< Number of columns
+  int grid_height_; //!< Number of rows
+  std::vector<int> cell_offsets_; //!< Start of the segment list of each cell in cell_segments_ (size: number of cells + 1)
+  std::vector<int> cell_segments_; //!< Concatenated segment lists of all cells
+  std::vector<char> cell_covered_; //!< Non-zero if every point of the cell is inside of the corridor
+  std::vector<std::pair<int, int> > entries_; //!< Pairs of cell and segment (workspace of buildIndex())
+  mutable Point2dContainer cell_square_; //!< Border of a cell (workspace of isInside())
+  mutable std::vector<unsigned int> visited_; //!< Stamp of the last query that tested a segment (avoids duplicate tests)
+  mutable unsigned int query_stamp_; //!< Stamp of the current query
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+} // namespace teb_local_planner
+
+#endif /* OBSTACLE_CORRIDOR_H_ */
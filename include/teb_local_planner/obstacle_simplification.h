@@ -0,0 +1,110 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef OBSTACLE_SIMPLIFICATION_H_
+#define OBSTACLE_SIMPLIFICATION_H_
+
+#include <teb_local_planner/obstacles.h>
+#include <teb_local_planner/distance_calculations.h>
+
+#include <cstddef>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @brief Simplify a closed polygon with a bounded error such that the result contains the original polygon
+ * 
+ * Noisy contours (e.g. from the costmap_converter) carry many nearly collinear vertices, each of which
+ * adds an edge to every distance and H-signature evaluation. The polygon is simplified greedily in the
+ * spirit of Visvalingam-Whyatt (the operation with the smallest error first), but only operations that
+ * enlarge the polygon are admitted:
+ * - a reflex (or collinear) vertex is removed, which adds the triangle spanned by the vertex and its neighbors;
+ * - an edge between two convex vertices is collapsed into the intersection of the lines of its adjacent edges,
+ *   which adds the triangle between the edge and the intersection point.
+ * 
+ * Hence the simplified polygon is an outer hull of the original polygon. Each edge carries an upper bound
+ * on the distance of its points to the original boundary; operations that would exceed \c tolerance or that
+ * would make the polygon self-intersecting are rejected.
+ * @param vertices vertices of a simple closed polygon (the first vertex is not repeated at the end)
+ * @param tolerance maximum distance between the simplified and the original boundary [m]
+ * @param[out] simplified the simplified polygon (a copy of \c vertices if nothing can be removed)
+ * @return upper bound on the distance between the simplified and the original boundary [m]
+ */
+double simplifyPolygonConservative(const Point2dContainer& vertices, double tolerance, Point2dContainer& simplified);
+
+/**
+ * @brief Simplify the vertices of a polygon obstacle in place (see simplifyPolygonConservative())
+ * 
+ * The obstacle (including its velocity) is preserved and finalized again if vertices are removed.
+ * @param[in,out] obstacle polygon obstacle to be simplified
+ * @param tolerance maximum distance between the simplified and the original boundary [m]
+ * @return number of removed vertices
+ */
+std::size_t simplifyPolygonObstacle(PolygonObstacle& obstacle, double tolerance);
+
+/**
+ * @brief Merge nearly coincident static point obstacles
+ * 
+ * Point obstacles are clustered greedily: a point joins the first cluster whose seed is closer than \c merge_dist.
+ * Each cluster with more than one member is replaced by a CircularObstacle that encloses all members
+ * (the radius is at most \c merge_dist), hence the obstacle region is never reduced.
+ * Dynamic point obstacles and all other obstacle types are kept unchanged.
+ * @param[in,out] obstacles obstacle container
+ * @param merge_dist maximum distance between a point and the seed of its cluster [m]
+ * @return number of removed obstacles
+ */
+std::size_t mergePointObstacles(ObstContainer& obstacles, double merge_dist);
+
+/**
+ * @brief Simplify all obstacles of a container (ingestion stage for external obstacles)
+ * 
+ * Polygon obstacles are simplified with simplifyPolygonObstacle() and point obstacles are merged with mergePointObstacles().
+ * @param[in,out] obstacles obstacle container
+ * @param polygon_tolerance tolerance of the polygon simplification [m] (disabled if <= 0)
+ * @param point_merge_dist merge distance of point obstacles [m] (disabled if <= 0)
+ * @param[out] removed_vertices [optional] number of removed polygon vertices
+ * @param[out] removed_points [optional] number of removed point obstacles
+ */
+void simplifyObstacles(ObstContainer& obstacles, double polygon_tolerance, double point_merge_dist,
+                       std::size_t* removed_vertices = NULL, std::size_t* removed_points = NULL);
+
+} // namespace teb_local_planner
+
+#endif /* OBSTACLE_SIMPLIFICATION_H_ */
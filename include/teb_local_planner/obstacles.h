@@ -49,11 +49,6 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/pointer_cast.hpp>
 
-#include <geometry_msgs/Polygon.h>
-#include <geometry_msgs/TwistWithCovariance.h>
-#include <geometry_msgs/QuaternionStamped.h>
-
-#include <tf/tf.h>
 #include <teb_local_planner/distance_calculations.h>
 
 
@@ -205,39 +200,6 @@ public:
     */
   void setCentroidVelocity(const Eigen::Ref<const Eigen::Vector2d>& vel) {centroid_velocity_ = vel; dynamic_=true;} 
 
-  /**
-    * @brief Set the 2d velocity (vx, vy) of the obstacle w.r.t to the centroid
-    * @remarks Setting the velocity using this function marks the obstacle as dynamic (@see isDynamic)
-    * @param velocity geometry_msgs::TwistWithCovariance containing the velocity of the obstacle
-    * @param orientation geometry_msgs::QuaternionStamped containing the orientation of the obstacle
-    */
-  void setCentroidVelocity(const geometry_msgs::TwistWithCovariance& velocity,
-                           const geometry_msgs::Quaternion& orientation)
-  {
-    // Set velocity, if obstacle is moving
-    Eigen::Vector2d vel;
-    vel.coeffRef(0) = velocity.twist.linear.x;
-    vel.coeffRef(1) = velocity.twist.linear.y;
-
-    // If norm of velocity is less than 0.001, consider obstacle as not dynamic
-    // TODO: Get rid of constant
-    if (vel.norm() < 0.001)
-      return;
-
-    // currently velocity published by stage is already given in the map frame
-//    double yaw = tf::getYaw(orientation.quaternion);
-//    ROS_INFO("Yaw: %f", yaw);
-//    Eigen::Rotation2Dd rot(yaw);
-//    vel = rot * vel;
-    setCentroidVelocity(vel);
-  }
-
-  void setCentroidVelocity(const geometry_msgs::TwistWithCovariance& velocity,
-                           const geometry_msgs::QuaternionStamped& orientation)
-  {
-    setCentroidVelocity(velocity, orientation.quaternion);
-  }
-
   /**
     * @brief Get the obstacle velocity (vx, vy) (w.r.t. to the centroid)
     * @returns 2D vector containing the velocities of the centroid in x and y directions
@@ -252,30 +214,14 @@ public:
   //@{ 
   
   /**
-   * @brief Convert the obstacle to a polygon message
+   * @brief Convert the obstacle to a polygon
    * 
-   * Convert the obstacle to a corresponding polygon msg.
+   * Convert the obstacle to a corresponding polygon (e.g. for visualization or the export to messages).
    * Point obstacles have one vertex, lines have two vertices 
    * and polygons might are implictly closed such that the start vertex must not be repeated.
-   * @param[out] polygon the polygon message
+   * @param[out] polygon container of polygon vertices (the container is cleared before)
    */
-  virtual void toPolygonMsg(geometry_msgs::Polygon& polygon) = 0;
-
-  virtual void toTwistWithCovarianceMsg(geometry_msgs::TwistWithCovariance& twistWithCovariance)
-  {
-    if (dynamic_)
-    {
-      twistWithCovariance.twist.linear.x = centroid_velocity_(0);
-      twistWithCovariance.twist.linear.y = centroid_velocity_(1);
-    }
-    else
-    {
-      twistWithCovariance.twist.linear.x = 0;
-      twistWithCovariance.twist.linear.y = 0;
-    }
-
-    // TODO:Covariance
-  }
+  virtual void toPolygon(Point2dContainer& polygon) const = 0;
 
   //@}
 	
@@ -422,13 +368,10 @@ public:
   double& y() {return pos_.coeffRef(1);} //!< Return the current x-coordinate of the obstacle
   const double& y() const {return pos_.coeffRef(1);} //!< Return the current y-coordinate of the obstacle (read-only)
       
-  // implements toPolygonMsg() of the base class
-  virtual void toPolygonMsg(geometry_msgs::Polygon& polygon)
+  // implements toPolygon() of the base class
+  virtual void toPolygon(Point2dContainer& polygon) const
   {
-    polygon.points.resize(1);
-    polygon.points.front().x = pos_.x();
-    polygon.points.front().y = pos_.y();
-    polygon.points.front().z = 0;
+    polygon.assign(1, pos_);
   }
       
 protected:
@@ -568,15 +511,12 @@ public:
   double& radius() {return radius_;} //!< Return the current radius of the obstacle
   const double& radius() const {return radius_;} //!< Return the current radius of the obstacle
 
-  // implements toPolygonMsg() of the base class
-  virtual void toPolygonMsg(geometry_msgs::Polygon& polygon)
+  // implements toPolygon() of the base class
+  virtual void toPolygon(Point2dContainer& polygon) const
   {
     // TODO(roesmann): the polygon message type cannot describe a "perfect" circle
     //                 We could switch to ObstacleMsg if required somewhere...
-    polygon.points.resize(1);
-    polygon.points.front().x = pos_.x();
-    polygon.points.front().y = pos_.y();
-    polygon.points.front().z = 0;
+    polygon.assign(1, pos_);
   }
 
 protected:
@@ -608,6 +548,7 @@ public:
     start_.setZero();
     end_.setZero();
     centroid_.setZero();
+    bounding_radius_ = 0;
   }
   
   /**
@@ -618,7 +559,7 @@ public:
   LineObstacle(const Eigen::Ref< const Eigen::Vector2d>& line_start, const Eigen::Ref< const Eigen::Vector2d>& line_end) 
                 : Obstacle(), start_(line_start), end_(line_end)
   {
-    calcCentroid();
+    calcGeometry();
   }
   
   /**
@@ -634,12 +575,14 @@ public:
     start_.y() = y1;
     end_.x() = x2;
     end_.y() = y2;
-    calcCentroid();
+    calcGeometry();
   }
 
   // implements checkCollision() of the base class
   virtual bool checkCollision(const Eigen::Vector2d& point, double min_dist) const    
   {
+    if ((point - centroid_).norm() - bounding_radius_ > min_dist)
+      return false;
     return getMinimumDistance(point) <= min_dist;
   }
   
@@ -652,46 +595,46 @@ public:
   // implements getMinimumDistance() of the base class
   virtual double getMinimumDistance(const Eigen::Vector2d& position) const 
   {
-    return distance_point_to_segment_2d(position, start_, end_);
+    return distance_point_to_segment_2d(position, segment_);
   }
   
   // implements getMinimumDistance() of the base class
   virtual double getMinimumDistance(const Eigen::Vector2d& line_start, const Eigen::Vector2d& line_end) const
   {
-    return distance_segment_to_segment_2d(start_, end_, line_start, line_end);
+    return distance_segment_to_segment_2d(line_start, line_end, segment_);
   }
   
   // implements getMinimumDistance() of the base class
   virtual double getMinimumDistance(const Point2dContainer& polygon) const
   {
-    return distance_segment_to_polygon_2d(start_, end_, polygon);
+    return distance_polygon_to_segment_2d(polygon, segment_);
   }
 
   // implements getMinimumDistanceVec() of the base class
   virtual Eigen::Vector2d getClosestPoint(const Eigen::Vector2d& position) const
   {
-    return closest_point_on_line_segment_2d(position, start_, end_);
+    return closest_point_on_line_segment_2d(position, segment_);
   }
 
   // implements getMinimumSpatioTemporalDistance() of the base class
   virtual double getMinimumSpatioTemporalDistance(const Eigen::Vector2d& position, double t) const
   {
+    // translate the query instead of the obstacle in order to reuse the precomputed segment
     Eigen::Vector2d offset = t*centroid_velocity_;
-    return distance_point_to_segment_2d(position, start_ + offset, end_ + offset);
+    return distance_point_to_segment_2d(position - offset, segment_);
   }
 
   // implements getMinimumSpatioTemporalDistance() of the base class
   virtual double getMinimumSpatioTemporalDistance(const Eigen::Vector2d& line_start, const Eigen::Vector2d& line_end, double t) const
   {
     Eigen::Vector2d offset = t*centroid_velocity_;
-    return distance_segment_to_segment_2d(start_ + offset, end_ + offset, line_start, line_end);
+    return distance_segment_to_segment_2d(line_start - offset, line_end - offset, segment_);
   }
 
   // implements getMinimumSpatioTemporalDistance() of the base class
   virtual double getMinimumSpatioTemporalDistance(const Point2dContainer& polygon, double t) const
   {
-    Eigen::Vector2d offset = t*centroid_velocity_;
-    return distance_segment_to_polygon_2d(start_ + offset, end_ + offset, polygon);
+    return distance_polygon_to_segment_2d(polygon, segment_, -t*centroid_velocity_);
   }
 
   // implements getCentroid() of the base class
@@ -708,30 +651,38 @@ public:
   
   // Access or modify line
   const Eigen::Vector2d& start() const {return start_;}
-  void setStart(const Eigen::Ref<const Eigen::Vector2d>& start) {start_ = start; calcCentroid();}
+  void setStart(const Eigen::Ref<const Eigen::Vector2d>& start) {start_ = start; calcGeometry();}
   const Eigen::Vector2d& end() const {return end_;}
-  void setEnd(const Eigen::Ref<const Eigen::Vector2d>& end) {end_ = end; calcCentroid();}
+  void setEnd(const Eigen::Ref<const Eigen::Vector2d>& end) {end_ = end; calcGeometry();}
+  const PrecomputedSegment2d& segment() const {return segment_;} //!< Access the line with its precomputed invariants
+  double boundingRadius() const {return bounding_radius_;} //!< Radius of the bounding circle around the centroid
   
-  // implements toPolygonMsg() of the base class
-  virtual void toPolygonMsg(geometry_msgs::Polygon& polygon)
+  // implements toPolygon() of the base class
+  virtual void toPolygon(Point2dContainer& polygon) const
   {
-    polygon.points.resize(2);
-    polygon.points.front().x = start_.x();
-    polygon.points.front().y = start_.y();
-    
-    polygon.points.back().x = end_.x();
-    polygon.points.back().y = end_.y();
-    polygon.points.back().z = polygon.points.front().z = 0;
+    polygon.resize(2);
+    polygon.front() = start_;
+    polygon.back() = end_;
   }
   
 protected:
   void calcCentroid()	{	centroid_ = 0.5*(start_ + end_); }
   
+  //! Compute the centroid and the precomputed segment (called whenever the line is modified)
+  void calcGeometry()
+  {
+    calcCentroid();
+    segment_.set(start_, end_);
+    bounding_radius_ = 0.5*(end_ - start_).norm();
+  }
+  
 private:
 	Eigen::Vector2d start_;
 	Eigen::Vector2d end_;
 	
   Eigen::Vector2d centroid_;
+  PrecomputedSegment2d segment_; //!< Line with precomputed direction, inverse squared length and normal
+  double bounding_radius_; //!< Radius of the bounding circle around the centroid
 
 public:	
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW  
@@ -752,9 +703,10 @@ public:
   /**
     * @brief Default constructor of the polygon obstacle class
     */
-  PolygonObstacle() : Obstacle(), finalized_(false)
+  PolygonObstacle() : Obstacle(), bounding_radius_(0), finalized_(false)
   {
     centroid_.setConstant(NAN);
+    bounding_center_.setConstant(NAN);
   }
   
   /**
@@ -780,6 +732,10 @@ public:
   // implements checkCollision() of the base class
   virtual bool checkCollision(const Eigen::Vector2d& point, double min_dist) const
   {
+      // the polygon is contained in its bounding circle
+      if (finalized_ && (point - bounding_center_).norm() - bounding_radius_ > min_dist)
+        return false;
+    
       // line case
       if (noVertices()==2)
         return getMinimumDistance(point) <= min_dist;
@@ -817,19 +773,25 @@ public:
   // implements getMinimumDistance() of the base class
   virtual double getMinimumDistance(const Eigen::Vector2d& position) const
   {
-    return distance_point_to_polygon_2d(position, vertices_);
+    if (!finalized_) // the precomputed edges are not valid, fall back to the vertices
+      return distance_point_to_polygon_2d(position, vertices_);
+    return distance_point_to_polygon_2d(position, edges_);
   }
   
   // implements getMinimumDistance() of the base class
   virtual double getMinimumDistance(const Eigen::Vector2d& line_start, const Eigen::Vector2d& line_end) const
   {
-    return distance_segment_to_polygon_2d(line_start, line_end, vertices_);
+    if (!finalized_)
+      return distance_segment_to_polygon_2d(line_start, line_end, vertices_);
+    return distance_segment_to_polygon_2d(line_start, line_end, edges_);
   }
 
   // implements getMinimumDistance() of the base class
   virtual double getMinimumDistance(const Point2dContainer& polygon) const
   {
-    return distance_polygon_to_polygon_2d(polygon, vertices_);
+    if (!finalized_)
+      return distance_polygon_to_polygon_2d(polygon, vertices_);
+    return distance_polygon_to_polygon_2d(polygon, edges_);
   }
   
   // implements getMinimumDistanceVec() of the base class
@@ -838,25 +800,28 @@ public:
   // implements getMinimumSpatioTemporalDistance() of the base class
   virtual double getMinimumSpatioTemporalDistance(const Eigen::Vector2d& position, double t) const
   {
-    Point2dContainer pred_vertices;
-    predictVertices(t, pred_vertices);
-    return distance_point_to_polygon_2d(position, pred_vertices);
+    // translate the query instead of predicting the vertices in order to reuse the precomputed edges
+    Eigen::Vector2d offset = t*centroid_velocity_;
+    return getMinimumDistance(Eigen::Vector2d(position - offset));
   }
 
   // implements getMinimumSpatioTemporalDistance() of the base class
   virtual double getMinimumSpatioTemporalDistance(const Eigen::Vector2d& line_start, const Eigen::Vector2d& line_end, double t) const
   {
-    Point2dContainer pred_vertices;
-    predictVertices(t, pred_vertices);
-    return distance_segment_to_polygon_2d(line_start, line_end, pred_vertices);
+    Eigen::Vector2d offset = t*centroid_velocity_;
+    return getMinimumDistance(Eigen::Vector2d(line_start - offset), Eigen::Vector2d(line_end - offset));
   }
 
   // implements getMinimumSpatioTemporalDistance() of the base class
   virtual double getMinimumSpatioTemporalDistance(const Point2dContainer& polygon, double t) const
   {
-    Point2dContainer pred_vertices;
-    predictVertices(t, pred_vertices);
-    return distance_polygon_to_polygon_2d(polygon, pred_vertices);
+    if (!finalized_)
+    {
+      Point2dContainer pred_vertices;
+      predictVertices(t, pred_vertices);
+      return distance_polygon_to_polygon_2d(polygon, pred_vertices);
+    }
+    return distance_polygon_to_polygon_2d(polygon, edges_, -t*centroid_velocity_);
   }
 
   virtual void predictVertices(double t, Point2dContainer& pred_vertices) const
@@ -884,8 +849,11 @@ public:
     return std::complex<double>(centroid_.coeffRef(0), centroid_.coeffRef(1));
   }
   
-  // implements toPolygonMsg() of the base class
-  virtual void toPolygonMsg(geometry_msgs::Polygon& polygon);
+  // implements toPolygon() of the base class
+  virtual void toPolygon(Point2dContainer& polygon) const
+  {
+    polygon = vertices_;
+  }
 
   
   /** @name Define the polygon */
@@ -893,7 +861,26 @@ public:
   
   // Access or modify polygon
   const Point2dContainer& vertices() const {return vertices_;} //!< Access vertices container (read-only)
-  Point2dContainer& vertices() {return vertices_;} //!< Access vertices container
+  const PrecomputedSegmentContainer& edges() const {return edges_;} //!< Access the precomputed edges (including the closing edge, valid after finalizePolygon())
+  bool isFinalized() const {return finalized_;} //!< \c false if the vertices have been modified after finalizePolygon() (the distances are computed from the vertices until then)
+  const Eigen::Vector2d& boundingCenter() const {return bounding_center_;} //!< Center of the bounding circle (valid after finalizePolygon())
+  double boundingRadius() const {return bounding_radius_;} //!< Radius of the bounding circle (valid after finalizePolygon())
+  
+  /**
+    * @brief Access the vertices container for modification
+    * @warning Invalidates the precomputed edges, centroid and bounding circle.
+    *          The distances are computed from the vertices until finalizePolygon() is called again.
+    * @return mutable reference to the vertices container
+    */
+  Point2dContainer& modifyVertices() {finalized_ = false; return vertices_;}
+  
+  /**
+    * @brief Replace all vertices of the polygon
+    * @warning Invalidates the precomputed edges, centroid and bounding circle.
+    *          The distances are computed from the vertices until finalizePolygon() is called again.
+    * @param vertices new vertices (do not repeat the first vertex)
+    */
+  void setVertices(const Point2dContainer& vertices) {vertices_ = vertices; finalized_ = false;}
   
   /**
     * @brief Add a vertex to the polygon (edge-point)
@@ -922,11 +909,15 @@ public:
   
   /**
     * @brief Call finalizePolygon after the polygon is created with the help of pushBackVertex() methods
+    * 
+    * Besides the centroid, the edges with their directions, inverse squared lengths and outward normals
+    * as well as a bounding circle are precomputed for the distance calculations.
     */
   void finalizePolygon()
   {
     fixPolygonClosure();
     calcCentroid();
+    calcEdgeGeometry();
     finalized_ = true;
   }
   
@@ -948,10 +939,15 @@ protected:
   void fixPolygonClosure(); //!< Check if the current polygon contains the first vertex twice (as start and end) and in that case erase the last redundant one.
 
   void calcCentroid(); //!< Compute the centroid of the polygon (called inside finalizePolygon())
+  
+  void calcEdgeGeometry(); //!< Compute the precomputed edges and the bounding circle of the polygon (called inside finalizePolygon())
 
   
   Point2dContainer vertices_; //!< Store vertices defining the polygon (@see pushBackVertex)
   Eigen::Vector2d centroid_; //!< Store the centroid coordinates of the polygon (@see calcCentroid)
+  PrecomputedSegmentContainer edges_; //!< Store the edges of the polygon with precomputed invariants (@see calcEdgeGeometry)
+  Eigen::Vector2d bounding_center_; //!< Center of a circle that contains the polygon (@see calcEdgeGeometry)
+  double bounding_radius_; //!< Radius of a circle that contains the polygon (@see calcEdgeGeometry)
   
   bool finalized_; //!< Flat that keeps track if the polygon was finalized after adding all vertices
   
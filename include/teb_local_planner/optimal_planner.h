@@ -41,14 +41,16 @@
 
 #include <math.h>
 
+#include <boost/make_shared.hpp>
+
 
 // teb stuff
 #include <teb_local_planner/teb_config.h>
 #include <teb_local_planner/misc.h>
 #include <teb_local_planner/timed_elastic_band.h>
 #include <teb_local_planner/planner_interface.h>
-#include <teb_local_planner/visualization.h>
 #include <teb_local_planner/robot_footprint_model.h>
+#include <teb_local_planner/allocation_tracker.h>
 
 // g2o lib stuff
 #include "g2o/core/sparse_optimizer.h"
@@ -69,14 +71,10 @@
 #include <teb_local_planner/g2o_types/edge_dynamic_obstacle.h>
 #include <teb_local_planner/g2o_types/edge_via_point.h>
 #include <teb_local_planner/g2o_types/edge_prefer_rotdir.h>
+#include <teb_local_planner/g2o_types/edge_consecutive_poses.h>
+#include <teb_local_planner/g2o_types/edge_chain_batch.h>
+#include <teb_local_planner/g2o_types/linear_solver_symbolic_cache.h>
 
-// messages
-#include <nav_msgs/Path.h>
-#include <geometry_msgs/PoseStamped.h>
-#include <tf/transform_datatypes.h>
-#include <teb_local_planner/TrajectoryMsg.h>
-
-#include <nav_msgs/Odometry.h>
 #include <limits.h>
 
 namespace teb_local_planner
@@ -85,9 +83,9 @@ namespace teb_local_planner
 //! Typedef for the block solver utilized for optimization
 typedef g2o::BlockSolver< g2o::BlockSolverTraits<-1, -1> >  TEBBlockSolver;
 
-//! Typedef for the linear solver utilized for optimization
-typedef g2o::LinearSolverCSparse<TEBBlockSolver::PoseMatrixType> TEBLinearSolver;
-//typedef g2o::LinearSolverCholmod<TEBBlockSolver::PoseMatrixType> TEBLinearSolver;
+//! Typedef for the linear solver utilized for optimization (see LinearSolverSymbolicCache)
+typedef LinearSolverSymbolicCache<g2o::LinearSolverCSparse<TEBBlockSolver::PoseMatrixType>, TEBBlockSolver::PoseMatrixType> TEBLinearSolver;
+//typedef LinearSolverSymbolicCache<g2o::LinearSolverCholmod<TEBBlockSolver::PoseMatrixType>, TEBBlockSolver::PoseMatrixType> TEBLinearSolver;
 
 //! Typedef for a container storing via-points
 typedef std::vector< Eigen::Vector2d, Eigen::aligned_allocator<Eigen::Vector2d> > ViaPointContainer;
@@ -122,11 +120,10 @@ public:
    * @param cfg Const reference to the TebConfig class for internal parameters
    * @param obstacles Container storing all relevant obstacles (see Obstacle)
    * @param robot_model Shared pointer to the robot shape model used for optimization (optional)
-   * @param visual Shared pointer to the TebVisualization class (optional)
    * @param via_points Container storing via-points (optional)
    */
   TebOptimalPlanner(const TebConfig& cfg, ObstContainer* obstacles = NULL, RobotFootprintModelPtr robot_model = boost::make_shared<PointRobotFootprint>(),
-                    TebVisualizationPtr visual = TebVisualizationPtr(), const ViaPointContainer* via_points = NULL);
+                    const ViaPointContainer* via_points = NULL);
   
   /**
    * @brief Destruct the optimal planner.
@@ -138,11 +135,10 @@ public:
     * @param cfg Const reference to the TebConfig class for internal parameters
     * @param obstacles Container storing all relevant obstacles (see Obstacle)
     * @param robot_model Shared pointer to the robot shape model used for optimization (optional)
-    * @param visual Shared pointer to the TebVisualization class (optional)
     * @param via_points Container storing via-points (optional)
     */
   void initialize(const TebConfig& cfg, ObstContainer* obstacles = NULL, RobotFootprintModelPtr robot_model = boost::make_shared<PointRobotFootprint>(),
-                  TebVisualizationPtr visual = TebVisualizationPtr(), const ViaPointContainer* via_points = NULL);
+                  const ViaPointContainer* via_points = NULL);
   
   
 
@@ -160,49 +156,45 @@ public:
    * 	- If a previous solution is avaiable, update the trajectory based on the initial plan,
    * 	  see bool TimedElasticBand::updateAndPruneTEB
    * 	- Afterwards optimize the recently initialized or updated trajectory by calling optimizeTEB() and invoking g2o
-   * @param initial_plan vector of geometry_msgs::PoseStamped
-   * @param start_vel Current start velocity (e.g. the velocity of the robot, only linear.x, linear.y (holonomic) and angular.z are used)
+   * @param initial_plan container of poses (start and goal included)
+   * @param start_vel Current start velocity (e.g. the velocity of the robot, only vx, vy (holonomic) and omega are used)
    * @param free_goal_vel if \c true, a nonzero final velocity at the goal pose is allowed,
    *		      otherwise the final velocity will be zero (default: false)
    * @return \c true if planning was successful, \c false otherwise
    */
-  virtual bool plan(const std::vector<geometry_msgs::PoseStamped>& initial_plan, const geometry_msgs::Twist* start_vel = NULL, bool free_goal_vel=false);
+  virtual bool plan(const PoseSE2Container& initial_plan, const Twist2D* start_vel = NULL, bool free_goal_vel=false);
   
   /**
-   * @brief Plan a trajectory between a given start and goal pose (tf::Pose version)
+   * @brief Plan a trajectory between a given start and goal pose
    * 
    * Call this method to create and optimize a trajectory that is initialized between a given start and goal pose. \n
    * The method supports hot-starting from previous solutions, if avaiable: \n
-   * 	- If no trajectory exist yet, a new trajectory is initialized between start and goal poses,
-   *	  see TimedElasticBand::initTEBtoGoal
+   * 	- If no trajectory exist yet, a new trajectory is initialized between start and goal poses
+   *	  @see TimedElasticBand::initTEBtoGoal
    * 	- If a previous solution is avaiable, update the trajectory @see bool TimedElasticBand::updateAndPruneTEB
    * 	- Afterwards optimize the recently initialized or updated trajectory by calling optimizeTEB() and invoking g2o
-   * @param start tf::Pose containing the start pose of the trajectory
-   * @param goal tf::Pose containing the goal pose of the trajectory
-   * @param start_vel Current start velocity (e.g. the velocity of the robot, only linear.x, linear.y (holonomic) and angular.z are used)
+   * @param start PoseSE2 containing the start pose of the trajectory
+   * @param goal PoseSE2 containing the goal pose of the trajectory
+   * @param start_vel Initial velocity at the start pose (containing the translational and angular velocity).
    * @param free_goal_vel if \c true, a nonzero final velocity at the goal pose is allowed,
    *		      otherwise the final velocity will be zero (default: false)
    * @return \c true if planning was successful, \c false otherwise
    */
-  virtual bool plan(const tf::Pose& start, const tf::Pose& goal, const geometry_msgs::Twist* start_vel = NULL, bool free_goal_vel=false);
+  virtual bool plan(const PoseSE2& start, const PoseSE2& goal, const Twist2D* start_vel = NULL, bool free_goal_vel=false);
   
   /**
-   * @brief Plan a trajectory between a given start and goal pose
+   * @brief Refine the previously planned trajectory with a reduced optimization effort
    * 
-   * Call this method to create and optimize a trajectory that is initialized between a given start and goal pose. \n
-   * The method supports hot-starting from previous solutions, if avaiable: \n
-   * 	- If no trajectory exist yet, a new trajectory is initialized between start and goal poses
-   *	  @see TimedElasticBand::initTEBtoGoal
-   * 	- If a previous solution is avaiable, update the trajectory @see bool TimedElasticBand::updateAndPruneTEB
-   * 	- Afterwards optimize the recently initialized or updated trajectory by calling optimizeTEB() and invoking g2o
-   * @param start PoseSE2 containing the start pose of the trajectory
-   * @param goal PoseSE2 containing the goal pose of the trajectory
-   * @param start_vel Initial velocity at the start pose (twist message containing the translational and angular velocity).
+   * The trajectory is updated w.r.t. the start and goal pose of the initial plan (see TimedElasticBand::updateAndPruneTEB)
+   * and optimized by calling optimizeTEB() with TebConfig::Replanning::refine_iterations and a single outer iteration.
+   * A regular plan() is performed if no trajectory exists yet or if the goal is too far away from the previous one.
+   * @param initial_plan container of poses (start and goal included)
+   * @param start_vel Current start velocity (e.g. the velocity of the robot, only vx, vy (holonomic) and omega are used)
    * @param free_goal_vel if \c true, a nonzero final velocity at the goal pose is allowed,
    *		      otherwise the final velocity will be zero (default: false)
    * @return \c true if planning was successful, \c false otherwise
    */
-  virtual bool plan(const PoseSE2& start, const PoseSE2& goal, const geometry_msgs::Twist* start_vel = NULL, bool free_goal_vel=false);
+  virtual bool refine(const PoseSE2Container& initial_plan, const Twist2D* start_vel = NULL, bool free_goal_vel=false);
   
   
   /**
@@ -215,6 +207,30 @@ public:
    */
   virtual bool getVelocityCommand(double& vx, double& vy, double& omega) const;
   
+  /**
+   * @brief Compute the deviation of a pose from the current trajectory
+   * 
+   * The distance is measured w.r.t. the line segments between the two poses adjacent to the closest pose.
+   * @param pose pose to be compared with the trajectory (e.g. the current robot pose)
+   * @param[out] dist Euclidean distance to the trajectory [m]
+   * @param[out] angle_diff absolute orientation difference to the closest pose of the trajectory [rad]
+   * @return \c true if a trajectory is available, \c false otherwise
+   */
+  virtual bool computeTrackingError(const PoseSE2& pose, double& dist, double& angle_diff) const;
+  
+  /**
+   * @brief Predict the state of the robot at a future time instant according to the current trajectory
+   * 
+   * The pose is interpolated linearly between the two enclosing poses of the trajectory and the velocity
+   * is extracted from the same transition (see extractVelocity()).
+   * Time instants beyond the end of the trajectory are mapped to the goal pose.
+   * @param t time w.r.t. the start of the trajectory [s]
+   * @param[out] pose predicted pose
+   * @param[out] velocity predicted velocity (w.r.t. the robot frame)
+   * @return \c true if a trajectory is available, \c false otherwise
+   */
+  virtual bool predictState(double t, PoseSE2& pose, Twist2D& velocity) const;
+  
   
   /**
    * @brief Optimize a previously initialized trajectory (actual TEB optimization loop).
@@ -253,19 +269,19 @@ public:
   
   
   /**
-   * @brief Set the initial velocity at the trajectory's start pose (e.g. the robot's velocity) [twist overload].
+   * @brief Set the initial velocity at the trajectory's start pose (e.g. the robot's velocity).
    * @remarks Calling this function is not neccessary if the initial velocity is passed via the plan() method
-   * @param vel_start Current start velocity (e.g. the velocity of the robot, only linear.x and angular.z are used,
-   *                  for holonomic robots also linear.y)
+   * @param vel_start Current start velocity (e.g. the velocity of the robot, only vx and omega are used,
+   *                  for holonomic robots also vy)
    */
-  void setVelocityStart(const geometry_msgs::Twist& vel_start);
+  void setVelocityStart(const Twist2D& vel_start);
   
   /**
    * @brief Set the desired final velocity at the trajectory's goal pose.
    * @remarks Call this function only if a non-zero velocity is desired and if \c free_goal_vel is set to \c false in plan()
-   * @param vel_goal twist message containing the translational and angular final velocity 
+   * @param vel_goal translational and angular final velocity 
    */
-  void setVelocityGoal(const geometry_msgs::Twist& vel_goal);
+  void setVelocityGoal(const Twist2D& vel_goal);
   
   /**
    * @brief Set the desired final velocity at the trajectory's goal pose to be the maximum velocity limit
@@ -273,6 +289,17 @@ public:
    */
   void setVelocityGoalFree() {vel_goal_.first = false;}
   
+  /**
+   * @brief Replace the constant velocity time differences of a newly initialized trajectory by a dynamically feasible time profile
+   *
+   * The trajectory is resized w.r.t. the temporal resolution first (if \c teb_autosize is enabled), since a trajectory initialized
+   * between start and goal consists of a few samples only. Afterwards TimedElasticBand::initTimeProfile() is invoked with the
+   * current start velocity and the goal velocity (the maximum velocity if the goal velocity is free).
+   * @remarks Nothing is done unless the parameter \c trajectory.feasible_time_init is enabled.
+   *          Call this function after the start and goal velocities have been assigned.
+   */
+  void initFeasibleTimeProfile();
+  
   //@}
   
   
@@ -315,27 +342,6 @@ public:
   //@}
 	  
   
-  /** @name Visualization */
-  //@{
-  
-  /**
-   * @brief Register a TebVisualization class to enable visiualization routines (e.g. publish the local plan and pose sequence)
-   * @param visualization shared pointer to a TebVisualization instance
-   * @see visualize
-   */
-  void setVisualization(TebVisualizationPtr visualization);
-  
-  /**
-   * @brief Publish the local plan and pose sequence via ros topics (e.g. subscribe with rviz).
-   * 
-   * Make sure to register a TebVisualization instance before using setVisualization() or an overlaoded constructor.
-   * @see setVisualization
-   */
-  virtual void visualize();
-  
-  //@}
-  
-  
   /** @name Utility methods and more */
   //@{
         
@@ -445,6 +451,72 @@ public:
    */
   double getCurrentCost() const {return cost_;}
   
+  /**
+   * @brief Access the number of solver iterations of the last optimizeTEB() call
+   * 
+   * The number of iterations is accumulated over all outer loop iterations.
+   * @return total number of inner (solver) iterations 
+   */
+  int getLastIterations() const {return iterations_;}
+  
+  /**
+   * @brief Access the largest violation of the hard constraints after the last optimizeTEB() call
+   * 
+   * The violation is the largest penalty value of the velocity, acceleration and obstacle separation constraints
+   * (refer to ConstraintEdge) and it is evaluated after the last outer iteration.
+   * @return largest constraint violation (NaN if the last optimization did not complete)
+   */
+  double getConstraintViolation() const {return constraint_violation_;}
+  
+  /**
+   * @brief Register a telemetry sink that records statistics of each optimizer iteration
+   * 
+   * For each inner (solver) iteration the chi2 value, the Levenberg-Marquardt damping, the number of rejected steps
+   * and the time split between linearization, Hessian construction and solve are recorded.
+   * Additionally, a summary record is stored for each outer iteration.
+   * Pass an empty pointer in order to disable the recording (default).
+   * @param telemetry shared telemetry instance (see OptimizerTelemetry)
+   */
+  virtual void setTelemetry(OptimizerTelemetryPtr telemetry);
+  
+  /**
+   * @brief Set the id that is stored in each telemetry record of this planner (see OptimizerIterationRecord::source)
+   * @param source_id arbitrary id, e.g. the index of a trajectory candidate
+   */
+  void setTelemetrySourceId(int source_id) {telemetry_source_id_ = source_id;}
+  
+  /**
+   * @brief Access the registered telemetry sink (might be empty)
+   */
+  OptimizerTelemetryPtr getTelemetry() const {return telemetry_;}
+  
+  /**
+   * @brief Register a cache of optimized trajectories that is used to initialize new trajectories
+   * 
+   * On a cold start (or after a re-initialization), the trajectory of the most similar stored planning problem
+   * is used as initial guess. The optimized trajectory of each cold start is stored in the cache.
+   * @param cache shared cache instance (see ExperienceCache), pass an empty pointer in order to detach the cache
+   */
+  virtual void setExperienceCache(ExperienceCachePtr cache) {experience_cache_ = cache;}
+  
+  /**
+   * @brief Access the registered experience cache (might be empty)
+   */
+  ExperienceCachePtr getExperienceCache() const {return experience_cache_;}
+  
+  /**
+   * @brief Initialize the (empty) trajectory from the experience cache
+   * @param start start pose
+   * @param goal goal pose
+   * @return \c true if a matching entry has been found, \c false if the cache is disabled or no entry matches
+   */
+  bool initTrajectoryFromExperience(const PoseSE2& start, const PoseSE2& goal);
+  
+  /**
+   * @brief Store the current trajectory in the experience cache (if it is enabled and the trajectory is collision free)
+   */
+  void storeExperience();
+  
     
   /**
    * @brief Extract the velocity from consecutive poses and a time difference (including strafing velocity for holonomic robots)
@@ -478,7 +550,7 @@ public:
    * to the next step refer to getVelocityCommand().
    * @param[out] velocity_profile velocity profile will be written to this vector (after clearing any existing content) with the size=no_poses+1
    */
-  void getVelocityProfile(std::vector<geometry_msgs::Twist>& velocity_profile) const;
+  void getVelocityProfile(std::vector<Twist2D>& velocity_profile) const;
   
     /**
    * @brief Return the complete trajectory including poses, velocity profiles and temporal information
@@ -491,23 +563,20 @@ public:
    * @todo The acceleration profile is not added at the moment.
    * @param[out] trajectory the resulting trajectory
    */
-  void getFullTrajectory(std::vector<TrajectoryPointMsg>& trajectory) const;
+  void getFullTrajectory(TrajectoryPointContainer& trajectory) const;
   
   /**
    * @brief Check whether the planned trajectory is feasible or not.
    * 
    * This method currently checks only that the trajectory, or a part of the trajectory is collision free.
-   * Obstacles are here represented as costmap instead of the internal ObstacleContainer.
-   * @param costmap_model Pointer to the costmap model
-   * @param footprint_spec The specification of the footprint of the robot in world coordinates
-   * @param inscribed_radius The radius of the inscribed circle of the robot
-   * @param circumscribed_radius The radius of the circumscribed circle of the robot
+   * Obstacles are here represented by an external world model (e.g. a costmap) instead of the internal ObstacleContainer.
+   * Intermediate poses are interpolated if consecutive poses are further apart than the inscribed radius of the checker.
+   * @param checker Collision checker that validates single robot poses
    * @param look_ahead_idx Number of poses along the trajectory that should be verified, if -1, the complete trajectory will be checked.
    * @return \c true, if the robot footprint along the first part of the trajectory intersects with 
    *         any obstacle in the costmap, \c false otherwise.
    */
-  virtual bool isTrajectoryFeasible(base_local_planner::CostmapModel* costmap_model, const std::vector<geometry_msgs::Point>& footprint_spec, double inscribed_radius = 0.0,
-          double circumscribed_radius=0.0, int look_ahead_idx=-1);
+  virtual bool isTrajectoryFeasible(const FootprintCollisionChecker& checker, int look_ahead_idx=-1);
   
   
   /**
@@ -523,7 +592,7 @@ public:
    * @param initial_plan The intial and transformed plan (part of the local map and pruned up to the robot position)
    * @return \c true, if the planner suggests a shorter horizon, \c false otherwise.
    */
-  virtual bool isHorizonReductionAppropriate(const std::vector<geometry_msgs::PoseStamped>& initial_plan) const;
+  virtual bool isHorizonReductionAppropriate(const PoseSE2Container& initial_plan) const;
   
   //@}
   
@@ -615,6 +684,17 @@ protected:
    */
   void AddEdgesShortestPath();
   
+  /**
+   * @brief Add fused edges (local cost functions) for all terms between consecutive poses (velocity, kinematics and path length)
+   * 
+   * Replaces AddEdgesVelocity(), AddEdgesShortestPath() and AddEdgesKinematicsDiffDrive() resp. AddEdgesKinematicsCarlike()
+   * for non-holonomic robots if the parameter optim.fuse_consecutive_pose_edges is enabled.
+   * @see EdgeConsecutivePoses
+   * @see buildGraph
+   * @see optimizeGraph
+   */
+  void AddEdgesConsecutivePoses();
+  
   /**
    * @brief Add all edges (local cost functions) related to keeping a distance from static obstacles
    * @warning do not combine with AddEdgesInflatedObstacles
@@ -688,6 +768,104 @@ protected:
    * @return shared pointer to the g2o::SparseOptimizer instance
    */
   boost::shared_ptr<g2o::SparseOptimizer> initOptimizer();
+  
+  /**
+   * @brief Append the batch statistics of the last optimizeGraph() call and a summary of the outer iteration to the telemetry sink
+   * @param outer_iteration index of the current outer iteration
+   * @param time_outer_iteration duration of the complete outer iteration [s]
+   */
+  void recordTelemetry(int outer_iteration, double time_outer_iteration);
+  
+  /**
+   * @brief Optimize the current trajectory together with alternative initializations and keep the best one
+   * 
+   * The alternative trajectories are initialized from scratch (refer to TebConfig::Optimization::multi_start_candidates):
+   * along the global plan, as straight line and along the global plan laterally displaced by
+   * multiples of \c multi_start_lateral_offset to the left and to the right.
+   * All trajectories are optimized in parallel if TebConfig::HomotopyClasses::enable_multithreading is enabled.
+   * The collision-free trajectory with the lowest cost replaces the current one.
+   * @param initial_plan vector of geometry_msgs::PoseStamped
+   * @return \c true if at least one optimization was successful, \c false otherwise
+   */
+  bool optimizeMultiStart(const PoseSE2Container& initial_plan);
+  
+  /**
+   * @brief Initialize the trajectory of an alternative start (see optimizeMultiStart())
+   * @param candidate index of the alternative start
+   * @param initial_plan vector of geometry_msgs::PoseStamped
+   * @param[out] teb trajectory to be initialized
+   * @return \c true if the initialization was successful
+   */
+  bool initMultiStartCandidate(int candidate, const PoseSE2Container& initial_plan, TimedElasticBand& teb);
+  
+  /**
+   * @brief Initialize the trajectory of a car-like robot along the shortest Reeds-Shepp (or Dubins) path
+   * 
+   * The path is sampled such that the spacing corresponds to \c dt_ref at the maximum (forward or backward) velocity.
+   * @remarks Nothing is done unless \c trajectory.carlike_path_init is enabled and \c robot.min_turning_radius is positive.
+   * @param start start pose
+   * @param goal goal pose
+   * @return \c true if teb_ has been initialized, \c false if the caller should fall back to the default initialization
+   */
+  bool initCarlikeTrajectory(const PoseSE2& start, const PoseSE2& goal);
+  
+  /**
+   * @brief Check the first poses of the trajectory against the obstacle container using the robot footprint model
+   * @param look_ahead_idx number of poses that are checked (all poses if negative)
+   * @return \c true if the footprint does not intersect any obstacle, \c false otherwise
+   */
+  bool isCollisionFree(int look_ahead_idx) const;
+  
+  /**
+   * @brief Optimize the trajectory with the augmented Lagrangian method (refer to TebConfig::Optimization::augmented_lagrangian)
+   * 
+   * The graph is built only once. Instead of rebuilding it with increased obstacle weights,
+   * each outer iteration updates the multipliers of all constraint edges in place (see ConstraintShift).
+   * The outer iterations terminate as soon as the largest constraint violation falls below
+   * TebConfig::Optimization::augmented_lagrangian_tolerance.
+   * Parameters are the same as for optimizeTEB().
+   * @return \c true if the optimization terminates successfully, \c false otherwise
+   */
+  bool optimizeTEBAugmentedLagrangian(int iterations_innerloop, int iterations_outerloop, bool compute_cost_afterwards,
+                                      double obst_cost_scale, double viapoint_cost_scale, bool alternative_time_cost);
+  
+  /**
+   * @brief Compute the largest constraint violation of all constraint edges of the current graph (see ConstraintEdge)
+   * 
+   * The errors of the edges must be up to date.
+   * @return largest constraint violation (zero if the graph does not contain any constraint edge)
+   */
+  double computeConstraintViolation() const;
+  
+  /**
+   * @brief Update or reset the augmented Lagrangian multipliers of all constraint edges of the current graph (see ConstraintEdge)
+   * @param reset if \c true, all multipliers are set to zero, otherwise they are updated with the current constraint violation
+   */
+  void updateConstraintMultipliers(bool reset);
+  
+  /**
+   * @brief Optimize the trajectory segment-wise (refer to TebConfig::Optimization::horizon_partitions)
+   * 
+   * Each segment is copied to a separate planner in which the two outer poses at each segment boundary are fixed.
+   * Hence, the segments are independent of each other and they are optimized in parallel if
+   * TebConfig::HomotopyClasses::enable_multithreading is enabled.
+   * A second sweep with boundaries shifted by half a segment length optimizes the poses that were fixed in the first sweep.
+   * Alternating both sweeps corresponds to an overlapping block Gauss-Seidel (Schwarz) iteration, whose fixed points
+   * coincide with the stationary points of the complete problem.
+   * @param partitions number of segments of the first sweep (the shifted sweep has one segment more)
+   * @param iterations_innerloop number of solver iterations for each segment and sweep
+   * @param weight_multiplier scales some weights of the obstacle edges (refer to buildGraph())
+   * @return \c true if all segments were optimized successfully, \c false otherwise
+   */
+  bool optimizeHorizonPartitions(int partitions, int iterations_innerloop, double weight_multiplier);
+  
+  /**
+   * @brief Build and optimize the graph of a single segment of optimizeHorizonPartitions() (called on the segment planner)
+   * @param iterations_innerloop number of solver iterations
+   * @param weight_multiplier scales some weights of the obstacle edges (refer to buildGraph())
+   * @param[out] success \c true if the optimization was successful
+   */
+  void optimizeHorizonSegment(int iterations_innerloop, double weight_multiplier, char* success);
     
 
   // external objects (store weak pointers)
@@ -696,15 +874,37 @@ protected:
   const ViaPointContainer* via_points_; //!< Store via points for planning
   
   double cost_; //!< Store cost value of the current hyper-graph
+  int iterations_; //!< Number of solver iterations performed during the last call of optimizeTEB()
   RotType prefer_rotdir_; //!< Store whether to prefer a specific initial rotation in optimization (might be activated in case the robot oscillates)
   
   // internal objects (memory management owned)
-  TebVisualizationPtr visualization_; //!< Instance of the visualization class
   TimedElasticBand teb_; //!< Actual trajectory object
   RobotFootprintModelPtr robot_model_; //!< Robot model
+  FootprintType footprint_type_; //!< Concrete type of the robot model, selects the specialized obstacle edges
   boost::shared_ptr<g2o::SparseOptimizer> optimizer_; //!< g2o optimizer for trajectory optimization
-  std::pair<bool, geometry_msgs::Twist> vel_start_; //!< Store the initial velocity at the start pose
-  std::pair<bool, geometry_msgs::Twist> vel_goal_; //!< Store the final velocity at the goal pose
+  TEBLinearSolver* linear_solver_; //!< Linear solver of the optimizer (owned by the optimizer)
+  std::pair<bool, Twist2D> vel_start_; //!< Store the initial velocity at the start pose
+  std::pair<bool, Twist2D> vel_goal_; //!< Store the final velocity at the goal pose
+  
+  OptimizerTelemetryPtr telemetry_; //!< Optional sink for per-iteration optimizer statistics
+  ExperienceCachePtr experience_cache_; //!< Optional cache of optimized trajectories for the initialization of new trajectories
+  int telemetry_source_id_; //!< Id that is stored in each telemetry record
+  boost::shared_ptr<g2o::HyperGraphAction> telemetry_action_; //!< Post-iteration action that captures the Levenberg-Marquardt damping
+  std::vector<double> telemetry_lambdas_; //!< Levenberg-Marquardt damping of each inner iteration (preallocated)
+  
+  EdgeChainBatch edge_batch_; //!< Batch linearization of the velocity, acceleration and kinematics edges (if optim.batch_edge_linearization is enabled)
+  
+  std::vector< boost::shared_ptr<TebOptimalPlanner> > multi_start_planners_; //!< Planners for the alternative initializations (see optimizeMultiStart())
+  PoseSE2Container multi_start_plan_; //!< Laterally displaced plan used to initialize the alternative trajectories (preallocated)
+  PoseSE2Container carlike_init_plan_; //!< Sampled Reeds-Shepp path used to initialize car-like trajectories (preallocated)
+  std::vector<char> multi_start_success_; //!< Result of each optimization of optimizeMultiStart() (\c char instead of \c bool, since elements are written concurrently)
+  
+  std::vector< boost::shared_ptr<TebOptimalPlanner> > horizon_segment_planners_; //!< Planners for the trajectory segments (see optimizeHorizonPartitions())
+  std::vector<ViaPointContainer> horizon_segment_via_points_; //!< Via-points that are associated with the free poses of each segment
+  std::vector<int> horizon_boundaries_; //!< Pose indices of the segment boundaries of the current sweep (preallocated)
+  std::vector<char> horizon_segment_success_; //!< Result of each segment optimization (\c char instead of \c bool, since elements are written concurrently)
+  double constraint_violation_; //!< Largest constraint violation after the last optimizeTEB() call
+  double horizon_time_offset_; //!< Time of the first pose w.r.t. the start of the complete trajectory (non-zero for segment planners of optimizeHorizonPartitions() only)
 
   bool initialized_; //!< Keeps track about the correct initialization of this class
   bool optimized_; //!< This variable is \c true as long as the last optimization has been completed successful
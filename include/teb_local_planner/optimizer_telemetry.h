@@ -0,0 +1,171 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef OPTIMIZER_TELEMETRY_H_
+#define OPTIMIZER_TELEMETRY_H_
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <vector>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @struct OptimizerIterationRecord
+ * @brief Telemetry of a single solver iteration (inner loop) of the TEB optimization
+ * 
+ * Records with \c inner_iteration == -1 summarize a complete outer iteration
+ * (trajectory resizing, graph construction and all inner iterations).
+ * All durations are given in seconds.
+ */
+struct OptimizerIterationRecord
+{
+  unsigned int cycle; //!< Planning cycle (see OptimizerTelemetry::nextCycle())
+  int source; //!< Id of the recording planner (e.g. index of the trajectory candidate in the HomotopyClassPlanner)
+  int outer_iteration; //!< Index of the outer iteration
+  int inner_iteration; //!< Index of the solver iteration, -1 for the summary of an outer iteration
+  int num_vertices; //!< Number of vertices in the graph
+  int num_edges; //!< Number of edges in the graph
+  double chi2; //!< Sum of squared errors after the iteration
+  double lambda; //!< Levenberg-Marquardt damping after the iteration
+  int rejected_steps; //!< Number of rejected Levenberg-Marquardt steps (damping increases) within the iteration
+  double time_residuals; //!< Time for evaluating all edge errors
+  double time_linearize; //!< Time for computing all edge jacobians
+  double time_hessian; //!< Time for building the (approximate) Hessian
+  double time_solve; //!< Time for solving the linear system (including repeated solves after rejected steps)
+  double time_iteration; //!< Total time of the iteration
+  double constraint_violation; //!< Largest violation of the hard constraints (evaluated for summaries only, otherwise NaN)
+};
+
+
+/**
+ * @class OptimizerTelemetry
+ * @brief Preallocated ring buffer that collects per-iteration statistics of the optimizer
+ * 
+ * Register an instance with PlannerInterface::setTelemetry() in order to record the chi2 value,
+ * Levenberg-Marquardt damping, number of rejected steps and the time split between linearization,
+ * Hessian construction and linear solve for each iteration of the optimization.
+ * The buffer is allocated once at construction. If it is full, the oldest records are overwritten,
+ * hence recording does not allocate memory during planning.
+ * All methods are thread-safe, so the same instance can be shared among several planners
+ * (e.g. the trajectory candidates of the HomotopyClassPlanner that are optimized in parallel).
+ */
+class OptimizerTelemetry
+{
+public:
+  
+  /**
+   * @brief Construct the telemetry sink and preallocate the ring buffer
+   * @param capacity maximum number of records that are kept (the oldest ones are overwritten)
+   */
+  OptimizerTelemetry(std::size_t capacity = 1000);
+  
+  /**
+   * @brief Append a record to the ring buffer
+   * @remarks The field \c cycle is overwritten with the current planning cycle.
+   * @param record record to be stored
+   */
+  void record(const OptimizerIterationRecord& record);
+  
+  /**
+   * @brief Start a new planning cycle
+   * 
+   * Call this method once per control cycle (before invoking the planner) in order to
+   * separate the records of subsequent cycles (see getCycle()).
+   * @return id of the new cycle
+   */
+  unsigned int nextCycle();
+  
+  /**
+   * @brief Get the id of the current planning cycle
+   */
+  unsigned int currentCycle() const;
+  
+  /**
+   * @brief Copy all stored records (from the oldest to the most recent one)
+   * @param[out] records container that is filled with the records (cleared before)
+   */
+  void getRecords(std::vector<OptimizerIterationRecord>& records) const;
+  
+  /**
+   * @brief Copy all stored records of a specific planning cycle (from the oldest to the most recent one)
+   * @param cycle id of the planning cycle
+   * @param[out] records container that is filled with the records (cleared before)
+   */
+  void getCycle(unsigned int cycle, std::vector<OptimizerIterationRecord>& records) const;
+  
+  /**
+   * @brief Number of records currently stored
+   */
+  std::size_t size() const;
+  
+  /**
+   * @brief Maximum number of records
+   */
+  std::size_t capacity() const {return buffer_.size();}
+  
+  /**
+   * @brief Total number of records that were dropped since the buffer was full
+   */
+  unsigned long droppedRecords() const;
+  
+  /**
+   * @brief Remove all records (the planning cycle id is kept)
+   */
+  void clear();
+  
+private:
+  
+  std::vector<OptimizerIterationRecord> buffer_; //!< Preallocated ring buffer
+  std::size_t head_; //!< Index of the next record to be written
+  std::size_t size_; //!< Number of valid records
+  unsigned long dropped_; //!< Number of overwritten records
+  unsigned int cycle_; //!< Current planning cycle
+  
+  mutable boost::mutex mutex_; //!< Mutex that protects the buffer against concurrent access
+};
+
+//! Abbrev. for shared instances of the OptimizerTelemetry
+typedef boost::shared_ptr<OptimizerTelemetry> OptimizerTelemetryPtr;
+
+} // namespace teb_local_planner
+
+#endif /* OPTIMIZER_TELEMETRY_H_ */
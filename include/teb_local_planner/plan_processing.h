@@ -0,0 +1,141 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef PLAN_PROCESSING_H_
+#define PLAN_PROCESSING_H_
+
+#include <teb_local_planner/pose_se2.h>
+#include <teb_local_planner/teb_types.h>
+#include <teb_local_planner/optimal_planner.h> // ViaPointContainer
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @brief Prune the global plan such that already passed poses are cut off
+ * 
+ * The global plan is pruned until the distance to the robot is at least \c dist_behind_robot.
+ * If no pose within the specified treshold \c dist_behind_robot can be found,
+ * nothing will be pruned and the method returns \c false.
+ * @remarks The robot pose must be given w.r.t. the frame of the global plan.
+ * @param robot_pose current robot pose
+ * @param[in,out] global_plan the plan to be pruned
+ * @param dist_behind_robot distance behind the robot that should be kept [meters]
+ * @return \c true if the plan is pruned, \c false if no pose can be found inside the threshold
+ */
+bool prunePlan(const PoseSE2& robot_pose, PoseSE2Container& global_plan, double dist_behind_robot=1);
+
+/**
+ * @brief Extract the local portion of the global plan that is considered by the local planner
+ * 
+ * Starting from the pose closest to the robot, poses are copied until either the distance to the robot
+ * exceeds \c dist_threshold (e.g. the size of the local map) or the cumulative length exceeds \c max_plan_length.
+ * If the resulting local plan is empty (e.g. the robot is close to the goal but the orientation is not yet reached),
+ * the global goal is injected explicitly.
+ * @remarks This is the ROS-free counterpart of TebLocalPlannerROS::transformGlobalPlan (without frame transformation).
+ * @param global_plan the global plan (w.r.t. the planning frame)
+ * @param robot_pose current robot pose
+ * @param dist_threshold poses farther away from the robot are not considered [m]
+ * @param max_plan_length maximum length (cumulative Euclidean distances) of the local plan [if <=0: disabled]
+ * @param[out] local_plan populated with the local plan
+ * @param[out] current_goal_idx index of the current (local) goal pose in the global plan
+ * @return \c true if the local plan is extracted, \c false if the global plan is empty
+ */
+bool extractLocalPlan(const PoseSE2Container& global_plan, const PoseSE2& robot_pose, double dist_threshold, double max_plan_length,
+                      PoseSE2Container& local_plan, int* current_goal_idx = NULL);
+
+/**
+ * @brief Sample via-points along a (local) reference plan
+ * @remarks All previous via-points will be cleared.
+ * @param plan reference plan
+ * @param min_separation minimum separation between two consecutive via-points [if <=0: no via-points are created]
+ * @param[out] via_points via-point container to be filled
+ */
+void extractViaPoints(const PoseSE2Container& plan, double min_separation, ViaPointContainer& via_points);
+
+/**
+ * @brief Estimate the orientation of the local goal from subsequent poses of the global plan
+ * 
+ * If the current (local) goal point is not the final one (global) the goal orientation is substituted
+ * by the average direction between the local goal and the subsequent poses of the global plan.
+ * @remarks This is the ROS-free counterpart of TebLocalPlannerROS::estimateLocalGoalOrientation.
+ * @param global_plan the global plan (w.r.t. the planning frame)
+ * @param local_goal current local goal
+ * @param current_goal_idx index of the current (local) goal pose in the global plan
+ * @param moving_average_length number of future poses of the global plan to be taken into account
+ * @return orientation (yaw-angle) estimate
+ */
+double estimateLocalGoalOrientation(const PoseSE2Container& global_plan, const PoseSE2& local_goal,
+                                    int current_goal_idx, int moving_average_length=3);
+
+/**
+ * @brief Saturate the translational and angular velocity to given limits.
+ * 
+ * The limit of the translational velocity for backwards driving can be changed independently.
+ * Do not choose max_vel_x_backwards <= 0. If no backward driving is desired, change the optimization weight for
+ * penalizing backwards driving instead.
+ * @param[in,out] vx The translational velocity that should be saturated.
+ * @param[in,out] vy Strafing velocity which can be nonzero for holonomic robots
+ * @param[in,out] omega The angular velocity that should be saturated.
+ * @param max_vel_x Maximum translational velocity for forward driving
+ * @param max_vel_y Maximum strafing velocity (for holonomic robots)
+ * @param max_vel_theta Maximum (absolute) angular velocity
+ * @param max_vel_x_backwards Maximum translational velocity for backwards driving
+ */
+void saturateVelocity(double& vx, double& vy, double& omega, double max_vel_x, double max_vel_y,
+                      double max_vel_theta, double max_vel_x_backwards);
+
+/**
+ * @brief Convert translational and rotational velocities to a steering angle of a carlike robot
+ * 
+ * The conversion is based on the following equations:
+ * - The turning radius is defined by \f$ R = v/omega \f$
+ * - For a car like robot withe a distance L between both axles, the relation is: \f$ tan(\phi) = L/R \f$
+ * - phi denotes the steering angle.
+ * @param v translational velocity [m/s]
+ * @param omega rotational velocity [rad/s]
+ * @param wheelbase distance between both axles (drive shaft and steering axle), the value might be negative for back_wheeled robots
+ * @param min_turning_radius Specify a lower bound on the turning radius
+ * @return Resulting steering angle in [rad] inbetween [-pi/2, pi/2]
+ */
+double convertTransRotVelToSteeringAngle(double v, double omega, double wheelbase, double min_turning_radius = 0);
+
+} // namespace teb_local_planner
+
+#endif /* PLAN_PROCESSING_H_ */
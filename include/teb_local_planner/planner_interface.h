@@ -42,17 +42,13 @@
 // boost
 #include <boost/shared_ptr.hpp>
 
-// ros
-#include <tf/transform_datatypes.h>
-#include <base_local_planner/costmap_model.h>
-
 // this package
 #include <teb_local_planner/pose_se2.h>
-
-// messages
-#include <geometry_msgs/PoseArray.h>
-#include <geometry_msgs/PoseStamped.h>
-#include <geometry_msgs/TwistStamped.h>
+#include <teb_local_planner/teb_types.h>
+#include <teb_local_planner/collision_checker.h>
+#include <teb_local_planner/logging.h>
+#include <teb_local_planner/optimizer_telemetry.h>
+#include <teb_local_planner/experience_cache.h>
 
 
 namespace teb_local_planner
@@ -89,39 +85,44 @@ public:
    * 
    * Provide this method to create and optimize a trajectory that is initialized
    * according to an initial reference plan (given as a container of poses).
-   * @param initial_plan vector of geometry_msgs::PoseStamped
-   * @param start_vel Current start velocity (e.g. the velocity of the robot, only linear.x and angular.z are used)
+   * @param initial_plan container of poses (start and goal included)
+   * @param start_vel Current start velocity (e.g. the velocity of the robot, only vx and omega are used for non-holonomic robots)
    * @param free_goal_vel if \c true, a nonzero final velocity at the goal pose is allowed,
    *        otherwise the final velocity will be zero (default: false)
    * @return \c true if planning was successful, \c false otherwise
    */
-  virtual bool plan(const std::vector<geometry_msgs::PoseStamped>& initial_plan, const geometry_msgs::Twist* start_vel = NULL, bool free_goal_vel=false) = 0;
+  virtual bool plan(const PoseSE2Container& initial_plan, const Twist2D* start_vel = NULL, bool free_goal_vel=false) = 0;
   
   /**
-   * @brief Plan a trajectory between a given start and goal pose (tf::Pose version).
+   * @brief Plan a trajectory between a given start and goal pose.
    * 
    * Provide this method to create and optimize a trajectory that is initialized between a given start and goal pose.
-   * @param start tf::Pose containing the start pose of the trajectory
-   * @param goal tf::Pose containing the goal pose of the trajectory
-   * @param start_vel Current start velocity (e.g. the velocity of the robot, only linear.x and angular.z are used)
+   * @param start PoseSE2 containing the start pose of the trajectory
+   * @param goal PoseSE2 containing the goal pose of the trajectory
+   * @param start_vel Initial velocity at the start pose (containing the translational and angular velocity).
    * @param free_goal_vel if \c true, a nonzero final velocity at the goal pose is allowed,
    *        otherwise the final velocity will be zero (default: false)
    * @return \c true if planning was successful, \c false otherwise
    */
-  virtual bool plan(const tf::Pose& start, const tf::Pose& goal, const geometry_msgs::Twist* start_vel = NULL, bool free_goal_vel=false) = 0;
+  virtual bool plan(const PoseSE2& start, const PoseSE2& goal, const Twist2D* start_vel = NULL, bool free_goal_vel=false) = 0;
   
   /**
-   * @brief Plan a trajectory between a given start and goal pose.
+   * @brief Refine the previously planned trajectory with a reduced optimization effort.
    * 
-   * Provide this method to create and optimize a trajectory that is initialized between a given start and goal pose.
-   * @param start PoseSE2 containing the start pose of the trajectory
-   * @param goal PoseSE2 containing the goal pose of the trajectory
-   * @param start_vel Initial velocity at the start pose (twist msg containing the translational and angular velocity).
+   * The trajectory is warm-started w.r.t. the new start and goal pose and optimized with
+   * TebConfig::Replanning::refine_iterations solver iterations only (e.g. no exploration of new homotopy classes).
+   * This method is intended for control cycles in which the planning problem did not change (see ReplanningMonitor).
+   * The default implementation performs a regular plan().
+   * @param initial_plan container of poses (start and goal included)
+   * @param start_vel Current start velocity (e.g. the velocity of the robot, only vx and omega are used for non-holonomic robots)
    * @param free_goal_vel if \c true, a nonzero final velocity at the goal pose is allowed,
    *        otherwise the final velocity will be zero (default: false)
    * @return \c true if planning was successful, \c false otherwise
    */
-  virtual bool plan(const PoseSE2& start, const PoseSE2& goal, const geometry_msgs::Twist* start_vel = NULL, bool free_goal_vel=false) = 0;
+  virtual bool refine(const PoseSE2Container& initial_plan, const Twist2D* start_vel = NULL, bool free_goal_vel=false)
+  {
+    return plan(initial_plan, start_vel, free_goal_vel);
+  }
   
   /**
    * @brief Get the velocity command from a previously optimized plan to control the robot at the current sampling interval.
@@ -133,6 +134,24 @@ public:
    */
   virtual bool getVelocityCommand(double& vx, double& vy, double& omega) const = 0;
   
+  /**
+   * @brief Compute the deviation of a pose (e.g. the current robot pose) from the previously planned trajectory.
+   * @param pose pose to be compared with the trajectory
+   * @param[out] dist Euclidean distance to the closest pose of the trajectory [m]
+   * @param[out] angle_diff absolute orientation difference to the closest pose of the trajectory [rad]
+   * @return \c true if a trajectory is available, \c false otherwise (default implementation)
+   */
+  virtual bool computeTrackingError(const PoseSE2& pose, double& dist, double& angle_diff) const {return false;}
+  
+  /**
+   * @brief Predict the state of the robot at a future time instant according to the previously planned trajectory.
+   * @param t time w.r.t. the start of the trajectory [s]
+   * @param[out] pose predicted pose
+   * @param[out] velocity predicted velocity (w.r.t. the robot frame)
+   * @return \c true if a trajectory is available, \c false otherwise (default implementation)
+   */
+  virtual bool predictState(double t, PoseSE2& pose, Twist2D& velocity) const {return false;}
+  
   //@}
   
   
@@ -149,31 +168,35 @@ public:
    * Initial means that the penalty is applied only to the first few poses of the trajectory.
    * @param dir This parameter might be RotType::left (prefer left), RotType::right (prefer right) or RotType::none (prefer none)
    */
-  virtual void setPreferredTurningDir(RotType dir) {ROS_WARN("setPreferredTurningDir() not implemented for this planner.");}
-    
+  virtual void setPreferredTurningDir(RotType dir) {TEB_WARN("setPreferredTurningDir() not implemented for this planner.");}
+  
   /**
-   * @brief Visualize planner specific stuff.
-   * Overwrite this method to provide an interface to perform all planner related visualizations at once.
-   */ 
-  virtual void visualize()
-  {
-  }
+   * @brief Register a telemetry sink that records statistics of each optimizer iteration
+   * 
+   * Pass an empty pointer in order to disable the recording.
+   * @param telemetry shared telemetry instance (see OptimizerTelemetry)
+   */
+  virtual void setTelemetry(OptimizerTelemetryPtr telemetry) {TEB_WARN("setTelemetry() not implemented for this planner.");}
   
+  /**
+   * @brief Register a cache of optimized trajectories that is used to initialize new trajectories (see ExperienceCache)
+   * 
+   * The cache is only used if the parameter \c experience.enable is set. Pass an empty pointer in order to detach the cache.
+   * @param cache shared cache instance
+   */
+  virtual void setExperienceCache(ExperienceCachePtr cache) {TEB_WARN("setExperienceCache() not implemented for this planner.");}
+    
   /**
    * @brief Check whether the planned trajectory is feasible or not.
    * 
    * This method currently checks only that the trajectory, or a part of the trajectory is collision free.
-   * Obstacles are here represented as costmap instead of the internal ObstacleContainer.
-   * @param costmap_model Pointer to the costmap model
-   * @param footprint_spec The specification of the footprint of the robot in world coordinates
-   * @param inscribed_radius The radius of the inscribed circle of the robot
-   * @param circumscribed_radius The radius of the circumscribed circle of the robot
+   * Obstacles are here represented by an external world model (e.g. a costmap) instead of the internal ObstacleContainer.
+   * @param checker Collision checker that validates single robot poses
    * @param look_ahead_idx Number of poses along the trajectory that should be verified, if -1, the complete trajectory will be checked.
    * @return \c true, if the robot footprint along the first part of the trajectory intersects with 
    *         any obstacle in the costmap, \c false otherwise.
    */
-  virtual bool isTrajectoryFeasible(base_local_planner::CostmapModel* costmap_model, const std::vector<geometry_msgs::Point>& footprint_spec,
-        double inscribed_radius = 0.0, double circumscribed_radius=0.0, int look_ahead_idx=-1) = 0;
+  virtual bool isTrajectoryFeasible(const FootprintCollisionChecker& checker, int look_ahead_idx=-1) = 0;
     
   
   /**
@@ -186,7 +209,7 @@ public:
    * @param initial_plan The intial and transformed plan (part of the local map and pruned up to the robot position)
    * @return \c true, if the planner suggests a shorter horizon, \c false otherwise.
    */
-  virtual bool isHorizonReductionAppropriate(const std::vector<geometry_msgs::PoseStamped>& initial_plan) const {return false;}   
+  virtual bool isHorizonReductionAppropriate(const PoseSE2Container& initial_plan) const {return false;}   
         
   /**
    * Compute and return the cost of the current optimization graph (supports multiple trajectories)
@@ -42,9 +42,10 @@
 #include <g2o/stuff/misc.h>
 
 #include <Eigen/Core>
+#include <Eigen/StdVector>
 #include <teb_local_planner/misc.h>
-#include <geometry_msgs/Pose.h>
-#include <tf/transform_datatypes.h>
+
+#include <vector>
 
 namespace teb_local_planner
 {
@@ -93,28 +94,6 @@ public:
       _theta = theta;
   }
   
-  /**
-   * @brief Construct pose using a geometry_msgs::Pose
-   * @param pose geometry_msgs::Pose object
-   */ 
-  PoseSE2(const geometry_msgs::Pose& pose)
-  {
-      _position.coeffRef(0) = pose.position.x;
-      _position.coeffRef(1) = pose.position.y;
-      _theta = tf::getYaw( pose.orientation );
-  }
-  
-  /**
-   * @brief Construct pose using a tf::Pose
-   * @param pose tf::Pose object
-   */ 
-  PoseSE2(const tf::Pose& pose)
-  {
-      _position.coeffRef(0) = pose.getOrigin().getX();
-      _position.coeffRef(1) = pose.getOrigin().getY();
-      _theta = tf::getYaw( pose.getRotation() );
-  }
-  
   /**
     * @brief Copy constructor
     * @param pose PoseSE2 instance
@@ -196,18 +175,6 @@ public:
     _theta = 0;
   }
   
-  /**
-   * @brief Convert PoseSE2 to a geometry_msgs::Pose
-   * @param[out] pose Pose message
-   */
-  void toPoseMsg(geometry_msgs::Pose& pose) const
-  {
-    pose.position.x = _position.x();
-    pose.position.y = _position.y();
-    pose.position.z = 0;
-    pose.orientation = tf::createQuaternionMsgFromYaw(_theta);
-  }
-  
   /**
    * @brief Return the unit vector of the current orientation
    * @returns [cos(theta), sin(theta))]^T
@@ -400,6 +367,8 @@ public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW  
 };
 
+//! Container of poses (e.g. an initial plan provided by a global planner)
+typedef std::vector< PoseSE2, Eigen::aligned_allocator<PoseSE2> > PoseSE2Container;
 
 } // namespace teb_local_planner
 
@@ -41,8 +41,11 @@
 
 
 #include <boost/circular_buffer.hpp>
-#include <geometry_msgs/Twist.h>
-#include <ros/ros.h>
+#include <teb_local_planner/teb_types.h>
+#include <teb_local_planner/teb_config.h>
+#include <teb_local_planner/planner_interface.h>
+#include <teb_local_planner/logging.h>
+#include <teb_local_planner/clock.h>
 
 namespace teb_local_planner
 {
@@ -77,14 +80,14 @@ public:
   
   /**
    * @brief Add a new twist measurement to the internal buffer and compute a new decision
-   * @param twist geometry_msgs::Twist velocity information
+   * @param twist velocity information
    * @param v_max maximum forward translational velocity
    * @param v_backwards_max maximum backward translational velocity
    * @param omega_max maximum angular velocity 
    * @param v_eps Threshold for the average normalized linear velocity in (0,1) that must not be exceded (e.g. 0.1)
    * @param omega_eps Threshold for the average normalized angular velocity in (0,1) that must not be exceded (e.g. 0.1)
    */
-  void update(const geometry_msgs::Twist& twist, double v_max, double v_backwards_max, double omega_max, double v_eps, double omega_eps);
+  void update(const Twist2D& twist, double v_max, double v_backwards_max, double omega_max, double v_eps, double omega_eps);
   
   /**
    * @brief Check if the robot got stucked
@@ -129,6 +132,140 @@ private:
 };
 
 
+/**
+ * @class BackupModeManager
+ * @brief Keeps track of the planning history and activates the backup modes of the local planner
+ * 
+ * Two backup modes are supported:
+ * - Reduced horizon: the local plan is shortened for a while after an infeasible trajectory has been detected
+ *   (refer to TebConfig::Recovery::shrink_horizon_backup)
+ * - Oscillation recovery: the current turning direction is preferred if the FailureDetector
+ *   detects oscillations (refer to TebConfig::Recovery::oscillation_recovery)
+ * 
+ * The class does not depend on ROS, hence it is shared between TebLocalPlannerROS
+ * and headless tools such as the closed-loop simulation.
+ * Time stamps are obtained from the clock passed to initialize() or, by default, from the global clock returned by getClock().
+ */
+class BackupModeManager
+{
+public:
+  
+  /**
+   * @brief Default constructor
+   */
+  BackupModeManager();
+  
+  /**
+   * @brief Initialize the manager
+   * @param cfg const reference to the TebConfig class for parameters
+   * @param oscillation_buffer_length number of velocity commands that are analyzed by the FailureDetector
+   * @param clock time source (optional, the global clock returned by getClock() is used if empty)
+   */
+  void initialize(const TebConfig& cfg, int oscillation_buffer_length, const ClockPtr& clock = ClockPtr());
+  
+  /**
+   * @brief Report that the planner failed to find a feasible trajectory in the current cycle
+   */
+  void notifyInfeasiblePlan();
+  
+  /**
+   * @brief Report that the planner found a feasible trajectory in the current cycle
+   */
+  void notifyFeasiblePlan() {no_infeasible_plans_ = 0;}
+  
+  /**
+   * @brief Shorten the local plan if the reduced horizon backup mode is active
+   * @param[in,out] local_plan local plan (must support size() and erase(), e.g. PoseSE2Container)
+   * @param[in,out] goal_idx index of the current (local) goal pose in the global plan
+   * @tparam PlanContainer container type of the local plan
+   * @return \c true if the horizon has been reduced, \c false otherwise
+   */
+  template <typename PlanContainer>
+  bool shrinkHorizon(PlanContainer& local_plan, int& goal_idx);
+  
+  /**
+   * @brief Detect oscillations and set the preferred turning direction of the planner accordingly
+   * @param last_cmd last velocity command sent to the robot
+   * @param robot_vel current velocity of the robot
+   * @param planner planner whose preferred turning direction should be updated
+   * @return \c true if the oscillation recovery has been activated in this cycle, \c false otherwise
+   */
+  bool updateOscillationRecovery(const Twist2D& last_cmd, const Twist2D& robot_vel, PlannerInterface& planner);
+  
+  /**
+   * @brief Return the number of consecutive planning cycles without a feasible trajectory
+   */
+  int getNoInfeasiblePlans() const {return no_infeasible_plans_;}
+  
+  /**
+   * @brief Return the currently preferred turning direction (RotType::none if oscillation recovery is inactive)
+   */
+  RotType getPreferredTurningDir() const {return last_preferred_rotdir_;}
+  
+  /**
+   * @brief Reset the planning history
+   */
+  void reset();
+  
+private:
+  
+  /**
+   * @brief Get the current time from the clock of this manager (or the global clock)
+   */
+  double now() const {return clock_ ? clock_->now() : getClock()->now();}
+  
+  const TebConfig* cfg_; //!< Config class that stores and manages all related parameters
+  ClockPtr clock_; //!< Time source (empty: use the global clock)
+  FailureDetector failure_detector_; //!< Detect if the robot got stucked
+  int no_infeasible_plans_; //!< Store how many times in a row the planner failed to find a feasible plan.
+  double time_last_infeasible_plan_; //!< Store at which time stamp the last infeasible plan was detected
+  double time_last_oscillation_; //!< Store at which time stamp the last oscillation was detected
+  RotType last_preferred_rotdir_; //!< Store recent preferred turning direction
+};
+
+
+template <typename PlanContainer>
+bool BackupModeManager::shrinkHorizon(PlanContainer& local_plan, int& goal_idx)
+{
+  if (!cfg_ || !cfg_->recovery.shrink_horizon_backup)
+    return false;
+  
+  // we do not reduce if the goal is already selected (because the orientation might change -> can introduce oscillations)
+  if (goal_idx >= (int)local_plan.size()-1)
+    return false;
+  
+  // keep short horizon for at least a few seconds
+  if (no_infeasible_plans_==0 && now() - time_last_infeasible_plan_ >= cfg_->recovery.shrink_horizon_min_duration)
+    return false;
+  
+  TEB_INFO_COND(no_infeasible_plans_==1, "Activating reduced horizon backup mode for at least %.2f sec (infeasible trajectory detected).", cfg_->recovery.shrink_horizon_min_duration);
+  
+  // Shorten horizon if requested
+  // reduce to 50 percent:
+  int horizon_reduction = goal_idx/2;
+  
+  if (no_infeasible_plans_ > 9)
+  {
+    TEB_INFO_COND(no_infeasible_plans_==10, "Infeasible trajectory detected 10 times in a row: further reducing horizon...");
+    horizon_reduction /= 2;
+  }
+  
+  // we have a small overhead here, since we already transformed 50% more of the trajectory.
+  // But that's ok for now, since we do not need to make the plan extraction more complex 
+  // and a reduced horizon should occur just rarely.
+  int new_goal_idx_local_plan = int(local_plan.size()) - horizon_reduction - 1;
+  goal_idx -= horizon_reduction;
+  if (new_goal_idx_local_plan>0 && goal_idx >= 0)
+  {
+    local_plan.erase(local_plan.begin()+new_goal_idx_local_plan, local_plan.end());
+    return true;
+  }
+  
+  goal_idx += horizon_reduction; // this should not happen, but safety first ;-) 
+  return false;
+}
+
+
 } // namespace teb_local_planner
 
 #endif /* RECOVERY_BEHAVIORS_H__ */
@@ -0,0 +1,154 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef REEDS_SHEPP_PATH_H_
+#define REEDS_SHEPP_PATH_H_
+
+#include <teb_local_planner/pose_se2.h>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @class ReedsSheppPath
+ * @brief Shortest path between two poses of a car-like robot with a bounded turning radius
+ * 
+ * The path consists of up to five segments, each of them is either a circular arc with the minimum
+ * turning radius or a straight line. If backwards motion is allowed, the shortest Reeds-Shepp path
+ * is determined (segments might be traversed backwards, connected by cusps). Otherwise only the six
+ * forward words of the Dubins car are considered.
+ * 
+ * The formulas follow the paper of Reeds and Shepp [1] (with the correction of formula 8.11 that is also
+ * applied by the OMPL implementation) and Shkel and Lumelsky [2] respectively.
+ * 
+ * [1] J. A. Reeds and L. A. Shepp: Optimal paths for a car that goes both forwards and backwards. Pacific Journal of Mathematics, 1990.
+ * [2] A. M. Shkel and V. Lumelsky: Classification of the Dubins set. Robotics and Autonomous Systems, 2001.
+ */
+class ReedsSheppPath
+{
+public:
+  
+  //! Type of a single path segment
+  enum SegmentType
+  {
+    NOP = 0, //!< Unused segment
+    LEFT, //!< Left turn with the minimum turning radius
+    STRAIGHT, //!< Straight line
+    RIGHT //!< Right turn with the minimum turning radius
+  };
+  
+  /**
+   * @brief Default constructor (empty path)
+   */
+  ReedsSheppPath();
+  
+  /**
+   * @brief Compute the shortest path between two poses
+   * @param start start pose
+   * @param goal goal pose
+   * @param turning_radius minimum turning radius [m] (must be positive)
+   * @param allow_backwards if \c true, the shortest Reeds-Shepp path is computed, otherwise the shortest Dubins path
+   * @return \c true if a path has been found, \c false otherwise
+   */
+  bool compute(const PoseSE2& start, const PoseSE2& goal, double turning_radius, bool allow_backwards);
+  
+  /**
+   * @brief Get the length of the path
+   * @return path length [m] (the sum of the absolute lengths of all segments)
+   */
+  double length() const {return length_ * radius_;}
+  
+  /**
+   * @brief Get the number of (non-empty) path segments
+   */
+  int numberOfSegments() const;
+  
+  /**
+   * @brief Get the type of a segment
+   * @param index segment index [0, numberOfSegments())
+   */
+  SegmentType segmentType(int index) const {return types_[index];}
+  
+  /**
+   * @brief Get the signed length of a segment
+   * @param index segment index [0, numberOfSegments())
+   * @return segment length [m], negative values refer to backwards motion
+   */
+  double segmentLength(int index) const {return lengths_[index] * radius_;}
+  
+  /**
+   * @brief Get the pose after traveling the given distance along the path
+   * @param s distance along the path [m], the value is bounded to [0, length()]
+   * @return pose at \c s
+   */
+  PoseSE2 interpolate(double s) const;
+  
+  /**
+   * @brief Sample the path
+   * 
+   * Each segment is subdivided uniformly, such that the spacing does not exceed the given step widths.
+   * The segment ends (e.g. cusps) are always included. The sequence starts with the start pose and ends
+   * exactly at the goal pose. The samples are appended to \c poses.
+   * @param step_forward maximum spacing of samples along forward segments [m]
+   * @param step_backward maximum spacing of samples along backward segments [m]
+   * @param[out] poses container to which the samples are appended
+   */
+  void sample(double step_forward, double step_backward, PoseSE2Container& poses) const;
+  
+private:
+  
+  /**
+   * @brief Apply a segment (in normalized coordinates) to a pose (in normalized coordinates)
+   */
+  static void applySegment(SegmentType type, double length, double& x, double& y, double& theta);
+  
+  PoseSE2 start_; //!< Start pose of the path
+  PoseSE2 goal_; //!< Goal pose of the path
+  double radius_; //!< Turning radius that normalizes the segment lengths
+  SegmentType types_[5]; //!< Segment types (unused segments are marked with NOP)
+  double lengths_[5]; //!< Signed segment lengths normalized by the turning radius
+  double length_; //!< Total normalized path length
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+} // namespace teb_local_planner
+
+#endif /* REEDS_SHEPP_PATH_H_ */
@@ -0,0 +1,177 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef REPLANNING_MONITOR_H_
+#define REPLANNING_MONITOR_H_
+
+#include <teb_local_planner/pose_se2.h>
+#include <teb_local_planner/teb_config.h>
+#include <teb_local_planner/obstacles.h>
+#include <teb_local_planner/optimal_planner.h>
+#include <teb_local_planner/planner_interface.h>
+
+#include <cstddef>
+
+
+namespace teb_local_planner
+{
+
+//! Optimization effort selected by the ReplanningMonitor for the current control cycle
+enum class ReplanningDecision
+{
+  FullOptimization, //!< Call PlannerInterface::plan() (exploration, resizing and all solver iterations)
+  Refinement, //!< Call PlannerInterface::refine() in order to warm-start and cheaply refine the previous trajectory
+  Speculative //!< Use the result of the speculative optimization of the previous cycle (refer to SpeculativePlanner), evaluate() is not called
+};
+
+
+/**
+ * @class ReplanningMonitor
+ * @brief Detects control cycles in which a full trajectory optimization is not required
+ * 
+ * Usually the complete optimization is repeated in each control cycle, even if the robot tracks the previous trajectory
+ * well and the environment did not change at all (e.g. while driving along an empty corridor).
+ * The monitor compares the current planning problem with the problem of the last full optimization:
+ * - Fingerprints (hash values) of the obstacles and via-points are compared. Coordinates are quantized with
+ *   TebConfig::Replanning::change_resolution in order to tolerate numerical noise.
+ *   Dynamic obstacles change their fingerprint as soon as they move.
+ * - The local goal must not be displaced more than TebConfig::Replanning::goal_change_dist and goal_change_angle.
+ * - The robot pose must be close to the previously planned trajectory (refer to PlannerInterface::computeTrackingError()).
+ * - At most TebConfig::Replanning::max_refinements consecutive cycles are refined (e.g. in order to explore new homotopy classes).
+ * 
+ * If none of the conditions is violated, the previous trajectory is only refined (ReplanningDecision::Refinement).
+ * 
+ * Usage (once per control cycle):
+ * @code
+ *   ReplanningDecision decision = monitor.evaluate(*planner, robot_pose, goal, obstacles, &via_points);
+ *   bool success = decision == ReplanningDecision::Refinement ? planner->refine(plan, &vel) : planner->plan(plan, &vel);
+ *   monitor.notifyPlanned(decision, success); // call notifyPlanned(decision, false) if the trajectory is rejected later
+ * @endcode
+ * 
+ * The class does not depend on ROS, hence it is shared between TebLocalPlannerROS
+ * and headless tools such as the closed-loop simulation.
+ */
+class ReplanningMonitor
+{
+public:
+  
+  /**
+   * @brief Default constructor
+   */
+  ReplanningMonitor();
+  
+  /**
+   * @brief Initialize the monitor
+   * @param cfg const reference to the TebConfig class for parameters
+   */
+  void initialize(const TebConfig& cfg);
+  
+  /**
+   * @brief Decide whether the current control cycle requires a full optimization
+   * 
+   * Always returns ReplanningDecision::FullOptimization if TebConfig::Replanning::event_driven is disabled.
+   * @param planner planner that stores the trajectory of the previous cycle
+   * @param robot_pose current pose of the robot
+   * @param goal current (local) goal pose
+   * @param obstacles current obstacle container
+   * @param via_points current via-points (optional)
+   * @return selected optimization effort
+   */
+  ReplanningDecision evaluate(const PlannerInterface& planner, const PoseSE2& robot_pose, const PoseSE2& goal,
+                              const ObstContainer& obstacles, const ViaPointContainer* via_points = NULL);
+  
+  /**
+   * @brief Report the result of the planning step that followed the last evaluate() call
+   * 
+   * A successful full optimization becomes the new reference for the change detection.
+   * An unsuccessful cycle (failed optimization, infeasible trajectory or invalid command) enforces a full optimization next time.
+   * A successful speculative cycle neither counts as refinement nor changes the reference problem.
+   * @param decision decision returned by evaluate()
+   * @param success \c true if the resulting trajectory is accepted, \c false otherwise
+   */
+  void notifyPlanned(ReplanningDecision decision, bool success);
+  
+  /**
+   * @brief Return the number of consecutive refinements since the last full optimization
+   */
+  int getNoRefinements() const {return no_refinements_;}
+  
+  /**
+   * @brief Enforce a full optimization in the next cycle (e.g. after the planner has been reset)
+   */
+  void reset();
+  
+  /**
+   * @brief Compute the fingerprint of an obstacle container
+   * 
+   * The fingerprint covers the type, the geometry, the (quantized) velocity and the order of all obstacles.
+   * @param obstacles obstacle container
+   * @param resolution coordinates are rounded to multiples of this value [m]
+   * @return hash value
+   */
+  static std::size_t computeFingerprint(const ObstContainer& obstacles, double resolution);
+  
+  /**
+   * @brief Compute the fingerprint of a via-point container
+   * @param via_points via-point container
+   * @param resolution coordinates are rounded to multiples of this value [m]
+   * @return hash value
+   */
+  static std::size_t computeFingerprint(const ViaPointContainer& via_points, double resolution);
+  
+private:
+  
+  const TebConfig* cfg_; //!< Config class that stores and manages all related parameters
+  
+  bool reference_valid_; //!< \c true if the reference problem below belongs to an accepted full optimization
+  std::size_t obstacle_fingerprint_; //!< Obstacle fingerprint of the last full optimization
+  std::size_t via_point_fingerprint_; //!< Via-point fingerprint of the last full optimization
+  PoseSE2 goal_; //!< Local goal of the last full optimization
+  int no_refinements_; //!< Number of consecutive refinements since the last full optimization
+  
+  std::size_t pending_obstacle_fingerprint_; //!< Obstacle fingerprint of the current cycle (becomes the reference after a successful full optimization)
+  std::size_t pending_via_point_fingerprint_; //!< Via-point fingerprint of the current cycle
+  PoseSE2 pending_goal_; //!< Local goal of the current cycle
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+} // namespace teb_local_planner
+
+#endif /* REPLANNING_MONITOR_H_ */
@@ -42,7 +42,8 @@
 
 #include <teb_local_planner/pose_se2.h>
 #include <teb_local_planner/obstacles.h>
-#include <visualization_msgs/Marker.h>
+
+#include <typeinfo>
 
 namespace teb_local_planner
 {
@@ -92,15 +93,35 @@ public:
   virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Obstacle* obstacle, double t) const = 0;
 
   /**
-    * @brief Visualize the robot using a markers
+    * @brief Calculate the distance between the robot and an obstacle given a precomputed orientation
     * 
-    * Fill a marker message with all necessary information (type, pose, scale and color).
-    * The header, namespace, id and marker lifetime will be overwritten.
+    * Models that depend on the orientation of the robot override this method in order to avoid
+    * recomputing cos/sin of the yaw angle (e.g. if the pose is stored in a VertexPose, which caches them).
+    * The default implementation ignores \c orientation.
     * @param current_pose Current robot pose
-    * @param[out] markers container of marker messages describing the robot shape
-    * @param color Color of the footprint
+    * @param orientation Unit vector of the orientation of \c current_pose: [cos(theta), sin(theta)]^T
+    * @param obstacle Pointer to the obstacle
+    * @return Euclidean distance to the robot
     */
-  virtual void visualizeRobot(const PoseSE2& current_pose, std::vector<visualization_msgs::Marker>& markers, const std_msgs::ColorRGBA& color) const {}
+  virtual double calculateDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle) const
+  {
+    return calculateDistance(current_pose, obstacle);
+  }
+
+  /**
+    * @brief Estimate the distance between the robot and the predicted location of an obstacle at time t given a precomputed orientation
+    * @see calculateDistance(const PoseSE2&, const Eigen::Vector2d&, const Obstacle*) const
+    * @param current_pose robot pose, from which the distance to the obstacle is estimated
+    * @param orientation Unit vector of the orientation of \c current_pose: [cos(theta), sin(theta)]^T
+    * @param obstacle Pointer to the dynamic obstacle (constant velocity model is assumed)
+    * @param t time, for which the predicted distance to the obstacle is calculated
+    * @return Euclidean distance to the robot
+    */
+  virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle, double t) const
+  {
+    return estimateSpatioTemporalDistance(current_pose, obstacle, t);
+  }
+
   
   
   /**
@@ -108,6 +129,14 @@ public:
    * @return inscribed radius
    */
   virtual double getInscribedRadius() = 0;
+  
+  /**
+   * @brief Compute the circumscribed radius of the footprint model (w.r.t. the robot center)
+   * @remarks The default implementation returns -1, override it in user defined models in order to enable
+   *          functions that depend on it (e.g. the ObstacleCorridorFilter).
+   * @return radius of the smallest circle around the robot center that contains the footprint, or a negative value if unknown
+   */
+  virtual double getCircumscribedRadius() const {return -1;}
 
 	
 
@@ -156,6 +185,18 @@ public:
     return obstacle->getMinimumDistance(current_pose.position());
   }
   
+  /**
+    * @brief Calculate the distance between the robot and an obstacle given a precomputed orientation (the orientation is not required)
+    * @param current_pose Current robot pose
+    * @param orientation Unit vector of the orientation of \c current_pose (ignored)
+    * @param obstacle Pointer to the obstacle
+    * @return Euclidean distance to the robot
+    */
+  virtual double calculateDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle) const
+  {
+    return obstacle->getMinimumDistance(current_pose.position());
+  }
+  
   /**
     * @brief Estimate the distance between the robot and the predicted location of an obstacle at time t
     * @param current_pose robot pose, from which the distance to the obstacle is estimated
@@ -167,12 +208,31 @@ public:
   {
     return obstacle->getMinimumSpatioTemporalDistance(current_pose.position(), t);
   }
+  
+  /**
+    * @brief Estimate the distance between the robot and the predicted location of an obstacle at time t given a precomputed orientation (the orientation is not required)
+    * @param current_pose robot pose, from which the distance to the obstacle is estimated
+    * @param orientation Unit vector of the orientation of \c current_pose (ignored)
+    * @param obstacle Pointer to the dynamic obstacle (constant velocity model is assumed)
+    * @param t time, for which the predicted distance to the obstacle is calculated
+    * @return Euclidean distance to the robot
+    */
+  virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle, double t) const
+  {
+    return obstacle->getMinimumSpatioTemporalDistance(current_pose.position(), t);
+  }
 
   /**
    * @brief Compute the inscribed radius of the footprint model
    * @return inscribed radius
    */
   virtual double getInscribedRadius() {return 0.0;}
+  
+  /**
+   * @brief Compute the circumscribed radius of the footprint model
+   * @return circumscribed radius
+   */
+  virtual double getCircumscribedRadius() const {return 0.0;}
 
 };
 
@@ -202,6 +262,12 @@ public:
     */
   void setRadius(double radius) {radius_ = radius;}
   
+  /**
+   * @brief Get the radius of the circular robot model
+   * @return radius
+   */
+  double getRadius() const {return radius_;}
+  
   /**
     * @brief Calculate the distance between the robot and an obstacle
     * @param current_pose Current robot pose
@@ -212,6 +278,18 @@ public:
   {
     return obstacle->getMinimumDistance(current_pose.position()) - radius_;
   }
+  
+  /**
+    * @brief Calculate the distance between the robot and an obstacle given a precomputed orientation (the orientation is not required)
+    * @param current_pose Current robot pose
+    * @param orientation Unit vector of the orientation of \c current_pose (ignored)
+    * @param obstacle Pointer to the obstacle
+    * @return Euclidean distance to the robot
+    */
+  virtual double calculateDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle) const
+  {
+    return obstacle->getMinimumDistance(current_pose.position()) - radius_;
+  }
 
   /**
     * @brief Estimate the distance between the robot and the predicted location of an obstacle at time t
@@ -224,32 +302,32 @@ public:
   {
     return obstacle->getMinimumSpatioTemporalDistance(current_pose.position(), t) - radius_;
   }
-
+  
   /**
-    * @brief Visualize the robot using a markers
-    * 
-    * Fill a marker message with all necessary information (type, pose, scale and color).
-    * The header, namespace, id and marker lifetime will be overwritten.
-    * @param current_pose Current robot pose
-    * @param[out] markers container of marker messages describing the robot shape
-    * @param color Color of the footprint
+    * @brief Estimate the distance between the robot and the predicted location of an obstacle at time t given a precomputed orientation (the orientation is not required)
+    * @param current_pose robot pose, from which the distance to the obstacle is estimated
+    * @param orientation Unit vector of the orientation of \c current_pose (ignored)
+    * @param obstacle Pointer to the dynamic obstacle (constant velocity model is assumed)
+    * @param t time, for which the predicted distance to the obstacle is calculated
+    * @return Euclidean distance to the robot
     */
-  virtual void visualizeRobot(const PoseSE2& current_pose, std::vector<visualization_msgs::Marker>& markers, const std_msgs::ColorRGBA& color) const
+  virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle, double t) const
   {
-    markers.resize(1);
-    visualization_msgs::Marker& marker = markers.back();
-    marker.type = visualization_msgs::Marker::CYLINDER;
-    current_pose.toPoseMsg(marker.pose);
-    marker.scale.x = marker.scale.y = 2*radius_; // scale = diameter
-    marker.scale.z = 0.05;
-    marker.color = color;
+    return obstacle->getMinimumSpatioTemporalDistance(current_pose.position(), t) - radius_;
   }
+
   
   /**
    * @brief Compute the inscribed radius of the footprint model
    * @return inscribed radius
    */
   virtual double getInscribedRadius() {return radius_;}
+  
+  /**
+   * @brief Compute the circumscribed radius of the footprint model
+   * @return circumscribed radius
+   */
+  virtual double getCircumscribedRadius() const {return radius_;}
 
 private:
     
@@ -290,6 +368,11 @@ public:
   void setParameters(double front_offset, double front_radius, double rear_offset, double rear_radius) 
   {front_offset_=front_offset; front_radius_=front_radius; rear_offset_=rear_offset; rear_radius_=rear_radius;}
   
+  double getFrontOffset() const {return front_offset_;} //!< Get the distance between the center of the robot and the center of the front circle
+  double getFrontRadius() const {return front_radius_;} //!< Get the radius of the front circle
+  double getRearOffset() const {return rear_offset_;} //!< Get the distance between the center of the robot and the center of the rear circle
+  double getRearRadius() const {return rear_radius_;} //!< Get the radius of the rear circle
+  
   /**
     * @brief Calculate the distance between the robot and an obstacle
     * @param current_pose Current robot pose
@@ -298,9 +381,20 @@ public:
     */
   virtual double calculateDistance(const PoseSE2& current_pose, const Obstacle* obstacle) const
   {
-    Eigen::Vector2d dir = current_pose.orientationUnitVec();
-    double dist_front = obstacle->getMinimumDistance(current_pose.position() + front_offset_*dir) - front_radius_;
-    double dist_rear = obstacle->getMinimumDistance(current_pose.position() - rear_offset_*dir) - rear_radius_;
+    return calculateDistance(current_pose, current_pose.orientationUnitVec(), obstacle);
+  }
+  
+  /**
+    * @brief Calculate the distance between the robot and an obstacle given a precomputed orientation
+    * @param current_pose Current robot pose
+    * @param orientation Unit vector of the orientation of \c current_pose
+    * @param obstacle Pointer to the obstacle
+    * @return Euclidean distance to the robot
+    */
+  virtual double calculateDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle) const
+  {
+    double dist_front = obstacle->getMinimumDistance(current_pose.position() + front_offset_*orientation) - front_radius_;
+    double dist_rear = obstacle->getMinimumDistance(current_pose.position() - rear_offset_*orientation) - rear_radius_;
     return std::min(dist_front, dist_rear);
   }
 
@@ -313,50 +407,24 @@ public:
     */
   virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Obstacle* obstacle, double t) const
   {
-    Eigen::Vector2d dir = current_pose.orientationUnitVec();
-    double dist_front = obstacle->getMinimumSpatioTemporalDistance(current_pose.position() + front_offset_*dir, t) - front_radius_;
-    double dist_rear = obstacle->getMinimumSpatioTemporalDistance(current_pose.position() - rear_offset_*dir, t) - rear_radius_;
-    return std::min(dist_front, dist_rear);
+    return estimateSpatioTemporalDistance(current_pose, current_pose.orientationUnitVec(), obstacle, t);
   }
-
+  
   /**
-    * @brief Visualize the robot using a markers
-    * 
-    * Fill a marker message with all necessary information (type, pose, scale and color).
-    * The header, namespace, id and marker lifetime will be overwritten.
-    * @param current_pose Current robot pose
-    * @param[out] markers container of marker messages describing the robot shape
-    * @param color Color of the footprint
+    * @brief Estimate the distance between the robot and the predicted location of an obstacle at time t given a precomputed orientation
+    * @param current_pose robot pose, from which the distance to the obstacle is estimated
+    * @param orientation Unit vector of the orientation of \c current_pose
+    * @param obstacle Pointer to the dynamic obstacle (constant velocity model is assumed)
+    * @param t time, for which the predicted distance to the obstacle is calculated
+    * @return Euclidean distance to the robot
     */
-  virtual void visualizeRobot(const PoseSE2& current_pose, std::vector<visualization_msgs::Marker>& markers, const std_msgs::ColorRGBA& color) const
-  {    
-    Eigen::Vector2d dir = current_pose.orientationUnitVec();
-    if (front_radius_>0)
-    {
-      markers.push_back(visualization_msgs::Marker());
-      visualization_msgs::Marker& marker1 = markers.front();
-      marker1.type = visualization_msgs::Marker::CYLINDER;
-      current_pose.toPoseMsg(marker1.pose);
-      marker1.pose.position.x += front_offset_*dir.x();
-      marker1.pose.position.y += front_offset_*dir.y();
-      marker1.scale.x = marker1.scale.y = 2*front_radius_; // scale = diameter
-//       marker1.scale.z = 0.05;
-      marker1.color = color;
-
-    }
-    if (rear_radius_>0)
-    {
-      markers.push_back(visualization_msgs::Marker());
-      visualization_msgs::Marker& marker2 = markers.back();
-      marker2.type = visualization_msgs::Marker::CYLINDER;
-      current_pose.toPoseMsg(marker2.pose);
-      marker2.pose.position.x -= rear_offset_*dir.x();
-      marker2.pose.position.y -= rear_offset_*dir.y();
-      marker2.scale.x = marker2.scale.y = 2*rear_radius_; // scale = diameter
-//       marker2.scale.z = 0.05;
-      marker2.color = color;
-    }
+  virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle, double t) const
+  {
+    double dist_front = obstacle->getMinimumSpatioTemporalDistance(current_pose.position() + front_offset_*orientation, t) - front_radius_;
+    double dist_rear = obstacle->getMinimumSpatioTemporalDistance(current_pose.position() - rear_offset_*orientation, t) - rear_radius_;
+    return std::min(dist_front, dist_rear);
   }
+
   
   /**
    * @brief Compute the inscribed radius of the footprint model
@@ -368,6 +436,15 @@ public:
       double min_lateral = std::min(rear_radius_, front_radius_);
       return std::min(min_longitudinal, min_lateral);
   }
+  
+  /**
+   * @brief Compute the circumscribed radius of the footprint model
+   * @return circumscribed radius
+   */
+  virtual double getCircumscribedRadius() const
+  {
+      return std::max(std::abs(front_offset_) + front_radius_, std::abs(rear_offset_) + rear_radius_);
+  }
 
 private:
     
@@ -388,16 +465,6 @@ class LineRobotFootprint : public BaseRobotFootprintModel
 {
 public:
   
-  /**
-    * @brief Default constructor of the abstract obstacle class
-    * @param line_start start coordinates (only x and y) of the line (w.r.t. robot center at (0,0))
-    * @param line_end end coordinates (only x and y) of the line (w.r.t. robot center at (0,0))
-    */
-  LineRobotFootprint(const geometry_msgs::Point& line_start, const geometry_msgs::Point& line_end)
-  {
-    setLine(line_start, line_end);
-  }
-  
   /**
   * @brief Default constructor of the abstract obstacle class (Eigen Version)
   * @param line_start start coordinates (only x and y) of the line (w.r.t. robot center at (0,0))
@@ -413,18 +480,6 @@ public:
    */
   virtual ~LineRobotFootprint() { }
 
-  /**
-   * @brief Set vertices of the contour/footprint
-   * @param vertices footprint vertices (only x and y) around the robot center (0,0) (do not repeat the first and last vertex at the end)
-   */
-  void setLine(const geometry_msgs::Point& line_start, const geometry_msgs::Point& line_end)
-  {
-    line_start_.x() = line_start.x; 
-    line_start_.y() = line_start.y; 
-    line_end_.x() = line_end.x;
-    line_end_.y() = line_end.y;
-  }
-  
   /**
    * @brief Set vertices of the contour/footprint (Eigen version)
    * @param vertices footprint vertices (only x and y) around the robot center (0,0) (do not repeat the first and last vertex at the end)
@@ -435,6 +490,9 @@ public:
     line_end_ = line_end;
   }
   
+  const Eigen::Vector2d& getLineStart() const {return line_start_;} //!< Get the start of the line (w.r.t. robot center at (0,0))
+  const Eigen::Vector2d& getLineEnd() const {return line_end_;} //!< Get the end of the line (w.r.t. robot center at (0,0))
+  
   /**
     * @brief Calculate the distance between the robot and an obstacle
     * @param current_pose Current robot pose
@@ -442,10 +500,22 @@ public:
     * @return Euclidean distance to the robot
     */
   virtual double calculateDistance(const PoseSE2& current_pose, const Obstacle* obstacle) const
+  {
+    return calculateDistance(current_pose, current_pose.orientationUnitVec(), obstacle);
+  }
+  
+  /**
+    * @brief Calculate the distance between the robot and an obstacle given a precomputed orientation
+    * @param current_pose Current robot pose
+    * @param orientation Unit vector of the orientation of \c current_pose
+    * @param obstacle Pointer to the obstacle
+    * @return Euclidean distance to the robot
+    */
+  virtual double calculateDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle) const
   {
     Eigen::Vector2d line_start_world;
     Eigen::Vector2d line_end_world;
-    transformToWorld(current_pose, line_start_world, line_end_world);
+    transformToWorld(current_pose, orientation, line_start_world, line_end_world);
     return obstacle->getMinimumDistance(line_start_world, line_end_world);
   }
 
@@ -457,45 +527,26 @@ public:
     * @return Euclidean distance to the robot
     */
   virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Obstacle* obstacle, double t) const
+  {
+    return estimateSpatioTemporalDistance(current_pose, current_pose.orientationUnitVec(), obstacle, t);
+  }
+  
+  /**
+    * @brief Estimate the distance between the robot and the predicted location of an obstacle at time t given a precomputed orientation
+    * @param current_pose robot pose, from which the distance to the obstacle is estimated
+    * @param orientation Unit vector of the orientation of \c current_pose
+    * @param obstacle Pointer to the dynamic obstacle (constant velocity model is assumed)
+    * @param t time, for which the predicted distance to the obstacle is calculated
+    * @return Euclidean distance to the robot
+    */
+  virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle, double t) const
   {
     Eigen::Vector2d line_start_world;
     Eigen::Vector2d line_end_world;
-    transformToWorld(current_pose, line_start_world, line_end_world);
+    transformToWorld(current_pose, orientation, line_start_world, line_end_world);
     return obstacle->getMinimumSpatioTemporalDistance(line_start_world, line_end_world, t);
   }
 
-  /**
-    * @brief Visualize the robot using a markers
-    * 
-    * Fill a marker message with all necessary information (type, pose, scale and color).
-    * The header, namespace, id and marker lifetime will be overwritten.
-    * @param current_pose Current robot pose
-    * @param[out] markers container of marker messages describing the robot shape
-    * @param color Color of the footprint
-    */
-  virtual void visualizeRobot(const PoseSE2& current_pose, std::vector<visualization_msgs::Marker>& markers, const std_msgs::ColorRGBA& color) const
-  {   
-    markers.push_back(visualization_msgs::Marker());
-    visualization_msgs::Marker& marker = markers.front();
-    marker.type = visualization_msgs::Marker::LINE_STRIP;
-    current_pose.toPoseMsg(marker.pose); // all points are transformed into the robot frame!
-    
-    // line
-    geometry_msgs::Point line_start_world;
-    line_start_world.x = line_start_.x();
-    line_start_world.y = line_start_.y();
-    line_start_world.z = 0;
-    marker.points.push_back(line_start_world);
-    
-    geometry_msgs::Point line_end_world;
-    line_end_world.x = line_end_.x();
-    line_end_world.y = line_end_.y();
-    line_end_world.z = 0;
-    marker.points.push_back(line_end_world);
-
-    marker.scale.x = 0.05; 
-    marker.color = color;
-  }
   
   /**
    * @brief Compute the inscribed radius of the footprint model
@@ -505,19 +556,29 @@ public:
   {
       return 0.0; // lateral distance = 0.0
   }
+  
+  /**
+   * @brief Compute the circumscribed radius of the footprint model
+   * @return circumscribed radius
+   */
+  virtual double getCircumscribedRadius() const
+  {
+      return std::max(line_start_.norm(), line_end_.norm());
+  }
 
 private:
     
   /**
     * @brief Transforms a line to the world frame manually
     * @param current_pose Current robot pose
+    * @param orientation Unit vector of the orientation of \c current_pose: [cos(theta), sin(theta)]^T
     * @param[out] line_start line_start_ in the world frame
     * @param[out] line_end line_end_ in the world frame
     */
-  void transformToWorld(const PoseSE2& current_pose, Eigen::Vector2d& line_start_world, Eigen::Vector2d& line_end_world) const
+  void transformToWorld(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, Eigen::Vector2d& line_start_world, Eigen::Vector2d& line_end_world) const
   {
-    double cos_th = std::cos(current_pose.theta());
-    double sin_th = std::sin(current_pose.theta());
+    double cos_th = orientation.x();
+    double sin_th = orientation.y();
     line_start_world.x() = current_pose.x() + cos_th * line_start_.x() - sin_th * line_start_.y();
     line_start_world.y() = current_pose.y() + sin_th * line_start_.x() + cos_th * line_start_.y();
     line_end_world.x() = current_pose.x() + cos_th * line_end_.x() - sin_th * line_end_.y();
@@ -561,6 +622,12 @@ public:
    */
   void setVertices(const Point2dContainer& vertices) {vertices_ = vertices;}
   
+  /**
+   * @brief Get vertices of the contour/footprint
+   * @return footprint vertices around the robot center (0,0)
+   */
+  const Point2dContainer& getVertices() const {return vertices_;}
+  
   /**
     * @brief Calculate the distance between the robot and an obstacle
     * @param current_pose Current robot pose
@@ -568,9 +635,21 @@ public:
     * @return Euclidean distance to the robot
     */
   virtual double calculateDistance(const PoseSE2& current_pose, const Obstacle* obstacle) const
+  {
+    return calculateDistance(current_pose, current_pose.orientationUnitVec(), obstacle);
+  }
+  
+  /**
+    * @brief Calculate the distance between the robot and an obstacle given a precomputed orientation
+    * @param current_pose Current robot pose
+    * @param orientation Unit vector of the orientation of \c current_pose
+    * @param obstacle Pointer to the obstacle
+    * @return Euclidean distance to the robot
+    */
+  virtual double calculateDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle) const
   {
     Point2dContainer polygon_world(vertices_.size());
-    transformToWorld(current_pose, polygon_world);
+    transformToWorld(current_pose, orientation, polygon_world);
     return obstacle->getMinimumDistance(polygon_world);
   }
 
@@ -583,49 +662,24 @@ public:
     */
   virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Obstacle* obstacle, double t) const
   {
-    Point2dContainer polygon_world(vertices_.size());
-    transformToWorld(current_pose, polygon_world);
-    return obstacle->getMinimumSpatioTemporalDistance(polygon_world, t);
+    return estimateSpatioTemporalDistance(current_pose, current_pose.orientationUnitVec(), obstacle, t);
   }
-
+  
   /**
-    * @brief Visualize the robot using a markers
-    * 
-    * Fill a marker message with all necessary information (type, pose, scale and color).
-    * The header, namespace, id and marker lifetime will be overwritten.
-    * @param current_pose Current robot pose
-    * @param[out] markers container of marker messages describing the robot shape
-    * @param color Color of the footprint
+    * @brief Estimate the distance between the robot and the predicted location of an obstacle at time t given a precomputed orientation
+    * @param current_pose robot pose, from which the distance to the obstacle is estimated
+    * @param orientation Unit vector of the orientation of \c current_pose
+    * @param obstacle Pointer to the dynamic obstacle (constant velocity model is assumed)
+    * @param t time, for which the predicted distance to the obstacle is calculated
+    * @return Euclidean distance to the robot
     */
-  virtual void visualizeRobot(const PoseSE2& current_pose, std::vector<visualization_msgs::Marker>& markers, const std_msgs::ColorRGBA& color) const
+  virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle, double t) const
   {
-    if (vertices_.empty())
-      return;
-
-    markers.push_back(visualization_msgs::Marker());
-    visualization_msgs::Marker& marker = markers.front();
-    marker.type = visualization_msgs::Marker::LINE_STRIP;
-    current_pose.toPoseMsg(marker.pose); // all points are transformed into the robot frame!
-    
-    for (std::size_t i = 0; i < vertices_.size(); ++i)
-    {
-      geometry_msgs::Point point;
-      point.x = vertices_[i].x();
-      point.y = vertices_[i].y();
-      point.z = 0;
-      marker.points.push_back(point);
-    }
-    // add first point again in order to close the polygon
-    geometry_msgs::Point point;
-    point.x = vertices_.front().x();
-    point.y = vertices_.front().y();
-    point.z = 0;
-    marker.points.push_back(point);
-
-    marker.scale.x = 0.025; 
-    marker.color = color;
-
+    Point2dContainer polygon_world(vertices_.size());
+    transformToWorld(current_pose, orientation, polygon_world);
+    return obstacle->getMinimumSpatioTemporalDistance(polygon_world, t);
   }
+
   
   /**
    * @brief Compute the inscribed radius of the footprint model
@@ -652,18 +706,31 @@ public:
      double edge_dist = distance_point_to_segment_2d(center, vertices_.back(), vertices_.front());
      return std::min(min_dist, std::min(vertex_dist, edge_dist));
   }
+  
+  /**
+   * @brief Compute the circumscribed radius of the footprint model
+   * @return circumscribed radius
+   */
+  virtual double getCircumscribedRadius() const
+  {
+     double max_dist = 0;
+     for (const Eigen::Vector2d& vertex : vertices_)
+        max_dist = std::max(max_dist, vertex.norm());
+     return max_dist;
+  }
 
 private:
     
   /**
     * @brief Transforms a polygon to the world frame manually
     * @param current_pose Current robot pose
+    * @param orientation Unit vector of the orientation of \c current_pose: [cos(theta), sin(theta)]^T
     * @param[out] polygon_world polygon in the world frame
     */
-  void transformToWorld(const PoseSE2& current_pose, Point2dContainer& polygon_world) const
+  void transformToWorld(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, Point2dContainer& polygon_world) const
   {
-    double cos_th = std::cos(current_pose.theta());
-    double sin_th = std::sin(current_pose.theta());
+    double cos_th = orientation.x();
+    double sin_th = orientation.y();
     for (std::size_t i=0; i<vertices_.size(); ++i)
     {
       polygon_world[i].x() = current_pose.x() + cos_th * vertices_[i].x() - sin_th * vertices_[i].y();
@@ -677,7 +744,245 @@ private:
 
 
 
+/**
+ * @class MultiCirclesRobotFootprint
+ * @brief Class that approximates the robot with an arbitrary number of circles
+ * 
+ * The circles can be specified directly or computed automatically from a footprint polygon (see approximatePolygon()).
+ * The automatic decomposition covers the complete polygon and guarantees that no point of the circles is farther
+ * than the requested over-approximation from the polygon. A distance query costs one point-to-obstacle
+ * distance per circle, which is much cheaper than the polygon-to-obstacle distance of PolygonRobotFootprint.
+ */
+class MultiCirclesRobotFootprint : public BaseRobotFootprintModel
+{
+public:
+  
+  /**
+   * @struct Circle
+   * @brief Circle of the footprint w.r.t. the robot center (0,0)
+   */
+  struct Circle
+  {
+    Circle(const Eigen::Vector2d& center_in = Eigen::Vector2d::Zero(), double radius_in = 0) : center(center_in), radius(radius_in) {}
+    
+    Eigen::Vector2d center; //!< Center of the circle (w.r.t. the robot frame)
+    double radius; //!< Radius of the circle
+    
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+  
+  //! Container of circles
+  typedef std::vector<Circle, Eigen::aligned_allocator<Circle> > CircleContainer;
+  
+  /**
+    * @brief Construct the footprint from a set of circles
+    * @param circles circles around the robot center (0,0)
+    */
+  MultiCirclesRobotFootprint(const CircleContainer& circles) : circles_(circles), approximation_error_(0), inscribed_radius_(-1) { }
+  
+  /**
+    * @brief Construct the footprint by covering a polygon with circles (see approximatePolygon())
+    * @param vertices footprint vertices (only x and y) around the robot center (0,0) (do not repeat the first and last vertex at the end)
+    * @param max_over_approximation maximum distance between any point of the circles and the polygon [m]
+    * @param max_circles maximum number of circles
+    */
+  MultiCirclesRobotFootprint(const Point2dContainer& vertices, double max_over_approximation, int max_circles = 10)
+    : approximation_error_(0), inscribed_radius_(-1)
+  {
+    approximatePolygon(vertices, max_over_approximation, max_circles);
+  }
+  
+  /**
+   * @brief Virtual destructor.
+   */
+  virtual ~MultiCirclesRobotFootprint() { }
+  
+  /**
+   * @brief Cover a polygon with a minimal number of circles
+   * 
+   * A circle whose center lies inside the polygon at distance \f$ d \f$ from its boundary is enlarged to the radius
+   * \f$ d + e \f$, where \f$ e \f$ denotes the allowed over-approximation. No point of such a circle is farther than
+   * \f$ e \f$ from the polygon. The circles are selected greedily from a grid of candidate centers until every cell
+   * of a grid that covers the polygon is contained completely in one of the circles.
+   * If more than \c max_circles circles are required, or if the over-approximation is too small w.r.t. the size of the
+   * polygon (the resolution of the grid is limited), the over-approximation is increased until the polygon is covered.
+   * A warning states the reason.
+   * @param vertices footprint vertices (only x and y) around the robot center (0,0) (do not repeat the first and last vertex at the end)
+   * @param max_over_approximation maximum distance between any point of the circles and the polygon [m]
+   * @param max_circles maximum number of circles
+   * @return \c true if the requested over-approximation is satisfied, \c false if it had to be increased or the polygon is degenerated
+   */
+  bool approximatePolygon(const Point2dContainer& vertices, double max_over_approximation, int max_circles = 10);
+  
+  /**
+   * @brief Set the circles of the footprint
+   * @param circles circles around the robot center (0,0)
+   */
+  void setCircles(const CircleContainer& circles) {circles_ = circles; approximation_error_ = 0; inscribed_radius_ = -1;}
+  
+  /**
+   * @brief Get the circles of the footprint
+   * @return circles around the robot center (0,0)
+   */
+  const CircleContainer& getCircles() const {return circles_;}
+  
+  /**
+   * @brief Get an upper bound of the distance between any point of the circles and the approximated polygon
+   * @return over-approximation [m] (0 if the circles have been specified directly)
+   */
+  double getApproximationError() const {return approximation_error_;}
+  
+  /**
+    * @brief Calculate the distance between the robot and an obstacle
+    * @param current_pose Current robot pose
+    * @param obstacle Pointer to the obstacle
+    * @return Euclidean distance to the robot
+    */
+  virtual double calculateDistance(const PoseSE2& current_pose, const Obstacle* obstacle) const
+  {
+    return calculateDistance(current_pose, current_pose.orientationUnitVec(), obstacle);
+  }
+  
+  /**
+    * @brief Calculate the distance between the robot and an obstacle given a precomputed orientation
+    * @param current_pose Current robot pose
+    * @param orientation Unit vector of the orientation of \c current_pose
+    * @param obstacle Pointer to the obstacle
+    * @return Euclidean distance to the robot
+    */
+  virtual double calculateDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle) const
+  {
+    double dist = std::numeric_limits<double>::max();
+    for (const Circle& circle : circles_)
+      dist = std::min(dist, obstacle->getMinimumDistance(transformToWorld(current_pose, orientation, circle.center)) - circle.radius);
+    return dist;
+  }
+
+  /**
+    * @brief Estimate the distance between the robot and the predicted location of an obstacle at time t
+    * @param current_pose robot pose, from which the distance to the obstacle is estimated
+    * @param obstacle Pointer to the dynamic obstacle (constant velocity model is assumed)
+    * @param t time, for which the predicted distance to the obstacle is calculated
+    * @return Euclidean distance to the robot
+    */
+  virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Obstacle* obstacle, double t) const
+  {
+    return estimateSpatioTemporalDistance(current_pose, current_pose.orientationUnitVec(), obstacle, t);
+  }
+  
+  /**
+    * @brief Estimate the distance between the robot and the predicted location of an obstacle at time t given a precomputed orientation
+    * @param current_pose robot pose, from which the distance to the obstacle is estimated
+    * @param orientation Unit vector of the orientation of \c current_pose
+    * @param obstacle Pointer to the dynamic obstacle (constant velocity model is assumed)
+    * @param t time, for which the predicted distance to the obstacle is calculated
+    * @return Euclidean distance to the robot
+    */
+  virtual double estimateSpatioTemporalDistance(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Obstacle* obstacle, double t) const
+  {
+    double dist = std::numeric_limits<double>::max();
+    for (const Circle& circle : circles_)
+      dist = std::min(dist, obstacle->getMinimumSpatioTemporalDistance(transformToWorld(current_pose, orientation, circle.center), t) - circle.radius);
+    return dist;
+  }
+
+  
+  /**
+   * @brief Compute the inscribed radius of the footprint model
+   * 
+   * If the circles approximate a polygon, the inscribed radius of the polygon is returned.
+   * Otherwise the largest circle that contains the robot center is considered.
+   * @return inscribed radius
+   */
+  virtual double getInscribedRadius() 
+  {
+    if (inscribed_radius_ >= 0)
+      return inscribed_radius_;
+    double radius = 0;
+    for (const Circle& circle : circles_)
+      radius = std::max(radius, circle.radius - circle.center.norm());
+    return radius;
+  }
+  
+  /**
+   * @brief Compute the circumscribed radius of the footprint model
+   * @return circumscribed radius
+   */
+  virtual double getCircumscribedRadius() const
+  {
+    double radius = 0;
+    for (const Circle& circle : circles_)
+      radius = std::max(radius, circle.center.norm() + circle.radius);
+    return radius;
+  }
+
+private:
+    
+  /**
+    * @brief Transforms a point of the robot frame to the world frame
+    * @param current_pose Current robot pose
+    * @param orientation Unit vector of the orientation of \c current_pose: [cos(theta), sin(theta)]^T
+    * @param point point w.r.t. the robot frame
+    * @return point w.r.t. the world frame
+    */
+  static Eigen::Vector2d transformToWorld(const PoseSE2& current_pose, const Eigen::Vector2d& orientation, const Eigen::Vector2d& point)
+  {
+    return Eigen::Vector2d(current_pose.x() + orientation.x() * point.x() - orientation.y() * point.y(),
+                           current_pose.y() + orientation.y() * point.x() + orientation.x() * point.y());
+  }
+
+  CircleContainer circles_; //!< Circles around the robot center
+  double approximation_error_; //!< Upper bound of the over-approximation of the polygon (0 if not approximated)
+  double inscribed_radius_; //!< Inscribed radius of the approximated polygon (negative if the circles have been specified directly)
+  
+};
+
+
+
+
 
+/**
+ * @brief Concrete footprint model types for which the obstacle edges are specialized at compile time
+ * @see footprintType(), EdgeObstacleSpecialized
+ */
+enum class FootprintType
+{
+  Generic, //!< Unknown (e.g. user defined) model, the distance is computed via virtual calls
+  Point, //!< PointRobotFootprint
+  Circular, //!< CircularRobotFootprint
+  TwoCircles, //!< TwoCirclesRobotFootprint
+  Line, //!< LineRobotFootprint
+  Polygon, //!< PolygonRobotFootprint
+  MultiCircles //!< MultiCirclesRobotFootprint
+};
+
+/**
+ * @brief Determine the concrete type of a footprint model
+ * 
+ * Only exact types are matched, since a derived class might override the distance calculation.
+ * @param robot_model footprint model (might be NULL)
+ * @return concrete type or FootprintType::Generic if the type is unknown
+ */
+inline FootprintType footprintType(const BaseRobotFootprintModel* robot_model)
+{
+  if (!robot_model)
+    return FootprintType::Generic;
+  const std::type_info& type = typeid(*robot_model);
+  if (type == typeid(PointRobotFootprint))
+    return FootprintType::Point;
+  if (type == typeid(CircularRobotFootprint))
+    return FootprintType::Circular;
+  if (type == typeid(TwoCirclesRobotFootprint))
+    return FootprintType::TwoCircles;
+  if (type == typeid(LineRobotFootprint))
+    return FootprintType::Line;
+  if (type == typeid(PolygonRobotFootprint))
+    return FootprintType::Polygon;
+  if (type == typeid(MultiCirclesRobotFootprint))
+    return FootprintType::MultiCircles;
+  return FootprintType::Generic;
+}
 
 } // namespace teb_local_planner
 
@@ -0,0 +1,237 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef ROS_ADAPTER_H_
+#define ROS_ADAPTER_H_
+
+// planning core
+#include <teb_local_planner/pose_se2.h>
+#include <teb_local_planner/teb_types.h>
+#include <teb_local_planner/obstacles.h>
+#include <teb_local_planner/robot_footprint_model.h>
+#include <teb_local_planner/collision_checker.h>
+#include <teb_local_planner/logging.h>
+#include <teb_local_planner/clock.h>
+#include <teb_local_planner/visualization.h>
+
+// ros
+#include <tf/transform_datatypes.h>
+#include <base_local_planner/costmap_model.h>
+
+// messages
+#include <geometry_msgs/Pose.h>
+#include <geometry_msgs/PoseStamped.h>
+#include <geometry_msgs/Twist.h>
+#include <geometry_msgs/Polygon.h>
+#include <geometry_msgs/TwistWithCovariance.h>
+#include <teb_local_planner/TrajectoryPointMsg.h>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @class RosLogger
+ * @brief Logger that forwards all messages of the planning core to rosconsole
+ */
+class RosLogger : public Logger
+{
+public:
+  // implements Logger::log()
+  virtual void log(Level level, const char* file, int line, const char* message);
+};
+
+/**
+ * @class RosClock
+ * @brief Clock that returns the ros time (respects simulated time if \e use_sim_time is set)
+ */
+class RosClock : public Clock
+{
+public:
+  // implements Clock::now()
+  virtual double now() const;
+};
+
+/**
+ * @brief Route the logging and timing of the planning core through ROS (RosLogger and RosClock).
+ * 
+ * Call this function once after ros::init() and before any planner is used.
+ */
+void initRosAdapter();
+
+
+/** @name Conversions between core types and ROS messages */
+//@{
+
+/**
+ * @brief Convert a geometry_msgs::Pose to a PoseSE2 (the yaw angle is extracted from the quaternion)
+ * @param pose pose message
+ * @return corresponding planar pose
+ */
+PoseSE2 poseFromMsg(const geometry_msgs::Pose& pose);
+
+/**
+ * @brief Convert a tf::Pose to a PoseSE2 (the yaw angle is extracted from the rotation)
+ * @param pose tf pose
+ * @return corresponding planar pose
+ */
+PoseSE2 poseFromTf(const tf::Pose& pose);
+
+/**
+ * @brief Convert a PoseSE2 to a geometry_msgs::Pose (z is set to zero)
+ * @param pose planar pose
+ * @param[out] pose_msg resulting pose message
+ */
+void poseToMsg(const PoseSE2& pose, geometry_msgs::Pose& pose_msg);
+
+/**
+ * @brief Convert a sequence of stamped poses (e.g. a transformed global plan) to a PoseSE2Container
+ * @param plan pose sequence
+ * @param[out] poses resulting container (previous content is replaced)
+ */
+void planFromMsg(const std::vector<geometry_msgs::PoseStamped>& plan, PoseSE2Container& poses);
+
+/**
+ * @brief Extract the planar components (linear.x, linear.y, angular.z) of a twist message
+ * @param twist twist message
+ * @return planar twist
+ */
+Twist2D twistFromMsg(const geometry_msgs::Twist& twist);
+
+/**
+ * @brief Convert a planar twist to a twist message (all other components are set to zero)
+ * @param twist planar twist
+ * @param[out] twist_msg resulting twist message
+ */
+void twistToMsg(const Twist2D& twist, geometry_msgs::Twist& twist_msg);
+
+/**
+ * @brief Convert a trajectory of the planning core to a sequence of trajectory point messages
+ * @param trajectory trajectory obtained from TebOptimalPlanner::getFullTrajectory()
+ * @param[out] trajectory_msg resulting message sequence
+ */
+void trajectoryToMsg(const TrajectoryPointContainer& trajectory, std::vector<TrajectoryPointMsg>& trajectory_msg);
+
+/**
+ * @brief Convert the obstacle to a polygon message (refer to Obstacle::toPolygon())
+ * @param obstacle the obstacle
+ * @param[out] polygon the polygon message
+ */
+void obstacleToPolygonMsg(const Obstacle& obstacle, geometry_msgs::Polygon& polygon);
+
+/**
+ * @brief Export the centroid velocity of the obstacle (zero if the obstacle is static)
+ * @param obstacle the obstacle
+ * @param[out] twist_with_covariance velocity message (the covariance is not set)
+ */
+void obstacleToTwistWithCovarianceMsg(const Obstacle& obstacle, geometry_msgs::TwistWithCovariance& twist_with_covariance);
+
+/**
+ * @brief Set the 2d velocity (vx, vy) of the obstacle w.r.t to the centroid from messages
+ * @remarks The obstacle is marked as dynamic only if the velocity is not negligible (@see Obstacle::isDynamic)
+ * @param[in,out] obstacle the obstacle to be modified
+ * @param velocity geometry_msgs::TwistWithCovariance containing the velocity of the obstacle
+ * @param orientation geometry_msgs::Quaternion containing the orientation of the obstacle
+ */
+void setObstacleVelocityFromMsg(Obstacle& obstacle, const geometry_msgs::TwistWithCovariance& velocity, const geometry_msgs::Quaternion& orientation);
+
+//@}
+
+
+/**
+ * @class CostmapCollisionChecker
+ * @brief Validate robot poses against the ROS costmap (implements FootprintCollisionChecker)
+ * 
+ * Infeasible poses are optionally published via TebVisualization::publishInfeasibleRobotPose().
+ */
+class CostmapCollisionChecker : public FootprintCollisionChecker
+{
+public:
+  
+  /**
+   * @brief Construct the collision checker
+   * @param costmap_model Pointer to the costmap model (must remain valid during the lifetime of this object)
+   * @param footprint_spec The specification of the footprint of the robot in world coordinates (stored by reference)
+   * @param inscribed_radius The radius of the inscribed circle of the robot
+   * @param circumscribed_radius The radius of the circumscribed circle of the robot
+   */
+  CostmapCollisionChecker(base_local_planner::CostmapModel* costmap_model, const std::vector<geometry_msgs::Point>& footprint_spec,
+                          double inscribed_radius = 0.0, double circumscribed_radius = 0.0)
+    : costmap_model_(costmap_model), footprint_spec_(footprint_spec), inscribed_radius_(inscribed_radius), circumscribed_radius_(circumscribed_radius) {}
+  
+  /**
+   * @brief Publish infeasible poses (optional)
+   * @param visualization Shared pointer to the TebVisualization class (empty to disable)
+   * @param robot_model Robot model used for visualizing the footprint
+   */
+  void setVisualization(TebVisualizationPtr visualization, RobotFootprintModelPtr robot_model)
+  {
+    visualization_ = visualization;
+    robot_model_ = robot_model;
+  }
+  
+  // implements footprintCost() of the base class
+  virtual double footprintCost(const PoseSE2& pose) const
+  {
+    return costmap_model_->footprintCost(pose.x(), pose.y(), pose.theta(), footprint_spec_, inscribed_radius_, circumscribed_radius_);
+  }
+  
+  // implements getInscribedRadius() of the base class
+  virtual double getInscribedRadius() const {return inscribed_radius_;}
+  
+  // implements infeasiblePoseDetected() of the base class
+  virtual void infeasiblePoseDetected(const PoseSE2& pose) const
+  {
+    if (visualization_ && robot_model_)
+      visualization_->publishInfeasibleRobotPose(pose, *robot_model_);
+  }
+  
+private:
+  
+  base_local_planner::CostmapModel* costmap_model_;
+  const std::vector<geometry_msgs::Point>& footprint_spec_;
+  double inscribed_radius_;
+  double circumscribed_radius_;
+  TebVisualizationPtr visualization_;
+  RobotFootprintModelPtr robot_model_;
+};
+
+
+} // namespace teb_local_planner
+
+#endif /* ROS_ADAPTER_H_ */
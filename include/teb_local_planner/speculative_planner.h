@@ -0,0 +1,179 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef SPECULATIVE_PLANNER_H_
+#define SPECULATIVE_PLANNER_H_
+
+#include <teb_local_planner/pose_se2.h>
+#include <teb_local_planner/teb_types.h>
+#include <teb_local_planner/teb_config.h>
+#include <teb_local_planner/obstacles.h>
+#include <teb_local_planner/planner_interface.h>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/utility.hpp>
+
+#include <cstddef>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @class SpeculativePlanner
+ * @brief Optimizes the trajectory of the next control cycle while the current command is executed
+ * 
+ * Right after a velocity command has been issued, the start state of the next control cycle can be predicted
+ * from the current trajectory (refer to PlannerInterface::predictState()).
+ * The speculative planner replaces the start of the (transformed) global plan by the predicted pose
+ * and optimizes the trajectory in a worker thread.
+ * In the next control cycle, accept() checks whether the prediction still holds:
+ * - the actual robot pose is close to the predicted one (TebConfig::Replanning::speculation_tolerance_xy and speculation_tolerance_yaw),
+ * - the local goal did not move (TebConfig::Replanning::goal_change_dist and goal_change_angle),
+ * - the obstacles did not change (refer to ReplanningMonitor::computeFingerprint()).
+ * If all conditions are satisfied, the speculative trajectory is used without optimizing again.
+ * Otherwise the caller falls back to the regular planning step, which warm-starts from the speculative trajectory.
+ * 
+ * The worker shares the planner, the obstacle container and the via-point container with the caller.
+ * Hence the caller must call wait() (or accept()) before modifying any of them.
+ * Via-points that are modified asynchronously (e.g. by a subscriber callback) must be guarded by the via-point mutex
+ * passed to initialize(), which the worker holds during the optimization.
+ * 
+ * Usage (once per control cycle):
+ * @code
+ *   bool success = speculative_planner.accept(robot_pose, goal, obstacles); // waits for the worker
+ *   if (!success)
+ *     success = planner->plan(plan, &vel);
+ *   // ... compute and issue the velocity command
+ *   speculative_planner.start(plan, control_period, obstacles);
+ * @endcode
+ */
+class SpeculativePlanner : public boost::noncopyable
+{
+public:
+  
+  /**
+   * @brief Default constructor
+   */
+  SpeculativePlanner();
+  
+  /**
+   * @brief Destructor (waits for a running worker)
+   */
+  ~SpeculativePlanner();
+  
+  /**
+   * @brief Initialize the speculative planner
+   * @param cfg const reference to the TebConfig class for parameters
+   * @param planner planner that is shared with the regular planning step
+   * @param config_mutex optional mutex that is locked by the worker during the optimization
+   *                     (e.g. TebConfig::configMutex() in order to block dynamic reconfigure)
+   * @param via_point_mutex optional mutex that guards the via-point container of the planner and that is locked by the worker
+   *                        during the optimization. Lock order: \c via_point_mutex before \c config_mutex,
+   *                        the caller must use the same order in order to avoid deadlocks
+   */
+  void initialize(const TebConfig& cfg, const PlannerInterfacePtr& planner, boost::mutex* config_mutex = NULL,
+                  boost::mutex* via_point_mutex = NULL);
+  
+  /**
+   * @brief Start the optimization for the predicted start state of the next control cycle
+   * 
+   * Nothing is started if TebConfig::Replanning::speculative is disabled or if the planner cannot predict its state.
+   * @param initial_plan plan that was used in the current control cycle (the start pose is replaced by the prediction)
+   * @param lookahead time until the next control cycle [s]
+   * @param obstacles obstacle container of the current control cycle
+   * @param free_goal_vel if \c true, a nonzero final velocity at the goal pose is allowed
+   * @return \c true if the worker has been started, \c false otherwise
+   */
+  bool start(const PoseSE2Container& initial_plan, double lookahead, const ObstContainer& obstacles, bool free_goal_vel = false);
+  
+  /**
+   * @brief Check whether the result of the speculative optimization can be used in the current control cycle
+   * 
+   * Waits for the worker and consumes its result. A failed speculative optimization resets the planner.
+   * @param robot_pose current pose of the robot
+   * @param goal current (local) goal pose
+   * @param obstacles current obstacle container
+   * @return \c true if the trajectory stored in the planner is valid for the current cycle, \c false otherwise
+   */
+  bool accept(const PoseSE2& robot_pose, const PoseSE2& goal, const ObstContainer& obstacles);
+  
+  /**
+   * @brief Wait until the worker has finished (the result remains pending for accept())
+   */
+  void wait();
+  
+  /**
+   * @brief Wait for the worker and discard its result
+   */
+  void reset();
+  
+  /**
+   * @brief Check whether a speculative result is pending (the worker might still be running)
+   */
+  bool isPending() const {return pending_;}
+  
+private:
+  
+  /**
+   * @brief Worker function that optimizes the speculative problem
+   */
+  void run();
+  
+  const TebConfig* cfg_; //!< Config class that stores and manages all related parameters
+  PlannerInterfacePtr planner_; //!< Planner shared with the regular planning step
+  boost::mutex* config_mutex_; //!< Optional mutex that is locked during the optimization
+  boost::mutex* via_point_mutex_; //!< Optional mutex that guards the via-points and that is locked during the optimization
+  
+  boost::thread worker_; //!< Worker thread
+  bool pending_; //!< \c true if a speculative optimization has been started and not yet consumed
+  bool success_; //!< Result of the speculative optimization (written by the worker)
+  
+  PoseSE2Container plan_; //!< Plan that starts at the predicted pose
+  Twist2D start_vel_; //!< Predicted start velocity
+  bool free_goal_vel_; //!< Allow a nonzero final velocity
+  std::size_t obstacle_fingerprint_; //!< Fingerprint of the obstacles used for the speculative optimization
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+} // namespace teb_local_planner
+
+#endif /* SPECULATIVE_PLANNER_H_ */
@@ -39,21 +39,28 @@
 #ifndef TEB_CONFIG_H_
 #define TEB_CONFIG_H_
 
-#include <ros/console.h>
-#include <ros/ros.h>
 #include <Eigen/Core>
 #include <Eigen/StdVector>
+#include <boost/thread/mutex.hpp>
 
-#include <teb_local_planner/TebLocalPlannerReconfigureConfig.h>
+#include <string>
 
 
 // Definitions
 #define USE_ANALYTIC_JACOBI // if available for a specific edge, use analytic jacobi
 
 
+// Forward declarations (the ROS specific parts are implemented in teb_config_ros.cpp)
+namespace ros
+{
+class NodeHandle;
+}
+
 namespace teb_local_planner
 {
 
+class TebLocalPlannerReconfigureConfig;
+
 /**
  * @class TebConfig
  * @brief Config class for the teb_local_planner and its components.
@@ -75,6 +82,8 @@ public:
     int max_samples; //!< Maximum number of samples; Warning: if too small the discretization/resolution might not be sufficient for the given robot model or obstacle avoidance does not work anymore.
     bool global_plan_overwrite_orientation; //!< Overwrite orientation of local subgoals provided by the global planner
     bool allow_init_with_backwards_motion; //!< If true, the underlying trajectories might be initialized with backwards motions in case the goal is behind the start within the local costmap (this is only recommended if the robot is equipped with rear sensors)
+    bool carlike_path_init; //!< If true, new trajectories of car-like robots (min_turning_radius > 0) are initialized along the shortest Reeds-Shepp path (Dubins path if allow_init_with_backwards_motion is false) sampled w.r.t. dt_ref
+    bool feasible_time_init; //!< If true, the time differences of newly initialized trajectories are obtained by a forward-backward pass under the velocity and acceleration limits (seeded with the current start velocity) rather than by a constant velocity assumption
     double global_plan_viapoint_sep; //!< Min. separation between each two consecutive via-points extracted from the global plan (if negative: disabled)
     bool via_points_ordered; //!< If true, the planner adheres to the order of via-points in the storage container
     double max_global_plan_lookahead_dist; //!< Specify maximum length (cumulative Euclidean distances) of the subset of the global plan taken into account for optimization [if <=0: disabled; the length is also bounded by the local costmap size!]
@@ -84,6 +93,7 @@ public:
     int feasibility_check_no_poses; //!< Specify up to which pose on the predicted plan the feasibility should be checked each sampling interval.
     bool publish_feedback; //!< Publish planner feedback containing the full trajectory and a list of active obstacles (should be enabled only for evaluation or debugging purposes)
     double min_resolution_collision_check_angular; //! Min angular resolution used during the costmap collision check. If not respected, intermediate samples are added. [rad]
+    bool preallocate_memory; //!< Steady-state mode: preallocate the trajectory for max_samples poses and recycle removed vertices in order to avoid heap allocations while resizing the trajectory
   } trajectory; //!< Trajectory related parameters
 
   //! Robot related parameters
@@ -127,6 +137,10 @@ public:
     std::string costmap_converter_plugin; //!< Define a plugin name of the costmap_converter package (costmap cells are converted to points/lines/polygons)
     bool costmap_converter_spin_thread; //!< If \c true, the costmap converter invokes its callback queue in a different thread
     int costmap_converter_rate; //!< The rate that defines how often the costmap_converter plugin processes the current costmap (the value should not be much higher than the costmap update rate)
+    double polygon_simplification_tolerance; //!< Simplify polygon obstacles from the costmap_converter and custom obstacle messages such that the result encloses the original polygon and deviates at most by this distance [m]. Set to 0 to disable the simplification (default)
+    double point_obstacle_merge_dist; //!< Merge static point obstacles closer than this distance into enclosing circular obstacles [m]. Set to 0 to disable the merging (default)
+    bool corridor_prefilter; //!< Remove static obstacles outside a corridor around the global plan and the current trajectories once per cycle, before they are associated with the trajectory (the corridor width follows the association cutoff)
+    double corridor_prefilter_slack; //!< Additional width of the obstacle corridor that accounts for the deformation of the trajectories during the optimization [m]
   } obstacles; //!< Obstacle related parameters
 
 
@@ -161,6 +175,17 @@ public:
 
     double weight_adapt_factor; //!< Some special weights (currently 'weight_obstacle') are repeatedly scaled by this factor in each outer TEB iteration (weight_new = weight_old*factor); Increasing weights iteratively instead of setting a huge value a-priori leads to better numerical conditions of the underlying optimization problem.
     double obstacle_cost_exponent; //!< Exponent for nonlinear obstacle cost (cost = linear_cost * obstacle_cost_exponent). Set to 1 to disable nonlinear cost (default)
+    bool fuse_consecutive_pose_edges; //!< Replace the velocity, kinematics and shortest path edges by a single fused edge per pose pair (non-holonomic robots only, see EdgeConsecutivePoses)
+    bool batch_edge_linearization; //!< Compute the jacobians of the velocity, acceleration and kinematics edges in batches along the trajectory instead of edge by edge (holonomic variants excluded, see EdgeChainBatch)
+    int telemetry_buffer_size; //!< Number of per-iteration optimizer records kept for diagnostics (see OptimizerTelemetry). Set to 0 to disable the telemetry (default)
+    int multi_start_candidates; //!< Number of trajectories (warm start and alternative initializations) optimized in each cycle if homotopy class planning is disabled. Set to 1 to optimize the warm start only (default)
+    double multi_start_lateral_offset; //!< Lateral displacement of the mirrored alternative initializations w.r.t. the global plan [m]
+    double multi_start_selection_hysteresis; //!< An alternative initialization replaces the warm start only if new_cost < old_cost*factor
+    int horizon_partitions; //!< Number of trajectory segments that are optimized in parallel (alternating with shifted segment boundaries). Set to 1 to optimize the trajectory at once (default)
+    int horizon_partition_min_poses; //!< Minimum number of poses of the trajectory for which the segment-wise optimization is applied (short trajectories are optimized at once)
+    bool reuse_symbolic_factorization; //!< Keep the symbolic factorization of the linear solver across graph rebuilds as long as the sparsity pattern of the system does not change (see LinearSolverSymbolicCache)
+    bool augmented_lagrangian; //!< Enforce the velocity, acceleration and obstacle constraints with augmented Lagrangian multipliers that are updated in each outer iteration instead of rebuilding the graph with increasing obstacle weights (see weight_adapt_factor). The segment-wise optimization (horizon_partitions) is not applied in this mode
+    double augmented_lagrangian_tolerance; //!< The outer iterations of the augmented Lagrangian mode terminate as soon as the largest constraint violation (penalty value) falls below this tolerance
   } optim; //!< Optimization related parameters
 
 
@@ -208,6 +233,34 @@ public:
     double oscillation_filter_duration; //!< Filter length/duration [sec] for the detection of oscillations
   } recovery; //!< Parameters related to recovery and backup strategies
 
+  //! Event-driven replanning related parameters
+  struct Replanning
+  {
+    bool event_driven; //!< Skip the full optimization if neither obstacles, goal nor via-points changed and the robot tracks the previous trajectory, the previous trajectory is only refined instead (see ReplanningMonitor)
+    double change_resolution; //!< Obstacle and via-point coordinates are rounded to multiples of this value [m] before they are compared with the ones of the last full optimization
+    double goal_change_dist; //!< Maximum displacement of the local goal w.r.t. the goal of the last full optimization that does not require a full optimization [m]
+    double goal_change_angle; //!< Maximum orientation change of the local goal w.r.t. the goal of the last full optimization that does not require a full optimization [rad]
+    double max_tracking_error_xy; //!< Maximum distance between the robot and the previous trajectory that allows a refinement [m]
+    double max_tracking_error_yaw; //!< Maximum orientation error between the robot and the closest pose of the previous trajectory that allows a refinement [rad]
+    int refine_iterations; //!< Number of solver iterations of a refinement (a single outer iteration is performed)
+    int max_refinements; //!< Enforce a full optimization after the specified number of consecutive refinements (0: unlimited)
+    bool speculative; //!< Optimize the trajectory for the predicted start state of the next control cycle in a worker thread right after the command has been issued (see SpeculativePlanner)
+    double speculation_tolerance_xy; //!< Maximum distance between the actual and the predicted robot pose that allows to use the speculative result [m]
+    double speculation_tolerance_yaw; //!< Maximum orientation difference between the actual and the predicted robot pose that allows to use the speculative result [rad]
+  } replanning; //!< Parameters related to event-driven replanning
+
+  //! Experience cache related parameters
+  struct Experience
+  {
+    bool enable; //!< Initialize new trajectories from previously optimized trajectories of similar planning problems (see ExperienceCache)
+    int max_entries; //!< Maximum number of stored trajectories (the least recently used one is evicted)
+    double grid_resolution; //!< Cell size of the 8x8 occupancy grid that describes the local obstacle layout between start and goal [m]
+    double max_goal_distance; //!< Maximum distance between the relative goals of the current and a stored planning problem [m]
+    double max_goal_angle; //!< Maximum orientation difference between the relative goals of the current and a stored planning problem [rad]
+    int max_cell_mismatch; //!< Maximum number of occupancy grid cells that might differ between the current and a stored planning problem
+    std::string file; //!< The cache is loaded from this file on startup and stored on shutdown (if not empty)
+  } experience; //!< Parameters related to the experience cache
+
 
   /**
   * @brief Construct the TebConfig using default values.
@@ -237,6 +290,8 @@ public:
     trajectory.max_samples = 500;
     trajectory.global_plan_overwrite_orientation = true;
     trajectory.allow_init_with_backwards_motion = false;
+    trajectory.carlike_path_init = false;
+    trajectory.feasible_time_init = false;
     trajectory.global_plan_viapoint_sep = -1;
     trajectory.via_points_ordered = false;
     trajectory.max_global_plan_lookahead_dist = 1;
@@ -246,6 +301,7 @@ public:
     trajectory.feasibility_check_no_poses = 5;
     trajectory.publish_feedback = false;
     trajectory.min_resolution_collision_check_angular = M_PI;
+    trajectory.preallocate_memory = false;
 
     // Robot
 
@@ -283,6 +339,10 @@ public:
     obstacles.costmap_converter_plugin = "";
     obstacles.costmap_converter_spin_thread = true;
     obstacles.costmap_converter_rate = 5;
+    obstacles.polygon_simplification_tolerance = 0.0;
+    obstacles.point_obstacle_merge_dist = 0.0;
+    obstacles.corridor_prefilter = false;
+    obstacles.corridor_prefilter_slack = 0.5;
 
     // Optimization
 
@@ -311,6 +371,17 @@ public:
 
     optim.weight_adapt_factor = 2.0;
     optim.obstacle_cost_exponent = 1.0;
+    optim.fuse_consecutive_pose_edges = false;
+    optim.batch_edge_linearization = false;
+    optim.telemetry_buffer_size = 0;
+    optim.multi_start_candidates = 1;
+    optim.multi_start_lateral_offset = 0.5;
+    optim.multi_start_selection_hysteresis = 0.8;
+    optim.horizon_partitions = 1;
+    optim.horizon_partition_min_poses = 100;
+    optim.reuse_symbolic_factorization = false;
+    optim.augmented_lagrangian = false;
+    optim.augmented_lagrangian_tolerance = 0.01;
 
     // Homotopy Class Planner
 
@@ -352,11 +423,36 @@ public:
     recovery.oscillation_recovery_min_duration = 10;
     recovery.oscillation_filter_duration = 10;
 
+    // Replanning
+
+    replanning.event_driven = false;
+    replanning.change_resolution = 0.01;
+    replanning.goal_change_dist = 0.1;
+    replanning.goal_change_angle = 0.2;
+    replanning.max_tracking_error_xy = 0.05;
+    replanning.max_tracking_error_yaw = 0.1;
+    replanning.refine_iterations = 2;
+    replanning.max_refinements = 10;
+    replanning.speculative = false;
+    replanning.speculation_tolerance_xy = 0.02;
+    replanning.speculation_tolerance_yaw = 0.05;
+
+    // Experience cache
+
+    experience.enable = false;
+    experience.max_entries = 200;
+    experience.grid_resolution = 0.5;
+    experience.max_goal_distance = 0.3;
+    experience.max_goal_angle = 0.3;
+    experience.max_cell_mismatch = 2;
+    experience.file = "";
+
 
   }
 
   /**
    * @brief Load parmeters from the ros param server.
+   * @remarks Provided by the ROS library (teb_config_ros.cpp), the planning core does not depend on it.
    * @param nh const reference to the local ros::NodeHandle
    */
   void loadRosParamFromNodeHandle(const ros::NodeHandle& nh);
@@ -367,6 +463,7 @@ public:
    * A reconfigure server needs to be instantiated that calls this method in it's callback.
    * In case of the plugin \e teb_local_planner default values are defined
    * in \e PROJECT_SRC/cfg/TebLocalPlannerReconfigure.cfg.
+   * @remarks Provided by the ROS library (teb_config_ros.cpp), the planning core does not depend on it.
    * @param cfg Config class autogenerated by dynamic_reconfigure according to the cfg-file mentioned above.
    */
   void reconfigure(TebLocalPlannerReconfigureConfig& cfg);
@@ -53,6 +53,12 @@
 #include <teb_local_planner/homotopy_class_planner.h>
 #include <teb_local_planner/visualization.h>
 #include <teb_local_planner/recovery_behaviors.h>
+#include <teb_local_planner/replanning_monitor.h>
+#include <teb_local_planner/speculative_planner.h>
+#include <teb_local_planner/plan_processing.h>
+#include <teb_local_planner/obstacle_simplification.h>
+#include <teb_local_planner/obstacle_corridor.h>
+#include <teb_local_planner/ros_adapter.h>
 
 // message types
 #include <nav_msgs/Path.h>
@@ -151,9 +157,10 @@ public:
   /**
    * @brief Get the current robot footprint/contour model
    * @param nh const reference to the local ros::NodeHandle
+   * @param costmap_footprint footprint of the costmap, which is decomposed by the 'multi_circles' model if no vertices are specified
    * @return Robot footprint model used for optimization
    */
-  static RobotFootprintModelPtr getRobotFootprintFromParamServer(const ros::NodeHandle& nh);
+  static RobotFootprintModelPtr getRobotFootprintFromParamServer(const ros::NodeHandle& nh, const Point2dContainer& costmap_footprint = Point2dContainer());
   
     /** 
    * @brief Set the footprint from the given XmlRpcValue.
@@ -226,6 +233,15 @@ protected:
     */
   void reconfigureCB(TebLocalPlannerReconfigureConfig& config, uint32_t level);
   
+  /**
+    * @brief Attach the experience cache to the planner or detach it according to enable_experience_cache
+    * 
+    * The cache is created (and loaded from experience_cache_file) the first time it is enabled.
+    * A disabled cache keeps its entries, hence they are available again if it is enabled later.
+    * The planner must be idle (lock the config mutex).
+    */
+  void updateExperienceCache();
+  
   
    /**
     * @brief Callback for custom obstacles that are not obtained from the costmap 
@@ -298,40 +314,6 @@ protected:
                                       int current_goal_idx, const tf::StampedTransform& tf_plan_to_global, int moving_average_length=3) const;
         
         
-  /**
-   * @brief Saturate the translational and angular velocity to given limits.
-   * 
-   * The limit of the translational velocity for backwards driving can be changed independently.
-   * Do not choose max_vel_x_backwards <= 0. If no backward driving is desired, change the optimization weight for
-   * penalizing backwards driving instead.
-   * @param[in,out] vx The translational velocity that should be saturated.
-   * @param[in,out] vy Strafing velocity which can be nonzero for holonomic robots
-   * @param[in,out] omega The angular velocity that should be saturated.
-   * @param max_vel_x Maximum translational velocity for forward driving
-   * @param max_vel_y Maximum strafing velocity (for holonomic robots)
-   * @param max_vel_theta Maximum (absolute) angular velocity
-   * @param max_vel_x_backwards Maximum translational velocity for backwards driving
-   */
-  void saturateVelocity(double& vx, double& vy, double& omega, double max_vel_x, double max_vel_y,
-                        double max_vel_theta, double max_vel_x_backwards) const;
-
-  
-  /**
-   * @brief Convert translational and rotational velocities to a steering angle of a carlike robot
-   * 
-   * The conversion is based on the following equations:
-   * - The turning radius is defined by \f$ R = v/omega \f$
-   * - For a car like robot withe a distance L between both axles, the relation is: \f$ tan(\phi) = L/R \f$
-   * - phi denotes the steering angle.
-   * @remarks You might provide distances instead of velocities, since the temporal information is not required.
-   * @param v translational velocity [m/s]
-   * @param omega rotational velocity [rad/s]
-   * @param wheelbase distance between both axles (drive shaft and steering axle), the value might be negative for back_wheeled robots
-   * @param min_turning_radius Specify a lower bound on the turning radius
-   * @return Resulting steering angle in [rad] inbetween [-pi/2, pi/2]
-   */
-  double convertTransRotVelToSteeringAngle(double v, double omega, double wheelbase, double min_turning_radius = 0) const;
-  
   /**
    * @brief Validate current parameter values of the footprint for optimization, obstacle distance and the costmap footprint
    * 
@@ -361,9 +343,16 @@ private:
   ObstContainer obstacles_; //!< Obstacle vector that should be considered during local trajectory optimization
   ViaPointContainer via_points_; //!< Container of via-points that should be considered during local trajectory optimization
   TebVisualizationPtr visualization_; //!< Instance of the visualization class (local/global plan, obstacles, ...)
+  RobotFootprintModelPtr robot_model_; //!< Robot footprint model used for optimization and visualization
   boost::shared_ptr<base_local_planner::CostmapModel> costmap_model_;  
   TebConfig cfg_; //!< Config class that stores and manages all related parameters
-  FailureDetector failure_detector_; //!< Detect if the robot got stucked
+  BackupModeManager backup_modes_; //!< Detect infeasible plans and oscillations and activate the corresponding backup modes
+  ReplanningMonitor replanning_monitor_; //!< Detect cycles in which the previous trajectory is only refined (if event_driven_replanning is enabled)
+  ObstacleCorridorFilter corridor_filter_; //!< Remove obstacles outside the corridor around the plan and the trajectories (if corridor_prefilter is enabled)
+  SpeculativePlanner speculative_planner_; //!< Optimize the trajectory for the predicted start state of the next cycle (if speculative_planning is enabled)
+  double control_period_; //!< Expected time between two consecutive calls of computeVelocityCommands() (obtained from controller_frequency) [s]
+  OptimizerTelemetryPtr telemetry_; //!< Optional per-iteration optimizer statistics (enabled if telemetry_buffer_size > 0)
+  ExperienceCachePtr experience_cache_; //!< Optional cache of optimized trajectories for the initialization of new ones (enabled if enable_experience_cache is set)
   
   std::vector<geometry_msgs::PoseStamped> global_plan_; //!< Store the current global plan
   
@@ -383,12 +372,8 @@ private:
 
   PoseSE2 robot_pose_; //!< Store current robot pose
   PoseSE2 robot_goal_; //!< Store current robot goal
-  geometry_msgs::Twist robot_vel_; //!< Store current robot translational and angular velocity (vx, vy, omega)
+  Twist2D robot_vel_; //!< Store current robot translational and angular velocity (vx, vy, omega)
   bool goal_reached_; //!< store whether the goal is reached or not
-  ros::Time time_last_infeasible_plan_; //!< Store at which time stamp the last infeasible plan was detected
-  int no_infeasible_plans_; //!< Store how many times in a row the planner failed to find a feasible plan.
-  ros::Time time_last_oscillation_; //!< Store at which time stamp the last oscillation was detected
-  RotType last_preferred_rotdir_; //!< Store recent preferred turning direction
   geometry_msgs::Twist last_cmd_; //!< Store the last control command generated in computeVelocityCommands()
   
   std::vector<geometry_msgs::Point> footprint_spec_; //!< Store the footprint of the robot 
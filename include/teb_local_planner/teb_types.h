@@ -0,0 +1,99 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#ifndef TEB_TYPES_H_
+#define TEB_TYPES_H_
+
+#include <teb_local_planner/pose_se2.h>
+
+#include <vector>
+
+
+namespace teb_local_planner
+{
+
+/**
+ * @struct Twist2D
+ * @brief Planar velocity (or acceleration) of the robot w.r.t. its own base frame
+ * 
+ * This plain type replaces geometry_msgs::Twist within the planning core.
+ * Conversions to and from ROS messages are provided by the ROS adapter (see ros_adapter.h).
+ */
+struct Twist2D
+{
+  double vx; //!< Translational velocity in heading direction [m/s]
+  double vy; //!< Strafing velocity (zero for non-holonomic robots) [m/s]
+  double omega; //!< Angular velocity [rad/s]
+  
+  /**
+   * @brief Construct a twist (default: zero)
+   */
+  Twist2D(double vx_in = 0, double vy_in = 0, double omega_in = 0) : vx(vx_in), vy(vy_in), omega(omega_in) {}
+  
+  /**
+   * @brief Set all components to zero
+   */
+  void setZero() {vx = vy = omega = 0;}
+};
+
+
+/**
+ * @struct TrajectoryPoint
+ * @brief Single point of a planned trajectory including velocity, acceleration and temporal information
+ * 
+ * This plain type replaces the TrajectoryPointMsg within the planning core (see TebOptimalPlanner::getFullTrajectory()).
+ */
+struct TrajectoryPoint
+{
+  PoseSE2 pose; //!< Pose of the robot
+  Twist2D velocity; //!< Corresponding velocity
+  Twist2D acceleration; //!< Corresponding acceleration
+  double time_from_start; //!< Time [s] from the start of the trajectory
+  
+  TrajectoryPoint() : time_from_start(0) {}
+  
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+//! Container of trajectory points
+typedef std::vector< TrajectoryPoint, Eigen::aligned_allocator<TrajectoryPoint> > TrajectoryPointContainer;
+
+} // namespace teb_local_planner
+
+#endif /* TEB_TYPES_H_ */
@@ -39,17 +39,14 @@
 #ifndef TIMED_ELASTIC_BAND_H_
 #define TIMED_ELASTIC_BAND_H_
 
-#include <ros/ros.h>
-#include <ros/assert.h>
-
-#include <geometry_msgs/PoseStamped.h>
-#include <geometry_msgs/PoseArray.h>
-#include <tf/tf.h>
-
 #include <complex>
 #include <iterator>
 
+#include <boost/optional.hpp>
+#include <boost/next_prior.hpp>
+
 #include <teb_local_planner/obstacles.h>
+#include <teb_local_planner/logging.h>
 
 // G2O Types
 #include <teb_local_planner/g2o_types/vertex_pose.h>
@@ -133,7 +130,7 @@ public:
    */
   double& TimeDiff(int index)
   {
-    ROS_ASSERT(index<sizeTimeDiffs()); 
+    TEB_ASSERT(index<sizeTimeDiffs()); 
     return timediff_vec_.at(index)->dt();
   }
   
@@ -144,7 +141,7 @@ public:
    */
   const double& TimeDiff(int index) const
   {
-    ROS_ASSERT(index<sizeTimeDiffs()); 
+    TEB_ASSERT(index<sizeTimeDiffs()); 
     return timediff_vec_.at(index)->dt();
   }
   
@@ -155,7 +152,7 @@ public:
    */
   PoseSE2& Pose(int index) 
   {
-    ROS_ASSERT(index<sizePoses());
+    TEB_ASSERT(index<sizePoses());
     return pose_vec_.at(index)->pose();
   }
   
@@ -166,7 +163,7 @@ public:
    */
   const PoseSE2& Pose(int index) const 
   {
-    ROS_ASSERT(index<sizePoses());
+    TEB_ASSERT(index<sizePoses());
     return pose_vec_.at(index)->pose();
   }
   
@@ -197,7 +194,7 @@ public:
    */ 
   VertexPose* PoseVertex(int index) 
   {
-    ROS_ASSERT(index<sizePoses());
+    TEB_ASSERT(index<sizePoses());
     return pose_vec_.at(index);
   }
   
@@ -208,7 +205,7 @@ public:
    */  
   VertexTimeDiff* TimeDiffVertex(int index) 
   {
-    ROS_ASSERT(index<sizeTimeDiffs()); 
+    TEB_ASSERT(index<sizeTimeDiffs()); 
     return timediff_vec_.at(index);
   }
   
@@ -415,7 +412,7 @@ public:
    * (e.g. as local plan from the ros navigation stack). \n
    * The initial time difference between two consecutive poses can be uniformly set
    * via the argument \c dt.
-   * @param plan vector of geometry_msgs::PoseStamped
+   * @param plan container of poses (PoseSE2)
    * @param max_vel_x maximum translational velocity used for determining time differences
    * @param estimate_orient if \c true, calculate orientation using the straight line distance vector between consecutive poses
    *                        (only copy start and goal orientation; recommended if no orientation data is available).
@@ -423,18 +420,18 @@ public:
    * @param guess_backwards_motion Allow the initialization of backwards oriented trajectories if the goal heading is pointing behind the robot (this parameter is used only if \c estimate_orient is enabled.
    * @return true if everything was fine, false otherwise
    */
-  bool initTrajectoryToGoal(const std::vector<geometry_msgs::PoseStamped>& plan, double max_vel_x, bool estimate_orient=false, int min_samples = 3, bool guess_backwards_motion = false);
+  bool initTrajectoryToGoal(const PoseSE2Container& plan, double max_vel_x, bool estimate_orient=false, int min_samples = 3, bool guess_backwards_motion = false);
 
 
-  ROS_DEPRECATED bool initTEBtoGoal(const PoseSE2& start, const PoseSE2& goal, double diststep=0, double timestep=1, int min_samples = 3, bool guess_backwards_motion = false)
+  TEB_DEPRECATED bool initTEBtoGoal(const PoseSE2& start, const PoseSE2& goal, double diststep=0, double timestep=1, int min_samples = 3, bool guess_backwards_motion = false)
   {
-    ROS_WARN_ONCE("initTEBtoGoal is deprecated and has been replaced by initTrajectoryToGoal. The signature has changed: timestep has been replaced by max_vel_x. \
+    TEB_WARN_ONCE("initTEBtoGoal is deprecated and has been replaced by initTrajectoryToGoal. The signature has changed: timestep has been replaced by max_vel_x. \
                    this deprecated method sets max_vel_x = 1. Please update your code.");
     return initTrajectoryToGoal(start, goal, diststep, timestep, min_samples, guess_backwards_motion);
   }
 
   template<typename BidirIter, typename Fun>
-  ROS_DEPRECATED bool initTEBtoGoal(BidirIter path_start, BidirIter path_end, Fun fun_position, double max_vel_x, double max_vel_theta,
+  TEB_DEPRECATED bool initTEBtoGoal(BidirIter path_start, BidirIter path_end, Fun fun_position, double max_vel_x, double max_vel_theta,
           boost::optional<double> max_acc_x, boost::optional<double> max_acc_theta,
           boost::optional<double> start_orientation, boost::optional<double> goal_orientation, int min_samples = 3, bool guess_backwards_motion = false)
   {
@@ -442,9 +439,9 @@ public:
                                                 max_acc_x, max_acc_theta, start_orientation, goal_orientation, min_samples, guess_backwards_motion);
   }
 
-  ROS_DEPRECATED bool initTEBtoGoal(const std::vector<geometry_msgs::PoseStamped>& plan, double dt, bool estimate_orient=false, int min_samples = 3, bool guess_backwards_motion = false)
+  TEB_DEPRECATED bool initTEBtoGoal(const PoseSE2Container& plan, double dt, bool estimate_orient=false, int min_samples = 3, bool guess_backwards_motion = false)
   {
-    ROS_WARN_ONCE("initTEBtoGoal is deprecated and has been replaced by initTrajectoryToGoal. The signature has changed: dt has been replaced by max_vel_x. \
+    TEB_WARN_ONCE("initTEBtoGoal is deprecated and has been replaced by initTrajectoryToGoal. The signature has changed: dt has been replaced by max_vel_x. \
                    this deprecated method sets max_vel = 1. Please update your code.");
     return initTrajectoryToGoal(plan, dt, estimate_orient, min_samples, guess_backwards_motion);
   }
@@ -505,6 +502,27 @@ public:
    */    
   void autoResize(double dt_ref, double dt_hysteresis, int min_samples = 3, int max_samples=1000, bool fast_mode=false);
 
+  /**
+   * @brief Recompute all time differences of the trajectory by a time-optimal path parameterization
+   *
+   * The poses remain untouched. The translational speed at each pose is bounded by the (direction dependent)
+   * maximum velocity and by the angular velocity limit that results from the orientation change of the adjacent segments.
+   * The speed vanishes at cusps, i.e. where the driving direction changes.
+   * A forward pass starting at \c start_vel and a backward pass ending at \c goal_vel apply the acceleration limit
+   * (\f$ v_{i+1}^2 \leq v_i^2 + 2 a \Delta s_i \f$). Each time difference is then obtained from the mean speed of its segment.
+   * Segments with a pure rotation are timed with a rest-to-rest profile under the angular limits.
+   * @remarks The resulting time differences might exceed \c dt_ref. Call autoResize() afterwards if a uniform resolution is required.
+   * @param max_vel_x maximum translational velocity for driving forwards
+   * @param max_vel_x_backwards maximum translational velocity for driving backwards
+   * @param max_vel_theta maximum angular velocity
+   * @param acc_lim_x maximum translational acceleration (non-positive values disable the acceleration limit)
+   * @param acc_lim_theta maximum angular acceleration (non-positive values disable the acceleration limit)
+   * @param start_vel translational velocity at the start pose
+   * @param goal_vel translational velocity at the goal pose
+   */
+  void initTimeProfile(double max_vel_x, double max_vel_x_backwards, double max_vel_theta, double acc_lim_x, double acc_lim_theta,
+                       double start_vel = 0, double goal_vel = 0);
+
   /**
    * @brief Set a pose vertex at pos \c index of the pose sequence to be fixed or unfixed during optimization.
    * @param index index to the pose vertex
@@ -525,6 +543,26 @@ public:
    */
   void clearTimedElasticBand();
   
+  /**
+   * @brief Exchange the pose and timediff sequences with another trajectory
+   * 
+   * Only the vertex pointers are exchanged, the recycled vertices (see reserve()) remain in their pools.
+   * The trajectories must not be part of a hyper-graph.
+   * @param other trajectory to exchange the sequences with
+   */
+  void swapTrajectory(TimedElasticBand& other);
+  
+  /**
+   * @brief Preallocate memory for a trajectory with up to \c capacity poses (steady-state mode)
+   * 
+   * The pose and timediff sequences reserve the given capacity and the corresponding number of vertices
+   * is allocated in advance. Afterwards, removed vertices are recycled instead of being deleted,
+   * so that resizing, pruning and reinitializing the trajectory does not touch the heap as long as
+   * the number of poses does not exceed \c capacity.
+   * @param capacity maximum number of poses that should be served without heap allocations (0 disables recycling)
+   */
+  void reserve(int capacity);
+  
   //@}
   
   
@@ -641,9 +679,34 @@ public:
   //@}
 	
 protected:
+  
+  /**
+   * @brief Get a pose vertex from the pool of recycled vertices or allocate a new one
+   */
+  VertexPose* createPoseVertex(const PoseSE2& pose, bool fixed);
+  
+  /**
+   * @brief Get a timediff vertex from the pool of recycled vertices or allocate a new one
+   */
+  VertexTimeDiff* createTimeDiffVertex(double dt, bool fixed);
+  
+  /**
+   * @brief Return a pose vertex to the pool (or delete it, if recycling is disabled or the pool is full)
+   */
+  void releasePoseVertex(VertexPose* pose_vertex);
+  
+  /**
+   * @brief Return a timediff vertex to the pool (or delete it, if recycling is disabled or the pool is full)
+   */
+  void releaseTimeDiffVertex(VertexTimeDiff* timediff_vertex);
+  
   PoseSequence pose_vec_; //!< Internal container storing the sequence of optimzable pose vertices
   TimeDiffSequence timediff_vec_;  //!< Internal container storing the sequence of optimzable timediff vertices
   
+  PoseSequence pose_pool_; //!< Recycled pose vertices (see reserve())
+  TimeDiffSequence timediff_pool_; //!< Recycled timediff vertices (see reserve())
+  int pool_capacity_; //!< Maximum number of recycled vertices per type, 0 if recycling is disabled
+  
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
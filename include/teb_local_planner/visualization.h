@@ -45,6 +45,7 @@
 #include <teb_local_planner/teb_config.h>
 #include <teb_local_planner/timed_elastic_band.h>
 #include <teb_local_planner/robot_footprint_model.h>
+#include <teb_local_planner/planner_interface.h>
 
 // ros stuff
 #include <ros/publisher.h>
@@ -147,6 +148,18 @@ public:
    */
   void publishInfeasibleRobotPose(const PoseSE2& current_pose, const BaseRobotFootprintModel& robot_model);
   
+  /**
+   * @brief Publish all planner related information at once (replaces the former PlannerInterface::visualize()).
+   * 
+   * Publishes the local plan and pose sequence, the robot footprint at the start of the trajectory
+   * and (if enabled) the feedback message. For the HomotopyClassPlanner all trajectory candidates and
+   * (if enabled) the exploration graph are published additionally.
+   * @param planner planner instance (TebOptimalPlanner or HomotopyClassPlanner)
+   * @param robot_model Subclass of BaseRobotFootprintModel
+   * @param obstacles Obstacle container that has been used for planning
+   */
+  void publishPlanner(const PlannerInterface& planner, const BaseRobotFootprintModel& robot_model, const ObstContainer& obstacles);
+  
   /**
    * @brief Publish obstacle positions to the ros topic \e ../../teb_markers
    * @todo Move filling of the marker message to polygon class in order to avoid checking types.
@@ -230,6 +243,15 @@ public:
    */
   void publishFeedbackMessage(const TebOptimalPlanner& teb_planner, const ObstContainer& obstacles);
   
+  /**
+   * @brief Publish the optimizer telemetry of the current planning cycle
+   * 
+   * The compact diagnostics message contains the per-iteration chi2 values, damping, number of rejected steps
+   * and the time split of all records of the current cycle (see OptimizerTelemetry::currentCycle()).
+   * @param telemetry telemetry sink that is registered with the planner
+   */
+  void publishOptimizerDiagnostics(const OptimizerTelemetry& telemetry);
+  
   //@}
 
   /**
@@ -242,6 +264,20 @@ public:
    */
   static std_msgs::ColorRGBA toColorMsg(double a, double r, double g, double b);
   
+  /**
+   * @brief Visualize the robot using a markers
+   * 
+   * Fill a marker message with all necessary information (type, pose, scale and color).
+   * The header, namespace, id and marker lifetime will be overwritten.
+   * Unknown robot models (e.g. PointRobotFootprint) do not generate any markers.
+   * @param robot_model Subclass of BaseRobotFootprintModel
+   * @param current_pose Current robot pose
+   * @param[out] markers container of marker messages describing the robot shape
+   * @param color Color of the footprint
+   */
+  static void robotFootprintToMarkers(const BaseRobotFootprintModel& robot_model, const PoseSE2& current_pose,
+                                      std::vector<visualization_msgs::Marker>& markers, const std_msgs::ColorRGBA& color);
+  
 protected:
   
   /**
@@ -255,6 +291,9 @@ protected:
   ros::Publisher teb_poses_pub_; //!< Publisher for the trajectory pose sequence
   ros::Publisher teb_marker_pub_; //!< Publisher for visualization markers
   ros::Publisher feedback_pub_; //!< Publisher for the feedback message for analysis and debug purposes
+  ros::Publisher diagnostics_pub_; //!< Publisher for the optimizer telemetry (per-iteration statistics)
+  
+  std::vector<OptimizerIterationRecord> telemetry_records_; //!< Buffer for the telemetry records of the current cycle
   
   const TebConfig* cfg_; //!< Config class that stores and manages all related parameters
   
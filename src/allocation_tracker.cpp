@@ -0,0 +1,133 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/allocation_tracker.h>
+
+#include <atomic>
+
+
+namespace teb_local_planner
+{
+
+namespace
+{
+
+// zero-initialized before any dynamic initialization, hence safe to use from operator new
+std::atomic<unsigned long> alloc_counts[NoAllocationPhases];
+std::atomic<unsigned long> alloc_bytes[NoAllocationPhases];
+std::atomic<bool> tracking_disabled(false);
+
+thread_local AllocationPhase current_phase = AllocationPhase::Other;
+
+} // anonymous namespace
+
+
+const char* allocationPhaseName(AllocationPhase phase)
+{
+  switch (phase)
+  {
+    case AllocationPhase::Other: return "other";
+    case AllocationPhase::TebResize: return "teb_resize";
+    case AllocationPhase::GraphBuild: return "graph_build";
+    case AllocationPhase::Optimization: return "optimization";
+    case AllocationPhase::ObstacleUpdate: return "obstacle_update";
+    case AllocationPhase::HSignature: return "h_signature";
+    case AllocationPhase::MessageConstruction: return "message_construction";
+    default: return "unknown";
+  }
+}
+
+unsigned long AllocationStats::totalCount() const
+{
+  unsigned long total = 0;
+  for (int i = 0; i < NoAllocationPhases; ++i)
+    total += count[i];
+  return total;
+}
+
+unsigned long AllocationStats::totalBytes() const
+{
+  unsigned long total = 0;
+  for (int i = 0; i < NoAllocationPhases; ++i)
+    total += bytes[i];
+  return total;
+}
+
+void AllocationTracker::recordAllocation(std::size_t size)
+{
+  if (tracking_disabled.load(std::memory_order_relaxed))
+    return;
+  const int idx = static_cast<int>(current_phase);
+  alloc_counts[idx].fetch_add(1, std::memory_order_relaxed);
+  alloc_bytes[idx].fetch_add(size, std::memory_order_relaxed);
+}
+
+void AllocationTracker::setEnabled(bool enabled)
+{
+  tracking_disabled.store(!enabled);
+}
+
+void AllocationTracker::getStats(AllocationStats& stats)
+{
+  for (int i = 0; i < NoAllocationPhases; ++i)
+  {
+    stats.count[i] = alloc_counts[i].load();
+    stats.bytes[i] = alloc_bytes[i].load();
+  }
+}
+
+void AllocationTracker::reset()
+{
+  for (int i = 0; i < NoAllocationPhases; ++i)
+  {
+    alloc_counts[i].store(0);
+    alloc_bytes[i].store(0);
+  }
+}
+
+AllocationPhase AllocationTracker::currentPhase()
+{
+  return current_phase;
+}
+
+void AllocationTracker::setCurrentPhase(AllocationPhase phase)
+{
+  current_phase = phase;
+}
+
+} // namespace teb_local_planner
@@ -0,0 +1,177 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/batch_planner.h>
+#include <teb_local_planner/homotopy_class_planner.h>
+#include <teb_local_planner/clock.h>
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+
+namespace teb_local_planner
+{
+
+BatchPlanner::BatchPlanner(const TebConfig& cfg, int no_threads) : cfg_(&cfg), next_problem_(0)
+{
+  if (no_threads <= 0)
+    no_threads = boost::thread::hardware_concurrency();
+  no_threads_ = std::max(no_threads, 1);
+  default_robot_model_ = boost::make_shared<PointRobotFootprint>();
+}
+
+std::size_t BatchPlanner::plan(const BatchPlanningProblemContainer& problems, const ObstContainer& shared_obstacles,
+                               std::vector<BatchPlanningResult>& results)
+{
+  SteadyClock wall_clock; // throughput is measured in wall time even if a simulated clock is registered
+  double start_time = wall_clock.now();
+  
+  results.assign(problems.size(), BatchPlanningResult());
+  
+  // create the planners in the calling thread, the workers only access their own slots
+  if (slots_.size() > problems.size())
+    slots_.resize(problems.size());
+  while (slots_.size() < problems.size())
+    slots_.push_back(boost::make_shared<Slot>());
+  
+  bool hcp = cfg_->hcp.enable_homotopy_class_planning;
+  for (std::size_t i=0; i < problems.size(); ++i)
+  {
+    Slot& slot = *slots_[i];
+    RobotFootprintModelPtr robot_model = problems[i].robot_model ? problems[i].robot_model : default_robot_model_;
+    bool is_hcp = dynamic_cast<HomotopyClassPlanner*>(slot.planner.get()) != NULL;
+    if (!slot.planner || slot.robot_model != robot_model || is_hcp != hcp)
+    {
+      if (hcp)
+        slot.planner = PlannerInterfacePtr(new HomotopyClassPlanner(*cfg_, &slot.obstacles, robot_model, &slot.via_points));
+      else
+        slot.planner = PlannerInterfacePtr(new TebOptimalPlanner(*cfg_, &slot.obstacles, robot_model, &slot.via_points));
+      slot.robot_model = robot_model;
+    }
+    if (experience_cache_)
+      slot.planner->setExperienceCache(experience_cache_);
+  }
+  
+  // the workers fetch the problems one after another (dynamic scheduling)
+  next_problem_ = 0;
+  std::size_t no_workers = std::min(no_threads_, std::max<std::size_t>(problems.size(), 1));
+  if (no_workers > 1)
+  {
+    // see HomotopyClassPlanner::optimizeAllTEBs()
+    boost::this_thread::disable_interruption di;
+    
+    boost::thread_group workers;
+    for (std::size_t i=1; i < no_workers; ++i)
+      workers.create_thread( boost::bind(&BatchPlanner::work, this, &problems, &shared_obstacles, &results) );
+    work(&problems, &shared_obstacles, &results); // the calling thread is a worker as well
+    workers.join_all();
+  }
+  else
+    work(&problems, &shared_obstacles, &results);
+  
+  std::size_t no_success = 0;
+  for (const BatchPlanningResult& result : results)
+  {
+    if (result.success)
+      ++no_success;
+  }
+  
+  statistics_.no_problems = problems.size();
+  statistics_.no_threads = no_workers;
+  statistics_.wall_time = wall_clock.now() - start_time;
+  statistics_.plans_per_second = statistics_.wall_time > 0 ? problems.size() / statistics_.wall_time : 0;
+  return no_success;
+}
+
+void BatchPlanner::work(const BatchPlanningProblemContainer* problems, const ObstContainer* shared_obstacles, std::vector<BatchPlanningResult>* results)
+{
+  while (true)
+  {
+    std::size_t index;
+    {
+      boost::mutex::scoped_lock lock(queue_mutex_);
+      if (next_problem_ >= problems->size())
+        return;
+      index = next_problem_++;
+    }
+    solve((*problems)[index], *shared_obstacles, *slots_[index], (*results)[index]);
+  }
+}
+
+void BatchPlanner::solve(const BatchPlanningProblem& problem, const ObstContainer& shared_obstacles, Slot& slot, BatchPlanningResult& result)
+{
+  SteadyClock wall_clock;
+  double start_time = wall_clock.now();
+  
+  // the obstacle objects are shared, only the pointers are copied
+  slot.obstacles.clear();
+  slot.obstacles.reserve(shared_obstacles.size() + problem.local_obstacles.size());
+  slot.obstacles.insert(slot.obstacles.end(), shared_obstacles.begin(), shared_obstacles.end());
+  slot.obstacles.insert(slot.obstacles.end(), problem.local_obstacles.begin(), problem.local_obstacles.end());
+  slot.via_points = problem.via_points;
+  
+  if (problem.initial_plan.size() >= 2)
+  {
+    result.success = slot.planner->plan(problem.initial_plan, problem.has_start_vel ? &problem.start_vel : NULL, problem.free_goal_vel)
+                     && slot.planner->getVelocityCommand(result.vx, result.vy, result.omega);
+  }
+  
+  if (!result.success)
+  {
+    slot.planner->clearPlanner(); // do not warm-start from a failed optimization
+    result.vx = result.vy = result.omega = 0;
+  }
+  
+  result.computation_time = wall_clock.now() - start_time;
+}
+
+PlannerInterfacePtr BatchPlanner::planner(std::size_t index) const
+{
+  if (index >= slots_.size())
+    return PlannerInterfacePtr();
+  return slots_[index]->planner;
+}
+
+void BatchPlanner::clear()
+{
+  slots_.clear();
+}
+
+} // namespace teb_local_planner
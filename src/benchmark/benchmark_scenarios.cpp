@@ -0,0 +1,299 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/benchmark/benchmark_scenarios.h>
+
+#include <boost/make_shared.hpp>
+
+#include <random>
+#include <limits>
+
+
+namespace teb_local_planner
+{
+
+namespace
+{
+
+/**
+ * @brief Add a rectangular room (four line obstacles) to the container
+ */
+void addRoomWalls(ObstContainer& obstacles, double x_min, double y_min, double x_max, double y_max)
+{
+  obstacles.push_back(boost::make_shared<LineObstacle>(x_min, y_min, x_max, y_min));
+  obstacles.push_back(boost::make_shared<LineObstacle>(x_max, y_min, x_max, y_max));
+  obstacles.push_back(boost::make_shared<LineObstacle>(x_max, y_max, x_min, y_max));
+  obstacles.push_back(boost::make_shared<LineObstacle>(x_min, y_max, x_min, y_min));
+}
+
+/**
+ * @brief Add an axis-aligned box (polygon obstacle) to the container
+ */
+void addBox(ObstContainer& obstacles, double x_min, double y_min, double x_max, double y_max)
+{
+  boost::shared_ptr<PolygonObstacle> box = boost::make_shared<PolygonObstacle>();
+  box->pushBackVertex(x_min, y_min);
+  box->pushBackVertex(x_max, y_min);
+  box->pushBackVertex(x_max, y_max);
+  box->pushBackVertex(x_min, y_max);
+  box->finalizePolygon();
+  obstacles.push_back(box);
+}
+
+void createCorridor(BenchmarkScenario& scenario)
+{
+  scenario.description = "Long corridor with a few point obstacles on alternating sides";
+  scenario.start = PoseSE2(0, 0, 0);
+  scenario.goal = PoseSE2(8, 0, 0);
+  scenario.robot_model = boost::make_shared<CircularRobotFootprint>(0.2);
+  
+  scenario.obstacles.push_back(boost::make_shared<LineObstacle>(-1, 1.2, 9, 1.2));
+  scenario.obstacles.push_back(boost::make_shared<LineObstacle>(-1, -1.2, 9, -1.2));
+  scenario.obstacles.push_back(boost::make_shared<PointObstacle>(2, 0.3));
+  scenario.obstacles.push_back(boost::make_shared<PointObstacle>(4, -0.4));
+  scenario.obstacles.push_back(boost::make_shared<PointObstacle>(6, 0.2));
+  
+  scenario.configure = [](TebConfig& cfg)
+  {
+    cfg.obstacles.min_obstacle_dist = 0.25;
+    cfg.obstacles.inflation_dist = 0.4;
+  };
+}
+
+void createClutteredRoom(BenchmarkScenario& scenario)
+{
+  scenario.description = "Square room with randomly placed (seeded) static obstacles";
+  scenario.start = PoseSE2(-2.5, -2.5, M_PI/4);
+  scenario.goal = PoseSE2(2.5, 2.5, M_PI/4);
+  scenario.robot_model = boost::make_shared<CircularRobotFootprint>(0.2);
+  
+  addRoomWalls(scenario.obstacles, -3.5, -3.5, 3.5, 3.5);
+  
+  std::mt19937 rng(42); // fixed seed in order to obtain reproducible scenes
+  std::uniform_real_distribution<double> coord(-3.0, 3.0);
+  std::uniform_real_distribution<double> radius(0.05, 0.25);
+  int no_obstacles = 0;
+  while (no_obstacles < 15)
+  {
+    Eigen::Vector2d pos(coord(rng), coord(rng));
+    double r = radius(rng);
+    // keep start and goal region free
+    if ((pos - scenario.start.position()).norm() < 1.0 || (pos - scenario.goal.position()).norm() < 1.0)
+      continue;
+    if (no_obstacles % 2 == 0)
+      scenario.obstacles.push_back(boost::make_shared<PointObstacle>(pos));
+    else
+      scenario.obstacles.push_back(boost::make_shared<CircularObstacle>(pos, r));
+    ++no_obstacles;
+  }
+  
+  scenario.configure = [](TebConfig& cfg)
+  {
+    cfg.obstacles.min_obstacle_dist = 0.25;
+    cfg.obstacles.inflation_dist = 0.4;
+  };
+}
+
+void createDoorway(BenchmarkScenario& scenario)
+{
+  scenario.description = "Wall with a narrow doorway between start and goal";
+  scenario.start = PoseSE2(-3, -1, 0);
+  scenario.goal = PoseSE2(3, 1, 0);
+  scenario.robot_model = boost::make_shared<CircularRobotFootprint>(0.2);
+  
+  scenario.obstacles.push_back(boost::make_shared<LineObstacle>(0, -5, 0, -0.7));
+  scenario.obstacles.push_back(boost::make_shared<LineObstacle>(0, 0.7, 0, 5));
+  
+  scenario.configure = [](TebConfig& cfg)
+  {
+    cfg.obstacles.min_obstacle_dist = 0.25;
+    cfg.obstacles.inflation_dist = 0.35;
+  };
+}
+
+void createPedestrianCrowd(BenchmarkScenario& scenario)
+{
+  scenario.description = "Pedestrians (dynamic circular obstacles) crossing the path of the robot";
+  scenario.start = PoseSE2(-4, 0, 0);
+  scenario.goal = PoseSE2(4, 0, 0);
+  scenario.robot_model = boost::make_shared<CircularRobotFootprint>(0.25);
+  
+  std::mt19937 rng(7); // fixed seed in order to obtain reproducible scenes
+  std::uniform_real_distribution<double> offset(-0.3, 0.3);
+  std::uniform_real_distribution<double> speed(0.3, 0.8);
+  for (int i=0; i < 8; ++i)
+  {
+    double dir = (i % 2 == 0) ? 1.0 : -1.0; // alternate crossing direction
+    Eigen::Vector2d pos(-2.1 + 0.6*i + offset(rng), -dir * (1.5 + offset(rng)));
+    boost::shared_ptr<CircularObstacle> pedestrian = boost::make_shared<CircularObstacle>(pos, 0.25);
+    pedestrian->setCentroidVelocity(Eigen::Vector2d(0.1*offset(rng), dir * speed(rng)));
+    scenario.obstacles.push_back(pedestrian);
+  }
+  
+  scenario.configure = [](TebConfig& cfg)
+  {
+    cfg.obstacles.include_dynamic_obstacles = true;
+    cfg.obstacles.min_obstacle_dist = 0.3;
+    cfg.obstacles.dynamic_obstacle_inflation_dist = 0.6;
+  };
+}
+
+void createCarlikeParking(BenchmarkScenario& scenario)
+{
+  scenario.description = "Car-like robot parking backwards into a gap between two parked cars";
+  scenario.start = PoseSE2(0, 0, 0);
+  scenario.goal = PoseSE2(-1.2, -1.1, 0);
+  
+  Point2dContainer footprint;
+  footprint.push_back(Eigen::Vector2d(-0.1, -0.2));
+  footprint.push_back(Eigen::Vector2d(0.5, -0.2));
+  footprint.push_back(Eigen::Vector2d(0.5, 0.2));
+  footprint.push_back(Eigen::Vector2d(-0.1, 0.2));
+  scenario.robot_model = boost::make_shared<PolygonRobotFootprint>(footprint);
+  
+  addBox(scenario.obstacles, -3.6, -1.4, -2.3, -0.8); // parked car behind the gap
+  addBox(scenario.obstacles, 0.0, -1.4, 1.3, -0.8); // parked car in front of the gap
+  scenario.obstacles.push_back(boost::make_shared<LineObstacle>(-5, -1.6, 3, -1.6)); // curb
+  
+  scenario.configure = [](TebConfig& cfg)
+  {
+    cfg.robot.min_turning_radius = 0.5;
+    cfg.robot.wheelbase = 0.4;
+    cfg.robot.max_vel_x = 0.4;
+    cfg.robot.max_vel_x_backwards = 0.2;
+    cfg.robot.max_vel_theta = 0.3;
+    cfg.trajectory.allow_init_with_backwards_motion = true;
+    cfg.optim.weight_kinematics_forward_drive = 1;
+    cfg.optim.weight_kinematics_turning_radius = 1;
+    cfg.obstacles.min_obstacle_dist = 0.1;
+    cfg.obstacles.inflation_dist = 0.2;
+  };
+}
+
+} // anonymous namespace
+
+
+bool BenchmarkScenario::hasDynamicObstacles() const
+{
+  for (const ObstaclePtr& obst : obstacles)
+  {
+    if (obst->isDynamic())
+      return true;
+  }
+  return false;
+}
+
+
+std::vector<std::string> benchmarkScenarioNames()
+{
+  std::vector<std::string> names;
+  names.push_back("corridor");
+  names.push_back("cluttered_room");
+  names.push_back("doorway");
+  names.push_back("pedestrian_crowd");
+  names.push_back("carlike_parking");
+  return names;
+}
+
+
+bool createBenchmarkScenario(const std::string& name, BenchmarkScenario& scenario)
+{
+  scenario = BenchmarkScenario();
+  scenario.name = name;
+  
+  if (name == "corridor")
+    createCorridor(scenario);
+  else if (name == "cluttered_room")
+    createClutteredRoom(scenario);
+  else if (name == "doorway")
+    createDoorway(scenario);
+  else if (name == "pedestrian_crowd")
+    createPedestrianCrowd(scenario);
+  else if (name == "carlike_parking")
+    createCarlikeParking(scenario);
+  else
+    return false;
+  
+  return true;
+}
+
+
+void advanceDynamicObstacles(BenchmarkScenario& scenario, double dt)
+{
+  for (ObstaclePtr& obst : scenario.obstacles)
+  {
+    if (!obst->isDynamic())
+      continue;
+    
+    PointObstacle* point = dynamic_cast<PointObstacle*>(obst.get());
+    if (point)
+    {
+      point->position() += dt * point->getCentroidVelocity();
+      continue;
+    }
+    
+    CircularObstacle* circle = dynamic_cast<CircularObstacle*>(obst.get());
+    if (circle)
+      circle->position() += dt * circle->getCentroidVelocity();
+  }
+}
+
+
+double computeMinimumClearance(const TimedElasticBand& teb, const BenchmarkScenario& scenario)
+{
+  double min_dist = std::numeric_limits<double>::max();
+  double t = 0;
+  for (int i=0; i < teb.sizePoses(); ++i)
+  {
+    for (const ObstaclePtr& obst : scenario.obstacles)
+    {
+      double dist;
+      if (obst->isDynamic())
+        dist = scenario.robot_model->estimateSpatioTemporalDistance(teb.Pose(i), obst.get(), t);
+      else
+        dist = scenario.robot_model->calculateDistance(teb.Pose(i), obst.get());
+      if (dist < min_dist)
+        min_dist = dist;
+    }
+    if (i < teb.sizeTimeDiffs())
+      t += teb.TimeDiff(i);
+  }
+  return min_dist;
+}
+
+} // namespace teb_local_planner
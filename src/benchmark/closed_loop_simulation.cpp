@@ -0,0 +1,417 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/benchmark/closed_loop_simulation.h>
+#include <teb_local_planner/optimal_planner.h>
+#include <teb_local_planner/homotopy_class_planner.h>
+#include <teb_local_planner/plan_processing.h>
+
+#include <boost/make_shared.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+
+namespace teb_local_planner
+{
+
+namespace
+{
+
+/**
+ * @brief Change a velocity towards a target value with a bounded rate of change
+ */
+double approachVelocity(double current, double target, double max_delta)
+{
+  if (max_delta <= 0)
+    return target;
+  if (target > current + max_delta)
+    return current + max_delta;
+  if (target < current - max_delta)
+    return current - max_delta;
+  return target;
+}
+
+} // anonymous namespace
+
+
+bool kinematicsFromString(const std::string& name, RobotKinematics& kinematics)
+{
+  if (name == "diff_drive")
+    kinematics = RobotKinematics::DiffDrive;
+  else if (name == "holonomic")
+    kinematics = RobotKinematics::Holonomic;
+  else if (name == "carlike")
+    kinematics = RobotKinematics::CarLike;
+  else
+    return false;
+  return true;
+}
+
+
+std::string kinematicsToString(RobotKinematics kinematics)
+{
+  switch (kinematics)
+  {
+    case RobotKinematics::Holonomic: return "holonomic";
+    case RobotKinematics::CarLike: return "carlike";
+    default: return "diff_drive";
+  }
+}
+
+
+void applyKinematics(RobotKinematics kinematics, TebConfig& cfg)
+{
+  switch (kinematics)
+  {
+    case RobotKinematics::DiffDrive:
+      cfg.robot.max_vel_y = 0;
+      cfg.robot.min_turning_radius = 0;
+      break;
+    case RobotKinematics::Holonomic:
+      if (cfg.robot.max_vel_y <= 0)
+        cfg.robot.max_vel_y = 0.5 * cfg.robot.max_vel_x;
+      cfg.robot.min_turning_radius = 0;
+      cfg.optim.weight_kinematics_nh = 1; // allow lateral motions
+      break;
+    case RobotKinematics::CarLike:
+      cfg.robot.max_vel_y = 0;
+      if (cfg.robot.min_turning_radius <= 0)
+        cfg.robot.min_turning_radius = 0.5;
+      if (cfg.robot.wheelbase <= 0)
+        cfg.robot.wheelbase = 0.4;
+      if (cfg.optim.weight_kinematics_turning_radius <= 0)
+        cfg.optim.weight_kinematics_turning_radius = 1;
+      break;
+  }
+}
+
+
+// ============== ObstacleCollisionChecker Implementation ===================
+
+double ObstacleCollisionChecker::footprintCost(const PoseSE2& pose) const
+{
+  return computeClearance(pose) > 0 ? 0 : -1;
+}
+
+double ObstacleCollisionChecker::computeClearance(const PoseSE2& pose) const
+{
+  double min_dist = std::numeric_limits<double>::infinity();
+  for (const ObstaclePtr& obst : *obstacles_)
+  {
+    double dist = robot_model_->calculateDistance(pose, obst.get());
+    if (dist < min_dist)
+      min_dist = dist;
+  }
+  return min_dist;
+}
+
+
+// ============== ClosedLoopSimulation Implementation ===================
+
+ClosedLoopSimulation::ClosedLoopSimulation(BenchmarkScenario& scenario, const TebConfig& cfg, const SimulationSettings& settings)
+  : scenario_(scenario), cfg_(&cfg), settings_(settings), collision_checker_(scenario.robot_model, &scenario.obstacles)
+{
+  via_points_ = scenario_.via_points;
+  clock_ = boost::make_shared<ManualClock>(0);
+  
+  if (cfg_->hcp.enable_homotopy_class_planning)
+    planner_ = boost::make_shared<HomotopyClassPlanner>(*cfg_, &planner_obstacles_, scenario_.robot_model, &via_points_, clock_);
+  else
+    planner_ = boost::make_shared<TebOptimalPlanner>(*cfg_, &planner_obstacles_, scenario_.robot_model, &via_points_);
+  
+  int buffer_length = (int) std::round(cfg_->recovery.oscillation_filter_duration / settings_.dt);
+  backup_modes_.initialize(*cfg_, buffer_length, clock_);
+  replanning_monitor_.initialize(*cfg_);
+  speculative_planner_.initialize(*cfg_, planner_);
+  corridor_filter_.initialize(*cfg_, scenario_.robot_model);
+}
+
+
+bool ClosedLoopSimulation::run(SimulationResult& result)
+{
+  result = SimulationResult();
+  
+  // the planner time follows the simulated time
+  clock_->setTime(0);
+  
+  robot_pose_ = scenario_.start;
+  robot_vel_.setZero();
+  last_cmd_.setZero();
+  speculative_planner_.reset();
+  planner_->clearPlanner();
+  backup_modes_.reset();
+  replanning_monitor_.reset();
+  createGlobalPlan();
+  
+  result.min_clearance = collision_checker_.computeClearance(robot_pose_);
+  bool in_collision = result.min_clearance <= 0;
+  
+  std::chrono::steady_clock::time_point mission_start = std::chrono::steady_clock::now();
+  
+  while (clock_->now() < settings_.max_duration)
+  {
+    Twist2D cmd;
+    std::chrono::steady_clock::time_point t_start = std::chrono::steady_clock::now();
+    bool goal_reached = controlCycle(cmd, result);
+    std::chrono::steady_clock::time_point t_end = std::chrono::steady_clock::now();
+    
+    if (goal_reached)
+    {
+      result.goal_reached = true;
+      break;
+    }
+    result.cycle_times_ms.push_back(std::chrono::duration<double, std::milli>(t_end - t_start).count());
+    
+    // simulate robot and environment for a single control period
+    PoseSE2 previous_pose = robot_pose_;
+    integrateRobot(cmd);
+    // the speculative optimization runs concurrently to the robot simulation,
+    // but it must not observe the obstacles and the clock of the next cycle
+    speculative_planner_.wait();
+    advanceDynamicObstacles(scenario_, settings_.dt);
+    clock_->advance(settings_.dt);
+    result.path_length += (robot_pose_.position() - previous_pose.position()).norm();
+    
+    double clearance = collision_checker_.computeClearance(robot_pose_);
+    result.min_clearance = std::min(result.min_clearance, clearance);
+    if (clearance <= 0)
+    {
+      ++result.collision_cycles;
+      if (!in_collision)
+        ++result.collision_events;
+    }
+    in_collision = clearance <= 0;
+  }
+  
+  result.time_to_goal = clock_->now();
+  result.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - mission_start).count();
+  
+  speculative_planner_.reset();
+  return result.goal_reached;
+}
+
+
+bool ClosedLoopSimulation::controlCycle(Twist2D& cmd, SimulationResult& result)
+{
+  cmd.setZero();
+  
+  // prune global plan to cut off parts of the past (spatially before the robot)
+  prunePlan(robot_pose_, global_plan_, cfg_->trajectory.global_plan_prune_distance);
+  
+  // extract the portion of the global plan inside the local map
+  PoseSE2Container local_plan;
+  int goal_idx;
+  if (!extractLocalPlan(global_plan_, robot_pose_, 0.85 * settings_.local_map_radius, cfg_->trajectory.max_global_plan_lookahead_dist,
+                        local_plan, &goal_idx))
+    return false;
+  
+  // update via-points container
+  if (cfg_->trajectory.global_plan_viapoint_sep > 0)
+    extractViaPoints(local_plan, cfg_->trajectory.global_plan_viapoint_sep, via_points_);
+  
+  // check if global goal is reached
+  // (custom via-points of the scenario are not removed during the mission, hence they do not block the goal check)
+  const PoseSE2& global_goal = global_plan_.back();
+  double dist_goal = (global_goal.position() - robot_pose_.position()).norm();
+  double delta_orient = g2o::normalize_theta(global_goal.theta() - robot_pose_.theta());
+  if (dist_goal < cfg_->goal_tolerance.xy_goal_tolerance && std::abs(delta_orient) < cfg_->goal_tolerance.yaw_goal_tolerance
+    && (!cfg_->goal_tolerance.complete_global_plan || cfg_->trajectory.global_plan_viapoint_sep <= 0 || via_points_.empty()))
+    return true;
+  
+  // check if we should enter any backup mode and apply settings
+  if (backup_modes_.shrinkHorizon(local_plan, goal_idx))
+    ++result.horizon_reductions;
+  if (backup_modes_.updateOscillationRecovery(last_cmd_, robot_vel_, *planner_))
+    ++result.oscillation_recoveries;
+  
+  // overwrite/update goal orientation of the local plan
+  if (cfg_->trajectory.global_plan_overwrite_orientation)
+    local_plan.back().theta() = estimateLocalGoalOrientation(global_plan_, local_plan.back(), goal_idx);
+  
+  // overwrite/update start of the local plan with the actual robot position
+  if (local_plan.size()==1) // plan only contains the goal
+    local_plan.insert(local_plan.begin(), robot_pose_);
+  else
+    local_plan.front() = robot_pose_;
+  
+  // Now perform the actual planning
+  std::chrono::steady_clock::time_point t_start = std::chrono::steady_clock::now();
+  
+  // obstacles of the current cycle (the planner is idle, the speculative optimization has been joined in run())
+  planner_obstacles_ = scenario_.obstacles;
+  if (cfg_->obstacles.corridor_prefilter)
+  {
+    corridor_filter_.clear();
+    corridor_filter_.addPath(local_plan);
+    corridor_filter_.addViaPoints(via_points_);
+    corridor_filter_.addPlanner(*planner_);
+    corridor_filter_.filter(planner_obstacles_);
+  }
+  
+  ReplanningDecision replanning = ReplanningDecision::Refinement;
+  bool success;
+  if (speculative_planner_.accept(robot_pose_, local_plan.back(), planner_obstacles_))
+  {
+    replanning = ReplanningDecision::Speculative;
+    success = true;
+    ++result.speculative_hits;
+  }
+  else
+  {
+    replanning = replanning_monitor_.evaluate(*planner_, robot_pose_, local_plan.back(), planner_obstacles_, &via_points_);
+    if (replanning == ReplanningDecision::Refinement)
+    {
+      success = planner_->refine(local_plan, &robot_vel_, cfg_->goal_tolerance.free_goal_vel);
+      ++result.refinements;
+    }
+    else
+      success = planner_->plan(local_plan, &robot_vel_, cfg_->goal_tolerance.free_goal_vel);
+  }
+  std::chrono::steady_clock::time_point t_end = std::chrono::steady_clock::now();
+  result.planning_times_ms.push_back(std::chrono::duration<double, std::milli>(t_end - t_start).count());
+  
+  if (!success)
+  {
+    planner_->clearPlanner(); // force reinitialization for next time
+    ++result.planning_failures;
+    backup_modes_.notifyInfeasiblePlan();
+    replanning_monitor_.notifyPlanned(replanning, false);
+    last_cmd_ = cmd;
+    return false;
+  }
+  
+  // Check feasibility (but within the first few states only)
+  if (!planner_->isTrajectoryFeasible(collision_checker_, cfg_->trajectory.feasibility_check_no_poses))
+  {
+    planner_->clearPlanner();
+    ++result.infeasible_trajectories;
+    backup_modes_.notifyInfeasiblePlan();
+    replanning_monitor_.notifyPlanned(replanning, false);
+    last_cmd_ = cmd;
+    return false;
+  }
+  
+  // Get the velocity command for this sampling interval
+  if (!planner_->getVelocityCommand(cmd.vx, cmd.vy, cmd.omega))
+  {
+    cmd.setZero();
+    planner_->clearPlanner();
+    ++result.invalid_commands;
+    backup_modes_.notifyInfeasiblePlan();
+    replanning_monitor_.notifyPlanned(replanning, false);
+    last_cmd_ = cmd;
+    return false;
+  }
+  
+  // Saturate velocity, if the optimization results violates the constraints (could be possible due to soft constraints).
+  saturateVelocity(cmd.vx, cmd.vy, cmd.omega, cfg_->robot.max_vel_x, cfg_->robot.max_vel_y,
+                   cfg_->robot.max_vel_theta, cfg_->robot.max_vel_x_backwards);
+  
+  // a feasible solution should be found, reset counter
+  backup_modes_.notifyFeasiblePlan();
+  replanning_monitor_.notifyPlanned(replanning, true);
+  last_cmd_ = cmd;
+  
+  // start optimizing for the next cycle
+  speculative_planner_.start(local_plan, settings_.dt, planner_obstacles_, cfg_->goal_tolerance.free_goal_vel);
+  return false;
+}
+
+
+void ClosedLoopSimulation::integrateRobot(const Twist2D& cmd)
+{
+  Twist2D target = cmd;
+  switch (settings_.kinematics)
+  {
+    case RobotKinematics::DiffDrive:
+      target.vy = 0;
+      break;
+    case RobotKinematics::Holonomic:
+      break;
+    case RobotKinematics::CarLike:
+    {
+      // the vehicle is commanded by a steering angle (refer to cmd_angle_instead_rotvel), the turning radius is bounded from below
+      target.vy = 0;
+      double steering = convertTransRotVelToSteeringAngle(target.vx, target.omega, cfg_->robot.wheelbase, cfg_->robot.min_turning_radius);
+      target.omega = target.vx * std::tan(steering) / cfg_->robot.wheelbase;
+      break;
+    }
+  }
+  
+  // the robot follows the command subject to its acceleration limits
+  double dt = settings_.dt;
+  robot_vel_.vx = approachVelocity(robot_vel_.vx, target.vx, cfg_->robot.acc_lim_x * dt);
+  robot_vel_.vy = approachVelocity(robot_vel_.vy, target.vy, cfg_->robot.acc_lim_y * dt);
+  robot_vel_.omega = approachVelocity(robot_vel_.omega, target.omega, cfg_->robot.acc_lim_theta * dt);
+  
+  // integrate the pose using the midpoint orientation
+  double theta_mid = robot_pose_.theta() + 0.5 * robot_vel_.omega * dt;
+  double cos_theta = std::cos(theta_mid);
+  double sin_theta = std::sin(theta_mid);
+  robot_pose_.x() += (robot_vel_.vx * cos_theta - robot_vel_.vy * sin_theta) * dt;
+  robot_pose_.y() += (robot_vel_.vx * sin_theta + robot_vel_.vy * cos_theta) * dt;
+  robot_pose_.theta() = g2o::normalize_theta(robot_pose_.theta() + robot_vel_.omega * dt);
+}
+
+
+void ClosedLoopSimulation::createGlobalPlan()
+{
+  global_plan_.clear();
+  
+  PoseSE2Container waypoints;
+  waypoints.push_back(scenario_.start);
+  for (const Eigen::Vector2d& via_point : scenario_.via_points)
+    waypoints.push_back(PoseSE2(via_point, 0));
+  waypoints.push_back(scenario_.goal);
+  
+  double resolution = settings_.global_plan_resolution > 0 ? settings_.global_plan_resolution : 0.1;
+  for (std::size_t i=1; i < waypoints.size(); ++i)
+  {
+    Eigen::Vector2d diff = waypoints[i].position() - waypoints[i-1].position();
+    double orientation = std::atan2(diff.y(), diff.x());
+    int no_steps = std::max(1, (int) std::ceil(diff.norm() / resolution));
+    for (int k=0; k < no_steps; ++k)
+      global_plan_.push_back(PoseSE2(waypoints[i-1].position() + double(k)/double(no_steps) * diff, orientation));
+  }
+  global_plan_.push_back(scenario_.goal);
+  global_plan_.front().theta() = scenario_.start.theta();
+}
+
+} // namespace teb_local_planner
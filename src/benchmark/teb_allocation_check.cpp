@@ -0,0 +1,261 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/optimal_planner.h>
+#include <teb_local_planner/homotopy_class_planner.h>
+#include <teb_local_planner/g2o_types/vertex_pose.h>
+#include <teb_local_planner/benchmark/benchmark_scenarios.h>
+#include <teb_local_planner/allocation_tracker.h>
+#include <teb_local_planner/logging.h>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+
+using namespace teb_local_planner; // it is ok here to import everything for benchmarking purposes
+
+/*
+ * Per-phase heap allocation report and steady-state check.
+ * 
+ * Each benchmark scenario is planned with trajectory.preallocate_memory enabled. After a cold start
+ * and a few warm-up cycles, the allocations of each warm cycle are attributed to the phases of the
+ * planning cycle (see AllocationPhase). The program returns a non-zero exit code if any warm cycle
+ * allocates within a phase that is supposed to be allocation free in the steady state:
+ * trajectory resizing (TebResize) and, with --strict, all other phases as well.
+ * Graph building and optimization are reported only, since g2o allocates its edges and internal
+ * containers for every graph.
+ * Before the scenarios are replayed, the program verifies that the hooks count the Eigen aligned
+ * allocations (e.g. of VertexPose), otherwise the check would pass vacuously.
+ * 
+ * Usage: teb_allocation_check [--cycles N] [--warmup N] [--planner teb|hcp] [--strict]
+ */
+
+
+// ============== Heap allocation accounting ===================
+// The global allocation functions are replaced for this executable only.
+#include <teb_local_planner/allocation_tracker_hooks.h>
+
+
+void printUsage()
+{
+  std::cout << "Usage: teb_allocation_check [--cycles N] [--warmup N] [--planner teb|hcp] [--strict]" << std::endl;
+}
+
+
+/**
+ * @brief Verify that the hooks count known allocations, in particular those of the Eigen aligned operator new
+ *        and of the Eigen aligned allocator, which bypass the global operator new
+ * @return \c true if every probe is counted
+ */
+bool checkHooks()
+{
+  AllocationStats stats;
+  bool ok = true;
+  
+  AllocationTracker::reset();
+  VertexPose* vertex = new VertexPose(); // EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  AllocationTracker::getStats(stats);
+  delete vertex;
+  if (stats.totalCount() < 1)
+  {
+    std::cout << "Allocation hooks do not count 'new VertexPose'." << std::endl;
+    ok = false;
+  }
+  
+  AllocationTracker::reset();
+  {
+    PoseSE2Container poses; // Eigen::aligned_allocator
+    poses.resize(100);
+  }
+  AllocationTracker::getStats(stats);
+  if (stats.totalCount() < 1)
+  {
+    std::cout << "Allocation hooks do not count the allocation of a PoseSE2Container." << std::endl;
+    ok = false;
+  }
+  
+  AllocationTracker::reset();
+  return ok;
+}
+
+
+bool isSteadyStatePhase(AllocationPhase phase, bool strict)
+{
+  if (strict)
+    return true;
+  return phase == AllocationPhase::TebResize;
+}
+
+
+/**
+ * @brief Replay a scenario and report the allocations of each warm cycle
+ * @return \c true if no warm cycle allocates within a steady-state phase
+ */
+bool checkScenario(const std::string& scenario_name, const std::string& planner_name, int warmup, int cycles, bool strict)
+{
+  BenchmarkScenario scenario;
+  createBenchmarkScenario(scenario_name, scenario);
+  
+  TebConfig cfg;
+  scenario.applyConfig(cfg);
+  cfg.trajectory.preallocate_memory = true;
+  cfg.hcp.enable_homotopy_class_planning = (planner_name == "hcp");
+  cfg.hcp.enable_multithreading = false; // attribute all allocations to the planning thread
+  
+  PlannerInterfacePtr planner;
+  if (cfg.hcp.enable_homotopy_class_planning)
+    planner = boost::make_shared<HomotopyClassPlanner>(cfg, &scenario.obstacles, scenario.robot_model, &scenario.via_points);
+  else
+    planner = boost::make_shared<TebOptimalPlanner>(cfg, &scenario.obstacles, scenario.robot_model, &scenario.via_points);
+  
+  Twist2D start_vel; // robot is at rest
+  
+  // cold start and warm-up: let the trajectory converge to its steady-state size
+  for (int i = 0; i < warmup; ++i)
+    planner->plan(scenario.start, scenario.goal, &start_vel, cfg.goal_tolerance.free_goal_vel);
+  
+  AllocationStats sum;
+  std::fill(sum.count, sum.count + NoAllocationPhases, 0ul);
+  std::fill(sum.bytes, sum.bytes + NoAllocationPhases, 0ul);
+  bool ok = true;
+  for (int cycle = 0; cycle < cycles; ++cycle)
+  {
+    AllocationTracker::reset();
+    planner->plan(scenario.start, scenario.goal, &start_vel, cfg.goal_tolerance.free_goal_vel);
+    AllocationStats stats;
+    AllocationTracker::getStats(stats);
+    
+    for (int i = 0; i < NoAllocationPhases; ++i)
+    {
+      sum.count[i] += stats.count[i];
+      sum.bytes[i] += stats.bytes[i];
+      AllocationPhase phase = static_cast<AllocationPhase>(i);
+      if (stats.count[i] > 0 && isSteadyStatePhase(phase, strict))
+      {
+        std::cout << "  " << scenario_name << "," << planner_name << ": warm cycle " << cycle << " allocates "
+                  << stats.count[i] << " times (" << stats.bytes[i] << " bytes) in phase " << allocationPhaseName(phase) << std::endl;
+        ok = false;
+      }
+    }
+  }
+  
+  // mean allocations per warm cycle
+  std::cout << std::left << std::setw(18) << scenario_name << std::setw(6) << planner_name;
+  for (int i = 0; i < NoAllocationPhases; ++i)
+  {
+    std::cout << std::right << std::setw(11) << sum.count[i] / cycles
+              << std::setw(11) << sum.bytes[i] / cycles;
+  }
+  std::cout << (ok ? "   ok" : "   FAILED") << std::endl;
+  return ok;
+}
+
+
+int main(int argc, char** argv)
+{
+  int cycles = 10;
+  int warmup = 5;
+  bool strict = false;
+  std::vector<std::string> planners = {"teb", "hcp"};
+  
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--strict")
+    {
+      strict = true;
+      continue;
+    }
+    if (i + 1 >= argc)
+    {
+      printUsage();
+      return 1;
+    }
+    if (arg == "--cycles")
+      cycles = std::atoi(argv[++i]);
+    else if (arg == "--warmup")
+      warmup = std::atoi(argv[++i]);
+    else if (arg == "--planner")
+      planners = {argv[++i]};
+    else
+    {
+      printUsage();
+      return 1;
+    }
+  }
+  
+  if (cycles < 1 || warmup < 1)
+  {
+    printUsage();
+    return 1;
+  }
+  
+  // only report errors of the planning core in order to keep the output readable
+  setLogger(boost::make_shared<StreamLogger>(Logger::Error));
+  
+  if (!checkHooks())
+  {
+    std::cout << "Steady-state allocation check FAILED (the allocation hooks are not effective)." << std::endl;
+    return 2;
+  }
+  
+  std::cout << "Mean allocations per warm cycle (count and bytes per phase):" << std::endl;
+  std::cout << std::left << std::setw(24) << "scenario,planner";
+  for (int i = 0; i < NoAllocationPhases; ++i)
+    std::cout << std::right << std::setw(22) << allocationPhaseName(static_cast<AllocationPhase>(i));
+  std::cout << std::endl;
+  
+  bool ok = true;
+  for (const std::string& scenario : benchmarkScenarioNames())
+  {
+    for (const std::string& planner : planners)
+      ok &= checkScenario(scenario, planner, warmup, cycles, strict);
+  }
+  
+  if (!ok)
+  {
+    std::cout << "Steady-state allocation check FAILED." << std::endl;
+    return 2;
+  }
+  std::cout << "Steady-state allocation check passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/batch_planner.h>
+#include <teb_local_planner/optimal_planner.h>
+#include <teb_local_planner/homotopy_class_planner.h>
+#include <teb_local_planner/benchmark/benchmark_scenarios.h>
+#include <teb_local_planner/logging.h>
+
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+
+using namespace teb_local_planner; // it is ok here to import everything for benchmarking purposes
+
+/*
+ * Throughput of the multi-robot batch planning API.
+ * 
+ * A fleet of robots is placed in a benchmark scenario. Each robot gets a slightly shifted start and goal
+ * pose and all robots share the obstacles of the scenario. The fleet is planned for several warm-started
+ * cycles (dynamic obstacles are propagated between the cycles) with
+ * - one planner instance per robot, planned one after another (reference),
+ * - the BatchPlanner with a single worker thread,
+ * - the BatchPlanner with the requested number of worker threads.
+ * The throughput is reported in plans per second (cold start excluded).
+ * 
+ * Usage: teb_batch_benchmark [--robots N] [--cycles N] [--threads N] [--scenario NAME] [--planner teb|hcp]
+ */
+
+
+void printUsage()
+{
+  std::cerr << "Usage: teb_batch_benchmark [--robots N] [--cycles N] [--threads N] [--scenario NAME] [--planner teb|hcp]" << std::endl;
+}
+
+//! Create the planning problem of each robot of the fleet
+void createFleet(const BenchmarkScenario& scenario, int no_robots, BatchPlanningProblemContainer& problems)
+{
+  problems.resize(no_robots);
+  for (int i = 0; i < no_robots; ++i)
+  {
+    // deterministic shift of start and goal on a 4x4 raster of 5 cm
+    Eigen::Vector2d shift(0.05 * (i % 4) - 0.075, 0.05 * ((i / 4) % 4) - 0.075);
+    BatchPlanningProblem& problem = problems[i];
+    problem.initial_plan.clear();
+    problem.initial_plan.push_back(PoseSE2(scenario.start.position() + shift, scenario.start.theta()));
+    problem.initial_plan.push_back(PoseSE2(scenario.goal.position() + shift, scenario.goal.theta()));
+    problem.robot_model = scenario.robot_model;
+    problem.via_points = scenario.via_points;
+  }
+}
+
+//! Plan all cycles and return the throughput of the warm-started cycles [plans/s]
+double runFleet(const std::string& scenario_name, bool hcp, int no_robots, int cycles, int no_threads, int& no_success)
+{
+  BenchmarkScenario scenario;
+  createBenchmarkScenario(scenario_name, scenario);
+  TebConfig cfg;
+  scenario.applyConfig(cfg);
+  cfg.hcp.enable_homotopy_class_planning = hcp;
+  cfg.hcp.enable_multithreading = false; // the robots are planned in parallel instead
+  
+  BatchPlanningProblemContainer problems;
+  createFleet(scenario, no_robots, problems);
+  
+  // reference: one planner instance with its own obstacle container per robot
+  std::vector<PlannerInterfacePtr> planners;
+  std::vector<ObstContainer> obstacles(no_robots);
+  boost::shared_ptr<BatchPlanner> batch_planner;
+  if (no_threads == 0)
+  {
+    for (int i = 0; i < no_robots; ++i)
+    {
+      if (hcp)
+        planners.push_back(PlannerInterfacePtr(new HomotopyClassPlanner(cfg, &obstacles[i], scenario.robot_model, &problems[i].via_points)));
+      else
+        planners.push_back(PlannerInterfacePtr(new TebOptimalPlanner(cfg, &obstacles[i], scenario.robot_model, &problems[i].via_points)));
+    }
+  }
+  else
+    batch_planner = boost::make_shared<BatchPlanner>(cfg, no_threads);
+  
+  std::vector<BatchPlanningResult> results;
+  double total_time = 0;
+  no_success = 0;
+  for (int cycle = 0; cycle <= cycles; ++cycle) // cycle 0 is the cold start
+  {
+    auto t_start = std::chrono::steady_clock::now();
+    if (batch_planner)
+      no_success = batch_planner->plan(problems, scenario.obstacles, results);
+    else
+    {
+      no_success = 0;
+      for (int i = 0; i < no_robots; ++i)
+      {
+        obstacles[i] = scenario.obstacles;
+        if (planners[i]->plan(problems[i].initial_plan, NULL, false))
+          ++no_success;
+        else
+          planners[i]->clearPlanner();
+      }
+    }
+    if (cycle > 0)
+      total_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+    
+    advanceDynamicObstacles(scenario, cfg.trajectory.dt_ref);
+  }
+  return total_time > 0 ? double(no_robots) * cycles / total_time : 0;
+}
+
+
+int main(int argc, char** argv)
+{
+  int no_robots = 16;
+  int cycles = 5;
+  int no_threads = 0;
+  std::string scenario_name = "cluttered_room";
+  std::string planner = "teb";
+  
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (i + 1 >= argc)
+    {
+      printUsage();
+      return 1;
+    }
+    if (arg == "--robots")
+      no_robots = std::atoi(argv[++i]);
+    else if (arg == "--cycles")
+      cycles = std::atoi(argv[++i]);
+    else if (arg == "--threads")
+      no_threads = std::atoi(argv[++i]);
+    else if (arg == "--scenario")
+      scenario_name = argv[++i];
+    else if (arg == "--planner")
+      planner = argv[++i];
+    else
+    {
+      printUsage();
+      return 1;
+    }
+  }
+  
+  BenchmarkScenario scenario;
+  if (no_robots < 1 || cycles < 1 || no_threads < 0 || (planner != "teb" && planner != "hcp")
+      || !createBenchmarkScenario(scenario_name, scenario))
+  {
+    printUsage();
+    return 1;
+  }
+  if (no_threads == 0)
+    no_threads = boost::thread::hardware_concurrency();
+  
+  // only report errors of the planning core in order to keep the output readable
+  setLogger(boost::make_shared<StreamLogger>(Logger::Error));
+  
+  std::cout << "Fleet of " << no_robots << " robots in '" << scenario_name << "' (" << planner << "), "
+            << cycles << " warm cycles:" << std::endl;
+  
+  struct Mode {const char* name; int threads;};
+  const Mode modes[] = {{"separate planners", 0}, {"batch, 1 thread", 1}, {"batch", no_threads}};
+  for (const Mode& mode : modes)
+  {
+    int no_success;
+    double throughput = runFleet(scenario_name, planner == "hcp", no_robots, cycles, mode.threads, no_success);
+    std::cout << "  " << std::left << std::setw(20) << mode.name << std::right << std::setw(4) << std::max(mode.threads, 1) << " threads"
+              << std::fixed << std::setprecision(1) << std::setw(10) << throughput << " plans/s"
+              << std::setw(6) << no_success << "/" << no_robots << " successful" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,336 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/optimal_planner.h>
+#include <teb_local_planner/homotopy_class_planner.h>
+#include <teb_local_planner/benchmark/benchmark_scenarios.h>
+#include <teb_local_planner/benchmark/benchmark_statistics.h>
+#include <teb_local_planner/logging.h>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+
+using namespace teb_local_planner; // it is ok here to import everything for benchmarking purposes
+
+/*
+ * Headless benchmark for the planning core.
+ * 
+ * Each combination of scenario, planner and config variant is solved several times (repetitions).
+ * A repetition starts with a cold start and continues with warm-started planning cycles while
+ * dynamic obstacles are propagated. Only the plan() call is timed.
+ * Results are written as JSON to stdout or to the file given with --output.
+ * 
+ * Usage: teb_benchmark [--repetitions N] [--cycles N] [--cycle_time T] [--scenario NAME] [--planner teb|hcp] [--output FILE]
+ */
+
+//! Named modification of the default parameters
+struct ConfigVariant
+{
+  std::string name;
+  boost::function<void (TebConfig&)> apply;
+};
+
+//! Raw samples collected for a single scenario/planner/variant combination
+struct BenchmarkSamples
+{
+  std::vector<double> latencies_ms; //!< Wall time of each plan() call
+  std::vector<double> iterations; //!< Solver iterations of each plan() call
+  std::vector<double> cold_start_latencies_ms; //!< Wall time of the first plan() call of each repetition
+  std::vector<double> cold_start_iterations; //!< Solver iterations of the first plan() call of each repetition
+  std::vector<double> final_costs; //!< Cost of the (best) trajectory after the last cycle of each repetition
+  std::vector<double> clearances; //!< Minimum clearance of the (best) trajectory after the last cycle of each repetition
+  std::vector<double> constraint_violations; //!< Largest constraint violation of the (best) trajectory after the last cycle of each repetition
+  int no_runs = 0;
+  int no_success = 0;
+};
+
+std::vector<ConfigVariant> createConfigVariants()
+{
+  std::vector<ConfigVariant> variants;
+  variants.push_back({"default", [](TebConfig&) {}});
+  variants.push_back({"legacy_association", [](TebConfig& cfg) {cfg.obstacles.legacy_obstacle_association = true;}});
+  variants.push_back({"exact_arc_length", [](TebConfig& cfg) {cfg.trajectory.exact_arc_length = true;}});
+  variants.push_back({"fine_resolution", [](TebConfig& cfg) {cfg.trajectory.dt_ref = 0.2; cfg.trajectory.dt_hysteresis = 0.07;}});
+  variants.push_back({"few_iterations", [](TebConfig& cfg) {cfg.optim.no_inner_iterations = 3; cfg.optim.no_outer_iterations = 2;}});
+  variants.push_back({"long_horizon", [](TebConfig& cfg) {cfg.trajectory.dt_ref = 0.1; cfg.trajectory.dt_hysteresis = 0.03; cfg.trajectory.max_samples = 1000;}});
+  variants.push_back({"long_horizon_partitioned", [](TebConfig& cfg) {cfg.trajectory.dt_ref = 0.1; cfg.trajectory.dt_hysteresis = 0.03; cfg.trajectory.max_samples = 1000;
+                                                                      cfg.optim.horizon_partitions = 4;}});
+  variants.push_back({"augmented_lagrangian", [](TebConfig& cfg) {cfg.optim.augmented_lagrangian = true;}});
+  variants.push_back({"feasible_time_init", [](TebConfig& cfg) {cfg.trajectory.feasible_time_init = true;}});
+  variants.push_back({"carlike_path_init", [](TebConfig& cfg) {cfg.trajectory.carlike_path_init = true; cfg.trajectory.feasible_time_init = true;}});
+  variants.push_back({"experience_cache", [](TebConfig& cfg) {cfg.experience.enable = true;}});
+  return variants;
+}
+
+void runBenchmark(const std::string& scenario_name, const std::string& planner_name, const ConfigVariant& variant,
+                  int repetitions, int cycles, double cycle_time, BenchmarkSamples& samples)
+{
+  // the experience cache is shared among the repetitions (the first one fills the cache)
+  ExperienceCachePtr experience_cache = boost::make_shared<ExperienceCache>();
+  
+  for (int rep = 0; rep < repetitions; ++rep)
+  {
+    BenchmarkScenario scenario;
+    createBenchmarkScenario(scenario_name, scenario);
+    
+    TebConfig cfg;
+    scenario.applyConfig(cfg);
+    variant.apply(cfg);
+    cfg.hcp.enable_homotopy_class_planning = (planner_name == "hcp");
+    
+    TebOptimalPlannerPtr teb_planner;
+    boost::shared_ptr<HomotopyClassPlanner> hcp_planner;
+    PlannerInterfacePtr planner;
+    if (cfg.hcp.enable_homotopy_class_planning)
+    {
+      hcp_planner = boost::make_shared<HomotopyClassPlanner>(cfg, &scenario.obstacles, scenario.robot_model, &scenario.via_points);
+      planner = hcp_planner;
+    }
+    else
+    {
+      teb_planner = boost::make_shared<TebOptimalPlanner>(cfg, &scenario.obstacles, scenario.robot_model, &scenario.via_points);
+      planner = teb_planner;
+    }
+    
+    if (cfg.experience.enable)
+      planner->setExperienceCache(experience_cache);
+    
+    Twist2D start_vel; // robot is at rest
+    bool success = true;
+    
+    for (int cycle = 0; cycle < cycles; ++cycle)
+    {
+      std::chrono::steady_clock::time_point t_start = std::chrono::steady_clock::now();
+      bool plan_ok = planner->plan(scenario.start, scenario.goal, &start_vel, cfg.goal_tolerance.free_goal_vel);
+      std::chrono::steady_clock::time_point t_end = std::chrono::steady_clock::now();
+      
+      samples.latencies_ms.push_back(std::chrono::duration<double, std::milli>(t_end - t_start).count());
+      success = success && plan_ok;
+      
+      int iterations = 0;
+      if (teb_planner)
+        iterations = teb_planner->getLastIterations();
+      else
+      {
+        for (const TebOptimalPlannerPtr& teb : hcp_planner->getTrajectoryContainer())
+          iterations += teb->getLastIterations();
+      }
+      samples.iterations.push_back(iterations);
+      if (cycle == 0)
+      {
+        samples.cold_start_latencies_ms.push_back(samples.latencies_ms.back());
+        samples.cold_start_iterations.push_back(iterations);
+      }
+      
+      if (cycle == cycles - 1)
+      {
+        TebOptimalPlannerPtr best = teb_planner ? teb_planner : hcp_planner->bestTeb();
+        if (best && plan_ok)
+        {
+          best->computeCurrentCost();
+          samples.final_costs.push_back(best->getCurrentCost());
+          double clearance = computeMinimumClearance(best->teb(), scenario);
+          samples.clearances.push_back(clearance);
+          if (!std::isnan(best->getConstraintViolation()))
+            samples.constraint_violations.push_back(best->getConstraintViolation());
+          success = success && clearance > 0;
+        }
+        else
+          success = false;
+      }
+      
+      advanceDynamicObstacles(scenario, cycle_time);
+    }
+    
+    samples.no_runs++;
+    if (success)
+      samples.no_success++;
+  }
+}
+
+void writeResult(std::ostream& os, const std::string& scenario, const std::string& planner, const std::string& variant,
+                 BenchmarkSamples& samples, bool last)
+{
+  std::sort(samples.latencies_ms.begin(), samples.latencies_ms.end());
+  
+  os << "    {\n";
+  os << "      \"scenario\": \"" << scenario << "\",\n";
+  os << "      \"planner\": \"" << planner << "\",\n";
+  os << "      \"variant\": \"" << variant << "\",\n";
+  os << "      \"runs\": " << samples.no_runs << ",\n";
+  os << "      \"samples\": " << samples.latencies_ms.size() << ",\n";
+  os << "      \"success_rate\": " << (samples.no_runs > 0 ? (double) samples.no_success / (double) samples.no_runs : 0.0) << ",\n";
+  os << "      \"latency_ms\": {\"mean\": " << mean(samples.latencies_ms)
+     << ", \"p50\": " << percentile(samples.latencies_ms, 50)
+     << ", \"p90\": " << percentile(samples.latencies_ms, 90)
+     << ", \"p99\": " << percentile(samples.latencies_ms, 99)
+     << ", \"max\": " << maximum(samples.latencies_ms) << "},\n";
+  os << "      \"iterations\": {\"mean\": " << mean(samples.iterations) << ", \"max\": " << maximum(samples.iterations) << "},\n";
+  os << "      \"cold_start\": {\"latency_ms\": " << mean(samples.cold_start_latencies_ms)
+     << ", \"iterations\": " << mean(samples.cold_start_iterations) << "},\n";
+  os << "      \"final_cost\": {\"mean\": " << mean(samples.final_costs) << ", \"min\": " << minimum(samples.final_costs)
+     << ", \"max\": " << maximum(samples.final_costs) << "},\n";
+  os << "      \"constraint_violation\": {\"mean\": " << mean(samples.constraint_violations) << ", \"max\": " << maximum(samples.constraint_violations) << "},\n";
+  os << "      \"min_clearance\": " << minimum(samples.clearances) << "\n";
+  os << "    }" << (last ? "\n" : ",\n");
+}
+
+void printUsage()
+{
+  std::cerr << "Usage: teb_benchmark [--repetitions N] [--cycles N] [--cycle_time T] [--scenario NAME] [--planner teb|hcp] [--variant NAME] [--output FILE]" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  int repetitions = 5;
+  int cycles = 20;
+  double cycle_time = 0.1;
+  std::string scenario_filter;
+  std::string planner_filter;
+  std::string variant_filter;
+  std::string output_file;
+  
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (i + 1 >= argc)
+    {
+      printUsage();
+      return 1;
+    }
+    if (arg == "--repetitions")
+      repetitions = std::atoi(argv[++i]);
+    else if (arg == "--cycles")
+      cycles = std::atoi(argv[++i]);
+    else if (arg == "--cycle_time")
+      cycle_time = std::atof(argv[++i]);
+    else if (arg == "--scenario")
+      scenario_filter = argv[++i];
+    else if (arg == "--planner")
+      planner_filter = argv[++i];
+    else if (arg == "--variant")
+      variant_filter = argv[++i];
+    else if (arg == "--output")
+      output_file = argv[++i];
+    else
+    {
+      printUsage();
+      return 1;
+    }
+  }
+  
+  if (repetitions < 1 || cycles < 1)
+  {
+    printUsage();
+    return 1;
+  }
+  
+  // only report errors of the planning core in order to keep the benchmark output readable
+  setLogger(boost::make_shared<StreamLogger>(Logger::Error));
+  
+  std::vector<std::string> scenarios = benchmarkScenarioNames();
+  std::vector<std::string> planners = {"teb", "hcp"};
+  std::vector<ConfigVariant> variants = createConfigVariants();
+  
+  // collect all requested combinations first in order to write a well-formed json array
+  struct Job {std::string scenario; std::string planner; const ConfigVariant* variant;};
+  std::vector<Job> jobs;
+  for (const std::string& scenario : scenarios)
+  {
+    if (!scenario_filter.empty() && scenario != scenario_filter)
+      continue;
+    for (const std::string& planner : planners)
+    {
+      if (!planner_filter.empty() && planner != planner_filter)
+        continue;
+      for (const ConfigVariant& variant : variants)
+      {
+        if (!variant_filter.empty() && variant.name != variant_filter)
+          continue;
+        jobs.push_back({scenario, planner, &variant});
+      }
+    }
+  }
+  
+  if (jobs.empty())
+  {
+    std::cerr << "teb_benchmark: no scenario/planner/variant matches the given filters." << std::endl;
+    return 1;
+  }
+  
+  std::ofstream file;
+  if (!output_file.empty())
+  {
+    file.open(output_file.c_str());
+    if (!file.is_open())
+    {
+      std::cerr << "teb_benchmark: cannot open output file " << output_file << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& os = output_file.empty() ? std::cout : file;
+  os << std::setprecision(6);
+  
+  os << "{\n";
+  os << "  \"benchmark\": \"teb_local_planner\",\n";
+  os << "  \"repetitions\": " << repetitions << ",\n";
+  os << "  \"cycles\": " << cycles << ",\n";
+  os << "  \"cycle_time\": " << cycle_time << ",\n";
+  os << "  \"results\": [\n";
+  
+  for (std::size_t i = 0; i < jobs.size(); ++i)
+  {
+    std::cerr << "teb_benchmark: " << jobs[i].scenario << " / " << jobs[i].planner << " / " << jobs[i].variant->name << std::endl;
+    BenchmarkSamples samples;
+    runBenchmark(jobs[i].scenario, jobs[i].planner, *jobs[i].variant, repetitions, cycles, cycle_time, samples);
+    writeResult(os, jobs[i].scenario, jobs[i].planner, jobs[i].variant->name, samples, i + 1 == jobs.size());
+  }
+  
+  os << "  ]\n";
+  os << "}\n";
+  
+  return 0;
+}
@@ -0,0 +1,976 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/g2o_types/vertex_pose.h>
+#include <teb_local_planner/g2o_types/vertex_timediff.h>
+#include <teb_local_planner/g2o_types/edge_velocity.h>
+#include <teb_local_planner/g2o_types/edge_acceleration.h>
+#include <teb_local_planner/g2o_types/edge_kinematics.h>
+#include <teb_local_planner/g2o_types/edge_obstacle.h>
+#include <teb_local_planner/g2o_types/edge_dynamic_obstacle.h>
+#include <teb_local_planner/g2o_types/edge_via_point.h>
+#include <teb_local_planner/g2o_types/edge_time_optimal.h>
+#include <teb_local_planner/g2o_types/edge_shortest_path.h>
+#include <teb_local_planner/g2o_types/edge_consecutive_poses.h>
+#include <teb_local_planner/g2o_types/edge_prefer_rotdir.h>
+#include <teb_local_planner/g2o_types/edge_chain_batch.h>
+#include <teb_local_planner/timed_elastic_band.h>
+#include <teb_local_planner/distance_calculations.h>
+#include <teb_local_planner/robot_footprint_model.h>
+#include <teb_local_planner/obstacles.h>
+#include <teb_local_planner/obstacle_simplification.h>
+#include <teb_local_planner/obstacle_corridor.h>
+#include <teb_local_planner/teb_config.h>
+#include <teb_local_planner/benchmark/benchmark_statistics.h>
+#include <teb_local_planner/logging.h>
+
+#include <g2o/core/jacobian_workspace.h>
+
+#include <boost/make_shared.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+using namespace teb_local_planner; // it is ok here to import everything for benchmarking purposes
+
+/*
+ * Microbenchmarks for the innermost kernels of the optimization.
+ * 
+ * Covered are computeError() and linearizeOplus() of every edge type in g2o_types,
+ * every function in distance_calculations.h (with raw vertices and with the precomputed edges of the obstacles) and calculateDistance() /
+ * estimateSpatioTemporalDistance() for every combination of footprint model and obstacle type.
+ * The group edge_dispatch compares the generic obstacle edges with the edges specialized for a footprint model.
+ * The group simplification measures the conservative polygon simplification of a noisy contour and the
+ * distance queries of a polygonal robot to the original and to the simplified contour.
+ * The group prefilter measures the ObstacleCorridorFilter on a costmap-like set of point obstacles and the
+ * distance computations of the obstacle association for all obstacles and for the remaining obstacles.
+ * The group trig_cache compares edges with a valid and an invalidated orientation cache of VertexPose.
+ * The group edge_chain compares the per-edge linearization of the velocity, acceleration and kinematics
+ * edges of a complete trajectory with the EdgeChainBatch (one call linearizes all edges).
+ * Each kernel is executed in several batches; the median batch is reported in ns/call.
+ * Edges without an analytic Jacobian are linearized by g2o's numeric differentiation, which
+ * is exactly what the optimizer pays for them.
+ * 
+ * Usage: teb_microbenchmark [--iterations N] [--batches N] [--filter SUBSTRING] [--output FILE]
+ */
+
+//! Accumulates kernel results, so that the compiler cannot discard the benchmarked calls
+static volatile double g_sink = 0;
+
+//! Result of a single microbenchmark
+struct MicroResult
+{
+  std::string group;
+  std::string name;
+  double ns_per_call; //!< median over all batches
+  double ns_min; //!< fastest batch
+};
+
+/**
+ * @brief Collect and run microbenchmarks
+ */
+class MicroBenchmarkRunner
+{
+public:
+  
+  MicroBenchmarkRunner(int iterations, int batches, const std::string& filter) 
+    : iterations_(iterations), batches_(batches), filter_(filter) {}
+  
+  /**
+   * @brief Measure the kernel \c fun and append the result
+   * @param group group of the kernel (edges, distance, footprint)
+   * @param name name of the kernel
+   * @param fun callable without arguments returning a double that is fed into the sink
+   */
+  template <typename Fun>
+  void run(const std::string& group, const std::string& name, Fun fun)
+  {
+    if (!filter_.empty() && (group + "/" + name).find(filter_) == std::string::npos)
+      return;
+    
+    // warm up caches and branch predictors
+    double acc = 0;
+    for (int i = 0; i < iterations_ / 10 + 1; ++i)
+      acc += fun();
+    
+    std::vector<double> batch_ns;
+    batch_ns.reserve(batches_);
+    for (int b = 0; b < batches_; ++b)
+    {
+      auto t_start = std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations_; ++i)
+        acc += fun();
+      auto t_end = std::chrono::steady_clock::now();
+      batch_ns.push_back(std::chrono::duration<double, std::nano>(t_end - t_start).count() / (double) iterations_);
+    }
+    g_sink = g_sink + acc;
+    
+    MicroResult result;
+    result.group = group;
+    result.name = name;
+    result.ns_per_call = percentile(batch_ns, 50);
+    result.ns_min = minimum(batch_ns);
+    results_.push_back(result);
+  }
+  
+  const std::vector<MicroResult>& results() const {return results_;}
+  
+private:
+  int iterations_;
+  int batches_;
+  std::string filter_;
+  std::vector<MicroResult> results_;
+};
+
+
+/**
+ * @brief Benchmark computeError() and linearizeOplus() of an edge whose vertices are already connected
+ * @remarks linearizeOplus() is invoked via the g2o::JacobianWorkspace interface of the optimizer,
+ *          since the jacobian storage of the edge is mapped to the workspace memory.
+ */
+template <typename EdgeT>
+void benchmarkEdge(MicroBenchmarkRunner& runner, const std::string& name, EdgeT& edge)
+{
+  runner.run("edges", name + "::computeError", [&edge]() {
+    edge.computeError();
+    return edge.error()[0];
+  });
+  
+  g2o::JacobianWorkspace workspace;
+  workspace.updateSize(&edge);
+  workspace.allocate();
+  g2o::OptimizableGraph::Edge& base_edge = edge;
+  runner.run("edges", name + "::linearizeOplus", [&edge, &base_edge, &workspace]() {
+    base_edge.linearizeOplus(workspace);
+    return edge.error()[0];
+  });
+}
+
+
+void benchmarkEdges(MicroBenchmarkRunner& runner, const TebConfig& cfg)
+{
+  // a short trajectory snippet with nominal spacing, which activates most penalty terms
+  VertexPose pose1(0.0, 0.0, 0.0);
+  VertexPose pose2(0.25, 0.05, 0.2);
+  VertexPose pose3(0.5, 0.15, 0.35);
+  VertexTimeDiff dt1(0.3);
+  VertexTimeDiff dt2(0.28);
+  
+  Twist2D vel_start;
+  vel_start.vx = 0.2;
+  vel_start.vy = 0.0;
+  vel_start.omega = 0.1;
+  Twist2D vel_goal;
+  vel_goal.setZero();
+  
+  // obstacles close to the poses in order to obtain non-zero errors
+  PointObstacle obstacle(0.3, 0.4);
+  CircularObstacle dyn_obstacle(0.6, 0.5, 0.1);
+  dyn_obstacle.setCentroidVelocity(Eigen::Vector2d(-0.2, 0.1));
+  CircularRobotFootprint robot_model(0.25);
+  Eigen::Vector2d via_point(0.3, 0.2);
+  
+  EdgeVelocity velocity;
+  velocity.setVertex(0, &pose1);
+  velocity.setVertex(1, &pose2);
+  velocity.setVertex(2, &dt1);
+  velocity.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeVelocity", velocity);
+  
+  EdgeVelocityHolonomic velocity_holonomic;
+  velocity_holonomic.setVertex(0, &pose1);
+  velocity_holonomic.setVertex(1, &pose2);
+  velocity_holonomic.setVertex(2, &dt1);
+  velocity_holonomic.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeVelocityHolonomic", velocity_holonomic);
+  
+  EdgeAcceleration acceleration;
+  acceleration.setVertex(0, &pose1);
+  acceleration.setVertex(1, &pose2);
+  acceleration.setVertex(2, &pose3);
+  acceleration.setVertex(3, &dt1);
+  acceleration.setVertex(4, &dt2);
+  acceleration.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeAcceleration", acceleration);
+  
+  EdgeAccelerationStart acceleration_start;
+  acceleration_start.setVertex(0, &pose1);
+  acceleration_start.setVertex(1, &pose2);
+  acceleration_start.setVertex(2, &dt1);
+  acceleration_start.setInitialVelocity(vel_start);
+  acceleration_start.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeAccelerationStart", acceleration_start);
+  
+  EdgeAccelerationGoal acceleration_goal;
+  acceleration_goal.setVertex(0, &pose2);
+  acceleration_goal.setVertex(1, &pose3);
+  acceleration_goal.setVertex(2, &dt2);
+  acceleration_goal.setGoalVelocity(vel_goal);
+  acceleration_goal.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeAccelerationGoal", acceleration_goal);
+  
+  EdgeAccelerationHolonomic acceleration_holonomic;
+  acceleration_holonomic.setVertex(0, &pose1);
+  acceleration_holonomic.setVertex(1, &pose2);
+  acceleration_holonomic.setVertex(2, &pose3);
+  acceleration_holonomic.setVertex(3, &dt1);
+  acceleration_holonomic.setVertex(4, &dt2);
+  acceleration_holonomic.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeAccelerationHolonomic", acceleration_holonomic);
+  
+  EdgeAccelerationHolonomicStart acceleration_holonomic_start;
+  acceleration_holonomic_start.setVertex(0, &pose1);
+  acceleration_holonomic_start.setVertex(1, &pose2);
+  acceleration_holonomic_start.setVertex(2, &dt1);
+  acceleration_holonomic_start.setInitialVelocity(vel_start);
+  acceleration_holonomic_start.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeAccelerationHolonomicStart", acceleration_holonomic_start);
+  
+  EdgeAccelerationHolonomicGoal acceleration_holonomic_goal;
+  acceleration_holonomic_goal.setVertex(0, &pose2);
+  acceleration_holonomic_goal.setVertex(1, &pose3);
+  acceleration_holonomic_goal.setVertex(2, &dt2);
+  acceleration_holonomic_goal.setGoalVelocity(vel_goal);
+  acceleration_holonomic_goal.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeAccelerationHolonomicGoal", acceleration_holonomic_goal);
+  
+  EdgeKinematicsDiffDrive kinematics_diff_drive;
+  kinematics_diff_drive.setVertex(0, &pose1);
+  kinematics_diff_drive.setVertex(1, &pose2);
+  kinematics_diff_drive.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeKinematicsDiffDrive", kinematics_diff_drive);
+  
+  EdgeKinematicsCarlike kinematics_carlike;
+  kinematics_carlike.setVertex(0, &pose1);
+  kinematics_carlike.setVertex(1, &pose2);
+  kinematics_carlike.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeKinematicsCarlike", kinematics_carlike);
+  
+  EdgeObstacle obstacle_edge;
+  obstacle_edge.setVertex(0, &pose2);
+  obstacle_edge.setParameters(cfg, &robot_model, &obstacle);
+  benchmarkEdge(runner, "EdgeObstacle", obstacle_edge);
+  
+  EdgeInflatedObstacle inflated_obstacle_edge;
+  inflated_obstacle_edge.setVertex(0, &pose2);
+  inflated_obstacle_edge.setParameters(cfg, &robot_model, &obstacle);
+  benchmarkEdge(runner, "EdgeInflatedObstacle", inflated_obstacle_edge);
+  
+  EdgeDynamicObstacle dynamic_obstacle_edge(0.6);
+  dynamic_obstacle_edge.setVertex(0, &pose3);
+  dynamic_obstacle_edge.setParameters(cfg, &robot_model, &dyn_obstacle);
+  benchmarkEdge(runner, "EdgeDynamicObstacle", dynamic_obstacle_edge);
+  
+  EdgeViaPoint via_point_edge;
+  via_point_edge.setVertex(0, &pose2);
+  via_point_edge.setParameters(cfg, &via_point);
+  benchmarkEdge(runner, "EdgeViaPoint", via_point_edge);
+  
+  EdgeTimeOptimal time_optimal;
+  time_optimal.setVertex(0, &dt1);
+  time_optimal.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeTimeOptimal", time_optimal);
+  
+  EdgeShortestPath shortest_path;
+  shortest_path.setVertex(0, &pose1);
+  shortest_path.setVertex(1, &pose2);
+  shortest_path.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeShortestPath", shortest_path);
+  
+  EdgeConsecutivePoses consecutive_poses; // replaces EdgeVelocity, EdgeKinematicsDiffDrive and EdgeShortestPath
+  consecutive_poses.setVertex(0, &pose1);
+  consecutive_poses.setVertex(1, &pose2);
+  consecutive_poses.setVertex(2, &dt1);
+  consecutive_poses.setTebConfig(cfg);
+  benchmarkEdge(runner, "EdgeConsecutivePoses", consecutive_poses);
+  
+  EdgePreferRotDir prefer_rotdir;
+  prefer_rotdir.setVertex(0, &pose1);
+  prefer_rotdir.setVertex(1, &pose2);
+  prefer_rotdir.setTebConfig(cfg);
+  prefer_rotdir.setRotDir(-1);
+  benchmarkEdge(runner, "EdgePreferRotDir", prefer_rotdir);
+}
+
+
+/**
+ * @brief Benchmark computeError() of an edge with a valid and with an invalidated orientation cache of its pose vertices
+ * 
+ * Numeric differentiation perturbs one vertex dimension at a time, hence the cache of the pose vertices
+ * is valid for all position perturbations. The invalidated variant toggles the yaw angles between two values
+ * in each call, which resembles the cost of computeError() without the cache.
+ */
+template <typename EdgeT>
+void benchmarkTrigCache(MicroBenchmarkRunner& runner, const std::string& name, EdgeT& edge, const std::vector<VertexPose*>& poses)
+{
+  runner.run("trig_cache", name + "::computeError (cached)", [&edge]() {
+    edge.computeError();
+    return edge.error()[0];
+  });
+  
+  double toggle = 1e-9;
+  runner.run("trig_cache", name + "::computeError (invalidated)", [&edge, &poses, &toggle]() {
+    toggle = -toggle;
+    for (VertexPose* pose : poses)
+      pose->setTheta(pose->theta() + toggle);
+    edge.computeError();
+    return edge.error()[0];
+  });
+}
+
+
+void benchmarkTrigCaches(MicroBenchmarkRunner& runner, const TebConfig& cfg)
+{
+  VertexPose pose1(0.0, 0.0, 0.0);
+  VertexPose pose2(0.25, 0.05, 0.2);
+  VertexPose pose3(0.5, 0.15, 0.35);
+  VertexTimeDiff dt1(0.3);
+  VertexTimeDiff dt2(0.28);
+  
+  double toggle = 1e-9;
+  runner.run("trig_cache", "VertexPose::orientationUnitVec (cached)", [&pose2]() {
+    return pose2.orientationUnitVec().x();
+  });
+  runner.run("trig_cache", "VertexPose::orientationUnitVec (invalidated)", [&pose2, &toggle]() {
+    toggle = -toggle;
+    pose2.setTheta(pose2.theta() + toggle);
+    return pose2.orientationUnitVec().x();
+  });
+  
+  EdgeVelocity velocity;
+  velocity.setVertex(0, &pose1);
+  velocity.setVertex(1, &pose2);
+  velocity.setVertex(2, &dt1);
+  velocity.setTebConfig(cfg);
+  benchmarkTrigCache(runner, "EdgeVelocity", velocity, {&pose1, &pose2});
+  
+  EdgeAcceleration acceleration;
+  acceleration.setVertex(0, &pose1);
+  acceleration.setVertex(1, &pose2);
+  acceleration.setVertex(2, &pose3);
+  acceleration.setVertex(3, &dt1);
+  acceleration.setVertex(4, &dt2);
+  acceleration.setTebConfig(cfg);
+  benchmarkTrigCache(runner, "EdgeAcceleration", acceleration, {&pose1, &pose2, &pose3});
+  
+  EdgeKinematicsDiffDrive kinematics_diff_drive;
+  kinematics_diff_drive.setVertex(0, &pose1);
+  kinematics_diff_drive.setVertex(1, &pose2);
+  kinematics_diff_drive.setTebConfig(cfg);
+  benchmarkTrigCache(runner, "EdgeKinematicsDiffDrive", kinematics_diff_drive, {&pose1, &pose2});
+  
+  Point2dContainer robot_polygon;
+  robot_polygon.push_back(Eigen::Vector2d(-0.3, -0.2));
+  robot_polygon.push_back(Eigen::Vector2d(0.4, -0.2));
+  robot_polygon.push_back(Eigen::Vector2d(0.5, 0.0));
+  robot_polygon.push_back(Eigen::Vector2d(0.4, 0.2));
+  robot_polygon.push_back(Eigen::Vector2d(-0.3, 0.2));
+  
+  PointObstacle obstacle(0.3, 0.4);
+  PolygonRobotFootprint robot_model(robot_polygon);
+  EdgeObstacle obstacle_edge;
+  obstacle_edge.setVertex(0, &pose2);
+  obstacle_edge.setParameters(cfg, &robot_model, &obstacle);
+  benchmarkTrigCache(runner, "EdgeObstacle(Polygon)", obstacle_edge, {&pose2});
+}
+
+
+/**
+ * @brief Benchmark the linearization of the velocity, acceleration and kinematics edges of a trajectory with and without EdgeChainBatch
+ * 
+ * A single call linearizes all edges, as the optimizer does once per iteration.
+ * The batch is invalidated in each call, so all jacobians are recomputed each time.
+ */
+void benchmarkEdgeChains(MicroBenchmarkRunner& runner, const TebConfig& cfg)
+{
+  const int no_poses = 50;
+  TimedElasticBand teb;
+  teb.addPose(PoseSE2(0.0, 0.0, 0.0));
+  for (int i = 1; i < no_poses; ++i)
+    teb.addPoseAndTimeDiff(PoseSE2(0.1*i, 0.2*std::sin(0.1*i), 0.2*std::cos(0.1*i)), 0.3);
+  
+  EdgeChainBatch batch;
+  batch.initialize(cfg, teb);
+  
+  std::vector<g2o::OptimizableGraph::Edge*> edges;
+  for (int i = 0; i < no_poses - 1; ++i)
+  {
+    EdgeVelocity* velocity = new EdgeVelocity;
+    velocity->setVertex(0, teb.PoseVertex(i));
+    velocity->setVertex(1, teb.PoseVertex(i+1));
+    velocity->setVertex(2, teb.TimeDiffVertex(i));
+    velocity->setTebConfig(cfg);
+    velocity->setBatch(&batch, batch.addEdge(EdgeChainType::Velocity, i));
+    edges.push_back(velocity);
+    
+    EdgeKinematicsDiffDrive* kinematics = new EdgeKinematicsDiffDrive;
+    kinematics->setVertex(0, teb.PoseVertex(i));
+    kinematics->setVertex(1, teb.PoseVertex(i+1));
+    kinematics->setTebConfig(cfg);
+    kinematics->setBatch(&batch, batch.addEdge(EdgeChainType::KinematicsDiffDrive, i));
+    edges.push_back(kinematics);
+    
+    if (i < no_poses - 2)
+    {
+      EdgeAcceleration* acceleration = new EdgeAcceleration;
+      acceleration->setVertex(0, teb.PoseVertex(i));
+      acceleration->setVertex(1, teb.PoseVertex(i+1));
+      acceleration->setVertex(2, teb.PoseVertex(i+2));
+      acceleration->setVertex(3, teb.TimeDiffVertex(i));
+      acceleration->setVertex(4, teb.TimeDiffVertex(i+1));
+      acceleration->setTebConfig(cfg);
+      acceleration->setBatch(&batch, batch.addEdge(EdgeChainType::Acceleration, i));
+      edges.push_back(acceleration);
+    }
+  }
+  
+  g2o::JacobianWorkspace workspace;
+  for (g2o::OptimizableGraph::Edge* edge : edges)
+    workspace.updateSize(edge);
+  workspace.allocate();
+  
+  for (int batched = 0; batched < 2; ++batched)
+  {
+    const std::string suffix = batched ? " (batched)" : " (per edge)";
+    batch.setActive(batched != 0);
+    
+    runner.run("edge_chain", "linearizeOplus of " + std::to_string(edges.size()) + " edges" + suffix, [&edges, &batch, &workspace]() {
+      batch.invalidate();
+      for (g2o::OptimizableGraph::Edge* edge : edges)
+        edge->linearizeOplus(workspace);
+      return edges.front()->errorData()[0];
+    });
+  }
+  batch.setActive(false);
+  
+  for (g2o::OptimizableGraph::Edge* edge : edges)
+    delete edge;
+}
+
+
+//! Find the result of a kernel by its group and name (returns NULL if it has been filtered)
+const MicroResult* findResult(const std::vector<MicroResult>& results, const std::string& group, const std::string& name)
+{
+  for (const MicroResult& result : results)
+  {
+    if (result.group == group && result.name == name)
+      return &result;
+  }
+  return NULL;
+}
+
+void benchmarkDistanceCalculations(MicroBenchmarkRunner& runner)
+{
+  const Eigen::Vector2d point(0.4, 1.2);
+  const Eigen::Vector2d line1_start(-1.0, 0.0), line1_end(1.0, 0.2);
+  const Eigen::Vector2d line2_start(0.0, 0.8), line2_end(0.5, 2.0);
+  
+  Point2dContainer polygon1;
+  polygon1.push_back(Eigen::Vector2d(0.0, 0.0));
+  polygon1.push_back(Eigen::Vector2d(1.0, -0.2));
+  polygon1.push_back(Eigen::Vector2d(1.4, 0.6));
+  polygon1.push_back(Eigen::Vector2d(0.6, 1.1));
+  polygon1.push_back(Eigen::Vector2d(-0.3, 0.7));
+  Point2dContainer polygon2;
+  polygon2.push_back(Eigen::Vector2d(2.0, 2.0));
+  polygon2.push_back(Eigen::Vector2d(3.0, 2.1));
+  polygon2.push_back(Eigen::Vector2d(2.8, 3.0));
+  polygon2.push_back(Eigen::Vector2d(2.1, 2.9));
+  
+  // the 3d variants expect non-const references of Eigen::Ref objects
+  const Eigen::Vector3d x1(0.0, 0.0, 0.0), x2(1.0, 0.5, 0.2), x3(0.0, 1.0, 0.0), x4(1.0, 1.2, 1.0);
+  const Eigen::Vector3d u(1.0, 0.5, 0.2), v(1.0, 0.2, 1.0);
+  Eigen::Ref<const Eigen::Vector3d> ref_u(u), ref_v(v), ref_x2(x2), ref_x4(x4);
+  
+  const Eigen::Vector2d vel1(0.5, 0.0), vel2(-0.2, -0.3);
+  
+  runner.run("distance", "closest_point_on_line_segment_2d", [&]() {
+    return closest_point_on_line_segment_2d(point, line1_start, line1_end).x();
+  });
+  runner.run("distance", "distance_point_to_segment_2d", [&]() {
+    return distance_point_to_segment_2d(point, line1_start, line1_end);
+  });
+  runner.run("distance", "check_line_segments_intersection_2d", [&]() {
+    return (double) check_line_segments_intersection_2d(line1_start, line1_end, line2_start, line2_end);
+  });
+  runner.run("distance", "distance_segment_to_segment_2d", [&]() {
+    return distance_segment_to_segment_2d(line1_start, line1_end, line2_start, line2_end);
+  });
+  runner.run("distance", "distance_point_to_polygon_2d", [&]() {
+    return distance_point_to_polygon_2d(Eigen::Vector2d(2.0, 0.3), polygon1);
+  });
+  runner.run("distance", "distance_segment_to_polygon_2d", [&]() {
+    return distance_segment_to_polygon_2d(line2_start, Eigen::Vector2d(2.0, 1.5), polygon1);
+  });
+  runner.run("distance", "distance_polygon_to_polygon_2d", [&]() {
+    return distance_polygon_to_polygon_2d(polygon1, polygon2);
+  });
+  
+  // the same queries with the precomputed edges that LineObstacle and PolygonObstacle store after finalization
+  PrecomputedSegment2d segment1;
+  segment1.set(line1_start, line1_end);
+  const PolygonObstacle polygon_obstacle1(polygon1);
+  const PolygonObstacle polygon_obstacle2(polygon2);
+  runner.run("distance", "closest_point_on_line_segment_2d (precomputed)", [&]() {
+    return closest_point_on_line_segment_2d(point, segment1).x();
+  });
+  runner.run("distance", "distance_point_to_segment_2d (precomputed)", [&]() {
+    return distance_point_to_segment_2d(point, segment1);
+  });
+  runner.run("distance", "distance_segment_to_segment_2d (precomputed)", [&]() {
+    return distance_segment_to_segment_2d(line2_start, line2_end, segment1);
+  });
+  runner.run("distance", "distance_point_to_polygon_2d (precomputed)", [&]() {
+    return distance_point_to_polygon_2d(Eigen::Vector2d(2.0, 0.3), polygon_obstacle1.edges());
+  });
+  runner.run("distance", "distance_segment_to_polygon_2d (precomputed)", [&]() {
+    return distance_segment_to_polygon_2d(line2_start, Eigen::Vector2d(2.0, 1.5), polygon_obstacle1.edges());
+  });
+  runner.run("distance", "distance_polygon_to_polygon_2d (precomputed)", [&]() {
+    return distance_polygon_to_polygon_2d(polygon1, polygon_obstacle2.edges());
+  });
+  
+  // noisy contour (e.g. from the costmap converter) with many vertices
+  Point2dContainer contour;
+  for (int i = 0; i < 32; ++i)
+  {
+    double angle = 2.0 * M_PI * i / 32.0;
+    double radius = 0.8 + 0.03 * std::sin(7.0 * angle);
+    contour.push_back(Eigen::Vector2d(3.0 + radius * std::cos(angle), 1.0 + radius * std::sin(angle)));
+  }
+  const PolygonObstacle contour_obstacle(contour);
+  runner.run("distance", "distance_point_to_polygon_2d (32 vertices)", [&]() {
+    return distance_point_to_polygon_2d(point, contour);
+  });
+  runner.run("distance", "distance_point_to_polygon_2d (32 vertices, precomputed)", [&]() {
+    return distance_point_to_polygon_2d(point, contour_obstacle.edges());
+  });
+  runner.run("distance", "distance_polygon_to_polygon_2d (32 vertices)", [&]() {
+    return distance_polygon_to_polygon_2d(polygon1, contour);
+  });
+  runner.run("distance", "distance_polygon_to_polygon_2d (32 vertices, precomputed)", [&]() {
+    return distance_polygon_to_polygon_2d(polygon1, contour_obstacle.edges());
+  });
+  
+  const char* compared_kernels[][2] = {
+    {"closest_point_on_line_segment_2d", "closest_point_on_line_segment_2d (precomputed)"},
+    {"distance_point_to_segment_2d", "distance_point_to_segment_2d (precomputed)"},
+    {"distance_segment_to_segment_2d", "distance_segment_to_segment_2d (precomputed)"},
+    {"distance_point_to_polygon_2d", "distance_point_to_polygon_2d (precomputed)"},
+    {"distance_segment_to_polygon_2d", "distance_segment_to_polygon_2d (precomputed)"},
+    {"distance_polygon_to_polygon_2d", "distance_polygon_to_polygon_2d (precomputed)"},
+    {"distance_point_to_polygon_2d (32 vertices)", "distance_point_to_polygon_2d (32 vertices, precomputed)"},
+    {"distance_polygon_to_polygon_2d (32 vertices)", "distance_polygon_to_polygon_2d (32 vertices, precomputed)"}};
+  for (const auto& kernels : compared_kernels)
+  {
+    const MicroResult* raw_result = findResult(runner.results(), "distance", kernels[0]);
+    const MicroResult* precomputed_result = findResult(runner.results(), "distance", kernels[1]);
+    if (raw_result && precomputed_result && precomputed_result->ns_per_call > 0)
+      std::cerr << "precomputed geometry " << kernels[0] << ": speedup " << std::fixed << std::setprecision(2)
+                << raw_result->ns_per_call / precomputed_result->ns_per_call << "x" << std::endl;
+  }
+  
+  runner.run("distance", "calc_distance_line_to_line_3d", [&]() {
+    return calc_distance_line_to_line_3d(x1, ref_u, x3, ref_v);
+  });
+  runner.run("distance", "calc_distance_segment_to_segment3D", [&]() {
+    return calc_distance_segment_to_segment3D(x1, ref_x2, x3, ref_x4);
+  });
+  runner.run("distance", "calc_closest_point_to_approach_time", [&]() {
+    return calc_closest_point_to_approach_time(line1_start, vel1, line2_start, vel2);
+  });
+  runner.run("distance", "calc_closest_point_to_approach_distance", [&]() {
+    return calc_closest_point_to_approach_distance(line1_start, vel1, line2_start, vel2, 2.0);
+  });
+  runner.run("distance", "calc_distance_point_to_line", [&]() {
+    return calc_distance_point_to_line(point, line1_start, Eigen::Vector2d(line1_end - line1_start));
+  });
+  runner.run("distance", "calc_distance_point_to_segment", [&]() {
+    return calc_distance_point_to_segment(point, line1_start, line1_end);
+  });
+}
+
+
+//! Polygonal robot footprint shared by the footprint benchmarks
+Point2dContainer benchmarkRobotPolygon()
+{
+  Point2dContainer robot_polygon;
+  robot_polygon.push_back(Eigen::Vector2d(-0.3, -0.2));
+  robot_polygon.push_back(Eigen::Vector2d(0.4, -0.2));
+  robot_polygon.push_back(Eigen::Vector2d(0.5, 0.0));
+  robot_polygon.push_back(Eigen::Vector2d(0.4, 0.2));
+  robot_polygon.push_back(Eigen::Vector2d(-0.3, 0.2));
+  return robot_polygon;
+}
+
+void benchmarkFootprints(MicroBenchmarkRunner& runner)
+{
+  const Point2dContainer robot_polygon = benchmarkRobotPolygon();
+  
+  std::vector<std::pair<std::string, RobotFootprintModelPtr> > models;
+  models.push_back(std::make_pair("Point", boost::make_shared<PointRobotFootprint>()));
+  models.push_back(std::make_pair("Circular", boost::make_shared<CircularRobotFootprint>(0.3)));
+  models.push_back(std::make_pair("TwoCircles", boost::make_shared<TwoCirclesRobotFootprint>(0.2, 0.2, 0.2, 0.2)));
+  models.push_back(std::make_pair("Line", boost::make_shared<LineRobotFootprint>(Eigen::Vector2d(-0.3, 0.0), Eigen::Vector2d(0.4, 0.0))));
+  models.push_back(std::make_pair("Polygon", boost::make_shared<PolygonRobotFootprint>(robot_polygon)));
+  
+  // automatic decompositions of the polygon
+  const double over_approximations[] = {0.05, 0.02};
+  std::vector<std::string> approximation_names;
+  for (double over_approximation : over_approximations)
+  {
+    boost::shared_ptr<MultiCirclesRobotFootprint> model = boost::make_shared<MultiCirclesRobotFootprint>(robot_polygon, over_approximation, 20);
+    std::ostringstream name;
+    name << "MultiCircles(e=" << over_approximation << ",k=" << model->getCircles().size() << ")";
+    models.push_back(std::make_pair(name.str(), model));
+    approximation_names.push_back(name.str());
+  }
+  
+  Point2dContainer obstacle_polygon;
+  obstacle_polygon.push_back(Eigen::Vector2d(1.0, 0.5));
+  obstacle_polygon.push_back(Eigen::Vector2d(1.8, 0.4));
+  obstacle_polygon.push_back(Eigen::Vector2d(2.0, 1.2));
+  obstacle_polygon.push_back(Eigen::Vector2d(1.2, 1.4));
+  
+  std::vector<std::pair<std::string, ObstaclePtr> > obstacles;
+  obstacles.push_back(std::make_pair("PointObstacle", boost::make_shared<PointObstacle>(1.0, 0.6)));
+  obstacles.push_back(std::make_pair("CircularObstacle", boost::make_shared<CircularObstacle>(1.0, 0.6, 0.2)));
+  obstacles.push_back(std::make_pair("LineObstacle", boost::make_shared<LineObstacle>(0.8, 1.0, 1.6, 0.4)));
+  obstacles.push_back(std::make_pair("PolygonObstacle", boost::make_shared<PolygonObstacle>(obstacle_polygon)));
+  for (std::size_t i = 0; i < obstacles.size(); ++i)
+    obstacles[i].second->setCentroidVelocity(Eigen::Vector2d(-0.3, 0.1));
+  
+  const PoseSE2 pose(0.1, 0.05, 0.3);
+  
+  for (std::size_t m = 0; m < models.size(); ++m)
+  {
+    const BaseRobotFootprintModel* model = models[m].second.get();
+    for (std::size_t o = 0; o < obstacles.size(); ++o)
+    {
+      const Obstacle* obstacle = obstacles[o].second.get();
+      const std::string pair_name = models[m].first + "/" + obstacles[o].first;
+      runner.run("footprint", pair_name + "::calculateDistance", [model, obstacle, &pose]() {
+        return model->calculateDistance(pose, obstacle);
+      });
+      runner.run("footprint", pair_name + "::estimateSpatioTemporalDistance", [model, obstacle, &pose]() {
+        return model->estimateSpatioTemporalDistance(pose, obstacle, 0.5);
+      });
+    }
+  }
+  
+  // approximation error and speedup of the circle decompositions w.r.t. the polygon
+  for (std::size_t m = 0; m < models.size(); ++m)
+  {
+    const MultiCirclesRobotFootprint* model = dynamic_cast<const MultiCirclesRobotFootprint*>(models[m].second.get());
+    if (!model)
+      continue;
+    std::cerr << "footprint approximation " << models[m].first << ": over-approximation " << std::fixed << std::setprecision(3)
+              << model->getApproximationError() << " m, speedup of calculateDistance w.r.t. Polygon:";
+    for (std::size_t o = 0; o < obstacles.size(); ++o)
+    {
+      const MicroResult* polygon_result = findResult(runner.results(), "footprint", "Polygon/" + obstacles[o].first + "::calculateDistance");
+      const MicroResult* circles_result = findResult(runner.results(), "footprint", models[m].first + "/" + obstacles[o].first + "::calculateDistance");
+      if (polygon_result && circles_result && circles_result->ns_per_call > 0)
+        std::cerr << " " << obstacles[o].first << " " << std::setprecision(1) << polygon_result->ns_per_call / circles_result->ns_per_call << "x";
+    }
+    std::cerr << std::endl;
+  }
+}
+
+
+/**
+ * @brief Compare the generic obstacle edges (virtual distance calculation) with the edges specialized for a footprint model
+ */
+template <template <typename> class SpecializedEdge, typename GenericEdge, typename FootprintT>
+void benchmarkEdgeDispatch(MicroBenchmarkRunner& runner, const TebConfig& cfg, const std::string& name, const FootprintT& robot_model,
+                           VertexPose& pose, const std::vector<std::pair<std::string, ObstaclePtr> >& obstacles)
+{
+  for (std::size_t o = 0; o < obstacles.size(); ++o)
+  {
+    const std::string pair_name = name + "/" + obstacles[o].first;
+    
+    boost::shared_ptr<GenericEdge> generic_edge = boost::make_shared<GenericEdge>();
+    generic_edge->setVertex(0, &pose);
+    generic_edge->setParameters(cfg, &robot_model, obstacles[o].second.get());
+    runner.run("edge_dispatch", pair_name + "::generic", [generic_edge]() {
+      generic_edge->computeError();
+      return generic_edge->error()[0];
+    });
+    
+    boost::shared_ptr<SpecializedEdge<FootprintT> > specialized_edge = boost::make_shared<SpecializedEdge<FootprintT> >();
+    specialized_edge->setVertex(0, &pose);
+    specialized_edge->setParameters(cfg, &robot_model, obstacles[o].second.get());
+    runner.run("edge_dispatch", pair_name + "::specialized", [specialized_edge]() {
+      specialized_edge->computeError();
+      return specialized_edge->error()[0];
+    });
+    
+    const MicroResult* generic_result = findResult(runner.results(), "edge_dispatch", pair_name + "::generic");
+    const MicroResult* specialized_result = findResult(runner.results(), "edge_dispatch", pair_name + "::specialized");
+    if (generic_result && specialized_result && specialized_result->ns_per_call > 0)
+      std::cerr << "edge dispatch " << pair_name << ": speedup of the specialized edge " << std::fixed << std::setprecision(2)
+                << generic_result->ns_per_call / specialized_result->ns_per_call << "x" << std::endl;
+  }
+}
+
+void benchmarkEdgeDispatches(MicroBenchmarkRunner& runner, const TebConfig& cfg)
+{
+  VertexPose pose(0.1, 0.05, 0.3);
+  
+  std::vector<std::pair<std::string, ObstaclePtr> > obstacles;
+  obstacles.push_back(std::make_pair("PointObstacle", boost::make_shared<PointObstacle>(0.6, 0.4)));
+  obstacles.push_back(std::make_pair("LineObstacle", boost::make_shared<LineObstacle>(0.5, 0.6, 1.0, 0.1)));
+  
+  const CircularRobotFootprint circular(0.3);
+  const TwoCirclesRobotFootprint two_circles(0.2, 0.2, 0.2, 0.2);
+  const PolygonRobotFootprint polygon(benchmarkRobotPolygon());
+  
+  benchmarkEdgeDispatch<EdgeObstacleSpecialized, EdgeObstacle>(runner, cfg, "EdgeObstacle/Circular", circular, pose, obstacles);
+  benchmarkEdgeDispatch<EdgeObstacleSpecialized, EdgeObstacle>(runner, cfg, "EdgeObstacle/TwoCircles", two_circles, pose, obstacles);
+  benchmarkEdgeDispatch<EdgeObstacleSpecialized, EdgeObstacle>(runner, cfg, "EdgeObstacle/Polygon", polygon, pose, obstacles);
+  benchmarkEdgeDispatch<EdgeInflatedObstacleSpecialized, EdgeInflatedObstacle>(runner, cfg, "EdgeInflatedObstacle/Polygon", polygon, pose, obstacles);
+  benchmarkEdgeDispatch<EdgeDynamicObstacleSpecialized, EdgeDynamicObstacle>(runner, cfg, "EdgeDynamicObstacle/Polygon", polygon, pose, obstacles);
+}
+
+
+/**
+ * @brief Compare the distance queries to a noisy contour before and after the conservative polygon simplification
+ */
+void benchmarkSimplification(MicroBenchmarkRunner& runner)
+{
+  // dense and noisy contour as extracted by the costmap converter from a cluttered costmap
+  Point2dContainer contour;
+  for (int i = 0; i < 128; ++i)
+  {
+    double angle = 2.0 * M_PI * i / 128.0;
+    double radius = 0.8 + 0.02 * std::sin(23.0 * angle) + 0.01 * std::sin(57.0 * angle);
+    contour.push_back(Eigen::Vector2d(3.0 + radius * std::cos(angle), 1.0 + radius * std::sin(angle)));
+  }
+  
+  const double tolerance = 0.05;
+  runner.run("simplification", "simplifyPolygonConservative (128 vertices)", [&]() {
+    Point2dContainer simplified;
+    return simplifyPolygonConservative(contour, tolerance, simplified);
+  });
+  
+  const PolygonObstacle original(contour);
+  PolygonObstacle simplified(contour);
+  simplifyPolygonObstacle(simplified, tolerance);
+  
+  const PolygonRobotFootprint robot(benchmarkRobotPolygon());
+  const PoseSE2 pose(1.6, 0.7, 0.3);
+  runner.run("simplification", "Polygon/PolygonObstacle::calculateDistance (original)", [&]() {
+    return robot.calculateDistance(pose, &original);
+  });
+  runner.run("simplification", "Polygon/PolygonObstacle::calculateDistance (simplified)", [&]() {
+    return robot.calculateDistance(pose, &simplified);
+  });
+  
+  const MicroResult* original_result = findResult(runner.results(), "simplification", "Polygon/PolygonObstacle::calculateDistance (original)");
+  const MicroResult* simplified_result = findResult(runner.results(), "simplification", "Polygon/PolygonObstacle::calculateDistance (simplified)");
+  if (original_result && simplified_result && simplified_result->ns_per_call > 0)
+    std::cerr << "polygon simplification (tolerance " << std::fixed << std::setprecision(2) << tolerance << " m): " << contour.size() << " -> "
+              << simplified.vertices().size() << " vertices, distance speedup " << original_result->ns_per_call / simplified_result->ns_per_call
+              << "x, distance change " << std::setprecision(4) << robot.calculateDistance(pose, &original) - robot.calculateDistance(pose, &simplified)
+              << " m" << std::endl;
+}
+
+
+/**
+ * @brief Measure the corridor prefilter and the association effort with and without it
+ */
+void benchmarkPrefilter(MicroBenchmarkRunner& runner)
+{
+  // occupied cells of a 10 m x 10 m local costmap (every 4th cell of a 0.05 m grid along scattered walls)
+  ObstContainer obstacles;
+  for (int i = 0; i < 40; ++i)
+  {
+    double y = -5.0 + 0.25 * i;
+    for (int j = 0; j < 50; ++j)
+      obstacles.push_back(boost::make_shared<PointObstacle>(-5.0 + 0.2 * j, y + 0.05 * std::sin(0.7 * j)));
+  }
+  
+  // plan and trajectory along a diagonal of the costmap
+  PoseSE2Container plan;
+  for (int i = 0; i < 50; ++i)
+    plan.push_back(PoseSE2(-4.0 + 0.1 * i, -4.0 + 0.1 * i, M_PI / 4));
+  
+  TebConfig filter_cfg;
+  filter_cfg.obstacles.corridor_prefilter = true;
+  RobotFootprintModelPtr robot = boost::make_shared<CircularRobotFootprint>(0.3);
+  ObstacleCorridorFilter filter;
+  filter.initialize(filter_cfg, robot);
+  
+  ObstContainer filtered;
+  runner.run("prefilter", "ObstacleCorridorFilter::filter (2000 points, 50 poses)", [&]() {
+    filtered = obstacles;
+    filter.clear();
+    filter.addPath(plan);
+    return (double) filter.filter(filtered);
+  });
+  
+  // distance computations of AddEdgesObstacles() (each pose against each obstacle)
+  auto associate = [&](const ObstContainer& obst) {
+    double sum = 0;
+    for (const PoseSE2& pose : plan)
+    {
+      for (const ObstaclePtr& o : obst)
+        sum += robot->calculateDistance(pose, o.get());
+    }
+    return sum;
+  };
+  runner.run("prefilter", "association (all obstacles)", [&]() {
+    return associate(obstacles);
+  });
+  runner.run("prefilter", "association (prefiltered obstacles)", [&]() {
+    return associate(filtered);
+  });
+  
+  const MicroResult* filter_result = findResult(runner.results(), "prefilter", "ObstacleCorridorFilter::filter (2000 points, 50 poses)");
+  const MicroResult* all_result = findResult(runner.results(), "prefilter", "association (all obstacles)");
+  const MicroResult* filtered_result = findResult(runner.results(), "prefilter", "association (prefiltered obstacles)");
+  if (filter_result && all_result && filtered_result)
+    std::cerr << "corridor prefilter (margin " << std::fixed << std::setprecision(2) << filter.computeMargin() << " m): " << obstacles.size()
+              << " -> " << filtered.size() << " obstacles, filter " << std::setprecision(1) << filter_result->ns_per_call / 1000.0
+              << " us, association " << all_result->ns_per_call / 1000.0 << " -> " << filtered_result->ns_per_call / 1000.0
+              << " us per outer iteration" << std::endl;
+}
+
+
+void writeResults(std::ostream& os, const std::vector<MicroResult>& results, int iterations, int batches)
+{
+  os << std::fixed << std::setprecision(2);
+  os << "{\n";
+  os << "  \"iterations\": " << iterations << ",\n";
+  os << "  \"batches\": " << batches << ",\n";
+  os << "  \"unit\": \"ns/call\",\n";
+  os << "  \"results\": [\n";
+  for (std::size_t i = 0; i < results.size(); ++i)
+  {
+    os << "    {\"group\": \"" << results[i].group << "\", \"name\": \"" << results[i].name 
+       << "\", \"ns_per_call\": " << results[i].ns_per_call << ", \"ns_min\": " << results[i].ns_min << "}"
+       << (i + 1 == results.size() ? "\n" : ",\n");
+  }
+  os << "  ]\n";
+  os << "}\n";
+}
+
+void printUsage()
+{
+  std::cerr << "Usage: teb_microbenchmark [--iterations N] [--batches N] [--filter SUBSTRING] [--output FILE]" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  int iterations = 100000;
+  int batches = 9;
+  std::string filter;
+  std::string output_file;
+  
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (i + 1 >= argc)
+    {
+      printUsage();
+      return 1;
+    }
+    if (arg == "--iterations")
+      iterations = std::atoi(argv[++i]);
+    else if (arg == "--batches")
+      batches = std::atoi(argv[++i]);
+    else if (arg == "--filter")
+      filter = argv[++i];
+    else if (arg == "--output")
+      output_file = argv[++i];
+    else
+    {
+      printUsage();
+      return 1;
+    }
+  }
+  
+  if (iterations < 1 || batches < 1)
+  {
+    printUsage();
+    return 1;
+  }
+  
+  // only report errors of the planning core in order to keep the benchmark output readable
+  setLogger(boost::make_shared<StreamLogger>(Logger::Error));
+  
+  TebConfig cfg;
+  MicroBenchmarkRunner runner(iterations, batches, filter);
+  benchmarkEdges(runner, cfg);
+  benchmarkDistanceCalculations(runner);
+  benchmarkFootprints(runner);
+  benchmarkEdgeDispatches(runner, cfg);
+  benchmarkSimplification(runner);
+  benchmarkPrefilter(runner);
+  benchmarkTrigCaches(runner, cfg);
+  benchmarkEdgeChains(runner, cfg);
+  
+  // short human readable summary on stderr, machine readable results on stdout / file
+  for (const MicroResult& result : runner.results())
+    std::cerr << std::left << std::setw(12) << result.group << std::setw(72) << result.name 
+              << std::right << std::fixed << std::setprecision(1) << std::setw(10) << result.ns_per_call << " ns/call" << std::endl;
+  
+  if (output_file.empty())
+  {
+    writeResults(std::cout, runner.results(), iterations, batches);
+  }
+  else
+  {
+    std::ofstream file(output_file.c_str());
+    if (!file.is_open())
+    {
+      std::cerr << "Cannot open output file " << output_file << std::endl;
+      return 1;
+    }
+    writeResults(file, runner.results(), iterations, batches);
+  }
+  return 0;
+}
@@ -0,0 +1,398 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/optimal_planner.h>
+#include <teb_local_planner/homotopy_class_planner.h>
+#include <teb_local_planner/benchmark/benchmark_scenarios.h>
+#include <teb_local_planner/benchmark/benchmark_statistics.h>
+#include <teb_local_planner/logging.h>
+
+#include <boost/make_shared.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+
+
+using namespace teb_local_planner; // it is ok here to import everything for benchmarking purposes
+
+/*
+ * Performance regression check against a stored baseline.
+ * 
+ * A fixed set of synthetic planning problems (all benchmark scenarios) is replayed through the
+ * TebOptimalPlanner and the HomotopyClassPlanner. Wall time, heap allocations, solver iterations
+ * and final cost are compared to the baseline file. The program returns a non-zero exit code
+ * if any metric regresses beyond its tolerance, hence it can be invoked by CI.
+ * Use --record in order to (re-)write the baseline after an intended change.
+ * Combinations without a baseline entry are only reported, unless --require-baseline is given:
+ * then a missing entry fails the check as well, which is the mode CI should use.
+ * Wall times depend on the machine: with --ignore_time they are neither checked nor recorded ("-" in the
+ * baseline file), hence only the deterministic metrics (allocations, iterations, cost) are compared.
+ * This is the mode of the registered test (see CMakeLists.txt).
+ * 
+ * Usage: teb_perf_regression [--baseline FILE] [--record] [--require-baseline] [--ignore_time] [--repetitions N] [--cycles N]
+ *                            [--time_tolerance REL] [--count_tolerance REL] [--cost_tolerance REL]
+ */
+
+#ifndef TEB_PERF_BASELINE_FILE
+#define TEB_PERF_BASELINE_FILE "perf_baseline.csv"
+#endif
+
+
+// ============== Heap allocation accounting ===================
+// The global allocation functions are replaced for this executable only.
+#include <teb_local_planner/allocation_tracker_hooks.h>
+
+
+//! Metrics of a single scenario/planner combination
+struct PerfMetrics
+{
+  double wall_time_ms = 0; //!< Median wall time of a warm-started plan() call
+  double allocations = 0; //!< Mean number of heap allocations per plan() call
+  double iterations = 0; //!< Mean number of solver iterations per plan() call
+  double final_cost = 0; //!< Mean cost of the (best) trajectory after the last cycle
+};
+
+//! Relative tolerances for the regression check
+struct PerfTolerances
+{
+  double time = 0.25;
+  double count = 0.05;
+  double cost = 0.05;
+};
+
+typedef std::map<std::string, PerfMetrics> PerfBaseline; //!< key: "scenario,planner"
+
+
+void measure(const std::string& scenario_name, const std::string& planner_name, int repetitions, int cycles, PerfMetrics& metrics)
+{
+  std::vector<double> latencies_ms;
+  std::vector<double> allocations;
+  std::vector<double> iterations;
+  std::vector<double> final_costs;
+  
+  for (int rep = 0; rep < repetitions; ++rep)
+  {
+    BenchmarkScenario scenario;
+    createBenchmarkScenario(scenario_name, scenario);
+    
+    TebConfig cfg;
+    scenario.applyConfig(cfg);
+    cfg.hcp.enable_homotopy_class_planning = (planner_name == "hcp");
+    cfg.hcp.enable_multithreading = false; // deterministic allocation and iteration counts
+    
+    TebOptimalPlannerPtr teb_planner;
+    boost::shared_ptr<HomotopyClassPlanner> hcp_planner;
+    PlannerInterfacePtr planner;
+    if (cfg.hcp.enable_homotopy_class_planning)
+    {
+      hcp_planner = boost::make_shared<HomotopyClassPlanner>(cfg, &scenario.obstacles, scenario.robot_model, &scenario.via_points);
+      planner = hcp_planner;
+    }
+    else
+    {
+      teb_planner = boost::make_shared<TebOptimalPlanner>(cfg, &scenario.obstacles, scenario.robot_model, &scenario.via_points);
+      planner = teb_planner;
+    }
+    
+    Twist2D start_vel; // robot is at rest
+    bool plan_ok = false;
+    for (int cycle = 0; cycle < cycles; ++cycle)
+    {
+      AllocationTracker::reset();
+      std::chrono::steady_clock::time_point t_start = std::chrono::steady_clock::now();
+      plan_ok = planner->plan(scenario.start, scenario.goal, &start_vel, cfg.goal_tolerance.free_goal_vel);
+      std::chrono::steady_clock::time_point t_end = std::chrono::steady_clock::now();
+      AllocationStats alloc_stats;
+      AllocationTracker::getStats(alloc_stats);
+      
+      if (cycle > 0) // the cold start is not representative for the control loop
+        latencies_ms.push_back(std::chrono::duration<double, std::milli>(t_end - t_start).count());
+      allocations.push_back(double(alloc_stats.totalCount()));
+      
+      int cycle_iterations = 0;
+      if (teb_planner)
+        cycle_iterations = teb_planner->getLastIterations();
+      else
+      {
+        for (const TebOptimalPlannerPtr& teb : hcp_planner->getTrajectoryContainer())
+          cycle_iterations += teb->getLastIterations();
+      }
+      iterations.push_back(cycle_iterations);
+      
+      advanceDynamicObstacles(scenario, 0.1);
+    }
+    
+    TebOptimalPlannerPtr best = teb_planner ? teb_planner : hcp_planner->bestTeb();
+    if (best && plan_ok)
+    {
+      best->computeCurrentCost();
+      final_costs.push_back(best->getCurrentCost());
+    }
+  }
+  
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  metrics.wall_time_ms = percentile(latencies_ms, 50);
+  metrics.allocations = mean(allocations);
+  metrics.iterations = mean(iterations);
+  metrics.final_cost = mean(final_costs);
+}
+
+
+bool readBaseline(const std::string& filename, PerfBaseline& baseline)
+{
+  std::ifstream file(filename.c_str());
+  if (!file.is_open())
+    return false;
+  
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+    
+    std::stringstream ss(line);
+    std::string scenario, planner, value;
+    std::vector<double> values;
+    std::getline(ss, scenario, ',');
+    std::getline(ss, planner, ',');
+    while (std::getline(ss, value, ','))
+      values.push_back(value == "-" ? std::numeric_limits<double>::quiet_NaN() : std::atof(value.c_str())); // "-": not recorded
+    if (values.size() != 4)
+    {
+      std::cerr << "teb_perf_regression: ignoring malformed baseline entry: " << line << std::endl;
+      continue;
+    }
+    
+    PerfMetrics& metrics = baseline[scenario + "," + planner];
+    metrics.wall_time_ms = values[0];
+    metrics.allocations = values[1];
+    metrics.iterations = values[2];
+    metrics.final_cost = values[3];
+  }
+  return true;
+}
+
+
+bool writeBaseline(const std::string& filename, const PerfBaseline& baseline)
+{
+  // keep the comment header of an existing baseline
+  std::vector<std::string> header;
+  std::ifstream in(filename.c_str());
+  std::string line;
+  while (in.is_open() && std::getline(in, line) && !line.empty() && line[0] == '#')
+    header.push_back(line);
+  in.close();
+  
+  std::ofstream file(filename.c_str());
+  if (!file.is_open())
+    return false;
+  
+  for (const std::string& comment : header)
+    file << comment << "\n";
+  file << std::setprecision(6);
+  for (const PerfBaseline::value_type& entry : baseline)
+  {
+    file << entry.first << ",";
+    if (std::isnan(entry.second.wall_time_ms))
+      file << "-";
+    else
+      file << entry.second.wall_time_ms;
+    file << "," << entry.second.allocations << "," << entry.second.iterations << "," << entry.second.final_cost << "\n";
+  }
+  return true;
+}
+
+
+/**
+ * @brief Compare a single metric and print the result
+ * @return \c true if the metric did not regress beyond the tolerance
+ */
+bool checkMetric(const std::string& name, double value, double baseline, double rel_tolerance, double abs_tolerance)
+{
+  if (std::isnan(baseline))
+  {
+    std::cout << "    " << std::left << std::setw(14) << name << std::right << std::setw(12) << value << "  (not recorded)" << std::endl;
+    return true;
+  }
+  double limit = baseline * (1.0 + rel_tolerance) + abs_tolerance;
+  bool ok = value <= limit;
+  std::cout << "    " << std::left << std::setw(14) << name << std::right << std::setw(12) << value
+            << "  (baseline " << baseline << ", limit " << limit << ")" << (ok ? "" : "  REGRESSION") << std::endl;
+  return ok;
+}
+
+
+void printUsage()
+{
+  std::cerr << "Usage: teb_perf_regression [--baseline FILE] [--record] [--require-baseline] [--ignore_time] [--repetitions N] [--cycles N] "
+            << "[--time_tolerance REL] [--count_tolerance REL] [--cost_tolerance REL]" << std::endl;
+}
+
+
+int main(int argc, char** argv)
+{
+  std::string baseline_file = TEB_PERF_BASELINE_FILE;
+  bool record = false;
+  bool require_baseline = false;
+  bool ignore_time = false;
+  int repetitions = 5;
+  int cycles = 10;
+  PerfTolerances tolerances;
+  
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--record")
+    {
+      record = true;
+      continue;
+    }
+    if (arg == "--require-baseline")
+    {
+      require_baseline = true;
+      continue;
+    }
+    if (arg == "--ignore_time")
+    {
+      ignore_time = true;
+      continue;
+    }
+    if (i + 1 >= argc)
+    {
+      printUsage();
+      return 1;
+    }
+    if (arg == "--baseline")
+      baseline_file = argv[++i];
+    else if (arg == "--repetitions")
+      repetitions = std::atoi(argv[++i]);
+    else if (arg == "--cycles")
+      cycles = std::atoi(argv[++i]);
+    else if (arg == "--time_tolerance")
+      tolerances.time = std::atof(argv[++i]);
+    else if (arg == "--count_tolerance")
+      tolerances.count = std::atof(argv[++i]);
+    else if (arg == "--cost_tolerance")
+      tolerances.cost = std::atof(argv[++i]);
+    else
+    {
+      printUsage();
+      return 1;
+    }
+  }
+  
+  if (repetitions < 1 || cycles < 2)
+  {
+    printUsage();
+    return 1;
+  }
+  
+  // only report errors of the planning core in order to keep the output readable
+  setLogger(boost::make_shared<StreamLogger>(Logger::Error));
+  
+  PerfBaseline baseline;
+  if (!record && !readBaseline(baseline_file, baseline))
+  {
+    std::cerr << "teb_perf_regression: cannot read baseline file " << baseline_file << std::endl;
+    return 1;
+  }
+  
+  PerfBaseline current;
+  bool regression = false;
+  std::vector<std::string> planners = {"teb", "hcp"};
+  for (const std::string& scenario : benchmarkScenarioNames())
+  {
+    for (const std::string& planner : planners)
+    {
+      std::string key = scenario + "," + planner;
+      PerfMetrics& metrics = current[key];
+      measure(scenario, planner, repetitions, cycles, metrics);
+      if (ignore_time)
+        metrics.wall_time_ms = std::numeric_limits<double>::quiet_NaN();
+      
+      if (record)
+      {
+        std::cout << key << ": recorded" << std::endl;
+        continue;
+      }
+      
+      PerfBaseline::const_iterator it = baseline.find(key);
+      if (it == baseline.end())
+      {
+        std::cout << key << ": no baseline available" << (require_baseline ? "  MISSING" : "") << std::endl;
+        regression = regression || require_baseline;
+        continue;
+      }
+      
+      std::cout << key << ":" << std::endl;
+      bool ok = true;
+      if (!ignore_time)
+        ok &= checkMetric("wall_time_ms", metrics.wall_time_ms, it->second.wall_time_ms, tolerances.time, 0.05);
+      ok &= checkMetric("allocations", metrics.allocations, it->second.allocations, tolerances.count, 1);
+      ok &= checkMetric("iterations", metrics.iterations, it->second.iterations, tolerances.count, 0.5);
+      ok &= checkMetric("final_cost", metrics.final_cost, it->second.final_cost, tolerances.cost, 1e-6);
+      regression = regression || !ok;
+    }
+  }
+  
+  if (record)
+  {
+    if (!writeBaseline(baseline_file, current))
+    {
+      std::cerr << "teb_perf_regression: cannot write baseline file " << baseline_file << std::endl;
+      return 1;
+    }
+    std::cout << "Baseline written to " << baseline_file << std::endl;
+    return 0;
+  }
+  
+  if (regression)
+  {
+    std::cout << (require_baseline ? "Performance regression or missing baseline detected." : "Performance regression detected.") << std::endl;
+    return 2;
+  }
+  std::cout << "No performance regression detected." << std::endl;
+  return 0;
+}
@@ -0,0 +1,254 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/benchmark/benchmark_scenarios.h>
+#include <teb_local_planner/benchmark/benchmark_statistics.h>
+#include <teb_local_planner/benchmark/closed_loop_simulation.h>
+#include <teb_local_planner/logging.h>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+
+using namespace teb_local_planner; // it is ok here to import everything for benchmarking purposes
+
+/*
+ * Headless closed-loop simulation of complete missions.
+ * 
+ * For each scenario and planner the robot is driven from start to goal by the planner in closed loop.
+ * The robot (differential drive, holonomic or car-like) and the dynamic obstacles are simulated with
+ * a fixed control period, hence missions run faster than real time.
+ * Reported metrics: control cycle time distribution, planning cycles per second, collisions,
+ * time-to-goal and recovery events. Results are written as JSON to stdout or to the file given with --output.
+ * 
+ * Usage: teb_simulation [--scenario NAME] [--planner teb|hcp] [--kinematics diff_drive|holonomic|carlike]
+ *                       [--dt T] [--max_duration T] [--event_driven 0|1] [--speculative 0|1] [--multi_start K]
+ *                       [--corridor_prefilter 0|1] [--output FILE]
+ * 
+ * With --event_driven 1 the previous trajectory is only refined in cycles without changes (see ReplanningMonitor).
+ * With --speculative 1 the trajectory of the next cycle is optimized while the robot is simulated (see SpeculativePlanner);
+ * the reported planning times then only cover the cycles in which the speculative result has been rejected.
+ * With --multi_start K the teb planner optimizes K initializations per cycle (see TebOptimalPlanner::optimizeMultiStart()).
+ * With --corridor_prefilter 1 obstacles outside the corridor around the plan and the trajectories are removed (see ObstacleCorridorFilter).
+ */
+
+void writeResult(std::ostream& os, const std::string& scenario, const std::string& planner, RobotKinematics kinematics,
+                 SimulationResult& result, bool last)
+{
+  std::sort(result.cycle_times_ms.begin(), result.cycle_times_ms.end());
+  std::sort(result.planning_times_ms.begin(), result.planning_times_ms.end());
+  
+  double mean_cycle_time = mean(result.cycle_times_ms);
+  
+  os << "    {\n";
+  os << "      \"scenario\": \"" << scenario << "\",\n";
+  os << "      \"planner\": \"" << planner << "\",\n";
+  os << "      \"kinematics\": \"" << kinematicsToString(kinematics) << "\",\n";
+  os << "      \"goal_reached\": " << (result.goal_reached ? "true" : "false") << ",\n";
+  os << "      \"time_to_goal\": " << result.time_to_goal << ",\n";
+  os << "      \"path_length\": " << result.path_length << ",\n";
+  os << "      \"cycles\": " << result.cycle_times_ms.size() << ",\n";
+  os << "      \"cycle_time_ms\": {\"mean\": " << mean_cycle_time
+     << ", \"p50\": " << percentile(result.cycle_times_ms, 50)
+     << ", \"p90\": " << percentile(result.cycle_times_ms, 90)
+     << ", \"p99\": " << percentile(result.cycle_times_ms, 99)
+     << ", \"max\": " << maximum(result.cycle_times_ms) << "},\n";
+  os << "      \"planning_time_ms\": {\"mean\": " << mean(result.planning_times_ms)
+     << ", \"p99\": " << percentile(result.planning_times_ms, 99)
+     << ", \"max\": " << maximum(result.planning_times_ms) << "},\n";
+  os << "      \"cycles_per_second\": " << (mean_cycle_time > 0 ? 1000.0 / mean_cycle_time : 0.0) << ",\n";
+  os << "      \"real_time_factor\": " << (result.wall_time > 0 ? result.time_to_goal / result.wall_time : 0.0) << ",\n";
+  os << "      \"collision_events\": " << result.collision_events << ",\n";
+  os << "      \"collision_cycles\": " << result.collision_cycles << ",\n";
+  os << "      \"min_clearance\": " << result.min_clearance << ",\n";
+  os << "      \"recovery\": {\"planning_failures\": " << result.planning_failures
+     << ", \"infeasible_trajectories\": " << result.infeasible_trajectories
+     << ", \"invalid_commands\": " << result.invalid_commands
+     << ", \"horizon_reductions\": " << result.horizon_reductions
+     << ", \"oscillation_recoveries\": " << result.oscillation_recoveries << "},\n";
+  os << "      \"refinements\": " << result.refinements << ",\n";
+  os << "      \"speculative_hits\": " << result.speculative_hits << "\n";
+  os << "    }" << (last ? "\n" : ",\n");
+}
+
+void printUsage()
+{
+  std::cerr << "Usage: teb_simulation [--scenario NAME] [--planner teb|hcp] [--kinematics diff_drive|holonomic|carlike] "
+            << "[--dt T] [--max_duration T] [--event_driven 0|1] [--speculative 0|1] [--multi_start K] [--corridor_prefilter 0|1] [--output FILE]" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  SimulationSettings settings;
+  std::string scenario_filter;
+  std::string planner_filter;
+  std::string kinematics_name; // empty: car-like for car-like scenarios, differential drive otherwise
+  std::string output_file;
+  bool event_driven = false;
+  bool speculative = false;
+  int multi_start = 1;
+  bool corridor_prefilter = false;
+  
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (i + 1 >= argc)
+    {
+      printUsage();
+      return 1;
+    }
+    if (arg == "--scenario")
+      scenario_filter = argv[++i];
+    else if (arg == "--planner")
+      planner_filter = argv[++i];
+    else if (arg == "--kinematics")
+      kinematics_name = argv[++i];
+    else if (arg == "--dt")
+      settings.dt = std::atof(argv[++i]);
+    else if (arg == "--max_duration")
+      settings.max_duration = std::atof(argv[++i]);
+    else if (arg == "--event_driven")
+      event_driven = std::atoi(argv[++i]) != 0;
+    else if (arg == "--speculative")
+      speculative = std::atoi(argv[++i]) != 0;
+    else if (arg == "--multi_start")
+      multi_start = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "--corridor_prefilter")
+      corridor_prefilter = std::atoi(argv[++i]) != 0;
+    else if (arg == "--output")
+      output_file = argv[++i];
+    else
+    {
+      printUsage();
+      return 1;
+    }
+  }
+  
+  RobotKinematics kinematics = RobotKinematics::DiffDrive;
+  if ((!kinematics_name.empty() && !kinematicsFromString(kinematics_name, kinematics)) || settings.dt <= 0 || settings.max_duration <= 0)
+  {
+    printUsage();
+    return 1;
+  }
+  
+  // only report errors of the planning core in order to keep the output readable
+  setLogger(boost::make_shared<StreamLogger>(Logger::Error));
+  
+  std::vector<std::string> scenarios;
+  for (const std::string& scenario : benchmarkScenarioNames())
+  {
+    if (scenario_filter.empty() || scenario == scenario_filter)
+      scenarios.push_back(scenario);
+  }
+  std::vector<std::string> planners;
+  for (const char* planner : {"teb", "hcp"})
+  {
+    if (planner_filter.empty() || planner == planner_filter)
+      planners.push_back(planner);
+  }
+  
+  if (scenarios.empty() || planners.empty())
+  {
+    std::cerr << "teb_simulation: no scenario/planner matches the given filters." << std::endl;
+    return 1;
+  }
+  
+  std::ofstream file;
+  if (!output_file.empty())
+  {
+    file.open(output_file.c_str());
+    if (!file.is_open())
+    {
+      std::cerr << "teb_simulation: cannot open output file " << output_file << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& os = output_file.empty() ? std::cout : file;
+  os << std::setprecision(6);
+  
+  os << "{\n";
+  os << "  \"simulation\": \"teb_local_planner\",\n";
+  os << "  \"dt\": " << settings.dt << ",\n";
+  os << "  \"max_duration\": " << settings.max_duration << ",\n";
+  os << "  \"event_driven\": " << (event_driven ? "true" : "false") << ",\n";
+  os << "  \"speculative\": " << (speculative ? "true" : "false") << ",\n";
+  os << "  \"multi_start\": " << multi_start << ",\n";
+  os << "  \"corridor_prefilter\": " << (corridor_prefilter ? "true" : "false") << ",\n";
+  os << "  \"results\": [\n";
+  
+  std::size_t no_jobs = scenarios.size() * planners.size();
+  std::size_t job = 0;
+  for (const std::string& scenario_name : scenarios)
+  {
+    for (const std::string& planner_name : planners)
+    {
+      BenchmarkScenario scenario;
+      createBenchmarkScenario(scenario_name, scenario);
+      
+      TebConfig cfg;
+      scenario.applyConfig(cfg);
+      cfg.hcp.enable_homotopy_class_planning = (planner_name == "hcp");
+      cfg.replanning.event_driven = event_driven;
+      cfg.replanning.speculative = speculative;
+      cfg.optim.multi_start_candidates = multi_start;
+      cfg.obstacles.corridor_prefilter = corridor_prefilter;
+      
+      settings.kinematics = kinematics;
+      if (kinematics_name.empty() && cfg.robot.min_turning_radius > 0)
+        settings.kinematics = RobotKinematics::CarLike;
+      applyKinematics(settings.kinematics, cfg);
+      
+      std::cerr << "teb_simulation: " << scenario_name << " / " << planner_name << " / " << kinematicsToString(settings.kinematics) << std::endl;
+      
+      ClosedLoopSimulation simulation(scenario, cfg, settings);
+      SimulationResult result;
+      simulation.run(result);
+      
+      writeResult(os, scenario_name, planner_name, settings.kinematics, result, ++job == no_jobs);
+    }
+  }
+  
+  os << "  ]\n";
+  os << "}\n";
+  return 0;
+}
@@ -0,0 +1,341 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/g2o_types/edge_chain_batch.h>
+#include <teb_local_planner/timed_elastic_band.h>
+
+namespace teb_local_planner
+{
+
+namespace
+{
+
+//! Step size of the numeric differentiation (identical to g2o::BaseMultiEdge and g2o::BaseBinaryEdge)
+const double kNumericDelta = 1e-9;
+
+/**
+ * @brief Adapters between the generic batch loops and the error kernels
+ * 
+ * The vertices of an edge are ordered as poses followed by time diffs,
+ * pose p is located at first_index + p and time diff t at first_index + t.
+ */
+struct VelocityKernel
+{
+  static const int Dimension = 2;
+  static const int NoPoses = 2;
+  static const int NoTimeDiffs = 1;
+  static void evaluate(const TebConfig& cfg, const PoseSample* poses, const double* time_diffs, double* error)
+  {
+    velocityErrorKernel(cfg, poses[0], poses[1], time_diffs[0], error);
+  }
+};
+
+struct AccelerationKernel
+{
+  static const int Dimension = 2;
+  static const int NoPoses = 3;
+  static const int NoTimeDiffs = 2;
+  static void evaluate(const TebConfig& cfg, const PoseSample* poses, const double* time_diffs, double* error)
+  {
+    accelerationErrorKernel(cfg, poses[0], poses[1], poses[2], time_diffs[0], time_diffs[1], error);
+  }
+};
+
+struct KinematicsDiffDriveKernel
+{
+  static const int Dimension = 2;
+  static const int NoPoses = 2;
+  static const int NoTimeDiffs = 0;
+  static void evaluate(const TebConfig& cfg, const PoseSample* poses, const double* time_diffs, double* error)
+  {
+    kinematicsDiffDriveErrorKernel(poses[0], poses[1], error);
+  }
+};
+
+struct KinematicsCarlikeKernel
+{
+  static const int Dimension = 2;
+  static const int NoPoses = 2;
+  static const int NoTimeDiffs = 0;
+  static void evaluate(const TebConfig& cfg, const PoseSample* poses, const double* time_diffs, double* error)
+  {
+    kinematicsCarlikeErrorKernel(cfg, poses[0], poses[1], error);
+  }
+};
+
+//! Error dimension and vertex layout of each chain type (indexed by EdgeChainType)
+const int kChainDimension[NoEdgeChainTypes] = {VelocityKernel::Dimension, AccelerationKernel::Dimension,
+                                               KinematicsDiffDriveKernel::Dimension, KinematicsCarlikeKernel::Dimension};
+const int kChainNoPoses[NoEdgeChainTypes] = {VelocityKernel::NoPoses, AccelerationKernel::NoPoses,
+                                             KinematicsDiffDriveKernel::NoPoses, KinematicsCarlikeKernel::NoPoses};
+const int kChainNoTimeDiffs[NoEdgeChainTypes] = {VelocityKernel::NoTimeDiffs, AccelerationKernel::NoTimeDiffs,
+                                                 KinematicsDiffDriveKernel::NoTimeDiffs, KinematicsCarlikeKernel::NoTimeDiffs};
+
+} // anonymous namespace
+
+
+EdgeChainBatch::EdgeChainBatch() : cfg_(nullptr), teb_(nullptr), active_(false), generation_(1), jacobians_generation_(0), invalidate_action_(this)
+{
+}
+
+void EdgeChainBatch::initialize(const TebConfig& cfg, const TimedElasticBand& teb)
+{
+  cfg_ = &cfg;
+  teb_ = &teb;
+}
+
+int EdgeChainBatch::addEdge(EdgeChainType type, int first_index)
+{
+  TEB_ASSERT_MSG(teb_, "You must call initialize on EdgeChainBatch()");
+  std::vector<int>& first_indices = chains_[static_cast<int>(type)].first_index;
+  first_indices.push_back(first_index);
+  invalidate();
+  return (int)first_indices.size() - 1;
+}
+
+void EdgeChainBatch::clear()
+{
+  for (Chain& chain : chains_)
+    chain.first_index.clear();
+  active_ = false;
+  invalidate();
+}
+
+bool EdgeChainBatch::empty() const
+{
+  for (const Chain& chain : chains_)
+  {
+    if (!chain.first_index.empty())
+      return false;
+  }
+  return true;
+}
+
+void EdgeChainBatch::setActive(bool active)
+{
+  active_ = active;
+  invalidate();
+}
+
+bool EdgeChainBatch::getJacobians(EdgeChainType type, int index, double* const* jacobians)
+{
+  if (!active_)
+    return false;
+  
+  updateJacobians();
+  
+  const int type_idx = static_cast<int>(type);
+  const Chain& chain = chains_[type_idx];
+  const int n = (int)chain.first_index.size();
+  const int dim = kChainDimension[type_idx];
+  TEB_ASSERT(index >= 0 && index < n);
+  
+  int col = 0; // column of the stacked jacobian of all vertices
+  const int no_vertices = kChainNoPoses[type_idx] + kChainNoTimeDiffs[type_idx];
+  for (int v = 0; v < no_vertices; ++v)
+  {
+    const int vertex_dim = v < kChainNoPoses[type_idx] ? 3 : 1;
+    double* jacobian = jacobians[v];
+    for (int c = 0; c < vertex_dim; ++c, ++col)
+    {
+      for (int r = 0; r < dim; ++r)
+        jacobian[c*dim + r] = chain.jacobians[(col*dim + r)*n + index];
+    }
+  }
+  return true;
+}
+
+void EdgeChainBatch::gatherStates()
+{
+  const int no_poses = teb_->sizePoses();
+  const int no_time_diffs = teb_->sizeTimeDiffs();
+  
+  poses_.resize(no_poses);
+  for (int i = 0; i < no_poses; ++i)
+    poses_[i] = PoseSample::fromVertex(*teb_->poses()[i]);
+  
+  time_diffs_.resize(no_time_diffs);
+  for (int i = 0; i < no_time_diffs; ++i)
+    time_diffs_[i] = teb_->timediffs()[i]->dt();
+  
+  // Reproduce VertexPose::oplusImpl() for an update vector with a single nonzero element:
+  // the position is incremented and the yaw angle is normalized in any case.
+  poses_shifted_.resize(no_poses);
+  poses_theta_plus_.resize(no_poses);
+  poses_theta_minus_.resize(no_poses);
+  
+  for (int i = 0; i < no_poses; ++i)
+  {
+    const PoseSample& pose = poses_[i];
+    
+    PoseSample& shifted = poses_shifted_[i];
+    shifted.x = pose.x + 0.;
+    shifted.y = pose.y + 0.;
+    shifted.theta = g2o::normalize_theta(pose.theta + 0.);
+    if (shifted.theta == pose.theta)
+    {
+      shifted.cos_theta = pose.cos_theta;
+      shifted.sin_theta = pose.sin_theta;
+    }
+    else
+    {
+      shifted.cos_theta = std::cos(shifted.theta);
+      shifted.sin_theta = std::sin(shifted.theta);
+    }
+    
+    PoseSample& plus = poses_theta_plus_[i];
+    plus = shifted;
+    plus.theta = g2o::normalize_theta(pose.theta + kNumericDelta);
+    plus.cos_theta = std::cos(plus.theta);
+    plus.sin_theta = std::sin(plus.theta);
+    
+    PoseSample& minus = poses_theta_minus_[i];
+    minus = shifted;
+    minus.theta = g2o::normalize_theta(pose.theta - kNumericDelta);
+    minus.cos_theta = std::cos(minus.theta);
+    minus.sin_theta = std::sin(minus.theta);
+  }
+}
+
+void EdgeChainBatch::updateJacobians()
+{
+  const unsigned int generation = generation_.load();
+  if (jacobians_generation_.load() == generation)
+    return;
+  
+  boost::mutex::scoped_lock lock(mutex_);
+  if (jacobians_generation_.load() == generation)
+    return; // updated by another thread in the meantime
+  
+  gatherStates();
+  
+  computeNumericJacobians<VelocityKernel>(chains_[static_cast<int>(EdgeChainType::Velocity)]);
+  computeNumericJacobians<AccelerationKernel>(chains_[static_cast<int>(EdgeChainType::Acceleration)]);
+#ifdef USE_ANALYTIC_JACOBI
+  computeKinematicsDiffDriveJacobians(chains_[static_cast<int>(EdgeChainType::KinematicsDiffDrive)]);
+#else
+  computeNumericJacobians<KinematicsDiffDriveKernel>(chains_[static_cast<int>(EdgeChainType::KinematicsDiffDrive)]);
+#endif
+  computeNumericJacobians<KinematicsCarlikeKernel>(chains_[static_cast<int>(EdgeChainType::KinematicsCarlike)]);
+  
+  jacobians_generation_ = generation;
+}
+
+template <typename Kernel>
+void EdgeChainBatch::computeNumericJacobians(Chain& chain)
+{
+  const int n = (int)chain.first_index.size();
+  const int dim = Kernel::Dimension;
+  chain.jacobians.resize(dim * (3*Kernel::NoPoses + Kernel::NoTimeDiffs) * n);
+  
+  // identical to the central differences of g2o: J = 1/(2*delta) * (e(x+delta) - e(x-delta))
+  const double scalar = 1.0 / (2*kNumericDelta);
+  
+  PoseSample poses[Kernel::NoPoses];
+  double time_diffs[Kernel::NoTimeDiffs + 1]; // avoid zero-sized array
+  double error_plus[Kernel::Dimension];
+  double error_minus[Kernel::Dimension];
+  
+  for (int k = 0; k < n; ++k)
+  {
+    const int first = chain.first_index[k];
+    for (int p = 0; p < Kernel::NoPoses; ++p)
+      poses[p] = poses_[first + p];
+    for (int t = 0; t < Kernel::NoTimeDiffs; ++t)
+      time_diffs[t] = time_diffs_[first + t];
+    
+    int col = 0;
+    for (int p = 0; p < Kernel::NoPoses; ++p)
+    {
+      const PoseSample& shifted = poses_shifted_[first + p];
+      for (int d = 0; d < 3; ++d, ++col)
+      {
+        poses[p] = d < 2 ? shifted : poses_theta_plus_[first + p];
+        if (d == 0)
+          poses[p].x = poses_[first + p].x + kNumericDelta;
+        else if (d == 1)
+          poses[p].y = poses_[first + p].y + kNumericDelta;
+        Kernel::evaluate(*cfg_, poses, time_diffs, error_plus);
+        
+        poses[p] = d < 2 ? shifted : poses_theta_minus_[first + p];
+        if (d == 0)
+          poses[p].x = poses_[first + p].x - kNumericDelta;
+        else if (d == 1)
+          poses[p].y = poses_[first + p].y - kNumericDelta;
+        Kernel::evaluate(*cfg_, poses, time_diffs, error_minus);
+        
+        for (int r = 0; r < dim; ++r)
+          chain.jacobians[(col*dim + r)*n + k] = scalar * (error_plus[r] - error_minus[r]);
+      }
+      poses[p] = poses_[first + p];
+    }
+    
+    for (int t = 0; t < Kernel::NoTimeDiffs; ++t, ++col)
+    {
+      time_diffs[t] = time_diffs_[first + t] + kNumericDelta;
+      Kernel::evaluate(*cfg_, poses, time_diffs, error_plus);
+      time_diffs[t] = time_diffs_[first + t] - kNumericDelta;
+      Kernel::evaluate(*cfg_, poses, time_diffs, error_minus);
+      time_diffs[t] = time_diffs_[first + t];
+      
+      for (int r = 0; r < dim; ++r)
+        chain.jacobians[(col*dim + r)*n + k] = scalar * (error_plus[r] - error_minus[r]);
+    }
+  }
+}
+
+void EdgeChainBatch::computeKinematicsDiffDriveJacobians(Chain& chain)
+{
+  const int n = (int)chain.first_index.size();
+  const int dim = KinematicsDiffDriveKernel::Dimension;
+  chain.jacobians.resize(dim * 6 * n);
+  
+  double jacobians[2][6];
+  for (int k = 0; k < n; ++k)
+  {
+    const int first = chain.first_index[k];
+    kinematicsDiffDriveJacobianKernel(poses_[first], poses_[first + 1], jacobians[0], jacobians[1]);
+    for (int v = 0; v < 2; ++v)
+    {
+      for (int i = 0; i < 6; ++i) // i = c*dim + r
+        chain.jacobians[(v*6 + i)*n + k] = jacobians[v][i];
+    }
+  }
+}
+
+} // namespace teb_local_planner
@@ -0,0 +1,394 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/experience_cache.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <typeinfo>
+
+
+namespace teb_local_planner
+{
+
+namespace
+{
+
+//! Add a length to the geometry hash of a footprint model (rounded to millimeters)
+inline void hashLength(std::size_t& seed, double value)
+{
+  boost::hash_combine(seed, std::llround(value * 1000.0));
+}
+
+//! Add a 2d point to the geometry hash of a footprint model (rounded to millimeters)
+inline void hashPoint(std::size_t& seed, const Eigen::Vector2d& point)
+{
+  hashLength(seed, point.x());
+  hashLength(seed, point.y());
+}
+
+/**
+ * @brief Hash the geometry of a footprint model
+ * 
+ * Unknown (user defined) models are described by their inscribed and circumscribed radius only.
+ */
+std::size_t footprintGeometryHash(BaseRobotFootprintModel& robot_model)
+{
+  std::size_t seed = 0;
+  switch (footprintType(&robot_model))
+  {
+    case FootprintType::Point:
+      break;
+    case FootprintType::Circular:
+      hashLength(seed, static_cast<const CircularRobotFootprint&>(robot_model).getRadius());
+      break;
+    case FootprintType::TwoCircles:
+    {
+      const TwoCirclesRobotFootprint& model = static_cast<const TwoCirclesRobotFootprint&>(robot_model);
+      hashLength(seed, model.getFrontOffset());
+      hashLength(seed, model.getFrontRadius());
+      hashLength(seed, model.getRearOffset());
+      hashLength(seed, model.getRearRadius());
+      break;
+    }
+    case FootprintType::Line:
+    {
+      const LineRobotFootprint& model = static_cast<const LineRobotFootprint&>(robot_model);
+      hashPoint(seed, model.getLineStart());
+      hashPoint(seed, model.getLineEnd());
+      break;
+    }
+    case FootprintType::Polygon:
+    {
+      const Point2dContainer& vertices = static_cast<const PolygonRobotFootprint&>(robot_model).getVertices();
+      for (Point2dContainer::const_iterator it = vertices.begin(); it != vertices.end(); ++it)
+        hashPoint(seed, *it);
+      break;
+    }
+    case FootprintType::MultiCircles:
+    {
+      const MultiCirclesRobotFootprint::CircleContainer& circles = static_cast<const MultiCirclesRobotFootprint&>(robot_model).getCircles();
+      for (MultiCirclesRobotFootprint::CircleContainer::const_iterator it = circles.begin(); it != circles.end(); ++it)
+      {
+        hashPoint(seed, it->center);
+        hashLength(seed, it->radius);
+      }
+      break;
+    }
+    default:
+      hashLength(seed, robot_model.getInscribedRadius());
+      hashLength(seed, robot_model.getCircumscribedRadius());
+      break;
+  }
+  return seed;
+}
+
+} // anonymous namespace
+
+
+int ExperienceDescriptor::cellMismatch(const ExperienceDescriptor& other) const
+{
+  uint64_t diff = occupancy ^ other.occupancy;
+  int count = 0;
+  for (; diff; ++count)
+    diff &= diff - 1; // clear the lowest set bit
+  return count;
+}
+
+
+ExperienceCache::ExperienceCache(int max_entries, double grid_resolution) : max_entries_(std::max(1, max_entries)), grid_resolution_(grid_resolution),
+                                                                           use_counter_(0), hits_(0), misses_(0)
+{
+  entries_.reserve(max_entries_);
+}
+
+void ExperienceCache::describe(const PoseSE2& start, const PoseSE2& goal, const ObstContainer* obstacles, const std::string& robot,
+                               ExperienceDescriptor& descriptor) const
+{
+  Eigen::Rotation2Dd world_to_start(-start.theta());
+  descriptor.relative_goal = PoseSE2(world_to_start * (goal.position() - start.position()), g2o::normalize_theta(goal.theta() - start.theta()));
+  descriptor.robot = robot;
+  descriptor.occupancy = 0;
+  if (!obstacles)
+    return;
+  
+  // the grid is centered between start and goal and aligned with the start frame
+  Eigen::Rotation2Dd start_to_world(start.theta());
+  Eigen::Vector2d center = 0.5 * (start.position() + goal.position());
+  double cell_radius = 0.5 * std::sqrt(2.) * grid_resolution_; // a cell is occupied if an obstacle touches its circumcircle
+  for (int row = 0; row < 8; ++row)
+  {
+    for (int col = 0; col < 8; ++col)
+    {
+      Eigen::Vector2d cell = center + start_to_world * (grid_resolution_ * Eigen::Vector2d(col - 3.5, row - 3.5));
+      for (ObstContainer::const_iterator obst = obstacles->begin(); obst != obstacles->end(); ++obst)
+      {
+        if ((*obst)->isDynamic())
+          continue;
+        if ((*obst)->getMinimumDistance(cell) <= cell_radius)
+        {
+          descriptor.occupancy |= uint64_t(1) << (8*row + col);
+          break;
+        }
+      }
+    }
+  }
+}
+
+void ExperienceCache::insert(const ExperienceDescriptor& descriptor, const TimedElasticBand& teb)
+{
+  if (teb.sizePoses() < 2 || teb.sizeTimeDiffs() != teb.sizePoses()-1)
+    return;
+  
+  boost::mutex::scoped_lock lock(mutex_);
+  
+  // replace an entry of the same planning problem, otherwise evict the least recently used one if the cache is full
+  std::size_t index = entries_.size();
+  for (std::size_t i=0; i < entries_.size(); ++i)
+  {
+    const ExperienceDescriptor& other = entries_[i].descriptor;
+    if (other.robot == descriptor.robot && other.occupancy == descriptor.occupancy
+        && (other.relative_goal.position() - descriptor.relative_goal.position()).norm() < 0.5 * grid_resolution_
+        && std::abs(g2o::normalize_theta(other.relative_goal.theta() - descriptor.relative_goal.theta())) < 0.1)
+    {
+      index = i;
+      break;
+    }
+  }
+  if (index == entries_.size())
+  {
+    if ((int)entries_.size() < max_entries_)
+      entries_.push_back(Entry());
+    else
+    {
+      index = 0;
+      for (std::size_t i=1; i < entries_.size(); ++i)
+      {
+        if (entries_[i].last_used < entries_[index].last_used)
+          index = i;
+      }
+    }
+  }
+  
+  Entry& entry = entries_[index];
+  entry.descriptor = descriptor;
+  entry.last_used = ++use_counter_;
+  
+  // store the trajectory w.r.t. its start frame
+  const PoseSE2& start = teb.Pose(0);
+  Eigen::Rotation2Dd world_to_start(-start.theta());
+  entry.poses.resize(teb.sizePoses());
+  for (int i=0; i < teb.sizePoses(); ++i)
+    entry.poses[i] = PoseSE2(world_to_start * (teb.Pose(i).position() - start.position()), g2o::normalize_theta(teb.Pose(i).theta() - start.theta()));
+  entry.timediffs.resize(teb.sizeTimeDiffs());
+  for (int i=0; i < teb.sizeTimeDiffs(); ++i)
+    entry.timediffs[i] = teb.TimeDiff(i);
+}
+
+bool ExperienceCache::retrieve(const ExperienceDescriptor& descriptor, const PoseSE2& start, const PoseSE2& goal, double max_goal_distance,
+                               double max_goal_angle, int max_cell_mismatch, TimedElasticBand& teb)
+{
+  if (teb.isInit())
+    return false;
+  
+  boost::mutex::scoped_lock lock(mutex_);
+  
+  int best = -1;
+  double best_score = std::numeric_limits<double>::max();
+  for (std::size_t i=0; i < entries_.size(); ++i)
+  {
+    const ExperienceDescriptor& other = entries_[i].descriptor;
+    if (other.robot != descriptor.robot)
+      continue;
+    int mismatch = descriptor.cellMismatch(other);
+    double goal_dist = (other.relative_goal.position() - descriptor.relative_goal.position()).norm();
+    double goal_angle = std::abs(g2o::normalize_theta(other.relative_goal.theta() - descriptor.relative_goal.theta()));
+    if (mismatch > max_cell_mismatch || goal_dist > max_goal_distance || goal_angle > max_goal_angle)
+      continue;
+    
+    double score = goal_dist / std::max(max_goal_distance, 1e-3) + goal_angle / std::max(max_goal_angle, 1e-3)
+                   + (double) mismatch / (double) (max_cell_mismatch + 1);
+    if (score < best_score)
+    {
+      best = (int) i;
+      best_score = score;
+    }
+  }
+  
+  if (best < 0)
+  {
+    ++misses_;
+    return false;
+  }
+  ++hits_;
+  
+  Entry& entry = entries_[best];
+  entry.last_used = ++use_counter_;
+  
+  // the remaining offset to the current goal is distributed along the path proportionally to the arc length
+  const PoseSE2& back = entry.poses.back();
+  Eigen::Rotation2Dd start_to_world(start.theta());
+  Eigen::Vector2d offset = goal.position() - (start.position() + start_to_world * back.position());
+  double offset_angle = g2o::normalize_theta(goal.theta() - start.theta() - back.theta());
+  
+  double length = 0;
+  for (std::size_t i=1; i < entry.poses.size(); ++i)
+    length += (entry.poses[i].position() - entry.poses[i-1].position()).norm();
+  
+  teb.addPose(start, true);
+  double arc = 0;
+  for (std::size_t i=1; i < entry.poses.size()-1; ++i)
+  {
+    arc += (entry.poses[i].position() - entry.poses[i-1].position()).norm();
+    double fraction = length > 1e-6 ? arc / length : (double) i / (double) (entry.poses.size()-1);
+    PoseSE2 pose(start.position() + start_to_world * entry.poses[i].position() + fraction * offset,
+                 g2o::normalize_theta(start.theta() + entry.poses[i].theta() + fraction * offset_angle));
+    teb.addPoseAndTimeDiff(pose, entry.timediffs[i-1]);
+  }
+  teb.addPoseAndTimeDiff(goal, entry.timediffs.back());
+  teb.setPoseVertexFixed(teb.sizePoses()-1, true);
+  return true;
+}
+
+bool ExperienceCache::save(const std::string& filename) const
+{
+  std::ofstream file(filename.c_str());
+  if (!file)
+    return false;
+  file.precision(17);
+  
+  boost::mutex::scoped_lock lock(mutex_);
+  file << "teb_experience_cache 1\n" << entries_.size() << "\n";
+  for (std::size_t i=0; i < entries_.size(); ++i)
+  {
+    const Entry& entry = entries_[i];
+    file << entry.descriptor.robot << "\n";
+    file << entry.descriptor.relative_goal.x() << " " << entry.descriptor.relative_goal.y() << " " << entry.descriptor.relative_goal.theta()
+         << " " << entry.descriptor.occupancy << " " << entry.poses.size() << "\n";
+    for (std::size_t k=0; k < entry.poses.size(); ++k)
+      file << entry.poses[k].x() << " " << entry.poses[k].y() << " " << entry.poses[k].theta() << (k+1 < entry.poses.size() ? " " : "\n");
+    for (std::size_t k=0; k < entry.timediffs.size(); ++k)
+      file << entry.timediffs[k] << (k+1 < entry.timediffs.size() ? " " : "\n");
+  }
+  return (bool) file;
+}
+
+bool ExperienceCache::load(const std::string& filename)
+{
+  std::ifstream file(filename.c_str());
+  std::string header;
+  int version = 0;
+  std::size_t no_entries = 0;
+  if (!(file >> header >> version >> no_entries) || header != "teb_experience_cache" || version != 1)
+    return false;
+  
+  std::vector<Entry, Eigen::aligned_allocator<Entry> > entries(std::min(no_entries, (std::size_t) max_entries_));
+  for (std::size_t i=0; i < no_entries; ++i)
+  {
+    Entry entry;
+    std::size_t no_poses = 0;
+    double x, y, theta;
+    file >> std::ws;
+    if (!std::getline(file, entry.descriptor.robot) || !(file >> x >> y >> theta >> entry.descriptor.occupancy >> no_poses) || no_poses < 2)
+      return false;
+    entry.descriptor.relative_goal = PoseSE2(x, y, theta);
+    entry.poses.resize(no_poses);
+    for (std::size_t k=0; k < no_poses; ++k)
+    {
+      if (!(file >> x >> y >> theta))
+        return false;
+      entry.poses[k] = PoseSE2(x, y, theta);
+    }
+    entry.timediffs.resize(no_poses-1);
+    for (std::size_t k=0; k < no_poses-1; ++k)
+    {
+      if (!(file >> entry.timediffs[k]))
+        return false;
+    }
+    entry.last_used = 0;
+    if (i < entries.size()) // surplus entries are dropped if the cache has been shrunk
+      entries[i] = entry;
+  }
+  
+  boost::mutex::scoped_lock lock(mutex_);
+  entries_.swap(entries);
+  return true;
+}
+
+std::size_t ExperienceCache::size() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return entries_.size();
+}
+
+void ExperienceCache::clear()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  entries_.clear();
+}
+
+unsigned long ExperienceCache::hits() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return hits_;
+}
+
+unsigned long ExperienceCache::misses() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return misses_;
+}
+
+std::string ExperienceCache::robotIdentifier(const RobotFootprintModelPtr& robot_model, double min_turning_radius)
+{
+  std::ostringstream identifier;
+  identifier.precision(3);
+  identifier << std::fixed;
+  if (robot_model)
+    identifier << typeid(*robot_model).name() << " " << robot_model->getInscribedRadius()
+               << " " << std::hex << footprintGeometryHash(*robot_model) << std::dec;
+  identifier << " " << min_turning_radius;
+  return identifier.str();
+}
+
+} // namespace teb_local_planner
@@ -37,20 +37,26 @@
  *********************************************************************/
 
 #include <teb_local_planner/homotopy_class_planner.h>
+#include <teb_local_planner/clock.h>
+
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 
 #include <limits>
 
 namespace teb_local_planner
 {
 
-HomotopyClassPlanner::HomotopyClassPlanner() : cfg_(NULL), obstacles_(NULL), via_points_(NULL), robot_model_(new PointRobotFootprint()), initial_plan_(NULL), initialized_(false)
+HomotopyClassPlanner::HomotopyClassPlanner() : cfg_(NULL), obstacles_(NULL), via_points_(NULL), robot_model_(new PointRobotFootprint()), initial_plan_(NULL),
+                                               last_eq_class_switching_time_(0), initialized_(false), telemetry_source_counter_(0)
 {
 }
 
 HomotopyClassPlanner::HomotopyClassPlanner(const TebConfig& cfg, ObstContainer* obstacles, RobotFootprintModelPtr robot_model,
-                                           TebVisualizationPtr visual, const ViaPointContainer* via_points) : initial_plan_(NULL)
+                                           const ViaPointContainer* via_points, const ClockPtr& clock) : initial_plan_(NULL), last_eq_class_switching_time_(0),
+                                                                                                         telemetry_source_counter_(0)
 {
-  initialize(cfg, obstacles, robot_model, visual, via_points);
+  initialize(cfg, obstacles, robot_model, via_points, clock);
 }
 
 HomotopyClassPlanner::~HomotopyClassPlanner()
@@ -58,12 +64,13 @@ HomotopyClassPlanner::~HomotopyClassPlanner()
 }
 
 void HomotopyClassPlanner::initialize(const TebConfig& cfg, ObstContainer* obstacles, RobotFootprintModelPtr robot_model,
-                                      TebVisualizationPtr visual, const ViaPointContainer* via_points)
+                                      const ViaPointContainer* via_points, const ClockPtr& clock)
 {
   cfg_ = &cfg;
   obstacles_ = obstacles;
   via_points_ = via_points;
   robot_model_ = robot_model;
+  clock_ = clock;
 
   if (cfg_->hcp.simple_exploration)
     graph_search_ = boost::shared_ptr<GraphSearchInterface>(new lrKeyPointGraph(*cfg_, this));
@@ -71,46 +78,27 @@ void HomotopyClassPlanner::initialize(const TebConfig& cfg, ObstContainer* obsta
     graph_search_ = boost::shared_ptr<GraphSearchInterface>(new ProbRoadmapGraph(*cfg_, this));
 
   initialized_ = true;
-
-  setVisualization(visual);
 }
 
 
-void HomotopyClassPlanner::setVisualization(TebVisualizationPtr visualization)
-{
-  visualization_ = visualization;
-}
 
-
-
-bool HomotopyClassPlanner::plan(const std::vector<geometry_msgs::PoseStamped>& initial_plan, const geometry_msgs::Twist* start_vel, bool free_goal_vel)
+bool HomotopyClassPlanner::plan(const PoseSE2Container& initial_plan, const Twist2D* start_vel, bool free_goal_vel)
 {
-  ROS_ASSERT_MSG(initialized_, "Call initialize() first.");
+  TEB_ASSERT_MSG(initialized_, "Call initialize() first.");
 
   // store initial plan for further initializations (must be valid for the lifetime of this object or clearPlanner() is called!)
   initial_plan_ = &initial_plan;
 
-  PoseSE2 start(initial_plan.front().pose);
-  PoseSE2 goal(initial_plan.back().pose);
-
-  return plan(start, goal, start_vel, free_goal_vel);
+  return plan(initial_plan.front(), initial_plan.back(), start_vel, free_goal_vel);
 }
 
-
-bool HomotopyClassPlanner::plan(const tf::Pose& start, const tf::Pose& goal, const geometry_msgs::Twist* start_vel, bool free_goal_vel)
-{
-  ROS_ASSERT_MSG(initialized_, "Call initialize() first.");
-  PoseSE2 start_pose(start);
-  PoseSE2 goal_pose(goal);
-  return plan(start_pose, goal_pose, start_vel, free_goal_vel);
-}
-
-bool HomotopyClassPlanner::plan(const PoseSE2& start, const PoseSE2& goal, const geometry_msgs::Twist* start_vel, bool free_goal_vel)
+bool HomotopyClassPlanner::plan(const PoseSE2& start, const PoseSE2& goal, const Twist2D* start_vel, bool free_goal_vel)
 {
-  ROS_ASSERT_MSG(initialized_, "Call initialize() first.");
+  TEB_ASSERT_MSG(initialized_, "Call initialize() first.");
 
   // Update old TEBs with new start, goal and velocity
   updateAllTEBs(&start, &goal, start_vel);
+  bool cold_start = tebs_.empty();
 
   // Init new TEBs based on newly explored homotopy classes
   exploreEquivalenceClassesAndInitTebs(start, goal, cfg_->obstacles.min_obstacle_dist, start_vel);
@@ -120,11 +108,28 @@ bool HomotopyClassPlanner::plan(const PoseSE2& start, const PoseSE2& goal, const
   optimizeAllTEBs(cfg_->optim.no_inner_iterations, cfg_->optim.no_outer_iterations);
   // Select which candidate (based on alternative homotopy classes) should be used
   selectBestTeb();
+  // remember the result of a cold start for similar planning problems (only if its optimization succeeded, see TebOptimalPlanner::plan())
+  TebOptimalPlannerPtr best_teb = bestTeb();
+  if (cold_start && best_teb && best_teb->isOptimized())
+    best_teb->storeExperience();
 
   initial_plan_ = nullptr; // clear pointer to any previous initial plan (any previous plan is useless regarding the h-signature);
   return true;
 }
 
+bool HomotopyClassPlanner::refine(const PoseSE2Container& initial_plan, const Twist2D* start_vel, bool free_goal_vel)
+{
+  TEB_ASSERT_MSG(initialized_, "Call initialize() first.");
+
+  TebOptimalPlannerPtr best_teb = bestTeb();
+  if (!best_teb || (initial_plan.back().position() - best_teb->teb().BackPose().position()).norm() >= cfg_->trajectory.force_reinit_new_goal_dist)
+    return plan(initial_plan, start_vel, free_goal_vel);
+
+  // the remaining candidates are updated during the next full optimization
+  // (free_goal_vel is not forwarded, since plan() does not consider it either)
+  return best_teb->refine(initial_plan, start_vel);
+}
+
 bool HomotopyClassPlanner::getVelocityCommand(double& vx, double& vy, double& omega) const
 {
   TebOptimalPlannerConstPtr best_teb = bestTeb();
@@ -139,43 +144,27 @@ bool HomotopyClassPlanner::getVelocityCommand(double& vx, double& vy, double& om
   return best_teb->getVelocityCommand(vx, vy, omega);
 }
 
-
-
-
-void HomotopyClassPlanner::visualize()
+bool HomotopyClassPlanner::computeTrackingError(const PoseSE2& pose, double& dist, double& angle_diff) const
 {
-  if (visualization_)
-  {
-    // Visualize graph
-    if (cfg_->hcp.visualize_hc_graph && graph_search_)
-      visualization_->publishGraph(graph_search_->graph_);
-
-    // Visualize active tebs as marker
-    visualization_->publishTebContainer(tebs_);
+  TebOptimalPlannerConstPtr best_teb = bestTeb();
+  if (!best_teb)
+    return false;
 
-    // Visualize best teb and feedback message if desired
-    TebOptimalPlannerConstPtr best_teb = bestTeb();
-    if (best_teb)
-    {
-      visualization_->publishLocalPlanAndPoses(best_teb->teb());
+  return best_teb->computeTrackingError(pose, dist, angle_diff);
+}
 
-      if (best_teb->teb().sizePoses() > 0) //TODO maybe store current pose (start) within plan method as class field.
-        visualization_->publishRobotFootprintModel(best_teb->teb().Pose(0), *robot_model_);
+bool HomotopyClassPlanner::predictState(double t, PoseSE2& pose, Twist2D& velocity) const
+{
+  TebOptimalPlannerConstPtr best_teb = bestTeb();
+  if (!best_teb)
+    return false;
 
-      // feedback message
-      if (cfg_->trajectory.publish_feedback)
-      {
-        int best_idx = bestTebIdx();
-        if (best_idx>=0)
-          visualization_->publishFeedbackMessage(tebs_, (unsigned int) best_idx, *obstacles_);
-      }
-    }
-  }
-  else ROS_DEBUG("Ignoring HomotopyClassPlanner::visualize() call, since no visualization class was instantiated before.");
+  return best_teb->predictState(t, pose, velocity);
 }
 
 
 
+
 bool HomotopyClassPlanner::hasEquivalenceClass(const EquivalenceClassPtr& eq_class) const
 {
   // iterate existing h-signatures and check if there is an existing H-Signature similar the candidate
@@ -194,7 +183,7 @@ bool HomotopyClassPlanner::addEquivalenceClassIfNew(const EquivalenceClassPtr& e
 
   if (!eq_class->isValid())
   {
-    ROS_WARN("HomotopyClassPlanner: Ignoring invalid H-signature");
+    TEB_WARN("HomotopyClassPlanner: Ignoring invalid H-signature");
     return false;
   }
 
@@ -278,7 +267,7 @@ void HomotopyClassPlanner::renewAndAnalyzeOldTebs(bool delete_detours)
 //     }
 //     else
 //     {
-//         ROS_WARN_STREAM("increase cand_i");
+//         TEB_WARN_STREAM("increase cand_i");
 //         ++cand_i;
 //     }
 //   }
@@ -289,7 +278,7 @@ void HomotopyClassPlanner::renewAndAnalyzeOldTebs(bool delete_detours)
 //     bool new_flag = addNewHSignatureIfNew(cand->second, cfg_->hcp.h_signature_threshold);
 //     if (!new_flag)
 //     {
-// //       ROS_ERROR_STREAM("getAndFilterHomotopyClassesTEB() - This schould not be happen.");
+// //       TEB_ERROR_STREAM("getAndFilterHomotopyClassesTEB() - This schould not be happen.");
 //       tebs_.erase(cand->first);
 //     }
 //   }
@@ -303,7 +292,7 @@ void HomotopyClassPlanner::updateReferenceTrajectoryViaPoints(bool all_trajector
 
   if(equivalence_classes_.size() < tebs_.size())
   {
-    ROS_ERROR("HomotopyClassPlanner::updateReferenceTrajectoryWithViaPoints(): Number of h-signatures does not match number of trajectories.");
+    TEB_ERROR("HomotopyClassPlanner::updateReferenceTrajectoryWithViaPoints(): Number of h-signatures does not match number of trajectories.");
     return;
   }
 
@@ -329,7 +318,7 @@ void HomotopyClassPlanner::updateReferenceTrajectoryViaPoints(bool all_trajector
 }
 
 
-void HomotopyClassPlanner::exploreEquivalenceClassesAndInitTebs(const PoseSE2& start, const PoseSE2& goal, double dist_to_obst, const geometry_msgs::Twist* start_vel)
+void HomotopyClassPlanner::exploreEquivalenceClassesAndInitTebs(const PoseSE2& start, const PoseSE2& goal, double dist_to_obst, const Twist2D* start_vel)
 {
   // first process old trajectories
   renewAndAnalyzeOldTebs(cfg_->hcp.delete_detours_backwards);
@@ -350,22 +339,30 @@ void HomotopyClassPlanner::exploreEquivalenceClassesAndInitTebs(const PoseSE2& s
 }
 
 
-TebOptimalPlannerPtr HomotopyClassPlanner::addAndInitNewTeb(const PoseSE2& start, const PoseSE2& goal, const geometry_msgs::Twist* start_velocity)
+TebOptimalPlannerPtr HomotopyClassPlanner::addAndInitNewTeb(const PoseSE2& start, const PoseSE2& goal, const Twist2D* start_velocity)
 {
   if(tebs_.size() >= cfg_->hcp.max_number_classes)
     return TebOptimalPlannerPtr();
-  TebOptimalPlannerPtr candidate =  TebOptimalPlannerPtr( new TebOptimalPlanner(*cfg_, obstacles_, robot_model_, visualization_));
+  TebOptimalPlannerPtr candidate =  TebOptimalPlannerPtr( new TebOptimalPlanner(*cfg_, obstacles_, robot_model_));
 
-  candidate->teb().initTrajectoryToGoal(start, goal, 0, cfg_->robot.max_vel_x, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
+  candidate->setExperienceCache(experience_cache_);
+  if (!candidate->initTrajectoryFromExperience(start, goal))
+    candidate->teb().initTrajectoryToGoal(start, goal, 0, cfg_->robot.max_vel_x, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
 
   if (start_velocity)
     candidate->setVelocityStart(*start_velocity);
+  candidate->initFeasibleTimeProfile();
 
   EquivalenceClassPtr H = calculateEquivalenceClass(candidate->teb().poses().begin(), candidate->teb().poses().end(), getCplxFromVertexPosePtr, obstacles_,
                                                     candidate->teb().timediffs().begin(), candidate->teb().timediffs().end());
 
   if(addEquivalenceClassIfNew(H))
   {
+    if (telemetry_)
+    {
+      candidate->setTelemetry(telemetry_);
+      candidate->setTelemetrySourceId(telemetry_source_counter_++);
+    }
     tebs_.push_back(candidate);
     return tebs_.back();
   }
@@ -375,17 +372,20 @@ TebOptimalPlannerPtr HomotopyClassPlanner::addAndInitNewTeb(const PoseSE2& start
 }
 
 
-TebOptimalPlannerPtr HomotopyClassPlanner::addAndInitNewTeb(const std::vector<geometry_msgs::PoseStamped>& initial_plan, const geometry_msgs::Twist* start_velocity)
+TebOptimalPlannerPtr HomotopyClassPlanner::addAndInitNewTeb(const PoseSE2Container& initial_plan, const Twist2D* start_velocity)
 {
   if(tebs_.size() >= cfg_->hcp.max_number_classes)
     return TebOptimalPlannerPtr();
-  TebOptimalPlannerPtr candidate = TebOptimalPlannerPtr( new TebOptimalPlanner(*cfg_, obstacles_, robot_model_, visualization_));
+  TebOptimalPlannerPtr candidate = TebOptimalPlannerPtr( new TebOptimalPlanner(*cfg_, obstacles_, robot_model_));
 
-  candidate->teb().initTrajectoryToGoal(initial_plan, cfg_->robot.max_vel_x,
-    cfg_->trajectory.global_plan_overwrite_orientation, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
+  candidate->setExperienceCache(experience_cache_);
+  if (!candidate->initTrajectoryFromExperience(initial_plan.front(), initial_plan.back()))
+    candidate->teb().initTrajectoryToGoal(initial_plan, cfg_->robot.max_vel_x,
+      cfg_->trajectory.global_plan_overwrite_orientation, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
 
   if (start_velocity)
     candidate->setVelocityStart(*start_velocity);
+  candidate->initFeasibleTimeProfile();
 
   // store the h signature of the initial plan to enable searching a matching teb later.
   initial_plan_eq_class_ = calculateEquivalenceClass(candidate->teb().poses().begin(), candidate->teb().poses().end(), getCplxFromVertexPosePtr, obstacles_,
@@ -393,6 +393,11 @@ TebOptimalPlannerPtr HomotopyClassPlanner::addAndInitNewTeb(const std::vector<ge
 
   if(addEquivalenceClassIfNew(initial_plan_eq_class_, true)) // also prevent candidate from deletion
   {
+    if (telemetry_)
+    {
+      candidate->setTelemetry(telemetry_);
+      candidate->setTelemetrySourceId(telemetry_source_counter_++);
+    }
     tebs_.push_back(candidate);
     return tebs_.back();
   }
@@ -401,13 +406,13 @@ TebOptimalPlannerPtr HomotopyClassPlanner::addAndInitNewTeb(const std::vector<ge
   return TebOptimalPlannerPtr();
 }
 
-void HomotopyClassPlanner::updateAllTEBs(const PoseSE2* start, const PoseSE2* goal, const geometry_msgs::Twist* start_velocity)
+void HomotopyClassPlanner::updateAllTEBs(const PoseSE2* start, const PoseSE2* goal, const Twist2D* start_velocity)
 {
   // If new goal is too far away, clear all existing trajectories to let them reinitialize later.
   // Since all Tebs are sharing the same fixed goal pose, just take the first candidate:
   if (!tebs_.empty() && (goal->position() - tebs_.front()->teb().BackPose().position()).norm() >= cfg_->trajectory.force_reinit_new_goal_dist)
   {
-      ROS_DEBUG("New goal: distance to existing goal is higher than the specified threshold. Reinitalizing trajectories.");
+      TEB_DEBUG("New goal: distance to existing goal is higher than the specified threshold. Reinitalizing trajectories.");
       tebs_.clear();
       equivalence_classes_.clear();
   }
@@ -462,7 +467,7 @@ TebOptimalPlannerPtr HomotopyClassPlanner::getInitialPlanTEB()
         else
         {
             initial_plan_teb_.reset(); // reset pointer for next call
-            ROS_DEBUG("initial teb not found, trying to find a match according to the cached equivalence class");
+            TEB_DEBUG("initial teb not found, trying to find a match according to the cached equivalence class");
         }
     }
 
@@ -487,10 +492,10 @@ TebOptimalPlannerPtr HomotopyClassPlanner::getInitialPlanTEB()
             }
          }
          else
-             ROS_ERROR("HomotopyClassPlanner::getInitialPlanTEB(): number of equivalence classes (%lu) and number of trajectories (%lu) does not match.", equivalence_classes_.size(), tebs_.size());
+             TEB_ERROR("HomotopyClassPlanner::getInitialPlanTEB(): number of equivalence classes (%lu) and number of trajectories (%lu) does not match.", equivalence_classes_.size(), tebs_.size());
     }
     else
-        ROS_DEBUG("HomotopyClassPlanner::getInitialPlanTEB(): initial TEB not found in the set of available trajectories.");
+        TEB_DEBUG("HomotopyClassPlanner::getInitialPlanTEB(): initial TEB not found in the set of available trajectories.");
 
     return TebOptimalPlannerPtr();
 }
@@ -528,7 +533,7 @@ TebOptimalPlannerPtr HomotopyClassPlanner::selectBestTeb()
         // check if the related TEB leaves the local costmap region
 //      if (tebs_.size()>1 && !(*it_teb)->teb().isTrajectoryInsideRegion(20, -1, 1))
 //      {
-//          ROS_INFO("HomotopyClassPlanner::selectBestTeb(): skipping trajectories that are not inside the local costmap");
+//          TEB_INFO("HomotopyClassPlanner::selectBestTeb(): skipping trajectories that are not inside the local costmap");
 //          continue;
 //      }
 
@@ -553,7 +558,7 @@ TebOptimalPlannerPtr HomotopyClassPlanner::selectBestTeb()
   // in case we haven't found any teb due to some previous checks, investigate list again
 //   if (!best_teb_ && !tebs_.empty())
 //   {
-//       ROS_DEBUG("all " << tebs_.size() << " tebs rejected previously");
+//       TEB_DEBUG("all " << tebs_.size() << " tebs rejected previously");
 //       if (tebs_.size()==1)
 //         best_teb_ = tebs_.front();
 //       else // if multiple TEBs are available:
@@ -582,14 +587,14 @@ TebOptimalPlannerPtr HomotopyClassPlanner::selectBestTeb()
     // check if we are allowed to change
     if (last_best_teb_ && best_teb_ != last_best_teb_)
     {
-      ros::Time now = ros::Time::now();
-      if ((now-last_eq_class_switching_time_).toSec() > cfg_->hcp.switching_blocking_period)
+      double now = clock_ ? clock_->now() : getClock()->now();
+      if (now-last_eq_class_switching_time_ > cfg_->hcp.switching_blocking_period)
       {
         last_eq_class_switching_time_ = now;
       }
       else
       {
-        ROS_DEBUG("HomotopyClassPlanner::selectBestTeb(): Switching equivalence classes blocked (check parameter switching_blocking_period.");
+        TEB_DEBUG("HomotopyClassPlanner::selectBestTeb(): Switching equivalence classes blocked (check parameter switching_blocking_period.");
         // block switching, so revert best_teb_
         best_teb_ = last_best_teb_;
       }
@@ -617,19 +622,18 @@ int HomotopyClassPlanner::bestTebIdx() const
   return -1;
 }
 
-bool HomotopyClassPlanner::isTrajectoryFeasible(base_local_planner::CostmapModel* costmap_model, const std::vector<geometry_msgs::Point>& footprint_spec,
-                                                double inscribed_radius, double circumscribed_radius, int look_ahead_idx)
+bool HomotopyClassPlanner::isTrajectoryFeasible(const FootprintCollisionChecker& checker, int look_ahead_idx)
 {
   bool feasible = false;
-  while(ros::ok() && !feasible && tebs_.size() > 0)
+  while(!feasible && tebs_.size() > 0)
   {
     TebOptimalPlannerPtr best = findBestTeb();
     if (!best)
     {
-      ROS_ERROR("Couldn't retrieve the best plan");
+      TEB_ERROR("Couldn't retrieve the best plan");
       return false;
     }
-    feasible = best->isTrajectoryFeasible(costmap_model, footprint_spec, inscribed_radius, circumscribed_radius, look_ahead_idx);
+    feasible = best->isTrajectoryFeasible(checker, look_ahead_idx);
     if(!feasible)
     {
       removeTeb(best);
@@ -654,7 +658,7 @@ TebOptPlannerContainer::iterator HomotopyClassPlanner::removeTeb(TebOptimalPlann
   TebOptPlannerContainer::iterator return_iterator = tebs_.end();
   if(equivalence_classes_.size() != tebs_.size())
   {
-      ROS_ERROR("removeTeb: size of eq classes != size of tebs");
+      TEB_ERROR("removeTeb: size of eq classes != size of tebs");
       return return_iterator;
   }
   auto it_eq_classes = equivalence_classes_.begin();
@@ -680,7 +684,25 @@ void HomotopyClassPlanner::setPreferredTurningDir(RotType dir)
   }
 }
 
-bool HomotopyClassPlanner::isHorizonReductionAppropriate(const std::vector<geometry_msgs::PoseStamped>& initial_plan) const
+void HomotopyClassPlanner::setTelemetry(OptimizerTelemetryPtr telemetry)
+{
+  telemetry_ = telemetry;
+  // register the sink (or disable the recording) for all existing TEBs
+  for (TebOptPlannerContainer::const_iterator it_teb = tebs_.begin(); it_teb != tebs_.end(); ++it_teb)
+  {
+    (*it_teb)->setTelemetry(telemetry_);
+    (*it_teb)->setTelemetrySourceId(telemetry_source_counter_++);
+  }
+}
+
+void HomotopyClassPlanner::setExperienceCache(ExperienceCachePtr cache)
+{
+  experience_cache_ = cache;
+  for (TebOptPlannerContainer::const_iterator it_teb = tebs_.begin(); it_teb != tebs_.end(); ++it_teb)
+    (*it_teb)->setExperienceCache(experience_cache_);
+}
+
+bool HomotopyClassPlanner::isHorizonReductionAppropriate(const PoseSE2Container& initial_plan) const
 {
   TebOptimalPlannerPtr best = bestTeb();
   if (!best)
@@ -718,14 +740,14 @@ void HomotopyClassPlanner::deletePlansDetouringBackwards(const double orient_thr
     }
     if((*it_teb)->teb().sizePoses() < 2)
     {
-      ROS_DEBUG("Discarding a plan with less than 2 poses");
+      TEB_DEBUG("Discarding a plan with less than 2 poses");
       it_teb = removeTeb(*it_teb);
       continue;
     }
     double plan_orientation;
     if(!computeStartOrientation(*it_teb, len_orientation_vector, plan_orientation))
     {
-      ROS_DEBUG("Failed to compute the start orientation for one of the tebs, likely close to the target");
+      TEB_DEBUG("Failed to compute the start orientation for one of the tebs, likely close to the target");
       it_teb = removeTeb(*it_teb);
       continue;
     }
@@ -736,13 +758,13 @@ void HomotopyClassPlanner::deletePlansDetouringBackwards(const double orient_thr
     }
     if(!it_teb->get()->isOptimized())
     {
-      ROS_DEBUG("Removing a teb because it's not optimized");
+      TEB_DEBUG("Removing a teb because it's not optimized");
       it_teb = removeTeb(*it_teb);  // Deletes tebs that cannot be optimized (last optim call failed)
       continue;
     }
     if(it_teb->get()->teb().getSumOfAllTimeDiffs() / best_plan_duration > cfg_->hcp.max_ratio_detours_duration_best_duration)
     {
-      ROS_DEBUG("Removing a teb because it's duration is much longer than that of the best teb");
+      TEB_DEBUG("Removing a teb because it's duration is much longer than that of the best teb");
       it_teb = removeTeb(*it_teb);
       continue;
     }
@@ -0,0 +1,115 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/logging.h>
+
+#include <cstdarg>
+#include <cstdio>
+
+
+namespace teb_local_planner
+{
+
+namespace
+{
+  
+const char* levelToString(Logger::Level level)
+{
+  switch (level)
+  {
+    case Logger::Debug: return "DEBUG";
+    case Logger::Info: return "INFO";
+    case Logger::Warn: return "WARN";
+    case Logger::Error: return "ERROR";
+    case Logger::Fatal: return "FATAL";
+  }
+  return "";
+}
+
+LoggerPtr& activeLogger()
+{
+  static LoggerPtr logger(new StreamLogger);
+  return logger;
+}
+
+} // anonymous namespace
+
+
+void StreamLogger::log(Level level, const char* file, int line, const char* message)
+{
+  if (!isEnabled(level))
+    return;
+  std::fprintf(stderr, "[%s] %s\n", levelToString(level), message);
+}
+
+
+void setLogger(const LoggerPtr& logger)
+{
+  boost::atomic_store(&activeLogger(), logger ? logger : LoggerPtr(new StreamLogger));
+}
+
+LoggerPtr getLogger()
+{
+  return boost::atomic_load(&activeLogger());
+}
+
+
+namespace logging
+{
+
+void logFormatted(Logger& logger, Logger::Level level, const char* file, int line, const char* fmt, ...)
+{
+  char buffer[1024];
+  va_list args;
+  va_start(args, fmt);
+  std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+  va_end(args);
+  logger.log(level, file, line, buffer);
+}
+
+void assertionFailed(const char* condition, const char* file, int line, const char* message)
+{
+  char buffer[1024];
+  std::snprintf(buffer, sizeof(buffer), "ASSERTION FAILED\n\tfile = %s\n\tline = %d\n\tcond = %s\n\tmessage = %s", file, line, condition, message);
+  getLogger()->log(Logger::Fatal, file, line, buffer);
+  std::abort();
+}
+
+} // namespace logging
+
+} // namespace teb_local_planner
@@ -0,0 +1,388 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/obstacle_corridor.h>
+#include <teb_local_planner/homotopy_class_planner.h>
+#include <teb_local_planner/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace teb_local_planner
+{
+
+
+ObstacleCorridorFilter::ObstacleCorridorFilter() : cfg_(NULL), margin_(0), grid_origin_(Eigen::Vector2d::Zero()), cell_size_(1), 
+                                                   grid_width_(0), grid_height_(0), cell_square_(4), query_stamp_(0)
+{
+}
+
+
+void ObstacleCorridorFilter::initialize(const TebConfig& cfg, RobotFootprintModelPtr robot_model)
+{
+  cfg_ = &cfg;
+  robot_model_ = robot_model;
+  clear();
+  
+  if (cfg_->obstacles.corridor_prefilter && robot_model_ && robot_model_->getCircumscribedRadius() < 0)
+    TEB_WARN("ObstacleCorridorFilter: the circumscribed radius of the robot footprint model is unknown, the corridor prefilter is disabled.");
+}
+
+
+void ObstacleCorridorFilter::clear()
+{
+  points_.clear();
+  polyline_starts_.clear();
+  segments_.clear();
+}
+
+
+void ObstacleCorridorFilter::addPath(const PoseSE2Container& path)
+{
+  if (path.empty())
+    return;
+  polyline_starts_.push_back((int)points_.size());
+  for (const PoseSE2& pose : path)
+    points_.push_back(pose.position());
+}
+
+
+void ObstacleCorridorFilter::addTrajectory(const TimedElasticBand& teb)
+{
+  if (teb.sizePoses() == 0)
+    return;
+  polyline_starts_.push_back((int)points_.size());
+  for (int i = 0; i < teb.sizePoses(); ++i)
+    points_.push_back(teb.Pose(i).position());
+}
+
+
+void ObstacleCorridorFilter::addPlanner(const PlannerInterface& planner)
+{
+  if (const HomotopyClassPlanner* hcp = dynamic_cast<const HomotopyClassPlanner*>(&planner))
+  {
+    for (const TebOptimalPlannerPtr& teb_planner : hcp->getTrajectoryContainer())
+      addTrajectory(teb_planner->teb());
+  }
+  else if (const TebOptimalPlanner* teb_planner = dynamic_cast<const TebOptimalPlanner*>(&planner))
+  {
+    addTrajectory(teb_planner->teb());
+  }
+}
+
+
+void ObstacleCorridorFilter::addViaPoints(const ViaPointContainer& via_points)
+{
+  for (const Eigen::Vector2d& via_point : via_points)
+  {
+    polyline_starts_.push_back((int)points_.size());
+    points_.push_back(via_point);
+  }
+}
+
+
+void ObstacleCorridorFilter::addSegment(const Eigen::Vector2d& start, const Eigen::Vector2d& end)
+{
+  Segment segment;
+  segment.start = start;
+  segment.end = end;
+  segment.box_min = start.cwiseMin(end);
+  segment.box_max = start.cwiseMax(end);
+  segments_.push_back(segment);
+}
+
+
+void ObstacleCorridorFilter::createSegments(double tolerance)
+{
+  segments_.clear();
+  for (std::size_t p = 0; p < polyline_starts_.size(); ++p)
+  {
+    int begin = polyline_starts_[p];
+    int end = p + 1 < polyline_starts_.size() ? polyline_starts_[p + 1] : (int)points_.size();
+    if (end - begin == 1)
+    {
+      addSegment(points_[begin], points_[begin]);
+      continue;
+    }
+    
+    // greedily extend each segment as long as all skipped points are closer than the tolerance,
+    // since the distance to a segment is convex, the skipped parts of the polyline are closer as well
+    // (the number of skipped points is bounded in order to bound the quadratic effort)
+    const int max_skipped = 32;
+    int first = begin;
+    while (first < end - 1)
+    {
+      int last = first + 1;
+      while (last + 1 < end && last - first < max_skipped)
+      {
+        bool valid = true;
+        for (int k = first + 1; k <= last && valid; ++k)
+          valid = distance_point_to_segment_2d(points_[k], points_[first], points_[last + 1]) <= tolerance;
+        if (!valid)
+          break;
+        ++last;
+      }
+      addSegment(points_[first], points_[last]);
+      first = last;
+    }
+  }
+}
+
+
+double ObstacleCorridorFilter::computeMargin() const
+{
+  double robot_radius = robot_model_ ? robot_model_->getCircumscribedRadius() : 0;
+  if (robot_radius < 0)
+    return -1; // unknown (e.g. user defined footprint model)
+  double association_dist = cfg_->obstacles.min_obstacle_dist * std::max(cfg_->obstacles.obstacle_association_cutoff_factor, 
+                                                                         cfg_->obstacles.obstacle_association_force_inclusion_factor);
+  return robot_radius + association_dist + cfg_->obstacles.corridor_prefilter_slack;
+}
+
+
+void ObstacleCorridorFilter::buildIndex()
+{
+  // grid around the bounding box of all segments, inflated by the margin
+  Eigen::Vector2d box_min = segments_.front().box_min;
+  Eigen::Vector2d box_max = segments_.front().box_max;
+  for (const Segment& segment : segments_)
+  {
+    box_min = box_min.cwiseMin(segment.box_min);
+    box_max = box_max.cwiseMax(segment.box_max);
+  }
+  box_min.array() -= margin_;
+  box_max.array() += margin_;
+  
+  // half of the margin leaves the inner two thirds of the corridor for covered cells,
+  // but the resolution is reduced for very long paths in order to bound the memory
+  const double max_cells = 1 << 18;
+  Eigen::Vector2d extent = box_max - box_min;
+  cell_size_ = std::max(0.5 * margin_, std::sqrt(extent.x() * extent.y() / max_cells));
+  grid_origin_ = box_min;
+  grid_width_ = (int)std::floor(extent.x() / cell_size_) + 1;
+  grid_height_ = (int)std::floor(extent.y() / cell_size_) + 1;
+  std::size_t no_cells = (std::size_t)grid_width_ * grid_height_;
+  
+  // the center of a cell is at most half_diag away from any point of the cell:
+  // every point of the cell is inside of the corridor if the center is closer than margin - half_diag to a segment,
+  // and no point of the cell is inside if the center is farther than margin + half_diag from all segments
+  const double half_diag = 0.5 * std::sqrt(2.0) * cell_size_;
+  const double covered_dist = margin_ - half_diag;
+  const double relevant_dist = margin_ + half_diag;
+  const double sq_covered_dist = covered_dist > 0 ? covered_dist * covered_dist : -1;
+  const double sq_relevant_dist = relevant_dist * relevant_dist;
+  
+  cell_covered_.assign(no_cells, 0);
+  entries_.clear();
+  for (std::size_t i = 0; i < segments_.size(); ++i)
+  {
+    const Segment& segment = segments_[i];
+    Eigen::Vector2d diff = segment.end - segment.start;
+    double sq_length = diff.squaredNorm();
+    int x_min = std::max(0, cellX(segment.box_min.x() - relevant_dist));
+    int x_max = std::min(grid_width_ - 1, cellX(segment.box_max.x() + relevant_dist));
+    int y_min = std::max(0, cellY(segment.box_min.y() - relevant_dist));
+    int y_max = std::min(grid_height_ - 1, cellY(segment.box_max.y() + relevant_dist));
+    for (int y = y_min; y <= y_max; ++y)
+    {
+      for (int x = x_min; x <= x_max; ++x)
+      {
+        int cell = y * grid_width_ + x;
+        if (cell_covered_[cell])
+          continue; // the segment list of a covered cell is never queried
+        Eigen::Vector2d center = grid_origin_ + cell_size_ * Eigen::Vector2d(x + 0.5, y + 0.5);
+        double u = sq_length > 0 ? std::min(1.0, std::max(0.0, (center - segment.start).dot(diff) / sq_length)) : 0;
+        double sq_dist = (segment.start + u * diff - center).squaredNorm();
+        if (sq_dist <= sq_covered_dist)
+          cell_covered_[cell] = 1;
+        else if (sq_dist <= sq_relevant_dist)
+          entries_.push_back(std::make_pair(cell, (int)i));
+      }
+    }
+  }
+  
+  // store the segment lists of all cells in a single container (counting sort by cell)
+  cell_offsets_.assign(no_cells + 1, 0);
+  for (const std::pair<int, int>& entry : entries_)
+    ++cell_offsets_[entry.first + 1];
+  for (std::size_t cell = 0; cell < no_cells; ++cell)
+    cell_offsets_[cell + 1] += cell_offsets_[cell];
+  cell_segments_.resize(entries_.size());
+  std::vector<int>::iterator write_pos = cell_offsets_.begin(); // reuse the offsets as write positions and restore them afterwards
+  for (const std::pair<int, int>& entry : entries_)
+    cell_segments_[write_pos[entry.first]++] = entry.second;
+  for (std::size_t cell = no_cells; cell > 0; --cell)
+    cell_offsets_[cell] = cell_offsets_[cell - 1];
+  cell_offsets_[0] = 0;
+  
+  visited_.assign(segments_.size(), 0);
+  query_stamp_ = 0;
+}
+
+
+bool ObstacleCorridorFilter::computeBoundingBox(const Obstacle& obstacle, Eigen::Vector2d& box_min, Eigen::Vector2d& box_max, Eigen::Vector2d& anchor)
+{
+  if (const PointObstacle* pobst = dynamic_cast<const PointObstacle*>(&obstacle))
+  {
+    box_min = box_max = anchor = pobst->position();
+  }
+  else if (const CircularObstacle* cobst = dynamic_cast<const CircularObstacle*>(&obstacle))
+  {
+    anchor = cobst->position();
+    box_min = cobst->position().array() - cobst->radius();
+    box_max = cobst->position().array() + cobst->radius();
+  }
+  else if (const LineObstacle* lobst = dynamic_cast<const LineObstacle*>(&obstacle))
+  {
+    anchor = lobst->start();
+    box_min = lobst->start().cwiseMin(lobst->end());
+    box_max = lobst->start().cwiseMax(lobst->end());
+  }
+  else if (const PolygonObstacle* polyobst = dynamic_cast<const PolygonObstacle*>(&obstacle))
+  {
+    if (polyobst->vertices().empty())
+      return false;
+    box_min = box_max = anchor = polyobst->vertices().front();
+    for (const Eigen::Vector2d& vertex : polyobst->vertices())
+    {
+      box_min = box_min.cwiseMin(vertex);
+      box_max = box_max.cwiseMax(vertex);
+    }
+  }
+  else
+    return false;
+  return true;
+}
+
+
+bool ObstacleCorridorFilter::isInside(const Obstacle& obstacle) const
+{
+  Eigen::Vector2d box_min, box_max, anchor;
+  if (!computeBoundingBox(obstacle, box_min, box_max, anchor))
+    return true; // unknown obstacle type
+  
+  // the anchor is a point of the obstacle, hence the obstacle is inside if the anchor is located in a covered cell
+  int anchor_x = cellX(anchor.x());
+  int anchor_y = cellY(anchor.y());
+  if (anchor_x >= 0 && anchor_x < grid_width_ && anchor_y >= 0 && anchor_y < grid_height_ && cell_covered_[anchor_y * grid_width_ + anchor_x])
+    return true;
+  
+  int x_min = std::max(0, cellX(box_min.x()));
+  int x_max = std::min(grid_width_ - 1, cellX(box_max.x()));
+  int y_min = std::max(0, cellY(box_min.y()));
+  int y_max = std::min(grid_height_ - 1, cellY(box_max.y()));
+  if (x_min > x_max || y_min > y_max)
+    return false; // outside of the grid
+  
+  if (++query_stamp_ == 0) // overflow
+  {
+    std::fill(visited_.begin(), visited_.end(), 0);
+    query_stamp_ = 1;
+  }
+  
+  for (int y = y_min; y <= y_max; ++y)
+  {
+    for (int x = x_min; x <= x_max; ++x)
+    {
+      int cell = y * grid_width_ + x;
+      
+      if (cell_covered_[cell])
+      {
+        // the bounding box overlaps a covered cell, but the obstacle itself might not:
+        // an obstacle that is completely located in the cell contains the anchor, otherwise its boundary crosses the cell border
+        Eigen::Vector2d corner = grid_origin_ + cell_size_ * Eigen::Vector2d(x, y);
+        cell_square_[0] = corner;
+        cell_square_[1] = corner + Eigen::Vector2d(cell_size_, 0);
+        cell_square_[2] = corner + Eigen::Vector2d(cell_size_, cell_size_);
+        cell_square_[3] = corner + Eigen::Vector2d(0, cell_size_);
+        if (obstacle.getMinimumDistance(cell_square_) <= 0)
+          return true;
+        continue;
+      }
+      
+      for (int k = cell_offsets_[cell]; k < cell_offsets_[cell + 1]; ++k)
+      {
+        int idx = cell_segments_[k];
+        if (visited_[idx] == query_stamp_)
+          continue;
+        visited_[idx] = query_stamp_;
+        
+        // cheap rejection by means of the bounding boxes
+        const Segment& segment = segments_[idx];
+        if ((box_min.array() > segment.box_max.array() + margin_).any() || (box_max.array() < segment.box_min.array() - margin_).any())
+          continue;
+        
+        double dist = segment.start == segment.end ? obstacle.getMinimumDistance(segment.start)
+                                                   : obstacle.getMinimumDistance(segment.start, segment.end);
+        if (dist <= margin_)
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+
+std::size_t ObstacleCorridorFilter::filter(ObstContainer& obstacles)
+{
+  if (points_.empty() || !cfg_)
+    return 0;
+  
+  double margin = computeMargin();
+  if (!(margin > 0) || !std::isfinite(margin)) // also skipped if the circumscribed radius of the robot is unknown
+    return 0;
+  
+  // the paths are simplified (the poses are usually almost collinear) and the margin is enlarged by the tolerance,
+  // hence the corridor contains the corridor of the original paths
+  const double tolerance = 0.05 * margin;
+  createSegments(tolerance);
+  margin_ = margin + tolerance;
+  buildIndex();
+  
+  // remove obstacles outside of the corridor in place (the order of the remaining obstacles is preserved)
+  ObstContainer::iterator end = std::remove_if(obstacles.begin(), obstacles.end(), [this](const ObstaclePtr& obst) {
+    return !obst->isDynamic() && !isInside(*obst);
+  });
+  std::size_t removed = std::distance(end, obstacles.end());
+  obstacles.erase(end, obstacles.end());
+  return removed;
+}
+
+
+} // namespace teb_local_planner
@@ -0,0 +1,464 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/obstacle_simplification.h>
+
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <queue>
+#include <vector>
+
+
+namespace teb_local_planner
+{
+
+namespace
+{
+
+//! Vertex of the polygon that is simplified (doubly linked ring)
+struct SimplificationNode
+{
+  Eigen::Vector2d pos;
+  int prev;
+  int next;
+  double edge_error; //!< Upper bound on the distance of the edge to the next vertex from the original boundary
+  int version; //!< Incremented whenever the candidate operation of this vertex is reevaluated
+  bool removed;
+  
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+//! Operation proposed for a vertex (removal of the vertex or collapse of the edge to the next vertex)
+struct SimplificationCandidate
+{
+  double error; //!< Error bound of the new edges
+  int node;
+  int version;
+  bool collapse; //!< \c true: collapse the edge node->next into point, \c false: remove node
+  Eigen::Vector2d point;
+  
+  bool operator<(const SimplificationCandidate& other) const {return error > other.error;} // min-heap
+  
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+typedef std::priority_queue<SimplificationCandidate, std::vector<SimplificationCandidate, Eigen::aligned_allocator<SimplificationCandidate> > > CandidateQueue;
+typedef std::vector<SimplificationNode, Eigen::aligned_allocator<SimplificationNode> > NodeContainer;
+
+inline double cross2d(const Eigen::Vector2d& a, const Eigen::Vector2d& b)
+{
+  return a.x()*b.y() - a.y()*b.x();
+}
+
+/**
+ * @brief Largest distance of a point on the chord prev->next to the polyline prev->vertex->next
+ * 
+ * The distance to the first segment is non-decreasing and the distance to the second one non-increasing along
+ * the chord, hence the maximum of their minimum is located at their crossing, which is bracketed by bisection.
+ * The returned value is an upper bound, since the distance to the first segment at the upper end of the bracket
+ * and the distance to the second segment at its lower end bound both distances inside the bracket.
+ */
+double chordDeviation(const Eigen::Vector2d& prev, const Eigen::Vector2d& vertex, const Eigen::Vector2d& next)
+{
+  double lower = 0;
+  double upper = 1;
+  double dist1_upper = distance_point_to_segment_2d(next, prev, vertex);
+  double dist2_lower = distance_point_to_segment_2d(prev, vertex, next);
+  for (int i = 0; i < 12; ++i)
+  {
+    double mid = 0.5 * (lower + upper);
+    Eigen::Vector2d point = prev + mid * (next - prev);
+    double dist1 = distance_point_to_segment_2d(point, prev, vertex);
+    double dist2 = distance_point_to_segment_2d(point, vertex, next);
+    if (dist1 < dist2)
+    {
+      lower = mid;
+      dist2_lower = dist2;
+    }
+    else
+    {
+      upper = mid;
+      dist1_upper = dist1;
+    }
+  }
+  return std::min(dist1_upper, dist2_lower);
+}
+
+//! Check whether point p is inside or on the boundary of triangle (a,b,c)
+bool isInsideTriangle(const Eigen::Vector2d& p, const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& c)
+{
+  if (cross2d(b - a, c - a) == 0) // degenerate triangle (e.g. removal of a collinear vertex)
+    return distance_point_to_segment_2d(p, a, b) == 0 || distance_point_to_segment_2d(p, b, c) == 0 || distance_point_to_segment_2d(p, c, a) == 0;
+  
+  double d1 = cross2d(b - a, p - a);
+  double d2 = cross2d(c - b, p - b);
+  double d3 = cross2d(a - c, p - c);
+  bool has_neg = d1 < 0 || d2 < 0 || d3 < 0;
+  bool has_pos = d1 > 0 || d2 > 0 || d3 > 0;
+  return !(has_neg && has_pos);
+}
+
+/**
+ * @brief Compute the operation of a vertex and push it to the queue if the error bound is below the tolerance
+ */
+void evaluateNode(NodeContainer& nodes, int idx, double orientation, double tolerance, CandidateQueue& queue)
+{
+  SimplificationNode& node = nodes[idx];
+  ++node.version;
+  const SimplificationNode& prev = nodes[node.prev];
+  const SimplificationNode& next = nodes[node.next];
+  
+  SimplificationCandidate candidate;
+  candidate.node = idx;
+  candidate.version = node.version;
+  
+  double turn = orientation * cross2d(node.pos - prev.pos, next.pos - node.pos);
+  if (turn <= 0)
+  {
+    // reflex or collinear vertex: removal enlarges the polygon
+    candidate.collapse = false;
+    candidate.error = std::max(prev.edge_error, node.edge_error) + chordDeviation(prev.pos, node.pos, next.pos);
+  }
+  else
+  {
+    // convex vertex: collapse the edge to the next vertex if the next vertex is convex as well
+    const SimplificationNode& next2 = nodes[next.next];
+    if (next.next == node.prev || orientation * cross2d(next.pos - node.pos, next2.pos - next.pos) <= 0)
+      return;
+    
+    // intersection of the lines prev->node and next2->next in front of both vertices
+    Eigen::Vector2d dir1 = node.pos - prev.pos;
+    Eigen::Vector2d dir2 = next.pos - next2.pos;
+    double denom = cross2d(dir1, dir2);
+    if (denom == 0)
+      return;
+    double s = cross2d(next.pos - node.pos, dir2) / denom;
+    double t = cross2d(next.pos - node.pos, dir1) / denom;
+    if (!(s > 0) || !(t > 0))
+      return;
+    candidate.collapse = true;
+    candidate.point = node.pos + s * dir1;
+    candidate.error = node.edge_error + distance_point_to_segment_2d(candidate.point, node.pos, next.pos);
+  }
+  
+  if (candidate.error <= tolerance)
+    queue.push(candidate);
+}
+
+/**
+ * @brief Check that the triangle added by an operation does not contain other vertices and that no other edge
+ *        crosses the triangle, such that the polygon remains simple
+ * @param nodes vertices of the polygon
+ * @param start any vertex of the polygon that is not removed
+ * @param a first corner of the triangle
+ * @param b second corner of the triangle
+ * @param c third corner of the triangle
+ * @param ids indices of the vertices that span the triangle (edges incident to them are skipped)
+ */
+bool isValidOperation(const NodeContainer& nodes, int start, const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& c,
+                      const std::array<int, 3>& ids)
+{
+  // axis aligned bounding box of the triangle in order to skip distant edges cheaply
+  const Eigen::Vector2d box_min = a.cwiseMin(b).cwiseMin(c);
+  const Eigen::Vector2d box_max = a.cwiseMax(b).cwiseMax(c);
+  
+  int idx = start;
+  do
+  {
+    const SimplificationNode& node = nodes[idx];
+    const Eigen::Vector2d& next = nodes[node.next].pos;
+    if ((node.pos.x() < box_min.x() && next.x() < box_min.x()) || (node.pos.x() > box_max.x() && next.x() > box_max.x())
+        || (node.pos.y() < box_min.y() && next.y() < box_min.y()) || (node.pos.y() > box_max.y() && next.y() > box_max.y()))
+    {
+      idx = node.next;
+      continue;
+    }
+    bool corner = std::find(ids.begin(), ids.end(), idx) != ids.end();
+    bool next_corner = std::find(ids.begin(), ids.end(), node.next) != ids.end();
+    if (!corner && isInsideTriangle(node.pos, a, b, c))
+      return false;
+    if (!corner && !next_corner)
+    {
+      if (check_line_segments_intersection_2d(node.pos, next, a, b) || check_line_segments_intersection_2d(node.pos, next, b, c) 
+          || check_line_segments_intersection_2d(node.pos, next, c, a))
+        return false;
+    }
+    idx = node.next;
+  } while (idx != start);
+  return true;
+}
+
+} // anonymous namespace
+
+
+double simplifyPolygonConservative(const Point2dContainer& vertices, double tolerance, Point2dContainer& simplified)
+{
+  simplified = vertices;
+  int n = (int)vertices.size();
+  if (n <= 3 || tolerance <= 0)
+    return 0;
+  
+  // orientation of the polygon, in order to distinguish convex and reflex vertices
+  double area = 0;
+  for (int i = 0; i < n; ++i)
+    area += cross2d(vertices[i], vertices[(i+1) % n]);
+  if (area == 0)
+    return 0;
+  double orientation = area > 0 ? 1 : -1;
+  
+  NodeContainer nodes(n);
+  for (int i = 0; i < n; ++i)
+  {
+    nodes[i].pos = vertices[i];
+    nodes[i].prev = (i + n - 1) % n;
+    nodes[i].next = (i + 1) % n;
+    nodes[i].edge_error = 0;
+    nodes[i].version = 0;
+    nodes[i].removed = false;
+  }
+  
+  CandidateQueue queue;
+  for (int i = 0; i < n; ++i)
+    evaluateNode(nodes, i, orientation, tolerance, queue);
+  
+  int no_nodes = n;
+  while (no_nodes > 3 && !queue.empty())
+  {
+    SimplificationCandidate candidate = queue.top();
+    queue.pop();
+    SimplificationNode& node = nodes[candidate.node];
+    if (node.removed || candidate.version != node.version)
+      continue; // outdated
+    
+    int prev = node.prev;
+    int next = node.next;
+    int first; // first vertex whose operation must be reevaluated
+    if (!candidate.collapse)
+    {
+      // remove the vertex: the chord prev->next replaces prev->node->next
+      std::array<int, 3> ids = {{prev, candidate.node, next}};
+      if (!isValidOperation(nodes, next, nodes[prev].pos, node.pos, nodes[next].pos, ids))
+        continue;
+      nodes[prev].edge_error = candidate.error;
+      nodes[prev].next = next;
+      nodes[next].prev = prev;
+      node.removed = true;
+      first = prev;
+    }
+    else
+    {
+      // collapse the edge node->next into the new point: prev->point->next2 replaces prev->node->next->next2
+      int next2 = nodes[next].next;
+      std::array<int, 3> ids = {{candidate.node, next, -1}};
+      if (!isValidOperation(nodes, next2, node.pos, candidate.point, nodes[next].pos, ids))
+        continue;
+      nodes[prev].edge_error = std::max(nodes[prev].edge_error, candidate.error);
+      node.edge_error = std::max(nodes[next].edge_error, candidate.error);
+      node.pos = candidate.point;
+      node.next = next2;
+      nodes[next2].prev = candidate.node;
+      nodes[next].removed = true;
+      first = candidate.node;
+    }
+    --no_nodes;
+    
+    // reevaluate all vertices whose operation depends on the modified vertices
+    int idx = nodes[nodes[first].prev].prev;
+    for (int i = 0; i < 5; ++i)
+    {
+      evaluateNode(nodes, idx, orientation, tolerance, queue);
+      idx = nodes[idx].next;
+    }
+  }
+  
+  // collect the remaining vertices in their original order
+  simplified.clear();
+  double error = 0;
+  for (const SimplificationNode& node : nodes)
+  {
+    if (node.removed)
+      continue;
+    simplified.push_back(node.pos);
+    error = std::max(error, node.edge_error);
+  }
+  return error;
+}
+
+
+std::size_t simplifyPolygonObstacle(PolygonObstacle& obstacle, double tolerance)
+{
+  if (obstacle.noVertices() <= 3 || tolerance <= 0)
+    return 0;
+  
+  const Point2dContainer& vertices = obstacle.vertices();
+  Point2dContainer simplified;
+  simplifyPolygonConservative(vertices, tolerance, simplified);
+  std::size_t removed = vertices.size() - simplified.size();
+  if (removed > 0)
+  {
+    obstacle.modifyVertices().swap(simplified);
+    obstacle.finalizePolygon();
+  }
+  return removed;
+}
+
+
+std::size_t mergePointObstacles(ObstContainer& obstacles, double merge_dist)
+{
+  if (merge_dist <= 0)
+    return 0;
+  
+  struct Cluster
+  {
+    Point2dContainer members;
+    ObstaclePtr first;
+  };
+  std::vector<Cluster> clusters;
+  boost::unordered_map<std::pair<int,int>, std::vector<int> > grid; // seeds of the clusters, cell size merge_dist
+  std::vector<int> cluster_of(obstacles.size(), -1);
+  
+  for (std::size_t i = 0; i < obstacles.size(); ++i)
+  {
+    const PointObstacle* point = dynamic_cast<const PointObstacle*>(obstacles[i].get());
+    if (!point || point->isDynamic())
+      continue;
+    
+    const Eigen::Vector2d& pos = point->position();
+    int cell_x = (int)std::floor(pos.x() / merge_dist);
+    int cell_y = (int)std::floor(pos.y() / merge_dist);
+    
+    // the seed of a matching cluster is located in one of the neighboring cells
+    int match = -1;
+    for (int dx = -1; dx <= 1 && match < 0; ++dx)
+    {
+      for (int dy = -1; dy <= 1 && match < 0; ++dy)
+      {
+        boost::unordered_map<std::pair<int,int>, std::vector<int> >::const_iterator cell = grid.find(std::make_pair(cell_x + dx, cell_y + dy));
+        if (cell == grid.end())
+          continue;
+        for (int cluster : cell->second)
+        {
+          if ((clusters[cluster].members.front() - pos).norm() < merge_dist)
+          {
+            match = cluster;
+            break;
+          }
+        }
+      }
+    }
+    
+    if (match < 0)
+    {
+      match = (int)clusters.size();
+      clusters.push_back(Cluster());
+      clusters.back().first = obstacles[i];
+      grid[std::make_pair(cell_x, cell_y)].push_back(match);
+    }
+    clusters[match].members.push_back(pos);
+    cluster_of[i] = match;
+  }
+  
+  if ((std::ptrdiff_t)clusters.size() == std::count_if(cluster_of.begin(), cluster_of.end(), [](int cluster) {return cluster >= 0;}))
+    return 0; // nothing to merge
+  
+  // replace each cluster by its single member or by a circle around the mean of its members that encloses all of them
+  ObstContainer merged;
+  merged.reserve(obstacles.size());
+  std::vector<bool> emitted(clusters.size(), false);
+  for (std::size_t i = 0; i < obstacles.size(); ++i)
+  {
+    int cluster = cluster_of[i];
+    if (cluster < 0)
+    {
+      merged.push_back(obstacles[i]);
+      continue;
+    }
+    if (emitted[cluster])
+      continue;
+    emitted[cluster] = true;
+    
+    const Point2dContainer& members = clusters[cluster].members;
+    if (members.size() == 1)
+    {
+      merged.push_back(clusters[cluster].first);
+      continue;
+    }
+    Eigen::Vector2d center = Eigen::Vector2d::Zero();
+    for (const Eigen::Vector2d& member : members)
+      center += member;
+    center /= (double)members.size();
+    double radius = 0;
+    for (const Eigen::Vector2d& member : members)
+      radius = std::max(radius, (member - center).norm());
+    merged.push_back(boost::make_shared<CircularObstacle>(center, radius));
+  }
+  
+  std::size_t removed = obstacles.size() - merged.size();
+  obstacles.swap(merged);
+  return removed;
+}
+
+
+void simplifyObstacles(ObstContainer& obstacles, double polygon_tolerance, double point_merge_dist,
+                       std::size_t* removed_vertices, std::size_t* removed_points)
+{
+  std::size_t no_vertices = 0;
+  if (polygon_tolerance > 0)
+  {
+    for (const ObstaclePtr& obstacle : obstacles)
+    {
+      PolygonObstacle* polygon = dynamic_cast<PolygonObstacle*>(obstacle.get());
+      if (polygon)
+        no_vertices += simplifyPolygonObstacle(*polygon, polygon_tolerance);
+    }
+  }
+  
+  std::size_t no_points = mergePointObstacles(obstacles, point_merge_dist);
+  
+  if (removed_vertices)
+    *removed_vertices = no_vertices;
+  if (removed_points)
+    *removed_points = no_points;
+}
+
+} // namespace teb_local_planner
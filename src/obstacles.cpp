@@ -37,8 +37,9 @@
  *********************************************************************/
 
 #include <teb_local_planner/obstacles.h>
-#include <ros/console.h>
-#include <ros/assert.h>
+#include <teb_local_planner/logging.h>
+
+#include <limits>
 // #include <teb_local_planner/misc.h>
 
 namespace teb_local_planner
@@ -59,7 +60,7 @@ void PolygonObstacle::calcCentroid()
   if (vertices_.empty())
   {
     centroid_.setConstant(NAN);
-    ROS_WARN("PolygonObstacle::calcCentroid(): number of vertices is empty. the resulting centroid is a vector of NANs.");
+    TEB_WARN("PolygonObstacle::calcCentroid(): number of vertices is empty. the resulting centroid is a vector of NANs.");
     return;
   }
   
@@ -126,83 +127,122 @@ void PolygonObstacle::calcCentroid()
 }
 
 
-
-Eigen::Vector2d PolygonObstacle::getClosestPoint(const Eigen::Vector2d& position) const
+void PolygonObstacle::calcEdgeGeometry()
 {
-  // the polygon is a point
-  if (noVertices() == 1)
+  edges_.clear();
+  if (vertices_.empty())
   {
-    return vertices_.front();
+    bounding_center_.setConstant(NAN);
+    bounding_radius_ = 0;
+    return;
   }
   
-  if (noVertices() > 1)
+  // orientation of the polygon (sign of the shoelace formula), in order to point all normals outwards
+  double A = 0;
+  for (int i=0; i < noVertices(); ++i)
   {
-    
-    Eigen::Vector2d new_pt = closest_point_on_line_segment_2d(position, vertices_.at(0), vertices_.at(1));
-    
-    if (noVertices() > 2) // real polygon and not a line
+    const Eigen::Vector2d& v1 = vertices_[i];
+    const Eigen::Vector2d& v2 = vertices_[(i+1) % noVertices()];
+    A += v1.x() * v2.y() - v2.x() * v1.y();
+  }
+  bool clockwise = A < 0;
+  
+  // a point is represented by a single degenerate edge and a line is not closed
+  int no_edges = noVertices() > 2 ? noVertices() : 1;
+  edges_.resize(no_edges);
+  for (int i=0; i < no_edges; ++i)
+    edges_[i].set(vertices_[i], vertices_[(i+1) % noVertices()], clockwise);
+  
+  // bounding circle around the center of the axis-aligned bounding box
+  Eigen::Vector2d min_corner = vertices_.front();
+  Eigen::Vector2d max_corner = vertices_.front();
+  for (const Eigen::Vector2d& vertex : vertices_)
+  {
+    min_corner = min_corner.cwiseMin(vertex);
+    max_corner = max_corner.cwiseMax(vertex);
+  }
+  bounding_center_ = 0.5 * (min_corner + max_corner);
+  bounding_radius_ = 0;
+  for (const Eigen::Vector2d& vertex : vertices_)
+    bounding_radius_ = std::max(bounding_radius_, (vertex - bounding_center_).norm());
+}
+
+
+Eigen::Vector2d PolygonObstacle::getClosestPoint(const Eigen::Vector2d& position) const
+{
+  if (!finalized_) // the precomputed edges are not valid, fall back to the vertices
+  {
+    if (noVertices() == 1)
+      return vertices_.front();
+    Eigen::Vector2d closest_pt = Eigen::Vector2d::Zero();
+    double sq_dist = std::numeric_limits<double>::infinity();
+    int no_edges = noVertices() > 2 ? noVertices() : noVertices() - 1; // a line is not closed
+    for (int i=0; i < no_edges; ++i)
     {
-      double dist = (new_pt-position).norm();
-      Eigen::Vector2d closest_pt = new_pt;
-      
-      // check each polygon edge
-      for (int i=1; i<noVertices()-1; ++i) // skip the first one, since we already checked it (new_pt)
+      Eigen::Vector2d new_pt = closest_point_on_line_segment_2d(position, vertices_[i], vertices_[(i+1) % noVertices()]);
+      double new_sq_dist = (new_pt - position).squaredNorm();
+      if (new_sq_dist < sq_dist)
       {
-        new_pt = closest_point_on_line_segment_2d(position, vertices_.at(i), vertices_.at(i+1));
-        double new_dist = (new_pt-position).norm();
-        if (new_dist < dist)
-        {
-          dist = new_dist;
-          closest_pt = new_pt;
-        }
+        sq_dist = new_sq_dist;
+        closest_pt = new_pt;
       }
-      // afterwards we check the edge between goal and start (close polygon)
-      new_pt = closest_point_on_line_segment_2d(position, vertices_.back(), vertices_.front());
-      double new_dist = (new_pt-position).norm();
-      if (new_dist < dist)
-        return new_pt;
-      else
-        return closest_pt;
     }
-    else
+    if (no_edges > 0)
+      return closest_pt;
+  }
+  
+  if (edges_.empty())
+  {
+    TEB_ERROR("PolygonObstacle::getClosestPoint() cannot find any closest point. Polygon ill-defined?");
+    return Eigen::Vector2d::Zero(); // todo: maybe boost::optional?
+  }
+  
+  // check each polygon edge (including the edge between goal and start)
+  Eigen::Vector2d closest_pt = closest_point_on_line_segment_2d(position, edges_.front());
+  double sq_dist = (closest_pt - position).squaredNorm();
+  for (std::size_t i=1; i < edges_.size(); ++i)
+  {
+    Eigen::Vector2d new_pt = closest_point_on_line_segment_2d(position, edges_[i]);
+    double new_sq_dist = (new_pt - position).squaredNorm();
+    if (new_sq_dist < sq_dist)
     {
-      return new_pt; // closest point on line segment
+      sq_dist = new_sq_dist;
+      closest_pt = new_pt;
     }
   }
-
-  ROS_ERROR("PolygonObstacle::getClosestPoint() cannot find any closest point. Polygon ill-defined?");
-  return Eigen::Vector2d::Zero(); // todo: maybe boost::optional?
+  return closest_pt;
 }
 
 
 bool PolygonObstacle::checkLineIntersection(const Eigen::Vector2d& line_start, const Eigen::Vector2d& line_end, double min_dist) const
 {
-  // Simple strategy, check all edge-line intersections until an intersection is found...
-  // check each polygon edge
-  for (int i=0; i<noVertices()-1; ++i)
+  if (!finalized_) // the precomputed edges are not valid, fall back to the vertices
   {
-    if ( check_line_segments_intersection_2d(line_start, line_end, vertices_.at(i), vertices_.at(i+1)) ) 
-      return true;
+    int no_edges = noVertices() > 2 ? noVertices() : noVertices() - 1; // a line is not closed
+    for (int i=0; i < no_edges; ++i)
+    {
+      if ( check_line_segments_intersection_2d(line_start, line_end, vertices_[i], vertices_[(i+1) % noVertices()]) )
+        return true;
+    }
+    return false;
   }
-  if (noVertices()==2) // if polygon is a line
+  
+  // the line cannot intersect the polygon if it does not intersect its bounding circle
+  if (distance_point_to_segment_2d(bounding_center_, line_start, line_end) > bounding_radius_)
     return false;
   
-  return check_line_segments_intersection_2d(line_start, line_end, vertices_.back(), vertices_.front()); //otherwise close polygon
+  // Simple strategy, check all edge-line intersections until an intersection is found...
+  // check each polygon edge (the edge between goal and start is only included if the polygon is not a line)
+  for (const PrecomputedSegment2d& edge : edges_)
+  {
+    if ( check_line_segments_intersection_2d(line_start, line_end, edge) ) 
+      return true;
+  }
+  return false;
 }
 
 
 
-// implements toPolygonMsg() of the base class
-void PolygonObstacle::toPolygonMsg(geometry_msgs::Polygon& polygon)
-{
-  polygon.points.resize(vertices_.size());
-  for (std::size_t i=0; i<vertices_.size(); ++i)
-  {
-    polygon.points[i].x = vertices_[i].x();
-    polygon.points[i].y = vertices_[i].y();
-    polygon.points[i].z = 0;
-  }
-}
 
 
 
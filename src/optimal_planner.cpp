@@ -37,28 +37,104 @@
  *********************************************************************/
 
 #include <teb_local_planner/optimal_planner.h>
+#include <teb_local_planner/reeds_shepp_path.h>
 #include <map>
 #include <limits>
+#include <boost/thread/once.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <algorithm>
+#include <chrono>
 
 
 namespace teb_local_planner
 {
 
+namespace
+{
+
+/**
+ * @brief g2o post-iteration action that stores the current Levenberg-Marquardt damping of each iteration
+ */
+class LevenbergLambdaRecorder : public g2o::HyperGraphAction
+{
+public:
+  LevenbergLambdaRecorder(std::vector<double>* lambdas) : lambdas_(lambdas) {}
+  
+  virtual g2o::HyperGraphAction* operator()(const g2o::HyperGraph* graph, g2o::HyperGraphAction::Parameters* parameters = 0)
+  {
+    const g2o::SparseOptimizer* optimizer = static_cast<const g2o::SparseOptimizer*>(graph);
+    const g2o::OptimizationAlgorithmLevenberg* lm = dynamic_cast<const g2o::OptimizationAlgorithmLevenberg*>(optimizer->algorithm());
+    const g2o::HyperGraphAction::ParametersIteration* params = dynamic_cast<const g2o::HyperGraphAction::ParametersIteration*>(parameters);
+    if (lm && params && params->iteration >= 0 && params->iteration < (int)lambdas_->size())
+      (*lambdas_)[params->iteration] = lm->currentLambda();
+    return this;
+  }
+  
+private:
+  std::vector<double>* lambdas_;
+};
+
+//! Optimize a trajectory of the multi-start optimization (skipped if its initialization failed)
+void optimizeMultiStartCandidate(TebOptimalPlanner* planner, int iterations_innerloop, int iterations_outerloop,
+                                 double obst_cost_scale, double viapoint_cost_scale, bool alternative_time_cost, char* success)
+{
+  if (*success)
+    *success = planner->optimizeTEB(iterations_innerloop, iterations_outerloop, true, obst_cost_scale, viapoint_cost_scale, alternative_time_cost);
+}
+
+/**
+ * @brief Allocate an obstacle edge whose distance calculation is resolved at compile time for the given footprint type
+ * 
+ * Unknown footprint models fall back to the generic edge with virtual distance calculation.
+ * @tparam GenericEdge generic edge type (e.g. EdgeObstacle)
+ * @tparam SpecializedEdge edge template specialized for a footprint model (e.g. EdgeObstacleSpecialized)
+ * @param type concrete footprint type of the planner's robot model (see footprintType())
+ * @param args optional constructor arguments
+ */
+template <typename GenericEdge, template <typename> class SpecializedEdge, typename... Args>
+GenericEdge* createObstacleEdge(FootprintType type, Args... args)
+{
+  switch (type)
+  {
+    case FootprintType::Point: return new SpecializedEdge<PointRobotFootprint>(args...);
+    case FootprintType::Circular: return new SpecializedEdge<CircularRobotFootprint>(args...);
+    case FootprintType::TwoCircles: return new SpecializedEdge<TwoCirclesRobotFootprint>(args...);
+    case FootprintType::Line: return new SpecializedEdge<LineRobotFootprint>(args...);
+    case FootprintType::Polygon: return new SpecializedEdge<PolygonRobotFootprint>(args...);
+    case FootprintType::MultiCircles: return new SpecializedEdge<MultiCirclesRobotFootprint>(args...);
+    default: return new GenericEdge(args...);
+  }
+}
+
+} // anonymous namespace
+
 // ============== Implementation ===================
 
-TebOptimalPlanner::TebOptimalPlanner() : cfg_(NULL), obstacles_(NULL), via_points_(NULL), cost_(HUGE_VAL), prefer_rotdir_(RotType::none),
-                                         robot_model_(new PointRobotFootprint()), initialized_(false), optimized_(false)
+TebOptimalPlanner::TebOptimalPlanner() : cfg_(NULL), obstacles_(NULL), via_points_(NULL), cost_(HUGE_VAL), iterations_(0), prefer_rotdir_(RotType::none),
+                                         robot_model_(new PointRobotFootprint()), footprint_type_(FootprintType::Point), linear_solver_(NULL), telemetry_source_id_(0),
+                                         constraint_violation_(std::numeric_limits<double>::quiet_NaN()), horizon_time_offset_(0),
+                                         initialized_(false), optimized_(false)
 {    
 }
   
-TebOptimalPlanner::TebOptimalPlanner(const TebConfig& cfg, ObstContainer* obstacles, RobotFootprintModelPtr robot_model, TebVisualizationPtr visual, const ViaPointContainer* via_points)
+TebOptimalPlanner::TebOptimalPlanner(const TebConfig& cfg, ObstContainer* obstacles, RobotFootprintModelPtr robot_model, const ViaPointContainer* via_points)
+  : footprint_type_(FootprintType::Generic), telemetry_source_id_(0)
 {    
-  initialize(cfg, obstacles, robot_model, visual, via_points);
+  initialize(cfg, obstacles, robot_model, via_points);
 }
 
 TebOptimalPlanner::~TebOptimalPlanner()
 {
   clearGraph();
+  if (optimizer_ && telemetry_action_)
+    optimizer_->removePostIterationAction(telemetry_action_.get());
+  if (optimizer_)
+  {
+    optimizer_->removePreIterationAction(edge_batch_.invalidateAction());
+    optimizer_->removeComputeErrorAction(edge_batch_.invalidateAction());
+  }
   // free dynamically allocated memory
   //if (optimizer_) 
   //  g2o::Factory::destroy();
@@ -66,50 +142,38 @@ TebOptimalPlanner::~TebOptimalPlanner()
   //g2o::HyperGraphActionLibrary::destroy();
 }
 
-void TebOptimalPlanner::initialize(const TebConfig& cfg, ObstContainer* obstacles, RobotFootprintModelPtr robot_model, TebVisualizationPtr visual, const ViaPointContainer* via_points)
+void TebOptimalPlanner::initialize(const TebConfig& cfg, ObstContainer* obstacles, RobotFootprintModelPtr robot_model, const ViaPointContainer* via_points)
 {    
   // init optimizer (set solver and block ordering settings)
   optimizer_ = initOptimizer();
   
+  // the batched edges must be reevaluated whenever the optimizer changes the vertices
+  edge_batch_.initialize(cfg, teb_);
+  optimizer_->addPreIterationAction(edge_batch_.invalidateAction());
+  optimizer_->addComputeErrorAction(edge_batch_.invalidateAction());
+  
   cfg_ = &cfg;
   obstacles_ = obstacles;
   robot_model_ = robot_model;
+  footprint_type_ = footprintType(robot_model_.get()); // select the obstacle edges once per footprint model
   via_points_ = via_points;
   cost_ = HUGE_VAL;
+  iterations_ = 0;
   prefer_rotdir_ = RotType::none;
-  setVisualization(visual);
+  constraint_violation_ = std::numeric_limits<double>::quiet_NaN();
+  horizon_time_offset_ = 0;
   
   vel_start_.first = true;
-  vel_start_.second.linear.x = 0;
-  vel_start_.second.linear.y = 0;
-  vel_start_.second.angular.z = 0;
+  vel_start_.second.setZero();
 
   vel_goal_.first = true;
-  vel_goal_.second.linear.x = 0;
-  vel_goal_.second.linear.y = 0;
-  vel_goal_.second.angular.z = 0;
-  initialized_ = true;
-}
-
-
-void TebOptimalPlanner::setVisualization(TebVisualizationPtr visualization)
-{
-  visualization_ = visualization;
-}
-
-void TebOptimalPlanner::visualize()
-{
-  if (!visualization_)
-    return;
- 
-  visualization_->publishLocalPlanAndPoses(teb_);
+  vel_goal_.second.setZero();
   
-  if (teb_.sizePoses() > 0)
-    visualization_->publishRobotFootprintModel(teb_.Pose(0), *robot_model_);
+  // steady-state mode: allocate the trajectory for the maximum number of samples in advance
+  if (cfg_->trajectory.preallocate_memory)
+    teb_.reserve(cfg_->trajectory.max_samples);
   
-  if (cfg_->trajectory.publish_feedback)
-    visualization_->publishFeedbackMessage(*this, *obstacles_);
- 
+  initialized_ = true;
 }
 
 
@@ -139,6 +203,7 @@ void TebOptimalPlanner::registerG2OTypes()
   factory->registerType("EDGE_DYNAMIC_OBSTACLE", new g2o::HyperGraphElementCreator<EdgeDynamicObstacle>);
   factory->registerType("EDGE_VIA_POINT", new g2o::HyperGraphElementCreator<EdgeViaPoint>);
   factory->registerType("EDGE_PREFER_ROTDIR", new g2o::HyperGraphElementCreator<EdgePreferRotDir>);
+  factory->registerType("EDGE_CONSECUTIVE_POSES", new g2o::HyperGraphElementCreator<EdgeConsecutivePoses>);
   return;
 }
 
@@ -156,6 +221,7 @@ boost::shared_ptr<g2o::SparseOptimizer> TebOptimalPlanner::initOptimizer()
   boost::shared_ptr<g2o::SparseOptimizer> optimizer = boost::make_shared<g2o::SparseOptimizer>();
   TEBLinearSolver* linearSolver = new TEBLinearSolver(); // see typedef in optimization.h
   linearSolver->setBlockOrdering(true);
+  linear_solver_ = linearSolver;
   TEBBlockSolver* blockSolver = new TEBBlockSolver(std::unique_ptr<TEBLinearSolver>(linearSolver));
   g2o::OptimizationAlgorithmLevenberg* solver = new g2o::OptimizationAlgorithmLevenberg(std::unique_ptr<TEBBlockSolver>(blockSolver));
 
@@ -175,6 +241,12 @@ bool TebOptimalPlanner::optimizeTEB(int iterations_innerloop, int iterations_out
   
   bool success = false;
   optimized_ = false;
+  iterations_ = 0;
+  constraint_violation_ = std::numeric_limits<double>::quiet_NaN();
+  
+  if (cfg_->optim.augmented_lagrangian)
+    return optimizeTEBAugmentedLagrangian(iterations_innerloop, iterations_outerloop, compute_cost_afterwards,
+                                          obst_cost_scale, viapoint_cost_scale, alternative_time_cost);
   
   double weight_multiplier = 1.0;
 
@@ -184,22 +256,79 @@ bool TebOptimalPlanner::optimizeTEB(int iterations_innerloop, int iterations_out
   //                 the legacy fast mode as default until we finish our tests.
   bool fast_mode = !cfg_->obstacles.include_dynamic_obstacles;
   
+  if (telemetry_ && (int)telemetry_lambdas_.size() < iterations_innerloop)
+    telemetry_lambdas_.resize(iterations_innerloop);
+  
   for(int i=0; i<iterations_outerloop; ++i)
   {
+    std::chrono::steady_clock::time_point t_outer_start;
+    if (telemetry_)
+    {
+      t_outer_start = std::chrono::steady_clock::now();
+      optimizer_->batchStatistics().clear();
+      std::fill(telemetry_lambdas_.begin(), telemetry_lambdas_.end(), std::numeric_limits<double>::quiet_NaN());
+    }
+    
     if (cfg_->trajectory.teb_autosize)
     {
+      AllocationPhaseScope alloc_phase(AllocationPhase::TebResize);
       //teb_.autoResize(cfg_->trajectory.dt_ref, cfg_->trajectory.dt_hysteresis, cfg_->trajectory.min_samples, cfg_->trajectory.max_samples);
       teb_.autoResize(cfg_->trajectory.dt_ref, cfg_->trajectory.dt_hysteresis, cfg_->trajectory.min_samples, cfg_->trajectory.max_samples, fast_mode);
 
     }
 
-    success = buildGraph(weight_multiplier);
+    // long trajectories are optimized segment-wise
+    int partitions = 1;
+    if (cfg_->optim.horizon_partitions > 1 && teb_.sizePoses() >= cfg_->optim.horizon_partition_min_poses)
+      partitions = std::min(cfg_->optim.horizon_partitions, (teb_.sizePoses()-1) / 8); // the shifted sweep requires at least 4 poses per half segment
+    
+    if (partitions > 1)
+    {
+      success = optimizeHorizonPartitions(partitions, iterations_innerloop, weight_multiplier);
+      if (!success)
+        return false;
+      optimized_ = true;
+      
+      // the constraint violation, the telemetry and the cost refer to the complete trajectory
+      bool last_iteration = i==iterations_outerloop-1;
+      if (last_iteration || telemetry_)
+      {
+        {
+          AllocationPhaseScope alloc_phase(AllocationPhase::GraphBuild);
+          buildGraph(weight_multiplier);
+        }
+        optimizer_->initializeOptimization();
+        optimizer_->computeActiveErrors();
+        if (last_iteration)
+          constraint_violation_ = computeConstraintViolation();
+        if (telemetry_)
+          recordTelemetry(i, std::chrono::duration<double>(std::chrono::steady_clock::now() - t_outer_start).count());
+        if (compute_cost_afterwards && last_iteration)
+          computeCurrentCost(obst_cost_scale, viapoint_cost_scale, alternative_time_cost);
+        clearGraph();
+      }
+      
+      weight_multiplier *= cfg_->optim.weight_adapt_factor;
+      continue;
+    }
+
+    {
+      AllocationPhaseScope alloc_phase(AllocationPhase::GraphBuild);
+      success = buildGraph(weight_multiplier);
+    }
     if (!success) 
     {
         clearGraph();
         return false;
     }
-    success = optimizeGraph(iterations_innerloop, false);
+    {
+      AllocationPhaseScope alloc_phase(AllocationPhase::Optimization);
+      success = optimizeGraph(iterations_innerloop, false);
+    }
+    if (success && i==iterations_outerloop-1)
+      constraint_violation_ = computeConstraintViolation();
+    if (telemetry_)
+      recordTelemetry(i, std::chrono::duration<double>(std::chrono::steady_clock::now() - t_outer_start).count());
     if (!success) 
     {
         clearGraph();
@@ -218,39 +347,225 @@ bool TebOptimalPlanner::optimizeTEB(int iterations_innerloop, int iterations_out
   return true;
 }
 
-void TebOptimalPlanner::setVelocityStart(const geometry_msgs::Twist& vel_start)
+bool TebOptimalPlanner::optimizeTEBAugmentedLagrangian(int iterations_innerloop, int iterations_outerloop, bool compute_cost_afterwards,
+                                                       double obst_cost_scale, double viapoint_cost_scale, bool alternative_time_cost)
+{
+  // the trajectory is resized and the graph is built only once, the outer iterations update the multipliers in place
+  if (cfg_->trajectory.teb_autosize)
+  {
+    AllocationPhaseScope alloc_phase(AllocationPhase::TebResize);
+    teb_.autoResize(cfg_->trajectory.dt_ref, cfg_->trajectory.dt_hysteresis, cfg_->trajectory.min_samples, cfg_->trajectory.max_samples,
+                    !cfg_->obstacles.include_dynamic_obstacles);
+  }
+  
+  bool success = false;
+  {
+    AllocationPhaseScope alloc_phase(AllocationPhase::GraphBuild);
+    success = buildGraph();
+  }
+  if (!success)
+  {
+    clearGraph();
+    return false;
+  }
+  
+  if (telemetry_ && (int)telemetry_lambdas_.size() < iterations_innerloop)
+    telemetry_lambdas_.resize(iterations_innerloop);
+  
+  for (int i=0; i<iterations_outerloop; ++i)
+  {
+    std::chrono::steady_clock::time_point t_outer_start;
+    if (telemetry_)
+    {
+      t_outer_start = std::chrono::steady_clock::now();
+      optimizer_->batchStatistics().clear();
+      std::fill(telemetry_lambdas_.begin(), telemetry_lambdas_.end(), std::numeric_limits<double>::quiet_NaN());
+    }
+    
+    {
+      AllocationPhaseScope alloc_phase(AllocationPhase::Optimization);
+      success = optimizeGraph(iterations_innerloop, false);
+    }
+    if (success)
+    {
+      optimizer_->computeActiveErrors(); // the errors of the last (possibly rejected) step might be outdated
+      constraint_violation_ = computeConstraintViolation();
+    }
+    if (telemetry_)
+      recordTelemetry(i, std::chrono::duration<double>(std::chrono::steady_clock::now() - t_outer_start).count());
+    if (!success)
+    {
+      clearGraph();
+      return false;
+    }
+    optimized_ = true;
+    
+    if (constraint_violation_ <= cfg_->optim.augmented_lagrangian_tolerance)
+      break;
+    
+    if (i < iterations_outerloop-1)
+      updateConstraintMultipliers(false);
+  }
+  
+  if (compute_cost_afterwards)
+  {
+    // the cost refers to the plain penalties in order to be comparable to other trajectories
+    updateConstraintMultipliers(true);
+    optimizer_->computeActiveErrors();
+    computeCurrentCost(obst_cost_scale, viapoint_cost_scale, alternative_time_cost);
+  }
+  
+  clearGraph();
+  return true;
+}
+
+double TebOptimalPlanner::computeConstraintViolation() const
+{
+  double violation = 0;
+  for (std::vector<g2o::OptimizableGraph::Edge*>::const_iterator it = optimizer_->activeEdges().begin(); it != optimizer_->activeEdges().end(); ++it)
+  {
+    const ConstraintEdge* edge = dynamic_cast<const ConstraintEdge*>(*it);
+    if (edge)
+      violation = std::max(violation, edge->getConstraintViolation());
+  }
+  return violation;
+}
+
+void TebOptimalPlanner::updateConstraintMultipliers(bool reset)
+{
+  for (std::vector<g2o::OptimizableGraph::Edge*>::const_iterator it = optimizer_->activeEdges().begin(); it != optimizer_->activeEdges().end(); ++it)
+  {
+    ConstraintEdge* edge = dynamic_cast<ConstraintEdge*>(*it);
+    if (!edge)
+      continue;
+    if (reset)
+      edge->resetMultipliers();
+    else
+      edge->updateMultipliers();
+  }
+}
+
+void TebOptimalPlanner::setTelemetry(OptimizerTelemetryPtr telemetry)
+{
+  TEB_ASSERT_MSG(initialized_, "Call initialize() first.");
+  telemetry_ = telemetry;
+  optimizer_->setComputeBatchStatistics(telemetry_ ? true : false);
+  if (telemetry_ && !telemetry_action_)
+  {
+    telemetry_action_ = boost::make_shared<LevenbergLambdaRecorder>(&telemetry_lambdas_);
+    optimizer_->addPostIterationAction(telemetry_action_.get());
+  }
+  else if (!telemetry_ && telemetry_action_)
+  {
+    optimizer_->removePostIterationAction(telemetry_action_.get());
+    telemetry_action_.reset();
+  }
+  if (telemetry_ && telemetry_lambdas_.size() < (std::size_t)cfg_->optim.no_inner_iterations)
+    telemetry_lambdas_.resize(cfg_->optim.no_inner_iterations, std::numeric_limits<double>::quiet_NaN());
+}
+
+void TebOptimalPlanner::recordTelemetry(int outer_iteration, double time_outer_iteration)
+{
+  OptimizerIterationRecord summary = OptimizerIterationRecord();
+  summary.source = telemetry_source_id_;
+  summary.outer_iteration = outer_iteration;
+  summary.inner_iteration = -1;
+  summary.num_vertices = (int)optimizer_->vertices().size();
+  summary.num_edges = (int)optimizer_->edges().size();
+  summary.chi2 = std::numeric_limits<double>::quiet_NaN();
+  summary.lambda = std::numeric_limits<double>::quiet_NaN();
+  
+  // g2o resizes the statistics container to the number of requested iterations,
+  // only entries with a valid graph size belong to iterations that were actually started.
+  const g2o::BatchStatisticsContainer& stats = optimizer_->batchStatistics();
+  for (std::size_t k = 0; k < stats.size() && stats[k].numEdges > 0; ++k)
+  {
+    OptimizerIterationRecord rec;
+    rec.source = telemetry_source_id_;
+    rec.outer_iteration = outer_iteration;
+    rec.inner_iteration = (int)k;
+    rec.num_vertices = stats[k].numVertices;
+    rec.num_edges = stats[k].numEdges;
+    rec.chi2 = stats[k].chi2;
+    rec.lambda = k < telemetry_lambdas_.size() ? telemetry_lambdas_[k] : std::numeric_limits<double>::quiet_NaN();
+    rec.rejected_steps = std::max(0, stats[k].levenbergIterations - 1);
+    rec.time_residuals = stats[k].timeResiduals;
+    rec.time_linearize = stats[k].timeLinearize;
+    rec.time_hessian = stats[k].timeQuadraticForm;
+    rec.time_solve = stats[k].timeLinearSolver;
+    rec.time_iteration = stats[k].timeIteration;
+    rec.constraint_violation = std::numeric_limits<double>::quiet_NaN();
+    telemetry_->record(rec);
+    
+    summary.chi2 = rec.chi2;
+    if (!std::isnan(rec.lambda))
+      summary.lambda = rec.lambda;
+    summary.rejected_steps += rec.rejected_steps;
+    summary.time_residuals += rec.time_residuals;
+    summary.time_linearize += rec.time_linearize;
+    summary.time_hessian += rec.time_hessian;
+    summary.time_solve += rec.time_solve;
+  }
+  summary.time_iteration = time_outer_iteration;
+  summary.constraint_violation = constraint_violation_;
+  telemetry_->record(summary);
+}
+
+void TebOptimalPlanner::setVelocityStart(const Twist2D& vel_start)
 {
   vel_start_.first = true;
-  vel_start_.second.linear.x = vel_start.linear.x;
-  vel_start_.second.linear.y = vel_start.linear.y;
-  vel_start_.second.angular.z = vel_start.angular.z;
+  vel_start_.second = vel_start;
 }
 
-void TebOptimalPlanner::setVelocityGoal(const geometry_msgs::Twist& vel_goal)
+void TebOptimalPlanner::setVelocityGoal(const Twist2D& vel_goal)
 {
   vel_goal_.first = true;
   vel_goal_.second = vel_goal;
 }
 
-bool TebOptimalPlanner::plan(const std::vector<geometry_msgs::PoseStamped>& initial_plan, const geometry_msgs::Twist* start_vel, bool free_goal_vel)
+void TebOptimalPlanner::initFeasibleTimeProfile()
+{
+  if (!cfg_->trajectory.feasible_time_init || !teb_.isInit())
+    return;
+  
+  AllocationPhaseScope alloc_phase(AllocationPhase::TebResize);
+  if (cfg_->trajectory.teb_autosize)
+    teb_.autoResize(cfg_->trajectory.dt_ref, cfg_->trajectory.dt_hysteresis, cfg_->trajectory.min_samples, cfg_->trajectory.max_samples,
+                    !cfg_->obstacles.include_dynamic_obstacles);
+  
+  double start_vel = vel_start_.first ? vel_start_.second.vx : 0;
+  double goal_vel = vel_goal_.first ? vel_goal_.second.vx : cfg_->robot.max_vel_x;
+  teb_.initTimeProfile(cfg_->robot.max_vel_x, cfg_->robot.max_vel_x_backwards, cfg_->robot.max_vel_theta,
+                       cfg_->robot.acc_lim_x, cfg_->robot.acc_lim_theta, start_vel, goal_vel);
+}
+
+bool TebOptimalPlanner::plan(const PoseSE2Container& initial_plan, const Twist2D* start_vel, bool free_goal_vel)
 {    
-  ROS_ASSERT_MSG(initialized_, "Call initialize() first.");
-  if (!teb_.isInit())
-  {
-    // init trajectory
-    teb_.initTrajectoryToGoal(initial_plan, cfg_->robot.max_vel_x, cfg_->trajectory.global_plan_overwrite_orientation, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
-  } 
-  else // warm start
+  TEB_ASSERT_MSG(initialized_, "Call initialize() first.");
+  bool cold_start = !teb_.isInit();
+  bool plain_init = false; // initialized along the global plan (not from the experience cache or a Reeds-Shepp path)
   {
-    PoseSE2 start_(initial_plan.front().pose);
-    PoseSE2 goal_(initial_plan.back().pose);
-    if (teb_.sizePoses()>0 && (goal_.position() - teb_.BackPose().position()).norm() < cfg_->trajectory.force_reinit_new_goal_dist) // actual warm start!
-      teb_.updateAndPruneTEB(start_, goal_, cfg_->trajectory.min_samples); // update TEB
-    else // goal too far away -> reinit
+    AllocationPhaseScope alloc_phase(AllocationPhase::TebResize);
+    if (!teb_.isInit())
+    {
+      // init trajectory
+      if (!initTrajectoryFromExperience(initial_plan.front(), initial_plan.back()) && !initCarlikeTrajectory(initial_plan.front(), initial_plan.back()))
+        plain_init = teb_.initTrajectoryToGoal(initial_plan, cfg_->robot.max_vel_x, cfg_->trajectory.global_plan_overwrite_orientation, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
+    } 
+    else // warm start
     {
-      ROS_DEBUG("New goal: distance to existing goal is higher than the specified threshold. Reinitalizing trajectories.");
-      teb_.clearTimedElasticBand();
-      teb_.initTrajectoryToGoal(initial_plan, cfg_->robot.max_vel_x, true, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
+      const PoseSE2& start_ = initial_plan.front();
+      const PoseSE2& goal_ = initial_plan.back();
+      if (teb_.sizePoses()>0 && (goal_.position() - teb_.BackPose().position()).norm() < cfg_->trajectory.force_reinit_new_goal_dist) // actual warm start!
+        teb_.updateAndPruneTEB(start_, goal_, cfg_->trajectory.min_samples); // update TEB
+      else // goal too far away -> reinit
+      {
+        TEB_DEBUG("New goal: distance to existing goal is higher than the specified threshold. Reinitalizing trajectories.");
+        teb_.clearTimedElasticBand();
+        cold_start = true;
+        if (!initTrajectoryFromExperience(start_, goal_) && !initCarlikeTrajectory(start_, goal_))
+          plain_init = teb_.initTrajectoryToGoal(initial_plan, cfg_->robot.max_vel_x, true, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
+      }
     }
   }
   if (start_vel)
@@ -259,36 +574,388 @@ bool TebOptimalPlanner::plan(const std::vector<geometry_msgs::PoseStamped>& init
     setVelocityGoalFree();
   else
     vel_goal_.first = true; // we just reactivate and use the previously set velocity (should be zero if nothing was modified)
+  if (plain_init) // the experience cache and the Reeds-Shepp initialization already provide a suitable time profile
+    initFeasibleTimeProfile();
   
   // now optimize
-  return optimizeTEB(cfg_->optim.no_inner_iterations, cfg_->optim.no_outer_iterations);
+  bool success;
+  if (cfg_->optim.multi_start_candidates > 1 && !cfg_->hcp.enable_homotopy_class_planning)
+    success = optimizeMultiStart(initial_plan);
+  else
+    success = optimizeTEB(cfg_->optim.no_inner_iterations, cfg_->optim.no_outer_iterations);
+  if (success && cold_start)
+    storeExperience();
+  return success;
 }
 
 
-bool TebOptimalPlanner::plan(const tf::Pose& start, const tf::Pose& goal, const geometry_msgs::Twist* start_vel, bool free_goal_vel)
+bool TebOptimalPlanner::optimizeMultiStart(const PoseSE2Container& initial_plan)
 {
-  PoseSE2 start_(start);
-  PoseSE2 goal_(goal);
-  return plan(start_, goal_, start_vel);
+  int no_alternatives = cfg_->optim.multi_start_candidates - 1;
+  while ((int)multi_start_planners_.size() < no_alternatives)
+    multi_start_planners_.push_back(boost::make_shared<TebOptimalPlanner>(*cfg_, obstacles_, robot_model_, via_points_));
+  multi_start_success_.assign(no_alternatives + 1, 1);
+  
+  // initialize the alternative trajectories from scratch (index 0 refers to the warm start)
+  for (int i=0; i < no_alternatives; ++i)
+  {
+    TebOptimalPlanner& candidate = *multi_start_planners_[i];
+    candidate.obstacles_ = obstacles_;
+    candidate.via_points_ = via_points_;
+    candidate.robot_model_ = robot_model_;
+    candidate.footprint_type_ = footprint_type_;
+    candidate.vel_start_ = vel_start_;
+    candidate.vel_goal_ = vel_goal_;
+    candidate.prefer_rotdir_ = prefer_rotdir_;
+    
+    AllocationPhaseScope alloc_phase(AllocationPhase::TebResize);
+    candidate.teb_.clearTimedElasticBand();
+    multi_start_success_[i+1] = initMultiStartCandidate(i, initial_plan, candidate.teb_);
+    if (multi_start_success_[i+1])
+      candidate.initFeasibleTimeProfile();
+  }
+  
+  // optimize all trajectories, since they are independent of each other
+  // (the cost is computed with the selection parameters of the homotopy class planner)
+  int inner = cfg_->optim.no_inner_iterations;
+  int outer = cfg_->optim.no_outer_iterations;
+  double obst_scale = cfg_->hcp.selection_obst_cost_scale;
+  double viapoint_scale = cfg_->hcp.selection_viapoint_cost_scale;
+  bool alternative_time_cost = cfg_->hcp.selection_alternative_time_cost;
+  if (cfg_->hcp.enable_multithreading)
+  {
+    // see HomotopyClassPlanner::optimizeAllTEBs()
+    boost::this_thread::disable_interruption di;
+    
+    boost::thread_group threads;
+    for (int i=0; i < no_alternatives; ++i)
+      threads.create_thread( boost::bind(&optimizeMultiStartCandidate, multi_start_planners_[i].get(), inner, outer, obst_scale, viapoint_scale,
+                                         alternative_time_cost, &multi_start_success_[i+1]) );
+    optimizeMultiStartCandidate(this, inner, outer, obst_scale, viapoint_scale, alternative_time_cost, &multi_start_success_[0]); // the warm start is optimized in the calling thread
+    threads.join_all();
+  }
+  else
+  {
+    optimizeMultiStartCandidate(this, inner, outer, obst_scale, viapoint_scale, alternative_time_cost, &multi_start_success_[0]);
+    for (int i=0; i < no_alternatives; ++i)
+      optimizeMultiStartCandidate(multi_start_planners_[i].get(), inner, outer, obst_scale, viapoint_scale, alternative_time_cost, &multi_start_success_[i+1]);
+  }
+  
+  // select the collision-free trajectory with the lowest cost (or the cheapest one if all of them collide).
+  // The warm start is preferred by the hysteresis, since an alternative is optimized from scratch in a single cycle.
+  int best = -1;
+  bool best_collision_free = false;
+  double best_cost = HUGE_VAL;
+  for (int i=0; i <= no_alternatives; ++i)
+  {
+    if (!multi_start_success_[i])
+      continue;
+    const TebOptimalPlanner* candidate = i==0 ? this : multi_start_planners_[i-1].get();
+    bool collision_free = candidate->isCollisionFree(cfg_->trajectory.feasibility_check_no_poses);
+    double cost = i==0 ? candidate->cost_ * cfg_->optim.multi_start_selection_hysteresis : candidate->cost_;
+    if ((collision_free && !best_collision_free) || (collision_free == best_collision_free && cost < best_cost))
+    {
+      best = i;
+      best_collision_free = collision_free;
+      best_cost = cost;
+    }
+  }
+  
+  if (best < 0)
+    return false;
+  
+  if (best > 0)
+  {
+    // take over the alternative trajectory, it serves as warm start in the next cycle
+    TebOptimalPlanner& candidate = *multi_start_planners_[best-1];
+    teb_.swapTrajectory(candidate.teb_);
+    cost_ = candidate.cost_;
+    iterations_ = candidate.iterations_;
+    optimized_ = true;
+    TEB_DEBUG("Multi-start optimization: selected alternative initialization %d.", best-1);
+  }
+  return true;
 }
 
-bool TebOptimalPlanner::plan(const PoseSE2& start, const PoseSE2& goal, const geometry_msgs::Twist* start_vel, bool free_goal_vel)
-{	
-  ROS_ASSERT_MSG(initialized_, "Call initialize() first.");
-  if (!teb_.isInit())
+
+bool TebOptimalPlanner::initMultiStartCandidate(int candidate, const PoseSE2Container& initial_plan, TimedElasticBand& teb)
+{
+  const PoseSE2& start = initial_plan.front();
+  const PoseSE2& goal = initial_plan.back();
+  
+  if (candidate == 0) // global plan
+    return teb.initTrajectoryToGoal(initial_plan, cfg_->robot.max_vel_x, true, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
+  
+  if (candidate == 1) // straight line
+    return teb.initTrajectoryToGoal(start, goal, 0, cfg_->robot.max_vel_x, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
+  
+  // global plan displaced to the left and to the right with increasing offsets
+  Eigen::Vector2d direction = goal.position() - start.position();
+  double length = direction.norm();
+  if (length < 1e-6)
+    return false;
+  Eigen::Vector2d normal(-direction.y() / length, direction.x() / length);
+  double offset = ((candidate - 2) / 2 + 1) * cfg_->optim.multi_start_lateral_offset;
+  if (candidate % 2 == 1)
+    offset = -offset;
+  
+  multi_start_plan_.assign(initial_plan.begin(), initial_plan.end());
+  if (multi_start_plan_.size() < 3)
+    multi_start_plan_.insert(multi_start_plan_.begin() + 1, PoseSE2(0.5 * (start.position() + goal.position()), start.theta()));
+  
+  // the displacement vanishes at the start and at the goal
+  int n = (int) multi_start_plan_.size();
+  for (int i=1; i < n-1; ++i)
+    multi_start_plan_[i].position() += std::sin(M_PI * (double) i / (double) (n-1)) * offset * normal;
+  
+  return teb.initTrajectoryToGoal(multi_start_plan_, cfg_->robot.max_vel_x, true, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
+}
+
+
+bool TebOptimalPlanner::initTrajectoryFromExperience(const PoseSE2& start, const PoseSE2& goal)
+{
+  if (!cfg_->experience.enable || !experience_cache_)
+    return false;
+  
+  ExperienceDescriptor descriptor;
+  experience_cache_->describe(start, goal, obstacles_, ExperienceCache::robotIdentifier(robot_model_, cfg_->robot.min_turning_radius), descriptor);
+  if (!experience_cache_->retrieve(descriptor, start, goal, cfg_->experience.max_goal_distance, cfg_->experience.max_goal_angle,
+                                   cfg_->experience.max_cell_mismatch, teb_))
+    return false;
+  
+  TEB_DEBUG("Initialized the trajectory from the experience cache (%d poses).", teb_.sizePoses());
+  return true;
+}
+
+void TebOptimalPlanner::storeExperience()
+{
+  if (!cfg_->experience.enable || !experience_cache_ || !teb_.isInit() || !isCollisionFree(-1))
+    return;
+  
+  ExperienceDescriptor descriptor;
+  experience_cache_->describe(teb_.Pose(0), teb_.BackPose(), obstacles_,
+                              ExperienceCache::robotIdentifier(robot_model_, cfg_->robot.min_turning_radius), descriptor);
+  experience_cache_->insert(descriptor, teb_);
+}
+
+
+bool TebOptimalPlanner::initCarlikeTrajectory(const PoseSE2& start, const PoseSE2& goal)
+{
+  if (!cfg_->trajectory.carlike_path_init || cfg_->robot.min_turning_radius <= 0)
+    return false;
+  
+  ReedsSheppPath path;
+  if (!path.compute(start, goal, cfg_->robot.min_turning_radius, cfg_->trajectory.allow_init_with_backwards_motion) || path.length() < 1e-3)
+    return false;
+  
+  carlike_init_plan_.clear();
+  path.sample(cfg_->trajectory.dt_ref * cfg_->robot.max_vel_x, cfg_->trajectory.dt_ref * cfg_->robot.max_vel_x_backwards, carlike_init_plan_);
+  if (!teb_.initTrajectoryToGoal(carlike_init_plan_, cfg_->robot.max_vel_x, false, cfg_->trajectory.min_samples, false))
+    return false;
+  
+  // segments that are traversed backwards are timed w.r.t. the backward velocity limit
+  if (cfg_->robot.max_vel_x_backwards > 0)
+  {
+    for (int i=0; i < teb_.sizeTimeDiffs(); ++i)
+    {
+      Eigen::Vector2d delta = teb_.Pose(i+1).position() - teb_.Pose(i).position();
+      if (delta.dot(teb_.Pose(i).orientationUnitVec()) < 0)
+        teb_.TimeDiff(i) = delta.norm() / cfg_->robot.max_vel_x_backwards;
+    }
+  }
+  TEB_DEBUG("Initialized the trajectory along a %s path of length %.2f m.",
+            cfg_->trajectory.allow_init_with_backwards_motion ? "Reeds-Shepp" : "Dubins", path.length());
+  return true;
+}
+
+
+bool TebOptimalPlanner::isCollisionFree(int look_ahead_idx) const
+{
+  if (!obstacles_ || !robot_model_)
+    return true;
+  
+  if (look_ahead_idx < 0 || look_ahead_idx >= teb_.sizePoses())
+    look_ahead_idx = teb_.sizePoses() - 1;
+  
+  for (int i=0; i <= look_ahead_idx; ++i)
+  {
+    for (const ObstaclePtr& obst : *obstacles_)
+    {
+      if (robot_model_->calculateDistance(teb_.Pose(i), obst.get()) <= 0)
+        return false;
+    }
+  }
+  return true;
+}
+
+
+bool TebOptimalPlanner::optimizeHorizonPartitions(int partitions, int iterations_innerloop, double weight_multiplier)
+{
+  int n = teb_.sizePoses();
+  while ((int)horizon_segment_planners_.size() < partitions+1)
+    horizon_segment_planners_.push_back(boost::make_shared<TebOptimalPlanner>(*cfg_, obstacles_, robot_model_, via_points_));
+  horizon_segment_via_points_.resize(partitions+1);
+  
+  for (int sweep=0; sweep < 2; ++sweep)
+  {
+    // the second sweep shifts the boundaries by half a segment, such that the poses fixed in the first sweep become free
+    horizon_boundaries_.clear();
+    horizon_boundaries_.push_back(0);
+    if (sweep == 0)
+    {
+      for (int k=1; k < partitions; ++k)
+        horizon_boundaries_.push_back(k*(n-1) / partitions);
+    }
+    else
+    {
+      for (int k=0; k < partitions; ++k)
+        horizon_boundaries_.push_back((2*k+1)*(n-1) / (2*partitions));
+    }
+    horizon_boundaries_.push_back(n-1);
+    int no_segments = (int)horizon_boundaries_.size() - 1;
+    
+    // associate each via-point with the segment that contains its closest pose.
+    // A closest pose that is fixed at a boundary is replaced by the next free pose of that segment (see AddEdgesViaPoints()).
+    for (int k=0; k < no_segments; ++k)
+      horizon_segment_via_points_[k].clear();
+    if (via_points_ != NULL && cfg_->optim.weight_viapoint != 0)
+    {
+      int start_pose_idx = 0;
+      for (ViaPointContainer::const_iterator vp_it = via_points_->begin(); vp_it != via_points_->end(); ++vp_it)
+      {
+        int index = teb_.findClosestTrajectoryPose(*vp_it, NULL, start_pose_idx);
+        if (cfg_->trajectory.via_points_ordered)
+          start_pose_idx = index+2;
+        index = std::min(std::max(index, 1), n-2);
+        int k = 0;
+        while (k < no_segments-1 && index >= horizon_boundaries_[k+1])
+          ++k;
+        horizon_segment_via_points_[k].push_back(*vp_it);
+      }
+    }
+    
+    // copy the segments. The two outer poses at an inner boundary and the timediff between them are fixed,
+    // hence the velocity and acceleration edges couple the segment to the current state of its neighbors.
+    double time_offset = 0;
+    for (int k=0; k < no_segments; ++k)
+    {
+      int begin = horizon_boundaries_[k];
+      int end = horizon_boundaries_[k+1];
+      TebOptimalPlanner& segment = *horizon_segment_planners_[k];
+      segment.obstacles_ = obstacles_;
+      segment.via_points_ = &horizon_segment_via_points_[k];
+      segment.robot_model_ = robot_model_;
+      segment.footprint_type_ = footprint_type_;
+      segment.vel_start_ = begin == 0 ? vel_start_ : std::make_pair(false, Twist2D());
+      segment.vel_goal_ = end == n-1 ? vel_goal_ : std::make_pair(false, Twist2D());
+      segment.prefer_rotdir_ = begin == 0 ? prefer_rotdir_ : RotType::none;
+      segment.iterations_ = 0;
+      segment.horizon_time_offset_ = time_offset; // dynamic obstacles are predicted w.r.t. the start of the complete trajectory
+      
+      AllocationPhaseScope alloc_phase(AllocationPhase::TebResize);
+      TimedElasticBand& band = segment.teb_;
+      band.clearTimedElasticBand();
+      band.addPose(teb_.Pose(begin), teb_.PoseVertex(begin)->fixed());
+      for (int i=begin; i < end; ++i)
+      {
+        band.addPose(teb_.Pose(i+1), teb_.PoseVertex(i+1)->fixed());
+        band.addTimeDiff(teb_.TimeDiff(i), teb_.TimeDiffVertex(i)->fixed());
+        time_offset += teb_.TimeDiff(i);
+      }
+      int last = end - begin;
+      if (begin > 0)
+      {
+        band.setPoseVertexFixed(0, true);
+        band.setPoseVertexFixed(1, true);
+        band.setTimeDiffVertexFixed(0, true);
+      }
+      if (end < n-1)
+      {
+        band.setPoseVertexFixed(last-1, true);
+        band.setPoseVertexFixed(last, true);
+        band.setTimeDiffVertexFixed(last-1, true);
+      }
+    }
+    
+    // optimize all segments (see HomotopyClassPlanner::optimizeAllTEBs())
+    horizon_segment_success_.assign(no_segments, 1);
+    if (cfg_->hcp.enable_multithreading)
+    {
+      boost::this_thread::disable_interruption di;
+      
+      boost::thread_group threads;
+      for (int k=1; k < no_segments; ++k)
+        threads.create_thread( boost::bind(&TebOptimalPlanner::optimizeHorizonSegment, horizon_segment_planners_[k].get(), iterations_innerloop,
+                                           weight_multiplier, &horizon_segment_success_[k]) );
+      horizon_segment_planners_[0]->optimizeHorizonSegment(iterations_innerloop, weight_multiplier, &horizon_segment_success_[0]); // the first segment is optimized in the calling thread
+      threads.join_all();
+    }
+    else
+    {
+      for (int k=0; k < no_segments; ++k)
+        horizon_segment_planners_[k]->optimizeHorizonSegment(iterations_innerloop, weight_multiplier, &horizon_segment_success_[k]);
+    }
+    
+    // write back the free poses and timediffs (they are disjoint for all segments)
+    for (int k=0; k < no_segments; ++k)
+    {
+      if (!horizon_segment_success_[k])
+        return false;
+      
+      TebOptimalPlanner& segment = *horizon_segment_planners_[k];
+      int begin = horizon_boundaries_[k];
+      for (int i=0; i < segment.teb_.sizePoses(); ++i)
+      {
+        if (!segment.teb_.PoseVertex(i)->fixed())
+          teb_.Pose(begin+i) = segment.teb_.Pose(i);
+        if (i < segment.teb_.sizeTimeDiffs() && !segment.teb_.TimeDiffVertex(i)->fixed())
+          teb_.TimeDiff(begin+i) = segment.teb_.TimeDiff(i);
+      }
+      iterations_ += segment.iterations_;
+    }
+  }
+  return true;
+}
+
+void TebOptimalPlanner::optimizeHorizonSegment(int iterations_innerloop, double weight_multiplier, char* success)
+{
+  {
+    AllocationPhaseScope alloc_phase(AllocationPhase::GraphBuild);
+    *success = buildGraph(weight_multiplier);
+  }
+  if (*success)
   {
-    // init trajectory
-    teb_.initTrajectoryToGoal(start, goal, 0, cfg_->robot.max_vel_x, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion); // 0 intermediate samples, but dt=1 -> autoResize will add more samples before calling first optimization
+    AllocationPhaseScope alloc_phase(AllocationPhase::Optimization);
+    *success = optimizeGraph(iterations_innerloop, false);
   }
-  else // warm start
+  clearGraph();
+}
+
+bool TebOptimalPlanner::plan(const PoseSE2& start, const PoseSE2& goal, const Twist2D* start_vel, bool free_goal_vel)
+{	
+  TEB_ASSERT_MSG(initialized_, "Call initialize() first.");
+  bool cold_start = !teb_.isInit();
+  bool plain_init = false; // initialized along a straight line (not from the experience cache or a Reeds-Shepp path)
   {
-    if (teb_.sizePoses()>0 && (goal.position() - teb_.BackPose().position()).norm() < cfg_->trajectory.force_reinit_new_goal_dist) // actual warm start!
-      teb_.updateAndPruneTEB(start, goal, cfg_->trajectory.min_samples);
-    else // goal too far away -> reinit
+    AllocationPhaseScope alloc_phase(AllocationPhase::TebResize);
+    if (!teb_.isInit())
     {
-      ROS_DEBUG("New goal: distance to existing goal is higher than the specified threshold. Reinitalizing trajectories.");
-      teb_.clearTimedElasticBand();
-      teb_.initTrajectoryToGoal(start, goal, 0, cfg_->robot.max_vel_x, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
+      // init trajectory
+      if (!initTrajectoryFromExperience(start, goal) && !initCarlikeTrajectory(start, goal))
+        plain_init = teb_.initTrajectoryToGoal(start, goal, 0, cfg_->robot.max_vel_x, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion); // 0 intermediate samples, but dt=1 -> autoResize will add more samples before calling first optimization
+    }
+    else // warm start
+    {
+      if (teb_.sizePoses()>0 && (goal.position() - teb_.BackPose().position()).norm() < cfg_->trajectory.force_reinit_new_goal_dist) // actual warm start!
+        teb_.updateAndPruneTEB(start, goal, cfg_->trajectory.min_samples);
+      else // goal too far away -> reinit
+      {
+        TEB_DEBUG("New goal: distance to existing goal is higher than the specified threshold. Reinitalizing trajectories.");
+        teb_.clearTimedElasticBand();
+        cold_start = true;
+        if (!initTrajectoryFromExperience(start, goal) && !initCarlikeTrajectory(start, goal))
+          plain_init = teb_.initTrajectoryToGoal(start, goal, 0, cfg_->robot.max_vel_x, cfg_->trajectory.min_samples, cfg_->trajectory.allow_init_with_backwards_motion);
+      }
     }
   }
   if (start_vel)
@@ -297,9 +964,38 @@ bool TebOptimalPlanner::plan(const PoseSE2& start, const PoseSE2& goal, const ge
     setVelocityGoalFree();
   else
     vel_goal_.first = true; // we just reactivate and use the previously set velocity (should be zero if nothing was modified)
+  if (plain_init) // the experience cache and the Reeds-Shepp initialization already provide a suitable time profile
+    initFeasibleTimeProfile();
       
   // now optimize
-  return optimizeTEB(cfg_->optim.no_inner_iterations, cfg_->optim.no_outer_iterations);
+  bool success = optimizeTEB(cfg_->optim.no_inner_iterations, cfg_->optim.no_outer_iterations);
+  if (success && cold_start)
+    storeExperience();
+  return success;
+}
+
+
+bool TebOptimalPlanner::refine(const PoseSE2Container& initial_plan, const Twist2D* start_vel, bool free_goal_vel)
+{
+  TEB_ASSERT_MSG(initialized_, "Call initialize() first.");
+  const PoseSE2& start = initial_plan.front();
+  const PoseSE2& goal = initial_plan.back();
+  if (!teb_.isInit() || (goal.position() - teb_.BackPose().position()).norm() >= cfg_->trajectory.force_reinit_new_goal_dist)
+    return plan(initial_plan, start_vel, free_goal_vel);
+  
+  {
+    AllocationPhaseScope alloc_phase(AllocationPhase::TebResize);
+    teb_.updateAndPruneTEB(start, goal, cfg_->trajectory.min_samples);
+  }
+  if (start_vel)
+    setVelocityStart(*start_vel);
+  if (free_goal_vel)
+    setVelocityGoalFree();
+  else
+    vel_goal_.first = true; // we just reactivate and use the previously set velocity (should be zero if nothing was modified)
+  
+  // refine with a single outer iteration
+  return optimizeTEB(cfg_->replanning.refine_iterations, 1);
 }
 
 
@@ -307,7 +1003,7 @@ bool TebOptimalPlanner::buildGraph(double weight_multiplier)
 {
   if (!optimizer_->edges().empty() || !optimizer_->vertices().empty())
   {
-    ROS_WARN("Cannot build graph, because it is not empty. Call graphClear()!");
+    TEB_WARN("Cannot build graph, because it is not empty. Call graphClear()!");
     return false;
   }
   
@@ -325,18 +1021,27 @@ bool TebOptimalPlanner::buildGraph(double weight_multiplier)
   
   AddEdgesViaPoints();
   
-  AddEdgesVelocity();
+  // the fused edge covers the pairwise terms of non-holonomic robots only
+  bool fuse_pairwise_edges = cfg_->optim.fuse_consecutive_pose_edges && cfg_->robot.max_vel_y == 0;
+  
+  if (!fuse_pairwise_edges)
+    AddEdgesVelocity();
   
   AddEdgesAcceleration();
 
   AddEdgesTimeOptimal();	
 
-  AddEdgesShortestPath();
-  
-  if (cfg_->robot.min_turning_radius == 0 || cfg_->optim.weight_kinematics_turning_radius == 0)
-    AddEdgesKinematicsDiffDrive(); // we have a differential drive robot
+  if (fuse_pairwise_edges)
+    AddEdgesConsecutivePoses();
   else
-    AddEdgesKinematicsCarlike(); // we have a carlike robot since the turning radius is bounded from below.
+  {
+    AddEdgesShortestPath();
+  
+    if (cfg_->robot.min_turning_radius == 0 || cfg_->optim.weight_kinematics_turning_radius == 0)
+      AddEdgesKinematicsDiffDrive(); // we have a differential drive robot
+    else
+      AddEdgesKinematicsCarlike(); // we have a carlike robot since the turning radius is bounded from below.
+  }
 
     
   AddEdgesPreferRotDir();
@@ -348,22 +1053,26 @@ bool TebOptimalPlanner::optimizeGraph(int no_iterations,bool clear_after)
 {
   if (cfg_->robot.max_vel_x<0.01)
   {
-    ROS_WARN("optimizeGraph(): Robot Max Velocity is smaller than 0.01m/s. Optimizing aborted...");
+    TEB_WARN("optimizeGraph(): Robot Max Velocity is smaller than 0.01m/s. Optimizing aborted...");
     if (clear_after) clearGraph();
     return false;	
   }
   
   if (!teb_.isInit() || teb_.sizePoses() < cfg_->trajectory.min_samples)
   {
-    ROS_WARN("optimizeGraph(): TEB is empty or has too less elements. Skipping optimization.");
+    TEB_WARN("optimizeGraph(): TEB is empty or has too less elements. Skipping optimization.");
     if (clear_after) clearGraph();
     return false;	
   }
   
   optimizer_->setVerbose(cfg_->optim.optimization_verbose);
+  linear_solver_->setReuseEnabled(cfg_->optim.reuse_symbolic_factorization);
   optimizer_->initializeOptimization();
 
+  edge_batch_.setActive(!edge_batch_.empty());
   int iter = optimizer_->optimize(no_iterations);
+  edge_batch_.setActive(false);
+  iterations_ += iter;
 
   // Save Hessian for visualization
   //  g2o::OptimizationAlgorithmLevenberg* lm = dynamic_cast<g2o::OptimizationAlgorithmLevenberg*> (optimizer_->solver());
@@ -371,7 +1080,7 @@ bool TebOptimalPlanner::optimizeGraph(int no_iterations,bool clear_after)
 
   if(!iter)
   {
-	ROS_ERROR("optimizeGraph(): Optimization failed! iter=%i", iter);
+	TEB_ERROR("optimizeGraph(): Optimization failed! iter=%i", iter);
 	return false;
   }
 
@@ -386,6 +1095,7 @@ void TebOptimalPlanner::clearGraph()
   //optimizer.edges().clear(); // optimizer.clear deletes edges!!! Therefore do not run optimizer.edges().clear()
   optimizer_->vertices().clear();  // neccessary, because optimizer->clear deletes pointer-targets (therefore it deletes TEB states!)
   optimizer_->clear();	
+  edge_batch_.clear();
 }
 
 
@@ -393,7 +1103,7 @@ void TebOptimalPlanner::clearGraph()
 void TebOptimalPlanner::AddTEBVertices()
 {
   // add vertices to graph
-  ROS_DEBUG_COND(cfg_->optim.optimization_verbose, "Adding TEB vertices ...");
+  TEB_DEBUG_COND(cfg_->optim.optimization_verbose, "Adding TEB vertices ...");
   unsigned int id_counter = 0; // used for vertices ids
   for (int i=0; i<teb_.sizePoses(); ++i)
   {
@@ -434,7 +1144,7 @@ void TebOptimalPlanner::AddEdgesObstacles(double weight_multiplier)
       
       std::vector<Obstacle*> relevant_obstacles;
       
-      const Eigen::Vector2d pose_orient = teb_.Pose(i).orientationUnitVec();
+      const Eigen::Vector2d& pose_orient = teb_.PoseVertex(i)->orientationUnitVec(); // cached in the vertex
       
       // iterate obstacles
       for (const ObstaclePtr& obst : *obstacles_)
@@ -444,7 +1154,7 @@ void TebOptimalPlanner::AddEdgesObstacles(double weight_multiplier)
           continue;
 
           // calculate distance to robot model
-          double dist = robot_model_->calculateDistance(teb_.Pose(i), obst.get());
+          double dist = robot_model_->calculateDistance(teb_.Pose(i), pose_orient, obst.get());
           
           // force considering obstacle if really close to the current pose
         if (dist < cfg_->obstacles.min_obstacle_dist*cfg_->obstacles.obstacle_association_force_inclusion_factor)
@@ -480,7 +1190,7 @@ void TebOptimalPlanner::AddEdgesObstacles(double weight_multiplier)
       {
             if (inflated)
             {
-                EdgeInflatedObstacle* dist_bandpt_obst = new EdgeInflatedObstacle;
+                EdgeInflatedObstacle* dist_bandpt_obst = createObstacleEdge<EdgeInflatedObstacle, EdgeInflatedObstacleSpecialized>(footprint_type_);
                 dist_bandpt_obst->setVertex(0,teb_.PoseVertex(i));
                 dist_bandpt_obst->setInformation(information_inflated);
                 dist_bandpt_obst->setParameters(*cfg_, robot_model_.get(), left_obstacle);
@@ -488,7 +1198,7 @@ void TebOptimalPlanner::AddEdgesObstacles(double weight_multiplier)
             }
             else
             {
-                EdgeObstacle* dist_bandpt_obst = new EdgeObstacle;
+                EdgeObstacle* dist_bandpt_obst = createObstacleEdge<EdgeObstacle, EdgeObstacleSpecialized>(footprint_type_);
                 dist_bandpt_obst->setVertex(0,teb_.PoseVertex(i));
                 dist_bandpt_obst->setInformation(information);
                 dist_bandpt_obst->setParameters(*cfg_, robot_model_.get(), left_obstacle);
@@ -500,7 +1210,7 @@ void TebOptimalPlanner::AddEdgesObstacles(double weight_multiplier)
       {
             if (inflated)
             {
-                EdgeInflatedObstacle* dist_bandpt_obst = new EdgeInflatedObstacle;
+                EdgeInflatedObstacle* dist_bandpt_obst = createObstacleEdge<EdgeInflatedObstacle, EdgeInflatedObstacleSpecialized>(footprint_type_);
                 dist_bandpt_obst->setVertex(0,teb_.PoseVertex(i));
                 dist_bandpt_obst->setInformation(information_inflated);
                 dist_bandpt_obst->setParameters(*cfg_, robot_model_.get(), right_obstacle);
@@ -508,7 +1218,7 @@ void TebOptimalPlanner::AddEdgesObstacles(double weight_multiplier)
             }
             else
             {
-                EdgeObstacle* dist_bandpt_obst = new EdgeObstacle;
+                EdgeObstacle* dist_bandpt_obst = createObstacleEdge<EdgeObstacle, EdgeObstacleSpecialized>(footprint_type_);
                 dist_bandpt_obst->setVertex(0,teb_.PoseVertex(i));
                 dist_bandpt_obst->setInformation(information);
                 dist_bandpt_obst->setParameters(*cfg_, robot_model_.get(), right_obstacle);
@@ -520,7 +1230,7 @@ void TebOptimalPlanner::AddEdgesObstacles(double weight_multiplier)
       {
             if (inflated)
             {
-                EdgeInflatedObstacle* dist_bandpt_obst = new EdgeInflatedObstacle;
+                EdgeInflatedObstacle* dist_bandpt_obst = createObstacleEdge<EdgeInflatedObstacle, EdgeInflatedObstacleSpecialized>(footprint_type_);
                 dist_bandpt_obst->setVertex(0,teb_.PoseVertex(i));
                 dist_bandpt_obst->setInformation(information_inflated);
                 dist_bandpt_obst->setParameters(*cfg_, robot_model_.get(), obst);
@@ -528,7 +1238,7 @@ void TebOptimalPlanner::AddEdgesObstacles(double weight_multiplier)
             }
             else
             {
-                EdgeObstacle* dist_bandpt_obst = new EdgeObstacle;
+                EdgeObstacle* dist_bandpt_obst = createObstacleEdge<EdgeObstacle, EdgeObstacleSpecialized>(footprint_type_);
                 dist_bandpt_obst->setVertex(0,teb_.PoseVertex(i));
                 dist_bandpt_obst->setInformation(information);
                 dist_bandpt_obst->setParameters(*cfg_, robot_model_.get(), obst);
@@ -574,7 +1284,7 @@ void TebOptimalPlanner::AddEdgesObstaclesLegacy(double weight_multiplier)
         
     if (inflated)
     {
-        EdgeInflatedObstacle* dist_bandpt_obst = new EdgeInflatedObstacle;
+        EdgeInflatedObstacle* dist_bandpt_obst = createObstacleEdge<EdgeInflatedObstacle, EdgeInflatedObstacleSpecialized>(footprint_type_);
         dist_bandpt_obst->setVertex(0,teb_.PoseVertex(index));
         dist_bandpt_obst->setInformation(information_inflated);
         dist_bandpt_obst->setParameters(*cfg_, robot_model_.get(), obst->get());
@@ -582,7 +1292,7 @@ void TebOptimalPlanner::AddEdgesObstaclesLegacy(double weight_multiplier)
     }
     else
     {
-        EdgeObstacle* dist_bandpt_obst = new EdgeObstacle;
+        EdgeObstacle* dist_bandpt_obst = createObstacleEdge<EdgeObstacle, EdgeObstacleSpecialized>(footprint_type_);
         dist_bandpt_obst->setVertex(0,teb_.PoseVertex(index));
         dist_bandpt_obst->setInformation(information);
         dist_bandpt_obst->setParameters(*cfg_, robot_model_.get(), obst->get());
@@ -595,7 +1305,7 @@ void TebOptimalPlanner::AddEdgesObstaclesLegacy(double weight_multiplier)
       {
             if (inflated)
             {
-                EdgeInflatedObstacle* dist_bandpt_obst_n_r = new EdgeInflatedObstacle;
+                EdgeInflatedObstacle* dist_bandpt_obst_n_r = createObstacleEdge<EdgeInflatedObstacle, EdgeInflatedObstacleSpecialized>(footprint_type_);
                 dist_bandpt_obst_n_r->setVertex(0,teb_.PoseVertex(index+neighbourIdx));
                 dist_bandpt_obst_n_r->setInformation(information_inflated);
                 dist_bandpt_obst_n_r->setParameters(*cfg_, robot_model_.get(), obst->get());
@@ -603,7 +1313,7 @@ void TebOptimalPlanner::AddEdgesObstaclesLegacy(double weight_multiplier)
             }
             else
             {
-                EdgeObstacle* dist_bandpt_obst_n_r = new EdgeObstacle;
+                EdgeObstacle* dist_bandpt_obst_n_r = createObstacleEdge<EdgeObstacle, EdgeObstacleSpecialized>(footprint_type_);
                 dist_bandpt_obst_n_r->setVertex(0,teb_.PoseVertex(index+neighbourIdx));
                 dist_bandpt_obst_n_r->setInformation(information);
                 dist_bandpt_obst_n_r->setParameters(*cfg_, robot_model_.get(), obst->get());
@@ -614,7 +1324,7 @@ void TebOptimalPlanner::AddEdgesObstaclesLegacy(double weight_multiplier)
       {
             if (inflated)
             {
-                EdgeInflatedObstacle* dist_bandpt_obst_n_l = new EdgeInflatedObstacle;
+                EdgeInflatedObstacle* dist_bandpt_obst_n_l = createObstacleEdge<EdgeInflatedObstacle, EdgeInflatedObstacleSpecialized>(footprint_type_);
                 dist_bandpt_obst_n_l->setVertex(0,teb_.PoseVertex(index-neighbourIdx));
                 dist_bandpt_obst_n_l->setInformation(information_inflated);
                 dist_bandpt_obst_n_l->setParameters(*cfg_, robot_model_.get(), obst->get());
@@ -622,7 +1332,7 @@ void TebOptimalPlanner::AddEdgesObstaclesLegacy(double weight_multiplier)
             }
             else
             {
-                EdgeObstacle* dist_bandpt_obst_n_l = new EdgeObstacle;
+                EdgeObstacle* dist_bandpt_obst_n_l = createObstacleEdge<EdgeObstacle, EdgeObstacleSpecialized>(footprint_type_);
                 dist_bandpt_obst_n_l->setVertex(0,teb_.PoseVertex(index-neighbourIdx));
                 dist_bandpt_obst_n_l->setInformation(information);
                 dist_bandpt_obst_n_l->setParameters(*cfg_, robot_model_.get(), obst->get());
@@ -651,10 +1361,10 @@ void TebOptimalPlanner::AddEdgesDynamicObstacles(double weight_multiplier)
       continue;
 
     // Skip first and last pose, as they are fixed
-    double time = teb_.TimeDiff(0);
+    double time = horizon_time_offset_ + teb_.TimeDiff(0);
     for (int i=1; i < teb_.sizePoses() - 1; ++i)
     {
-      EdgeDynamicObstacle* dynobst_edge = new EdgeDynamicObstacle(time);
+      EdgeDynamicObstacle* dynobst_edge = createObstacleEdge<EdgeDynamicObstacle, EdgeDynamicObstacleSpecialized>(footprint_type_, time);
       dynobst_edge->setVertex(0,teb_.PoseVertex(i));
       dynobst_edge->setInformation(information);
       dynobst_edge->setParameters(*cfg_, robot_model_.get(), obst->get());
@@ -694,10 +1404,16 @@ void TebOptimalPlanner::AddEdgesViaPoints()
       }
       else
       {
-        ROS_DEBUG("TebOptimalPlanner::AddEdgesViaPoints(): skipping a via-point that is close or behind the current robot pose.");
+        TEB_DEBUG("TebOptimalPlanner::AddEdgesViaPoints(): skipping a via-point that is close or behind the current robot pose.");
         continue; // skip via points really close or behind the current robot pose
       }
     }
+    // poses that are fixed at the boundary of a horizon segment cannot approach the via-point (see optimizeHorizonPartitions())
+    while (index < n-2 && teb_.PoseVertex(index)->fixed() && teb_.PoseVertex(index-1)->fixed())
+      ++index;
+    while (index > 1 && teb_.PoseVertex(index)->fixed() && teb_.PoseVertex(index+1)->fixed())
+      --index;
+    
     Eigen::Matrix<double,1,1> information;
     information.fill(cfg_->optim.weight_viapoint);
     
@@ -731,6 +1447,8 @@ void TebOptimalPlanner::AddEdgesVelocity()
       velocity_edge->setVertex(2,teb_.TimeDiffVertex(i));
       velocity_edge->setInformation(information);
       velocity_edge->setTebConfig(*cfg_);
+      if (cfg_->optim.batch_edge_linearization)
+        velocity_edge->setBatch(&edge_batch_, edge_batch_.addEdge(EdgeChainType::Velocity, i));
       optimizer_->addEdge(velocity_edge);
     }
   }
@@ -798,6 +1516,8 @@ void TebOptimalPlanner::AddEdgesAcceleration()
       acceleration_edge->setVertex(4,teb_.TimeDiffVertex(i+1));
       acceleration_edge->setInformation(information);
       acceleration_edge->setTebConfig(*cfg_);
+      if (cfg_->optim.batch_edge_linearization)
+        acceleration_edge->setBatch(&edge_batch_, edge_batch_.addEdge(EdgeChainType::Acceleration, i));
       optimizer_->addEdge(acceleration_edge);
     }
     
@@ -923,6 +1643,8 @@ void TebOptimalPlanner::AddEdgesKinematicsDiffDrive()
     kinematics_edge->setVertex(1,teb_.PoseVertex(i+1));      
     kinematics_edge->setInformation(information_kinematics);
     kinematics_edge->setTebConfig(*cfg_);
+    if (cfg_->optim.batch_edge_linearization)
+      kinematics_edge->setBatch(&edge_batch_, edge_batch_.addEdge(EdgeChainType::KinematicsDiffDrive, i));
     optimizer_->addEdge(kinematics_edge);
   }	 
 }
@@ -945,11 +1667,43 @@ void TebOptimalPlanner::AddEdgesKinematicsCarlike()
     kinematics_edge->setVertex(1,teb_.PoseVertex(i+1));      
     kinematics_edge->setInformation(information_kinematics);
     kinematics_edge->setTebConfig(*cfg_);
+    if (cfg_->optim.batch_edge_linearization)
+      kinematics_edge->setBatch(&edge_batch_, edge_batch_.addEdge(EdgeChainType::KinematicsCarlike, i));
     optimizer_->addEdge(kinematics_edge);
   }  
 }
 
 
+void TebOptimalPlanner::AddEdgesConsecutivePoses()
+{
+  // we have a carlike robot if the turning radius is bounded from below (see buildGraph)
+  bool carlike = cfg_->robot.min_turning_radius != 0 && cfg_->optim.weight_kinematics_turning_radius != 0;
+  
+  Eigen::Matrix<double,5,5> information;
+  information.fill(0.0);
+  information(0, 0) = cfg_->optim.weight_max_vel_x;
+  information(1, 1) = cfg_->optim.weight_max_vel_theta;
+  information(2, 2) = cfg_->optim.weight_kinematics_nh;
+  information(3, 3) = carlike ? cfg_->optim.weight_kinematics_turning_radius : cfg_->optim.weight_kinematics_forward_drive;
+  information(4, 4) = cfg_->optim.weight_shortest_path;
+  
+  if (information.diagonal().isZero())
+    return; // if all weights equal zero skip adding edges!
+  
+  for (int i=0; i < teb_.sizePoses()-1; ++i)
+  {
+    EdgeConsecutivePoses* consecutive_edge = new EdgeConsecutivePoses;
+    consecutive_edge->setVertex(0,teb_.PoseVertex(i));
+    consecutive_edge->setVertex(1,teb_.PoseVertex(i+1));
+    consecutive_edge->setVertex(2,teb_.TimeDiffVertex(i));
+    consecutive_edge->setInformation(information);
+    consecutive_edge->setTebConfig(*cfg_);
+    consecutive_edge->setCarlike(carlike);
+    optimizer_->addEdge(consecutive_edge);
+  }
+}
+
+
 void TebOptimalPlanner::AddEdgesPreferRotDir()
 {
   //TODO(roesmann): Note, these edges can result in odd predictions, in particular
@@ -964,7 +1718,7 @@ void TebOptimalPlanner::AddEdgesPreferRotDir()
 
   if (prefer_rotdir_ != RotType::right && prefer_rotdir_ != RotType::left)
   {
-    ROS_WARN("TebOptimalPlanner::AddEdgesPreferRotDir(): unsupported RotType selected. Skipping edge creation.");
+    TEB_WARN("TebOptimalPlanner::AddEdgesPreferRotDir(): unsupported RotType selected. Skipping edge creation.");
     return;
   }
 
@@ -998,6 +1752,7 @@ void TebOptimalPlanner::computeCurrentCost(double obst_cost_scale, double viapoi
     // between buildGraph and Optimize (deleted), but it depends on the application
     buildGraph();	
     optimizer_->initializeOptimization();
+    optimizer_->computeActiveErrors(); // the edges of a new graph do not store any error yet
   }
   else
   {
@@ -1086,7 +1841,7 @@ bool TebOptimalPlanner::getVelocityCommand(double& vx, double& vy, double& omega
 {
   if (teb_.sizePoses()<2)
   {
-    ROS_ERROR("TebOptimalPlanner::getVelocityCommand(): The trajectory contains less than 2 poses. Make sure to init and optimize/plan the trajectory fist.");
+    TEB_ERROR("TebOptimalPlanner::getVelocityCommand(): The trajectory contains less than 2 poses. Make sure to init and optimize/plan the trajectory fist.");
     vx = 0;
     vy = 0;
     omega = 0;
@@ -1096,7 +1851,7 @@ bool TebOptimalPlanner::getVelocityCommand(double& vx, double& vy, double& omega
   double dt = teb_.TimeDiff(0);
   if (dt<=0)
   {	
-    ROS_ERROR("TebOptimalPlanner::getVelocityCommand() - timediff<=0 is invalid!");
+    TEB_ERROR("TebOptimalPlanner::getVelocityCommand() - timediff<=0 is invalid!");
     vx = 0;
     vy = 0;
     omega = 0;
@@ -1108,34 +1863,68 @@ bool TebOptimalPlanner::getVelocityCommand(double& vx, double& vy, double& omega
   return true;
 }
 
-void TebOptimalPlanner::getVelocityProfile(std::vector<geometry_msgs::Twist>& velocity_profile) const
+bool TebOptimalPlanner::computeTrackingError(const PoseSE2& pose, double& dist, double& angle_diff) const
+{
+  if (!teb_.isInit())
+    return false;
+  
+  int idx = teb_.findClosestTrajectoryPose(pose.position(), &dist);
+  
+  // the robot is usually located between two poses of the trajectory
+  if (idx > 0)
+    dist = std::min(dist, distance_point_to_segment_2d(pose.position(), teb_.Pose(idx-1).position(), teb_.Pose(idx).position()));
+  if (idx < teb_.sizePoses()-1)
+    dist = std::min(dist, distance_point_to_segment_2d(pose.position(), teb_.Pose(idx).position(), teb_.Pose(idx+1).position()));
+  
+  angle_diff = std::abs(g2o::normalize_theta(pose.theta() - teb_.Pose(idx).theta()));
+  return true;
+}
+
+bool TebOptimalPlanner::predictState(double t, PoseSE2& pose, Twist2D& velocity) const
+{
+  if (teb_.sizePoses() < 2)
+    return false;
+  
+  double time = 0;
+  for (int i=0; i < teb_.sizeTimeDiffs(); ++i)
+  {
+    double dt = teb_.TimeDiff(i);
+    if (dt <= 0)
+      return false;
+    
+    if (t <= time + dt || i == teb_.sizeTimeDiffs()-1)
+    {
+      const PoseSE2& pose1 = teb_.Pose(i);
+      const PoseSE2& pose2 = teb_.Pose(i+1);
+      double s = std::max(0.0, std::min(1.0, (t - time) / dt));
+      pose.position() = pose1.position() + s * (pose2.position() - pose1.position());
+      pose.theta() = g2o::normalize_theta(pose1.theta() + s * g2o::normalize_theta(pose2.theta() - pose1.theta()));
+      extractVelocity(pose1, pose2, dt, velocity.vx, velocity.vy, velocity.omega);
+      return true;
+    }
+    time += dt;
+  }
+  return false;
+}
+
+void TebOptimalPlanner::getVelocityProfile(std::vector<Twist2D>& velocity_profile) const
 {
   int n = teb_.sizePoses();
   velocity_profile.resize( n+1 );
 
   // start velocity 
-  velocity_profile.front().linear.z = 0;
-  velocity_profile.front().angular.x = velocity_profile.front().angular.y = 0;  
-  velocity_profile.front().linear.x = vel_start_.second.linear.x;
-  velocity_profile.front().linear.y = vel_start_.second.linear.y;
-  velocity_profile.front().angular.z = vel_start_.second.angular.z;
+  velocity_profile.front() = vel_start_.second;
   
   for (int i=1; i<n; ++i)
   {
-    velocity_profile[i].linear.z = 0;
-    velocity_profile[i].angular.x = velocity_profile[i].angular.y = 0;
-    extractVelocity(teb_.Pose(i-1), teb_.Pose(i), teb_.TimeDiff(i-1), velocity_profile[i].linear.x, velocity_profile[i].linear.y, velocity_profile[i].angular.z);
+    extractVelocity(teb_.Pose(i-1), teb_.Pose(i), teb_.TimeDiff(i-1), velocity_profile[i].vx, velocity_profile[i].vy, velocity_profile[i].omega);
   }
   
   // goal velocity
-  velocity_profile.back().linear.z = 0;
-  velocity_profile.back().angular.x = velocity_profile.back().angular.y = 0;  
-  velocity_profile.back().linear.x = vel_goal_.second.linear.x;
-  velocity_profile.back().linear.y = vel_goal_.second.linear.y;
-  velocity_profile.back().angular.z = vel_goal_.second.angular.z;
+  velocity_profile.back() = vel_goal_.second;
 }
 
-void TebOptimalPlanner::getFullTrajectory(std::vector<TrajectoryPointMsg>& trajectory) const
+void TebOptimalPlanner::getFullTrajectory(TrajectoryPointContainer& trajectory) const
 {
   int n = teb_.sizePoses();
   
@@ -1147,61 +1936,49 @@ void TebOptimalPlanner::getFullTrajectory(std::vector<TrajectoryPointMsg>& traje
   double curr_time = 0;
   
   // start
-  TrajectoryPointMsg& start = trajectory.front();
-  teb_.Pose(0).toPoseMsg(start.pose);
-  start.velocity.linear.z = 0;
-  start.velocity.angular.x = start.velocity.angular.y = 0;
-  start.velocity.linear.x = vel_start_.second.linear.x;
-  start.velocity.linear.y = vel_start_.second.linear.y;
-  start.velocity.angular.z = vel_start_.second.angular.z;
-  start.time_from_start.fromSec(curr_time);
+  TrajectoryPoint& start = trajectory.front();
+  start.pose = teb_.Pose(0);
+  start.velocity = vel_start_.second;
+  start.time_from_start = curr_time;
   
   curr_time += teb_.TimeDiff(0);
   
   // intermediate points
   for (int i=1; i < n-1; ++i)
   {
-    TrajectoryPointMsg& point = trajectory[i];
-    teb_.Pose(i).toPoseMsg(point.pose);
-    point.velocity.linear.z = 0;
-    point.velocity.angular.x = point.velocity.angular.y = 0;
+    TrajectoryPoint& point = trajectory[i];
+    point.pose = teb_.Pose(i);
     double vel1_x, vel1_y, vel2_x, vel2_y, omega1, omega2;
     extractVelocity(teb_.Pose(i-1), teb_.Pose(i), teb_.TimeDiff(i-1), vel1_x, vel1_y, omega1);
     extractVelocity(teb_.Pose(i), teb_.Pose(i+1), teb_.TimeDiff(i), vel2_x, vel2_y, omega2);
-    point.velocity.linear.x = 0.5*(vel1_x+vel2_x);
-    point.velocity.linear.y = 0.5*(vel1_y+vel2_y);
-    point.velocity.angular.z = 0.5*(omega1+omega2);    
-    point.time_from_start.fromSec(curr_time);
+    point.velocity.vx = 0.5*(vel1_x+vel2_x);
+    point.velocity.vy = 0.5*(vel1_y+vel2_y);
+    point.velocity.omega = 0.5*(omega1+omega2);    
+    point.time_from_start = curr_time;
     
     curr_time += teb_.TimeDiff(i);
   }
   
   // goal
-  TrajectoryPointMsg& goal = trajectory.back();
-  teb_.BackPose().toPoseMsg(goal.pose);
-  goal.velocity.linear.z = 0;
-  goal.velocity.angular.x = goal.velocity.angular.y = 0;
-  goal.velocity.linear.x = vel_goal_.second.linear.x;
-  goal.velocity.linear.y = vel_goal_.second.linear.y;
-  goal.velocity.angular.z = vel_goal_.second.angular.z;
-  goal.time_from_start.fromSec(curr_time);
+  TrajectoryPoint& goal = trajectory.back();
+  goal.pose = teb_.BackPose();
+  goal.velocity = vel_goal_.second;
+  goal.time_from_start = curr_time;
 }
 
 
-bool TebOptimalPlanner::isTrajectoryFeasible(base_local_planner::CostmapModel* costmap_model, const std::vector<geometry_msgs::Point>& footprint_spec,
-                                             double inscribed_radius, double circumscribed_radius, int look_ahead_idx)
+bool TebOptimalPlanner::isTrajectoryFeasible(const FootprintCollisionChecker& checker, int look_ahead_idx)
 {
   if (look_ahead_idx < 0 || look_ahead_idx >= teb().sizePoses())
     look_ahead_idx = teb().sizePoses() - 1;
   
+  const double inscribed_radius = checker.getInscribedRadius();
+  
   for (int i=0; i <= look_ahead_idx; ++i)
   {           
-    if ( costmap_model->footprintCost(teb().Pose(i).x(), teb().Pose(i).y(), teb().Pose(i).theta(), footprint_spec, inscribed_radius, circumscribed_radius) < 0 )
+    if ( checker.footprintCost(teb().Pose(i)) < 0 )
     {
-      if (visualization_)
-      {
-        visualization_->publishInfeasibleRobotPose(teb().Pose(i), *robot_model_);
-      }
+      checker.infeasiblePoseDetected(teb().Pose(i));
       return false;
     }
     // Checks if the distance between two poses is higher than the robot radius or the orientation diff is bigger than the specified threshold
@@ -1222,13 +1999,9 @@ bool TebOptimalPlanner::isTrajectoryFeasible(base_local_planner::CostmapModel* c
           intermediate_pose.position() = intermediate_pose.position() + delta_dist / (n_additional_samples + 1.0);
           intermediate_pose.theta() = g2o::normalize_theta(intermediate_pose.theta() + 
                                                            delta_rot / (n_additional_samples + 1.0));
-          if ( costmap_model->footprintCost(intermediate_pose.x(), intermediate_pose.y(), intermediate_pose.theta(),
-            footprint_spec, inscribed_radius, circumscribed_radius) == -1 )
+          if ( checker.footprintCost(intermediate_pose) == -1 )
           {
-            if (visualization_) 
-            {
-              visualization_->publishInfeasibleRobotPose(intermediate_pose, *robot_model_);
-            }
+            checker.infeasiblePoseDetected(intermediate_pose);
             return false;
           }
         }
@@ -1239,7 +2012,7 @@ bool TebOptimalPlanner::isTrajectoryFeasible(base_local_planner::CostmapModel* c
 }
 
 
-bool TebOptimalPlanner::isHorizonReductionAppropriate(const std::vector<geometry_msgs::PoseStamped>& initial_plan) const
+bool TebOptimalPlanner::isHorizonReductionAppropriate(const PoseSE2Container& initial_plan) const
 {
   if (teb_.sizePoses() < int( 1.5*double(cfg_->trajectory.min_samples) ) ) // trajectory is short already
     return false;
@@ -1262,14 +2035,14 @@ bool TebOptimalPlanner::isHorizonReductionAppropriate(const std::vector<geometry
   // push the trajectory to the correct side.
   if ( std::abs( g2o::normalize_theta( teb_.Pose(0).theta() - teb_.BackPose().theta() ) ) > M_PI/2)
   {
-    ROS_DEBUG("TebOptimalPlanner::isHorizonReductionAppropriate(): Goal orientation - start orientation > 90° ");
+    TEB_DEBUG("TebOptimalPlanner::isHorizonReductionAppropriate(): Goal orientation - start orientation > 90° ");
     return true;
   }
   
   // check if goal heading deviates more than 90° w.r.t. start orienation
   if (teb_.Pose(0).orientationUnitVec().dot(teb_.BackPose().position() - teb_.Pose(0).position()) < 0)
   {
-    ROS_DEBUG("TebOptimalPlanner::isHorizonReductionAppropriate(): Goal heading - start orientation > 90° ");
+    TEB_DEBUG("TebOptimalPlanner::isHorizonReductionAppropriate(): Goal heading - start orientation > 90° ");
     return true;
   }
     
@@ -1277,15 +2050,15 @@ bool TebOptimalPlanner::isHorizonReductionAppropriate(const std::vector<geometry
   int idx=0; // first get point close to the robot (should be fast if the global path is already pruned!)
   for (; idx < (int)initial_plan.size(); ++idx)
   {
-    if ( std::sqrt(std::pow(initial_plan[idx].pose.position.x-teb_.Pose(0).x(), 2) + std::pow(initial_plan[idx].pose.position.y-teb_.Pose(0).y(), 2)) )
+    if ( std::sqrt(std::pow(initial_plan[idx].x()-teb_.Pose(0).x(), 2) + std::pow(initial_plan[idx].y()-teb_.Pose(0).y(), 2)) )
       break;
   } 
   // now calculate length
   double ref_path_length = 0;
   for (; idx < int(initial_plan.size())-1; ++idx)
   {
-    ref_path_length += std::sqrt(std::pow(initial_plan[idx+1].pose.position.x-initial_plan[idx].pose.position.x, 2) 
-                     + std::pow(initial_plan[idx+1].pose.position.y-initial_plan[idx].pose.position.y, 2) );
+    ref_path_length += std::sqrt(std::pow(initial_plan[idx+1].x()-initial_plan[idx].x(), 2) 
+                     + std::pow(initial_plan[idx+1].y()-initial_plan[idx].y(), 2) );
   } 
   
   // check distances along the teb trajectory (by the way, we also check if the distance between two poses is > obst_dist)
@@ -1295,14 +2068,14 @@ bool TebOptimalPlanner::isHorizonReductionAppropriate(const std::vector<geometry
     double dist = (teb_.Pose(i).position() - teb_.Pose(i-1).position()).norm();
     if (dist > 0.95*cfg_->obstacles.min_obstacle_dist)
     {
-      ROS_DEBUG("TebOptimalPlanner::isHorizonReductionAppropriate(): Distance between consecutive poses > 0.9*min_obstacle_dist");
+      TEB_DEBUG("TebOptimalPlanner::isHorizonReductionAppropriate(): Distance between consecutive poses > 0.9*min_obstacle_dist");
       return true;
     }
     ref_path_length += dist;
   }
   if (ref_path_length>0 && teb_length/ref_path_length < 0.7) // now check ratio
   {
-    ROS_DEBUG("TebOptimalPlanner::isHorizonReductionAppropriate(): Planned trajectory is at least 30° shorter than the initial plan");
+    TEB_DEBUG("TebOptimalPlanner::isHorizonReductionAppropriate(): Planned trajectory is at least 30° shorter than the initial plan");
     return true;
   }
   
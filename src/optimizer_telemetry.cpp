@@ -0,0 +1,115 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/optimizer_telemetry.h>
+
+
+namespace teb_local_planner
+{
+
+OptimizerTelemetry::OptimizerTelemetry(std::size_t capacity) : buffer_(capacity > 0 ? capacity : 1), head_(0), size_(0), dropped_(0), cycle_(0)
+{
+}
+
+void OptimizerTelemetry::record(const OptimizerIterationRecord& record)
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  buffer_[head_] = record;
+  buffer_[head_].cycle = cycle_;
+  head_ = (head_ + 1) % buffer_.size();
+  if (size_ < buffer_.size())
+    ++size_;
+  else
+    ++dropped_;
+}
+
+unsigned int OptimizerTelemetry::nextCycle()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return ++cycle_;
+}
+
+unsigned int OptimizerTelemetry::currentCycle() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return cycle_;
+}
+
+void OptimizerTelemetry::getRecords(std::vector<OptimizerIterationRecord>& records) const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  records.clear();
+  records.reserve(size_);
+  std::size_t oldest = (head_ + buffer_.size() - size_) % buffer_.size();
+  for (std::size_t i = 0; i < size_; ++i)
+    records.push_back(buffer_[(oldest + i) % buffer_.size()]);
+}
+
+void OptimizerTelemetry::getCycle(unsigned int cycle, std::vector<OptimizerIterationRecord>& records) const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  records.clear();
+  std::size_t oldest = (head_ + buffer_.size() - size_) % buffer_.size();
+  for (std::size_t i = 0; i < size_; ++i)
+  {
+    const OptimizerIterationRecord& rec = buffer_[(oldest + i) % buffer_.size()];
+    if (rec.cycle == cycle)
+      records.push_back(rec);
+  }
+}
+
+std::size_t OptimizerTelemetry::size() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return size_;
+}
+
+unsigned long OptimizerTelemetry::droppedRecords() const
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  return dropped_;
+}
+
+void OptimizerTelemetry::clear()
+{
+  boost::mutex::scoped_lock lock(mutex_);
+  head_ = 0;
+  size_ = 0;
+}
+
+} // namespace teb_local_planner
@@ -0,0 +1,237 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/plan_processing.h>
+#include <teb_local_planner/logging.h>
+#include <teb_local_planner/misc.h>
+
+#include <g2o/stuff/misc.h>
+
+#include <cmath>
+
+
+namespace teb_local_planner
+{
+
+bool prunePlan(const PoseSE2& robot_pose, PoseSE2Container& global_plan, double dist_behind_robot)
+{
+  if (global_plan.empty())
+    return true;
+  
+  double dist_thresh_sq = dist_behind_robot*dist_behind_robot;
+  
+  // iterate plan until a pose close the robot is found
+  PoseSE2Container::iterator it = global_plan.begin();
+  PoseSE2Container::iterator erase_end = global_plan.end();
+  while (it != global_plan.end())
+  {
+    double dist_sq = (robot_pose.position() - it->position()).squaredNorm();
+    if (dist_sq < dist_thresh_sq)
+    {
+       erase_end = it;
+       break;
+    }
+    ++it;
+  }
+  if (erase_end == global_plan.end())
+    return false;
+  
+  if (erase_end != global_plan.begin())
+    global_plan.erase(global_plan.begin(), erase_end);
+  return true;
+}
+
+
+bool extractLocalPlan(const PoseSE2Container& global_plan, const PoseSE2& robot_pose, double dist_threshold, double max_plan_length,
+                      PoseSE2Container& local_plan, int* current_goal_idx)
+{
+  local_plan.clear();
+  
+  if (global_plan.empty())
+  {
+    TEB_ERROR("Received plan with zero length");
+    if (current_goal_idx) *current_goal_idx = 0;
+    return false;
+  }
+  
+  int i = 0;
+  double sq_dist_threshold = dist_threshold * dist_threshold;
+  double sq_dist = 1e10;
+  
+  // we need to loop to a point on the plan that is within a certain distance of the robot
+  for (int j=0; j < (int)global_plan.size(); ++j)
+  {
+    double new_sq_dist = (robot_pose.position() - global_plan[j].position()).squaredNorm();
+    if (new_sq_dist > sq_dist_threshold)
+      break;  // force stop if we have reached the border of the local map
+    
+    if (new_sq_dist < sq_dist) // find closest distance
+    {
+      sq_dist = new_sq_dist;
+      i = j;
+    }
+  }
+  
+  double plan_length = 0; // check cumulative Euclidean distance along the plan
+  
+  // now we'll copy until points are outside of our distance threshold
+  while (i < (int)global_plan.size() && sq_dist <= sq_dist_threshold && (max_plan_length<=0 || plan_length <= max_plan_length))
+  {
+    local_plan.push_back(global_plan[i]);
+    
+    sq_dist = (robot_pose.position() - global_plan[i].position()).squaredNorm();
+    
+    // caclulate distance to previous pose
+    if (i>0 && max_plan_length>0)
+      plan_length += (global_plan[i].position() - global_plan[i-1].position()).norm();
+    
+    ++i;
+  }
+  
+  // if we are really close to the goal (<sq_dist_threshold) and the goal is not yet reached (e.g. orientation error >>0)
+  // the resulting local plan can be empty. In that case we explicitly inject the global goal.
+  if (local_plan.empty())
+  {
+    local_plan.push_back(global_plan.back());
+    if (current_goal_idx) *current_goal_idx = int(global_plan.size())-1;
+  }
+  else
+  {
+    if (current_goal_idx) *current_goal_idx = i-1; // subtract 1, since i was increased once before leaving the loop
+  }
+  return true;
+}
+
+
+void extractViaPoints(const PoseSE2Container& plan, double min_separation, ViaPointContainer& via_points)
+{
+  via_points.clear();
+  
+  if (min_separation<=0)
+    return;
+  
+  std::size_t prev_idx = 0;
+  for (std::size_t i=1; i < plan.size(); ++i) // skip first one, since we do not need any point before the first min_separation [m]
+  {
+    // check separation to the previous via-point inserted
+    if ((plan[i].position() - plan[prev_idx].position()).norm() < min_separation)
+      continue;
+    
+    // add via-point
+    via_points.push_back(plan[i].position());
+    prev_idx = i;
+  }
+}
+
+
+double estimateLocalGoalOrientation(const PoseSE2Container& global_plan, const PoseSE2& local_goal,
+                                    int current_goal_idx, int moving_average_length)
+{
+  int n = (int)global_plan.size();
+  
+  // check if we are near the global goal already
+  if (current_goal_idx > n-moving_average_length-2)
+  {
+    if (current_goal_idx >= n-1) // we've exactly reached the goal
+      return local_goal.theta();
+    else
+      return global_plan.back().theta();
+  }
+  
+  // reduce number of poses taken into account if the desired number of poses is not available
+  moving_average_length = std::min(moving_average_length, n-current_goal_idx-1 ); // maybe redundant, since we have checked the vicinity of the goal before
+  
+  std::vector<double> candidates;
+  Eigen::Vector2d pose_k = local_goal.position();
+  
+  int range_end = current_goal_idx + moving_average_length;
+  for (int i = current_goal_idx; i < range_end; ++i)
+  {
+    const Eigen::Vector2d& pose_kp1 = global_plan.at(i+1).position();
+    
+    // calculate yaw angle
+    candidates.push_back( std::atan2(pose_kp1.y() - pose_k.y(), pose_kp1.x() - pose_k.x()) );
+    
+    pose_k = pose_kp1;
+  }
+  return average_angles(candidates);
+}
+
+
+void saturateVelocity(double& vx, double& vy, double& omega, double max_vel_x, double max_vel_y, double max_vel_theta, double max_vel_x_backwards)
+{
+  // Limit translational velocity for forward driving
+  if (vx > max_vel_x)
+    vx = max_vel_x;
+  
+  // limit strafing velocity
+  if (vy > max_vel_y)
+    vy = max_vel_y;
+  else if (vy < -max_vel_y)
+    vy = -max_vel_y;
+  
+  // Limit angular velocity
+  if (omega > max_vel_theta)
+    omega = max_vel_theta;
+  else if (omega < -max_vel_theta)
+    omega = -max_vel_theta;
+  
+  // Limit backwards velocity
+  if (max_vel_x_backwards<=0)
+  {
+    TEB_WARN_ONCE("saturateVelocity(): Do not choose max_vel_x_backwards to be <=0. Disable backwards driving by increasing the optimization weight for penalyzing backwards driving.");
+  }
+  else if (vx < -max_vel_x_backwards)
+    vx = -max_vel_x_backwards;
+}
+
+
+double convertTransRotVelToSteeringAngle(double v, double omega, double wheelbase, double min_turning_radius)
+{
+  if (omega==0 || v==0)
+    return 0;
+  
+  double radius = v/omega;
+  
+  if (fabs(radius) < min_turning_radius)
+    radius = double(g2o::sign(radius)) * min_turning_radius; 
+  
+  return std::atan(wheelbase / radius);
+}
+
+} // namespace teb_local_planner
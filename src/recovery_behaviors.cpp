@@ -37,7 +37,7 @@
  *********************************************************************/
 
 #include <teb_local_planner/recovery_behaviors.h>
-#include <ros/ros.h>
+#include <teb_local_planner/logging.h>
 #include <limits>
 #include <functional>
 #include <numeric>
@@ -48,14 +48,14 @@ namespace teb_local_planner
 
 // ============== FailureDetector Implementation ===================
 
-void FailureDetector::update(const geometry_msgs::Twist& twist, double v_max, double v_backwards_max, double omega_max, double v_eps, double omega_eps)
+void FailureDetector::update(const Twist2D& twist, double v_max, double v_backwards_max, double omega_max, double v_eps, double omega_eps)
 {
     if (buffer_.capacity() == 0)
         return;
     
     VelMeasurement measurement;
-    measurement.v = twist.linear.x; // just consider linear velocity in x-direction in the robot frame for now
-    measurement.omega = twist.angular.z;
+    measurement.v = twist.vx; // just consider linear velocity in x-direction in the robot frame for now
+    measurement.omega = twist.omega;
     
     if (measurement.v > 0 && v_max>0)
         measurement.v /= v_max;
@@ -109,10 +109,85 @@ bool FailureDetector::detect(double v_eps, double omega_eps)
     {
         oscillating_ = true;
     }
-//     ROS_INFO_STREAM("v: " << std::abs(v_mean) << ", omega: " << std::abs(omega_mean) << ", zero crossings: " << omega_zero_crossings);
+//     TEB_INFO_STREAM("v: " << std::abs(v_mean) << ", omega: " << std::abs(omega_mean) << ", zero crossings: " << omega_zero_crossings);
     return oscillating_;
 }
+
+
+// ============== BackupModeManager Implementation ===================
+
+BackupModeManager::BackupModeManager() : cfg_(NULL), no_infeasible_plans_(0),
+                                         time_last_infeasible_plan_(-std::numeric_limits<double>::infinity()),
+                                         time_last_oscillation_(-std::numeric_limits<double>::infinity()),
+                                         last_preferred_rotdir_(RotType::none)
+{
+}
+
+void BackupModeManager::initialize(const TebConfig& cfg, int oscillation_buffer_length, const ClockPtr& clock)
+{
+    cfg_ = &cfg;
+    clock_ = clock;
+    failure_detector_.setBufferLength(oscillation_buffer_length);
+    reset();
+}
+
+void BackupModeManager::notifyInfeasiblePlan()
+{
+    ++no_infeasible_plans_; // increase number of infeasible solutions in a row
+    time_last_infeasible_plan_ = now();
+}
+
+bool BackupModeManager::updateOscillationRecovery(const Twist2D& last_cmd, const Twist2D& robot_vel, PlannerInterface& planner)
+{
+    if (!cfg_ || !cfg_->recovery.oscillation_recovery)
+        return false;
+    
+    double max_vel_theta;
+    double max_vel_current = last_cmd.vx >= 0 ? cfg_->robot.max_vel_x : cfg_->robot.max_vel_x_backwards;
+    if (cfg_->robot.min_turning_radius!=0 && max_vel_current>0)
+        max_vel_theta = std::max( max_vel_current/std::abs(cfg_->robot.min_turning_radius),  cfg_->robot.max_vel_theta );
+    else
+        max_vel_theta = cfg_->robot.max_vel_theta;
     
+    failure_detector_.update(last_cmd, cfg_->robot.max_vel_x, cfg_->robot.max_vel_x_backwards, max_vel_theta,
+                             cfg_->recovery.oscillation_v_eps, cfg_->recovery.oscillation_omega_eps);
     
+    double time_now = now();
+    bool oscillating = failure_detector_.isOscillating();
+    bool recently_oscillated = (time_now - time_last_oscillation_) < cfg_->recovery.oscillation_recovery_min_duration; // check if we have already detected an oscillation recently
+    bool activated = false;
+    
+    if (oscillating)
+    {
+        if (!recently_oscillated)
+        {
+            // save current turning direction
+            if (robot_vel.omega > 0)
+                last_preferred_rotdir_ = RotType::left;
+            else
+                last_preferred_rotdir_ = RotType::right;
+            TEB_WARN("BackupModeManager: possible oscillation (of the robot or its local plan) detected. Activating recovery strategy (prefer current turning direction during optimization).");
+            activated = true;
+        }
+        time_last_oscillation_ = time_now;
+        planner.setPreferredTurningDir(last_preferred_rotdir_);
+    }
+    else if (!recently_oscillated && last_preferred_rotdir_ != RotType::none) // clear recovery behavior
+    {
+        last_preferred_rotdir_ = RotType::none;
+        planner.setPreferredTurningDir(last_preferred_rotdir_);
+        TEB_INFO("BackupModeManager: oscillation recovery disabled/expired.");
+    }
+    return activated;
+}
+
+void BackupModeManager::reset()
+{
+    failure_detector_.clear();
+    no_infeasible_plans_ = 0;
+    time_last_infeasible_plan_ = -std::numeric_limits<double>::infinity();
+    time_last_oscillation_ = -std::numeric_limits<double>::infinity();
+    last_preferred_rotdir_ = RotType::none;
+}
 
 } // namespace teb_local_planner
@@ -0,0 +1,579 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/reeds_shepp_path.h>
+
+#include <cmath>
+#include <limits>
+
+
+namespace teb_local_planner
+{
+
+namespace
+{
+
+const double RS_ZERO = 1e-5; //!< Tolerance for the admissibility of segment lengths
+
+//! Normalize an angle to [-pi, pi)
+inline double mod2pi(double x)
+{
+  double v = std::fmod(x, 2*M_PI);
+  if (v < -M_PI)
+    v += 2*M_PI;
+  else if (v > M_PI)
+    v -= 2*M_PI;
+  return v;
+}
+
+//! Normalize an angle to [0, 2pi)
+inline double mod2piPositive(double x)
+{
+  double v = std::fmod(x, 2*M_PI);
+  if (v < 0)
+    v += 2*M_PI;
+  return v;
+}
+
+inline void polar(double x, double y, double& r, double& theta)
+{
+  r = std::sqrt(x*x + y*y);
+  theta = std::atan2(y, x);
+}
+
+inline void tauOmega(double u, double v, double xi, double eta, double phi, double& tau, double& omega)
+{
+  double delta = mod2pi(u - v);
+  double A = std::sin(u) - std::sin(delta);
+  double B = std::cos(u) - std::cos(delta) - 1.;
+  double t1 = std::atan2(eta*A - xi*B, xi*A + eta*B);
+  double t2 = 2. * (std::cos(delta) - std::cos(v) - std::cos(u)) + 3.;
+  tau = (t2 < 0) ? mod2pi(t1 + M_PI) : mod2pi(t1);
+  omega = mod2pi(tau - u + v - phi);
+}
+
+// formula 8.1
+inline bool LpSpLp(double x, double y, double phi, double& t, double& u, double& v)
+{
+  polar(x - std::sin(phi), y - 1. + std::cos(phi), u, t);
+  if (t >= -RS_ZERO)
+  {
+    v = mod2pi(phi - t);
+    return v >= -RS_ZERO;
+  }
+  return false;
+}
+
+// formula 8.2
+inline bool LpSpRp(double x, double y, double phi, double& t, double& u, double& v)
+{
+  double t1, u1;
+  polar(x + std::sin(phi), y - 1. - std::cos(phi), u1, t1);
+  u1 = u1*u1;
+  if (u1 >= 4.)
+  {
+    u = std::sqrt(u1 - 4.);
+    t = mod2pi(t1 + std::atan2(2., u));
+    v = mod2pi(t - phi);
+    return t >= -RS_ZERO && v >= -RS_ZERO;
+  }
+  return false;
+}
+
+// formula 8.3
+inline bool LpRmL(double x, double y, double phi, double& t, double& u, double& v)
+{
+  double xi = x - std::sin(phi);
+  double eta = y - 1. + std::cos(phi);
+  double u1, theta;
+  polar(xi, eta, u1, theta);
+  if (u1 <= 4.)
+  {
+    u = -2. * std::asin(.25 * u1);
+    t = mod2pi(theta + .5*u + M_PI);
+    v = mod2pi(phi - t + u);
+    return t >= -RS_ZERO && u <= RS_ZERO;
+  }
+  return false;
+}
+
+// formula 8.7
+inline bool LpRupLumRm(double x, double y, double phi, double& t, double& u, double& v)
+{
+  double xi = x + std::sin(phi);
+  double eta = y - 1. - std::cos(phi);
+  double rho = .25 * (2. + std::sqrt(xi*xi + eta*eta));
+  if (rho <= 1.)
+  {
+    u = std::acos(rho);
+    tauOmega(u, -u, xi, eta, phi, t, v);
+    return t >= -RS_ZERO && v <= RS_ZERO;
+  }
+  return false;
+}
+
+// formula 8.8
+inline bool LpRumLumRp(double x, double y, double phi, double& t, double& u, double& v)
+{
+  double xi = x + std::sin(phi);
+  double eta = y - 1. - std::cos(phi);
+  double rho = (20. - xi*xi - eta*eta) / 16.;
+  if (rho >= 0 && rho <= 1)
+  {
+    u = -std::acos(rho);
+    if (u >= -.5*M_PI)
+    {
+      tauOmega(u, u, xi, eta, phi, t, v);
+      return t >= -RS_ZERO && v >= -RS_ZERO;
+    }
+  }
+  return false;
+}
+
+// formula 8.9
+inline bool LpRmSmLm(double x, double y, double phi, double& t, double& u, double& v)
+{
+  double xi = x - std::sin(phi);
+  double eta = y - 1. + std::cos(phi);
+  double rho, theta;
+  polar(xi, eta, rho, theta);
+  if (rho >= 2.)
+  {
+    double r = std::sqrt(rho*rho - 4.);
+    u = 2. - r;
+    t = mod2pi(theta + std::atan2(r, -2.));
+    v = mod2pi(phi - .5*M_PI - t);
+    return t >= -RS_ZERO && u <= RS_ZERO && v <= RS_ZERO;
+  }
+  return false;
+}
+
+// formula 8.10
+inline bool LpRmSmRm(double x, double y, double phi, double& t, double& u, double& v)
+{
+  double xi = x + std::sin(phi);
+  double eta = y - 1. - std::cos(phi);
+  double rho, theta;
+  polar(-eta, xi, rho, theta);
+  if (rho >= 2.)
+  {
+    t = theta;
+    u = 2. - rho;
+    v = mod2pi(t + .5*M_PI - phi);
+    return t >= -RS_ZERO && u <= RS_ZERO && v <= RS_ZERO;
+  }
+  return false;
+}
+
+// formula 8.11 (corrected)
+inline bool LpRmSLmRp(double x, double y, double phi, double& t, double& u, double& v)
+{
+  double xi = x + std::sin(phi);
+  double eta = y - 1. - std::cos(phi);
+  double rho, theta;
+  polar(xi, eta, rho, theta);
+  if (rho >= 2.)
+  {
+    u = 4. - std::sqrt(rho*rho - 4.);
+    if (u <= RS_ZERO)
+    {
+      t = mod2pi(std::atan2((4. - u)*xi - 2.*eta, -2.*xi + (u - 4.)*eta));
+      v = mod2pi(t - phi);
+      return t >= -RS_ZERO && v >= -RS_ZERO;
+    }
+  }
+  return false;
+}
+
+typedef ReedsSheppPath::SegmentType Word[5];
+
+const ReedsSheppPath::SegmentType L = ReedsSheppPath::LEFT;
+const ReedsSheppPath::SegmentType S = ReedsSheppPath::STRAIGHT;
+const ReedsSheppPath::SegmentType R = ReedsSheppPath::RIGHT;
+const ReedsSheppPath::SegmentType N = ReedsSheppPath::NOP;
+
+const Word RS_WORDS[18] = {
+  {L, R, L, N, N}, {R, L, R, N, N}, // 0-1: CCC
+  {L, R, L, R, N}, {R, L, R, L, N}, // 2-3: CCCC
+  {L, R, S, L, N}, {R, L, S, R, N}, {L, S, R, L, N}, {R, S, L, R, N}, // 4-7: CCSC
+  {L, R, S, R, N}, {R, L, S, L, N}, {R, S, R, L, N}, {L, S, L, R, N}, // 8-11: CCSC
+  {L, S, R, N, N}, {R, S, L, N, N}, {L, S, L, N, N}, {R, S, R, N, N}, // 12-15: CSC
+  {L, R, S, L, R}, {R, L, S, R, L} // 16-17: CCSCC
+};
+
+/**
+ * @brief Candidate path in normalized coordinates, keeps the shortest of all offered words
+ */
+struct ShortestWord
+{
+  const ReedsSheppPath::SegmentType* word = NULL;
+  double lengths[5] = {0, 0, 0, 0, 0};
+  double total = std::numeric_limits<double>::infinity();
+  
+  void offer(const Word& w, double t, double u, double v, double x = 0, double y = 0)
+  {
+    double sum = std::abs(t) + std::abs(u) + std::abs(v) + std::abs(x) + std::abs(y);
+    if (sum >= total)
+      return;
+    word = w;
+    lengths[0] = t; lengths[1] = u; lengths[2] = v; lengths[3] = x; lengths[4] = y;
+    total = sum;
+  }
+};
+
+void CSC(double x, double y, double phi, ShortestWord& best)
+{
+  double t, u, v;
+  if (LpSpLp(x, y, phi, t, u, v))
+    best.offer(RS_WORDS[14], t, u, v);
+  if (LpSpLp(-x, y, -phi, t, u, v)) // timeflip
+    best.offer(RS_WORDS[14], -t, -u, -v);
+  if (LpSpLp(x, -y, -phi, t, u, v)) // reflect
+    best.offer(RS_WORDS[15], t, u, v);
+  if (LpSpLp(-x, -y, phi, t, u, v)) // timeflip + reflect
+    best.offer(RS_WORDS[15], -t, -u, -v);
+  if (LpSpRp(x, y, phi, t, u, v))
+    best.offer(RS_WORDS[12], t, u, v);
+  if (LpSpRp(-x, y, -phi, t, u, v))
+    best.offer(RS_WORDS[12], -t, -u, -v);
+  if (LpSpRp(x, -y, -phi, t, u, v))
+    best.offer(RS_WORDS[13], t, u, v);
+  if (LpSpRp(-x, -y, phi, t, u, v))
+    best.offer(RS_WORDS[13], -t, -u, -v);
+}
+
+void CCC(double x, double y, double phi, ShortestWord& best)
+{
+  double t, u, v;
+  if (LpRmL(x, y, phi, t, u, v))
+    best.offer(RS_WORDS[0], t, u, v);
+  if (LpRmL(-x, y, -phi, t, u, v))
+    best.offer(RS_WORDS[0], -t, -u, -v);
+  if (LpRmL(x, -y, -phi, t, u, v))
+    best.offer(RS_WORDS[1], t, u, v);
+  if (LpRmL(-x, -y, phi, t, u, v))
+    best.offer(RS_WORDS[1], -t, -u, -v);
+  
+  // backwards
+  double xb = x*std::cos(phi) + y*std::sin(phi);
+  double yb = x*std::sin(phi) - y*std::cos(phi);
+  if (LpRmL(xb, yb, phi, t, u, v))
+    best.offer(RS_WORDS[0], v, u, t);
+  if (LpRmL(-xb, yb, -phi, t, u, v))
+    best.offer(RS_WORDS[0], -v, -u, -t);
+  if (LpRmL(xb, -yb, -phi, t, u, v))
+    best.offer(RS_WORDS[1], v, u, t);
+  if (LpRmL(-xb, -yb, phi, t, u, v))
+    best.offer(RS_WORDS[1], -v, -u, -t);
+}
+
+void CCCC(double x, double y, double phi, ShortestWord& best)
+{
+  double t, u, v;
+  if (LpRupLumRm(x, y, phi, t, u, v))
+    best.offer(RS_WORDS[2], t, u, -u, v);
+  if (LpRupLumRm(-x, y, -phi, t, u, v))
+    best.offer(RS_WORDS[2], -t, -u, u, -v);
+  if (LpRupLumRm(x, -y, -phi, t, u, v))
+    best.offer(RS_WORDS[3], t, u, -u, v);
+  if (LpRupLumRm(-x, -y, phi, t, u, v))
+    best.offer(RS_WORDS[3], -t, -u, u, -v);
+  
+  if (LpRumLumRp(x, y, phi, t, u, v))
+    best.offer(RS_WORDS[2], t, u, u, v);
+  if (LpRumLumRp(-x, y, -phi, t, u, v))
+    best.offer(RS_WORDS[2], -t, -u, -u, -v);
+  if (LpRumLumRp(x, -y, -phi, t, u, v))
+    best.offer(RS_WORDS[3], t, u, u, v);
+  if (LpRumLumRp(-x, -y, phi, t, u, v))
+    best.offer(RS_WORDS[3], -t, -u, -u, -v);
+}
+
+void CCSC(double x, double y, double phi, ShortestWord& best)
+{
+  double t, u, v;
+  if (LpRmSmLm(x, y, phi, t, u, v))
+    best.offer(RS_WORDS[4], t, -.5*M_PI, u, v);
+  if (LpRmSmLm(-x, y, -phi, t, u, v))
+    best.offer(RS_WORDS[4], -t, .5*M_PI, -u, -v);
+  if (LpRmSmLm(x, -y, -phi, t, u, v))
+    best.offer(RS_WORDS[5], t, -.5*M_PI, u, v);
+  if (LpRmSmLm(-x, -y, phi, t, u, v))
+    best.offer(RS_WORDS[5], -t, .5*M_PI, -u, -v);
+  
+  if (LpRmSmRm(x, y, phi, t, u, v))
+    best.offer(RS_WORDS[8], t, -.5*M_PI, u, v);
+  if (LpRmSmRm(-x, y, -phi, t, u, v))
+    best.offer(RS_WORDS[8], -t, .5*M_PI, -u, -v);
+  if (LpRmSmRm(x, -y, -phi, t, u, v))
+    best.offer(RS_WORDS[9], t, -.5*M_PI, u, v);
+  if (LpRmSmRm(-x, -y, phi, t, u, v))
+    best.offer(RS_WORDS[9], -t, .5*M_PI, -u, -v);
+  
+  // backwards
+  double xb = x*std::cos(phi) + y*std::sin(phi);
+  double yb = x*std::sin(phi) - y*std::cos(phi);
+  if (LpRmSmLm(xb, yb, phi, t, u, v))
+    best.offer(RS_WORDS[6], v, u, -.5*M_PI, t);
+  if (LpRmSmLm(-xb, yb, -phi, t, u, v))
+    best.offer(RS_WORDS[6], -v, -u, .5*M_PI, -t);
+  if (LpRmSmLm(xb, -yb, -phi, t, u, v))
+    best.offer(RS_WORDS[7], v, u, -.5*M_PI, t);
+  if (LpRmSmLm(-xb, -yb, phi, t, u, v))
+    best.offer(RS_WORDS[7], -v, -u, .5*M_PI, -t);
+  
+  if (LpRmSmRm(xb, yb, phi, t, u, v))
+    best.offer(RS_WORDS[10], v, u, -.5*M_PI, t);
+  if (LpRmSmRm(-xb, yb, -phi, t, u, v))
+    best.offer(RS_WORDS[10], -v, -u, .5*M_PI, -t);
+  if (LpRmSmRm(xb, -yb, -phi, t, u, v))
+    best.offer(RS_WORDS[11], v, u, -.5*M_PI, t);
+  if (LpRmSmRm(-xb, -yb, phi, t, u, v))
+    best.offer(RS_WORDS[11], -v, -u, .5*M_PI, -t);
+}
+
+void CCSCC(double x, double y, double phi, ShortestWord& best)
+{
+  double t, u, v;
+  if (LpRmSLmRp(x, y, phi, t, u, v))
+    best.offer(RS_WORDS[16], t, -.5*M_PI, u, -.5*M_PI, v);
+  if (LpRmSLmRp(-x, y, -phi, t, u, v))
+    best.offer(RS_WORDS[16], -t, .5*M_PI, -u, .5*M_PI, -v);
+  if (LpRmSLmRp(x, -y, -phi, t, u, v))
+    best.offer(RS_WORDS[17], t, -.5*M_PI, u, -.5*M_PI, v);
+  if (LpRmSLmRp(-x, -y, phi, t, u, v))
+    best.offer(RS_WORDS[17], -t, .5*M_PI, -u, .5*M_PI, -v);
+}
+
+/**
+ * @brief Shortest Dubins word (forward motion only)
+ * @param d normalized distance between start and goal
+ * @param alpha start orientation w.r.t. the line from start to goal
+ * @param beta goal orientation w.r.t. the line from start to goal
+ */
+void Dubins(double d, double alpha, double beta, ShortestWord& best)
+{
+  static const Word LSL = {L, S, L, N, N};
+  static const Word RSR = {R, S, R, N, N};
+  static const Word LSR = {L, S, R, N, N};
+  static const Word RSL = {R, S, L, N, N};
+  static const Word RLR = {R, L, R, N, N};
+  static const Word LRL = {L, R, L, N, N};
+  
+  alpha = mod2piPositive(alpha);
+  beta = mod2piPositive(beta);
+  double sa = std::sin(alpha), sb = std::sin(beta);
+  double ca = std::cos(alpha), cb = std::cos(beta);
+  double c_ab = std::cos(alpha - beta);
+  
+  double p_sq = 2. + d*d - 2.*c_ab + 2.*d*(sa - sb);
+  if (p_sq >= 0)
+  {
+    double tmp = std::atan2(cb - ca, d + sa - sb);
+    best.offer(LSL, mod2piPositive(tmp - alpha), std::sqrt(p_sq), mod2piPositive(beta - tmp));
+  }
+  
+  p_sq = 2. + d*d - 2.*c_ab + 2.*d*(sb - sa);
+  if (p_sq >= 0)
+  {
+    double tmp = std::atan2(ca - cb, d - sa + sb);
+    best.offer(RSR, mod2piPositive(alpha - tmp), std::sqrt(p_sq), mod2piPositive(tmp - beta));
+  }
+  
+  p_sq = -2. + d*d + 2.*c_ab + 2.*d*(sa + sb);
+  if (p_sq >= 0)
+  {
+    double p = std::sqrt(p_sq);
+    double tmp = std::atan2(-ca - cb, d + sa + sb) - std::atan2(-2., p);
+    best.offer(LSR, mod2piPositive(tmp - alpha), p, mod2piPositive(tmp - beta));
+  }
+  
+  p_sq = -2. + d*d + 2.*c_ab - 2.*d*(sa + sb);
+  if (p_sq >= 0)
+  {
+    double p = std::sqrt(p_sq);
+    double tmp = std::atan2(ca + cb, d - sa - sb) - std::atan2(2., p);
+    best.offer(RSL, mod2piPositive(alpha - tmp), p, mod2piPositive(beta - tmp));
+  }
+  
+  double tmp = (6. - d*d + 2.*c_ab + 2.*d*(sa - sb)) / 8.;
+  if (std::abs(tmp) <= 1.)
+  {
+    double p = mod2piPositive(2.*M_PI - std::acos(tmp));
+    double t = mod2piPositive(alpha - std::atan2(ca - cb, d - sa + sb) + .5*p);
+    best.offer(RLR, t, p, mod2piPositive(alpha - beta - t + p));
+  }
+  
+  tmp = (6. - d*d + 2.*c_ab + 2.*d*(sb - sa)) / 8.;
+  if (std::abs(tmp) <= 1.)
+  {
+    double p = mod2piPositive(2.*M_PI - std::acos(tmp));
+    double t = mod2piPositive(-alpha - std::atan2(ca - cb, d + sa - sb) + .5*p);
+    best.offer(LRL, t, p, mod2piPositive(beta - alpha - t + p));
+  }
+}
+
+} // anonymous namespace
+
+
+ReedsSheppPath::ReedsSheppPath() : radius_(1), length_(0)
+{
+  for (int i=0; i < 5; ++i)
+  {
+    types_[i] = NOP;
+    lengths_[i] = 0;
+  }
+}
+
+bool ReedsSheppPath::compute(const PoseSE2& start, const PoseSE2& goal, double turning_radius, bool allow_backwards)
+{
+  if (turning_radius <= 0)
+    return false;
+  
+  start_ = start;
+  goal_ = goal;
+  radius_ = turning_radius;
+  
+  // goal w.r.t. the start frame, normalized by the turning radius
+  Eigen::Vector2d delta = (goal.position() - start.position()) / turning_radius;
+  double c = std::cos(start.theta());
+  double s = std::sin(start.theta());
+  double x = c*delta.x() + s*delta.y();
+  double y = -s*delta.x() + c*delta.y();
+  double phi = mod2pi(goal.theta() - start.theta());
+  
+  ShortestWord best;
+  if (allow_backwards)
+  {
+    CSC(x, y, phi, best);
+    CCC(x, y, phi, best);
+    CCCC(x, y, phi, best);
+    CCSC(x, y, phi, best);
+    CCSCC(x, y, phi, best);
+  }
+  else
+  {
+    double angle = std::atan2(delta.y(), delta.x());
+    Dubins(delta.norm(), start.theta() - angle, goal.theta() - angle, best);
+  }
+  
+  if (!best.word)
+    return false;
+  
+  for (int i=0; i < 5; ++i)
+  {
+    types_[i] = best.word[i];
+    lengths_[i] = best.lengths[i];
+  }
+  length_ = best.total;
+  return true;
+}
+
+int ReedsSheppPath::numberOfSegments() const
+{
+  int n = 0;
+  while (n < 5 && types_[n] != NOP)
+    ++n;
+  return n;
+}
+
+void ReedsSheppPath::applySegment(SegmentType type, double length, double& x, double& y, double& theta)
+{
+  switch (type)
+  {
+    case LEFT:
+      x += std::sin(theta + length) - std::sin(theta);
+      y += -std::cos(theta + length) + std::cos(theta);
+      theta += length;
+      break;
+    case RIGHT:
+      x += -std::sin(theta - length) + std::sin(theta);
+      y += std::cos(theta - length) - std::cos(theta);
+      theta -= length;
+      break;
+    case STRAIGHT:
+      x += length * std::cos(theta);
+      y += length * std::sin(theta);
+      break;
+    default:
+      break;
+  }
+}
+
+PoseSE2 ReedsSheppPath::interpolate(double s) const
+{
+  double remaining = std::max(0., std::min(s / radius_, length_));
+  double x = 0, y = 0, theta = start_.theta();
+  for (int i=0; i < 5 && types_[i] != NOP && remaining > 0; ++i)
+  {
+    double seg = std::min(std::abs(lengths_[i]), remaining);
+    remaining -= seg;
+    applySegment(types_[i], lengths_[i] < 0 ? -seg : seg, x, y, theta);
+  }
+  return PoseSE2(start_.x() + radius_*x, start_.y() + radius_*y, g2o::normalize_theta(theta));
+}
+
+void ReedsSheppPath::sample(double step_forward, double step_backward, PoseSE2Container& poses) const
+{
+  poses.push_back(start_);
+  
+  double x = 0, y = 0, theta = start_.theta();
+  for (int i=0; i < 5 && types_[i] != NOP; ++i)
+  {
+    double seg_length = std::abs(lengths_[i]) * radius_;
+    if (seg_length < 1e-6)
+      continue;
+    
+    double step = lengths_[i] < 0 ? step_backward : step_forward;
+    int no_steps = step > 0 ? std::max(1, (int) std::ceil(seg_length / step)) : 1;
+    double increment = lengths_[i] / (double) no_steps;
+    for (int k=0; k < no_steps; ++k)
+    {
+      applySegment(types_[i], increment, x, y, theta);
+      poses.push_back(PoseSE2(start_.x() + radius_*x, start_.y() + radius_*y, g2o::normalize_theta(theta)));
+    }
+  }
+  
+  // remove the accumulated numerical error
+  if (poses.size() > 1)
+    poses.back() = goal_;
+  else
+    poses.push_back(goal_);
+}
+
+} // namespace teb_local_planner
@@ -0,0 +1,217 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/replanning_monitor.h>
+#include <teb_local_planner/logging.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <cmath>
+#include <typeinfo>
+
+namespace teb_local_planner
+{
+
+namespace
+{
+
+//! Add a coordinate to a fingerprint (rounded to multiples of the resolution)
+inline void hashCoordinate(std::size_t& seed, double value, double resolution)
+{
+  if (resolution > 0)
+    boost::hash_combine(seed, std::llround(value / resolution));
+  else
+    boost::hash_combine(seed, value);
+}
+
+//! Add a 2d point to a fingerprint (rounded to multiples of the resolution)
+inline void hashPoint(std::size_t& seed, const Eigen::Vector2d& point, double resolution)
+{
+  hashCoordinate(seed, point.x(), resolution);
+  hashCoordinate(seed, point.y(), resolution);
+}
+
+} // anonymous namespace
+
+
+ReplanningMonitor::ReplanningMonitor() : cfg_(NULL), reference_valid_(false), obstacle_fingerprint_(0), via_point_fingerprint_(0),
+                                         no_refinements_(0), pending_obstacle_fingerprint_(0), pending_via_point_fingerprint_(0)
+{
+}
+
+void ReplanningMonitor::initialize(const TebConfig& cfg)
+{
+  cfg_ = &cfg;
+  reset();
+}
+
+void ReplanningMonitor::reset()
+{
+  reference_valid_ = false;
+  no_refinements_ = 0;
+}
+
+ReplanningDecision ReplanningMonitor::evaluate(const PlannerInterface& planner, const PoseSE2& robot_pose, const PoseSE2& goal,
+                                               const ObstContainer& obstacles, const ViaPointContainer* via_points)
+{
+  TEB_ASSERT_MSG(cfg_, "Call initialize() first.");
+  if (!cfg_->replanning.event_driven)
+    return ReplanningDecision::FullOptimization;
+  
+  // the fingerprints of the current cycle are stored in any case, they become the new reference after a full optimization
+  const double resolution = cfg_->replanning.change_resolution;
+  pending_obstacle_fingerprint_ = computeFingerprint(obstacles, resolution);
+  pending_via_point_fingerprint_ = via_points ? computeFingerprint(*via_points, resolution) : 0;
+  pending_goal_ = goal;
+  
+  if (!reference_valid_)
+    return ReplanningDecision::FullOptimization;
+  
+  if (cfg_->replanning.max_refinements > 0 && no_refinements_ >= cfg_->replanning.max_refinements)
+  {
+    TEB_DEBUG("ReplanningMonitor: maximum number of consecutive refinements reached.");
+    return ReplanningDecision::FullOptimization;
+  }
+  
+  if (pending_obstacle_fingerprint_ != obstacle_fingerprint_)
+  {
+    TEB_DEBUG("ReplanningMonitor: obstacles changed.");
+    return ReplanningDecision::FullOptimization;
+  }
+  
+  if (pending_via_point_fingerprint_ != via_point_fingerprint_)
+  {
+    TEB_DEBUG("ReplanningMonitor: via-points changed.");
+    return ReplanningDecision::FullOptimization;
+  }
+  
+  if ((goal.position() - goal_.position()).norm() > cfg_->replanning.goal_change_dist
+      || std::abs(g2o::normalize_theta(goal.theta() - goal_.theta())) > cfg_->replanning.goal_change_angle)
+  {
+    TEB_DEBUG("ReplanningMonitor: goal changed.");
+    return ReplanningDecision::FullOptimization;
+  }
+  
+  double dist, angle_diff;
+  if (!planner.computeTrackingError(robot_pose, dist, angle_diff))
+    return ReplanningDecision::FullOptimization;
+  
+  if (dist > cfg_->replanning.max_tracking_error_xy || angle_diff > cfg_->replanning.max_tracking_error_yaw)
+  {
+    TEB_DEBUG("ReplanningMonitor: robot deviates from the previous trajectory (dist: %f, angle: %f).", dist, angle_diff);
+    return ReplanningDecision::FullOptimization;
+  }
+  
+  return ReplanningDecision::Refinement;
+}
+
+void ReplanningMonitor::notifyPlanned(ReplanningDecision decision, bool success)
+{
+  if (!success)
+  {
+    reset();
+    return;
+  }
+  
+  if (decision == ReplanningDecision::Refinement)
+  {
+    ++no_refinements_;
+    return;
+  }
+  
+  // evaluate() has not been called, hence there is no pending reference problem
+  if (decision == ReplanningDecision::Speculative)
+    return;
+  
+  // a successful full optimization defines the new reference problem
+  reference_valid_ = cfg_ && cfg_->replanning.event_driven;
+  obstacle_fingerprint_ = pending_obstacle_fingerprint_;
+  via_point_fingerprint_ = pending_via_point_fingerprint_;
+  goal_ = pending_goal_;
+  no_refinements_ = 0;
+}
+
+std::size_t ReplanningMonitor::computeFingerprint(const ObstContainer& obstacles, double resolution)
+{
+  std::size_t seed = obstacles.size();
+  for (const ObstaclePtr& obst : obstacles)
+  {
+    boost::hash_combine(seed, typeid(*obst).hash_code());
+    
+    if (const PointObstacle* pobst = dynamic_cast<const PointObstacle*>(obst.get()))
+      hashPoint(seed, pobst->position(), resolution);
+    else if (const CircularObstacle* cobst = dynamic_cast<const CircularObstacle*>(obst.get()))
+    {
+      hashPoint(seed, cobst->position(), resolution);
+      hashCoordinate(seed, cobst->radius(), resolution);
+    }
+    else if (const LineObstacle* lobst = dynamic_cast<const LineObstacle*>(obst.get()))
+    {
+      hashPoint(seed, lobst->start(), resolution);
+      hashPoint(seed, lobst->end(), resolution);
+    }
+    else if (const PolygonObstacle* polyobst = dynamic_cast<const PolygonObstacle*>(obst.get()))
+    {
+      boost::hash_combine(seed, polyobst->vertices().size());
+      for (const Eigen::Vector2d& vertex : polyobst->vertices())
+        hashPoint(seed, vertex, resolution);
+    }
+    else // unknown obstacle type
+    {
+      Point2dContainer polygon;
+      obst->toPolygon(polygon);
+      for (const Eigen::Vector2d& vertex : polygon)
+        hashPoint(seed, vertex, resolution);
+    }
+    
+    boost::hash_combine(seed, obst->isDynamic());
+    if (obst->isDynamic())
+      hashPoint(seed, obst->getCentroidVelocity(), resolution);
+  }
+  return seed;
+}
+
+std::size_t ReplanningMonitor::computeFingerprint(const ViaPointContainer& via_points, double resolution)
+{
+  std::size_t seed = via_points.size();
+  for (const Eigen::Vector2d& via_point : via_points)
+    hashPoint(seed, via_point, resolution);
+  return seed;
+}
+
+} // namespace teb_local_planner
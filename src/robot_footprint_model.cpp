@@ -0,0 +1,313 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/robot_footprint_model.h>
+#include <teb_local_planner/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace teb_local_planner
+{
+
+namespace
+{
+
+//! Maximum number of grid cells per axis used for the circle decomposition
+const int kMaxGridCells = 160;
+//! Number of grid cells per over-approximation (finer grids waste less of the over-approximation on the cell size)
+const double kGridSubdivision = 4;
+
+/**
+ * @brief Check whether a point lies inside a closed polygon (crossing number test)
+ */
+bool isInsidePolygon(const Eigen::Vector2d& point, const Point2dContainer& vertices)
+{
+  bool inside = false;
+  for (std::size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++)
+  {
+    const Eigen::Vector2d& a = vertices[i];
+    const Eigen::Vector2d& b = vertices[j];
+    if ((a.y() > point.y()) != (b.y() > point.y())
+        && point.x() < (b.x() - a.x()) * (point.y() - a.y()) / (b.y() - a.y()) + a.x())
+      inside = !inside;
+  }
+  return inside;
+}
+
+//! Result of coverPolygon()
+enum CoverResult
+{
+  PolygonCovered, //!< The polygon is covered with at most max_circles circles
+  GridLimitExceeded, //!< The over-approximation is too small w.r.t. the size of the footprint (see kMaxGridCells)
+  NotCoverable, //!< Some cells cannot be covered with the over-approximation (e.g. degenerated polygon)
+  TooManyCircles //!< More than max_circles circles are required
+};
+
+/**
+ * @brief Cover the polygon with at most \c max_circles circles using the over-approximation \c max_error
+ * 
+ * The polygon is rasterized with cells of size \f$ h = e / 4 \f$. A candidate center \f$ c \f$ inside the polygon
+ * with distance \f$ d(c) \f$ to the boundary covers a cell completely if the farthest corner of the cell is not farther
+ * than \f$ d(c) + e \f$ from \f$ c \f$. All cells that might intersect the polygon are covered greedily.
+ * @return PolygonCovered if the polygon is covered, otherwise the reason of the failure
+ */
+CoverResult coverPolygon(const Point2dContainer& vertices, double max_error, int max_circles, MultiCirclesRobotFootprint::CircleContainer& circles)
+{
+  Eigen::Vector2d min_corner = vertices.front();
+  Eigen::Vector2d max_corner = vertices.front();
+  for (const Eigen::Vector2d& vertex : vertices)
+  {
+    min_corner = min_corner.cwiseMin(vertex);
+    max_corner = max_corner.cwiseMax(vertex);
+  }
+  
+  double h = max_error / kGridSubdivision;
+  int nx = (int) std::ceil((max_corner.x() - min_corner.x()) / h) + 2;
+  int ny = (int) std::ceil((max_corner.y() - min_corner.y()) / h) + 2;
+  if (nx > kMaxGridCells || ny > kMaxGridCells)
+    return GridLimitExceeded;
+  double half_diagonal = h * M_SQRT1_2;
+  
+  // cells that might intersect the polygon and candidate centers inside the polygon (with their distance to the boundary)
+  Point2dContainer cells;
+  std::vector<int> cell_index(nx * ny, -1); // grid position -> index of the cell (or -1)
+  std::vector<int> centers; // grid positions of the candidate centers
+  std::vector<double> center_dist;
+  for (int ix = 0; ix < nx; ++ix)
+  {
+    for (int iy = 0; iy < ny; ++iy)
+    {
+      Eigen::Vector2d point(min_corner.x() + (ix - 0.5) * h, min_corner.y() + (iy - 0.5) * h);
+      double dist = distance_point_to_polygon_2d(point, vertices);
+      bool inside = isInsidePolygon(point, vertices);
+      if (inside || dist <= half_diagonal)
+      {
+        cell_index[ix * ny + iy] = (int) cells.size();
+        cells.push_back(point);
+      }
+      if (inside && dist > 0)
+      {
+        centers.push_back(ix * ny + iy);
+        center_dist.push_back(dist);
+      }
+    }
+  }
+  if (centers.empty())
+    return NotCoverable;
+  
+  // visit all cells in reach of a candidate center
+  auto forEachCellInReach = [&](std::size_t candidate, const std::function<void (int)>& fun)
+  {
+    int cx = centers[candidate] / ny;
+    int cy = centers[candidate] % ny;
+    double reach = (center_dist[candidate] + max_error) / h; // in cells
+    int window = (int) std::floor(reach - 0.5);
+    for (int ix = std::max(cx - window, 0); ix <= std::min(cx + window, nx - 1); ++ix)
+    {
+      for (int iy = std::max(cy - window, 0); iy <= std::min(cy + window, ny - 1); ++iy)
+      {
+        // the farthest corner of the cell must be in reach
+        double dx = std::abs(ix - cx) + 0.5;
+        double dy = std::abs(iy - cy) + 0.5;
+        int k = cell_index[ix * ny + iy];
+        if (k >= 0 && dx * dx + dy * dy <= reach * reach)
+          fun(k);
+      }
+    }
+  };
+  
+  // cells that can be covered by only a few candidates (e.g. acute corners) are weighted higher,
+  // otherwise the greedy selection prefers large circles and needs many small ones for the remaining boundary
+  std::vector<double> weight(cells.size(), 0);
+  for (std::size_t c = 0; c < centers.size(); ++c)
+    forEachCellInReach(c, [&weight](int k) {weight[k] += 1;});
+  for (std::size_t k = 0; k < cells.size(); ++k)
+  {
+    if (weight[k] == 0)
+      return NotCoverable; // the cell cannot be covered with this over-approximation
+    weight[k] = 1.0 / weight[k];
+  }
+  
+  // greedy set cover: select the center that covers most of the (weighted) remaining cells.
+  // The score of a candidate can only decrease, hence the score of a previous iteration is an upper bound
+  // and candidates whose bound is not better than the current best are skipped.
+  std::vector<bool> covered(cells.size(), false);
+  std::vector<double> bound(centers.size(), HUGE_VAL);
+  std::size_t no_uncovered = cells.size();
+  std::vector<std::size_t> selected;
+  std::vector<std::size_t> order(centers.size());
+  while (no_uncovered > 0)
+  {
+    for (std::size_t c = 0; c < order.size(); ++c)
+      order[c] = c;
+    std::sort(order.begin(), order.end(), [&bound](std::size_t a, std::size_t b) {return bound[a] > bound[b];});
+    
+    std::size_t best = order.front();
+    double best_score = 0;
+    for (std::size_t c : order)
+    {
+      if (bound[c] <= best_score)
+        break;
+      double score = 0;
+      forEachCellInReach(c, [&](int k) {if (!covered[k]) score += weight[k];});
+      bound[c] = score;
+      if (score > best_score)
+      {
+        best_score = score;
+        best = c;
+      }
+    }
+    
+    forEachCellInReach(best, [&](int k) {if (!covered[k]) {covered[k] = true; --no_uncovered;}});
+    selected.push_back(best);
+  }
+  
+  // remove redundant circles (in reverse order of selection, since the first ones are the largest)
+  std::vector<int> multiplicity(cells.size(), 0);
+  for (std::size_t center : selected)
+    forEachCellInReach(center, [&multiplicity](int k) {++multiplicity[k];});
+  for (int i = (int) selected.size() - 1; i >= 0; --i)
+  {
+    bool redundant = true;
+    forEachCellInReach(selected[i], [&](int k) {if (multiplicity[k] < 2) redundant = false;});
+    if (redundant)
+    {
+      forEachCellInReach(selected[i], [&multiplicity](int k) {--multiplicity[k];});
+      selected.erase(selected.begin() + i);
+    }
+  }
+  if ((int) selected.size() > max_circles)
+    return TooManyCircles;
+  
+  // assign each cell to the first circle that covers it and shrink each circle to its cells
+  std::vector<int> owner(cells.size(), -1);
+  circles.clear();
+  for (std::size_t i = 0; i < selected.size(); ++i)
+  {
+    int cx = centers[selected[i]] / ny;
+    int cy = centers[selected[i]] % ny;
+    circles.push_back(MultiCirclesRobotFootprint::Circle(Eigen::Vector2d(min_corner.x() + (cx - 0.5) * h, min_corner.y() + (cy - 0.5) * h), 0));
+    forEachCellInReach(selected[i], [&owner, i](int k) {if (owner[k] < 0) owner[k] = (int) i;});
+  }
+  for (std::size_t k = 0; k < cells.size(); ++k)
+  {
+    MultiCirclesRobotFootprint::Circle& circle = circles[owner[k]];
+    Eigen::Vector2d farthest_corner = (cells[k] - circle.center).cwiseAbs() + Eigen::Vector2d(h/2, h/2);
+    circle.radius = std::max(circle.radius, farthest_corner.norm());
+  }
+  return PolygonCovered;
+}
+  
+} // anonymous namespace
+
+
+bool MultiCirclesRobotFootprint::approximatePolygon(const Point2dContainer& vertices, double max_over_approximation, int max_circles)
+{
+  circles_.clear();
+  approximation_error_ = 0;
+  inscribed_radius_ = 0;
+  
+  if (vertices.size() < 3 || max_over_approximation <= 0 || max_circles < 1)
+  {
+    TEB_WARN("MultiCirclesRobotFootprint: a polygon with at least 3 vertices, a positive over-approximation and at least one circle are required.");
+    // conservative fallback: a single circle around the robot center that contains all vertices
+    double radius = 0;
+    for (const Eigen::Vector2d& vertex : vertices)
+      radius = std::max(radius, vertex.norm());
+    circles_.push_back(Circle(Eigen::Vector2d::Zero(), radius));
+    approximation_error_ = radius;
+    return false;
+  }
+  
+  // inscribed radius of the polygon (w.r.t. the robot center)
+  inscribed_radius_ = std::numeric_limits<double>::max();
+  for (std::size_t i = 0; i < vertices.size(); ++i)
+  {
+    inscribed_radius_ = std::min(inscribed_radius_, vertices[i].norm());
+    inscribed_radius_ = std::min(inscribed_radius_, distance_point_to_segment_2d(Eigen::Vector2d::Zero(), vertices[i], vertices[(i+1) % vertices.size()]));
+  }
+  
+  // increase the over-approximation until the number of circles (and the grid size) suffices
+  double max_error = max_over_approximation;
+  int attempts = 0;
+  bool grid_limit_exceeded = false;
+  bool too_many_circles = false;
+  bool not_coverable = false;
+  CoverResult result;
+  while ((result = coverPolygon(vertices, max_error, max_circles, circles_)) != PolygonCovered)
+  {
+    grid_limit_exceeded |= result == GridLimitExceeded;
+    too_many_circles |= result == TooManyCircles;
+    not_coverable |= result == NotCoverable;
+    max_error *= 1.25;
+    if (++attempts > 50) // degenerated polygon (e.g. all vertices on a line)
+    {
+      TEB_WARN("MultiCirclesRobotFootprint: the polygon cannot be covered by circles.");
+      double radius = 0;
+      for (const Eigen::Vector2d& vertex : vertices)
+        radius = std::max(radius, vertex.norm());
+      circles_.assign(1, Circle(Eigen::Vector2d::Zero(), radius));
+      approximation_error_ = radius;
+      return false;
+    }
+  }
+  
+  // each circle is contained in the polygon grown by (radius - distance of its center to the boundary)
+  for (const Circle& circle : circles_)
+    approximation_error_ = std::max(approximation_error_, circle.radius - distance_point_to_polygon_2d(circle.center, vertices));
+  
+  if (max_error > max_over_approximation)
+  {
+    if (grid_limit_exceeded)
+      TEB_WARN("MultiCirclesRobotFootprint: an over-approximation of %.3fm is too small w.r.t. the footprint size (the decomposition grid is limited to %d cells per axis), it has been increased to %.3fm.",
+               max_over_approximation, kMaxGridCells, approximation_error_);
+    if (too_many_circles)
+      TEB_WARN("MultiCirclesRobotFootprint: %d circles do not suffice for an over-approximation of %.3fm, it has been increased to %.3fm.",
+               max_circles, max_over_approximation, approximation_error_);
+    if (not_coverable)
+      TEB_WARN("MultiCirclesRobotFootprint: the polygon cannot be covered with an over-approximation of %.3fm, it has been increased to %.3fm.",
+               max_over_approximation, approximation_error_);
+    return false;
+  }
+  return true;
+}
+
+} // namespace teb_local_planner
@@ -0,0 +1,182 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/ros_adapter.h>
+
+#include <ros/ros.h>
+#include <boost/make_shared.hpp>
+
+namespace teb_local_planner
+{
+
+void RosLogger::log(Level level, const char* file, int line, const char* message)
+{
+  switch (level)
+  {
+    case Debug:
+      ROS_DEBUG("%s", message);
+      break;
+    case Info:
+      ROS_INFO("%s", message);
+      break;
+    case Warn:
+      ROS_WARN("%s", message);
+      break;
+    case Error:
+      ROS_ERROR("%s", message);
+      break;
+    default:
+      ROS_FATAL("%s (%s:%d)", message, file, line);
+      break;
+  }
+}
+
+double RosClock::now() const
+{
+  return ros::Time::now().toSec();
+}
+
+void initRosAdapter()
+{
+  setLogger(boost::make_shared<RosLogger>());
+  setClock(boost::make_shared<RosClock>());
+}
+
+
+PoseSE2 poseFromMsg(const geometry_msgs::Pose& pose)
+{
+  return PoseSE2(pose.position.x, pose.position.y, tf::getYaw(pose.orientation));
+}
+
+PoseSE2 poseFromTf(const tf::Pose& pose)
+{
+  return PoseSE2(pose.getOrigin().getX(), pose.getOrigin().getY(), tf::getYaw(pose.getRotation()));
+}
+
+void poseToMsg(const PoseSE2& pose, geometry_msgs::Pose& pose_msg)
+{
+  pose_msg.position.x = pose.x();
+  pose_msg.position.y = pose.y();
+  pose_msg.position.z = 0;
+  pose_msg.orientation = tf::createQuaternionMsgFromYaw(pose.theta());
+}
+
+void planFromMsg(const std::vector<geometry_msgs::PoseStamped>& plan, PoseSE2Container& poses)
+{
+  poses.resize(plan.size());
+  for (std::size_t i=0; i<plan.size(); ++i)
+    poses[i] = poseFromMsg(plan[i].pose);
+}
+
+Twist2D twistFromMsg(const geometry_msgs::Twist& twist)
+{
+  return Twist2D(twist.linear.x, twist.linear.y, twist.angular.z);
+}
+
+void twistToMsg(const Twist2D& twist, geometry_msgs::Twist& twist_msg)
+{
+  twist_msg.linear.x = twist.vx;
+  twist_msg.linear.y = twist.vy;
+  twist_msg.linear.z = 0;
+  twist_msg.angular.x = twist_msg.angular.y = 0;
+  twist_msg.angular.z = twist.omega;
+}
+
+void trajectoryToMsg(const TrajectoryPointContainer& trajectory, std::vector<TrajectoryPointMsg>& trajectory_msg)
+{
+  trajectory_msg.resize(trajectory.size());
+  for (std::size_t i=0; i<trajectory.size(); ++i)
+  {
+    poseToMsg(trajectory[i].pose, trajectory_msg[i].pose);
+    twistToMsg(trajectory[i].velocity, trajectory_msg[i].velocity);
+    twistToMsg(trajectory[i].acceleration, trajectory_msg[i].acceleration);
+    trajectory_msg[i].time_from_start.fromSec(trajectory[i].time_from_start);
+  }
+}
+
+void obstacleToPolygonMsg(const Obstacle& obstacle, geometry_msgs::Polygon& polygon)
+{
+  Point2dContainer vertices;
+  obstacle.toPolygon(vertices);
+  polygon.points.resize(vertices.size());
+  for (std::size_t i=0; i<vertices.size(); ++i)
+  {
+    polygon.points[i].x = vertices[i].x();
+    polygon.points[i].y = vertices[i].y();
+    polygon.points[i].z = 0;
+  }
+}
+
+void obstacleToTwistWithCovarianceMsg(const Obstacle& obstacle, geometry_msgs::TwistWithCovariance& twist_with_covariance)
+{
+  if (obstacle.isDynamic())
+  {
+    twist_with_covariance.twist.linear.x = obstacle.getCentroidVelocity().x();
+    twist_with_covariance.twist.linear.y = obstacle.getCentroidVelocity().y();
+  }
+  else
+  {
+    twist_with_covariance.twist.linear.x = 0;
+    twist_with_covariance.twist.linear.y = 0;
+  }
+
+  // TODO:Covariance
+}
+
+void setObstacleVelocityFromMsg(Obstacle& obstacle, const geometry_msgs::TwistWithCovariance& velocity, const geometry_msgs::Quaternion& orientation)
+{
+  // Set velocity, if obstacle is moving
+  Eigen::Vector2d vel;
+  vel.coeffRef(0) = velocity.twist.linear.x;
+  vel.coeffRef(1) = velocity.twist.linear.y;
+
+  // If norm of velocity is less than 0.001, consider obstacle as not dynamic
+  // TODO: Get rid of constant
+  if (vel.norm() < 0.001)
+    return;
+
+  // currently velocity published by stage is already given in the map frame
+//    double yaw = tf::getYaw(orientation);
+//    ROS_INFO("Yaw: %f", yaw);
+//    Eigen::Rotation2Dd rot(yaw);
+//    vel = rot * vel;
+  obstacle.setCentroidVelocity(vel);
+}
+
+
+} // namespace teb_local_planner
@@ -0,0 +1,151 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/speculative_planner.h>
+#include <teb_local_planner/replanning_monitor.h>
+#include <teb_local_planner/logging.h>
+
+#include <boost/bind.hpp>
+
+#include <cmath>
+
+namespace teb_local_planner
+{
+
+SpeculativePlanner::SpeculativePlanner() : cfg_(NULL), config_mutex_(NULL), via_point_mutex_(NULL), pending_(false), success_(false),
+                                           free_goal_vel_(false), obstacle_fingerprint_(0)
+{
+}
+
+SpeculativePlanner::~SpeculativePlanner()
+{
+  wait();
+}
+
+void SpeculativePlanner::initialize(const TebConfig& cfg, const PlannerInterfacePtr& planner, boost::mutex* config_mutex,
+                                    boost::mutex* via_point_mutex)
+{
+  reset();
+  cfg_ = &cfg;
+  planner_ = planner;
+  config_mutex_ = config_mutex;
+  via_point_mutex_ = via_point_mutex;
+}
+
+bool SpeculativePlanner::start(const PoseSE2Container& initial_plan, double lookahead, const ObstContainer& obstacles, bool free_goal_vel)
+{
+  reset();
+  
+  if (!cfg_ || !planner_ || !cfg_->replanning.speculative || initial_plan.size() < 2)
+    return false;
+  
+  PoseSE2 predicted_pose;
+  if (!planner_->predictState(lookahead, predicted_pose, start_vel_))
+    return false;
+  
+  plan_ = initial_plan;
+  plan_.front() = predicted_pose;
+  free_goal_vel_ = free_goal_vel;
+  obstacle_fingerprint_ = ReplanningMonitor::computeFingerprint(obstacles, cfg_->replanning.change_resolution);
+  
+  success_ = false;
+  pending_ = true;
+  worker_ = boost::thread(boost::bind(&SpeculativePlanner::run, this));
+  return true;
+}
+
+void SpeculativePlanner::run()
+{
+  // Lock order: via-points before config. The control cycle (e.g. TebLocalPlannerROS::computeVelocityCommands())
+  // locks both in the same order, any other order might deadlock against it.
+  boost::unique_lock<boost::mutex> via_point_lock;
+  if (via_point_mutex_)
+    via_point_lock = boost::unique_lock<boost::mutex>(*via_point_mutex_);
+  boost::unique_lock<boost::mutex> cfg_lock;
+  if (config_mutex_)
+  {
+    TEB_ASSERT_MSG(!via_point_mutex_ || via_point_lock.owns_lock(), "SpeculativePlanner: lock the via-points before the config.");
+    cfg_lock = boost::unique_lock<boost::mutex>(*config_mutex_);
+  }
+  
+  success_ = planner_->plan(plan_, &start_vel_, free_goal_vel_);
+}
+
+void SpeculativePlanner::wait()
+{
+  if (worker_.joinable())
+    worker_.join();
+}
+
+void SpeculativePlanner::reset()
+{
+  wait();
+  pending_ = false;
+}
+
+bool SpeculativePlanner::accept(const PoseSE2& robot_pose, const PoseSE2& goal, const ObstContainer& obstacles)
+{
+  if (!pending_)
+    return false;
+  
+  wait();
+  pending_ = false;
+  
+  if (!success_)
+  {
+    planner_->clearPlanner(); // do not warm-start from a failed optimization
+    return false;
+  }
+  
+  // the robot must have reached the predicted start state
+  const PoseSE2& start = plan_.front();
+  if ((robot_pose.position() - start.position()).norm() > cfg_->replanning.speculation_tolerance_xy
+      || std::abs(g2o::normalize_theta(robot_pose.theta() - start.theta())) > cfg_->replanning.speculation_tolerance_yaw)
+    return false;
+  
+  // the local goal must not move
+  const PoseSE2& speculative_goal = plan_.back();
+  if ((goal.position() - speculative_goal.position()).norm() > cfg_->replanning.goal_change_dist
+      || std::abs(g2o::normalize_theta(goal.theta() - speculative_goal.theta())) > cfg_->replanning.goal_change_angle)
+    return false;
+  
+  // the worker optimized w.r.t. the obstacles of the previous cycle
+  return ReplanningMonitor::computeFingerprint(obstacles, cfg_->replanning.change_resolution) == obstacle_fingerprint_;
+}
+
+} // namespace teb_local_planner
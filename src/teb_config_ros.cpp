@@ -0,0 +1,368 @@
+/*********************************************************************
+ *
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2016,
+ *  TU Dortmund - Institute of Control Theory and Systems Engineering.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the institute nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Author: Christoph Rösmann
+ *********************************************************************/
+
+#include <teb_local_planner/teb_config.h>
+
+#include <ros/ros.h>
+#include <teb_local_planner/TebLocalPlannerReconfigureConfig.h>
+
+namespace teb_local_planner
+{
+    
+void TebConfig::loadRosParamFromNodeHandle(const ros::NodeHandle& nh)
+{
+    
+  nh.param("odom_topic", odom_topic, odom_topic);
+  nh.param("map_frame", map_frame, map_frame);
+  
+  // Trajectory
+  nh.param("teb_autosize", trajectory.teb_autosize, trajectory.teb_autosize);
+  nh.param("dt_ref", trajectory.dt_ref, trajectory.dt_ref);
+  nh.param("dt_hysteresis", trajectory.dt_hysteresis, trajectory.dt_hysteresis);
+  nh.param("min_samples", trajectory.min_samples, trajectory.min_samples);
+  nh.param("max_samples", trajectory.max_samples, trajectory.max_samples);
+  nh.param("global_plan_overwrite_orientation", trajectory.global_plan_overwrite_orientation, trajectory.global_plan_overwrite_orientation);
+  nh.param("allow_init_with_backwards_motion", trajectory.allow_init_with_backwards_motion, trajectory.allow_init_with_backwards_motion);
+  nh.param("carlike_path_init", trajectory.carlike_path_init, trajectory.carlike_path_init);
+  nh.param("feasible_time_init", trajectory.feasible_time_init, trajectory.feasible_time_init);
+  nh.getParam("global_plan_via_point_sep", trajectory.global_plan_viapoint_sep); // deprecated, see checkDeprecated()
+  if (!nh.param("global_plan_viapoint_sep", trajectory.global_plan_viapoint_sep, trajectory.global_plan_viapoint_sep))
+    nh.setParam("global_plan_viapoint_sep", trajectory.global_plan_viapoint_sep); // write deprecated value to param server
+  nh.param("via_points_ordered", trajectory.via_points_ordered, trajectory.via_points_ordered);
+  nh.param("max_global_plan_lookahead_dist", trajectory.max_global_plan_lookahead_dist, trajectory.max_global_plan_lookahead_dist);
+  nh.param("global_plan_prune_distance", trajectory.global_plan_prune_distance, trajectory.global_plan_prune_distance);
+  nh.param("exact_arc_length", trajectory.exact_arc_length, trajectory.exact_arc_length);
+  nh.param("force_reinit_new_goal_dist", trajectory.force_reinit_new_goal_dist, trajectory.force_reinit_new_goal_dist);
+  nh.param("feasibility_check_no_poses", trajectory.feasibility_check_no_poses, trajectory.feasibility_check_no_poses);
+  nh.param("publish_feedback", trajectory.publish_feedback, trajectory.publish_feedback);
+  nh.param("min_resolution_collision_check_angular", trajectory.min_resolution_collision_check_angular, trajectory.min_resolution_collision_check_angular);
+  nh.param("preallocate_memory", trajectory.preallocate_memory, trajectory.preallocate_memory);
+  
+  // Robot
+  nh.param("max_vel_x", robot.max_vel_x, robot.max_vel_x);
+  nh.param("max_vel_x_backwards", robot.max_vel_x_backwards, robot.max_vel_x_backwards);
+  nh.param("max_vel_y", robot.max_vel_y, robot.max_vel_y);
+  nh.param("max_vel_theta", robot.max_vel_theta, robot.max_vel_theta);
+  nh.param("acc_lim_x", robot.acc_lim_x, robot.acc_lim_x);
+  nh.param("acc_lim_y", robot.acc_lim_y, robot.acc_lim_y);
+  nh.param("acc_lim_theta", robot.acc_lim_theta, robot.acc_lim_theta);
+  nh.param("min_turning_radius", robot.min_turning_radius, robot.min_turning_radius);
+  nh.param("wheelbase", robot.wheelbase, robot.wheelbase);
+  nh.param("cmd_angle_instead_rotvel", robot.cmd_angle_instead_rotvel, robot.cmd_angle_instead_rotvel);
+  nh.param("is_footprint_dynamic", robot.is_footprint_dynamic, robot.is_footprint_dynamic);
+  
+  // GoalTolerance
+  nh.param("xy_goal_tolerance", goal_tolerance.xy_goal_tolerance, goal_tolerance.xy_goal_tolerance);
+  nh.param("yaw_goal_tolerance", goal_tolerance.yaw_goal_tolerance, goal_tolerance.yaw_goal_tolerance);
+  nh.param("free_goal_vel", goal_tolerance.free_goal_vel, goal_tolerance.free_goal_vel);
+  nh.param("complete_global_plan", goal_tolerance.complete_global_plan, goal_tolerance.complete_global_plan);
+
+  // Obstacles
+  nh.param("min_obstacle_dist", obstacles.min_obstacle_dist, obstacles.min_obstacle_dist);
+  nh.param("inflation_dist", obstacles.inflation_dist, obstacles.inflation_dist);
+  nh.param("dynamic_obstacle_inflation_dist", obstacles.dynamic_obstacle_inflation_dist, obstacles.dynamic_obstacle_inflation_dist);
+  nh.param("include_dynamic_obstacles", obstacles.include_dynamic_obstacles, obstacles.include_dynamic_obstacles);
+  nh.param("include_costmap_obstacles", obstacles.include_costmap_obstacles, obstacles.include_costmap_obstacles);
+  nh.param("costmap_obstacles_behind_robot_dist", obstacles.costmap_obstacles_behind_robot_dist, obstacles.costmap_obstacles_behind_robot_dist);
+  nh.param("obstacle_poses_affected", obstacles.obstacle_poses_affected, obstacles.obstacle_poses_affected);
+  nh.param("legacy_obstacle_association", obstacles.legacy_obstacle_association, obstacles.legacy_obstacle_association);
+  nh.param("obstacle_association_force_inclusion_factor", obstacles.obstacle_association_force_inclusion_factor, obstacles.obstacle_association_force_inclusion_factor);
+  nh.param("obstacle_association_cutoff_factor", obstacles.obstacle_association_cutoff_factor, obstacles.obstacle_association_cutoff_factor);
+  nh.param("costmap_converter_plugin", obstacles.costmap_converter_plugin, obstacles.costmap_converter_plugin);
+  nh.param("costmap_converter_spin_thread", obstacles.costmap_converter_spin_thread, obstacles.costmap_converter_spin_thread);
+  nh.param("polygon_simplification_tolerance", obstacles.polygon_simplification_tolerance, obstacles.polygon_simplification_tolerance);
+  nh.param("point_obstacle_merge_dist", obstacles.point_obstacle_merge_dist, obstacles.point_obstacle_merge_dist);
+  nh.param("corridor_prefilter", obstacles.corridor_prefilter, obstacles.corridor_prefilter);
+  nh.param("corridor_prefilter_slack", obstacles.corridor_prefilter_slack, obstacles.corridor_prefilter_slack);
+  
+  // Optimization
+  nh.param("no_inner_iterations", optim.no_inner_iterations, optim.no_inner_iterations);
+  nh.param("no_outer_iterations", optim.no_outer_iterations, optim.no_outer_iterations);
+  nh.param("optimization_activate", optim.optimization_activate, optim.optimization_activate);
+  nh.param("optimization_verbose", optim.optimization_verbose, optim.optimization_verbose);
+  nh.param("penalty_epsilon", optim.penalty_epsilon, optim.penalty_epsilon);
+  nh.param("weight_max_vel_x", optim.weight_max_vel_x, optim.weight_max_vel_x);
+  nh.param("weight_max_vel_y", optim.weight_max_vel_y, optim.weight_max_vel_y);
+  nh.param("weight_max_vel_theta", optim.weight_max_vel_theta, optim.weight_max_vel_theta);
+  nh.param("weight_acc_lim_x", optim.weight_acc_lim_x, optim.weight_acc_lim_x);
+  nh.param("weight_acc_lim_y", optim.weight_acc_lim_y, optim.weight_acc_lim_y);
+  nh.param("weight_acc_lim_theta", optim.weight_acc_lim_theta, optim.weight_acc_lim_theta);
+  nh.param("weight_kinematics_nh", optim.weight_kinematics_nh, optim.weight_kinematics_nh);
+  nh.param("weight_kinematics_forward_drive", optim.weight_kinematics_forward_drive, optim.weight_kinematics_forward_drive);
+  nh.param("weight_kinematics_turning_radius", optim.weight_kinematics_turning_radius, optim.weight_kinematics_turning_radius);
+  nh.param("weight_optimaltime", optim.weight_optimaltime, optim.weight_optimaltime);
+  nh.param("weight_shortest_path", optim.weight_shortest_path, optim.weight_shortest_path);
+  nh.param("weight_obstacle", optim.weight_obstacle, optim.weight_obstacle);
+  nh.param("weight_inflation", optim.weight_inflation, optim.weight_inflation);
+  nh.param("weight_dynamic_obstacle", optim.weight_dynamic_obstacle, optim.weight_dynamic_obstacle);    
+  nh.param("weight_dynamic_obstacle_inflation", optim.weight_dynamic_obstacle_inflation, optim.weight_dynamic_obstacle_inflation);
+  nh.param("weight_viapoint", optim.weight_viapoint, optim.weight_viapoint);
+  nh.param("weight_prefer_rotdir", optim.weight_prefer_rotdir, optim.weight_prefer_rotdir);
+  nh.param("weight_adapt_factor", optim.weight_adapt_factor, optim.weight_adapt_factor);
+  nh.param("obstacle_cost_exponent", optim.obstacle_cost_exponent, optim.obstacle_cost_exponent);
+  nh.param("fuse_consecutive_pose_edges", optim.fuse_consecutive_pose_edges, optim.fuse_consecutive_pose_edges);
+  nh.param("batch_edge_linearization", optim.batch_edge_linearization, optim.batch_edge_linearization);
+  nh.param("telemetry_buffer_size", optim.telemetry_buffer_size, optim.telemetry_buffer_size);
+  nh.param("multi_start_candidates", optim.multi_start_candidates, optim.multi_start_candidates);
+  nh.param("multi_start_lateral_offset", optim.multi_start_lateral_offset, optim.multi_start_lateral_offset);
+  nh.param("multi_start_selection_hysteresis", optim.multi_start_selection_hysteresis, optim.multi_start_selection_hysteresis);
+  nh.param("horizon_partitions", optim.horizon_partitions, optim.horizon_partitions);
+  nh.param("horizon_partition_min_poses", optim.horizon_partition_min_poses, optim.horizon_partition_min_poses);
+  nh.param("reuse_symbolic_factorization", optim.reuse_symbolic_factorization, optim.reuse_symbolic_factorization);
+  nh.param("augmented_lagrangian", optim.augmented_lagrangian, optim.augmented_lagrangian);
+  nh.param("augmented_lagrangian_tolerance", optim.augmented_lagrangian_tolerance, optim.augmented_lagrangian_tolerance);
+  
+  // Homotopy Class Planner
+  nh.param("enable_homotopy_class_planning", hcp.enable_homotopy_class_planning, hcp.enable_homotopy_class_planning); 
+  nh.param("enable_multithreading", hcp.enable_multithreading, hcp.enable_multithreading); 
+  nh.param("simple_exploration", hcp.simple_exploration, hcp.simple_exploration); 
+  nh.param("max_number_classes", hcp.max_number_classes, hcp.max_number_classes);
+  nh.param("selection_obst_cost_scale", hcp.selection_obst_cost_scale, hcp.selection_obst_cost_scale);
+  nh.param("selection_prefer_initial_plan", hcp.selection_prefer_initial_plan, hcp.selection_prefer_initial_plan);
+  nh.param("selection_viapoint_cost_scale", hcp.selection_viapoint_cost_scale, hcp.selection_viapoint_cost_scale);
+  nh.param("selection_cost_hysteresis", hcp.selection_cost_hysteresis, hcp.selection_cost_hysteresis); 
+  nh.param("selection_alternative_time_cost", hcp.selection_alternative_time_cost, hcp.selection_alternative_time_cost); 
+  nh.param("switching_blocking_period", hcp.switching_blocking_period, hcp.switching_blocking_period);
+  nh.param("roadmap_graph_samples", hcp.roadmap_graph_no_samples, hcp.roadmap_graph_no_samples); 
+  nh.param("roadmap_graph_area_width", hcp.roadmap_graph_area_width, hcp.roadmap_graph_area_width); 
+  nh.param("roadmap_graph_area_length_scale", hcp.roadmap_graph_area_length_scale, hcp.roadmap_graph_area_length_scale);
+  nh.param("h_signature_prescaler", hcp.h_signature_prescaler, hcp.h_signature_prescaler); 
+  nh.param("h_signature_threshold", hcp.h_signature_threshold, hcp.h_signature_threshold); 
+  nh.param("obstacle_keypoint_offset", hcp.obstacle_keypoint_offset, hcp.obstacle_keypoint_offset); 
+  nh.param("obstacle_heading_threshold", hcp.obstacle_heading_threshold, hcp.obstacle_heading_threshold); 
+  nh.param("viapoints_all_candidates", hcp.viapoints_all_candidates, hcp.viapoints_all_candidates);
+  nh.param("visualize_hc_graph", hcp.visualize_hc_graph, hcp.visualize_hc_graph); 
+  nh.param("visualize_with_time_as_z_axis_scale", hcp.visualize_with_time_as_z_axis_scale, hcp.visualize_with_time_as_z_axis_scale);
+  nh.param("delete_detours_backwards", hcp.delete_detours_backwards, hcp.delete_detours_backwards);
+  nh.param("detours_orientation_tolerance", hcp.detours_orientation_tolerance, hcp.detours_orientation_tolerance);
+  nh.param("length_start_orientation_vector", hcp.length_start_orientation_vector, hcp.length_start_orientation_vector);
+  nh.param("max_ratio_detours_duration_best_duration", hcp.max_ratio_detours_duration_best_duration, hcp.max_ratio_detours_duration_best_duration);
+  
+  // Recovery
+  nh.param("shrink_horizon_backup", recovery.shrink_horizon_backup, recovery.shrink_horizon_backup);
+  nh.param("shrink_horizon_min_duration", recovery.shrink_horizon_min_duration, recovery.shrink_horizon_min_duration);
+  nh.param("oscillation_recovery", recovery.oscillation_recovery, recovery.oscillation_recovery);
+  nh.param("oscillation_v_eps", recovery.oscillation_v_eps, recovery.oscillation_v_eps);
+  nh.param("oscillation_omega_eps", recovery.oscillation_omega_eps, recovery.oscillation_omega_eps);
+  nh.param("oscillation_recovery_min_duration", recovery.oscillation_recovery_min_duration, recovery.oscillation_recovery_min_duration);
+  nh.param("oscillation_filter_duration", recovery.oscillation_filter_duration, recovery.oscillation_filter_duration);
+  
+  // Replanning
+  nh.param("event_driven_replanning", replanning.event_driven, replanning.event_driven);
+  nh.param("replanning_change_resolution", replanning.change_resolution, replanning.change_resolution);
+  nh.param("replanning_goal_change_dist", replanning.goal_change_dist, replanning.goal_change_dist);
+  nh.param("replanning_goal_change_angle", replanning.goal_change_angle, replanning.goal_change_angle);
+  nh.param("replanning_max_tracking_error_xy", replanning.max_tracking_error_xy, replanning.max_tracking_error_xy);
+  nh.param("replanning_max_tracking_error_yaw", replanning.max_tracking_error_yaw, replanning.max_tracking_error_yaw);
+  nh.param("replanning_refine_iterations", replanning.refine_iterations, replanning.refine_iterations);
+  nh.param("replanning_max_refinements", replanning.max_refinements, replanning.max_refinements);
+  nh.param("speculative_planning", replanning.speculative, replanning.speculative);
+  nh.param("speculation_tolerance_xy", replanning.speculation_tolerance_xy, replanning.speculation_tolerance_xy);
+  nh.param("speculation_tolerance_yaw", replanning.speculation_tolerance_yaw, replanning.speculation_tolerance_yaw);
+  
+  // Experience cache
+  nh.param("enable_experience_cache", experience.enable, experience.enable);
+  nh.param("experience_cache_size", experience.max_entries, experience.max_entries);
+  nh.param("experience_grid_resolution", experience.grid_resolution, experience.grid_resolution);
+  nh.param("experience_max_goal_distance", experience.max_goal_distance, experience.max_goal_distance);
+  nh.param("experience_max_goal_angle", experience.max_goal_angle, experience.max_goal_angle);
+  nh.param("experience_max_cell_mismatch", experience.max_cell_mismatch, experience.max_cell_mismatch);
+  nh.param("experience_cache_file", experience.file, experience.file);
+
+  checkParameters();
+  checkDeprecated(nh);
+}
+
+void TebConfig::reconfigure(TebLocalPlannerReconfigureConfig& cfg)
+{ 
+  boost::mutex::scoped_lock l(config_mutex_);
+  
+  // Trajectory
+  trajectory.teb_autosize = cfg.teb_autosize;
+  trajectory.dt_ref = cfg.dt_ref;
+  trajectory.dt_hysteresis = cfg.dt_hysteresis;
+  trajectory.global_plan_overwrite_orientation = cfg.global_plan_overwrite_orientation;
+  trajectory.allow_init_with_backwards_motion = cfg.allow_init_with_backwards_motion;
+  trajectory.carlike_path_init = cfg.carlike_path_init;
+  trajectory.feasible_time_init = cfg.feasible_time_init;
+  trajectory.global_plan_viapoint_sep = cfg.global_plan_viapoint_sep;
+  trajectory.via_points_ordered = cfg.via_points_ordered;
+  trajectory.max_global_plan_lookahead_dist = cfg.max_global_plan_lookahead_dist;
+  trajectory.exact_arc_length = cfg.exact_arc_length;
+  trajectory.force_reinit_new_goal_dist = cfg.force_reinit_new_goal_dist;
+  trajectory.feasibility_check_no_poses = cfg.feasibility_check_no_poses;
+  trajectory.publish_feedback = cfg.publish_feedback;
+  
+  // Robot     
+  robot.max_vel_x = cfg.max_vel_x;
+  robot.max_vel_x_backwards = cfg.max_vel_x_backwards;
+  robot.max_vel_y = cfg.max_vel_y;
+  robot.max_vel_theta = cfg.max_vel_theta;
+  robot.acc_lim_x = cfg.acc_lim_x;
+  robot.acc_lim_y = cfg.acc_lim_y;
+  robot.acc_lim_theta = cfg.acc_lim_theta;
+  robot.min_turning_radius = cfg.min_turning_radius;
+  robot.wheelbase = cfg.wheelbase;
+  robot.cmd_angle_instead_rotvel = cfg.cmd_angle_instead_rotvel;
+  
+  // GoalTolerance
+  goal_tolerance.xy_goal_tolerance = cfg.xy_goal_tolerance;
+  goal_tolerance.yaw_goal_tolerance = cfg.yaw_goal_tolerance;
+  goal_tolerance.free_goal_vel = cfg.free_goal_vel;
+  
+  // Obstacles
+  obstacles.min_obstacle_dist = cfg.min_obstacle_dist;
+  obstacles.inflation_dist = cfg.inflation_dist;
+  obstacles.dynamic_obstacle_inflation_dist = cfg.dynamic_obstacle_inflation_dist;
+  obstacles.include_dynamic_obstacles = cfg.include_dynamic_obstacles;
+  obstacles.include_costmap_obstacles = cfg.include_costmap_obstacles;
+  obstacles.legacy_obstacle_association = cfg.legacy_obstacle_association;
+  obstacles.obstacle_association_force_inclusion_factor = cfg.obstacle_association_force_inclusion_factor;
+  obstacles.obstacle_association_cutoff_factor = cfg.obstacle_association_cutoff_factor;
+  obstacles.costmap_obstacles_behind_robot_dist = cfg.costmap_obstacles_behind_robot_dist;
+  obstacles.obstacle_poses_affected = cfg.obstacle_poses_affected;
+  obstacles.polygon_simplification_tolerance = cfg.polygon_simplification_tolerance;
+  obstacles.point_obstacle_merge_dist = cfg.point_obstacle_merge_dist;
+  obstacles.corridor_prefilter = cfg.corridor_prefilter;
+  obstacles.corridor_prefilter_slack = cfg.corridor_prefilter_slack;
+
+  
+  // Optimization
+  optim.no_inner_iterations = cfg.no_inner_iterations;
+  optim.no_outer_iterations = cfg.no_outer_iterations;
+  optim.optimization_activate = cfg.optimization_activate;
+  optim.optimization_verbose = cfg.optimization_verbose;
+  optim.penalty_epsilon = cfg.penalty_epsilon;
+  optim.weight_max_vel_x = cfg.weight_max_vel_x;
+  optim.weight_max_vel_y = cfg.weight_max_vel_y;
+  optim.weight_max_vel_theta = cfg.weight_max_vel_theta;
+  optim.weight_acc_lim_x = cfg.weight_acc_lim_x;
+  optim.weight_acc_lim_y = cfg.weight_acc_lim_y;
+  optim.weight_acc_lim_theta = cfg.weight_acc_lim_theta;
+  optim.weight_kinematics_nh = cfg.weight_kinematics_nh;
+  optim.weight_kinematics_forward_drive = cfg.weight_kinematics_forward_drive;
+  optim.weight_kinematics_turning_radius = cfg.weight_kinematics_turning_radius;
+  optim.weight_optimaltime = cfg.weight_optimaltime;
+  optim.weight_shortest_path = cfg.weight_shortest_path;
+  optim.weight_obstacle = cfg.weight_obstacle;
+  optim.weight_inflation = cfg.weight_inflation;
+  optim.weight_dynamic_obstacle = cfg.weight_dynamic_obstacle;
+  optim.weight_dynamic_obstacle_inflation = cfg.weight_dynamic_obstacle_inflation;
+  optim.weight_viapoint = cfg.weight_viapoint;
+  optim.weight_adapt_factor = cfg.weight_adapt_factor;
+  optim.obstacle_cost_exponent = cfg.obstacle_cost_exponent;
+  optim.fuse_consecutive_pose_edges = cfg.fuse_consecutive_pose_edges;
+  optim.batch_edge_linearization = cfg.batch_edge_linearization;
+  optim.multi_start_candidates = cfg.multi_start_candidates;
+  optim.multi_start_lateral_offset = cfg.multi_start_lateral_offset;
+  optim.multi_start_selection_hysteresis = cfg.multi_start_selection_hysteresis;
+  optim.horizon_partitions = cfg.horizon_partitions;
+  optim.horizon_partition_min_poses = cfg.horizon_partition_min_poses;
+  optim.reuse_symbolic_factorization = cfg.reuse_symbolic_factorization;
+  optim.augmented_lagrangian = cfg.augmented_lagrangian;
+  optim.augmented_lagrangian_tolerance = cfg.augmented_lagrangian_tolerance;
+  
+  // Homotopy Class Planner
+  hcp.enable_multithreading = cfg.enable_multithreading;
+  hcp.max_number_classes = cfg.max_number_classes; 
+  hcp.selection_cost_hysteresis = cfg.selection_cost_hysteresis;
+  hcp.selection_prefer_initial_plan = cfg.selection_prefer_initial_plan;
+  hcp.selection_obst_cost_scale = cfg.selection_obst_cost_scale;
+  hcp.selection_viapoint_cost_scale = cfg.selection_viapoint_cost_scale;
+  hcp.selection_alternative_time_cost = cfg.selection_alternative_time_cost;
+  hcp.switching_blocking_period = cfg.switching_blocking_period;
+  
+  hcp.obstacle_heading_threshold = cfg.obstacle_heading_threshold;
+  hcp.roadmap_graph_no_samples = cfg.roadmap_graph_no_samples;
+  hcp.roadmap_graph_area_width = cfg.roadmap_graph_area_width;
+  hcp.roadmap_graph_area_length_scale = cfg.roadmap_graph_area_length_scale;
+  hcp.h_signature_prescaler = cfg.h_signature_prescaler;
+  hcp.h_signature_threshold = cfg.h_signature_threshold;
+  hcp.viapoints_all_candidates = cfg.viapoints_all_candidates;
+  hcp.visualize_hc_graph = cfg.visualize_hc_graph;
+  hcp.visualize_with_time_as_z_axis_scale = cfg.visualize_with_time_as_z_axis_scale;
+  
+  // Recovery
+  
+  recovery.shrink_horizon_backup = cfg.shrink_horizon_backup;
+  recovery.oscillation_recovery = cfg.oscillation_recovery;
+  
+  // Replanning
+  
+  replanning.event_driven = cfg.event_driven_replanning;
+  replanning.max_tracking_error_xy = cfg.replanning_max_tracking_error_xy;
+  replanning.max_tracking_error_yaw = cfg.replanning_max_tracking_error_yaw;
+  replanning.refine_iterations = cfg.replanning_refine_iterations;
+  replanning.max_refinements = cfg.replanning_max_refinements;
+  replanning.speculative = cfg.speculative_planning;
+  replanning.speculation_tolerance_xy = cfg.speculation_tolerance_xy;
+  replanning.speculation_tolerance_yaw = cfg.speculation_tolerance_yaw;
+  
+  // Experience cache
+  experience.enable = cfg.enable_experience_cache;
+  experience.max_goal_distance = cfg.experience_max_goal_distance;
+  experience.max_goal_angle = cfg.experience_max_goal_angle;
+  experience.max_cell_mismatch = cfg.experience_max_cell_mismatch;
+  
+  checkParameters();
+}
+
+
+void TebConfig::checkDeprecated(const ros::NodeHandle& nh) const
+{
+  if (nh.hasParam("line_obstacle_poses_affected") || nh.hasParam("polygon_obstacle_poses_affected"))
+    ROS_WARN("TebLocalPlannerROS() Param Warning: 'line_obstacle_poses_affected' and 'polygon_obstacle_poses_affected' are deprecated. They share now the common parameter 'obstacle_poses_affected'.");
+  
+  if (nh.hasParam("weight_point_obstacle") || nh.hasParam("weight_line_obstacle") || nh.hasParam("weight_poly_obstacle"))
+    ROS_WARN("TebLocalPlannerROS() Param Warning: 'weight_point_obstacle', 'weight_line_obstacle' and 'weight_poly_obstacle' are deprecated. They are replaced by the single param 'weight_obstacle'.");
+  
+  if (nh.hasParam("costmap_obstacles_front_only"))
+    ROS_WARN("TebLocalPlannerROS() Param Warning: 'costmap_obstacles_front_only' is deprecated. It is replaced by 'costmap_obstacles_behind_robot_dist' to define the actual area taken into account.");
+  
+  if (nh.hasParam("costmap_emergency_stop_dist"))
+    ROS_WARN("TebLocalPlannerROS() Param Warning: 'costmap_emergency_stop_dist' is deprecated. You can safely remove it from your parameter config.");
+  
+  if (nh.hasParam("alternative_time_cost"))
+    ROS_WARN("TebLocalPlannerROS() Param Warning: 'alternative_time_cost' is deprecated. It has been replaced by 'selection_alternative_time_cost'.");
+
+  if (nh.hasParam("global_plan_via_point_sep"))
+    ROS_WARN("TebLocalPlannerROS() Param Warning: 'global_plan_via_point_sep' is deprecated. It has been replaced by 'global_plan_viapoint_sep' due to consistency reasons.");
+}
+
+    
+} // namespace teb_local_planner
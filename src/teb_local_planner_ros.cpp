@@ -63,19 +63,47 @@ namespace teb_local_planner
 
 TebLocalPlannerROS::TebLocalPlannerROS() : costmap_ros_(NULL), tf_(NULL), costmap_model_(NULL),
                                            costmap_converter_loader_("costmap_converter", "costmap_converter::BaseCostmapToPolygons"),
-                                           dynamic_recfg_(NULL), custom_via_points_active_(false), goal_reached_(false), no_infeasible_plans_(0),
-                                           last_preferred_rotdir_(RotType::none), initialized_(false)
+                                           dynamic_recfg_(NULL), custom_via_points_active_(false), goal_reached_(false), initialized_(false)
 {
 }
 
 
 TebLocalPlannerROS::~TebLocalPlannerROS()
 {
+  // the speculative worker uses the planner, the config, the obstacles and the via-point mutex,
+  // which are destroyed before the speculative planner itself (and it might insert into the experience cache)
+  speculative_planner_.reset();
+  
+  // persist the experience cache across restarts
+  if (experience_cache_ && !cfg_.experience.file.empty())
+  {
+    if (experience_cache_->save(cfg_.experience.file))
+      ROS_INFO("Stored %lu trajectories in the experience cache file '%s'.", (unsigned long) experience_cache_->size(), cfg_.experience.file.c_str());
+    else
+      ROS_WARN("Cannot write the experience cache file '%s'.", cfg_.experience.file.c_str());
+  }
 }
 
 void TebLocalPlannerROS::reconfigureCB(TebLocalPlannerReconfigureConfig& config, uint32_t level)
 {
   cfg_.reconfigure(config);
+  
+  if (planner_)
+  {
+    boost::mutex::scoped_lock cfg_lock(cfg_.configMutex()); // the planner (and the speculative worker) is idle
+    updateExperienceCache();
+  }
+}
+
+void TebLocalPlannerROS::updateExperienceCache()
+{
+  if (cfg_.experience.enable && !experience_cache_)
+  {
+    experience_cache_ = boost::make_shared<ExperienceCache>(cfg_.experience.max_entries, cfg_.experience.grid_resolution);
+    if (!cfg_.experience.file.empty() && experience_cache_->load(cfg_.experience.file))
+      ROS_INFO("Loaded %lu trajectories from the experience cache file '%s'.", (unsigned long) experience_cache_->size(), cfg_.experience.file.c_str());
+  }
+  planner_->setExperienceCache(cfg_.experience.enable ? experience_cache_ : ExperienceCachePtr());
 }
 
 void TebLocalPlannerROS::initialize(std::string name, tf::TransformListener* tf, costmap_2d::Costmap2DROS* costmap_ros)
@@ -92,24 +120,42 @@ void TebLocalPlannerROS::initialize(std::string name, tf::TransformListener* tf,
     // reserve some memory for obstacles
     obstacles_.reserve(500);
         
+    // route logging and timing of the planning core through ROS
+    initRosAdapter();
+    
     // create visualization instance	
     visualization_ = TebVisualizationPtr(new TebVisualization(nh, cfg_)); 
         
-    // create robot footprint/contour model for optimization
-    RobotFootprintModelPtr robot_model = getRobotFootprintFromParamServer(nh);
+    // create robot footprint/contour model for optimization (the costmap footprint is used for the automatic circle decomposition)
+    Point2dContainer costmap_footprint;
+    std::vector<geometry_msgs::Point> costmap_footprint_msg = costmap_ros->getRobotFootprint();
+    for (std::size_t i = 0; i < costmap_footprint_msg.size(); ++i)
+      costmap_footprint.push_back(Eigen::Vector2d(costmap_footprint_msg[i].x, costmap_footprint_msg[i].y));
+    robot_model_ = getRobotFootprintFromParamServer(nh, costmap_footprint);
     
     // create the planner instance
     if (cfg_.hcp.enable_homotopy_class_planning)
     {
-      planner_ = PlannerInterfacePtr(new HomotopyClassPlanner(cfg_, &obstacles_, robot_model, visualization_, &via_points_));
+      planner_ = PlannerInterfacePtr(new HomotopyClassPlanner(cfg_, &obstacles_, robot_model_, &via_points_));
       ROS_INFO("Parallel planning in distinctive topologies enabled.");
     }
     else
     {
-      planner_ = PlannerInterfacePtr(new TebOptimalPlanner(cfg_, &obstacles_, robot_model, visualization_, &via_points_));
+      planner_ = PlannerInterfacePtr(new TebOptimalPlanner(cfg_, &obstacles_, robot_model_, &via_points_));
       ROS_INFO("Parallel planning in distinctive topologies disabled.");
     }
     
+    // record per-iteration statistics of the optimizer if desired
+    if (cfg_.optim.telemetry_buffer_size > 0)
+    {
+      telemetry_ = boost::make_shared<OptimizerTelemetry>(cfg_.optim.telemetry_buffer_size);
+      planner_->setTelemetry(telemetry_);
+    }
+    
+    // initialize new trajectories from previously optimized ones if desired (might be enabled at runtime, see reconfigureCB())
+    if (cfg_.experience.enable)
+      updateExperienceCache();
+    
     // init other variables
     tf_ = tf;
     costmap_ros_ = costmap_ros;
@@ -172,7 +218,17 @@ void TebLocalPlannerROS::initialize(std::string name, tf::TransformListener* tf,
     ros::NodeHandle nh_move_base("~");
     double controller_frequency = 5;
     nh_move_base.param("controller_frequency", controller_frequency, controller_frequency);
-    failure_detector_.setBufferLength(std::round(cfg_.recovery.oscillation_filter_duration*controller_frequency));
+    backup_modes_.initialize(cfg_, std::round(cfg_.recovery.oscillation_filter_duration*controller_frequency));
+    
+    // initialize the change detection for event-driven replanning
+    replanning_monitor_.initialize(cfg_);
+    
+    // initialize the corridor that prefilters the obstacles of each cycle
+    corridor_filter_.initialize(cfg_, robot_model_);
+    
+    // initialize the speculative planning for the predicted start state of the next cycle
+    control_period_ = 1.0 / controller_frequency;
+    speculative_planner_.initialize(cfg_, planner_, &cfg_.configMutex(), &via_point_mutex_);
     
     // set initialized flag
     initialized_ = true;
@@ -219,6 +275,9 @@ bool TebLocalPlannerROS::computeVelocityCommands(geometry_msgs::Twist& cmd_vel)
     return false;
   }
 
+  // the speculative optimization of the previous cycle shares the planner and the obstacle container
+  speculative_planner_.wait();
+
   cmd_vel.linear.x = 0;
   cmd_vel.linear.y = 0;
   cmd_vel.angular.z = 0;
@@ -227,14 +286,14 @@ bool TebLocalPlannerROS::computeVelocityCommands(geometry_msgs::Twist& cmd_vel)
   // Get robot pose
   tf::Stamped<tf::Pose> robot_pose;
   costmap_ros_->getRobotPose(robot_pose);
-  robot_pose_ = PoseSE2(robot_pose);
+  robot_pose_ = poseFromTf(robot_pose);
     
   // Get robot velocity
   tf::Stamped<tf::Pose> robot_vel_tf;
   odom_helper_.getRobotVel(robot_vel_tf);
-  robot_vel_.linear.x = robot_vel_tf.getOrigin().getX();
-  robot_vel_.linear.y = robot_vel_tf.getOrigin().getY();
-  robot_vel_.angular.z = tf::getYaw(robot_vel_tf.getRotation());
+  robot_vel_.vx = robot_vel_tf.getOrigin().getX();
+  robot_vel_.vy = robot_vel_tf.getOrigin().getY();
+  robot_vel_.omega = tf::getYaw(robot_vel_tf.getRotation());
   
   // prune global plan to cut off parts of the past (spatially before the robot)
   pruneGlobalPlan(*tf_, robot_pose, global_plan_, cfg_.trajectory.global_plan_prune_distance);
@@ -250,7 +309,9 @@ bool TebLocalPlannerROS::computeVelocityCommands(geometry_msgs::Twist& cmd_vel)
     return false;
   }
 
-  // update via-points container
+  // update via-points container (locked until the end of the cycle, customViaPointsCB() must not modify it while planning).
+  // Lock order: via_point_mutex_ before the config mutex, the speculative worker (SpeculativePlanner::run()) locks both in the same order.
+  boost::mutex::scoped_lock via_point_lock(via_point_mutex_);
   if (!custom_via_points_active_)
     updateViaPointsContainer(transformed_plan, cfg_.trajectory.global_plan_viapoint_sep);
 
@@ -303,33 +364,78 @@ bool TebLocalPlannerROS::computeVelocityCommands(geometry_msgs::Twist& cmd_vel)
     transformed_plan.insert(transformed_plan.begin(), geometry_msgs::PoseStamped()); // insert start (not yet initialized)
   }
   tf::poseTFToMsg(robot_pose, transformed_plan.front().pose); // update start;
-    
-  // clear currently existing obstacles
-  obstacles_.clear();
-  
-  // Update obstacle container with costmap information or polygons provided by a costmap_converter plugin
-  if (costmap_converter_)
-    updateObstacleContainerWithCostmapConverter();
-  else
-    updateObstacleContainerWithCostmap();
   
-  // also consider custom obstacles (must be called after other updates, since the container is not cleared)
-  updateObstacleContainerWithCustomObstacles();
+  PoseSE2Container initial_plan;
+  planFromMsg(transformed_plan, initial_plan);
+    
+  {
+    AllocationPhaseScope alloc_phase(AllocationPhase::ObstacleUpdate);
+    
+    // clear currently existing obstacles
+    obstacles_.clear();
+    
+    // Update obstacle container with costmap information or polygons provided by a costmap_converter plugin
+    if (costmap_converter_)
+      updateObstacleContainerWithCostmapConverter();
+    else
+      updateObstacleContainerWithCostmap();
+    
+    // also consider custom obstacles (must be called after other updates, since the container is not cleared)
+    updateObstacleContainerWithCustomObstacles();
+    
+    // remove redundant vertices of noisy polygons and nearly coincident points before any planner component sees them
+    if (cfg_.obstacles.polygon_simplification_tolerance > 0 || cfg_.obstacles.point_obstacle_merge_dist > 0)
+      simplifyObstacles(obstacles_, cfg_.obstacles.polygon_simplification_tolerance, cfg_.obstacles.point_obstacle_merge_dist);
+    
+    // discard obstacles that cannot be associated with the current plan or trajectories (planner is idle, see speculative_planner_.wait())
+    if (cfg_.obstacles.corridor_prefilter)
+    {
+      corridor_filter_.clear();
+      corridor_filter_.addPath(initial_plan);
+      corridor_filter_.addViaPoints(via_points_);
+      corridor_filter_.addPlanner(*planner_);
+      corridor_filter_.filter(obstacles_);
+    }
+  }
   
     
-  // Do not allow config changes during the following optimization step
+  // Do not allow config changes during the following optimization step (lock order: see via_point_lock)
+  TEB_ASSERT_MSG(via_point_lock.owns_lock(), "TebLocalPlannerROS: lock the via-points before the config (lock order of the speculative worker).");
   boost::mutex::scoped_lock cfg_lock(cfg_.configMutex());
     
   // Now perform the actual planning
-//   bool success = planner_->plan(robot_pose_, robot_goal_, robot_vel_, cfg_.goal_tolerance.free_goal_vel); // straight line init
-  bool success = planner_->plan(transformed_plan, &robot_vel_, cfg_.goal_tolerance.free_goal_vel);
+//   bool success = planner_->plan(robot_pose_, robot_goal_, &robot_vel_, cfg_.goal_tolerance.free_goal_vel); // straight line init
+  if (telemetry_)
+    telemetry_->nextCycle();
+  ReplanningDecision replanning = ReplanningDecision::Refinement;
+  bool success;
+  // use the speculative result of the previous cycle if the robot reached the predicted state
+  if (speculative_planner_.accept(robot_pose_, robot_goal_, obstacles_))
+  {
+    replanning = ReplanningDecision::Speculative;
+    success = true;
+  }
+  else
+  {
+    // skip the full optimization if the planning problem did not change since the last cycle
+    replanning = replanning_monitor_.evaluate(*planner_, robot_pose_, robot_goal_, obstacles_, &via_points_);
+    if (replanning == ReplanningDecision::Refinement)
+      success = planner_->refine(initial_plan, &robot_vel_, cfg_.goal_tolerance.free_goal_vel);
+    else
+      success = planner_->plan(initial_plan, &robot_vel_, cfg_.goal_tolerance.free_goal_vel);
+  }
+  if (telemetry_)
+  {
+    AllocationPhaseScope alloc_phase(AllocationPhase::MessageConstruction);
+    visualization_->publishOptimizerDiagnostics(*telemetry_);
+  }
   if (!success)
   {
     planner_->clearPlanner(); // force reinitialization for next time
     ROS_WARN("teb_local_planner was not able to obtain a local plan for the current setting.");
     
-    ++no_infeasible_plans_; // increase number of infeasible solutions in a row
-    time_last_infeasible_plan_ = ros::Time::now();
+    backup_modes_.notifyInfeasiblePlan(); // increase number of infeasible solutions in a row
+    replanning_monitor_.notifyPlanned(replanning, false);
     last_cmd_ = cmd_vel;
     return false;
   }
@@ -342,7 +448,9 @@ bool TebLocalPlannerROS::computeVelocityCommands(geometry_msgs::Twist& cmd_vel)
     costmap_2d::calculateMinAndMaxDistances(footprint_spec_, robot_inscribed_radius_, robot_circumscribed_radius);
   }
 
-  bool feasible = planner_->isTrajectoryFeasible(costmap_model_.get(), footprint_spec_, robot_inscribed_radius_, robot_circumscribed_radius, cfg_.trajectory.feasibility_check_no_poses);
+  CostmapCollisionChecker collision_checker(costmap_model_.get(), footprint_spec_, robot_inscribed_radius_, robot_circumscribed_radius);
+  collision_checker.setVisualization(visualization_, robot_model_);
+  bool feasible = planner_->isTrajectoryFeasible(collision_checker, cfg_.trajectory.feasibility_check_no_poses);
   if (!feasible)
   {
     cmd_vel.linear.x = 0;
@@ -353,8 +461,8 @@ bool TebLocalPlannerROS::computeVelocityCommands(geometry_msgs::Twist& cmd_vel)
     planner_->clearPlanner();
     ROS_WARN("TebLocalPlannerROS: trajectory is not feasible. Resetting planner...");
     
-    ++no_infeasible_plans_; // increase number of infeasible solutions in a row
-    time_last_infeasible_plan_ = ros::Time::now();
+    backup_modes_.notifyInfeasiblePlan(); // increase number of infeasible solutions in a row
+    replanning_monitor_.notifyPlanned(replanning, false);
     last_cmd_ = cmd_vel;
     return false;
   }
@@ -364,8 +472,8 @@ bool TebLocalPlannerROS::computeVelocityCommands(geometry_msgs::Twist& cmd_vel)
   {
     planner_->clearPlanner();
     ROS_WARN("TebLocalPlannerROS: velocity command invalid. Resetting planner...");
-    ++no_infeasible_plans_; // increase number of infeasible solutions in a row
-    time_last_infeasible_plan_ = ros::Time::now();
+    backup_modes_.notifyInfeasiblePlan(); // increase number of infeasible solutions in a row
+    replanning_monitor_.notifyPlanned(replanning, false);
     last_cmd_ = cmd_vel;
     return false;
   }
@@ -386,23 +494,28 @@ bool TebLocalPlannerROS::computeVelocityCommands(geometry_msgs::Twist& cmd_vel)
       last_cmd_ = cmd_vel;
       planner_->clearPlanner();
       ROS_WARN("TebLocalPlannerROS: Resulting steering angle is not finite. Resetting planner...");
-      ++no_infeasible_plans_; // increase number of infeasible solutions in a row
-      time_last_infeasible_plan_ = ros::Time::now();
+      backup_modes_.notifyInfeasiblePlan(); // increase number of infeasible solutions in a row
+      replanning_monitor_.notifyPlanned(replanning, false);
       return false;
     }
   }
   
   // a feasible solution should be found, reset counter
-  no_infeasible_plans_ = 0;
+  backup_modes_.notifyFeasiblePlan();
+  replanning_monitor_.notifyPlanned(replanning, true);
   
   // store last command (for recovery analysis etc.)
   last_cmd_ = cmd_vel;
   
   // Now visualize everything    
-  planner_->visualize();
+  AllocationPhaseScope alloc_phase(AllocationPhase::MessageConstruction);
+  visualization_->publishPlanner(*planner_, *robot_model_, obstacles_);
   visualization_->publishObstacles(obstacles_);
   visualization_->publishViaPoints(via_points_);
   visualization_->publishGlobalPlan(global_plan_);
+  
+  // start optimizing for the next cycle (the worker waits for via_point_lock and cfg_lock)
+  speculative_planner_.start(initial_plan, control_period_, obstacles_, cfg_.goal_tolerance.free_goal_vel);
   return true;
 }
 
@@ -412,7 +525,9 @@ bool TebLocalPlannerROS::isGoalReached()
   if (goal_reached_)
   {
     ROS_INFO("GOAL Reached!");
+    speculative_planner_.reset();
     planner_->clearPlanner();
+    replanning_monitor_.reset();
     return true;
   }
   return false;
@@ -489,7 +604,7 @@ void TebLocalPlannerROS::updateObstacleContainerWithCostmapConverter()
 
     // Set velocity, if obstacle is moving
     if(!obstacles_.empty())
-      obstacles_.back()->setCentroidVelocity(obstacles->obstacles[i].velocities, obstacles->obstacles[i].orientation);
+      setObstacleVelocityFromMsg(*obstacles_.back(), obstacles->obstacles[i].velocities, obstacles->obstacles[i].orientation);
   }
 }
 
@@ -568,30 +683,16 @@ void TebLocalPlannerROS::updateObstacleContainerWithCustomObstacles()
 
       // Set velocity, if obstacle is moving
       if(!obstacles_.empty())
-        obstacles_.back()->setCentroidVelocity(custom_obstacle_msg_.obstacles[i].velocities, custom_obstacle_msg_.obstacles[i].orientation);
+        setObstacleVelocityFromMsg(*obstacles_.back(), custom_obstacle_msg_.obstacles[i].velocities, custom_obstacle_msg_.obstacles[i].orientation);
     }
   }
 }
 
 void TebLocalPlannerROS::updateViaPointsContainer(const std::vector<geometry_msgs::PoseStamped>& transformed_plan, double min_separation)
 {
-  via_points_.clear();
-  
-  if (min_separation<=0)
-    return;
-  
-  std::size_t prev_idx = 0;
-  for (std::size_t i=1; i < transformed_plan.size(); ++i) // skip first one, since we do not need any point before the first min_separation [m]
-  {
-    // check separation to the previous via-point inserted
-    if (distance_points2d( transformed_plan[prev_idx].pose.position, transformed_plan[i].pose.position ) < min_separation)
-      continue;
-        
-    // add via-point
-    via_points_.push_back( Eigen::Vector2d( transformed_plan[i].pose.position.x, transformed_plan[i].pose.position.y ) );
-    prev_idx = i;
-  }
-  
+  PoseSE2Container plan;
+  planFromMsg(transformed_plan, plan);
+  extractViaPoints(plan, min_separation, via_points_);
 }
       
 Eigen::Vector2d TebLocalPlannerROS::tfPoseToEigenVector2dTransRot(const tf::Pose& tf_vel)
@@ -830,48 +931,6 @@ double TebLocalPlannerROS::estimateLocalGoalOrientation(const std::vector<geomet
 }
       
       
-void TebLocalPlannerROS::saturateVelocity(double& vx, double& vy, double& omega, double max_vel_x, double max_vel_y, double max_vel_theta, double max_vel_x_backwards) const
-{
-  // Limit translational velocity for forward driving
-  if (vx > max_vel_x)
-    vx = max_vel_x;
-  
-  // limit strafing velocity
-  if (vy > max_vel_y)
-    vy = max_vel_y;
-  else if (vy < -max_vel_y)
-    vy = -max_vel_y;
-  
-  // Limit angular velocity
-  if (omega > max_vel_theta)
-    omega = max_vel_theta;
-  else if (omega < -max_vel_theta)
-    omega = -max_vel_theta;
-  
-  // Limit backwards velocity
-  if (max_vel_x_backwards<=0)
-  {
-    ROS_WARN_ONCE("TebLocalPlannerROS(): Do not choose max_vel_x_backwards to be <=0. Disable backwards driving by increasing the optimization weight for penalyzing backwards driving.");
-  }
-  else if (vx < -max_vel_x_backwards)
-    vx = -max_vel_x_backwards;
-}
-     
-     
-double TebLocalPlannerROS::convertTransRotVelToSteeringAngle(double v, double omega, double wheelbase, double min_turning_radius) const
-{
-  if (omega==0 || v==0)
-    return 0;
-    
-  double radius = v/omega;
-  
-  if (fabs(radius) < min_turning_radius)
-    radius = double(g2o::sign(radius)) * min_turning_radius; 
-
-  return std::atan(wheelbase / radius);
-}
-     
-
 void TebLocalPlannerROS::validateFootprints(double opt_inscribed_radius, double costmap_inscribed_radius, double min_obst_dist)
 {
     ROS_WARN_COND(opt_inscribed_radius + min_obst_dist < costmap_inscribed_radius,
@@ -884,76 +943,11 @@ void TebLocalPlannerROS::validateFootprints(double opt_inscribed_radius, double
    
 void TebLocalPlannerROS::configureBackupModes(std::vector<geometry_msgs::PoseStamped>& transformed_plan,  int& goal_idx)
 {
-    ros::Time current_time = ros::Time::now();
-    
     // reduced horizon backup mode
-    if (cfg_.recovery.shrink_horizon_backup && 
-        goal_idx < (int)transformed_plan.size()-1 && // we do not reduce if the goal is already selected (because the orientation might change -> can introduce oscillations)
-       (no_infeasible_plans_>0 || (current_time - time_last_infeasible_plan_).toSec() < cfg_.recovery.shrink_horizon_min_duration )) // keep short horizon for at least a few seconds
-    {
-        ROS_INFO_COND(no_infeasible_plans_==1, "Activating reduced horizon backup mode for at least %.2f sec (infeasible trajectory detected).", cfg_.recovery.shrink_horizon_min_duration);
-
-
-        // Shorten horizon if requested
-        // reduce to 50 percent:
-        int horizon_reduction = goal_idx/2;
-        
-        if (no_infeasible_plans_ > 9)
-        {
-            ROS_INFO_COND(no_infeasible_plans_==10, "Infeasible trajectory detected 10 times in a row: further reducing horizon...");
-            horizon_reduction /= 2;
-        }
-        
-        // we have a small overhead here, since we already transformed 50% more of the trajectory.
-        // But that's ok for now, since we do not need to make transformGlobalPlan more complex 
-        // and a reduced horizon should occur just rarely.
-        int new_goal_idx_transformed_plan = int(transformed_plan.size()) - horizon_reduction - 1;
-        goal_idx -= horizon_reduction;
-        if (new_goal_idx_transformed_plan>0 && goal_idx >= 0)
-            transformed_plan.erase(transformed_plan.begin()+new_goal_idx_transformed_plan, transformed_plan.end());
-        else
-            goal_idx += horizon_reduction; // this should not happen, but safety first ;-) 
-    }
-    
+    backup_modes_.shrinkHorizon(transformed_plan, goal_idx);
     
     // detect and resolve oscillations
-    if (cfg_.recovery.oscillation_recovery)
-    {
-        double max_vel_theta;
-        double max_vel_current = last_cmd_.linear.x >= 0 ? cfg_.robot.max_vel_x : cfg_.robot.max_vel_x_backwards;
-        if (cfg_.robot.min_turning_radius!=0 && max_vel_current>0)
-            max_vel_theta = std::max( max_vel_current/std::abs(cfg_.robot.min_turning_radius),  cfg_.robot.max_vel_theta );
-        else
-            max_vel_theta = cfg_.robot.max_vel_theta;
-        
-        failure_detector_.update(last_cmd_, cfg_.robot.max_vel_x, cfg_.robot.max_vel_x_backwards, max_vel_theta,
-                               cfg_.recovery.oscillation_v_eps, cfg_.recovery.oscillation_omega_eps);
-        
-        bool oscillating = failure_detector_.isOscillating();
-        bool recently_oscillated = (ros::Time::now()-time_last_oscillation_).toSec() < cfg_.recovery.oscillation_recovery_min_duration; // check if we have already detected an oscillation recently
-        
-        if (oscillating)
-        {
-            if (!recently_oscillated)
-            {
-                // save current turning direction
-                if (robot_vel_.angular.z > 0)
-                    last_preferred_rotdir_ = RotType::left;
-                else
-                    last_preferred_rotdir_ = RotType::right;
-                ROS_WARN("TebLocalPlannerROS: possible oscillation (of the robot or its local plan) detected. Activating recovery strategy (prefer current turning direction during optimization).");
-            }
-            time_last_oscillation_ = ros::Time::now();  
-            planner_->setPreferredTurningDir(last_preferred_rotdir_);
-        }
-        else if (!recently_oscillated && last_preferred_rotdir_ != RotType::none) // clear recovery behavior
-        {
-            last_preferred_rotdir_ = RotType::none;
-            planner_->setPreferredTurningDir(last_preferred_rotdir_);
-            ROS_INFO("TebLocalPlannerROS: oscillation recovery disabled/expired.");
-        }
-    }
-
+    backup_modes_.updateOscillationRecovery(twistFromMsg(last_cmd_), robot_vel_, *planner_);
 }
      
      
@@ -983,7 +977,7 @@ void TebLocalPlannerROS::customViaPointsCB(const nav_msgs::Path::ConstPtr& via_p
   custom_via_points_active_ = !via_points_.empty();
 }
      
-RobotFootprintModelPtr TebLocalPlannerROS::getRobotFootprintFromParamServer(const ros::NodeHandle& nh)
+RobotFootprintModelPtr TebLocalPlannerROS::getRobotFootprintFromParamServer(const ros::NodeHandle& nh, const Point2dContainer& costmap_footprint)
 {
   std::string model_name; 
   if (!nh.getParam("footprint_model/type", model_name))
@@ -1097,6 +1091,42 @@ RobotFootprintModelPtr TebLocalPlannerROS::getRobotFootprintFromParamServer(cons
     
   }
   
+  // multiple circles (automatic decomposition of a polygon)
+  if (model_name.compare("multi_circles") == 0)
+  {
+    double max_over_approximation = 0.05;
+    int max_circles = 10;
+    nh.param("footprint_model/max_over_approximation", max_over_approximation, max_over_approximation);
+    nh.param("footprint_model/max_circles", max_circles, max_circles);
+    
+    // use the vertices of the footprint model or the costmap footprint otherwise
+    Point2dContainer polygon = costmap_footprint;
+    XmlRpc::XmlRpcValue footprint_xmlrpc;
+    if (nh.getParam("footprint_model/vertices", footprint_xmlrpc))
+    {
+      try
+      {
+        polygon = makeFootprintFromXMLRPC(footprint_xmlrpc, "/footprint_model/vertices");
+      }
+      catch(const std::exception& ex)
+      {
+        ROS_ERROR_STREAM("Footprint model 'multi_circles' cannot be loaded for trajectory optimization: " << ex.what() << ". Using point-model instead.");
+        return boost::make_shared<PointRobotFootprint>();
+      }
+    }
+    if (polygon.size() < 3)
+    {
+      ROS_ERROR_STREAM("Footprint model 'multi_circles' cannot be loaded for trajectory optimization, since param '" << nh.getNamespace() 
+                       << "/footprint_model/vertices' does not exist and the costmap footprint is not a polygon. Using point-model instead.");
+      return boost::make_shared<PointRobotFootprint>();
+    }
+    
+    boost::shared_ptr<MultiCirclesRobotFootprint> model = boost::make_shared<MultiCirclesRobotFootprint>(polygon, max_over_approximation, max_circles);
+    ROS_INFO_STREAM("Footprint model 'multi_circles' (" << model->getCircles().size() << " circles, over-approximation: " 
+                    << model->getApproximationError() << "m) loaded for trajectory optimization.");
+    return model;
+  }
+  
   // otherwise
   ROS_WARN_STREAM("Unknown robot footprint model specified with parameter '" << nh.getNamespace() << "/footprint_model/type'. Using point model instead.");
   return boost::make_shared<PointRobotFootprint>();
@@ -51,6 +51,7 @@ using namespace teb_local_planner; // it is ok here to import everything for tes
 // Ok global variables are bad, but here we only have a simple testing node.
 PlannerInterfacePtr planner;
 TebVisualizationPtr visual;
+RobotFootprintModelPtr robot_model;
 std::vector<ObstaclePtr> obst_vector;
 ViaPointContainer via_points;
 TebConfig config;
@@ -78,6 +79,9 @@ int main( int argc, char** argv )
 {
   ros::init(argc, argv, "test_optim_node");
   ros::NodeHandle n("~");
+  
+  // route logging and timing of the planning core through ROS
+  initRosAdapter();
  
   
   // load ros parameters from node handle
@@ -147,13 +151,13 @@ int main( int argc, char** argv )
   visual = TebVisualizationPtr(new TebVisualization(n, config));
   
   // Setup robot shape model
-  RobotFootprintModelPtr robot_model = TebLocalPlannerROS::getRobotFootprintFromParamServer(n);
+  robot_model = TebLocalPlannerROS::getRobotFootprintFromParamServer(n);
   
   // Setup planner (homotopy class planning or just the local teb planner)
   if (config.hcp.enable_homotopy_class_planning)
-    planner = PlannerInterfacePtr(new HomotopyClassPlanner(config, &obst_vector, robot_model, visual, &via_points));
+    planner = PlannerInterfacePtr(new HomotopyClassPlanner(config, &obst_vector, robot_model, &via_points));
   else
-    planner = PlannerInterfacePtr(new TebOptimalPlanner(config, &obst_vector, robot_model, visual, &via_points));
+    planner = PlannerInterfacePtr(new TebOptimalPlanner(config, &obst_vector, robot_model, &via_points));
   
 
   no_fixed_obstacles = obst_vector.size();
@@ -171,7 +175,7 @@ void CB_mainCycle(const ros::TimerEvent& e)
 // Visualization loop
 void CB_publishCycle(const ros::TimerEvent& e)
 {
-  planner->visualize();
+  visual->publishPlanner(*planner, *robot_model, obst_vector);
   visual->publishObstacles(obst_vector);
   visual->publishViaPoints(via_points);
 }
@@ -273,7 +277,7 @@ void CB_customObstacle(const costmap_converter::ObstacleArrayMsg::ConstPtr& obst
     }
 
     if(!obst_vector.empty())
-      obst_vector.back()->setCentroidVelocity(obst_msg->obstacles.at(i).velocities, obst_msg->obstacles.at(i).orientation);
+      setObstacleVelocityFromMsg(*obst_vector.back(), obst_msg->obstacles.at(i).velocities, obst_msg->obstacles.at(i).orientation);
   }
 }
 
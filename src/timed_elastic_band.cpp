@@ -38,46 +38,120 @@
 
 #include <teb_local_planner/timed_elastic_band.h>
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 
 namespace teb_local_planner
 {
 
 
-TimedElasticBand::TimedElasticBand()
+TimedElasticBand::TimedElasticBand() : pool_capacity_(0)
 {		
 }
 
 TimedElasticBand::~TimedElasticBand()
 {
-  ROS_DEBUG("Destructor Timed_Elastic_Band...");
+  TEB_DEBUG("Destructor Timed_Elastic_Band...");
   clearTimedElasticBand();
+  reserve(0); // free recycled vertices
+}
+
+
+VertexPose* TimedElasticBand::createPoseVertex(const PoseSE2& pose, bool fixed)
+{
+  if (pose_pool_.empty())
+    return new VertexPose(pose, fixed);
+  VertexPose* pose_vertex = pose_pool_.back();
+  pose_pool_.pop_back();
+  pose_vertex->setEstimate(pose);
+  pose_vertex->setFixed(fixed);
+  return pose_vertex;
+}
+
+VertexTimeDiff* TimedElasticBand::createTimeDiffVertex(double dt, bool fixed)
+{
+  if (timediff_pool_.empty())
+    return new VertexTimeDiff(dt, fixed);
+  VertexTimeDiff* timediff_vertex = timediff_pool_.back();
+  timediff_pool_.pop_back();
+  timediff_vertex->dt() = dt;
+  timediff_vertex->setFixed(fixed);
+  return timediff_vertex;
+}
+
+void TimedElasticBand::releasePoseVertex(VertexPose* pose_vertex)
+{
+  if ((int)pose_pool_.size() < pool_capacity_)
+    pose_pool_.push_back(pose_vertex);
+  else
+    delete pose_vertex;
+}
+
+void TimedElasticBand::releaseTimeDiffVertex(VertexTimeDiff* timediff_vertex)
+{
+  if ((int)timediff_pool_.size() < pool_capacity_)
+    timediff_pool_.push_back(timediff_vertex);
+  else
+    delete timediff_vertex;
+}
+
+void TimedElasticBand::reserve(int capacity)
+{
+  pool_capacity_ = std::max(capacity, 0);
+  
+  // shrink pools if required
+  while ((int)pose_pool_.size() > pool_capacity_)
+  {
+    delete pose_pool_.back();
+    pose_pool_.pop_back();
+  }
+  while ((int)timediff_pool_.size() > pool_capacity_)
+  {
+    delete timediff_pool_.back();
+    timediff_pool_.pop_back();
+  }
+  if (pool_capacity_ == 0)
+    return;
+  
+  pose_vec_.reserve(pool_capacity_);
+  timediff_vec_.reserve(pool_capacity_);
+  pose_pool_.reserve(pool_capacity_);
+  timediff_pool_.reserve(pool_capacity_);
+  
+  // preallocate the vertices that are not in use yet
+  while ((int)(pose_pool_.size() + pose_vec_.size()) < pool_capacity_)
+    pose_pool_.push_back(new VertexPose());
+  while ((int)(timediff_pool_.size() + timediff_vec_.size()) < pool_capacity_)
+    timediff_pool_.push_back(new VertexTimeDiff());
 }
 
 
 void TimedElasticBand::addPose(const PoseSE2& pose, bool fixed)
 {
-  VertexPose* pose_vertex = new VertexPose(pose, fixed);
+  VertexPose* pose_vertex = createPoseVertex(pose, fixed);
   pose_vec_.push_back( pose_vertex );
   return;
 }
 
 void TimedElasticBand::addPose(const Eigen::Ref<const Eigen::Vector2d>& position, double theta, bool fixed)
 {
-  VertexPose* pose_vertex = new VertexPose(position, theta, fixed);
+  VertexPose* pose_vertex = createPoseVertex(PoseSE2(position, theta), fixed);
   pose_vec_.push_back( pose_vertex );
   return;
 }
 
  void TimedElasticBand::addPose(double x, double y, double theta, bool fixed)
 {
-  VertexPose* pose_vertex = new VertexPose(x, y, theta, fixed);
+  VertexPose* pose_vertex = createPoseVertex(PoseSE2(x, y, theta), fixed);
   pose_vec_.push_back( pose_vertex );
   return;
 }
 
 void TimedElasticBand::addTimeDiff(double dt, bool fixed)
 {
-  VertexTimeDiff* timediff_vertex = new VertexTimeDiff(dt, fixed);
+  VertexTimeDiff* timediff_vertex = createTimeDiffVertex(dt, fixed);
   timediff_vec_.push_back( timediff_vertex );
   return;
 }
@@ -91,7 +165,7 @@ void TimedElasticBand::addPoseAndTimeDiff(double x, double y, double angle, doub
     addTimeDiff(dt,false);
   }
   else 
-    ROS_ERROR("Method addPoseAndTimeDiff: Add one single Pose first. Timediff describes the time difference between last conf and given conf");
+    TEB_ERROR("Method addPoseAndTimeDiff: Add one single Pose first. Timediff describes the time difference between last conf and given conf");
   return;
 }
 
@@ -104,7 +178,7 @@ void TimedElasticBand::addPoseAndTimeDiff(const PoseSE2& pose, double dt)
     addPose(pose,false);
     addTimeDiff(dt,false);
   } else
-    ROS_ERROR("Method addPoseAndTimeDiff: Add one single Pose first. Timediff describes the time difference between last conf and given conf");
+    TEB_ERROR("Method addPoseAndTimeDiff: Add one single Pose first. Timediff describes the time difference between last conf and given conf");
   return;
 }
 
@@ -115,62 +189,62 @@ void TimedElasticBand::addPoseAndTimeDiff(const Eigen::Ref<const Eigen::Vector2d
     addPose(position, theta,false);
     addTimeDiff(dt,false);
   } else 
-    ROS_ERROR("Method addPoseAndTimeDiff: Add one single Pose first. Timediff describes the time difference between last conf and given conf");
+    TEB_ERROR("Method addPoseAndTimeDiff: Add one single Pose first. Timediff describes the time difference between last conf and given conf");
   return;
 }
 
 
 void TimedElasticBand::deletePose(int index)
 {
-  ROS_ASSERT(index<pose_vec_.size());
-  delete pose_vec_.at(index);
+  TEB_ASSERT(index<pose_vec_.size());
+  releasePoseVertex(pose_vec_.at(index));
   pose_vec_.erase(pose_vec_.begin()+index);
 }
 
 void TimedElasticBand::deletePoses(int index, int number)
 {
-  ROS_ASSERT(index+number<=(int)pose_vec_.size());
+  TEB_ASSERT(index+number<=(int)pose_vec_.size());
   for (int i = index; i<index+number; ++i)
-    delete pose_vec_.at(i);
+    releasePoseVertex(pose_vec_.at(i));
   pose_vec_.erase(pose_vec_.begin()+index, pose_vec_.begin()+index+number);
 }
 
 void TimedElasticBand::deleteTimeDiff(int index)
 {
-  ROS_ASSERT(index<(int)timediff_vec_.size());
-  delete timediff_vec_.at(index);
+  TEB_ASSERT(index<(int)timediff_vec_.size());
+  releaseTimeDiffVertex(timediff_vec_.at(index));
   timediff_vec_.erase(timediff_vec_.begin()+index);
 }
 
 void TimedElasticBand::deleteTimeDiffs(int index, int number)
 {
-  ROS_ASSERT(index+number<=timediff_vec_.size());
+  TEB_ASSERT(index+number<=timediff_vec_.size());
   for (int i = index; i<index+number; ++i)
-    delete timediff_vec_.at(i);
+    releaseTimeDiffVertex(timediff_vec_.at(i));
   timediff_vec_.erase(timediff_vec_.begin()+index, timediff_vec_.begin()+index+number);
 }
 
 void TimedElasticBand::insertPose(int index, const PoseSE2& pose)
 {
-  VertexPose* pose_vertex = new VertexPose(pose);
+  VertexPose* pose_vertex = createPoseVertex(pose, false);
   pose_vec_.insert(pose_vec_.begin()+index, pose_vertex);
 }
 
 void TimedElasticBand::insertPose(int index, const Eigen::Ref<const Eigen::Vector2d>& position, double theta)
 {
-  VertexPose* pose_vertex = new VertexPose(position, theta);
+  VertexPose* pose_vertex = createPoseVertex(PoseSE2(position, theta), false);
   pose_vec_.insert(pose_vec_.begin()+index, pose_vertex);
 }
 
 void TimedElasticBand::insertPose(int index, double x, double y, double theta)
 {
-  VertexPose* pose_vertex = new VertexPose(x, y, theta);
+  VertexPose* pose_vertex = createPoseVertex(PoseSE2(x, y, theta), false);
   pose_vec_.insert(pose_vec_.begin()+index, pose_vertex);
 }
 
 void TimedElasticBand::insertTimeDiff(int index, double dt)
 {
-  VertexTimeDiff* timediff_vertex = new VertexTimeDiff(dt);
+  VertexTimeDiff* timediff_vertex = createTimeDiffVertex(dt, false);
   timediff_vec_.insert(timediff_vec_.begin()+index, timediff_vertex);
 }
 
@@ -178,24 +252,31 @@ void TimedElasticBand::insertTimeDiff(int index, double dt)
 void TimedElasticBand::clearTimedElasticBand()
 {
   for (PoseSequence::iterator pose_it = pose_vec_.begin(); pose_it != pose_vec_.end(); ++pose_it)
-    delete *pose_it;
+    releasePoseVertex(*pose_it);
   pose_vec_.clear();
   
   for (TimeDiffSequence::iterator dt_it = timediff_vec_.begin(); dt_it != timediff_vec_.end(); ++dt_it)
-    delete *dt_it;
+    releaseTimeDiffVertex(*dt_it);
   timediff_vec_.clear();
 }
 
 
+void TimedElasticBand::swapTrajectory(TimedElasticBand& other)
+{
+  pose_vec_.swap(other.pose_vec_);
+  timediff_vec_.swap(other.timediff_vec_);
+}
+
+
 void TimedElasticBand::setPoseVertexFixed(int index, bool status)
 {
-  ROS_ASSERT(index<sizePoses());
+  TEB_ASSERT(index<sizePoses());
   pose_vec_.at(index)->setFixed(status);   
 }
 
 void TimedElasticBand::setTimeDiffVertexFixed(int index, bool status)
 {
-  ROS_ASSERT(index<sizeTimeDiffs());
+  TEB_ASSERT(index<sizeTimeDiffs());
   timediff_vec_.at(index)->setFixed(status);
 }
 
@@ -214,7 +295,7 @@ void TimedElasticBand::autoResize(double dt_ref, double dt_hysteresis, int min_s
     {
       if(TimeDiff(i) > dt_ref + dt_hysteresis && sizeTimeDiffs()<max_samples)
       {
-        //ROS_DEBUG("teb_local_planner: autoResize() inserting new bandpoint i=%u, #TimeDiffs=%lu",i,sizeTimeDiffs());
+        //TEB_DEBUG("teb_local_planner: autoResize() inserting new bandpoint i=%u, #TimeDiffs=%lu",i,sizeTimeDiffs());
 
         double newtime = 0.5*TimeDiff(i);
 
@@ -226,7 +307,7 @@ void TimedElasticBand::autoResize(double dt_ref, double dt_hysteresis, int min_s
       }
       else if(TimeDiff(i) < dt_ref - dt_hysteresis && sizeTimeDiffs()>min_samples) // only remove samples if size is larger than min_samples.
       {
-        //ROS_DEBUG("teb_local_planner: autoResize() deleting bandpoint i=%u, #TimeDiffs=%lu",i,sizeTimeDiffs());
+        //TEB_DEBUG("teb_local_planner: autoResize() deleting bandpoint i=%u, #TimeDiffs=%lu",i,sizeTimeDiffs());
 
         if(i < ((int)sizeTimeDiffs()-1))
         {
@@ -243,6 +324,80 @@ void TimedElasticBand::autoResize(double dt_ref, double dt_hysteresis, int min_s
 }
 
 
+void TimedElasticBand::initTimeProfile(double max_vel_x, double max_vel_x_backwards, double max_vel_theta, double acc_lim_x, double acc_lim_theta,
+                                       double start_vel, double goal_vel)
+{
+  int n = sizePoses();
+  if (n < 2 || sizeTimeDiffs() != n-1)
+    return;
+  
+  const double eps = 1e-6;
+  std::vector<double> dist(n-1); // translational distance of each segment
+  std::vector<double> angle(n-1); // absolute orientation change of each segment
+  std::vector<double> vel(n, std::numeric_limits<double>::max()); // admissible translational speed at each pose
+  
+  // the speed at a pose is bounded by the velocity limits of both adjacent segments
+  int last_direction = 0;
+  for (int k=0; k < n-1; ++k)
+  {
+    Eigen::Vector2d delta = Pose(k+1).position() - Pose(k).position();
+    dist[k] = delta.norm();
+    angle[k] = std::abs(g2o::normalize_theta(Pose(k+1).theta() - Pose(k).theta()));
+    
+    double vel_max = 0; // rotation on the spot
+    if (dist[k] > eps)
+    {
+      int direction = delta.dot(Pose(k).orientationUnitVec()) < 0 ? -1 : 1;
+      vel_max = direction < 0 ? max_vel_x_backwards : max_vel_x;
+      if (angle[k] > eps && max_vel_theta > 0)
+        vel_max = std::min(vel_max, max_vel_theta * dist[k] / angle[k]);
+      if (direction * last_direction < 0)
+        vel[k] = 0; // the robot stops at a cusp
+      last_direction = direction;
+    }
+    vel[k] = std::min(vel[k], vel_max);
+    vel[k+1] = std::min(vel[k+1], vel_max);
+  }
+  
+  // forward pass: accelerate from the start velocity
+  vel.front() = std::min(vel.front(), std::abs(start_vel));
+  if (acc_lim_x > 0)
+  {
+    for (int k=0; k < n-1; ++k)
+      vel[k+1] = std::min(vel[k+1], std::sqrt(vel[k]*vel[k] + 2*acc_lim_x*dist[k]));
+  }
+  
+  // backward pass: decelerate towards the goal velocity
+  vel.back() = std::min(vel.back(), std::abs(goal_vel));
+  if (acc_lim_x > 0)
+  {
+    for (int k=n-2; k >= 0; --k)
+      vel[k] = std::min(vel[k], std::sqrt(vel[k+1]*vel[k+1] + 2*acc_lim_x*dist[k]));
+  }
+  
+  for (int k=0; k < n-1; ++k)
+  {
+    double dt = 0;
+    double vel_mean = 0.5 * (vel[k] + vel[k+1]); // exact for a constant acceleration within the segment
+    if (vel_mean > eps)
+      dt = dist[k] / vel_mean;
+    else if (dist[k] > eps && acc_lim_x > 0)
+      dt = 2 * std::sqrt(dist[k] / acc_lim_x); // rest-to-rest
+    
+    if (angle[k] > eps)
+    {
+      double dt_rot = max_vel_theta > 0 ? angle[k] / max_vel_theta : 0;
+      if (dist[k] <= eps && acc_lim_theta > 0)
+        dt_rot = std::max(dt_rot, 2 * std::sqrt(angle[k] / acc_lim_theta)); // rest-to-rest rotation on the spot
+      dt = std::max(dt, dt_rot);
+    }
+    
+    if (dt > eps) // keep the previous value for coincident poses
+      TimeDiff(k) = dt;
+  }
+}
+
+
 double TimedElasticBand::getSumOfAllTimeDiffs() const
 {
   double time = 0;
@@ -256,7 +411,7 @@ double TimedElasticBand::getSumOfAllTimeDiffs() const
 
 double TimedElasticBand::getSumOfTimeDiffsUpToIdx(int index) const
 {
-  ROS_ASSERT(index<=timediff_vec_.size());
+  TEB_ASSERT(index<=timediff_vec_.size());
 
   double time = 0;
 
@@ -318,7 +473,7 @@ bool TimedElasticBand::initTrajectoryToGoal(const PoseSE2& start, const PoseSE2&
     // if number of samples is not larger than min_samples, insert manually
     if ( sizePoses() < min_samples-1 )
     {
-      ROS_DEBUG("initTEBtoGoal(): number of generated samples is less than specified by min_samples. Forcing the insertion of more samples...");
+      TEB_DEBUG("initTEBtoGoal(): number of generated samples is less than specified by min_samples. Forcing the insertion of more samples...");
       while (sizePoses() < min_samples-1) // subtract goal point that will be added later
       {
         // simple strategy: interpolate between the current pose and the goal
@@ -335,21 +490,21 @@ bool TimedElasticBand::initTrajectoryToGoal(const PoseSE2& start, const PoseSE2&
   }
   else // size!=0
   {
-    ROS_WARN("Cannot init TEB between given configuration and goal, because TEB vectors are not empty or TEB is already initialized (call this function before adding states yourself)!");
-    ROS_WARN("Number of TEB configurations: %d, Number of TEB timediffs: %d",(unsigned int) sizePoses(),(unsigned int) sizeTimeDiffs());
+    TEB_WARN("Cannot init TEB between given configuration and goal, because TEB vectors are not empty or TEB is already initialized (call this function before adding states yourself)!");
+    TEB_WARN("Number of TEB configurations: %d, Number of TEB timediffs: %d",(unsigned int) sizePoses(),(unsigned int) sizeTimeDiffs());
     return false;
   }
   return true;
 }
 
 
-bool TimedElasticBand::initTrajectoryToGoal(const std::vector<geometry_msgs::PoseStamped>& plan, double max_vel_x, bool estimate_orient, int min_samples, bool guess_backwards_motion)
+bool TimedElasticBand::initTrajectoryToGoal(const PoseSE2Container& plan, double max_vel_x, bool estimate_orient, int min_samples, bool guess_backwards_motion)
 {
   
   if (!isInit())
   {
-    PoseSE2 start(plan.front().pose);
-    PoseSE2 goal(plan.back().pose);
+    const PoseSE2& start = plan.front();
+    const PoseSE2& goal = plan.back();
 
     double dt = 0.1;
     
@@ -367,17 +522,17 @@ bool TimedElasticBand::initTrajectoryToGoal(const std::vector<geometry_msgs::Pos
         if (estimate_orient)
         {
             // get yaw from the orientation of the distance vector between pose_{i+1} and pose_{i}
-            double dx = plan[i+1].pose.position.x - plan[i].pose.position.x;
-            double dy = plan[i+1].pose.position.y - plan[i].pose.position.y;
+            double dx = plan[i+1].x() - plan[i].x();
+            double dy = plan[i+1].y() - plan[i].y();
             yaw = std::atan2(dy,dx);
             if (backwards)
                 yaw = g2o::normalize_theta(yaw+M_PI);
         }
         else 
         {
-            yaw = tf::getYaw(plan[i].pose.orientation);
+            yaw = plan[i].theta();
         }
-        PoseSE2 intermediate_pose(plan[i].pose.position.x, plan[i].pose.position.y, yaw);
+        PoseSE2 intermediate_pose(plan[i].x(), plan[i].y(), yaw);
         if (max_vel_x > 0) dt = (intermediate_pose.position()-BackPose().position()).norm()/max_vel_x;
         addPoseAndTimeDiff(intermediate_pose, dt);
     }
@@ -385,7 +540,7 @@ bool TimedElasticBand::initTrajectoryToGoal(const std::vector<geometry_msgs::Pos
     // if number of samples is not larger than min_samples, insert manually
     if ( sizePoses() < min_samples-1 )
     {
-      ROS_DEBUG("initTEBtoGoal(): number of generated samples is less than specified by min_samples. Forcing the insertion of more samples...");
+      TEB_DEBUG("initTEBtoGoal(): number of generated samples is less than specified by min_samples. Forcing the insertion of more samples...");
       while (sizePoses() < min_samples-1) // subtract goal point that will be added later
       {
         // simple strategy: interpolate between the current pose and the goal
@@ -402,8 +557,8 @@ bool TimedElasticBand::initTrajectoryToGoal(const std::vector<geometry_msgs::Pos
   }
   else // size!=0
   {
-    ROS_WARN("Cannot init TEB between given configuration and goal, because TEB vectors are not empty or TEB is already initialized (call this function before adding states yourself)!");
-    ROS_WARN("Number of TEB configurations: %d, Number of TEB timediffs: %d", sizePoses(), sizeTimeDiffs());
+    TEB_WARN("Cannot init TEB between given configuration and goal, because TEB vectors are not empty or TEB is already initialized (call this function before adding states yourself)!");
+    TEB_WARN("Number of TEB configurations: %d, Number of TEB timediffs: %d", sizePoses(), sizeTimeDiffs());
     return false;
   }
   
@@ -582,12 +737,12 @@ void TimedElasticBand::updateAndPruneTEB(boost::optional<const PoseSE2&> new_sta
     }
     
     // update start
-    Pose(0) = *new_start;
+    PoseVertex(0)->setEstimate(*new_start);
   }
   
   if (new_goal && sizePoses()>0)
   {
-    BackPose() = *new_goal;
+    pose_vec_.back()->setEstimate(*new_goal);
   }
 };
 
@@ -608,14 +763,14 @@ bool TimedElasticBand::isTrajectoryInsideRegion(double radius, double max_dist_b
         
         if (dist_sq > radius_sq)
         {
-            ROS_INFO("outside robot");
+            TEB_INFO("outside robot");
             return false;
         }
         
         // check behind the robot with a different distance, if specified (or >=0)
         if (max_dist_behind_robot >= 0 && dist_vec.dot(robot_orient) < 0 && dist_sq > max_dist_behind_robot_sq)
         {
-            ROS_INFO("outside robot behind");
+            TEB_INFO("outside robot behind");
             return false;
         }
         
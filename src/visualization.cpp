@@ -38,7 +38,10 @@
 
 #include <teb_local_planner/visualization.h>
 #include <teb_local_planner/optimal_planner.h>
+#include <teb_local_planner/homotopy_class_planner.h>
+#include <teb_local_planner/ros_adapter.h>
 #include <teb_local_planner/FeedbackMsg.h>
+#include <teb_local_planner/OptimizerDiagnosticsMsg.h>
 
 namespace teb_local_planner
 {
@@ -66,6 +69,7 @@ void TebVisualization::initialize(ros::NodeHandle& nh, const TebConfig& cfg)
   teb_poses_pub_ = nh.advertise<geometry_msgs::PoseArray>("teb_poses", 100);
   teb_marker_pub_ = nh.advertise<visualization_msgs::Marker>("teb_markers", 1000);
   feedback_pub_ = nh.advertise<teb_local_planner::FeedbackMsg>("teb_feedback", 10);  
+  diagnostics_pub_ = nh.advertise<teb_local_planner::OptimizerDiagnosticsMsg>("teb_optimizer_diagnostics", 10);
   
   initialized_ = true; 
 }
@@ -126,7 +130,7 @@ void TebVisualization::publishRobotFootprintModel(const PoseSE2& current_pose, c
     return;
   
   std::vector<visualization_msgs::Marker> markers;
-  robot_model.visualizeRobot(current_pose, markers, color);
+  robotFootprintToMarkers(robot_model, current_pose, markers, color);
   if (markers.empty())
     return;
   
@@ -150,6 +154,56 @@ void TebVisualization::publishInfeasibleRobotPose(const PoseSE2& current_pose, c
 }
 
 
+void TebVisualization::publishPlanner(const PlannerInterface& planner, const BaseRobotFootprintModel& robot_model, const ObstContainer& obstacles)
+{
+  if ( printErrorWhenNotInitialized() )
+    return;
+  
+  const HomotopyClassPlanner* hcp = dynamic_cast<const HomotopyClassPlanner*>(&planner);
+  if (hcp)
+  {
+    // Visualize graph
+    boost::shared_ptr<const GraphSearchInterface> graph_search = hcp->getGraphSearch();
+    if (cfg_->hcp.visualize_hc_graph && graph_search)
+      publishGraph(graph_search->graph_);
+
+    // Visualize active tebs as marker
+    publishTebContainer(hcp->getTrajectoryContainer());
+
+    // Visualize best teb and feedback message if desired
+    TebOptimalPlannerConstPtr best_teb = hcp->bestTeb();
+    if (best_teb)
+    {
+      publishLocalPlanAndPoses(best_teb->teb());
+
+      if (best_teb->teb().sizePoses() > 0) //TODO maybe store current pose (start) within plan method as class field.
+        publishRobotFootprintModel(best_teb->teb().Pose(0), robot_model);
+
+      // feedback message
+      if (cfg_->trajectory.publish_feedback)
+      {
+        int best_idx = hcp->bestTebIdx();
+        if (best_idx>=0)
+          publishFeedbackMessage(hcp->getTrajectoryContainer(), (unsigned int) best_idx, obstacles);
+      }
+    }
+    return;
+  }
+  
+  const TebOptimalPlanner* teb_planner = dynamic_cast<const TebOptimalPlanner*>(&planner);
+  if (teb_planner)
+  {
+    publishLocalPlanAndPoses(teb_planner->teb());
+  
+    if (teb_planner->teb().sizePoses() > 0)
+      publishRobotFootprintModel(teb_planner->teb().Pose(0), robot_model);
+  
+    if (cfg_->trajectory.publish_feedback)
+      publishFeedbackMessage(*teb_planner, obstacles);
+  }
+}
+
+
 void TebVisualization::publishObstacles(const ObstContainer& obstacles) const
 {
   if ( obstacles.empty() || printErrorWhenNotInitialized() )
@@ -394,13 +448,15 @@ void TebVisualization::publishFeedbackMessage(const std::vector< boost::shared_p
   
   
   msg.trajectories.resize(teb_planners.size());
+  TrajectoryPointContainer trajectory;
   
   // Iterate through teb pose sequence
   std::size_t idx_traj = 0;
   for( TebOptPlannerContainer::const_iterator it_teb = teb_planners.begin(); it_teb != teb_planners.end(); ++it_teb, ++idx_traj )
   {   
     msg.trajectories[idx_traj].header = msg.header;
-    it_teb->get()->getFullTrajectory(msg.trajectories[idx_traj].trajectory);
+    it_teb->get()->getFullTrajectory(trajectory);
+    trajectoryToMsg(trajectory, msg.trajectories[idx_traj].trajectory);
   }
   
   // add obstacles
@@ -411,7 +467,7 @@ void TebVisualization::publishFeedbackMessage(const std::vector< boost::shared_p
 
     // copy polygon
     msg.obstacles_msg.obstacles[i].header = msg.header;
-    obstacles[i]->toPolygonMsg(msg.obstacles_msg.obstacles[i].polygon);
+    obstacleToPolygonMsg(*obstacles[i], msg.obstacles_msg.obstacles[i].polygon);
 
     // copy id
     msg.obstacles_msg.obstacles[i].id = i; // TODO: we do not have any id stored yet
@@ -420,7 +476,7 @@ void TebVisualization::publishFeedbackMessage(const std::vector< boost::shared_p
     //msg.obstacles_msg.obstacles[i].orientation =; // TODO
 
     // copy velocities
-    obstacles[i]->toTwistWithCovarianceMsg(msg.obstacles_msg.obstacles[i].velocities);
+    obstacleToTwistWithCovarianceMsg(*obstacles[i], msg.obstacles_msg.obstacles[i].velocities);
   }
   
   feedback_pub_.publish(msg);
@@ -435,7 +491,9 @@ void TebVisualization::publishFeedbackMessage(const TebOptimalPlanner& teb_plann
   
   msg.trajectories.resize(1);
   msg.trajectories.front().header = msg.header;
-  teb_planner.getFullTrajectory(msg.trajectories.front().trajectory);
+  TrajectoryPointContainer trajectory;
+  teb_planner.getFullTrajectory(trajectory);
+  trajectoryToMsg(trajectory, msg.trajectories.front().trajectory);
  
   // add obstacles
   msg.obstacles_msg.obstacles.resize(obstacles.size());
@@ -445,7 +503,7 @@ void TebVisualization::publishFeedbackMessage(const TebOptimalPlanner& teb_plann
 
     // copy polygon
     msg.obstacles_msg.obstacles[i].header = msg.header;
-    obstacles[i]->toPolygonMsg(msg.obstacles_msg.obstacles[i].polygon);
+    obstacleToPolygonMsg(*obstacles[i], msg.obstacles_msg.obstacles[i].polygon);
 
     // copy id
     msg.obstacles_msg.obstacles[i].id = i; // TODO: we do not have any id stored yet
@@ -454,12 +512,53 @@ void TebVisualization::publishFeedbackMessage(const TebOptimalPlanner& teb_plann
     //msg.obstacles_msg.obstacles[i].orientation =; // TODO
 
     // copy velocities
-    obstacles[i]->toTwistWithCovarianceMsg(msg.obstacles_msg.obstacles[i].velocities);
+    obstacleToTwistWithCovarianceMsg(*obstacles[i], msg.obstacles_msg.obstacles[i].velocities);
   }
   
   feedback_pub_.publish(msg);
 }
 
+void TebVisualization::publishOptimizerDiagnostics(const OptimizerTelemetry& telemetry)
+{
+  if ( printErrorWhenNotInitialized() || diagnostics_pub_.getNumSubscribers() == 0 )
+    return;
+  
+  OptimizerDiagnosticsMsg msg;
+  msg.header.stamp = ros::Time::now();
+  msg.cycle = telemetry.currentCycle();
+  
+  telemetry.getCycle(msg.cycle, telemetry_records_);
+  const std::size_t n = telemetry_records_.size();
+  msg.source.resize(n);
+  msg.outer_iteration.resize(n);
+  msg.inner_iteration.resize(n);
+  msg.chi2.resize(n);
+  msg.lambda.resize(n);
+  msg.rejected_steps.resize(n);
+  msg.time_linearize.resize(n);
+  msg.time_hessian.resize(n);
+  msg.time_solve.resize(n);
+  msg.time_iteration.resize(n);
+  msg.constraint_violation.resize(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const OptimizerIterationRecord& rec = telemetry_records_[i];
+    msg.source[i] = rec.source;
+    msg.outer_iteration[i] = rec.outer_iteration;
+    msg.inner_iteration[i] = rec.inner_iteration;
+    msg.chi2[i] = rec.chi2;
+    msg.lambda[i] = rec.lambda;
+    msg.rejected_steps[i] = rec.rejected_steps;
+    msg.time_linearize[i] = rec.time_linearize * 1e3;
+    msg.time_hessian[i] = rec.time_hessian * 1e3;
+    msg.time_solve[i] = rec.time_solve * 1e3;
+    msg.time_iteration[i] = rec.time_iteration * 1e3;
+    msg.constraint_violation[i] = rec.constraint_violation;
+  }
+  
+  diagnostics_pub_.publish(msg);
+}
+
 std_msgs::ColorRGBA TebVisualization::toColorMsg(double a, double r, double g, double b)
 {
   std_msgs::ColorRGBA color;
@@ -470,6 +569,117 @@ std_msgs::ColorRGBA TebVisualization::toColorMsg(double a, double r, double g, d
   return color;
 }
 
+void TebVisualization::robotFootprintToMarkers(const BaseRobotFootprintModel& robot_model, const PoseSE2& current_pose,
+                                               std::vector<visualization_msgs::Marker>& markers, const std_msgs::ColorRGBA& color)
+{
+  if (const CircularRobotFootprint* circular = dynamic_cast<const CircularRobotFootprint*>(&robot_model))
+  {
+    markers.resize(1);
+    visualization_msgs::Marker& marker = markers.back();
+    marker.type = visualization_msgs::Marker::CYLINDER;
+    poseToMsg(current_pose, marker.pose);
+    marker.scale.x = marker.scale.y = 2*circular->getRadius(); // scale = diameter
+    marker.scale.z = 0.05;
+    marker.color = color;
+  }
+  else if (const TwoCirclesRobotFootprint* two_circles = dynamic_cast<const TwoCirclesRobotFootprint*>(&robot_model))
+  {
+    Eigen::Vector2d dir = current_pose.orientationUnitVec();
+    if (two_circles->getFrontRadius()>0)
+    {
+      markers.push_back(visualization_msgs::Marker());
+      visualization_msgs::Marker& marker1 = markers.front();
+      marker1.type = visualization_msgs::Marker::CYLINDER;
+      poseToMsg(current_pose, marker1.pose);
+      marker1.pose.position.x += two_circles->getFrontOffset()*dir.x();
+      marker1.pose.position.y += two_circles->getFrontOffset()*dir.y();
+      marker1.scale.x = marker1.scale.y = 2*two_circles->getFrontRadius(); // scale = diameter
+//       marker1.scale.z = 0.05;
+      marker1.color = color;
+
+    }
+    if (two_circles->getRearRadius()>0)
+    {
+      markers.push_back(visualization_msgs::Marker());
+      visualization_msgs::Marker& marker2 = markers.back();
+      marker2.type = visualization_msgs::Marker::CYLINDER;
+      poseToMsg(current_pose, marker2.pose);
+      marker2.pose.position.x -= two_circles->getRearOffset()*dir.x();
+      marker2.pose.position.y -= two_circles->getRearOffset()*dir.y();
+      marker2.scale.x = marker2.scale.y = 2*two_circles->getRearRadius(); // scale = diameter
+//       marker2.scale.z = 0.05;
+      marker2.color = color;
+    }
+  }
+  else if (const MultiCirclesRobotFootprint* multi_circles = dynamic_cast<const MultiCirclesRobotFootprint*>(&robot_model))
+  {
+    Eigen::Vector2d dir = current_pose.orientationUnitVec();
+    for (const MultiCirclesRobotFootprint::Circle& circle : multi_circles->getCircles())
+    {
+      markers.push_back(visualization_msgs::Marker());
+      visualization_msgs::Marker& marker = markers.back();
+      marker.type = visualization_msgs::Marker::CYLINDER;
+      poseToMsg(current_pose, marker.pose);
+      marker.pose.position.x += dir.x()*circle.center.x() - dir.y()*circle.center.y();
+      marker.pose.position.y += dir.y()*circle.center.x() + dir.x()*circle.center.y();
+      marker.scale.x = marker.scale.y = 2*circle.radius; // scale = diameter
+      marker.color = color;
+    }
+  }
+  else if (const LineRobotFootprint* line = dynamic_cast<const LineRobotFootprint*>(&robot_model))
+  {
+    markers.push_back(visualization_msgs::Marker());
+    visualization_msgs::Marker& marker = markers.front();
+    marker.type = visualization_msgs::Marker::LINE_STRIP;
+    poseToMsg(current_pose, marker.pose); // all points are transformed into the robot frame!
+    
+    // line
+    geometry_msgs::Point line_start_world;
+    line_start_world.x = line->getLineStart().x();
+    line_start_world.y = line->getLineStart().y();
+    line_start_world.z = 0;
+    marker.points.push_back(line_start_world);
+    
+    geometry_msgs::Point line_end_world;
+    line_end_world.x = line->getLineEnd().x();
+    line_end_world.y = line->getLineEnd().y();
+    line_end_world.z = 0;
+    marker.points.push_back(line_end_world);
+
+    marker.scale.x = 0.05; 
+    marker.color = color;
+  }
+  else if (const PolygonRobotFootprint* polygon = dynamic_cast<const PolygonRobotFootprint*>(&robot_model))
+  {
+    const Point2dContainer& vertices = polygon->getVertices();
+    if (vertices.empty())
+      return;
+
+    markers.push_back(visualization_msgs::Marker());
+    visualization_msgs::Marker& marker = markers.front();
+    marker.type = visualization_msgs::Marker::LINE_STRIP;
+    poseToMsg(current_pose, marker.pose); // all points are transformed into the robot frame!
+    
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+      geometry_msgs::Point point;
+      point.x = vertices[i].x();
+      point.y = vertices[i].y();
+      point.z = 0;
+      marker.points.push_back(point);
+    }
+    // add first point again in order to close the polygon
+    geometry_msgs::Point point;
+    point.x = vertices.front().x();
+    point.y = vertices.front().y();
+    point.z = 0;
+    marker.points.push_back(point);
+
+    marker.scale.x = 0.025; 
+    marker.color = color;
+  }
+}
+
 bool TebVisualization::printErrorWhenNotInitialized() const
 {
   if (!initialized_)